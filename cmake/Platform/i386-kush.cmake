@@ -16,7 +16,8 @@ set(CMAKE_C_LINK_OPTIONS_NO_PIE "-no-pie")
 #set(CMAKE_SHARED_LIBRARY_SUFFIX ".dyldo")
 set(CMAKE_SHARED_LIBRARY_C_FLAGS "-fPIC")
 set(CMAKE_SHARED_LIBRARY_CXX_FLAGS "-fPIC")
-set(CMAKE_SHARED_LIBRARY_CREATE_C_FLAGS "-shared")
+# emit both GNU and SysV hash tables; dyldo prefers the former for symbol lookups
+set(CMAKE_SHARED_LIBRARY_CREATE_C_FLAGS "-shared -Wl,--hash-style=both")
 set(CMAKE_SHARED_LIBRARY_RUNTIME_C_FLAG "-Wl,-rpath,")
 set(CMAKE_SHARED_LIBRARY_RUNTIME_C_FLAG_SEP ":")
 set(CMAKE_SHARED_LIBRARY_RPATH_LINK_C_FLAG "-Wl,-rpath-link,")
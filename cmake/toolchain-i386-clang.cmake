@@ -34,7 +34,8 @@ SET(CMAKE_RANLIB "${TOOLS_BASE}/llvm-ranlib")
 SET(CMAKE_ASM_FLAGS "${ASM_FLAGS} -target ${TARGET_TRIPLE} ${ARCH_FLAGS}" CACHE STRING "" FORCE)
 SET(CMAKE_C_FLAGS "${C_CXX_FLAGS} -target ${TARGET_TRIPLE} ${ARCH_FLAGS}" CACHE STRING "" FORCE)
 SET(CMAKE_CXX_FLAGS "${C_CXX_FLAGS} -target ${TARGET_TRIPLE} ${ARCH_FLAGS}" CACHE STRING "" FORCE)
-SET(CMAKE_EXE_LINKER_FLAGS_INIT "-fuse-ld=lld")
+# build IDs identify binaries in the root server's image cache
+SET(CMAKE_EXE_LINKER_FLAGS_INIT "-fuse-ld=lld -Wl,--build-id")
 
 # skip testing compilers
 set(CMAKE_ASM_COMPILER_WORKS 1)
@@ -27,6 +27,9 @@
 /// Low 32 bits define which bits to mask off in RFLAGS on SYSCALL
 #define X86_MSR_IA32_FMASK              0xC0000084
 
+/// Absolute TSC value at which the local APIC timer fires, when in TSC-deadline mode
+#define X86_MSR_IA32_TSC_DEADLINE       0x000006E0
+
 /**
  * Writes a model-specific register.
  */
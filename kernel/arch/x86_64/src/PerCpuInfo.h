@@ -27,6 +27,11 @@ namespace vm {
 class Map;
 }
 
+namespace debug {
+class LogRing;
+struct TraceBuffer;
+}
+
 namespace arch {
 class Idt;
 class IrqRegistry;
@@ -65,6 +70,11 @@ struct ProcInfo {
     platform::CoreLocalInfo p;
 #endif
 
+    /// kernel log ring for messages logged on this core
+    debug::LogRing *logRing = nullptr;
+    /// event trace buffer for this core
+    debug::TraceBuffer *traceBuffer = nullptr;
+
     /// Initializes the self ptr
     ProcInfo() {
         this->selfPtr = this;
@@ -196,11 +196,19 @@ void amd64_handle_pagefault(amd64_exception_info_t *info) {
 
     // forward userspace page faults to the VM manager
     if(faultAddr < 0x8000000000000000 && (info->errCode & 0x04)) {
+        /*
+         * The entry stub moves userspace faults off the IST stack onto the thread's kernel stack,
+         * so they may block (such as when waiting for a pager to provide the page) and thus need
+         * interrupts enabled. Any nested fault from here on is a kernel fault, not a recursive
+         * userspace one.
+         */
+        __atomic_clear(&inFault, __ATOMIC_RELAXED);
+        asm volatile("sti" ::: "memory");
+
         auto vm = ::vm::Map::current();
         bool handled = vm->handlePagefault(faultAddr, (info->errCode & 0x01), (info->errCode & 0x02));
 
         if(handled) {
-            __atomic_clear(&inFault, __ATOMIC_RELAXED);
             return;
         }
 
@@ -208,7 +216,6 @@ void amd64_handle_pagefault(amd64_exception_info_t *info) {
         auto thread = sched::Thread::current();
         if(thread) {
             thread->handleFault(sched::Thread::FaultType::UnhandledPagefault, faultAddr, &info->rip, &info);
-            __atomic_clear(&inFault, __ATOMIC_RELAXED);
             return;
         }
     }
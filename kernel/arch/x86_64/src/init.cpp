@@ -2,6 +2,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <printf.h>
+#include <string.h>
 
 #include "IrqRegistry.h"
 #include "PerCpuInfo.h"
@@ -40,6 +41,9 @@ void arch_init() {
     // test CPU features we need to support
     TestCpuSupport();
 
+    // then pick the string routines to use
+    string_init();
+
     // determine if we support the NX bit; enable the feature if so
     update_supports_nx();
 
@@ -25,8 +25,10 @@ extern "C" void arch_syscall_entry();
  * Initializes the shared syscall handler.
  */
 void Handler::init() {
-    gShared = reinterpret_cast<Handler *>(&gSharedBuf);
-    new(gShared) Handler();
+    // only publish the handler once it's set up, since context switches may update the time page
+    auto handler = reinterpret_cast<Handler *>(&gSharedBuf);
+    new(handler) Handler();
+    gShared = handler;
 }
 
 /**
@@ -72,20 +74,81 @@ void Handler::mapTimePage(rt::SharedPtr<sched::Task> &task) {
 }
 
 /**
- * Writes to the time page.
+ * Reads the time stamp counter of the current processor.
  */
-void Handler::updateTime() {
+static inline uint64_t ReadTsc() {
     uint32_t low, high;
-
-    // get time and read tsc
-    auto now = platform_timer_now();
-
     asm volatile("lfence; rdtsc; lfence" : "=a"(low), "=d"(high) : : "memory");
-    uint64_t tsc =  (static_cast<uint64_t>(high) << 32ULL) | low;
+    return (static_cast<uint64_t>(high) << 32ULL) | low;
+}
 
-    // do the atomic writes
-    __atomic_store(&this->timeInfo->timeNsec, &now, __ATOMIC_RELAXED);
-    __atomic_store(&this->timeInfo->kernelTsc, &tsc, __ATOMIC_SEQ_CST);
+/**
+ * Publishes a new base time on the time page, if the update period has elapsed since the last
+ * update.
+ *
+ * Only one processor updates the page at a time: whoever manages to make the sequence number odd
+ * does the update, and everyone else skips it. The rate of the time stamp counter is measured
+ * against the platform timer over the uptime so far.
+ *
+ * The published time is never earlier than what userspace could have extrapolated from the
+ * previous base, so the time it reads doesn't go backwards when a new base is published.
+ */
+void Handler::updateTime() {
+    auto info = this->timeInfo;
+    auto tsc = ReadTsc();
+
+    // bail if the update period hasn't elapsed; this avoids reading the platform timer
+    const auto lastTsc = __atomic_load_n(&info->kernelTsc, __ATOMIC_RELAXED);
+    const auto period = __atomic_load_n(&this->updatePeriodTicks, __ATOMIC_RELAXED);
+    if(period && (tsc - lastTsc) < period) return;
+
+    // acquire the sequence lock
+    auto seq = __atomic_load_n(&info->sequence, __ATOMIC_RELAXED);
+    if(seq & 1) return;
+    if(!__atomic_compare_exchange_n(&info->sequence, &seq, seq + 1, false, __ATOMIC_ACQUIRE,
+                __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    // sample the time and refine the counter rate
+    const auto timer = platform_timer_now();
+    tsc = ReadTsc();
+
+    if(!this->firstTsc) {
+        this->firstNsec = timer;
+        this->firstTsc = tsc;
+    }
+
+    auto rate = info->nsPerTick;
+    const auto elapsed = timer - this->firstNsec;
+
+    if(elapsed >= kTimeCalibrationMin && elapsed < kTimeCalibrationMax && tsc > this->firstTsc) {
+        rate = (elapsed << kTimeRateShift) / (tsc - this->firstTsc);
+        if(rate) {
+            __atomic_store_n(&this->updatePeriodTicks,
+                    (kTimeUpdatePeriod << kTimeRateShift) / rate, __ATOMIC_RELAXED);
+        }
+    }
+
+    // never publish a time earlier than userspace could have read until now
+    auto now = timer;
+    const auto oldNsec = info->timeNsec;
+
+    if(info->nsPerTick && tsc > lastTsc) {
+        const auto delta = (static_cast<unsigned __int128>(tsc - lastTsc) * info->nsPerTick)
+            >> kTimeRateShift;
+        const auto extrapolated = oldNsec + static_cast<uint64_t>(delta);
+        if(extrapolated > now) now = extrapolated;
+    }
+    if(now < oldNsec) now = oldNsec;
+
+    // publish the new base and release the lock
+    __atomic_store_n(&info->timeNsec, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&info->kernelTsc, tsc, __ATOMIC_RELAXED);
+    __atomic_store_n(&info->nsPerTick, rate, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&info->sequence, seq + 2, __ATOMIC_RELEASE);
 }
 
 
@@ -15,12 +15,21 @@
 namespace arch::syscall {
 /**
  * Format of the time info page
+ *
+ * The page holds a base pair of an uptime and the time stamp counter value at that time, from
+ * which userspace extrapolates the current time. It's protected by a sequence lock: the sequence
+ * number is odd while the kernel is writing to the page, and readers retry if it was odd or it
+ * changed while they read the other fields.
  */
 struct TimeInfo {
+    /// Sequence number; incremented before and after each update
+    uint64_t sequence;
     /// Nanoseconds of kernel uptime
     uint64_t timeNsec;
     /// Time counter value when this was written
     uint64_t kernelTsc;
+    /// Nanoseconds per time counter tick, as fixed point with 24 fractional bits; 0 if not known
+    uint64_t nsPerTick;
 };
 
 /**
@@ -34,14 +43,30 @@ class Handler {
         constexpr static const uintptr_t kTimeKernelVmAddr = 0xFFFFFF0000020000;
         /// Userspace VM address for the system time page
         constexpr static const uintptr_t kTimeUserVmAddr = 0x7FFF00100000;
+        /// Interval between updates of the time page, in nanoseconds
+        constexpr static const uint64_t kTimeUpdatePeriod = 10'000'000ULL;
+        /// Minimum uptime to elapse before the time stamp counter rate is published
+        constexpr static const uint64_t kTimeCalibrationMin = 10'000'000ULL;
+        /// Uptime after which the time stamp counter rate is no longer refined
+        constexpr static const uint64_t kTimeCalibrationMax = (1ULL << 39);
+        /// Number of fractional bits in the time stamp counter rate
+        constexpr static const uint64_t kTimeRateShift = 24;
 
     public:
         /**
          * When switching to a task, set its stack as the syscall stack in the per-CPU info
          * structure.
+         *
+         * The time page is refreshed here as well, since there's no periodic tick to update it
+         * from. This only happens once every `kTimeUpdatePeriod` though; in between, userspace
+         * extrapolates from the last published time using the time stamp counter.
          */
         static inline void handleCtxSwitch(const rt::SharedPtr<sched::Thread> &thread) {
             PerCpuInfo::get()->syscallStack = thread->stack;
+
+            if(gShared) [[likely]] {
+                gShared->updateTime();
+            }
         }
 
         /// Prepares the given task
@@ -64,6 +89,11 @@ class Handler {
         uint64_t timePage = 0;
         /// pointer to the in-memory time info struct
         TimeInfo *timeInfo = nullptr;
+
+        /// uptime and time stamp counter value of the first time page update
+        uint64_t firstNsec = 0, firstTsc = 0;
+        /// number of time stamp counter ticks between updates, or 0 if not yet known
+        uint64_t updatePeriodTicks = 0;
 };
 }
 #endif
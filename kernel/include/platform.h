@@ -57,6 +57,8 @@ uint64_t GetLocalTsc();
 void SetLocalTimer(const uint64_t interval, const bool repeat = false);
 /// Stops the core local timer
 void StopLocalTimer();
+/// Returns the shortest interval (in ns) the core local timer can reliably be set to
+uint64_t GetLocalTimerMinInterval();
 
 /// Sends a scheduler self IPI
 void RequestSchedulerIpi();
@@ -74,6 +74,20 @@ int vsnprintf(char* buffer, size_t count, const char* format, va_list va);
 int fctprintf(void (*out)(char character, void* arg), void* arg, const char* format, ...) __attribute__((format (printf, 3, 4)));
 int fctvprintf(void (*out)(char character, void* arg), void* arg, const char* format, va_list va);
 
+/**
+ * printf with chunked output function
+ * Output is collected in a small buffer on the stack, and passed to the output function a run of
+ * characters at a time; this is preferable to fctprintf() when the output function has some per
+ * call overhead, such as taking a lock.
+ * \param out An output function which takes a run of characters (not null terminated), its length
+ *        and an argument pointer
+ * \param arg An argument pointer for user data passed to output function
+ * \param format A string that specifies the format of the output
+ * \return The number of characters that are sent to the output function, not counting the terminating null character
+ */
+int chunkprintf(void (*out)(const char* chunk, size_t length, void* arg), void* arg, const char* format, ...) __attribute__((format (printf, 3, 4)));
+int vchunkprintf(void (*out)(const char* chunk, size_t length, void* arg), void* arg, const char* format, va_list va);
+
 
 #ifdef __cplusplus
 }
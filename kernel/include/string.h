@@ -8,6 +8,9 @@
 extern "C" {
 #endif
 
+// selects the best implementation of the string functions; called during arch init
+void string_init();
+
 // string functions: memory
 const void *memchr(const void *ptr, const uint8_t value, const size_t num);
 int memcmp(const void *ptr1, const void *ptr2, const size_t num);
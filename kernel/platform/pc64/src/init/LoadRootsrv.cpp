@@ -1,4 +1,4 @@
-#include "tar.h"
+#include "BundleTypes.h"
 #include "elf.h"
 
 #include <platform.h>
@@ -24,8 +24,8 @@ using namespace platform;
 /// VM address at which the init bundle is mapped in the task
 constexpr static const uintptr_t kInitBundleVmAddr = 0x690000000;
 /// Name of root server binary in initrd
-static const char *kRootSrvName = "rootsrv\0";
-constexpr static const size_t kRootSrvNameLen = 8;
+static const char *kRootSrvName = "rootsrv";
+constexpr static const size_t kRootSrvNameLen = 7;
 
 static void RootSrvEntry(const uintptr_t);
 static void MapInitBundle();
@@ -67,7 +67,7 @@ rt::SharedPtr<sched::Task> platform::InitRootsrv() {
 /**
  * Main entry point for the root server
  *
- * Map the init bundle -- an USTAR file -- into the task's address space, and attempt to find in
+ * Map the init bundle into the task's address space, and attempt to find in
  * it the ELF for the root server. Once we've located it, create mappings that contain the ELF's
  * .text and .data segments, and allocate a .bss, and stack.
  *
@@ -292,46 +292,52 @@ static void MapInitBundle() {
 }
 
 /**
- * Helper method to convert an octal string to a binary number.
- */
-static size_t Oct2Bin(const char *str, size_t size) {
-    size_t n = 0;
-    auto c = str;
-    while (size-- > 0) {
-        n *= 8;
-        n += *c - '0';
-        c++;
-    }
-    return n;
-}
-
-/**
- * Searches the init bundle (which is assumed to be a tar file) for the root server binary.
+ * Looks up the root server binary in the init bundle's directory. The binary must be stored
+ * uncompressed.
  *
  * @param outPtr Virtual memory address of root server binary, if found
  * @param outLength Length of the root server binary, if found
  * @return Whether the binary was located
  */
 static bool FindRootsrvFile(void* &outPtr, size_t &outLength) {
-    auto read = reinterpret_cast<uint8_t *>(kInitBundleVmAddr);
-    const auto bundleEnd = kInitBundleVmAddr + bootboot.initrd_size;
-
-    // iterate until we find the right header
-    while((reinterpret_cast<uintptr_t>(read) + 512) < bundleEnd &&
-            !memcmp(read + 257, TMAGIC, 5)) {
-        // get the size of this header and entry
-        auto hdr = reinterpret_cast<struct posix_header *>(read);
-        const auto size = Oct2Bin(hdr->size, 11);
-
-        // compare filename
-        if(!memcmp(hdr->name, kRootSrvName, kRootSrvNameLen)) {
-            outLength = size;
-            outPtr = read + 512; // XXX: is this block size _always_ 512?
-            return true;
+    const auto base = kInitBundleVmAddr;
+    const auto hdr = reinterpret_cast<const InitHeader *>(base);
+
+    // validate the header and directory bounds
+    REQUIRE(bootboot.initrd_size >= sizeof(InitHeader), "init bundle too small");
+    REQUIRE(hdr->magic == kInitMagic && hdr->type == kInitType && hdr->major == kInitVersionMajor,
+            "invalid init bundle header");
+    REQUIRE(hdr->totalLen <= bootboot.initrd_size && hdr->headerLen <= hdr->totalLen,
+            "invalid init bundle length");
+    REQUIRE(hdr->numBuckets && !(hdr->numBuckets & (hdr->numBuckets - 1)),
+            "invalid init bundle buckets");
+    REQUIRE(hdr->bucketsOff + ((hdr->numBuckets + 1ULL) * sizeof(uint32_t)) <= hdr->headerLen &&
+            hdr->filesOff + (hdr->numFiles * sizeof(InitFileHeader)) <= hdr->headerLen &&
+            hdr->namesOff + hdr->namesLen <= hdr->headerLen, "invalid init bundle directory");
+
+    const auto buckets = reinterpret_cast<const uint32_t *>(base + hdr->bucketsOff);
+    const auto files = reinterpret_cast<const InitFileHeader *>(base + hdr->filesOff);
+    const auto names = reinterpret_cast<const char *>(base + hdr->namesOff);
+
+    // search the name's bucket
+    const auto hash = InitBundleHashName(kRootSrvName, kRootSrvNameLen);
+    const auto bucket = hash & (hdr->numBuckets - 1);
+
+    for(auto i = buckets[bucket]; i < buckets[bucket + 1] && i < hdr->numFiles; i++) {
+        const auto &f = files[i];
+
+        if(f.hash != hash || f.nameLen != kRootSrvNameLen ||
+                f.nameOff + f.nameLen > hdr->namesLen ||
+                memcmp(names + f.nameOff, kRootSrvName, kRootSrvNameLen)) {
+            continue;
         }
 
-        // advance to next entry
-        read += (((size + 511) / 512) + 1) * 512;
+        REQUIRE(!(f.flags & kInitFileFlagsCompressed), "rootsrv must be stored uncompressed");
+        REQUIRE(f.dataOff + f.dataLen <= hdr->totalLen, "rootsrv extends past end of bundle");
+
+        outLength = f.dataLen;
+        outPtr = reinterpret_cast<void *>(base + f.dataOff);
+        return true;
     }
 
     return false;
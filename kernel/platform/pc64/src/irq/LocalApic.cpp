@@ -303,6 +303,17 @@ void platform::StopLocalTimer() {
     timer->stop();
 }
 
+/**
+ * Returns the minimum interval of the local APIC timer. This depends on whether the timer is in
+ * TSC-deadline mode.
+ */
+uint64_t platform::GetLocalTimerMinInterval() {
+    auto timer = LocalApic::theTimer();
+    REQUIRE(timer, "invalid %s", "LAPIC timer");
+
+    return timer->getMinInterval();
+}
+
 /**
  * Sends a scheduler self IPI to the current core.
  */
@@ -1,5 +1,6 @@
 #include "ApicTimer.h"
 #include "Hpet.h"
+#include "Tsc.h"
 #include "../irq/LocalApic.h"
 #include "../irq/ApicRegs.h"
 
@@ -9,12 +10,14 @@
 #include <arch/PerCpuInfo.h>
 #include <arch/critical.h>
 #include <arch/spinlock.h>
+#include <arch/x86_msr.h>
 #include <log.h>
 
 using namespace platform;
 
 bool ApicTimer::gLogInit        = true;
 bool ApicTimer::gLogSet         = false;
+bool ApicTimer::gAllowTscDeadline = true;
 
 
 /**
@@ -36,10 +39,15 @@ ApicTimer::ApicTimer(LocalApic *_parent) : parent(_parent) {
         this->isConstantTime = (eax & (1 << 2));
     }
 
+    // use TSC-deadline mode if supported (CPUID.01H:ECX[24]) and the TSC has been calibrated
+    __get_cpuid(0x01, &eax, &ebx, &ecx, &edx);
+    this->useTscDeadline = gAllowTscDeadline && (ecx & (1 << 24)) && Tsc::the();
+
     // measure its frequency
     this->measureTimerFreq();
-    if(gLogInit) log("APIC timer %3u: freq %lu Hz, constant time %c", this->parent->id, this->freq,
-            this->isConstantTime ? 'Y' : 'N');
+    if(gLogInit) log("APIC timer %3u: freq %lu Hz, constant time %c, TSC deadline %c",
+            this->parent->id, this->freq, this->isConstantTime ? 'Y' : 'N',
+            this->useTscDeadline ? 'Y' : 'N');
 
     // install the irq handler
     auto irq = arch::PerCpuInfo::get()->irqRegistry;
@@ -49,7 +57,13 @@ ApicTimer::ApicTimer(LocalApic *_parent) : parent(_parent) {
     this->parent->write(kApicRegTimerInitial, 0);
     this->parent->write(kApicRegTimerDivide, 0b0011); // divide by 16
 
-    this->parent->write(kApicRegLvtTimer, kVector);
+    if(this->useTscDeadline) {
+        this->parent->write(kApicRegLvtTimer, kVector | kLvtModeTscDeadline);
+        asm volatile("mfence" ::: "memory");
+        x86_msr_write(X86_MSR_IA32_TSC_DEADLINE, 0, 0);
+    } else {
+        this->parent->write(kApicRegLvtTimer, kVector);
+    }
 }
 
 /**
@@ -123,7 +137,7 @@ void ApicTimer::measureTimerFreq() {
 }
 
 /**
- * Configures the timer in one-shot mode with the given interval.
+ * Configures the timer to fire after the given interval.
  *
  * @param nsec Interval for the timer, in nanoseconds
  * @param repeat Whether the timer is in one-shot (`false`) or repeating (`true`) mode
@@ -131,9 +145,51 @@ void ApicTimer::measureTimerFreq() {
  * @return The actually achieved time set
  */
 uint64_t ApicTimer::setInterval(const uint64_t nsec, const bool repeat) {
-    DECLARE_CRITICAL();
     REQUIRE(nsec, "invalid interval");
 
+    // TSC-deadline mode can't repeat on its own
+    if(this->useTscDeadline && !repeat) {
+        return this->setIntervalDeadline(nsec);
+    }
+    return this->setIntervalCount(nsec, repeat);
+}
+
+/**
+ * Arms the timer by writing the TSC value at which it shall fire. The interval is converted to
+ * TSC ticks and added to the current TSC value.
+ *
+ * Writing the deadline MSR is not serializing with respect to the LVT write that selects the
+ * TSC-deadline mode, so a memory fence is required between them.
+ */
+uint64_t ApicTimer::setIntervalDeadline(const uint64_t nsec) {
+    DECLARE_CRITICAL();
+
+    uint64_t actual{0};
+    const auto ticks = Tsc::the()->nsToTicks(nsec, actual);
+
+    CRITICAL_ENTER();
+    {
+        this->parent->write(kApicRegLvtTimer, kVector | kLvtModeTscDeadline);
+        asm volatile("mfence" ::: "memory");
+
+        // a deadline of 0 disarms the timer, so always ensure it's nonzero
+        auto deadline = Tsc::GetCount() + (ticks ? ticks : 1);
+        x86_msr_write(X86_MSR_IA32_TSC_DEADLINE, deadline & 0xFFFFFFFF, deadline >> 32);
+    }
+    CRITICAL_EXIT();
+
+    if(gLogSet) log("desired %lu ns -> %lu TSC ticks", nsec, ticks);
+
+    this->intervalPs = actual * 1000ULL;
+    return actual;
+}
+
+/**
+ * Configures the timer in one-shot or periodic count mode with the given interval.
+ */
+uint64_t ApicTimer::setIntervalCount(const uint64_t nsec, const bool repeat) {
+    DECLARE_CRITICAL();
+
     // convert to period
     const uint64_t divisor = 16; // XXX: should this be supported to change?
     const uint64_t ticks = ((nsec * 1000ULL) / (this->psPerTick /** divisor*/));
@@ -155,7 +211,7 @@ uint64_t ApicTimer::setInterval(const uint64_t nsec, const bool repeat) {
 
         // unmask timer interrupt
         uint32_t lvtValue = kVector;
-        lvtValue |= (repeat ? 0b01 : 0b00) << 17;
+        lvtValue |= repeat ? kLvtModePeriodic : kLvtModeOneShot;
         this->parent->write(kApicRegLvtTimer, lvtValue);
 
         // write the timer configuration
@@ -176,10 +232,17 @@ uint64_t ApicTimer::setInterval(const uint64_t nsec, const bool repeat) {
 void ApicTimer::stop() {
     // mask the timer interrupt
     auto lvt = this->parent->read(kApicRegLvtTimer);
-    lvt |=  (1 << 16);
-    lvt &= ~(0b11 << 17); // clear timer type (0b00 = one shot)
+    lvt |= kLvtMasked;
 
-    this->parent->write(kApicRegLvtTimer, lvt);
+    if(this->useTscDeadline) {
+        this->parent->write(kApicRegLvtTimer, lvt);
+
+        // disarm the deadline
+        x86_msr_write(X86_MSR_IA32_TSC_DEADLINE, 0, 0);
+    } else {
+        lvt &= ~(0b11 << 17); // clear timer type (0b00 = one shot)
+        this->parent->write(kApicRegLvtTimer, lvt);
+    }
 
     // write a 0 initial count to stop
     this->parent->write(kApicRegTimerInitial, 0);
@@ -12,6 +12,12 @@ class LocalApic;
  * of precision) timer that's used for things like the scheduler and other core-local timing.
  *
  * An interface is exposed to use the timer in one-shot (deadline) mode.
+ *
+ * If the processor supports it, the timer runs in TSC-deadline mode: rather than loading a count
+ * that's decremented at the (measured, and divided) APIC timer frequency, we write the absolute
+ * TSC value at which the timer should fire. This has the resolution of the TSC, and since a
+ * deadline that has already passed fires immediately, timer interrupts can't be lost by setting
+ * very short intervals.
  */
 class ApicTimer {
     friend void ApicTimerIrq(const uintptr_t, void *);
@@ -29,16 +35,47 @@ class ApicTimer {
         /// Stops the timer
         void stop();
 
+        /// Shortest interval (in ns) that the timer can reliably be programmed with
+        constexpr inline uint64_t getMinInterval() const {
+            return this->useTscDeadline ? kMinIntervalDeadline : kMinIntervalCount;
+        }
+
     private:
         /// interrupt callback indicating the timer was triggered
         void fired();
         /// Measures the frequency of the timer by comparing against the PIT
         void measureTimerFreq();
 
+        /// Programs the timer in one-shot or periodic count mode
+        uint64_t setIntervalCount(const uint64_t nsec, const bool repeat);
+        /// Programs the timer in TSC-deadline mode
+        uint64_t setIntervalDeadline(const uint64_t nsec);
+
     private:
         /// Number of times we'll measure the APIC timer and average it
         constexpr static const size_t kTimeAverages = 5;
 
+        /**
+         * Minimum interval for the timer in count mode, in nanoseconds. Setting shorter intervals
+         * tends to lose timer interrupts, particularly in virtualized environments where the
+         * timer's resolution is rather poor.
+         */
+        constexpr static const uint64_t kMinIntervalCount = 50000;
+        /// Minimum interval for the timer in TSC-deadline mode, in nanoseconds
+        constexpr static const uint64_t kMinIntervalDeadline = 1000;
+
+        /// LVT timer mode: one-shot count
+        constexpr static const uint32_t kLvtModeOneShot = (0b00 << 17);
+        /// LVT timer mode: periodic count
+        constexpr static const uint32_t kLvtModePeriodic = (0b01 << 17);
+        /// LVT timer mode: TSC deadline
+        constexpr static const uint32_t kLvtModeTscDeadline = (0b10 << 17);
+        /// LVT mask bit
+        constexpr static const uint32_t kLvtMasked = (1 << 16);
+
+        /// whether the TSC-deadline mode is used, if supported
+        static bool gAllowTscDeadline;
+
         /// are the initializations of the timer logged?
         static bool gLogInit;
         /// are timer interval changes logged?
@@ -60,6 +97,8 @@ class ApicTimer {
 
         /// determine whether the timer always runs at a constant rate, regardless of P-states
         bool isConstantTime = false;
+        /// whether the timer is programmed with absolute TSC deadlines
+        bool useTscDeadline = false;
 };
 }
 
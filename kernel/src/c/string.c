@@ -1,4 +1,5 @@
 #include <string.h>
+#include <stdbool.h>
 
 /*
  * Portions of this code are taken from the OpenBSD libc, released under the
@@ -36,6 +37,226 @@
  * SUCH DAMAGE.
  */
 
+#if defined(__amd64__)
+#include <cpuid.h>
+
+/// Unaligned 64-bit accesses
+typedef uint64_t __attribute__((aligned(1), may_alias)) unaligned_u64;
+typedef uint32_t __attribute__((aligned(1), may_alias)) unaligned_u32;
+typedef uint16_t __attribute__((aligned(1), may_alias)) unaligned_u16;
+
+/// Whether the processor has enhanced rep movsb/stosb (ERMS)
+static bool gStringErms = false;
+
+/// Words with each byte set to 0x01 and 0x80, for finding bytes in a word at a time
+#define kBytes01                        (0x0101010101010101ULL)
+#define kBytes80                        (0x8080808080808080ULL)
+
+/**
+ * Selects the implementation of the string routines based on the processor's features. Until this
+ * is called, the baseline implementations are used.
+ */
+void string_init() {
+    uint32_t eax, ebx, ecx, edx;
+
+    if(__get_cpuid_max(0, NULL) < 0x07) return;
+    __cpuid_count(0x07, 0, eax, ebx, ecx, edx);
+
+    gStringErms = (ebx & (1 << 9));
+}
+
+/*
+ * Finds the first occurrence of value in the first num bytes of ptr. Eight bytes are tested at a
+ * time, once the pointer is aligned.
+ */
+const void *memchr(const void *ptr, const uint8_t value, const size_t num) {
+    const uint8_t *read = (const uint8_t *) ptr;
+    size_t i = 0;
+
+    for(; i < num && ((uintptr_t) (read + i) & 7); i++) {
+        if(read[i] == value) return &read[i];
+    }
+
+    const uint64_t pattern = kBytes01 * value;
+    for(; i + 8 <= num; i += 8) {
+        const uint64_t word = *(const uint64_t *) (read + i) ^ pattern;
+        if((word - kBytes01) & ~word & kBytes80) break;
+    }
+
+    for(; i < num; i++) {
+        if(read[i] == value) return &read[i];
+    }
+
+    return NULL;
+}
+
+/*
+ * Compares the first num bytes in two blocks of memory.
+ *
+ * Returns 0 if equal, a value greater than 0 if the first byte in ptr1 is greater than the first
+ * byte in ptr2; and a value less than zero if the opposite. Note that these comparisons are
+ * performed on uint8_t types.
+ */
+int memcmp(const void *ptr1, const void *ptr2, const size_t num) {
+    const uint8_t *read1 = (const uint8_t *) ptr1;
+    const uint8_t *read2 = (const uint8_t *) ptr2;
+    size_t i = 0;
+
+    // skip over equal words; the differing byte is then found below
+    for(; i + 8 <= num; i += 8) {
+        if(*(const unaligned_u64 *) (read1 + i) != *(const unaligned_u64 *) (read2 + i)) break;
+    }
+
+    for(; i < num; i++) {
+        if(read1[i] != read2[i]) {
+            if(read1[i] > read2[i]) return 1;
+            else return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Copies fewer than 32 bytes, using overlapping accesses at the start and end of the buffers.
+ * All loads happen before the stores.
+ */
+static inline void CopySmall(uint8_t *dst, const uint8_t *src, const size_t n) {
+    if(n >= 16) {
+        const uint64_t a = *(const unaligned_u64 *) src, b = *(const unaligned_u64 *) (src + 8);
+        const uint64_t c = *(const unaligned_u64 *) (src + n - 16);
+        const uint64_t d = *(const unaligned_u64 *) (src + n - 8);
+        *(unaligned_u64 *) dst = a;
+        *(unaligned_u64 *) (dst + 8) = b;
+        *(unaligned_u64 *) (dst + n - 16) = c;
+        *(unaligned_u64 *) (dst + n - 8) = d;
+    } else if(n >= 8) {
+        const uint64_t a = *(const unaligned_u64 *) src, b = *(const unaligned_u64 *) (src + n - 8);
+        *(unaligned_u64 *) dst = a;
+        *(unaligned_u64 *) (dst + n - 8) = b;
+    } else if(n >= 4) {
+        const uint32_t a = *(const unaligned_u32 *) src, b = *(const unaligned_u32 *) (src + n - 4);
+        *(unaligned_u32 *) dst = a;
+        *(unaligned_u32 *) (dst + n - 4) = b;
+    } else if(n >= 2) {
+        const uint16_t a = *(const unaligned_u16 *) src, b = *(const unaligned_u16 *) (src + n - 2);
+        *(unaligned_u16 *) dst = a;
+        *(unaligned_u16 *) (dst + n - 2) = b;
+    } else if(n) {
+        *dst = *src;
+    }
+}
+
+/*
+ * Copies num bytes from source to destination.
+ *
+ * We can't use vector registers in the kernel, so larger copies use the string instructions:
+ * `rep movsb` if the processor implements it efficiently, `rep movsq` otherwise.
+ */
+void *memcpy(void *destination, const void *source, const size_t num) {
+    uint8_t *dst = (uint8_t *) destination;
+    const uint8_t *src = (const uint8_t *) source;
+
+    if(num < 32) {
+        CopySmall(dst, src, num);
+    } else if(gStringErms) {
+        size_t count = num;
+        asm volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(count) :: "memory");
+    } else {
+        const uint64_t tail = *(const unaligned_u64 *) (src + num - 8);
+        size_t count = num / 8;
+        asm volatile("rep movsq" : "+D"(dst), "+S"(src), "+c"(count) :: "memory");
+        *(unaligned_u64 *) ((uint8_t *) destination + num - 8) = tail;
+    }
+
+    return destination;
+}
+
+/*
+ * Fills a given segment of memory with a specified value.
+ */
+void *memset(void *ptr, const uint8_t value, const size_t num) {
+    uint8_t *dst = (uint8_t *) ptr;
+    const uint64_t pattern = kBytes01 * value;
+
+    if(num < 16) {
+        if(num >= 8) {
+            *(unaligned_u64 *) dst = pattern;
+            *(unaligned_u64 *) (dst + num - 8) = pattern;
+        } else if(num >= 4) {
+            *(unaligned_u32 *) dst = pattern;
+            *(unaligned_u32 *) (dst + num - 4) = pattern;
+        } else if(num >= 2) {
+            *(unaligned_u16 *) dst = pattern;
+            *(unaligned_u16 *) (dst + num - 2) = pattern;
+        } else if(num) {
+            *dst = value;
+        }
+    } else if(gStringErms) {
+        size_t count = num;
+        asm volatile("rep stosb" : "+D"(dst), "+c"(count) : "a"(value) : "memory");
+    } else {
+        size_t count = num / 8;
+        asm volatile("rep stosq" : "+D"(dst), "+c"(count) : "a"(pattern) : "memory");
+        *(unaligned_u64 *) ((uint8_t *) ptr + num - 8) = pattern;
+    }
+
+    return ptr;
+}
+
+/*
+ * Clears count bytes of memory, starting at start, with 0x00.
+ */
+void* memclr(void *start, const size_t count) {
+    return memset(start, 0, count);
+}
+
+/**
+ * Moves the given memory region; they can overlap.
+ *
+ * If they don't, this is just a memcpy(). Otherwise, we copy a word at a time in the direction
+ * that ensures no source bytes are overwritten before they're read.
+ */
+void *memmove(void *dest, const void *src, const size_t n) {
+    uint8_t *d = (uint8_t *) dest;
+    const uint8_t *s = (const uint8_t *) src;
+
+    if(n < 32) {
+        CopySmall(d, s, n);
+        return dest;
+    } else if(((uintptr_t) d - (uintptr_t) s) >= n && ((uintptr_t) s - (uintptr_t) d) >= n) {
+        return memcpy(dest, src, n);
+    }
+
+    if(d < s) {
+        size_t i = 0;
+        for(; i + 8 <= n; i += 8) {
+            *(unaligned_u64 *) (d + i) = *(const unaligned_u64 *) (s + i);
+        }
+        for(; i < n; i++) {
+            d[i] = s[i];
+        }
+    } else if(d > s) {
+        size_t i = n;
+        for(; i >= 8; i -= 8) {
+            *(unaligned_u64 *) (d + i - 8) = *(const unaligned_u64 *) (s + i - 8);
+        }
+        while(i--) {
+            d[i] = s[i];
+        }
+    }
+
+    return dest;
+}
+
+#else
+/**
+ * There are no optimized string routines for this architecture.
+ */
+void string_init() {
+    // nothing
+}
+
 /*
  * Finds the first occurrence of value in the first num bytes of ptr.
  */
@@ -125,18 +346,30 @@ void* memclr(void *start, const size_t count) {
         *ptr++ = 0;
     }
 
-    return (void *) ((size_t) start + count);
+    return start;
 }
 
 /**
- * Moves the given memory region; they can overlap. A temporary stack buffer is used.
+ * Moves the given memory region; they can overlap. The copy is done in the direction that ensures
+ * no source bytes are overwritten before they're read.
  */
 void *memmove(void *dest, const void *src, const size_t n) {
-    unsigned char tmp[n];
-    memcpy(tmp, src, n);
-    memcpy(dest, tmp, n);
+    uint8_t *d = (uint8_t *) dest;
+    const uint8_t *s = (const uint8_t *) src;
+
+    if(d < s) {
+        for(size_t i = 0; i < n; i++) {
+            d[i] = s[i];
+        }
+    } else if(d > s) {
+        for(size_t i = n; i; i--) {
+            d[i - 1] = s[i - 1];
+        }
+    }
+
     return dest;
 }
+#endif
 
 
 
@@ -0,0 +1,330 @@
+#include "KernelLog.h"
+#include "LogRing.h"
+#include "FramebufferConsole.h"
+
+#include "sched/Scheduler.h"
+#include "sched/Task.h"
+#include "sched/Thread.h"
+
+#include <arch/critical.h>
+#include <arch/spinlock.h>
+#include <arch/PerCpuInfo.h>
+
+#include <log.h>
+#include <platform.h>
+#include <printf.h>
+#include <string.h>
+
+using namespace debug;
+
+/// Framebuffer console which we can use to print to
+namespace platform {
+    extern debug::FramebufferConsole *gConsole;
+};
+
+/// Size of the boot ring, used before processors have their own ring
+constexpr static const size_t kBootRingSize{16 * 1024};
+/// Size of the history ring, which holds messages after they've been drained
+constexpr static const size_t kHistorySize{64 * 1024};
+
+static uint8_t gBootRingStorage[kBootRingSize] __attribute__((aligned(64)));
+static LogRing gBootRing(gBootRingStorage, kBootRingSize);
+
+static uint8_t gHistoryStorage[kHistorySize] __attribute__((aligned(64)));
+static LogRing gHistory(gHistoryStorage, kHistorySize);
+
+/// Rings of all processors that have called `InitCore()`
+static LogRing *gCoreRings[KernelLog::kMaxCores]{nullptr};
+/// Number of entries in the core rings array
+static size_t gNumCoreRings{0};
+/// Set once the processor local info may be used to look up a processor's ring
+static bool gCoreRingsReady{false};
+
+/// Protects the consumer side of all rings, as well as the history ring
+DECLARE_SPINLOCK_S(gRingLock);
+/// Held while messages are being written to the spew port and console
+DECLARE_SPINLOCK_S(gOutputLock);
+
+/// Drain thread; once set, messages are no longer written synchronously
+static rt::SharedPtr<sched::Thread> gDrainThread;
+static bool gDrainRunning{false};
+/// Set when the drain thread has been notified, but hasn't started draining yet
+static bool gWakePending{false};
+/// Total number of dropped messages that have been reported
+static uint64_t gDroppedReported{0};
+
+/**
+ * printf wrapper to send a run of characters to the debug spew port
+ */
+static void _outchunk(const char *str, size_t length, void *ctx) {
+    for(size_t i = 0; i < length; i++) {
+        platform_debug_spew(str[i]);
+    }
+}
+
+/**
+ * printf wrapper to send a run of characters to the debug spew port and framebuffer console
+ */
+static void _outchunk_console(const char *str, size_t length, void *ctx) {
+    using namespace platform;
+    _outchunk(str, length, ctx);
+
+    if(gConsole) {
+        gConsole->write(str, length);
+    }
+}
+
+void debug::KernelLogDrainEntry(uintptr_t) {
+    KernelLog::DrainMain();
+}
+
+
+
+/**
+ * Allocates the log ring for the calling processor, and installs it in its processor local info
+ * structure. This must be called once the heap is available.
+ */
+void KernelLog::InitCore() {
+    auto storage = new uint8_t[kCoreRingSize];
+    REQUIRE(storage, "failed to allocate %s", "log ring");
+    memset(storage, 0, kCoreRingSize);
+
+    auto ring = new LogRing(storage, kCoreRingSize);
+    REQUIRE(ring, "failed to allocate %s", "log ring");
+
+    const auto index = __atomic_fetch_add(&gNumCoreRings, 1, __ATOMIC_RELAXED);
+    REQUIRE(index < kMaxCores, "too many log rings (%lu)", index);
+    __atomic_store_n(&gCoreRings[index], ring, __ATOMIC_RELEASE);
+
+    arch::GetProcLocal()->logRing = ring;
+    __atomic_store_n(&gCoreRingsReady, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Creates the drain thread. Any messages logged before this point have already been written out.
+ */
+void KernelLog::StartDrain() {
+    auto thread = sched::Thread::kernelThread(sched::Task::kern(), KernelLogDrainEntry, 0);
+    REQUIRE(thread, "failed to allocate %s", "log drain thread");
+
+    thread->setName("kernel log drain");
+    thread->setPriority(kDrainPriority);
+
+    gDrainThread = thread;
+    __atomic_store_n(&gDrainRunning, true, __ATOMIC_RELEASE);
+
+    thread->setState(sched::Thread::State::Runnable);
+    sched::Scheduler::get()->markThreadAsRunnable(thread, false);
+}
+
+/**
+ * Writes a message to the calling processor's log ring. If the ring is full, the message is
+ * discarded, and will be reported as dropped when the ring is next drained.
+ *
+ * The drain thread is woken if we're at a low enough irql to call into the scheduler; otherwise,
+ * the message is picked up the next time it checks for messages.
+ */
+void KernelLog::Write(const char *msg, const size_t msgLen) {
+    const auto timestamp = platform_timer_now();
+
+    LogRing *ring = &gBootRing;
+    uint8_t coreId = 0;
+
+    if(__atomic_load_n(&gCoreRingsReady, __ATOMIC_ACQUIRE)) {
+        auto proc = arch::GetProcLocal();
+        coreId = proc->getCoreId();
+        if(proc->logRing) ring = proc->logRing;
+    }
+
+    ring->write(coreId, timestamp, msg, msgLen);
+
+    // write the message out now if the drain thread doesn't exist yet
+    if(!__atomic_load_n(&gDrainRunning, __ATOMIC_ACQUIRE)) {
+        Drain(false);
+    }
+    // otherwise, wake it
+    else if(platform_get_irql() <= platform::Irql::Dpc &&
+            !__atomic_test_and_set(&gWakePending, __ATOMIC_RELAXED)) {
+        gDrainThread->notify(kWakeBit);
+    }
+}
+
+/**
+ * Writes out all buffered messages to the spew port. This ignores all locks, since the processors
+ * holding them may have been halted.
+ */
+void KernelLog::PanicFlush() {
+    uint8_t buf[LogRing::kMaxRecordSize];
+
+    while(TakeRecord(buf)) {
+        Output(buf, false);
+    }
+}
+
+/**
+ * Copies as many complete log records as fit into the provided buffer from the history ring,
+ * starting at the record at the given offset. If the oldest records have already been discarded,
+ * copying starts at the oldest record still available.
+ *
+ * @param cursor Offset of the first record to copy; updated to the offset of the next record
+ * @param outBuf Buffer to receive records, including padding to their full size
+ * @param outBufLen Size of the output buffer in bytes
+ *
+ * @return Number of bytes copied to the buffer
+ */
+size_t KernelLog::ReadHistory(uint64_t &cursor, void *outBuf, const size_t outBufLen) {
+    auto out = reinterpret_cast<uint8_t *>(outBuf);
+    size_t copied{0};
+
+    DECLARE_CRITICAL();
+    CRITICAL_ENTER();
+    SPIN_LOCK(gRingLock);
+
+    if(cursor < gHistory.getReadOffset()) {
+        cursor = gHistory.getReadOffset();
+    }
+
+    while(auto record = gHistory.at(cursor)) {
+        if(record->flags & LogRing::Record::Flags::Padding) {
+            cursor += record->size;
+            continue;
+        }
+        if(copied + record->size > outBufLen) break;
+
+        memcpy(out + copied, record, record->size);
+        copied += record->size;
+        cursor += record->size;
+    }
+
+    SPIN_UNLOCK(gRingLock);
+    CRITICAL_EXIT();
+
+    return copied;
+}
+
+
+
+/**
+ * Writes out messages from all rings until they're empty. If another processor is already doing
+ * so, we return immediately; it will pick up our messages as well.
+ *
+ * @param critical Whether the ring lock is taken in a critical section; this should be the case
+ *        once other threads may run.
+ */
+void KernelLog::Drain(const bool critical) {
+    uint8_t buf[LogRing::kMaxRecordSize];
+
+    if(SPIN_TRY_LOCK(gOutputLock)) {
+        return;
+    }
+
+    while(NextRecord(buf, critical)) {
+        Output(buf, true);
+    }
+
+    // report any messages that were dropped since we last checked
+    uint64_t dropped{gBootRing.getDropped()};
+    const auto numRings = __atomic_load_n(&gNumCoreRings, __ATOMIC_RELAXED);
+    for(size_t i = 0; i < numRings; i++) {
+        auto ring = __atomic_load_n(&gCoreRings[i], __ATOMIC_ACQUIRE);
+        if(ring) dropped += ring->getDropped();
+    }
+
+    if(dropped != gDroppedReported) {
+        chunkprintf(_outchunk_console, nullptr, "[%16llu] (%llu log messages dropped)\n",
+                platform_timer_now(), dropped - gDroppedReported);
+        gDroppedReported = dropped;
+    }
+
+    SPIN_UNLOCK(gOutputLock);
+}
+
+/**
+ * Removes the oldest record from the rings, and appends it to the history ring, under protection
+ * of the ring lock.
+ */
+bool KernelLog::NextRecord(void *outBuf, const bool critical) {
+    DECLARE_CRITICAL();
+    if(critical) CRITICAL_ENTER();
+    SPIN_LOCK(gRingLock);
+
+    const bool got = TakeRecord(outBuf);
+
+    SPIN_UNLOCK(gRingLock);
+    if(critical) CRITICAL_EXIT();
+
+    return got;
+}
+
+/**
+ * Finds the oldest record across all rings, copies it to the provided buffer, and removes it from
+ * its ring. It's also added to the history ring, discarding the oldest history if needed.
+ *
+ * @param outBuf Buffer to receive the record; it must be at least `LogRing::kMaxRecordSize` bytes
+ *
+ * @return Whether a record was copied
+ */
+bool KernelLog::TakeRecord(void *outBuf) {
+    LogRing *oldest{nullptr};
+    const LogRing::Record *oldestRecord{nullptr};
+
+    // find the ring whose first record is the oldest
+    auto check = [&](LogRing *ring) {
+        auto record = ring->peek();
+        if(record && (!oldestRecord || record->timestamp < oldestRecord->timestamp)) {
+            oldest = ring;
+            oldestRecord = record;
+        }
+    };
+
+    check(&gBootRing);
+
+    const auto numRings = __atomic_load_n(&gNumCoreRings, __ATOMIC_RELAXED);
+    for(size_t i = 0; i < numRings; i++) {
+        auto ring = __atomic_load_n(&gCoreRings[i], __ATOMIC_ACQUIRE);
+        if(ring) check(ring);
+    }
+
+    if(!oldest) {
+        return false;
+    }
+
+    // copy it out, then release it
+    memcpy(outBuf, oldestRecord, sizeof(LogRing::Record) + oldestRecord->length);
+    oldest->consume();
+
+    // add it to the history
+    auto record = reinterpret_cast<const LogRing::Record *>(outBuf);
+
+    while(!gHistory.write(record->coreId, record->timestamp, record->message(), record->length)) {
+        if(!gHistory.peek()) break;
+        gHistory.consume();
+    }
+
+    return true;
+}
+
+/**
+ * Prints a single log record.
+ */
+void KernelLog::Output(const void *_record, const bool toConsole) {
+    auto record = reinterpret_cast<const LogRing::Record *>(_record);
+
+    chunkprintf(toConsole ? _outchunk_console : _outchunk, nullptr, "[%16llu %2x] %.*s\n",
+            record->timestamp, record->coreId, static_cast<int>(record->length),
+            record->message());
+}
+
+/**
+ * Main loop of the drain thread: write out all pending messages, then wait to be woken up again.
+ */
+void KernelLog::DrainMain() {
+    auto thread = sched::Thread::current();
+
+    while(true) {
+        __atomic_clear(&gWakePending, __ATOMIC_RELAXED);
+        Drain(true);
+
+        thread->blockNotify(kWakeBit, kDrainInterval);
+    }
+}
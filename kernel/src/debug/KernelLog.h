@@ -0,0 +1,63 @@
+#ifndef DEBUG_KERNELLOG_H
+#define DEBUG_KERNELLOG_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace debug {
+void KernelLogDrainEntry(uintptr_t arg);
+
+/**
+ * Kernel log message buffering
+ *
+ * Messages are written into a lock-free ring buffer belonging to the processor that logged them,
+ * together with a timestamp and the processor's ID; this makes logging cheap enough to do from any
+ * context, including interrupt handlers and the scheduler. Until each processor's ring has been
+ * allocated, a shared boot ring is used instead.
+ *
+ * A low priority kernel thread drains the rings in timestamp order and writes the messages to the
+ * debug spew port and framebuffer console. Drained messages are kept in a history ring, which can
+ * be read from userspace. Before the drain thread has been started, messages are written out
+ * synchronously as they're logged.
+ */
+class KernelLog {
+    friend void KernelLogDrainEntry(uintptr_t arg);
+
+    public:
+        /// Size of each processor's log ring, in bytes
+        constexpr static const size_t kCoreRingSize{16 * 1024};
+        /// Maximum number of processors with their own log ring
+        constexpr static const size_t kMaxCores{64};
+
+        /// Allocates the log ring for the calling processor.
+        static void InitCore();
+        /// Starts the drain thread; after this, messages are no longer written synchronously.
+        static void StartDrain();
+
+        /// Writes a message to the calling processor's log ring.
+        static void Write(const char *msg, const size_t msgLen);
+        /// Writes out all buffered messages, ignoring any locks. Only call this when panicking.
+        static void PanicFlush();
+
+        /// Copies log records from the history ring, starting at the given offset.
+        static size_t ReadHistory(uint64_t &cursor, void *outBuf, const size_t outBufLen);
+
+    private:
+        static void Drain(const bool critical);
+        static bool NextRecord(void *outBuf, const bool critical);
+        static bool TakeRecord(void *outBuf);
+        static void Output(const void *record, const bool toConsole);
+
+        static void DrainMain();
+
+    private:
+        /// Notification bit used to wake the drain thread
+        constexpr static const uintptr_t kWakeBit{(1 << 0)};
+        /// Interval at which the drain thread checks for messages, even if not woken (in ns)
+        constexpr static const uint64_t kDrainInterval{100'000'000ULL};
+        /// Priority of the drain thread
+        constexpr static const int16_t kDrainPriority{-90};
+};
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "LogRing.h"
+
+#include <string.h>
+
+using namespace debug;
+
+/**
+ * Writes a record to the ring. Messages longer than the maximum record size are truncated.
+ *
+ * If the record doesn't fit in the space left before the end of the storage, a padding record is
+ * written there and the record itself is placed at the start of the storage.
+ *
+ * @return Whether the record was written; this fails only if the ring is full.
+ */
+bool LogRing::write(const uint8_t coreId, const uint64_t timestamp, const char *msg,
+        size_t msgLen) {
+    if(msgLen > kMaxMessage) msgLen = kMaxMessage;
+    const auto recordSize = RecordSize(msgLen);
+
+    // reserve space for the record (and padding, if it would wrap around)
+    uint64_t start, padding;
+    auto expected = __atomic_load_n(&this->writeOffset, __ATOMIC_RELAXED);
+
+    do {
+        start = expected;
+
+        const auto toEnd = this->size - (start & (this->size - 1));
+        padding = (recordSize > toEnd) ? toEnd : 0;
+
+        const auto read = __atomic_load_n(&this->readOffset, __ATOMIC_ACQUIRE);
+        if((start + padding + recordSize) - read > this->size) {
+            __atomic_add_fetch(&this->dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+    } while(!__atomic_compare_exchange_n(&this->writeOffset, &expected,
+                start + padding + recordSize, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    // write the padding record
+    if(padding) {
+        auto pad = this->recordAt(start);
+        pad->length = 0;
+        pad->coreId = coreId;
+        pad->flags = Record::Flags::Padding;
+        pad->timestamp = timestamp;
+
+        __atomic_store_n(&pad->size, static_cast<uint32_t>(padding), __ATOMIC_RELEASE);
+    }
+
+    // then the record; it's committed once its size is written
+    auto record = this->recordAt(start + padding);
+    record->length = msgLen;
+    record->coreId = coreId;
+    record->flags = 0;
+    record->timestamp = timestamp;
+    memcpy(record + 1, msg, msgLen);
+
+    __atomic_store_n(&record->size, static_cast<uint32_t>(recordSize), __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * Returns the oldest record in the ring, skipping over any padding records.
+ *
+ * @return Oldest record, or `nullptr` if the ring is empty or the oldest record has been reserved
+ *         but not yet committed.
+ */
+const LogRing::Record *LogRing::peek() {
+    while(true) {
+        auto record = this->recordAt(this->readOffset);
+        if(!__atomic_load_n(&record->size, __ATOMIC_ACQUIRE)) {
+            return nullptr;
+        }
+
+        if(record->flags & Record::Flags::Padding) {
+            this->consume();
+            continue;
+        }
+
+        return record;
+    }
+}
+
+/**
+ * Releases the oldest record in the ring. Its storage is zeroed before it may be reused, so that
+ * uncommitted records can be detected.
+ *
+ * @note You must have previously gotten the record via `peek()`.
+ */
+void LogRing::consume() {
+    const auto read = this->readOffset;
+    auto record = this->recordAt(read);
+    const auto recordSize = record->size;
+
+    memset(record, 0, recordSize);
+    __atomic_store_n(&this->readOffset, read + recordSize, __ATOMIC_RELEASE);
+}
+
+/**
+ * Returns the record at the given offset, which must be the start of a record. Padding records are
+ * returned as well, so that the caller may skip over them.
+ *
+ * @note The caller must ensure that the record isn't consumed while it's being accessed.
+ */
+const LogRing::Record *LogRing::at(const uint64_t offset) const {
+    if(offset < this->getReadOffset() || offset >= __atomic_load_n(&this->writeOffset,
+                __ATOMIC_RELAXED)) {
+        return nullptr;
+    }
+
+    auto record = this->recordAt(offset);
+    if(!__atomic_load_n(&record->size, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+
+    return record;
+}
@@ -0,0 +1,112 @@
+#ifndef DEBUG_LOGRING_H
+#define DEBUG_LOGRING_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace debug {
+/**
+ * A ring buffer of variable length log records.
+ *
+ * Any number of producers may write records concurrently without taking locks: space is reserved
+ * by atomically advancing the write offset, then the record is filled in and committed by storing
+ * its size last. This makes it safe to write to from interrupt handlers, including ones that
+ * interrupt another producer on the same core. There may only be a single consumer at a time.
+ *
+ * Offsets into the ring increase monotonically, and are only reduced modulo the ring's size when
+ * accessing the storage. All unused storage is kept zeroed, so a record whose size is zero has been
+ * reserved, but not yet committed.
+ */
+class LogRing {
+    public:
+        /**
+         * Header of a record in the ring, followed by the message text. The message is not zero
+         * terminated, and records are padded so that the next one is aligned.
+         */
+        struct Record {
+            /// Flags for a record
+            enum Flags: uint8_t {
+                /// The record is padding before the ring wraps around, and contains no message
+                Padding                 = (1 << 0),
+            };
+
+            /// Total size of the record, including the header and padding; 0 if uncommitted
+            uint32_t size;
+            /// Length of the message text, in bytes
+            uint16_t length;
+            /// Processor that wrote the record
+            uint8_t coreId;
+            /// Record flags
+            uint8_t flags;
+            /// Timestamp at which the record was written (in ns since boot)
+            uint64_t timestamp;
+
+            /// Returns the message text following the header
+            inline const char *message() const {
+                return reinterpret_cast<const char *>(this + 1);
+            }
+        };
+        static_assert(sizeof(Record) == 16, "invalid log record size");
+
+        /// Alignment of records in the ring
+        constexpr static const size_t kRecordAlignment{sizeof(Record)};
+        /// Maximum length of a message in a single record
+        constexpr static const size_t kMaxMessage{512};
+        /// Largest possible record
+        constexpr static const size_t kMaxRecordSize{sizeof(Record) + kMaxMessage};
+
+    public:
+        /**
+         * Creates a ring using the given storage. Its size must be a power of two, and it must
+         * initially be zeroed.
+         */
+        constexpr LogRing(uint8_t *_storage, const size_t _size) : storage(_storage),
+            size(_size) {}
+
+        /// Writes a record to the ring.
+        bool write(const uint8_t coreId, const uint64_t timestamp, const char *msg, size_t msgLen);
+
+        /// Returns the oldest committed record in the ring, if any.
+        const Record *peek();
+        /// Releases the oldest record in the ring.
+        void consume();
+
+        /// Returns the record at the given offset, or `nullptr` if it's not available.
+        const Record *at(const uint64_t offset) const;
+
+        /// Offset of the oldest record in the ring
+        inline uint64_t getReadOffset() const {
+            return __atomic_load_n(&this->readOffset, __ATOMIC_ACQUIRE);
+        }
+        /// Number of records discarded because the ring was full
+        inline uint64_t getDropped() const {
+            return __atomic_load_n(&this->dropped, __ATOMIC_RELAXED);
+        }
+
+        /// Rounds a message length up to the size of the record holding it.
+        constexpr static inline size_t RecordSize(const size_t msgLen) {
+            return (sizeof(Record) + msgLen + (kRecordAlignment - 1)) & ~(kRecordAlignment - 1);
+        }
+
+    private:
+        /// Returns a pointer to the record at the given offset
+        inline Record *recordAt(const uint64_t offset) const {
+            return reinterpret_cast<Record *>(this->storage + (offset & (this->size - 1)));
+        }
+
+    private:
+        /// Storage for records
+        uint8_t *storage;
+        /// Size of the storage, in bytes
+        size_t size;
+
+        /// Offset at which the next record will be written
+        uint64_t writeOffset{0};
+        /// Offset of the oldest record that has not been consumed
+        uint64_t readOffset{0};
+        /// Number of records dropped because the ring was full
+        uint64_t dropped{0};
+};
+}
+
+#endif
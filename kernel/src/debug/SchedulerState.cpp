@@ -13,9 +13,9 @@ namespace platform {
     extern debug::FramebufferConsole *gConsole;
 };
 
-static void _outchar(char ch, void *) {
+static void _outchunk(const char *str, size_t length, void *) {
     using namespace platform;
-    if(gConsole) gConsole->write(ch);
+    if(gConsole) gConsole->write(str, length);
 }
 
 void debug::SchedulerStateEntry(uintptr_t arg) {
@@ -51,16 +51,16 @@ void SchedulerState::main() {
     gConsole->write("\033[;HThread State ");
 
     while(this->run) {
-        fctprintf(_outchar, 0, "\033[2;HTime: %16lu\n\n", platform_timer_now());
+        chunkprintf(_outchunk, 0, "\033[2;HTime: %16lu\n\n", platform_timer_now());
 
         // iterate over all tasks
         auto gs = GlobalState::the();
 
         for(const auto &task : gs->getTasks()) {
-            fctprintf(_outchar, 0, "%4lu $%p'h    %20s\n", task->pid, task->handle, task->name);
+            chunkprintf(_outchunk, 0, "%4lu $%p'h    %20s\n", task->pid, task->handle, task->name);
 
             // print each thread
-            fctprintf(_outchar, 0, " \x5  tid Handle              %20s S lv pr %14s %14s %8s %8s %8s %8s\n",
+            chunkprintf(_outchunk, 0, " \x5  tid Handle              %20s S lv pr %14s %14s %8s %8s %8s %8s\n",
                     "Name", "CPU Time", "Last Sched", "RQ Push", "RQ Pop", "Q used", "Q total");
             for(const auto &thread : task->threads) {
                 const auto &sched = thread->sched;
@@ -87,7 +87,7 @@ void SchedulerState::main() {
                         break;
                 }
 
-                fctprintf(_outchar, 0, " \x4 %4lu $%p'h %20s %s %2u %2u %14lu %14lu %8lu %8lu %8lu %8lu\n", 
+                chunkprintf(_outchunk, 0, " \x4 %4lu $%p'h %20s %s %2u %2u %14lu %14lu %8lu %8lu %8lu %8lu\n", 
                         thread->tid, thread->handle, thread->name, state, sched.level, sched.lastLevel,
                         sched.cpuTime, thread->lastSwitchedTo, sched.queuePushed, sched.queuePopped,
                         sched.quantumUsed / 10, sched.quantumTotal / 10);
@@ -95,17 +95,17 @@ void SchedulerState::main() {
 
             // print each port
             if(!task->ports.empty()) {
-                fctprintf(_outchar, 0, " \x5 Handle              %5s %14s %14s\n",
+                chunkprintf(_outchunk, 0, " \x5 Handle              %5s %14s %14s\n",
                         "Pend", "Total Rx", "Total Tx");
                 for(const auto &port : task->ports) {
-                    fctprintf(_outchar, 0, " \x4 $%p'h %5lu %14lu %14lu\n", port->getHandle(),
+                    chunkprintf(_outchunk, 0, " \x4 $%p'h %5lu %14lu %14lu\n", port->getHandle(),
                             port->messagesPending(), port->getTotalReceived(), port->getTotalSent());
 
                 }
             }
 
             // footer
-            fctprintf(_outchar, 0, "\n");
+            chunkprintf(_outchunk, 0, "\n");
         }
 
         // yeet
@@ -113,6 +113,6 @@ void SchedulerState::main() {
     }
 
     // terminate thread
-    fctprintf(_outchar, 0, "\033[;H\033[41mThread state exited\033[m");
+    chunkprintf(_outchunk, 0, "\033[;H\033[41mThread state exited\033[m");
     Thread::current()->terminate();
 }
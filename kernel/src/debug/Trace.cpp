@@ -0,0 +1,162 @@
+#include "Trace.h"
+
+#include "sched/Scheduler.h"
+#include "sched/Thread.h"
+
+#include <arch/critical.h>
+#include <arch/spinlock.h>
+#include <arch/PerCpuInfo.h>
+
+#include <log.h>
+#include <platform.h>
+#include <string.h>
+
+using namespace debug;
+
+/**
+ * Trace buffer for a single processor. Records are written at `head`, which only ever increases;
+ * the slot for a record is its sequence number modulo the buffer size.
+ */
+struct debug::TraceBuffer {
+    /// Sequence number of the next record to write
+    uint64_t head{0};
+    /// Sequence number of the next record to read
+    uint64_t tail{0};
+
+    /// Record storage
+    TraceRecord records[Trace::kRecordsPerCore];
+};
+
+uint32_t Trace::gMask{0};
+
+/// Buffers of all processors that have called `InitCore()`
+static TraceBuffer *gBuffers[Trace::kMaxCores]{nullptr};
+/// Number of entries in the buffers array
+static size_t gNumBuffers{0};
+
+/// Serializes readers of the trace buffers
+DECLARE_SPINLOCK_S(gReadLock);
+
+/**
+ * Allocates the trace buffer for the calling processor, and installs it in its processor local
+ * info structure. This must be called once the heap is available.
+ */
+void Trace::InitCore() {
+    auto buf = new TraceBuffer;
+    REQUIRE(buf, "failed to allocate %s", "trace buffer");
+    memset(buf->records, 0, sizeof(buf->records));
+
+    const auto index = __atomic_fetch_add(&gNumBuffers, 1, __ATOMIC_RELAXED);
+    REQUIRE(index < kMaxCores, "too many trace buffers (%lu)", index);
+    __atomic_store_n(&gBuffers[index], buf, __ATOMIC_RELEASE);
+
+    arch::GetProcLocal()->traceBuffer = buf;
+}
+
+/**
+ * Updates the mask of enabled trace categories.
+ *
+ * @return Previous mask
+ */
+uint32_t Trace::SetMask(const uint32_t mask) {
+    return __atomic_exchange_n(&gMask, mask, __ATOMIC_RELAXED);
+}
+
+/**
+ * Writes an event to the calling processor's trace buffer, overwriting the oldest record if it's
+ * full. An interrupt that records an event while we're writing one simply gets the next slot.
+ *
+ * @note This is also called directly from the syscall entry code; its signature must not change.
+ */
+void Trace::Record(const TraceEvent event, const uint64_t arg0, const uint64_t arg1,
+        const uint64_t arg2, const uint64_t arg3) {
+    auto proc = arch::GetProcLocal();
+    auto buf = proc->traceBuffer;
+    if(!buf) return;
+
+    uint64_t thread{0};
+    if(proc->sched) {
+        auto running = proc->sched->runningThread();
+        if(running) thread = static_cast<uintptr_t>(running->getHandle());
+    }
+
+    // reserve a slot and invalidate it while we write it
+    const auto seq = __atomic_fetch_add(&buf->head, 1, __ATOMIC_RELAXED);
+    auto &record = buf->records[seq % kRecordsPerCore];
+
+    __atomic_store_n(&record.sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record.timestamp = platform::GetLocalTsc();
+    record.thread = thread;
+    record.event = event;
+    record.coreId = proc->getCoreId();
+    record.reserved = 0;
+    record.args[0] = arg0;
+    record.args[1] = arg1;
+    record.args[2] = arg2;
+    record.args[3] = arg3;
+
+    __atomic_store_n(&record.sequence, seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copies as many records as fit into the given buffer, removing them from the trace buffers. The
+ * records from each processor are in order, but records from different processors are not merged.
+ *
+ * @param outBuf Buffer to receive trace records
+ * @param outBufLen Size of the buffer, in bytes
+ * @param lost Incremented by the number of records that were overwritten before being read
+ *
+ * @return Number of bytes of records copied
+ */
+size_t Trace::Read(void *outBuf, const size_t outBufLen, uint64_t &lost) {
+    auto out = reinterpret_cast<TraceRecord *>(outBuf);
+    const auto maxRecords = outBufLen / sizeof(TraceRecord);
+    size_t copied{0};
+
+    DECLARE_CRITICAL();
+    CRITICAL_ENTER();
+    SPIN_LOCK(gReadLock);
+
+    const auto numBuffers = __atomic_load_n(&gNumBuffers, __ATOMIC_RELAXED);
+    for(size_t i = 0; i < numBuffers && copied < maxRecords; i++) {
+        auto buf = __atomic_load_n(&gBuffers[i], __ATOMIC_ACQUIRE);
+        if(!buf) continue;
+
+        // skip records that have already been overwritten
+        const auto head = __atomic_load_n(&buf->head, __ATOMIC_ACQUIRE);
+        if(head - buf->tail > kRecordsPerCore) {
+            lost += (head - buf->tail) - kRecordsPerCore;
+            buf->tail = head - kRecordsPerCore;
+        }
+
+        while(buf->tail != head && copied < maxRecords) {
+            const auto &record = buf->records[buf->tail % kRecordsPerCore];
+            const auto expected = buf->tail + 1;
+
+            // the record is still being written
+            auto seq = __atomic_load_n(&record.sequence, __ATOMIC_ACQUIRE);
+            if(seq < expected) break;
+
+            // copy it, then ensure it wasn't overwritten in the meantime
+            if(seq == expected) {
+                memcpy(&out[copied], &record, sizeof(record));
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                seq = __atomic_load_n(&record.sequence, __ATOMIC_RELAXED);
+            }
+
+            if(seq == expected) {
+                copied++;
+            } else {
+                lost++;
+            }
+            buf->tail++;
+        }
+    }
+
+    SPIN_UNLOCK(gReadLock);
+    CRITICAL_EXIT();
+
+    return copied * sizeof(TraceRecord);
+}
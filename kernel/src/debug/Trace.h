@@ -0,0 +1,135 @@
+#ifndef DEBUG_TRACE_H
+#define DEBUG_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace debug {
+/**
+ * Categories of trace events; each of them can be enabled individually at runtime. The value is
+ * the bit index in the trace mask.
+ */
+enum class TraceCategory: uint8_t {
+    Scheduler                           = 0,
+    Ipc                                 = 1,
+    Vm                                  = 2,
+    Irq                                 = 3,
+    Syscall                             = 4,
+};
+
+/**
+ * Types of trace events. The high byte of each value is the category the event belongs to.
+ *
+ * The meaning of each event's arguments is noted next to it; the host side trace decoder must be
+ * kept in sync with these.
+ */
+enum class TraceEvent: uint16_t {
+    /// Context switch: outgoing thread handle, incoming thread handle, outgoing thread state
+    ContextSwitch                       = 0x0001,
+
+    /// Message sent to port: port handle, message length, status
+    PortSend                            = 0x0101,
+    /// Message received from port: port handle, buffer length, status or bytes received
+    PortReceive                         = 0x0102,
+
+    /// Anonymous memory page fault: faulting address, write, VM object base, time taken (ns)
+    PageFault                           = 0x0201,
+
+    /// Interrupt delivered to thread: irq number, irq vector, thread handle, notification bits
+    Irq                                 = 0x0301,
+
+    /// System call entry: syscall number, first three arguments
+    SyscallEnter                        = 0x0401,
+    /// System call return: syscall number, return value
+    SyscallExit                         = 0x0402,
+};
+
+/*
+ * The amd64 syscall entry code (arch/x86_64/src/syscall/entry.S) can't include this header, so it
+ * hardcodes the syscall category mask bit and event types; these must be kept in sync.
+ */
+static_assert((1U << static_cast<uint8_t>(TraceCategory::Syscall)) == (1 << 4),
+        "syscall trace category bit doesn't match entry.S");
+static_assert(static_cast<uint16_t>(TraceEvent::SyscallEnter) == 0x0401,
+        "syscall enter trace event doesn't match entry.S");
+static_assert(static_cast<uint16_t>(TraceEvent::SyscallExit) == 0x0402,
+        "syscall exit trace event doesn't match entry.S");
+
+/**
+ * A single trace record. Records are a fixed size so that they can be written to (and read from)
+ * the per processor trace buffers without any locking.
+ */
+struct TraceRecord {
+    /// Sequence number of the record in its processor's buffer, plus one; 0 while being written
+    uint64_t sequence;
+    /// Timestamp counter (in ns) at the time the event was recorded
+    uint64_t timestamp;
+    /// Handle of the thread that was running when the event was recorded
+    uint64_t thread;
+    /// Event type
+    TraceEvent event;
+    /// Processor that recorded the event
+    uint16_t coreId;
+    /// Reserved; always 0
+    uint32_t reserved;
+    /// Event specific arguments
+    uint64_t args[4];
+};
+static_assert(sizeof(TraceRecord) == 64, "invalid trace record size");
+
+struct TraceBuffer;
+
+/**
+ * Low overhead binary event tracing
+ *
+ * Tracepoints throughout the kernel record events into a buffer belonging to the processor they
+ * occur on. Each buffer is a ring of fixed size records that overwrites its oldest records when
+ * full, so that tracing may be left running to catch rare events. If the category an event belongs
+ * to is disabled, the tracepoint costs a single load and branch.
+ *
+ * Records are read out of the buffers (in per processor order) via a syscall, then converted to a
+ * viewable format on the host by the `tracedump` tool.
+ */
+class Trace {
+    public:
+        /// Number of records in each processor's trace buffer
+        constexpr static const size_t kRecordsPerCore{1024};
+        /// Maximum number of processors with a trace buffer
+        constexpr static const size_t kMaxCores{64};
+
+        /// Allocates the trace buffer for the calling processor.
+        static void InitCore();
+
+        /// Returns whether events of the given type are being recorded
+        static inline bool IsEnabled(const TraceEvent event) {
+            const auto category = static_cast<uint16_t>(event) >> 8;
+            return __atomic_load_n(&gMask, __ATOMIC_RELAXED) & (1U << category);
+        }
+
+        /// Records an event, if its category is enabled.
+        static inline void Emit(const TraceEvent event, const uint64_t arg0 = 0,
+                const uint64_t arg1 = 0, const uint64_t arg2 = 0, const uint64_t arg3 = 0) {
+            if(__builtin_expect(IsEnabled(event), 0)) {
+                Record(event, arg0, arg1, arg2, arg3);
+            }
+        }
+
+        /// Updates the mask of enabled categories, returning the previous mask.
+        static uint32_t SetMask(const uint32_t mask);
+        /// Copies records out of all trace buffers.
+        static size_t Read(void *outBuf, const size_t outBufLen, uint64_t &lost);
+
+        /// Writes an event to the calling processor's trace buffer.
+        static void Record(const TraceEvent event, const uint64_t arg0, const uint64_t arg1,
+                const uint64_t arg2, const uint64_t arg3);
+
+    public:
+        /**
+         * Mask of enabled trace categories; bit n corresponds to the category with value n. This
+         * is read directly by the syscall entry code.
+         */
+        static uint32_t gMask;
+};
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "sched/Task.h"
 #include "sys/Syscall.h"
 #include "handle/Manager.h"
+#include "debug/KernelLog.h"
 
 #include <arch.h>
 #include <platform.h>
@@ -61,6 +62,9 @@ void kernel_init() {
 void kernel_main() {
     PrintBanner();
 
+    // from here on, log messages are written out asynchronously
+    debug::KernelLog::StartDrain();
+
     // kernel is initialized. launch the root server
     gRootServer = platform::InitRootsrv();
 
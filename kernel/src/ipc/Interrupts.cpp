@@ -1,6 +1,7 @@
 #include "Interrupts.h"
 
 #include "log.h"
+#include "debug/Trace.h"
 #include "handle/Manager.h"
 #include "sched/Thread.h"
 
@@ -30,6 +31,9 @@ IrqHandler::~IrqHandler() {
  */
 void IrqHandler::fired() {
     REQUIRE(this->thread, "cannot deliver irq to nonexistent thread");
+
+    debug::Trace::Emit(debug::TraceEvent::Irq, this->irqNum, this->irqVector,
+            static_cast<uintptr_t>(this->thread->getHandle()), this->bits);
     this->thread->notify(this->bits);
 }
 
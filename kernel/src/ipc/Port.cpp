@@ -2,6 +2,8 @@
 
 #include "mem/SlabAllocator.h"
 
+#include "debug/Trace.h"
+
 #include <arch/critical.h>
 #include <log.h>
 
@@ -87,6 +89,9 @@ int Port::send(const void *msgBuf, const size_t msgLen) {
     if(this->maxMessages && this->messages.size() >= this->maxMessages) {
         RW_UNLOCK_WRITE(&this->lock);
         CRITICAL_EXIT();
+
+        debug::Trace::Emit(debug::TraceEvent::PortSend, static_cast<uintptr_t>(this->handle),
+                msgLen, -1);
         return -1;
     }
 
@@ -103,6 +108,9 @@ int Port::send(const void *msgBuf, const size_t msgLen) {
 
     // wake any pending task
     this->receiverBlocker->messageQueued();
+
+    debug::Trace::Emit(debug::TraceEvent::PortSend, static_cast<uintptr_t>(this->handle), msgLen,
+            0);
     return 0;
 
 }
@@ -153,6 +161,9 @@ int Port::receive(Handle &sender, void *msgBuf, const size_t msgBufLen, const ui
 
         RW_UNLOCK_WRITE(&this->lock);
         CRITICAL_EXIT();
+
+        debug::Trace::Emit(debug::TraceEvent::PortReceive, static_cast<uintptr_t>(this->handle),
+                msgBufLen, toCopy);
         return toCopy;
     }
     // no messages on the queue, but we don't want to block; so abort
@@ -169,7 +180,8 @@ int Port::receive(Handle &sender, void *msgBuf, const size_t msgBufLen, const ui
      * we received a message, whether that is because we actually got one or the block was
      * aborted.
      */
-    unblockReason = thread->blockOn(this->receiverBlocker);
+    unblockReason = thread->blockOn(this->receiverBlocker,
+            (blockUntil == UINT64_MAX) ? 0 : blockUntil);
     if(unblockReason == BlockOnReturn::Error) {
         return -2;
     }
@@ -190,6 +202,9 @@ int Port::receive(Handle &sender, void *msgBuf, const size_t msgBufLen, const ui
 
         RW_UNLOCK_WRITE(&this->lock);
         CRITICAL_EXIT();
+
+        debug::Trace::Emit(debug::TraceEvent::PortReceive, static_cast<uintptr_t>(this->handle),
+                msgBufLen, toCopy);
         return toCopy;
     } 
     // if we get here and the queue is empty, the wakeup was spurious
@@ -199,6 +214,9 @@ failedUnlock:;
     // failure return
     RW_UNLOCK_WRITE(&this->lock);
     CRITICAL_EXIT();
+
+    debug::Trace::Emit(debug::TraceEvent::PortReceive, static_cast<uintptr_t>(this->handle),
+            msgBufLen, ret);
     return ret;
 }
 
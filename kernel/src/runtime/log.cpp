@@ -2,12 +2,15 @@
 #include <arch.h>
 #include <platform.h>
 #include <printf.h>
+#include <string.h>
 
 #include <arch/critical.h>
 #include <arch/spinlock.h>
 #include <arch/PerCpuInfo.h>
 
 #include "debug/FramebufferConsole.h"
+#include "debug/KernelLog.h"
+#include "debug/LogRing.h"
 #include "sched/Scheduler.h"
 #include "sched/Task.h"
 #include "sched/Thread.h"
@@ -21,21 +24,16 @@ namespace platform {
 DECLARE_SPINLOCK_S(gPanicLock);
 
 /**
- * printf wrapper to send a character to the debug spew port
+ * printf wrapper to send a run of characters to the debug spew port and framebuffer console
  */
-static void _outchar(char ch, void *ctx) {
-    platform_debug_spew(ch);
-}
-
-/**
- * printf wrapper to send a character to the debug spew port and framebuffer console
- */
-static void _outchar_panic(char ch, void *ctx) {
+static void _outchunk_panic(const char *str, size_t length, void *ctx) {
     using namespace platform;
-    platform_debug_spew(ch);
+    for(size_t i = 0; i < length; i++) {
+        platform_debug_spew(str[i]);
+    }
 
     if(gConsole) {
-        gConsole->write(ch);
+        gConsole->write(str, length);
     }
 }
 
@@ -43,19 +41,31 @@ static void _outchar_panic(char ch, void *ctx) {
 /**
  * Writes the message to the kernel log.
  *
- * This will be an in-memory buffer, as well as optionally a debug spew port defined by the
- * platform code.
+ * The message is formatted into the calling processor's log ring, from which it's later written
+ * to the debug spew port defined by the platform code; this never waits on the output device.
+ * Messages longer than the maximum log record size (`LogRing::kMaxMessage` bytes) are truncated;
+ * the last characters of a truncated message are replaced with a marker.
  */
 void log(const char *format, ...) {
+    constexpr static const char kTruncMarker[]{"[...]"};
+    constexpr static const size_t kTruncMarkerLen{sizeof(kTruncMarker) - 1};
+
+    char buf[debug::LogRing::kMaxMessage + 1];
+
     va_list va;
     va_start(va, format);
 
-    fctprintf(_outchar, NULL, "[%16llu] ", platform_timer_now());
-    fctvprintf(_outchar, NULL, format, va);
+    int len = vsnprintf(buf, sizeof(buf), format, va);
 
     va_end(va);
 
-    platform_debug_spew('\n');
+    if(len < 0) return;
+    else if(static_cast<size_t>(len) > debug::LogRing::kMaxMessage) {
+        len = debug::LogRing::kMaxMessage;
+        memcpy(buf + len - kTruncMarkerLen, kTruncMarker, kTruncMarkerLen);
+    }
+
+    debug::KernelLog::Write(buf, len);
 }
 
 /**
@@ -73,6 +83,9 @@ void panic(const char *format, ...) {
     auto thread = sched ? sched->runningThread() : nullptr;
     auto task = (thread ? thread->task : nullptr);
 
+    // write out any log messages that haven't been drained yet
+    debug::KernelLog::PanicFlush();
+
     // set up panic buffer
     constexpr static const size_t kPanicBufSz = 2048;
     static char panicBuf[kPanicBufSz];
@@ -85,32 +98,32 @@ void panic(const char *format, ...) {
 
     va_end(va);
 
-    fctprintf(_outchar_panic, 0, "\033[41m\033[;Hpanic: %s\npc: $%p\n", panicBuf, pc);
+    chunkprintf(_outchunk_panic, 0, "\033[41m\033[;Hpanic: %s\npc: $%p\n", panicBuf, pc);
 
     if(thread) {
-        fctprintf(_outchar_panic, 0, "  Active thread: %p (tid %u) '%s'\n",
+        chunkprintf(_outchunk_panic, 0, "  Active thread: %p (tid %u) '%s'\n",
                 static_cast<void *>(thread), thread->tid, thread->name);
     }
     if(task) {
-        fctprintf(_outchar_panic, 0, "    Active task: %p (pid %u) '%s'\n", static_cast<void *>(task),
+        chunkprintf(_outchunk_panic, 0, "    Active task: %p (pid %u) '%s'\n", static_cast<void *>(task),
                 task->pid, task->name);
     }
     auto procLocal = arch::GetProcLocal();
     if(procLocal) {
-        fctprintf(_outchar_panic, 0, "   Current core: %x\n", procLocal->procId);
+        chunkprintf(_outchunk_panic, 0, "   Current core: %x\n", procLocal->procId);
 
     }
 
-    fctprintf(_outchar_panic, 0, "Time since boot: %llu ns\n\n", platform_timer_now());
+    chunkprintf(_outchunk_panic, 0, "Time since boot: %llu ns\n\n", platform_timer_now());
 
     // try to get a backtrace as well
     int err = arch_backtrace(nullptr, panicBuf, kPanicBufSz);
     if(err) {
-        fctprintf(_outchar_panic, 0, "Backtrace:\n%s", panicBuf);
+        chunkprintf(_outchunk_panic, 0, "Backtrace:\n%s", panicBuf);
     }
 
     // reset terminal
-    fctprintf(_outchar_panic, 0, "\033[m");
+    chunkprintf(_outchunk_panic, 0, "\033[m");
 
     // then jump to the platform panic handler
     platform_panic_handler();
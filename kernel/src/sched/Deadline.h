@@ -1,9 +1,12 @@
 #ifndef KERNEL_SCHED_DEADLINE_H
 #define KERNEL_SCHED_DEADLINE_H
 
+#include <cstddef>
 #include <cstdint>
 
 namespace sched {
+class DeadlineQueue;
+class Scheduler;
 struct Thread;
 
 /**
@@ -13,8 +16,15 @@ struct Thread;
  * Each deadline consists of an absolute time at which it becomes due, and a function that is
  * invoked at that time. Other parts of the system can subclass this object to implement custom
  * behavior on arrival of the deadline.
+ *
+ * A deadline is armed on the scheduler of the core that added it, and remembers both that
+ * scheduler and its position in the scheduler's deadline queue. It can thus be cancelled cheaply
+ * from any core, even if the thread that armed it has since moved to another one.
  */
 struct Deadline {
+    friend class DeadlineQueue;
+    friend class Scheduler;
+
     Deadline() = default;
     Deadline(const uint64_t _expires) : expires(_expires) {}
     virtual ~Deadline() = default;
@@ -32,25 +42,15 @@ struct Deadline {
      */
     virtual void operator()()= 0;
 
-
-    bool operator ==(const Deadline &d) const {
-        return this->expires == d.expires;
-    }
-    bool operator !=(const Deadline &d) const {
-        return this->expires != d.expires;
-    }
-    bool operator <(const Deadline &d) const {
-        return this->expires < d.expires;
-    }
-    bool operator <=(const Deadline &d) const {
-        return this->expires <= d.expires;
-    }
-    bool operator >(const Deadline &d) const {
-        return this->expires > d.expires;
-    }
-    bool operator >=(const Deadline &d) const {
-        return this->expires >= d.expires;
-    }
+    private:
+        /// Scheduler on which the deadline is armed, if any
+        Scheduler *scheduler{nullptr};
+        /// Whether the deadline is in a deadline queue
+        bool queued{false};
+        /// Index of the deadline in its queue's heap
+        size_t queueIndex{0};
+        /// Insertion order; used to order deadlines with the same expiration time
+        uint64_t queueSequence{0};
 };
 }
 
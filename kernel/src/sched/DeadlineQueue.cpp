@@ -0,0 +1,138 @@
+#include "DeadlineQueue.h"
+
+#include <log.h>
+
+using namespace sched;
+
+/**
+ * Returns the deadline that expires first.
+ *
+ * @note The queue must not be empty.
+ */
+const rt::SharedPtr<Deadline> &DeadlineQueue::peek() const {
+    REQUIRE(!this->empty(), "cannot %s empty deadline queue", "peek at");
+    return this->storage.front();
+}
+
+/**
+ * Returns the expiration time of the deadline that expires first.
+ */
+uint64_t DeadlineQueue::nextExpiry() const {
+    if(this->empty()) return UINT64_MAX;
+    return this->storage.front()->expires;
+}
+
+/**
+ * Inserts a deadline into the queue. A deadline can only be in one queue at a time.
+ *
+ * @return Whether the deadline is now the first to expire
+ */
+bool DeadlineQueue::insert(const rt::SharedPtr<Deadline> &deadline) {
+    REQUIRE(!deadline->queued, "deadline %p already queued", static_cast<void *>(deadline));
+
+    deadline->queued = true;
+    deadline->queueIndex = this->storage.size();
+    deadline->queueSequence = this->nextSequence++;
+
+    this->storage.push_back(deadline);
+    this->siftUp(deadline->queueIndex);
+
+    return (deadline->queueIndex == 0);
+}
+
+/**
+ * Removes a deadline from the queue. The deadline knows its position in the queue, so there is no
+ * need to search for it.
+ *
+ * @return Whether the deadline was in the queue
+ */
+bool DeadlineQueue::remove(const rt::SharedPtr<Deadline> &deadline) {
+    if(!deadline->queued) return false;
+
+    const auto i = deadline->queueIndex;
+    if(i >= this->storage.size() || this->storage[i].get() != deadline.get()) {
+        return false;
+    }
+
+    this->removeAt(i);
+    return true;
+}
+
+/**
+ * Removes the deadline that expires first.
+ *
+ * @note The queue must not be empty.
+ */
+rt::SharedPtr<Deadline> DeadlineQueue::extract() {
+    REQUIRE(!this->empty(), "cannot %s empty deadline queue", "extract from");
+
+    auto deadline = this->storage.front();
+    this->removeAt(0);
+    return deadline;
+}
+
+
+
+/**
+ * Removes the deadline at the given index; the last deadline is moved into its place, and then
+ * moved up or down the heap as needed.
+ */
+void DeadlineQueue::removeAt(const size_t i) {
+    const auto last = this->storage.size() - 1;
+    this->storage[i]->queued = false;
+
+    if(i != last) {
+        this->swap(i, last);
+        this->storage.pop_back();
+
+        if(i && this->before(i, Parent(i))) {
+            this->siftUp(i);
+        } else {
+            this->siftDown(i);
+        }
+    } else {
+        this->storage.pop_back();
+    }
+}
+
+/**
+ * Exchanges two deadlines in the heap, and updates their indices.
+ */
+void DeadlineQueue::swap(const size_t a, const size_t b) {
+    auto tmp = this->storage[a];
+    this->storage[a] = this->storage[b];
+    this->storage[b] = tmp;
+
+    this->storage[a]->queueIndex = a;
+    this->storage[b]->queueIndex = b;
+}
+
+/**
+ * Moves the deadline at the given index towards the root until its parent expires before it.
+ */
+void DeadlineQueue::siftUp(size_t i) {
+    while(i && this->before(i, Parent(i))) {
+        this->swap(i, Parent(i));
+        i = Parent(i);
+    }
+}
+
+/**
+ * Moves the deadline at the given index towards the leaves until both children expire after it.
+ */
+void DeadlineQueue::siftDown(size_t i) {
+    const auto size = this->storage.size();
+
+    while(true) {
+        const auto left = Left(i), right = left + 1;
+        auto smallest = i;
+
+        if(left < size && this->before(left, smallest)) smallest = left;
+        if(right < size && this->before(right, smallest)) smallest = right;
+
+        if(smallest == i) return;
+
+        this->swap(i, smallest);
+        i = smallest;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef KERNEL_SCHED_DEADLINEQUEUE_H
+#define KERNEL_SCHED_DEADLINEQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <runtime/SmartPointers.h>
+#include <runtime/Vector.h>
+
+#include "Deadline.h"
+
+namespace sched {
+/**
+ * Priority queue of deadlines, ordered by their expiration time.
+ *
+ * This is a binary min-heap in which each deadline records its own position. Removing a deadline
+ * therefore doesn't require searching for it, and is done in O(log n) time like insertion, rather
+ * than enumerating the entire queue. Deadlines with the same expiration time are ordered by when
+ * they were inserted, and are always distinguished by identity rather than by their expiration.
+ *
+ * @note The queue is not thread safe; the scheduler that owns it protects it with a lock.
+ */
+class DeadlineQueue {
+    public:
+        /// Whether the queue contains no deadlines
+        inline bool empty() const {
+            return this->storage.empty();
+        }
+        /// Number of deadlines in the queue
+        inline size_t size() const {
+            return this->storage.size();
+        }
+
+        /// Returns the deadline that expires first.
+        const rt::SharedPtr<Deadline> &peek() const;
+        /// Returns the expiration time of the first deadline, or UINT64_MAX if empty.
+        uint64_t nextExpiry() const;
+
+        /// Inserts a deadline into the queue.
+        bool insert(const rt::SharedPtr<Deadline> &deadline);
+        /// Removes a deadline from the queue, if it's in it.
+        bool remove(const rt::SharedPtr<Deadline> &deadline);
+        /// Removes the deadline that expires first, and returns it.
+        rt::SharedPtr<Deadline> extract();
+
+    private:
+        constexpr static inline size_t Parent(const size_t i) {
+            return (i - 1) / 2;
+        }
+        constexpr static inline size_t Left(const size_t i) {
+            return (2 * i) + 1;
+        }
+
+        /// Whether the deadline at index `a` should expire before the one at index `b`
+        inline bool before(const size_t a, const size_t b) const {
+            const auto &da = this->storage[a], &db = this->storage[b];
+            if(da->expires != db->expires) return da->expires < db->expires;
+            return (da->queueSequence - db->queueSequence) > (UINT64_MAX / 2);
+        }
+
+        void swap(const size_t a, const size_t b);
+        void siftUp(size_t i);
+        void siftDown(size_t i);
+        void removeAt(const size_t i);
+
+    private:
+        /// Heap of deadlines; each deadline's `queueIndex` is its index in this array
+        rt::Vector<rt::SharedPtr<Deadline>> storage;
+        /// Sequence number to assign to the next inserted deadline
+        uint64_t nextSequence{0};
+};
+}
+
+#endif
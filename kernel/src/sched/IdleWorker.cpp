@@ -2,6 +2,7 @@
 #include "Scheduler.h"
 #include "Task.h"
 #include "Thread.h"
+#include "vm/Map.h"
 
 #include <platform.h>
 #include <log.h>
@@ -98,9 +99,16 @@ void IdleWorker::DeleteThreadItem::operator()() {
 
 /**
  * Deallocates a task.
+ *
+ * All VM objects are removed from the task's map first: they hold references to the tasks they're
+ * mapped in, and pager-backed objects notify their pager once they're no longer mapped anywhere.
  */
 void IdleWorker::DeleteTaskItem::operator()() {
     if(gLog) {
         log("deleting task %p", static_cast<void *>(this->task));
     }
+
+    if(this->task->vm) {
+        this->task->vm->removeAll(this->task);
+    }
 }
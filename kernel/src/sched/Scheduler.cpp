@@ -7,6 +7,8 @@
 #include "IdleWorker.h"
 
 #include "vm/Map.h"
+#include "debug/KernelLog.h"
+#include "debug/Trace.h"
 
 #include <arch/critical.h>
 #include <arch/rwlock.h>
@@ -70,6 +72,10 @@ void Scheduler::InitAp() {
     REQUIRE(sched, "failed to allocate %s", "scheduler");
 
     arch::GetProcLocal()->sched = sched;
+
+    // the heap is available, so give the core its own log ring and trace buffer
+    debug::KernelLog::InitCore();
+    debug::Trace::InitCore();
 }
 
 /**
@@ -402,32 +408,43 @@ void Scheduler::timerFired() {
 /**
  * Sets the platform timer interval to the minimum of the time to the next deadline or the current
  * thread being preempted.
+ *
+ * When the idle thread is running and there are no deadlines, the timer is stopped entirely
+ * (unless periodic idle wakeups are enabled) and the core sleeps until another core sends it an
+ * IPI, usually because it scheduled a thread on it.
  */
 void Scheduler::timerUpdate() {
-    uint64_t quantumRemaining = kIdleWakeupInterval;
+    uint64_t quantumRemaining = UINT64_MAX;
+    bool idle{false};
 
     // calculate remaining quantum
     if(this->running) [[likely]] {
         auto &sched = this->running->sched;
 
         if(TestFlags(sched.flags & SchedulerThreadDataFlags::Idle)) [[unlikely]] {
-            quantumRemaining = kIdleWakeupInterval;
+            idle = true;
         } else {
             quantumRemaining = sched.quantumTotal - sched.quantumUsed;
         }
+    } else {
+        idle = true;
+    }
+
+    if(idle && !kTicklessIdle) {
+        quantumRemaining = kIdleWakeupInterval;
     }
 
     // find the nearest deadline
-    auto deadline = UINTPTR_MAX;
-    const auto now = platform_timer_now();
+    uint64_t deadline = UINT64_MAX;
 
     {
         RW_LOCK_READ_GUARD(this->deadlinesLock);
 
         if(!this->deadlines.empty()) {
+            const auto now = platform_timer_now();
+
             // is the front deadline expired/close to expiring?
-            const auto &next = this->deadlines.min();
-            const auto expires = next.expires();
+            const auto expires = this->deadlines.nextExpiry();
 
             if(expires <= now) { // already expired
                 deadline = 0;
@@ -440,13 +457,14 @@ void Scheduler::timerUpdate() {
     // whichever is sooner, set a timer for it
     uint64_t interval = (deadline < quantumRemaining) ? deadline : quantumRemaining;
 
-    // make sure it's at least the min interval (TODO: this is a bit janky)
-    if(interval >= this->timerMinInterval) {
-        platform::SetLocalTimer(interval);
-    } else {
-        platform::SetLocalTimer(this->timerMinInterval);
-        //this->sendIpi();
+    if(interval == UINT64_MAX) {
+        platform::StopLocalTimer();
+        return;
     }
+
+    // make sure it's at least the min interval the timer supports
+    const auto minInterval = platform::GetLocalTimerMinInterval();
+    platform::SetLocalTimer((interval >= minInterval) ? interval : minInterval);
 }
 
 /**
@@ -697,34 +715,42 @@ bool Scheduler::updateQuantumUsed(const rt::SharedPtr<Thread> &thread) {
  * Processes all expired deadlines, by invoking their expiration methods. These may add new threads
  * to the run queue.
  *
+ * The time is sampled only once, and all deadlines that expire before it (plus the slack) are
+ * taken off the queue in batches. Their handlers are invoked after the deadline lock is dropped,
+ * so that they may add or remove deadlines themselves.
+ *
  * @return Whether any deadline expired during this invocation
  */
 bool Scheduler::processDeadlines() {
     bool expired = false;
+    const auto cutoff = platform_timer_now() + this->deadlineSlack;
 
-    RW_LOCK_WRITE_GUARD(this->deadlinesLock);
-    // XXX: do we need to resample this every loop? in case we have tons of deadlines
-    const auto now = platform_timer_now();
+    rt::SharedPtr<Deadline> batch[kDeadlineBatchSize];
+    size_t numExpired;
 
-    bool doNext = true;
+    do {
+        numExpired = 0;
 
-    while(!this->deadlines.empty() && doNext) {
-        auto &next = this->deadlines.min();
-        const auto expires = next.expires();
+        // collect the expired deadlines
+        {
+            RW_LOCK_WRITE_GUARD(this->deadlinesLock);
 
-        // does the deadline lie in the past?
-        if(expires <= now ||
-        // does it expire within the fudge time?
-          (expires - now) <= this->deadlineSlack) {
-            next();
-            this->deadlines.extract();
-            expired = true;
+            while(numExpired < kDeadlineBatchSize && this->deadlines.nextExpiry() <= cutoff) {
+                auto deadline = this->deadlines.extract();
+                __atomic_store_n(&deadline->scheduler, nullptr, __ATOMIC_RELEASE);
+
+                batch[numExpired++] = deadline;
+            }
         }
-        // the deadline doesn't expire until later. chill
-        else {
-            doNext = false;
+
+        // then invoke them
+        for(size_t i = 0; i < numExpired; i++) {
+            (*batch[i])();
+            batch[i] = nullptr;
         }
-    }
+
+        expired |= (numExpired != 0);
+    } while(numExpired == kDeadlineBatchSize);
 
     return expired;
 }
@@ -739,23 +765,18 @@ void Scheduler::addDeadline(const rt::SharedPtr<Deadline> &deadline, const bool
     platform::Irql oldIrql;
     if(!inCritical) oldIrql = platform_raise_irql(platform::Irql::Scheduler);
 
-    DeadlineWrapper wrap(deadline);
-    bool needTimerUpdate = true;
+    bool needTimerUpdate;
 
     if(kLogDeadlines) {
-        log("adding deadline: %p (%lu %lu) %p", static_cast<void *>(deadline),
-                deadline->expires, wrap.expires(), &deadline->expires);
+        log("adding deadline: %p (%lu)", static_cast<void *>(deadline), deadline->expires);
     }
 
-    // modify deadlines and determine if timer needs update
+    // insert it and determine if timer needs update
     {
         RW_LOCK_WRITE_GUARD(this->deadlinesLock);
 
-        if(!this->deadlines.empty()) {
-            needTimerUpdate = this->deadlines.min() > wrap;
-        }
-
-        this->deadlines.insert(wrap);
+        needTimerUpdate = this->deadlines.insert(deadline);
+        __atomic_store_n(&deadline->scheduler, this, __ATOMIC_RELEASE);
     }
 
     // update timer (if needed) and restore irql
@@ -769,13 +790,19 @@ void Scheduler::addDeadline(const rt::SharedPtr<Deadline> &deadline, const bool
 /**
  * Removes an existing deadline, if it has not yet expired.
  *
+ * The deadline is removed from the queue of the scheduler it was added to, which is not
+ * necessarily this one, since the thread that added it may have moved to another core in the
+ * meantime. Only if the deadline was the next to expire on this core is the timer updated;
+ * another core's timer may simply fire early.
+ *
  * @param inCritical When set, the method is invoked from a critical section and the IRQL does not
  *        need to be adjusted.
  *
- * @return Whether the given deadline was found and removed
+ * @return Whether the given deadline was found and removed; if not, its handler may be running
+ *         concurrently on another core, and must itself detect that it's no longer relevant.
  */
 bool Scheduler::removeDeadline(const rt::SharedPtr<Deadline> &deadline, const bool inCritical) {
-    bool needTimerUpdate;
+    bool removed{false}, needTimerUpdate{false};
     platform::Irql oldIrql;
 
     if(!inCritical) oldIrql = platform_raise_irql(platform::Irql::Scheduler);
@@ -784,45 +811,28 @@ bool Scheduler::removeDeadline(const rt::SharedPtr<Deadline> &deadline, const bo
         log("removing deadline: %p", static_cast<void *>(deadline));
     }
 
-    // prepare info for removal
-    struct RemoveInfo {
-        rt::SharedPtr<Deadline> deadline;
-        size_t numRemoved = 0;
+    // get the scheduler on which it's armed; if none, it's already expired
+    auto owner = __atomic_load_n(&deadline->scheduler, __ATOMIC_ACQUIRE);
 
-        RemoveInfo(const rt::SharedPtr<Deadline> &_deadline) : deadline(_deadline) {}
-    };
+    if(owner) {
+        RW_LOCK_WRITE_GUARD(owner->deadlinesLock);
 
-    RemoveInfo info(deadline);
+        // it may have expired between reading the owner and acquiring the lock
+        if(deadline->scheduler == owner) {
+            const auto wasFirst = (owner->deadlines.peek().get() == deadline.get());
+            removed = owner->deadlines.remove(deadline);
+            deadline->scheduler = nullptr;
 
-    // enumerate over all the objects
-    {
-        RW_LOCK_WRITE_GUARD(this->deadlinesLock);
-
-        const auto oldMinExpires = this->deadlines.min().expires();
-
-        this->deadlines.enumerateObjects([](DeadlineWrapper &wrap, bool *remove, void *ctx) -> bool {
-            auto info = reinterpret_cast<RemoveInfo *>(ctx);
-
-            // we've found the deadline object to remove
-            if(wrap == info->deadline) {
-                info->numRemoved++;
-                *remove = true;
-                return false;
-            }
-            // continue iterating
-            return true;
-        }, &info);
-
-        needTimerUpdate = this->deadlines.min().expires() != oldMinExpires;
+            needTimerUpdate = removed && wasFirst && (owner == this);
+        }
     }
 
-    // lower irql again
+    // update timer if needed and lower irql again
     if(needTimerUpdate) {
         this->timerUpdate();
     }
 
     if(!inCritical) platform_lower_irql(oldIrql);
 
-    return (info.numRemoved != 0);
+    return removed;
 }
-
@@ -5,11 +5,11 @@
 
 #include <bitflags.h>
 #include <arch/rwlock.h>
-#include <runtime/MinHeap.h>
 #include <runtime/LockFreeQueue.h>
 #include <runtime/SmartPointers.h>
 
 #include "Deadline.h"
+#include "DeadlineQueue.h"
 #include "Thread.h"
 #include "Oclock.h"
 #include "PeerList.h"
@@ -60,10 +60,16 @@ class Scheduler {
 
         /**
          * Interval at which the scheduler will wake the core to check for new work if it enters
-         * the idle state, in nanoseconds.
+         * the idle state, in nanoseconds. This is only used if tickless idle is disabled.
          */
         constexpr static const uintptr_t kIdleWakeupInterval = (1000000 * 100); // 100ms
 
+        /**
+         * When set, an idle core with no pending deadlines stops its timer entirely, rather than
+         * waking up periodically; it'll be woken by an IPI when work is scheduled on it.
+         */
+        constexpr static const bool kTicklessIdle = true;
+
         /// Default positive slack for deadlines (in ns)
         constexpr static const uint64_t kDeadlineSlack = 500;
 
@@ -177,48 +183,6 @@ class Scheduler {
             uint64_t quantumLength = 0;
         };
 
-        /**
-         * Small wrapper around a polymorphic Deadline shared pointer, to provide the appropriate
-         * operators to make it work in the minheap
-         */
-        struct DeadlineWrapper {
-            DeadlineWrapper() = default;
-            DeadlineWrapper(const rt::SharedPtr<Deadline> &_deadline) : deadline(_deadline) {}
-
-            /// deadline object we represent
-            rt::SharedPtr<Deadline> deadline;
-
-            /// get expiration time or 0 if invalid
-            inline uint64_t expires() const {
-                if(!deadline) return 0;
-                return deadline->expires;
-            }
-
-            /// call through to the object
-            inline void operator()() {
-                (*this->deadline)();
-            }
-
-            bool operator ==(const DeadlineWrapper &d) const {
-                return this->expires() == d.expires();
-            }
-            bool operator !=(const DeadlineWrapper &d) const {
-                return this->expires() != d.expires();
-            }
-            bool operator <(const DeadlineWrapper &d) const {
-                return this->expires() < d.expires();
-            }
-            bool operator <=(const DeadlineWrapper &d) const {
-                return this->expires() <= d.expires();
-            }
-            bool operator >(const DeadlineWrapper &d) const {
-                return this->expires() > d.expires();
-            }
-            bool operator >=(const DeadlineWrapper &d) const {
-                return this->expires() >= d.expires();
-            }
-        };
-
     private:
         /// whether pops/pushes to queue are logged
         constexpr static const bool kLogQueueOps = false;
@@ -227,6 +191,9 @@ class Scheduler {
         /// whether deadline operations are logged
         constexpr static const bool kLogDeadlines = false;
 
+        /// Maximum number of expired deadlines collected before their handlers are invoked
+        constexpr static const size_t kDeadlineBatchSize = 16;
+
         /// per level configuration
         static LevelInfo gLevelInfo[kNumLevels];
 
@@ -270,18 +237,6 @@ class Scheduler {
          */
         uint64_t deadlineSlack = kDeadlineSlack;
 
-        /**
-         * If an event (thread preemption or deadline) occurs within this time period (in ns) the
-         * scheduler will take an IPI directly rather than setting the core local timer.
-         *
-         * This value really needs to be tweaked so the scheduler doesn't get random "freezes"
-         * where all activity in the system seems to stop. This is mostly an issue on
-         * virtualized environments where the timer's resolution is rather shit, and it's
-         * totally possible for us to get in the timer setup function with some whacky values
-         * that cause a lost timer interrupt.
-         */
-        uint64_t timerMinInterval = 50000;
-
         /**
          * Level from which the currently executing thread was pulled, or `kNumLevels` if we're
          * executing the idle thread.
@@ -304,7 +259,7 @@ class Scheduler {
          * All upcoming deadlines for this core; they are processed at every scheduler invocation
          * if they've passed or are about to occur (to avoid some overhead)
          */
-        rt::MinHeap<DeadlineWrapper> deadlines;
+        DeadlineQueue deadlines;
 
     public:
         /// idle worker
@@ -29,8 +29,18 @@ class SignalFlag: public Blockable {
         void reset() override {
             // we don't do anything; we cannot be reset.
         }
-        /// Prepare to block on the flag.
-        // void willBlockOn(Thread *t) override {}
+        /// Prepare to block on the flag; this fails if it's already been signalled.
+        int willBlockOn(const rt::SharedPtr<Thread> &t) override {
+            if(int err = Blockable::willBlockOn(t)) {
+                return err;
+            }
+
+            if(__atomic_load_n(&this->signalled, __ATOMIC_ACQUIRE)) {
+                this->blocker = nullptr;
+                return -1;
+            }
+            return 0;
+        }
 
         /**
          * Signals the flag, waking any threads that are pending on it.
@@ -40,8 +50,11 @@ class SignalFlag: public Blockable {
             bool no = false, yes = true;
             if(__atomic_compare_exchange(&this->signalled, &no, &yes, false, __ATOMIC_RELEASE,
                         __ATOMIC_RELAXED)) {
-                // unblock the task
-                this->blocker->unblock(this->us.lock());
+                // unblock the task, if it's already blocking on us
+                auto thread = this->blocker;
+                if(thread) {
+                    thread->unblock(this->us.lock());
+                }
             }
         }
 
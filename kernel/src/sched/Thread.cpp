@@ -7,6 +7,7 @@
 
 #include "SleepDeadline.h"
 
+#include "debug/Trace.h"
 #include "ipc/Interrupts.h"
 #include "mem/StackPool.h"
 #include "vm/Map.h"
@@ -30,20 +31,26 @@ bool Thread::gLogLifecycle = false;
 /**
  * Scheduler deadline object that will cancel any pending blocks on the thread when it expires,
  * allowing for blocks to time out.
+ *
+ * The deadline records the thread's epoch when it was created: its handler may still be running
+ * after the thread finished blocking and failed to remove the deadline, in which case the epoch
+ * will have changed and the expiration is ignored.
  */
 struct sched::BlockWait: public Deadline {
     BlockWait(const uint64_t _when, const rt::SharedPtr<Thread> &_thread) : Deadline(_when),
-    thread(_thread) {}
+    thread(_thread), epoch(__atomic_load_n(&_thread->epoch, __ATOMIC_RELAXED)) {}
 
     /**
      * On expiration, call back into the blocker object
      */
     void operator()() override {
-        this->thread->blockExpired();
+        this->thread->blockExpired(this->epoch);
     }
 
     /// thread whose blocks time out
     rt::SharedPtr<Thread> thread;
+    /// thread's epoch value for the block this deadline times out
+    uintptr_t epoch;
 };
 
 
@@ -166,6 +173,11 @@ void Thread::switchTo() {
 
     this->lastSwitchedTo = platform_timer_now();
 
+    debug::Trace::Emit(debug::TraceEvent::ContextSwitch,
+            current ? static_cast<uintptr_t>(current->handle) : 0,
+            static_cast<uintptr_t>(this->handle),
+            current ? static_cast<uint64_t>(current->getState()) : 0);
+
     //log("switching to %s (from %s)", this->name, current ? (current->name) : "<null>");
     Scheduler::get()->setRunningThread(to);
     arch::RestoreThreadState(current, to);
@@ -357,9 +369,6 @@ beach:;
     // finally, yield to scheduler if needed
     if(yield) {
         Scheduler::get()->yield();
-
-        // increment epoch value
-        __atomic_add_fetch(&this->epoch, 0, __ATOMIC_RELAXED);
     }
 
     /*
@@ -372,6 +381,9 @@ beach:;
         CRITICAL_ENTER();
         RW_LOCK_WRITE(&this->lock);
 
+        // the block is over; a deadline handler that's still running must not time out the next
+        __atomic_add_fetch(&this->epoch, 1, __ATOMIC_RELAXED);
+
         // remove the old deadline
         if(deadline) {
             Scheduler::get()->removeDeadline(deadline, true);
@@ -428,8 +440,13 @@ void Thread::unblock(const rt::SharedPtr<Blockable> &b) {
 
 /**
  * Cancels any pending blocks.
+ *
+ * This is ignored if the thread has since finished the block the deadline was created for (its
+ * epoch changed) or isn't blocking at all anymore.
+ *
+ * @param epoch Thread epoch value when the block's deadline was created
  */
-void Thread::blockExpired() {
+void Thread::blockExpired(const uintptr_t epoch) {
     DECLARE_CRITICAL();
 
     // update thread state
@@ -437,6 +454,13 @@ void Thread::blockExpired() {
         RW_LOCK_WRITE(&this->lock);
         CRITICAL_ENTER();
 
+        if(__atomic_load_n(&this->epoch, __ATOMIC_RELAXED) != epoch ||
+                this->blockState != BlockState::Blocking) {
+            RW_UNLOCK_WRITE(&this->lock);
+            CRITICAL_EXIT();
+            return;
+        }
+
         this->blockState = BlockState::Timeout;
 
         RW_UNLOCK_WRITE(&this->lock);
@@ -666,6 +690,9 @@ uintptr_t Thread::blockNotify(const uintptr_t _mask, const uintptr_t timeout) {
         CRITICAL_ENTER();
         RW_LOCK_WRITE(&this->lock);
 
+        // the block is over; a deadline handler that's still running must not time out the next
+        __atomic_add_fetch(&this->epoch, 1, __ATOMIC_RELAXED);
+
         // remove deadline
         if(deadline) {
             Scheduler::get()->removeDeadline(deadline, true);
@@ -170,9 +170,9 @@ struct Thread: public rt::SharedFromThis<Thread> {
         bool notified = false;
 
         /**
-         * This counter is incremented any time the thread leaves the runnable state; it is used to
-         * detect when a deadline (or other unblock event) takes place yet the subject thread has
-         * changed state since then.
+         * This counter is incremented (with the thread lock held) any time the thread finishes a
+         * block; it is used to detect when a deadline (or other unblock event) takes place yet the
+         * subject thread has changed state since then.
          *
          * In other words, when a deadline (or other object) fires, it should ensure the epoch
          * value is the same as what it was when it began blocking.
@@ -301,8 +301,8 @@ struct Thread: public rt::SharedFromThis<Thread> {
 
         /// scheduler is attempting to determine if thread should be runnable again
         void schedTestUnblock();
-        /// any pending blocks should be cancelled
-        void blockExpired();
+        /// any pending blocks should be cancelled, if the thread is still in the given block
+        void blockExpired(const uintptr_t epoch);
         /// set thread state with optionally idsabling validation
         void setState(State newState, const bool validate) {
             if(validate) {
@@ -43,6 +43,12 @@ enum VmQueryKey: uintptr_t;
 intptr_t VmAllocPhysRegion(const uintptr_t physAddr, const size_t length, const VmFlags flags);
 /// Allocate a virtual memory region backed by anonymous memory
 intptr_t VmAllocAnonRegion(const uintptr_t length, const VmFlags flags);
+/// Allocate a virtual memory region whose pages are provided by a userspace pager
+intptr_t VmAllocPagerRegion(const uintptr_t length, const VmFlags flags, const Handle portHandle,
+        const uintptr_t cookie);
+/// Provides pages to a pager-backed region
+intptr_t VmPagerSupply(const Handle vmHandle, const uintptr_t offset, const uintptr_t srcAddr,
+        const size_t length);
 /// Releases a previously allocated VM region
 intptr_t VmDealloc(const Handle vmHandle);
 /// Update permissions (R/W/X flags) of a VM region
@@ -106,6 +112,8 @@ intptr_t TaskInitialize(const Handle taskHandle, const uintptr_t userPc,
 intptr_t TaskSetName(const Handle taskHandle, const char *namePtr, const size_t nameLen);
 /// Debug output to kernel log console
 intptr_t TaskDbgOut(const char *msgPtr, const size_t msgLen);
+/// Reads records from the kernel log history
+intptr_t TaskDbgReadLog(void *outPtr, const size_t outBytes, uintptr_t *cursorPtr);
 
 
 /// Installs an IRQ handler
@@ -123,6 +131,10 @@ intptr_t IrqHandlerAllocCoreLocal(const Handle threadHandle, const uintptr_t bit
 
 /// Get entropy from kernel buffer
 intptr_t GetEntropy(void *outPtr, const size_t outBytes);
+/// Sets the enabled trace event categories
+intptr_t TraceSetMask(const uintptr_t mask);
+/// Reads records from the trace buffers
+intptr_t TraceRead(void *outPtr, const size_t outBytes, uint64_t *lostPtr);
 }
 
 #endif
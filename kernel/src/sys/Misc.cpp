@@ -1,6 +1,7 @@
 #include "Handlers.h"
 
 #include "crypto/Random.h"
+#include "debug/Trace.h"
 
 #include <log.h>
 
@@ -8,6 +9,8 @@ using namespace sys;
 
 /// Maximum size of entropy that can be acquired from the kernel (bytes)
 constexpr static const size_t kMaxEntropy{256};
+/// Number of trace records copied out to userspace at a time
+constexpr static const size_t kTraceBounceRecords{16};
 
 /**
  * Reads the given number of bytes (up to the specified maximum) from the kernel's random number
@@ -33,3 +36,52 @@ intptr_t sys::GetEntropy(void *outPtr, const size_t outBytes) {
     return outBytes;
 }
 
+/**
+ * Updates the mask of enabled trace event categories.
+ *
+ * @return Previous mask of enabled categories
+ */
+intptr_t sys::TraceSetMask(const uintptr_t mask) {
+    return debug::Trace::SetMask(mask);
+}
+
+/**
+ * Copies records out of the kernel's trace buffers, removing them from the buffers.
+ *
+ * @param outPtr Buffer to receive trace records
+ * @param outBytes Size of the buffer; only whole records are copied
+ * @param lostPtr If non-null, receives the number of records that were overwritten before they
+ *        could be read
+ *
+ * @return A negative error code, or the number of bytes of records written to the buffer
+ */
+intptr_t sys::TraceRead(void *outPtr, const size_t outBytes, uint64_t *lostPtr) {
+    // validate arguments
+    if(outBytes < sizeof(debug::TraceRecord)) {
+        return Errors::BufferTooSmall;
+    }
+    else if(!Syscall::validateUserPtr(outPtr, outBytes) ||
+            (lostPtr && !Syscall::validateUserPtr(lostPtr, sizeof(*lostPtr)))) {
+        return Errors::InvalidPointer;
+    }
+
+    // copy out records through a bounce buffer
+    debug::TraceRecord buf[kTraceBounceRecords];
+    uint64_t lost{0};
+    size_t copied{0};
+
+    while(copied < outBytes) {
+        const auto toCopy = (outBytes - copied) > sizeof(buf) ? sizeof(buf) : (outBytes - copied);
+        const auto got = debug::Trace::Read(buf, toCopy, lost);
+        if(!got) break;
+
+        Syscall::copyOut(buf, got, reinterpret_cast<uint8_t *>(outPtr) + copied,
+                outBytes - copied);
+        copied += got;
+    }
+
+    if(lostPtr) {
+        Syscall::copyOut(&lost, sizeof(lost), lostPtr, sizeof(*lostPtr));
+    }
+    return copied;
+}
@@ -136,7 +136,7 @@ intptr_t sys::PortReceive(const Handle portHandle, RecvInfo *recvPtr, const size
     // receive from port
     Handle senderThreadHandle = Handle::Invalid;
 
-    err = port->receive(senderThreadHandle, recvPtr->data, msgBufLen, timeout);
+    err = port->receive(senderThreadHandle, recvPtr->data, msgBufLen, timeoutNs);
 
     if(err < 0) {
         // receive timed out
@@ -4,6 +4,8 @@
 #include "sched/Task.h"
 
 #include "handle/Manager.h"
+#include "debug/KernelLog.h"
+#include "debug/LogRing.h"
 
 #include <arch.h>
 #include <arch/critical.h>
@@ -215,15 +217,59 @@ intptr_t sys::TaskDbgOut(const char *msgPtr, const size_t msgLen) {
     Syscall::copyIn(msgPtr, msgLen, &message, sizeof(message));
     // strncpy(message, msgPtr, 1024);
 
-    // print it
-    DECLARE_CRITICAL();
-    CRITICAL_ENTER();
+    // print it; each message is a single log record, so it won't be interleaved with others, but
+    // it is truncated (with a marker) if it's longer than the maximum record size
     log("%4lu %4lu) %s", sched::Task::current()->pid, sched::Thread::current()->tid, message);
-    CRITICAL_EXIT();
 
     return Errors::Success;
 }
 
+/**
+ * Copies records from the kernel log history into the provided buffer. Records are copied in their
+ * entirety, as a header followed by the (not zero terminated) message, padded to the size
+ * indicated in the header.
+ *
+ * @param outPtr Buffer to receive log records
+ * @param outBytes Size of the buffer; it must be able to hold a record of the maximum size
+ * @param cursorPtr Offset of the first record to read (0 for the oldest available record); on
+ *        return, it's updated to the offset of the next record to read.
+ *
+ * @return A negative error code, or the number of bytes written to the buffer
+ */
+intptr_t sys::TaskDbgReadLog(void *outPtr, const size_t outBytes, uintptr_t *cursorPtr) {
+    // validate arguments
+    if(outBytes < debug::LogRing::kMaxRecordSize) {
+        return Errors::BufferTooSmall;
+    }
+    else if(!Syscall::validateUserPtr(outPtr, outBytes) ||
+            !Syscall::validateUserPtr(cursorPtr, sizeof(*cursorPtr))) {
+        return Errors::InvalidPointer;
+    }
+
+    // the cursor is pointer sized in userspace; widen it to the history ring's offsets
+    uintptr_t userCursor{0};
+    Syscall::copyIn(cursorPtr, sizeof(*cursorPtr), &userCursor, sizeof(userCursor));
+    uint64_t cursor = userCursor;
+
+    // copy out records through a bounce buffer
+    uint8_t buf[debug::LogRing::kMaxRecordSize * 2];
+    size_t copied{0};
+
+    while(copied < outBytes) {
+        const auto toCopy = (outBytes - copied) > sizeof(buf) ? sizeof(buf) : (outBytes - copied);
+        const auto got = debug::KernelLog::ReadHistory(cursor, buf, toCopy);
+        if(!got) break;
+
+        Syscall::copyOut(buf, got, reinterpret_cast<uint8_t *>(outPtr) + copied,
+                outBytes - copied);
+        copied += got;
+    }
+
+    userCursor = static_cast<uintptr_t>(cursor);
+    Syscall::copyOut(&userCursor, sizeof(userCursor), cursorPtr, sizeof(*cursorPtr));
+    return copied;
+}
+
 
 
 /**
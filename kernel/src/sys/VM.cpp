@@ -1,6 +1,7 @@
 #include "Handlers.h"
 
 #include "handle/Manager.h"
+#include "ipc/Port.h"
 #include "mem/PhysicalAllocator.h"
 #include "sched/Task.h"
 #include "sched/Thread.h"
@@ -200,6 +201,138 @@ intptr_t sys::VmAllocAnonRegion(const uintptr_t length, const VmFlags flags) {
     return static_cast<intptr_t>(region->getHandle());
 }
 
+/**
+ * Allocates a memory region whose pages are provided by a userspace pager.
+ *
+ * When a page of the region is first accessed, a request is sent to the given port, and the
+ * accessing thread blocks until the pager provides the page with `VmPagerSupply`. Only the task
+ * that owns the region may provide pages.
+ *
+ * This relies on userspace page faults being able to block, so it's only wired up in the amd64
+ * syscall table; the x86 port doesn't support it.
+ *
+ * @param length Size of the region, in bytes. Must be page aligned
+ * @param flags Access flags for the region
+ * @param portHandle Port to which page requests are sent
+ * @param cookie Opaque value passed to the pager with each request
+ *
+ * @return Valid handle to the VM region, or a negative error code
+ */
+intptr_t sys::VmAllocPagerRegion(const uintptr_t length, const VmFlags flags,
+        const Handle portHandle, const uintptr_t cookie) {
+    rt::SharedPtr<vm::MapEntry> region = nullptr;
+    const auto pageSz = arch_page_size();
+    auto task = sched::Task::current();
+
+    if(gLogAlloc) {
+        log("VmAllocPagerRegion(%lu, %04x, $%p'h, %p)", length, flags, portHandle, cookie);
+    }
+
+    // validate arguments
+    if(!length || length % pageSz) {
+        return Errors::InvalidArgument;
+    } else if(flags & kMapTypeMmio) {
+        return Errors::InvalidArgument;
+    }
+
+    auto port = handle::Manager::getPort(portHandle);
+    if(!port) {
+        return Errors::InvalidHandle;
+    }
+
+    // set up the mapping
+    const auto mapFlags = ConvertFlags(flags);
+
+    region = vm::MapEntry::makePager(length, mapFlags, port, cookie);
+    if(!region) {
+        return Errors::GeneralError;
+    }
+
+    // associate it with the task and return its handle
+    task->addVmRegion(region);
+    return static_cast<intptr_t>(region->getHandle());
+}
+
+/**
+ * Provides pages to a pager-backed region, and wakes any threads waiting for them.
+ *
+ * The pages are taken from an anonymous region of the calling task: each page of the source range
+ * is moved into the pager-backed region without copying, and replaced by a fresh page in the
+ * source region. Pages that were already provided are left untouched.
+ *
+ * @param vmHandle Pager-backed region to provide pages for; it must be owned by the caller
+ * @param offset Offset into the region of the first page, in bytes. Must be page aligned
+ * @param srcAddr Address of the data in the caller's address space; all pages in the range must
+ *        be in anonymous regions owned by the caller, and have been faulted in. If zero, requests
+ *        for the range are failed instead, which in turn fails the faults that caused them.
+ * @param length Number of bytes to provide. Must be page aligned
+ *
+ * @return 0 on success, or a negative error code
+ */
+intptr_t sys::VmPagerSupply(const Handle vmHandle, const uintptr_t offset, const uintptr_t srcAddr,
+        const size_t length) {
+    intptr_t ret{Errors::Success};
+    const auto pageSz = arch_page_size();
+    size_t i{0};
+
+    if(gLogChanges) {
+        log("VmPagerSupply($%p'h, $%p, $%p, %lu)", vmHandle, offset, srcAddr, length);
+    }
+
+    auto task = sched::Task::current();
+    if(!task || !task->vm) return Errors::GeneralError;
+    auto vm = task->vm;
+
+    // validate arguments
+    if(!length || offset % pageSz || length % pageSz || srcAddr % pageSz) {
+        return Errors::InvalidArgument;
+    } else if(srcAddr && (srcAddr + length) >= kKernelVmBound) {
+        return Errors::InvalidAddress;
+    }
+
+    auto region = handle::Manager::getVmObject(vmHandle);
+    if(!region) {
+        return Errors::InvalidHandle;
+    } else if(!region->backedByPager()) {
+        return Errors::InvalidArgument;
+    } else if(region->getOwner().lock() != task) {
+        return Errors::PermissionDenied;
+    } else if(offset >= region->getLength() || length > (region->getLength() - offset)) {
+        return Errors::InvalidArgument;
+    }
+
+    // fail the requests for this range
+    if(!srcAddr) {
+        goto done;
+    }
+
+    // move each page from the source region
+    for(i = 0; i < length; i += pageSz) {
+        rt::SharedPtr<vm::MapEntry> src;
+        uintptr_t srcOffset, physAddr;
+
+        if(!vm->findRegion(srcAddr + i, src, srcOffset) || !src) {
+            ret = Errors::InvalidAddress;
+            goto done;
+        } else if(!src->backedByAnonymousMem() || src->getOwner().lock() != task) {
+            ret = Errors::PermissionDenied;
+            goto done;
+        }
+
+        if(src->exchangePage(srcOffset, physAddr)) {
+            ret = Errors::Unmapped;
+            goto done;
+        }
+
+        region->supplyPage(offset + i, physAddr);
+    }
+
+done:;
+    // wake up all threads waiting for these pages; they'll retry their accesses
+    region->completePagerRequests(offset, length);
+    return ret;
+}
+
 /**
  * Deallocates a virtual memory region. This will unmap the region from the caller (if it is
  * mapped) and if the calling task is the owner, remove the ownership reference.
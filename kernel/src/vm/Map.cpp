@@ -362,6 +362,32 @@ int Map::remove(const rt::SharedPtr<MapEntry> &entry, const rt::SharedPtr<sched:
     return 0;
 }
 
+/**
+ * Removes all entries from this map. This is done when the task that owns the map is destroyed,
+ * so that the VM objects it had mapped no longer consider themselves mapped in it.
+ */
+void Map::removeAll(const rt::SharedPtr<sched::Task> &task) {
+    REQUIRE(task, "invalid %s", "task");
+
+    while(true) {
+        uintptr_t base{0};
+        size_t length{0};
+
+        RW_LOCK_WRITE(&this->lock);
+
+        auto entry = this->entries.any(base, length);
+        if(!entry) {
+            RW_UNLOCK_WRITE(&this->lock);
+            break;
+        }
+
+        this->entries.remove(base);
+        RW_UNLOCK_WRITE(&this->lock);
+
+        entry->removedFromMap(this, task, base, length);
+    }
+}
+
 /**
  * Iterates the list of allocated mappings to see if we contain one.
  */
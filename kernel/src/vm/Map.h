@@ -87,6 +87,7 @@ class Map {
                 const size_t viewSize = 0, const uintptr_t searchStart = kVmSearchBase,
                 const uintptr_t searchEnd = kVmMaxAddr);
         int remove(const rt::SharedPtr<MapEntry> &entry, const rt::SharedPtr<sched::Task> &task);
+        void removeAll(const rt::SharedPtr<sched::Task> &task);
         const bool contains(const rt::SharedPtr<MapEntry> &entry);
 
         int add(const uint64_t physAddr, const uintptr_t length, const uintptr_t vmAddr, 
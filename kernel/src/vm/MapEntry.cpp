@@ -2,13 +2,18 @@
 #include "Map.h"
 #include "Mapper.h"
 
+#include "ipc/Port.h"
 #include "mem/PhysicalAllocator.h"
 #include "mem/SlabAllocator.h"
+#include "sched/SignalFlag.h"
 #include "sched/Task.h"
+#include "sched/Thread.h"
+#include "debug/Trace.h"
 
 #include <arch.h>
 #include <log.h>
 #include <new>
+#include <platform.h>
 
 using namespace vm;
 
@@ -100,6 +105,33 @@ rt::SharedPtr<MapEntry> MapEntry::makeAnon(const size_t length, const MappingFla
     return ptr;
 }
 
+/**
+ * Allocates a VM object whose pages are provided by a userspace pager.
+ *
+ * When a page that hasn't been provided yet is accessed, a request is sent to the given port, and
+ * the faulting thread blocks until the pager supplies it.
+ *
+ * @param port Port to which page requests are sent
+ * @param cookie Opaque value included in all page requests
+ */
+rt::SharedPtr<MapEntry> MapEntry::makePager(const size_t length, const MappingFlags flags,
+        const rt::SharedPtr<ipc::Port> &port, const uintptr_t cookie) {
+    // allocate the bare map
+    if(!gMapEntryAllocator) initAllocator();
+    auto entry = gMapEntryAllocator->alloc(length, flags);
+
+    // set it up
+    entry->isPager = true;
+    entry->pagerPort = port;
+    entry->pagerCookie = cookie;
+
+    // create a shared ptr
+    auto ptr = rt::SharedPtr<MapEntry>(entry, MapEntryDeleter());
+    entry->handle = handle::Manager::makeVmObjectHandle(ptr);
+
+    return ptr;
+}
+
 /**
  * Frees a previously allocated VM map entry.
  */
@@ -160,8 +192,8 @@ int MapEntry::resize(const size_t newSize) {
  */
 bool MapEntry::handlePagefault(Map *map, const uintptr_t base, const uintptr_t offset,
         const bool present, const bool write) {
-    // only anonymous memory can be faulted in
-    if(!this->isAnon) {
+    // only anonymous and pager-backed memory can be faulted in
+    if(!this->isAnon && !this->isPager) {
         return false;
     }
     // the page must be _not_ present
@@ -174,11 +206,102 @@ bool MapEntry::handlePagefault(Map *map, const uintptr_t base, const uintptr_t o
     }
 
     // fault it in
+    const bool trace = debug::Trace::IsEnabled(debug::TraceEvent::PageFault);
+    const auto start = trace ? platform::GetLocalTsc() : 0;
+    bool handled{true};
+
+    if(this->isPager) {
+        handled = this->handlePagerFault(map, base, offset);
+    } else {
+        RW_LOCK_WRITE(&this->lock);
+        this->faultInPage(base, offset, map, true);
+        RW_UNLOCK_WRITE(&this->lock);
+    }
+
+    if(trace) {
+        debug::Trace::Record(debug::TraceEvent::PageFault, base + offset, write, base,
+                platform::GetLocalTsc() - start);
+    }
+
+    return handled;
+}
+
+/**
+ * Handles a fault on a pager-backed object. If the pager already provided the page, it's mapped;
+ * otherwise, a request for a cluster of pages around it is sent to the pager (unless a request
+ * that covers it is already outstanding) and the faulting thread blocks until it is completed.
+ *
+ * Once woken, the fault isn't resolved directly: the faulting instruction is simply retried, and
+ * maps the page on the second fault.
+ *
+ * @return Whether the page was provided; if not, the fault is unhandled.
+ */
+bool MapEntry::handlePagerFault(Map *map, const uintptr_t base, const uintptr_t offset) {
+    int err;
+    const auto pageSz = arch_page_size();
+    const auto pageOff = offset / pageSz;
+
+    auto flag = sched::SignalFlag::make();
+    bool send{true};
+
+    // map the page if we've already got it; otherwise, register as a waiter
     RW_LOCK_WRITE(&this->lock);
-    this->faultInPage(base, offset, map, true);
+
+    if(this->pages.findKey(pageOff)) {
+        this->faultInPage(base, offset, map, false);
+        RW_UNLOCK_WRITE(&this->lock);
+        return true;
+    }
+
+    const auto numPages = this->length / pageSz;
+    PagerWaiter waiter(pageOff, pageOff, (numPages - pageOff) < kPagerClusterPages ?
+            (numPages - pageOff) : kPagerClusterPages, flag);
+
+    for(const auto &other : this->pagerWaiters) {
+        if(pageOff >= other.reqStart && pageOff < (other.reqStart + other.reqPages)) {
+            waiter.reqStart = other.reqStart;
+            waiter.reqPages = other.reqPages;
+            send = false;
+            break;
+        }
+    }
+
+    this->pagerWaiters.append(waiter);
     RW_UNLOCK_WRITE(&this->lock);
 
-    return true;
+    // send the request; if that fails, fail all faults waiting on it
+    if(send) {
+        PagerRequest req{kPagerRequestType};
+        req.region = static_cast<uintptr_t>(this->handle);
+        req.cookie = this->pagerCookie;
+        req.offset = waiter.reqStart * pageSz;
+        req.length = waiter.reqPages * pageSz;
+
+        err = this->pagerPort->send(&req, sizeof(req));
+        if(err) {
+            log("failed to send page request for $%p'h to port $%p'h: %d", this->handle,
+                    this->pagerPort->getHandle(), err);
+            this->completePagerRequests(req.offset, req.length);
+        }
+    }
+
+    // wait for the page (this returns immediately if the request was already completed)
+    const auto ret = sched::Thread::current()->blockOn(flag, platform_timer_now() + kPagerTimeout);
+
+    RW_LOCK_WRITE(&this->lock);
+
+    if(ret == sched::Thread::BlockOnReturn::Timeout) {
+        log("timed out waiting for page %lu of $%p'h", pageOff, this->handle);
+
+        this->pagerWaiters.removeMatching([](void *ctx, PagerWaiter &w) -> bool {
+            return (w.flag.get() == ctx);
+        }, flag.get());
+    }
+
+    const bool provided = !!this->pages.findKey(pageOff);
+    RW_UNLOCK_WRITE(&this->lock);
+
+    return provided;
 }
 
 /**
@@ -352,6 +475,116 @@ int MapEntry::faultInAllPages() {
     return 0;
 }
 
+/**
+ * Replaces the physical page at the given offset of an anonymous object with a freshly allocated
+ * page, and returns the page that was previously there. The new page is mapped in place of the old
+ * one in all views of the object.
+ *
+ * This is used to move pages that the pager prepared into a pager-backed object without copying.
+ *
+ * @param outPhysAddr Physical address of the removed page; the caller is responsible for it
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int MapEntry::exchangePage(const uintptr_t offset, uint64_t &outPhysAddr) {
+    int err;
+    const auto pageSz = arch_page_size();
+    const auto pageOff = offset / pageSz;
+
+    if(!this->isAnon) {
+        return -1;
+    }
+
+    RW_LOCK_WRITE_GUARD(this->lock);
+
+    // the page must have been faulted in
+    auto info = this->pages.findKey(pageOff);
+    if(!info) {
+        return -1;
+    }
+
+    const auto page = mem::PhysicalAllocator::alloc();
+    if(!page) {
+        return -1;
+    }
+
+    auto task = sched::Task::current();
+    if(task) {
+        __atomic_add_fetch(&task->physPagesOwned, 1, __ATOMIC_RELEASE);
+    }
+
+    outPhysAddr = info->physAddr;
+    info->physAddr = page;
+
+    // remap it in all views
+    for(const auto &view : this->mappedIn) {
+        auto map = view.task->vm.get();
+
+        auto flg = this->flags;
+        if(view.flags != MappingFlags::None) {
+            flg &= ~MappingFlags::PermissionsMask;
+            flg |= (flg & view.flags);
+        }
+
+        const auto vmAddr = view.base + (pageOff * pageSz);
+        err = map->add(page, pageSz, vmAddr, ConvertVmMode(flg, !this->isKernel));
+        REQUIRE(!err, "failed to map vm object %p ($%08x'h) addr $%08x %d", this, this->handle,
+                vmAddr, err);
+
+        arch::InvalidateTlb(vmAddr);
+    }
+
+    return 0;
+}
+
+/**
+ * Inserts a page provided by the pager. If the page was already provided, the new page is freed
+ * instead.
+ *
+ * Waiting threads are not woken; call completePagerRequests() once all pages were inserted.
+ *
+ * @return 0 if the page was inserted, 1 if it was already present.
+ */
+int MapEntry::supplyPage(const uintptr_t offset, const uint64_t physAddr) {
+    const auto pageOff = offset / arch_page_size();
+
+    RW_LOCK_WRITE_GUARD(this->lock);
+
+    if(this->pages.findKey(pageOff)) {
+        this->freePage(AnonInfoLeaf(pageOff, physAddr));
+        return 1;
+    }
+
+    auto info = new AnonInfoLeaf(pageOff, physAddr);
+    this->pages.insert(info);
+
+    return 0;
+}
+
+/**
+ * Wakes all threads that are waiting for pages in the given range. They'll retry their accesses,
+ * which fail if the pager did not provide the page.
+ */
+void MapEntry::completePagerRequests(const uintptr_t offset, const size_t length) {
+    const auto pageSz = arch_page_size();
+
+    struct Range {
+        uintptr_t start, end;
+    } range{offset / pageSz, (offset + length + pageSz - 1) / pageSz};
+
+    RW_LOCK_WRITE_GUARD(this->lock);
+
+    this->pagerWaiters.removeMatching([](void *ctx, PagerWaiter &w) -> bool {
+        auto r = reinterpret_cast<Range *>(ctx);
+        if(w.pageOff < r->start || w.pageOff >= r->end) {
+            return false;
+        }
+
+        w.flag->signal();
+        return true;
+    }, &range);
+}
+
 /**
  * Frees a memory page belonging to this map.
  */
@@ -413,7 +646,7 @@ void MapEntry::updateExistingMappingFlags() {
     for(const auto &view : this->mappedIn) {
         auto map = view.task->vm.get();
 
-        if(this->isAnon) {
+        if(this->isAnon || this->isPager) {
             this->mapAnonPages(map, view.base, view.flags, true);
         } else {
             this->mapPhysMem(map, view.base, view.flags, true);
@@ -441,7 +674,7 @@ void MapEntry::addedToMap(Map *map, const rt::SharedPtr<sched::Task> &task, cons
 
     // map all allocated physical anon pages
     RW_LOCK_WRITE_GUARD(this->lock);
-    if(this->isAnon) {
+    if(this->isAnon || this->isPager) {
         this->mapAnonPages(map, baseAddr, flagsMask, false);
     }
     // otherwise, map the whole thing
@@ -525,16 +758,38 @@ void MapEntry::mapPhysMem(Map *map, const uintptr_t base, const MappingFlags mas
  */
 void MapEntry::removedFromMap(Map *map, const rt::SharedPtr<sched::Task> &task,
         const uintptr_t base, const size_t length) {
-    RW_LOCK_WRITE_GUARD(this->lock);
+    bool notifyPager{false};
+
+    {
+        RW_LOCK_WRITE_GUARD(this->lock);
 
-    // remove it from the provided map
-    int err = map->remove(base, length);
-    REQUIRE(!err, "failed to unmap vm object: %d", err);
+        // remove it from the provided map
+        int err = map->remove(base, length);
+        REQUIRE(!err, "failed to unmap vm object: %d", err);
 
-    // remove the view info object
-    this->mappedIn.removeMatching([](void *task, ViewInfo &view) -> bool {
-        return (view.task.get() == task);
-    }, task.get());
+        // remove the view info object
+        this->mappedIn.removeMatching([](void *task, ViewInfo &view) -> bool {
+            return (view.task.get() == task);
+        }, task.get());
+
+        notifyPager = this->isPager && this->mappedIn.empty();
+    }
+
+    /*
+     * Once a pager-backed object isn't mapped anywhere anymore, tell the pager so it can release
+     * its reference. This happens when the last task that mapped it unmaps it, or is destroyed.
+     */
+    if(notifyPager) {
+        PagerRequest req{kPagerReleaseType};
+        req.region = static_cast<uintptr_t>(this->handle);
+        req.cookie = this->pagerCookie;
+
+        int err = this->pagerPort->send(&req, sizeof(req));
+        if(err) {
+            log("failed to send release for $%p'h to port $%p'h: %d", this->handle,
+                    this->pagerPort->getHandle(), err);
+        }
+    }
 
     // TODO: find new task to transfer ownership of pages to
     /*sched::Task *newOwner = nullptr;
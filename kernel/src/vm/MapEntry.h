@@ -11,7 +11,12 @@
 
 #include <arch/rwlock.h>
 
+namespace ipc {
+class Port;
+}
+
 namespace sched {
+class SignalFlag;
 struct Task;
 }
 
@@ -57,7 +62,8 @@ enum class MappingFlags {
  * Represents an allocation of virtual memory.
  *
  * This range may be backed by physical memory, device memory, or nothing at all. Pages can be
- * faulted in on demand.
+ * faulted in on demand; for pager-backed objects, their contents are requested from a userspace
+ * pager (such as a filesystem server) when first accessed.
  *
  * VM entry objects are reference counted, and may be present in multiple maps simultaneously; this
  * enables shared memory. When the last reference to the entry is removed, it's deallocated, and
@@ -96,6 +102,10 @@ class MapEntry {
         constexpr inline bool backedByAnonymousMem() const {
             return this->isAnon;
         }
+        /// whether pages are provided by a userspace pager
+        constexpr inline bool backedByPager() const {
+            return this->isPager;
+        }
         /// whether the object is copy on write or not
         inline bool isCoW() const {
             return TestFlags(this->getFlags() & MappingFlags::CopyOnWrite);
@@ -109,6 +119,13 @@ class MapEntry {
         /// Force all pages to be faulted in
         [[nodiscard]] int faultInAllPages();
 
+        /// Replaces a physical page of an anonymous object with a fresh page, returning the old one
+        [[nodiscard]] int exchangePage(const uintptr_t offset, uint64_t &outPhysAddr);
+        /// Inserts a physical page provided by the pager
+        int supplyPage(const uintptr_t offset, const uint64_t physAddr);
+        /// Wakes all threads waiting for the pager to provide pages in the given range
+        void completePagerRequests(const uintptr_t offset, const size_t length);
+
         /**
          * Sets the owning task for the map.
          *
@@ -129,12 +146,59 @@ class MapEntry {
         /// Allocates an anonymous VM object
         static rt::SharedPtr<MapEntry> makeAnon(const size_t length, const MappingFlags flags,
                 const bool kernel = false);
+        /// Allocates a VM object whose pages are provided by a userspace pager
+        static rt::SharedPtr<MapEntry> makePager(const size_t length, const MappingFlags flags,
+                const rt::SharedPtr<ipc::Port> &port, const uintptr_t cookie);
         /// Releases a VM object
         static void free(MapEntry *entry);
 
     private:
         /// Maximum number of sequential pages to fault in
         constexpr static const size_t kMaxSequentialPrefault{64};
+        /// Number of pages requested from the pager at once
+        constexpr static const size_t kPagerClusterPages{8};
+        /// Time to wait for the pager to provide a page before failing the fault (in ns)
+        constexpr static const uint64_t kPagerTimeout{30ULL * 1000 * 1000 * 1000};
+        /// Message type for page requests sent to the pager
+        constexpr static const uint32_t kPagerRequestType{0x50414745};
+        /// Message type sent to the pager once the object is no longer mapped in any task
+        constexpr static const uint32_t kPagerReleaseType{0x5052454C};
+
+        /**
+         * Message sent to the pager port when pages of a pager-backed object are needed.
+         */
+        struct PagerRequest {
+            /// kPagerRequestType, or kPagerReleaseType (in which case the range is unused)
+            uint32_t type;
+            uint32_t reserved{0};
+            /// handle of the VM object
+            uintptr_t region;
+            /// cookie specified when the object was created
+            uintptr_t cookie;
+            /// byte offset into the object of the first page requested
+            uint64_t offset;
+            /// number of bytes requested
+            uint64_t length;
+        };
+
+        /**
+         * A thread waiting for the pager to provide a page.
+         */
+        struct PagerWaiter {
+            /// page the thread faulted on
+            uintptr_t pageOff{0};
+            /// first page of the request that will provide the page
+            uintptr_t reqStart{0};
+            /// number of pages in that request
+            size_t reqPages{0};
+            /// signalled once the page was provided (or the request failed)
+            rt::SharedPtr<sched::SignalFlag> flag;
+
+            PagerWaiter() = default;
+            PagerWaiter(const uintptr_t _pageOff, const uintptr_t _reqStart, const size_t _reqPages,
+                    const rt::SharedPtr<sched::SignalFlag> &_flag) : pageOff(_pageOff),
+                reqStart(_reqStart), reqPages(_reqPages), flag(_flag) {}
+        };
 
         /**
          * Tree node representing a single physical page backing some page of this mapping.
@@ -228,6 +292,9 @@ class MapEntry {
         void removedFromMap(Map *, const rt::SharedPtr<sched::Task> &, const uintptr_t,
                 const size_t);
 
+        /// Requests a page from the pager and waits for it to be provided.
+        bool handlePagerFault(Map *map, const uintptr_t base, const uintptr_t offset);
+
         /// Faults in an anonymous memory page.
         void faultInPage(const uintptr_t base, const uintptr_t offset, Map *map,
                 const bool runDetector);
@@ -254,9 +321,18 @@ class MapEntry {
         bool isKernel{false};
         /// when set, this is an anonymous mapping and is backed by anonymous phys mem
         bool isAnon{false};
+        /// when set, pages are provided by a userspace pager
+        bool isPager{false};
         /// if not an anonymous map, the physical address base
         uint64_t physBase{0};
 
+        /// port to which page requests are sent, for pager-backed objects
+        rt::SharedPtr<ipc::Port> pagerPort;
+        /// opaque value passed to the pager with each request
+        uintptr_t pagerCookie{0};
+        /// threads waiting for pages from the pager
+        rt::List<PagerWaiter> pagerWaiters;
+
         /// state of the sequence detector
         SequenceDetectorState seqState;
         /// page offset at which the last page fault took place
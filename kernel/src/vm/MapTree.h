@@ -228,6 +228,19 @@ class MapTree: public rt::BinarySearchTree<MapTreeLeaf> {
             return this->remove(address, this->root);
         }
 
+        /**
+         * Returns an arbitrary mapping in the tree; this is used to remove all mappings.
+         *
+         * @return VM object of the mapping, or `nullptr` if the tree is empty.
+         */
+        rt::SharedPtr<MapEntry> any(uintptr_t &outBase, size_t &outLength) {
+            if(!this->root) return nullptr;
+
+            outBase = this->root->address;
+            outLength = this->root->size;
+            return this->root->entry;
+        }
+
         /**
          * Performs an in-order traversal of the tree, invoking the given callback for each of the
          * nodes in the tree.
@@ -0,0 +1,282 @@
+#include <gfx/Pixels.h>
+#include "pixels/Kernels.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace gui::gfx::pixels;
+
+/// Fails the test (and exits) if the condition is false
+#define CHECK(cond, ...) do { if(!(cond)) { \
+    fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+    fprintf(stderr, __VA_ARGS__); \
+    fputc('\n', stderr); \
+    exit(1); \
+} } while(0)
+
+/// Longest span tested; a few times the widest vector, plus some left over pixels
+constexpr static const size_t kMaxLength{3 * 8 + 7};
+/// Largest misalignment (in pixels) of the start of spans
+constexpr static const size_t kMaxOffset{8};
+/// Pixels on either side of each span, which must not be modified
+constexpr static const size_t kGuard{16};
+
+/// All implementations other than the scalar reference
+constexpr static const Implementation kVectorImpls[]{
+    Implementation::Sse2,
+    Implementation::Avx2,
+};
+
+static uint64_t gRngState{0x853C49E6748FEA9BULL};
+
+/// Returns a pseudo random 32-bit number (xorshift64*)
+static uint32_t Random() {
+    gRngState ^= gRngState >> 12;
+    gRngState ^= gRngState << 25;
+    gRngState ^= gRngState >> 27;
+    return static_cast<uint32_t>((gRngState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/**
+ * Returns a random premultiplied ARGB32 pixel. Fully transparent and fully opaque pixels are
+ * produced in runs, so that the fast paths of the blending code for entire vectors of them are
+ * exercised as well.
+ */
+static uint32_t RandomPremultiplied(const size_t i) {
+    switch((i / 4 + Random()) % 4) {
+        case 0:
+            return 0;
+        case 1:
+            return 0xFF000000 | (Random() & 0xFFFFFF);
+        default: {
+            const uint32_t a = Random() & 0xFF;
+            const uint32_t r = a ? Random() % (a + 1) : 0;
+            const uint32_t g = a ? Random() % (a + 1) : 0;
+            const uint32_t b = a ? Random() % (a + 1) : 0;
+            return (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+/**
+ * Checks the scalar blend against the definition: each destination component is scaled by the
+ * inverse source alpha, divided by 255 with rounding to nearest, and the source component added,
+ * saturating at 255. This is checked for all destination values and alphas, and all source
+ * component values that are valid for the alpha (plus a few that aren't, to test saturation.)
+ */
+static void TestBlendPixel() {
+    for(uint32_t a = 0; a < 256; a++) {
+        const uint32_t ia = 255 - a;
+
+        for(uint32_t d = 0; d < 256; d++) {
+            for(uint32_t s = 0; s <= a + 2 && s < 256; s++) {
+                uint32_t expected = ((d * ia * 2) + 255) / 510 + s;
+                if(expected > 255) expected = 255;
+                uint32_t expectedAlpha = ((d * ia * 2) + 255) / 510 + a;
+                if(expectedAlpha > 255) expectedAlpha = 255;
+
+                const uint32_t dst = (d << 24) | (d << 16) | (d << 8) | d;
+                const uint32_t src = (a << 24) | (s << 16) | (s << 8) | s;
+                const uint32_t got = impl::BlendPixel(dst, src);
+                const uint32_t want = (expectedAlpha << 24) | (expected << 16) | (expected << 8) |
+                    expected;
+
+                CHECK(got == want, "d=%u a=%u s=%u: got %08x, expected %08x", d, a, s, got, want);
+            }
+        }
+    }
+}
+
+/**
+ * Checks the single pixel conversions against their definitions: narrowing drops low bits, and
+ * widening replicates the high bits, so that converting back gives the original value.
+ */
+static void TestPixelConversions() {
+    for(uint32_t p = 0; p < 0x10000; p++) {
+        const auto argb = impl::PixelRgb565ToArgb32(p);
+        CHECK(impl::PixelArgb32ToRgb565(argb) == p, "rgb565 %04x round trip", p);
+    }
+    for(uint32_t c = 0; c < 256; c++) {
+        const uint32_t argb = 0xFF000000 | (c << 16) | (c << 8) | c;
+        const auto rgb30 = impl::PixelArgb32ToRgb30(argb);
+        const uint32_t c10 = (c << 2) | (c >> 6);
+
+        CHECK(rgb30 == ((c10 << 20) | (c10 << 10) | c10), "rgb30 of %02x: %08x", c, rgb30);
+        CHECK(impl::PixelRgb30ToArgb32(rgb30) == argb, "rgb30 %08x round trip", rgb30);
+    }
+}
+
+/**
+ * Runs a span operation with both the reference and the implementation under test, for all
+ * lengths and misalignments; the entire destination buffers (including guard areas around the
+ * span) must be identical afterwards.
+ *
+ * @param makeSrc Produces the source pixel at the given index
+ * @param ref Runs the reference implementation on (dst, src, count)
+ * @param test Runs the implementation under test on (dst, src, count)
+ */
+template<typename Dst, typename Src, typename MakeSrc, typename Ref, typename Test>
+static void CompareSpans(const char *what, const char *impl, MakeSrc makeSrc, Ref ref, Test test) {
+    constexpr static const size_t kBufLen{kGuard + kMaxOffset + kMaxLength + kGuard};
+
+    std::vector<Src> src(kBufLen);
+    std::vector<Dst> dstRef(kBufLen), dstTest(kBufLen);
+
+    for(size_t len = 0; len <= kMaxLength; len++) {
+        for(size_t srcOff = 0; srcOff < kMaxOffset; srcOff++) {
+            for(size_t dstOff = 0; dstOff < kMaxOffset; dstOff++) {
+                for(size_t i = 0; i < kBufLen; i++) {
+                    src[i] = makeSrc(i);
+                    dstRef[i] = dstTest[i] = static_cast<Dst>(Random());
+                }
+
+                ref(dstRef.data() + kGuard + dstOff, src.data() + kGuard + srcOff, len);
+                test(dstTest.data() + kGuard + dstOff, src.data() + kGuard + srcOff, len);
+
+                for(size_t i = 0; i < kBufLen; i++) {
+                    CHECK(dstRef[i] == dstTest[i], "%s (%s): length %lu, src offset %lu, "
+                            "dst offset %lu: pixel %ld is %08x, expected %08x", what, impl,
+                            (unsigned long) len, (unsigned long) srcOff, (unsigned long) dstOff,
+                            (long) i - (long) (kGuard + dstOff), (unsigned) dstTest[i],
+                            (unsigned) dstRef[i]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Compares all span routines of the currently selected implementation against the scalar ones.
+ */
+static void TestSpans(const char *impl) {
+    const auto &ref = impl::gScalarKernels;
+    auto anyPixel = [](size_t) -> uint32_t { return Random(); };
+    auto anyRgb565 = [](size_t) -> uint16_t { return static_cast<uint16_t>(Random()); };
+
+    CompareSpans<uint32_t, uint32_t>("BlendOver", impl, RandomPremultiplied, ref.blendOver,
+            BlendOver);
+    // not valid premultiplied pixels, but the results must still be identical
+    CompareSpans<uint32_t, uint32_t>("BlendOver (invalid)", impl, anyPixel, ref.blendOver,
+            BlendOver);
+
+    CompareSpans<uint32_t, uint32_t>("Fill", impl, anyPixel,
+            [&](uint32_t *d, const uint32_t *s, size_t n) { ref.fill(d, *(s - 1), n); },
+            [](uint32_t *d, const uint32_t *s, size_t n) { Fill(d, *(s - 1), n); });
+
+    CompareSpans<uint32_t, uint32_t>("ConvertArgb32ToRgb30", impl, anyPixel, ref.argb32ToRgb30,
+            ConvertArgb32ToRgb30);
+    CompareSpans<uint32_t, uint32_t>("ConvertRgb30ToArgb32", impl, anyPixel, ref.rgb30ToArgb32,
+            ConvertRgb30ToArgb32);
+    CompareSpans<uint16_t, uint32_t>("ConvertArgb32ToRgb565", impl, anyPixel, ref.argb32ToRgb565,
+            ConvertArgb32ToRgb565);
+    CompareSpans<uint32_t, uint16_t>("ConvertRgb565ToArgb32", impl, anyRgb565, ref.rgb565ToArgb32,
+            ConvertRgb565ToArgb32);
+    CompareSpans<uint32_t, uint32_t>("SwapArgb32Bgra", impl, anyPixel, ref.swapBgra,
+            SwapArgb32Bgra);
+}
+
+/**
+ * Checks the rectangle routines against row by row invocations of the scalar routines, with
+ * pitches that leave padding between the rows.
+ */
+static void TestRects(const char *impl) {
+    constexpr static const size_t kWidth{37}, kHeight{5};
+    constexpr static const size_t kSrcPitch{(kWidth + 3) * 4}, kDstPitch{(kWidth + 11) * 4};
+    const auto &ref = impl::gScalarKernels;
+
+    std::vector<uint32_t> src(kSrcPitch / 4 * kHeight);
+    std::vector<uint32_t> dstRef(kDstPitch / 4 * kHeight), dstTest(dstRef.size());
+
+    for(size_t i = 0; i < src.size(); i++) src[i] = RandomPremultiplied(i);
+    for(size_t i = 0; i < dstRef.size(); i++) dstRef[i] = dstTest[i] = Random();
+
+    for(size_t y = 0; y < kHeight; y++) {
+        ref.blendOver(dstRef.data() + y * kDstPitch / 4, src.data() + y * kSrcPitch / 4, kWidth);
+    }
+    BlendOverRect(dstTest.data(), kDstPitch, src.data(), kSrcPitch, kWidth, kHeight);
+    CHECK(dstRef == dstTest, "BlendOverRect (%s)", impl);
+
+    for(size_t y = 0; y < kHeight; y++) {
+        ref.fill(dstRef.data() + y * kDstPitch / 4, 0x80402010, kWidth);
+    }
+    FillRect(dstTest.data(), kDstPitch, 0x80402010, kWidth, kHeight);
+    CHECK(dstRef == dstTest, "FillRect (%s)", impl);
+
+    for(size_t y = 0; y < kHeight; y++) {
+        memcpy(dstRef.data() + y * kDstPitch / 4, src.data() + y * kSrcPitch / 4, kWidth * 4);
+    }
+    CopyRect(dstTest.data(), kDstPitch, src.data(), kSrcPitch, kWidth, kHeight);
+    CHECK(dstRef == dstTest, "CopyRect (%s)", impl);
+}
+
+/**
+ * Measures the throughput of each routine of the current implementation on a full HD frame.
+ */
+static void Benchmark() {
+    constexpr static const size_t kPixels{1920 * 1080};
+    constexpr static const size_t kRounds{50};
+
+    std::vector<uint32_t> src(kPixels), dst(kPixels);
+    std::vector<uint16_t> dst16(kPixels);
+    for(size_t i = 0; i < kPixels; i++) {
+        src[i] = RandomPremultiplied(i);
+        dst[i] = Random();
+    }
+
+    auto measure = [&](const char *what, auto fn) {
+        const auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < kRounds; i++) fn();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        printf("  %-24s %8.1f Mpixel/s\n", what, double(kPixels * kRounds) * 1e3 / double(ns));
+    };
+
+    printf("%s:\n", GetImplementationName());
+    measure("BlendOver", [&]{ BlendOver(dst.data(), src.data(), kPixels); });
+    measure("Fill", [&]{ Fill(dst.data(), 0xFF123456, kPixels); });
+    measure("Copy", [&]{ Copy(dst.data(), src.data(), kPixels); });
+    measure("ConvertArgb32ToRgb30", [&]{ ConvertArgb32ToRgb30(dst.data(), src.data(), kPixels); });
+    measure("ConvertRgb30ToArgb32", [&]{ ConvertRgb30ToArgb32(dst.data(), src.data(), kPixels); });
+    measure("ConvertArgb32ToRgb565", [&]{
+        ConvertArgb32ToRgb565(dst16.data(), src.data(), kPixels);
+    });
+    measure("ConvertRgb565ToArgb32", [&]{
+        ConvertRgb565ToArgb32(dst.data(), dst16.data(), kPixels);
+    });
+    measure("SwapArgb32Bgra", [&]{ SwapArgb32Bgra(dst.data(), src.data(), kPixels); });
+}
+
+/**
+ * Checks the pixel routines; if invoked with `-b`, also benchmarks all implementations supported
+ * by the processor.
+ */
+int main(int argc, char **argv) {
+    const bool bench = (argc > 1 && !strcmp(argv[1], "-b"));
+
+    TestBlendPixel();
+    TestPixelConversions();
+
+    CHECK(SetImplementation(Implementation::Scalar), "scalar implementation unavailable");
+    TestRects(GetImplementationName());
+    if(bench) Benchmark();
+
+    for(const auto which : kVectorImpls) {
+        if(!SetImplementation(which)) continue;
+
+        const auto name = GetImplementationName();
+        TestSpans(name);
+        TestRects(name);
+        printf("%s matches scalar\n", name);
+
+        if(bench) Benchmark();
+    }
+
+    printf("all pixel tests passed\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+/*
+ * printf routines under test (user/lib/libc/src/string/printf.c)
+ */
+int libc_snprintf(char *buffer, size_t count, const char *format, ...);
+int libc_vsnprintf(char *buffer, size_t count, const char *format, va_list va);
+int libc_fctvprintf(void (*out)(char character, void *arg), void *arg, const char *format,
+        va_list va);
+int libc_chunkprintf(void (*out)(const char *chunk, size_t length, void *arg), void *arg,
+        const char *format, ...);
+int libc_vchunkprintf(void (*out)(const char *chunk, size_t length, void *arg), void *arg,
+        const char *format, va_list va);
+}
+
+/// Fails the test (and exits) if the condition is false
+#define CHECK(cond, ...) do { if(!(cond)) { \
+    fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+    fprintf(stderr, __VA_ARGS__); \
+    fputc('\n', stderr); \
+    exit(1); \
+} } while(0)
+
+/// Size of the chunk buffer the printf routines were built with
+constexpr static const size_t kChunkSize{PRINTF_CHUNK_BUFFER_SIZE};
+
+/**
+ * Output of a chunked printf call, and the individual chunks it was passed in
+ */
+struct Chunks {
+    std::string output;
+    std::vector<size_t> lengths;
+
+    static void Append(const char *chunk, size_t length, void *arg) {
+        auto self = reinterpret_cast<Chunks *>(arg);
+        self->output.append(chunk, length);
+        self->lengths.push_back(length);
+    }
+};
+
+static void AppendChar(char character, void *arg) {
+    reinterpret_cast<std::string *>(arg)->push_back(character);
+}
+
+/**
+ * Formats the given format string with all output routines, and ensures they all produce the
+ * expected string and return its length.
+ */
+static void Expect(const char *expected, const char *format, ...) {
+    va_list va, va2, va3;
+    char buf[256];
+    const int len = static_cast<int>(strlen(expected));
+
+    va_start(va, format);
+    va_copy(va2, va);
+    va_copy(va3, va);
+
+    const int ret = libc_vsnprintf(buf, sizeof(buf), format, va);
+    CHECK(ret == len, "vsnprintf(\"%s\") returned %d, expected %d", format, ret, len);
+    CHECK(!strcmp(buf, expected), "vsnprintf(\"%s\") = \"%s\", expected \"%s\"", format, buf,
+            expected);
+
+    std::string chars;
+    const int fctRet = libc_fctvprintf(AppendChar, &chars, format, va2);
+    CHECK(fctRet == len, "fctvprintf(\"%s\") returned %d, expected %d", format, fctRet, len);
+    CHECK(chars == expected, "fctvprintf(\"%s\") = \"%s\", expected \"%s\"", format,
+            chars.c_str(), expected);
+
+    Chunks chunks;
+    const int chunkRet = libc_vchunkprintf(Chunks::Append, &chunks, format, va3);
+    CHECK(chunkRet == len, "vchunkprintf(\"%s\") returned %d, expected %d", format, chunkRet, len);
+    CHECK(chunks.output == expected, "vchunkprintf(\"%s\") = \"%s\", expected \"%s\"", format,
+            chunks.output.c_str(), expected);
+
+    va_end(va3);
+    va_end(va2);
+    va_end(va);
+}
+
+/**
+ * Conversions with combinations of flags, width and precision.
+ */
+static void TestConversions() {
+    Expect("-005    ", "%-8.3d", -5);
+    Expect("042     ", "%-8.3d", 42);
+    Expect("    -005", "%8.3d", -5);
+    Expect("+042", "%+.3d", 42);
+    Expect("12345", "%-3.2d", 12345);
+
+    Expect("010", "%#.3o", 8);
+    Expect("010", "%#o", 8);
+    Expect("0777", "%#.3o", 0777);
+    Expect("000", "%#.3o", 0);
+    Expect("0", "%#o", 0);
+    Expect("0xff", "%#x", 255);
+    Expect("0X00FF", "%#06X", 255);
+
+    Expect("%", "%%");
+    Expect("   ab|cd   ", "%5s|%-5s", "ab", "cd");
+    Expect("abc", "%.3s", "abcdef");
+}
+
+/**
+ * A format string ending in a lone '%' outputs everything before it, and nothing else.
+ */
+static void TestTrailingPercent() {
+    Expect("", "%");
+    Expect("abc", "abc%");
+    Expect("42", "%d%", 42);
+    Expect("  x", "%3c%", 'x');
+}
+
+/**
+ * NULL strings print as "(null)", subject to the usual width and precision.
+ */
+static void TestNullString() {
+    const char *null = nullptr;
+
+    Expect("(null)", "%s", null);
+    Expect("  (null)", "%8s", null);
+    Expect("(null)  |", "%-8s|", null);
+    Expect("(nu", "%.3s", null);
+}
+
+/**
+ * Output that doesn't fit in a single chunk is split into several, none larger than the chunk
+ * buffer; the split may fall anywhere: in literal text, padding or a converted number.
+ */
+static void TestChunkSplits() {
+    const std::string literal(3 * kChunkSize + 5, 'L');
+
+    for(size_t width = 0; width <= 3 * kChunkSize + 1; width++) {
+        for(size_t prefix = 0; prefix < kChunkSize + 2; prefix += 7) {
+            const std::string text = literal.substr(0, prefix);
+
+            char expected[1024];
+            const int len = snprintf(expected, sizeof(expected), "%s%*d|%-*x|%s", text.c_str(),
+                    static_cast<int>(width), -123456789, static_cast<int>(width / 2), 0xbeef,
+                    text.c_str());
+            CHECK(len > 0 && static_cast<size_t>(len) < sizeof(expected), "reference failed");
+
+            Chunks chunks;
+            const int ret = libc_chunkprintf(Chunks::Append, &chunks, "%s%*d|%-*x|%s",
+                    text.c_str(), static_cast<int>(width), -123456789,
+                    static_cast<int>(width / 2), 0xbeef, text.c_str());
+
+            CHECK(ret == len, "width %zu prefix %zu: returned %d, expected %d", width, prefix,
+                    ret, len);
+            CHECK(chunks.output == expected, "width %zu prefix %zu: \"%s\", expected \"%s\"",
+                    width, prefix, chunks.output.c_str(), expected);
+
+            // every chunk but the last must be completely full
+            CHECK(chunks.lengths.size() == (len + kChunkSize - 1) / kChunkSize,
+                    "width %zu prefix %zu: %zu chunks for %d chars", width, prefix,
+                    chunks.lengths.size(), len);
+            for(size_t i = 0; i < chunks.lengths.size(); i++) {
+                CHECK(chunks.lengths[i] && chunks.lengths[i] <= kChunkSize,
+                        "width %zu prefix %zu: chunk %zu is %zu bytes", width, prefix, i,
+                        chunks.lengths[i]);
+                CHECK(i + 1 == chunks.lengths.size() || chunks.lengths[i] == kChunkSize,
+                        "width %zu prefix %zu: chunk %zu is short (%zu bytes)", width, prefix, i,
+                        chunks.lengths[i]);
+            }
+        }
+    }
+
+    // no output means the output function is never invoked
+    Chunks chunks;
+    CHECK(!libc_chunkprintf(Chunks::Append, &chunks, "%s", ""), "empty output");
+    CHECK(chunks.lengths.empty(), "%zu chunks for empty output", chunks.lengths.size());
+}
+
+/**
+ * snprintf always returns the length of the full output, but writes at most count - 1
+ * characters plus a terminating NUL, and never touches the buffer beyond that.
+ */
+static void TestTruncation() {
+    constexpr static const char kFull[]{"hello-12345-ff"};
+    constexpr static const int kFullLen{sizeof(kFull) - 1};
+    constexpr static const char kSentinel{'#'};
+
+    for(size_t count = 0; count <= kFullLen + 2; count++) {
+        char buf[kFullLen + 8];
+        memset(buf, kSentinel, sizeof(buf));
+
+        const int ret = libc_snprintf(buf, count, "%s-%d-%x", "hello", 12345, 0xff);
+        CHECK(ret == kFullLen, "count %zu: returned %d, expected %d", count, ret, kFullLen);
+
+        if(!count) {
+            CHECK(buf[0] == kSentinel, "count 0: buffer was written");
+            continue;
+        }
+
+        const size_t written = (count - 1 < kFullLen) ? count - 1 : kFullLen;
+        CHECK(!memcmp(buf, kFull, written), "count %zu: wrong output \"%.*s\"", count,
+                static_cast<int>(written), buf);
+        CHECK(buf[written] == '\0', "count %zu: not terminated at %zu", count, written);
+        for(size_t i = written + 1; i < sizeof(buf); i++) {
+            CHECK(buf[i] == kSentinel, "count %zu: byte %zu was written", count, i);
+        }
+    }
+
+    // a NULL buffer only measures the output
+    CHECK(libc_snprintf(nullptr, 0, "%s-%d-%x", "hello", 12345, 0xff) == kFullLen,
+            "NULL buffer");
+}
+
+int main(int argc, char **argv) {
+    TestConversions();
+    TestTrailingPercent();
+    TestNullString();
+    TestChunkSplits();
+    TestTruncation();
+
+    fprintf(stderr, "All printf tests passed\n");
+    return 0;
+}
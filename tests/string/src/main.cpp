@@ -0,0 +1,499 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+extern "C" {
+#include "cpu_features.h"
+
+/*
+ * libc routines under test (user/lib/libc/src/x86_64/string)
+ */
+void *libc_memchr(const void *ptr, const int value, const size_t num);
+int libc_memcmp(const void *ptr1, const void *ptr2, const size_t num);
+void *libc_memcpy(void *destination, const void *source, const size_t num);
+void *libc_memmove(void *dest, const void *src, const size_t n);
+void *libc_memset(void *ptr, const int value, const size_t num);
+void *libc_memclr(void *start, const size_t count);
+size_t libc_strlen(const char *str);
+
+/*
+ * Kernel routines under test (kernel/src/c/string.c)
+ */
+void kern_string_init();
+const void *kern_memchr(const void *ptr, const uint8_t value, const size_t num);
+int kern_memcmp(const void *ptr1, const void *ptr2, const size_t num);
+void *kern_memcpy(void *destination, const void *source, const size_t num);
+void *kern_memmove(void *dest, const void *src, const size_t n);
+void *kern_memset(void *ptr, const uint8_t value, const size_t num);
+void *kern_memclr(void *start, const size_t count);
+}
+
+/// Fails the test (and exits) if the condition is false
+#define CHECK(cond, ...) do { if(!(cond)) { \
+    fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+    fprintf(stderr, __VA_ARGS__); \
+    fputc('\n', stderr); \
+    exit(1); \
+} } while(0)
+
+/// Largest size for which all sizes and alignments are tested (a few cache lines)
+constexpr static const size_t kMaxExhaustiveSize{5 * 64};
+/// Alignments (relative to a cache line) tested for the source and destination
+constexpr static const size_t kMaxAlign{64};
+/// Bytes on either side of each destination, which must not be modified
+constexpr static const size_t kGuard{64};
+/// Larger sizes, which exercise the rep movsb/stosb paths
+constexpr static const size_t kLargeSizes[]{
+    1000, 2047, 2048, 2049, 4095, 4096, 4097, 10000, 65536 + 37,
+};
+
+/**
+ * A set of string routines under test
+ */
+struct Routines {
+    const char *name;
+
+    void *(*memcpy)(void *, const void *, size_t);
+    void *(*memmove)(void *, const void *, size_t);
+    void *(*memset)(void *, int, size_t);
+    void *(*memclr)(void *, size_t);
+    int (*memcmp)(const void *, const void *, size_t);
+    const void *(*memchr)(const void *, int, size_t);
+    /// strlen, if implemented
+    size_t (*strlen)(const char *);
+};
+
+static uint64_t gRngState{0x9E3779B97F4A7C15ULL};
+
+/// Returns a pseudo random byte (xorshift64*)
+static uint8_t RandomByte() {
+    gRngState ^= gRngState >> 12;
+    gRngState ^= gRngState << 25;
+    gRngState ^= gRngState >> 27;
+    return static_cast<uint8_t>((gRngState * 0x2545F4914F6CDD1DULL) >> 56);
+}
+
+/// Fills the buffer with random bytes
+static void Randomize(uint8_t *buf, const size_t len) {
+    for(size_t i = 0; i < len; i++) buf[i] = RandomByte();
+}
+
+/**
+ * Copies with memcpy for all sizes up to a few cache lines, and all source and destination
+ * alignments within a cache line. The destination must hold exactly the source bytes, and the
+ * bytes around it must be untouched.
+ */
+static void TestMemcpy(const Routines &r, const size_t maxSize, const size_t maxAlign) {
+    const size_t bufLen = kGuard + kMaxAlign + maxSize + kGuard;
+    std::vector<uint8_t> src(bufLen), dst(bufLen), pattern(bufLen);
+    Randomize(src.data(), bufLen);
+    Randomize(pattern.data(), bufLen);
+
+    auto test = [&](const size_t size, const size_t srcAlign, const size_t dstAlign) {
+        const size_t dstOff = kGuard + dstAlign;
+        memcpy(dst.data(), pattern.data(), bufLen);
+
+        auto s = src.data() + kGuard + srcAlign;
+        auto d = dst.data() + dstOff;
+
+        auto ret = r.memcpy(d, s, size);
+        CHECK(ret == d, "%s memcpy: wrong return value", r.name);
+        CHECK(!memcmp(d, s, size) && !memcmp(dst.data(), pattern.data(), dstOff) &&
+                !memcmp(d + size, pattern.data() + dstOff + size, bufLen - dstOff - size),
+                "%s memcpy: size %lu, src align %lu, dst align %lu", r.name,
+                (unsigned long) size, (unsigned long) srcAlign, (unsigned long) dstAlign);
+    };
+
+    // align the buffers to a cache line, so the alignments are relative to one
+    const auto srcBase = (kMaxAlign - (reinterpret_cast<uintptr_t>(src.data() + kGuard) % 64)) % 64;
+    const auto dstBase = (kMaxAlign - (reinterpret_cast<uintptr_t>(dst.data() + kGuard) % 64)) % 64;
+
+    for(size_t size = 0; size <= maxSize; size++) {
+        for(size_t sa = 0; sa < maxAlign; sa++) {
+            for(size_t da = 0; da < maxAlign; da++) {
+                test(size, (srcBase + sa) % kMaxAlign, (dstBase + da) % kMaxAlign);
+            }
+        }
+    }
+}
+
+/// Tests copies of the large sizes, with a few alignments
+static void TestMemcpyLarge(const Routines &r) {
+    for(const auto size : kLargeSizes) {
+        std::vector<uint8_t> src(size + 64), dst(size + 64 + 2 * kGuard), expected;
+
+        for(const size_t sa : {0, 1, 15, 32}) {
+            for(const size_t da : {0, 7, 16, 63}) {
+                Randomize(src.data(), src.size());
+                Randomize(dst.data(), dst.size());
+                expected = dst;
+                memcpy(expected.data() + kGuard + da, src.data() + sa, size);
+
+                r.memcpy(dst.data() + kGuard + da, src.data() + sa, size);
+                CHECK(dst == expected, "%s memcpy: size %lu, src align %lu, dst align %lu",
+                        r.name, (unsigned long) size, (unsigned long) sa, (unsigned long) da);
+            }
+        }
+    }
+}
+
+/**
+ * Moves blocks of all sizes up to a few cache lines within one buffer, for all distances between
+ * source and destination up to a cache line in either direction (including full overlap), and
+ * compares the buffer with the result of a byte-wise reference move.
+ */
+static void TestMemmove(const Routines &r, const size_t maxSize) {
+    constexpr static const ptrdiff_t kMaxDistance{80};
+    const size_t bufLen = kGuard + kMaxDistance + maxSize + kMaxDistance + kGuard;
+    std::vector<uint8_t> buf(bufLen), expected(bufLen), pattern(bufLen);
+    Randomize(pattern.data(), bufLen);
+
+    auto test = [&](const size_t size, const size_t srcOff, const size_t dstOff) {
+        memcpy(buf.data(), pattern.data(), buf.size());
+        memcpy(expected.data(), pattern.data(), buf.size());
+
+        // reference: move a byte at a time, in the direction that doesn't clobber the source
+        if(dstOff < srcOff) {
+            for(size_t i = 0; i < size; i++) expected[dstOff + i] = expected[srcOff + i];
+        } else {
+            for(size_t i = size; i--;) expected[dstOff + i] = expected[srcOff + i];
+        }
+
+        auto ret = r.memmove(buf.data() + dstOff, buf.data() + srcOff, size);
+        CHECK(ret == buf.data() + dstOff, "%s memmove: wrong return value", r.name);
+        CHECK(buf == expected, "%s memmove: size %lu, distance %ld, align %lu", r.name,
+                (unsigned long) size, (long) dstOff - (long) srcOff,
+                (unsigned long) (reinterpret_cast<uintptr_t>(buf.data() + srcOff) & 63));
+    };
+
+    for(size_t size = 0; size <= maxSize; size++) {
+        for(ptrdiff_t dist = -kMaxDistance; dist <= kMaxDistance; dist++) {
+            for(const size_t align : {0, 1, 9, 31}) {
+                const size_t srcOff = kGuard + kMaxDistance + align;
+                test(size, srcOff, srcOff + dist);
+            }
+        }
+    }
+
+    // large overlapping moves in both directions, and disjoint ones
+    for(const auto size : kLargeSizes) {
+        buf.resize(size * 2 + 2 * kGuard);
+        expected.resize(buf.size());
+        pattern.resize(buf.size());
+        Randomize(pattern.data(), pattern.size());
+
+        for(const size_t dist : {1, 8, 17, 64, 100}) {
+            test(size, kGuard, kGuard + dist);
+            test(size, kGuard + dist, kGuard);
+        }
+        test(size, kGuard, kGuard + size);
+        test(size, kGuard + size, kGuard);
+    }
+}
+
+/**
+ * Fills (and clears) blocks of all sizes and alignments with memset and memclr.
+ */
+static void TestMemset(const Routines &r, const size_t maxSize) {
+    const size_t bufLen = kGuard + kMaxAlign + maxSize + kGuard;
+    std::vector<uint8_t> buf(bufLen), expected(bufLen);
+
+    auto test = [&](const size_t size, const size_t align, const int value, const bool clear) {
+        Randomize(buf.data(), bufLen);
+        expected = buf;
+        for(size_t i = 0; i < size; i++) expected[kGuard + align + i] = static_cast<uint8_t>(value);
+
+        auto d = buf.data() + kGuard + align;
+        auto ret = clear ? r.memclr(d, size) : r.memset(d, value, size);
+        CHECK(ret == d, "%s %s: wrong return value", r.name, clear ? "memclr" : "memset");
+        CHECK(buf == expected, "%s %s: size %lu, align %lu, value %02x", r.name,
+                clear ? "memclr" : "memset", (unsigned long) size, (unsigned long) align,
+                value & 0xFF);
+    };
+
+    for(size_t size = 0; size <= maxSize; size++) {
+        for(size_t align = 0; align < kMaxAlign; align++) {
+            test(size, align, 0xA5, false);
+            test(size, align, 0, true);
+        }
+    }
+
+    for(const auto size : kLargeSizes) {
+        buf.resize(kGuard + kMaxAlign + size + kGuard);
+        expected.resize(buf.size());
+
+        for(const size_t align : {0, 3, 32}) {
+            // only the low byte of the value counts
+            test(size, align, 0x1FF, false);
+            test(size, align, 0, true);
+        }
+    }
+}
+
+/**
+ * Compares equal buffers, and buffers with a single differing byte at each position, for all
+ * sizes up to a few cache lines and some alignments; bytes are compared as unsigned values.
+ */
+static void TestMemcmp(const Routines &r, const size_t maxSize) {
+    std::vector<uint8_t> a(maxSize + 64), b(maxSize + 64);
+
+    for(size_t size = 0; size <= maxSize; size++) {
+        for(const size_t align : {0, 5, 16}) {
+            auto pa = a.data() + align, pb = b.data() + (align * 3) % 64;
+            Randomize(pa, size);
+            memcpy(pb, pa, size);
+
+            CHECK(!r.memcmp(pa, pb, size), "%s memcmp: equal, size %lu", r.name,
+                    (unsigned long) size);
+
+            for(size_t i = 0; i < size; i++) {
+                const auto old = pb[i];
+
+                pb[i] = pa[i] ^ 0x80;
+                const int expected = (pa[i] > pb[i]) ? 1 : -1;
+                const int got = r.memcmp(pa, pb, size);
+                CHECK((got > 0 ? 1 : -1) == expected && got, "%s memcmp: size %lu, difference "
+                        "at %lu: got %d, expected sign %d", r.name, (unsigned long) size,
+                        (unsigned long) i, got, expected);
+
+                // differences past the size are ignored
+                CHECK(!r.memcmp(pa, pb, i), "%s memcmp: size %lu, difference at end", r.name,
+                        (unsigned long) i);
+
+                pb[i] = old;
+            }
+        }
+    }
+}
+
+/**
+ * Searches for bytes with memchr in buffers of all sizes and alignments: the first occurrence must
+ * be found, and occurrences just outside the buffer must be ignored.
+ */
+static void TestMemchr(const Routines &r, const size_t maxSize) {
+    std::vector<uint8_t> buf(kGuard + kMaxAlign + maxSize + kGuard);
+    constexpr static const uint8_t kNeedle{0xE7};
+
+    for(size_t size = 0; size <= maxSize; size++) {
+        for(size_t align = 0; align < kMaxAlign; align++) {
+            // fill with the needle, then clear the buffer itself
+            memset(buf.data(), kNeedle, buf.size());
+            auto p = buf.data() + kGuard + align;
+            memset(p, 0, size);
+
+            CHECK(!r.memchr(p, kNeedle, size), "%s memchr: size %lu, align %lu: found needle "
+                    "outside buffer", r.name, (unsigned long) size, (unsigned long) align);
+
+            // place the needle at a few positions (the first one placed is found)
+            for(const size_t pos : {size - 1, size / 2, size_t{0}}) {
+                if(pos >= size) continue;
+                p[pos] = kNeedle;
+
+                const auto found = r.memchr(p, kNeedle | 0x100, size);
+                CHECK(found == p + pos, "%s memchr: size %lu, align %lu, needle at %lu: got "
+                        "%ld", r.name, (unsigned long) size, (unsigned long) align,
+                        (unsigned long) pos,
+                        found ? (long) (static_cast<const uint8_t *>(found) - p) : -1L);
+            }
+        }
+    }
+}
+
+/**
+ * Measures the length of strings of all lengths and alignments, with nonzero bytes after the
+ * terminator.
+ */
+static void TestStrlen(const Routines &r, const size_t maxSize) {
+    std::vector<char> buf(kMaxAlign + maxSize + kGuard);
+
+    for(size_t len = 0; len <= maxSize; len++) {
+        for(size_t align = 0; align < kMaxAlign; align++) {
+            memset(buf.data(), 'x', buf.size());
+            buf[align + len] = 0;
+
+            const auto got = r.strlen(buf.data() + align);
+            CHECK(got == len, "%s strlen: length %lu, align %lu: got %lu", r.name,
+                    (unsigned long) len, (unsigned long) align, (unsigned long) got);
+        }
+    }
+}
+
+/**
+ * Runs memchr and strlen on buffers that end right at the end of a page, with an inaccessible page
+ * after it, and that start right after an inaccessible page: reading past either end of the
+ * buffer's page would fault.
+ */
+static void TestPageBoundaries(const Routines &r) {
+    const size_t pageSz = sysconf(_SC_PAGESIZE);
+
+    auto region = static_cast<uint8_t *>(mmap(nullptr, pageSz * 3, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    CHECK(region != MAP_FAILED, "mmap failed");
+    CHECK(!mprotect(region, pageSz, PROT_NONE), "mprotect failed");
+    CHECK(!mprotect(region + pageSz * 2, pageSz, PROT_NONE), "mprotect failed");
+
+    auto page = region + pageSz;
+    auto pageEnd = page + pageSz;
+    memset(page, 'x', pageSz);
+
+    for(size_t len = 0; len <= 4 * 64 + 1; len++) {
+        // buffers (and strings) ending at the end of the page
+        auto start = pageEnd - len;
+        CHECK(!r.memchr(start, 0, len), "%s memchr at page end: length %lu", r.name,
+                (unsigned long) len);
+        if(len) {
+            pageEnd[-1] = 0;
+            CHECK(r.memchr(start, 0, len) == pageEnd - 1, "%s memchr at page end: length %lu",
+                    r.name, (unsigned long) len);
+            pageEnd[-1] = 'x';
+        }
+
+        if(r.strlen && len) {
+            pageEnd[-1] = 0;
+            CHECK(r.strlen(reinterpret_cast<const char *>(start)) == len - 1,
+                    "%s strlen at page end: length %lu", r.name, (unsigned long) len - 1);
+            pageEnd[-1] = 'x';
+        }
+
+        // buffers and strings starting at the start of the page
+        CHECK(!r.memchr(page, 0, len), "%s memchr at page start: length %lu", r.name,
+                (unsigned long) len);
+        if(r.strlen && len < pageSz) {
+            page[len] = 0;
+            CHECK(r.strlen(reinterpret_cast<const char *>(page)) == len,
+                    "%s strlen at page start: length %lu", r.name, (unsigned long) len);
+            page[len] = 'x';
+        }
+    }
+
+    munmap(region, pageSz * 3);
+}
+
+/// Runs all tests on a set of routines.
+static void TestAll(const Routines &r) {
+    TestMemcpy(r, kMaxExhaustiveSize, kMaxAlign);
+    TestMemcpyLarge(r);
+    TestMemmove(r, kMaxExhaustiveSize);
+    TestMemset(r, kMaxExhaustiveSize);
+    TestMemcmp(r, kMaxExhaustiveSize);
+    TestMemchr(r, kMaxExhaustiveSize);
+    if(r.strlen) TestStrlen(r, kMaxExhaustiveSize);
+    TestPageBoundaries(r);
+
+    printf("%s: passed\n", r.name);
+}
+
+/**
+ * Measures the throughput of memcpy, memset, memchr and strlen for a few sizes, compared to the
+ * host's C library.
+ */
+static void Benchmark(const Routines &r) {
+    constexpr static const size_t kSizes[]{16, 64, 256, 1024, 4096, 65536, 1024 * 1024};
+    constexpr static const size_t kBytesPerRun{256 * 1024 * 1024};
+
+    std::vector<uint8_t> src(kSizes[std::size(kSizes) - 1] + 64, 'x');
+    std::vector<uint8_t> dst(src.size());
+    src.back() = 0;
+
+    auto measure = [&](const char *what, const size_t size, auto fn) {
+        const size_t rounds = kBytesPerRun / size;
+        const auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < rounds; i++) {
+            fn();
+            __asm__ volatile("" ::: "memory");
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        printf("  %-8s %8lu bytes: %7.2f GB/s\n", what, (unsigned long) size,
+                double(rounds * size) / double(ns));
+    };
+
+    printf("%s:\n", r.name);
+    for(const auto size : kSizes) {
+        measure("memcpy", size, [&]{ r.memcpy(dst.data() + 1, src.data(), size); });
+    }
+    for(const auto size : kSizes) {
+        measure("memset", size, [&]{ r.memset(dst.data(), 0x55, size); });
+    }
+    for(const auto size : kSizes) {
+        measure("memchr", size, [&]{ r.memchr(src.data(), 0, size); });
+    }
+    if(r.strlen) {
+        for(const auto size : kSizes) {
+            auto str = reinterpret_cast<const char *>(src.data() + src.size() - 1 - size);
+            measure("strlen", size, [&]{ r.strlen(str); });
+        }
+    }
+}
+
+static const void *LibcMemchr(const void *p, int v, size_t n) {
+    return libc_memchr(p, v, n);
+}
+static void *KernMemset(void *p, int v, size_t n) {
+    return kern_memset(p, static_cast<uint8_t>(v), n);
+}
+static const void *KernMemchr(const void *p, int v, size_t n) {
+    return kern_memchr(p, static_cast<uint8_t>(v), n);
+}
+static const void *HostMemchr(const void *p, int v, size_t n) {
+    return memchr(p, v, n);
+}
+
+/**
+ * Tests the libc routines with each combination of processor features the host supports, then
+ * the kernel routines before and after selecting their implementation. If invoked with `-b`, they
+ * are also benchmarked against the host's C library.
+ */
+int main(int argc, char **argv) {
+    const bool bench = (argc > 1 && !strcmp(argv[1], "-b"));
+
+    const Routines libc{"libc", libc_memcpy, libc_memmove, libc_memset, libc_memclr,
+        libc_memcmp, LibcMemchr, libc_strlen};
+    const Routines kernel{"kernel", kern_memcpy, kern_memmove, KernMemset, kern_memclr,
+        kern_memcmp, KernMemchr, nullptr};
+
+    // libc: all combinations of the features the processor has
+    __libc_cpu_init();
+    const auto features = __libc_cpu;
+
+    for(const bool erms : {false, true}) {
+        for(const bool avx2 : {false, true}) {
+            if((erms && !features.erms) || (avx2 && !features.avx2)) continue;
+
+            __libc_cpu.erms = erms;
+            __libc_cpu.avx2 = avx2;
+            printf("libc with%s ERMS, with%s AVX2\n", erms ? "" : "out", avx2 ? "" : "out");
+
+            TestAll(libc);
+            if(bench) Benchmark(libc);
+        }
+    }
+
+    // kernel: the baseline implementation, then the one for this processor
+    printf("kernel without ERMS\n");
+    TestAll(kernel);
+    if(bench) Benchmark(kernel);
+
+    kern_string_init();
+    printf("kernel with processor features\n");
+    TestAll(kernel);
+    if(bench) Benchmark(kernel);
+
+    if(bench) {
+        const Routines host{"host libc", memcpy, memmove, memset, nullptr, memcmp, HostMemchr,
+            strlen};
+        Benchmark(host);
+    }
+
+    printf("all string tests passed\n");
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef TESTS_SHIM_LIBC_H
+#define TESTS_SHIM_LIBC_H
+
+/*
+ * Everything is linked into the test executable, so no visibility attributes are needed.
+ */
+#define LIBC_EXPORT
+#define LIBC_INTERNAL
+
+#endif
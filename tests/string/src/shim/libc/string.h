@@ -0,0 +1,18 @@
+#ifndef TESTS_SHIM_STRING_H
+#define TESTS_SHIM_STRING_H
+
+#include <stddef.h>
+
+/*
+ * Declarations of the libc string routines under test; the names are changed by the build so
+ * that they don't clash with the host's C library.
+ */
+void *memchr(const void *ptr, const int value, const size_t num);
+int memcmp(const void *ptr1, const void *ptr2, const size_t num);
+void *memcpy(void *destination, const void *source, const size_t num);
+void *memmove(void *dest, const void *src, const size_t n);
+void *memset(void *ptr, const int value, const size_t num);
+void *memclr(void *start, const size_t count);
+size_t strlen(const char *str);
+
+#endif
@@ -0,0 +1,78 @@
+#include <sys/syscalls.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * Notification state of a thread; this emulates the kernel's per-thread notification bits.
+ *
+ * These are never freed, since a notification may be sent to a thread just as it exits.
+ */
+struct ThreadState {
+    std::mutex lock;
+    std::condition_variable cv;
+    /// bits that were sent, but not yet received
+    uintptr_t bits{0};
+};
+
+static thread_local ThreadState *gState{nullptr};
+
+/// Returns the notification state of the calling thread, allocating it if needed.
+static ThreadState *GetState() {
+    if(!gState) {
+        gState = new ThreadState;
+    }
+    return gState;
+}
+
+int ThreadGetHandle(uintptr_t *outHandle) {
+    *outHandle = reinterpret_cast<uintptr_t>(GetState());
+    return 0;
+}
+
+int ThreadYield() {
+    std::this_thread::yield();
+    return 0;
+}
+
+int ThreadSetName(const uintptr_t, const char *) {
+    return 0;
+}
+
+/**
+ * Sets the given notification bits on the thread, waking it if it's waiting for any of them.
+ */
+int NotificationSend(const uintptr_t threadHandle, const uintptr_t bits) {
+    auto state = reinterpret_cast<ThreadState *>(threadHandle);
+    if(!state) return -1;
+
+    {
+        std::lock_guard<std::mutex> lg(state->lock);
+        state->bits |= bits;
+    }
+    state->cv.notify_all();
+    return 0;
+}
+
+/**
+ * Waits for any of the bits in the mask to be set, then clears and returns them. The timeout is
+ * in microseconds; UINTPTR_MAX waits forever.
+ */
+uintptr_t NotificationReceive(const uintptr_t mask, const uintptr_t timeout) {
+    auto state = GetState();
+    std::unique_lock<std::mutex> lk(state->lock);
+
+    auto pred = [&]{ return (state->bits & mask) != 0; };
+    if(timeout == UINTPTR_MAX) {
+        state->cv.wait(lk, pred);
+    } else {
+        state->cv.wait_for(lk, std::chrono::microseconds(timeout), pred);
+    }
+
+    const auto bits = state->bits & mask;
+    state->bits &= ~mask;
+    return bits;
+}
@@ -0,0 +1,260 @@
+#include "ThreadPool.h"
+#include "WorkDeque.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace libdriver;
+
+/// Fails the test (and exits) if the condition is false
+#define CHECK(cond) do { if(!(cond)) { \
+    fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    exit(1); \
+} } while(0)
+
+/**
+ * Pushes and pops items from a single thread: pops must return items in LIFO order, steals in
+ * FIFO order, and the deque must grow past its initial capacity.
+ */
+static void TestDequeSingleThreaded() {
+    constexpr static const size_t kItems{1000};
+    std::vector<int> items(kItems);
+    WorkDeque<int> deque;
+
+    CHECK(deque.empty());
+    CHECK(!deque.pop());
+    CHECK(!deque.steal());
+
+    for(size_t i = 0; i < kItems; i++) {
+        deque.push(&items[i]);
+    }
+    CHECK(!deque.empty());
+
+    // oldest from the top, newest from the bottom
+    CHECK(deque.steal() == &items[0]);
+    CHECK(deque.steal() == &items[1]);
+
+    for(size_t i = kItems; i-- > 2;) {
+        CHECK(deque.pop() == &items[i]);
+    }
+    CHECK(!deque.pop());
+    CHECK(!deque.steal());
+    CHECK(deque.empty());
+}
+
+/**
+ * Has the owner push items (popping some of them itself) while several thieves steal at the same
+ * time. Every item must be taken exactly once.
+ */
+static void TestDequeConcurrent() {
+    constexpr static const size_t kItems{200000};
+    constexpr static const size_t kThieves{4};
+
+    std::vector<int> items(kItems);
+    std::vector<std::atomic_int> taken(kItems);
+    std::atomic_bool done{false};
+    WorkDeque<int> deque;
+
+    auto take = [&](int *item) {
+        taken[item - items.data()]++;
+    };
+
+    std::vector<std::thread> thieves;
+    for(size_t i = 0; i < kThieves; i++) {
+        thieves.emplace_back([&]{
+            while(!done || !deque.empty()) {
+                if(auto item = deque.steal()) {
+                    take(item);
+                }
+            }
+        });
+    }
+
+    for(size_t i = 0; i < kItems; i++) {
+        deque.push(&items[i]);
+
+        // occasionally race the thieves for the newest items
+        if(!(i % 7)) {
+            if(auto item = deque.pop()) {
+                take(item);
+            }
+        }
+    }
+    while(auto item = deque.pop()) {
+        take(item);
+    }
+
+    done = true;
+    for(auto &t : thieves) {
+        t.join();
+    }
+
+    for(size_t i = 0; i < kItems; i++) {
+        CHECK(taken[i] == 1);
+    }
+}
+
+/**
+ * Submits tasks from outside the pool, with and without affinity hints, then waits for all of
+ * them.
+ */
+static void TestSubmitWait() {
+    constexpr static const size_t kTasks{10000};
+
+    std::shared_ptr<ThreadPool> pool;
+    CHECK(!ThreadPool::Alloc(4, "Test", pool));
+    CHECK(pool->getNumWorkers() == 4);
+    CHECK(pool->getCurrentWorker() == ThreadPool::kAnyWorker);
+
+    std::atomic_size_t count{0};
+    std::atomic_size_t misplaced{0};
+
+    for(size_t i = 0; i < kTasks; i++) {
+        if(i & 1) {
+            pool->submit([&]{ count++; });
+        } else {
+            pool->submit([&]{
+                if(pool->getCurrentWorker() == ThreadPool::kAnyWorker) misplaced++;
+                count++;
+            }, i);
+        }
+    }
+
+    pool->wait();
+    CHECK(count == kTasks);
+    CHECK(!misplaced);
+
+    // groups waited on from outside the pool
+    ThreadPool::TaskGroup group;
+    for(size_t i = 0; i < kTasks; i++) {
+        pool->submit(group, [&]{ count++; });
+    }
+    pool->wait(group);
+    CHECK(group.isDone());
+    CHECK(count == kTasks * 2);
+}
+
+/**
+ * Sums a range of numbers by recursively splitting it in half, with each half executed as a task
+ * of a group that the parent task waits on.
+ */
+static uint64_t ParallelSum(ThreadPool *pool, const uint64_t start, const uint64_t end) {
+    if(end - start <= 64) {
+        uint64_t sum{0};
+        for(auto i = start; i < end; i++) sum += i;
+        return sum;
+    }
+
+    const auto mid = start + (end - start) / 2;
+    uint64_t left{0}, right{0};
+
+    ThreadPool::TaskGroup group;
+    pool->submit(group, [&]{ left = ParallelSum(pool, start, mid); });
+    right = ParallelSum(pool, mid, end);
+    pool->wait(group);
+
+    return left + right;
+}
+
+/**
+ * Runs nested fork/join computations in the pool, while other threads submit and wait on their
+ * own groups at the same time. With only two workers, each of them is waiting in several tasks at
+ * once; none of the waits may depend on unrelated tasks completing.
+ */
+static void TestNestedWait() {
+    constexpr static const uint64_t kRange{200000};
+    constexpr static const size_t kWaiters{4};
+    constexpr static const size_t kRounds{20};
+
+    std::shared_ptr<ThreadPool> pool;
+    CHECK(!ThreadPool::Alloc(2, "Nested", pool));
+
+    // long running unrelated work, which must not hold up any of the waits
+    std::atomic_bool stop{false};
+    ThreadPool::TaskGroup background;
+    pool->submit(background, [&]{
+        while(!stop) std::this_thread::yield();
+    });
+
+    std::vector<std::thread> waiters;
+    std::atomic_size_t failures{0};
+
+    for(size_t i = 0; i < kWaiters; i++) {
+        waiters.emplace_back([&]{
+            for(size_t round = 0; round < kRounds; round++) {
+                uint64_t result{0};
+
+                ThreadPool::TaskGroup group;
+                pool->submit(group, [&]{ result = ParallelSum(pool.get(), 0, kRange); });
+                pool->wait(group);
+
+                if(result != (kRange * (kRange - 1)) / 2) failures++;
+            }
+        });
+    }
+
+    for(auto &t : waiters) {
+        t.join();
+    }
+    CHECK(!failures);
+
+    stop = true;
+    pool->wait(background);
+    pool->wait();
+}
+
+/**
+ * Measures the time to submit and complete a large number of tiny tasks, both from outside the
+ * pool and split up from inside it.
+ */
+static void BenchSubmit() {
+    constexpr static const size_t kTasks{200000};
+
+    std::shared_ptr<ThreadPool> pool;
+    CHECK(!ThreadPool::Alloc(4, "Bench", pool));
+    std::atomic_size_t count{0};
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < kTasks; i++) {
+        pool->submit([&]{ count++; });
+    }
+    pool->wait();
+    auto external = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    ThreadPool::TaskGroup group;
+    pool->submit(group, [&]{
+        ThreadPool::TaskGroup inner;
+        for(size_t i = 0; i < kTasks; i++) {
+            pool->submit(inner, [&]{ count++; });
+        }
+        pool->wait(inner);
+    });
+    pool->wait(group);
+    auto internal = std::chrono::steady_clock::now() - start;
+
+    CHECK(count == kTasks * 2);
+
+    using ns = std::chrono::nanoseconds;
+    printf("submit+wait: %.1f ns/task external, %.1f ns/task from a worker\n",
+            double(std::chrono::duration_cast<ns>(external).count()) / kTasks,
+            double(std::chrono::duration_cast<ns>(internal).count()) / kTasks);
+}
+
+int main(int, char **) {
+    TestDequeSingleThreaded();
+    TestDequeConcurrent();
+    TestSubmitWait();
+    TestNestedWait();
+    BenchSubmit();
+
+    printf("all thread pool tests passed\n");
+    return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef TESTS_SHIM_SYS_SYSCALLS_H
+#define TESTS_SHIM_SYS_SYSCALLS_H
+
+#include <stdint.h>
+
+/*
+ * Host implementations of the thread and notification syscalls used by the thread pool; see
+ * Syscalls.cpp.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int ThreadGetHandle(uintptr_t *outHandle);
+int ThreadYield();
+int ThreadSetName(const uintptr_t handle, const char *name);
+
+int NotificationSend(const uintptr_t threadHandle, const uintptr_t bits);
+uintptr_t NotificationReceive(const uintptr_t mask, const uintptr_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
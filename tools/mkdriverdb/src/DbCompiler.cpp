@@ -0,0 +1,236 @@
+#include "DbCompiler.h"
+#include "DriverDbTypes.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Parses the TOML driver database at the given path, and adds all drivers in it to the compiled
+ * database.
+ */
+void DbCompiler::addFile(const std::string &path) {
+    toml::table tbl;
+
+    try {
+        tbl = toml::parse_file(path);
+    } catch(const toml::parse_error &err) {
+        throw std::runtime_error("failed to parse " + path + ": " +
+                std::string(err.description()));
+    }
+
+    auto driversArray = tbl["drivers"].as_array();
+    if(!driversArray) {
+        throw std::runtime_error(path + " is invalid: missing or invalid `drivers` key");
+    }
+
+    for(const auto &elem : *driversArray) {
+        auto table = elem.as_table();
+        if(!table) {
+            throw std::runtime_error(path + " is invalid: invalid driver object type");
+        }
+
+        this->processEntry(*table);
+    }
+}
+
+/**
+ * Creates the driver record for a single driver entry, and all of its match descriptors.
+ */
+void DbCompiler::processEntry(const toml::table &n) {
+    auto path = n["path"].value<std::string>();
+    if(!path) {
+        throw std::runtime_error("driver is missing path");
+    }
+
+    DriverDbDriver driver;
+    memset(&driver, 0, sizeof(driver));
+
+    driver.pathOff = this->addString(*path);
+    driver.pathLen = path->length();
+    driver.firstMatch = this->matches.size();
+
+    if(n["matchAll"].value<bool>().value_or(false)) {
+        driver.flags |= kDriverDbDriverFlagsMatchAll;
+    }
+
+    auto matchArray = n["match"].as_array();
+    if(!matchArray) {
+        throw std::runtime_error("driver " + *path + " has invalid or missing matches array");
+    }
+
+    for(const auto &elem : *matchArray) {
+        auto match = elem.as_table();
+        if(!match) {
+            throw std::runtime_error("driver " + *path + " has invalid match object");
+        }
+
+        this->processMatch(*match, *path);
+    }
+
+    driver.numMatches = this->matches.size() - driver.firstMatch;
+    this->drivers.push_back(driver);
+}
+
+/**
+ * Converts a match table to a match descriptor.
+ */
+void DbCompiler::processMatch(const toml::table &n, const std::string &path) {
+    DriverDbMatch match;
+    memset(&match, 0, sizeof(match));
+
+    match.priority = n["priority"].value<int>().value_or(0);
+
+    if(n.contains("name")) {
+        auto name = n["name"].value<std::string>();
+        if(!name) {
+            throw std::runtime_error("driver " + path + " has invalid name match");
+        }
+
+        match.type = kDriverDbMatchTypeName;
+        match.nameOff = this->addString(*name);
+        match.nameLen = name->length();
+    }
+    else if(n.contains("pci")) {
+        auto tbl = n["pci"].as_table();
+        if(!tbl) {
+            throw std::runtime_error("driver " + path + " has invalid pci match");
+        }
+
+        match.type = kDriverDbMatchTypePci;
+        this->processPciMatch(*tbl, match);
+    }
+    else {
+        throw std::runtime_error("driver " + path + " has match of unknown type");
+    }
+
+    this->matches.push_back(match);
+}
+
+/**
+ * Fills in the PCI specific fields of a match descriptor. The keys are the same as those that
+ * driverman's text database parser accepts.
+ */
+void DbCompiler::processPciMatch(const toml::table &n, DriverDbMatch &match) {
+    match.priority = n["priority"].value<int>().value_or(0);
+
+    if(n["conjunction"].value<bool>().value_or(false)) {
+        match.flags |= kDriverDbMatchFlagsConjunction;
+    }
+    if(auto classId = n["class"].value<uint8_t>()) {
+        match.flags |= kDriverDbMatchFlagsClass;
+        match.classId = *classId;
+    }
+    if(auto subclassId = n["subclass"].value<uint8_t>()) {
+        match.flags |= kDriverDbMatchFlagsSubclass;
+        match.subclassId = *subclassId;
+    }
+
+    match.firstVidPid = this->vidPids.size();
+
+    if(n.contains("device")) {
+        auto devices = n["device"].as_array();
+        if(!devices) {
+            throw std::runtime_error("invalid pci device array");
+        }
+
+        for(const auto &elem : *devices) {
+            auto tbl = elem.as_table();
+            if(!tbl) {
+                throw std::runtime_error("invalid pci device entry");
+            }
+            const auto &info = *tbl;
+
+            DriverDbVidPid vp;
+            memset(&vp, 0, sizeof(vp));
+
+            vp.vid = info["vid"].value<uint16_t>().value_or(0xFFFF);
+            if(auto pid = info["pid"].value<uint16_t>()) {
+                vp.flags |= kDriverDbVidPidFlagsPid;
+                vp.pid = *pid;
+            }
+            if(auto priority = info["priority"].value<int>()) {
+                vp.flags |= kDriverDbVidPidFlagsPriority;
+                vp.priority = *priority;
+            }
+
+            this->vidPids.push_back(vp);
+        }
+    }
+
+    match.numVidPid = this->vidPids.size() - match.firstVidPid;
+}
+
+/**
+ * Inserts a string into the string table, if it's not already there.
+ *
+ * @return Offset of the string in the string table
+ */
+uint32_t DbCompiler::addString(const std::string &str) {
+    auto it = this->stringOffsets.find(str);
+    if(it != this->stringOffsets.end()) {
+        return it->second;
+    }
+
+    const uint32_t off = this->strings.size();
+    this->strings.insert(this->strings.end(), str.begin(), str.end());
+    this->stringOffsets.emplace(str, off);
+
+    return off;
+}
+
+/**
+ * Lays out all of the tables and writes the database to the given path.
+ *
+ * @return Number of bytes written
+ */
+size_t DbCompiler::write(const std::string &path) {
+    std::fstream file(path, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    if(file.fail()) {
+        throw std::runtime_error("failed to open output file");
+    }
+
+    auto align = [](size_t off) -> uint32_t {
+        return ((off + 15) / 16) * 16;
+    };
+
+    // build the header and place each table
+    DriverDbHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+
+    hdr.magic = kDriverDbMagic;
+    hdr.type = kDriverDbType;
+    hdr.major = 1; hdr.minor = 0;
+
+    hdr.driversOff = align(sizeof(DriverDbHeader));
+    hdr.numDrivers = this->drivers.size();
+    hdr.matchesOff = align(hdr.driversOff + (hdr.numDrivers * sizeof(DriverDbDriver)));
+    hdr.numMatches = this->matches.size();
+    hdr.vidPidsOff = align(hdr.matchesOff + (hdr.numMatches * sizeof(DriverDbMatch)));
+    hdr.numVidPids = this->vidPids.size();
+    hdr.stringsOff = align(hdr.vidPidsOff + (hdr.numVidPids * sizeof(DriverDbVidPid)));
+    hdr.stringsLen = this->strings.size();
+    hdr.totalLen = align(hdr.stringsOff + hdr.stringsLen);
+
+    // write it all out
+    file.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+    file.seekp(hdr.driversOff);
+    file.write(reinterpret_cast<const char *>(this->drivers.data()),
+            this->drivers.size() * sizeof(DriverDbDriver));
+    file.seekp(hdr.matchesOff);
+    file.write(reinterpret_cast<const char *>(this->matches.data()),
+            this->matches.size() * sizeof(DriverDbMatch));
+    file.seekp(hdr.vidPidsOff);
+    file.write(reinterpret_cast<const char *>(this->vidPids.data()),
+            this->vidPids.size() * sizeof(DriverDbVidPid));
+    file.seekp(hdr.stringsOff);
+    file.write(this->strings.data(), this->strings.size());
+
+    // pad out to the total length
+    file.seekp(hdr.totalLen - 1);
+    file.put(0);
+
+    return file.tellp();
+}
@@ -0,0 +1,49 @@
+#ifndef _MKDRIVERDB_DBCOMPILER_H
+#define _MKDRIVERDB_DBCOMPILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <toml++/toml.h>
+
+#include "DriverDbTypes.h"
+
+/**
+ * Reads one or more TOML driver databases, in the format understood by driverman, and produces
+ * the compiled binary form of the combined database.
+ */
+class DbCompiler {
+    public:
+        void addFile(const std::string &path);
+        size_t write(const std::string &path);
+
+        /// Returns the total number of drivers
+        size_t getNumDrivers() const {
+            return this->drivers.size();
+        }
+
+    private:
+        void processEntry(const toml::table &);
+        void processMatch(const toml::table &, const std::string &);
+        void processPciMatch(const toml::table &, DriverDbMatch &);
+
+        uint32_t addString(const std::string &);
+
+    private:
+        /// all drivers
+        std::vector<DriverDbDriver> drivers;
+        /// match descriptors for all drivers
+        std::vector<DriverDbMatch> matches;
+        /// vid/pid pairs for all PCI matches
+        std::vector<DriverDbVidPid> vidPids;
+
+        /// string table
+        std::vector<char> strings;
+        /// offsets of strings already in the string table
+        std::unordered_map<std::string, uint32_t> stringOffsets;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef _MKDRIVERDB_DRIVERDBTYPES_H
+#define _MKDRIVERDB_DRIVERDBTYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Describes a single driver in the compiled driver database. Its match descriptors are stored
+ * contiguously in the match table.
+ */
+struct DriverDbDriver {
+    /// flags: see kDriverDbDriverFlags*
+    uint32_t flags;
+
+    /// offset of the driver's path into the string table
+    uint32_t pathOff;
+    /// length of the path, in bytes (not NUL terminated)
+    uint32_t pathLen;
+
+    /// index of the first match descriptor in the match table
+    uint32_t firstMatch;
+    /// number of match descriptors
+    uint32_t numMatches;
+} __attribute__((packed));
+
+/// All match descriptors of the driver must match
+constexpr static const uint32_t kDriverDbDriverFlagsMatchAll = (1 << 0);
+
+/**
+ * A single match descriptor. Depending on its type, either the name fields or the PCI fields are
+ * valid; the others are zero.
+ */
+struct DriverDbMatch {
+    /// type of match: see kDriverDbMatchType*
+    uint8_t type;
+    /// flags: see kDriverDbMatchFlags*
+    uint8_t flags;
+    /// PCI class and subclass ids (if the corresponding flags are set)
+    uint8_t classId, subclassId;
+
+    /// priority of the match
+    int32_t priority;
+
+    /// for name matches, offset into the string table of the name, and its length
+    uint32_t nameOff, nameLen;
+
+    /// for PCI matches, index of the first vid/pid entry, and the number of them
+    uint32_t firstVidPid, numVidPid;
+} __attribute__((packed));
+
+/// Match on a device's driver name
+constexpr static const uint8_t kDriverDbMatchTypeName = 0x01;
+/// Match on a PCI device
+constexpr static const uint8_t kDriverDbMatchTypePci = 0x02;
+
+/// PCI match is a conjunction
+constexpr static const uint8_t kDriverDbMatchFlagsConjunction = (1 << 0);
+/// The class id field is valid
+constexpr static const uint8_t kDriverDbMatchFlagsClass = (1 << 1);
+/// The subclass id field is valid
+constexpr static const uint8_t kDriverDbMatchFlagsSubclass = (1 << 2);
+
+/**
+ * A PCI vendor/product id pair as used by PCI matches.
+ */
+struct DriverDbVidPid {
+    /// flags: see kDriverDbVidPidFlags*
+    uint16_t flags;
+    /// vendor id (always valid) and product id
+    uint16_t vid, pid;
+    /// priority override, if set
+    int32_t priority;
+} __attribute__((packed));
+
+/// The product id field is valid
+constexpr static const uint16_t kDriverDbVidPidFlagsPid = (1 << 0);
+/// The priority override field is valid
+constexpr static const uint16_t kDriverDbVidPidFlagsPriority = (1 << 1);
+
+/**
+ * Header of a compiled driver database. All offsets are relative to the start of the header, and
+ * every table is aligned to 16 bytes, so the file can be used in place once read into memory.
+ */
+struct DriverDbHeader {
+    /// magic value: must be 'KUSH'
+    uint32_t magic;
+    /// major and minor version: must be 1,0 respectively
+    uint16_t major, minor;
+    /// file type: must be 'DRDB'
+    uint32_t type;
+
+    /// total length of the database, in bytes
+    uint32_t totalLen;
+
+    /// driver table
+    uint32_t driversOff, numDrivers;
+    /// match descriptor table
+    uint32_t matchesOff, numMatches;
+    /// vendor/product id table
+    uint32_t vidPidsOff, numVidPids;
+    /// string table
+    uint32_t stringsOff, stringsLen;
+} __attribute__((packed));
+
+constexpr static const uint32_t kDriverDbMagic = 'HSUK';
+constexpr static const uint32_t kDriverDbType = 'BDRD';
+
+#endif
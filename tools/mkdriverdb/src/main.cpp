@@ -0,0 +1,78 @@
+#include "DbCompiler.h"
+
+#include <unistd.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Input state
+ */
+std::vector<std::string> gInPaths;
+std::string gOutPath;
+
+/**
+ * Parse the command line. The tool should be invoked as "mkdriverdb -i <db> [-i <db>...] -o
+ * <output path>" where each input is a TOML driver database.
+ *
+ * @return true if the program execution should continue, false otherwise.
+ */
+static bool ParseCommandline(int argc, char *const *argv) {
+    int option;
+    while((option = getopt(argc, argv, ":i:o:")) != -1) {
+        switch(option) {
+            // input database
+            case 'i':
+                gInPaths.emplace_back(optarg);
+                break;
+            // output binary file
+            case 'o':
+                gOutPath = std::string(optarg);
+                break;
+
+            // unknown option
+            case '?':
+                std::cerr << "unknown option " << (char) optopt << std::endl;
+                return false;
+        }
+    }
+
+    // ensure the input and output paths were specified
+    if(gInPaths.empty() || gOutPath.empty()) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Entry point for the driver database compiler.
+ *
+ * All input databases are combined, in the order specified, into a single binary database that
+ * driverman can load without having to parse any text at boot.
+ */
+int main(int argc, char * const *argv) {
+    if(!ParseCommandline(argc, argv)) {
+        std::cerr << "usage: " << argv[0] << " -i db.toml [-i db2.toml...] -o outfile" << std::endl;
+        return -1;
+    }
+
+    DbCompiler compiler;
+
+    try {
+        for(const auto &path : gInPaths) {
+            compiler.addFile(path);
+        }
+
+        const auto written = compiler.write(gOutPath);
+        std::cout << "Wrote " << written << " bytes (" << compiler.getNumDrivers()
+            << " drivers in database)" << std::endl;
+    } catch(const std::exception &e) {
+        std::cerr << "failed to compile driver database: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
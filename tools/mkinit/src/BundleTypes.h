@@ -5,9 +5,14 @@
 #include <stdint.h>
 
 /**
- * Header describing a single file in the init bundke.
+ * Directory entry describing a single file in the init bundle.
+ *
+ * Entries are grouped by hash bucket (the low bits of the name hash) and sorted by name within
+ * each bucket.
  */
 struct InitFileHeader {
+    /// hash of the file name (see InitBundleHashName)
+    uint32_t hash;
     /// flags: 0x80000000 = compressed
     uint32_t flags;
 
@@ -18,38 +23,89 @@ struct InitFileHeader {
     /// total size of the file, in bytes (maybe different from `dataLen` if compressed)
     uint32_t rawLen;
 
-    /// length of the filename field
-    uint8_t nameLen;
-    /// name bytes
-    char name[];
+    /// offset of the name into the name table
+    uint32_t nameOff;
+    /// length of the name, in bytes (it is not NUL terminated)
+    uint32_t nameLen;
 } __attribute__((packed));
 
 /// File header flag indicating its contents are compressed using lzfse
 constexpr static const uint32_t kInitFileFlagsCompressed = 0x80000000;
 
+/**
+ * Data of compressed files starts with a table of chunks. Each chunk holds `chunkSize` bytes of the
+ * file (the last may be shorter) and is compressed independently; a chunk whose length is equal
+ * to the number of bytes it holds is stored as-is.
+ */
+struct InitChunkHeader {
+    /// offset of the chunk's data, relative to the start of the file's data
+    uint32_t offset;
+    /// number of bytes of chunk data
+    uint32_t length;
+} __attribute__((packed));
+
 /**
  * Header of an init bundle
+ *
+ * The header is followed by the bucket table, the directory and the name table; the data of all
+ * files comes after that. Data of uncompressed files is aligned to `dataAlign` (a page) so it may
+ * be mapped in place.
  */
 struct InitHeader {
     /// magic value: must be 'KUSH'
     uint32_t magic;
-    /// major and minor version: must be 1,0 respectively
+    /// major and minor version: must be 2,1 respectively
     uint16_t major, minor;
     /// bundle type: must be 'INIT'
     uint32_t type;
 
-    /// total length of header
+    /// total length of header, bucket table, directory and name table
     uint32_t headerLen;
     /// total length of bundle, including payload and padding
     uint32_t totalLen;
 
     /// number of file entries
     uint32_t numFiles;
-    /// file headers
-    struct InitFileHeader headers[];
+    /// number of hash buckets; always a power of two
+    uint32_t numBuckets;
+
+    /// offset to the bucket table: `numBuckets + 1` directory indices
+    uint32_t bucketsOff;
+    /// offset to the directory: `numFiles` file headers
+    uint32_t filesOff;
+    /// offset to the name table
+    uint32_t namesOff;
+    /// length of the name table, in bytes
+    uint32_t namesLen;
+
+    /// alignment of uncompressed file data
+    uint32_t dataAlign;
+    /// number of bytes of file data in each chunk of compressed files
+    uint32_t chunkSize;
 } __attribute__((packed));
 
 constexpr static const uint32_t kInitMagic = 'HSUK';
 constexpr static const uint32_t kInitType = 'TINI';
 
+constexpr static const uint16_t kInitVersionMajor = 2;
+constexpr static const uint16_t kInitVersionMinor = 1;
+
+/// Alignment of uncompressed file data
+constexpr static const uint32_t kInitDataAlign = 0x1000;
+/// Size of chunks of compressed files
+constexpr static const uint32_t kInitChunkSize = 0x10000;
+
+/**
+ * Hashes a file name (32-bit FNV-1a) for lookup in the bundle directory. Names are stored without
+ * a leading slash.
+ */
+static inline uint32_t InitBundleHashName(const char *name, const size_t nameLen) {
+    uint32_t hash = 0x811c9dc5;
+    for(size_t i = 0; i < nameLen; i++) {
+        hash ^= static_cast<uint8_t>(name[i]);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
 #endif
@@ -12,52 +12,140 @@
 #include <lzfse.h>
 
 /**
- * Adds a new file to the init bundle.
+ * Compresses a file's data as independently compressed chunks, preceded by the chunk table.
+ * Chunks that do not get smaller are stored as-is.
+ */
+static std::vector<uint8_t> CompressChunks(const std::vector<uint8_t> &in) {
+    const size_t numChunks = (in.size() + kInitChunkSize - 1) / kInitChunkSize;
+
+    std::vector<InitChunkHeader> table(numChunks);
+    std::vector<uint8_t> out(sizeof(InitChunkHeader) * numChunks);
+    std::vector<uint8_t> buf(kInitChunkSize);
+
+    for(size_t i = 0; i < numChunks; i++) {
+        const auto off = i * kInitChunkSize;
+        const size_t len = std::min<size_t>(kInitChunkSize, in.size() - off);
+        const auto chunk = in.data() + off;
+
+        // the output must be smaller than the input to count as compressed
+        const auto written = lzfse_encode_buffer(buf.data(), len - 1, chunk, len, nullptr);
+
+        table[i].offset = out.size();
+        if(written) {
+            table[i].length = written;
+            out.insert(out.end(), buf.begin(), buf.begin() + written);
+        } else {
+            table[i].length = len;
+            out.insert(out.end(), chunk, chunk + len);
+        }
+    }
+
+    memcpy(out.data(), table.data(), sizeof(InitChunkHeader) * numChunks);
+    return out;
+}
+
+/**
+ * Adds a new file to the init bundle. Its name in the bundle is the path, without the leading
+ * slash.
  *
  * We'll load the file and compress it at this point.
  */
 void InitBundle::addFile(const std::string &_path) {
-    size_t err;
-
     // open for reading
     const auto path = std::filesystem::path(_path);
     const auto realpath = (this->sysroot.empty() ? path :
             (std::filesystem::path(this->sysroot + _path)));
 
+    auto name = _path;
+    while(!name.empty() && name[0] == '/') {
+        name.erase(0, 1);
+    }
+
+    this->addFile(name, realpath.string(), false);
+}
+
+/**
+ * Adds all regular files in the given directory (and its subdirectories) to the bundle. They're
+ * named by their path relative to that directory.
+ */
+void InitBundle::addDirectory(const std::string &dirPath) {
+    const auto root = std::filesystem::path(dirPath);
+
+    for(const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+        if(!entry.is_regular_file()) continue;
+
+        const auto name = std::filesystem::relative(entry.path(), root).generic_string();
+
+        // don't add the kernel twice
+        if(std::find_if(this->files.begin(), this->files.end(), [&](const auto &f) {
+            return f.name == name;
+        }) != this->files.end()) {
+            continue;
+        }
+
+        this->addFile(name, entry.path().string(), false);
+    }
+}
+
+/**
+ * Sets the kernel to place in the bundle. It's stored uncompressed, before all other files, so
+ * that the boot loader finds it when it scans the bundle for the first executable.
+ */
+void InitBundle::setKernel(const std::string &path) {
+    const auto name = std::filesystem::path(path).filename().string();
+    this->storeUncompressed(name);
+    this->addFile(name, path, true);
+}
+
+/**
+ * Reads a file, and compresses it if it's worthwhile.
+ *
+ * @param name Path of the file inside the bundle
+ * @param realpath Path to the file on the host
+ * @param first Whether the file's data is placed before all other files
+ */
+void InitBundle::addFile(const std::string &name, const std::string &realpath, const bool first) {
     std::ifstream file(realpath, std::istream::binary);
     if(file.fail()) {
-        throw std::runtime_error("failed to open input file: " + realpath.string());
+        throw std::runtime_error("failed to open input file: " + realpath);
     }
 
     // prepare the file struct
-    File hdr(_path, realpath.string());
+    File hdr(name, realpath);
     hdr.rawBytes = std::filesystem::file_size(realpath);
+    hdr.first = first;
 
-    // ignore zero byte files
     if(!hdr.rawBytes) {
-        std::cerr << "ignoring zero-byte file at " << realpath.string() << std::endl;
+        std::cerr << "adding zero-byte file at " << realpath << std::endl;
     }
 
     // read the file
-    hdr.data.resize(hdr.rawBytes);
     std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-    // compress it
-    err = lzfse_encode_buffer(hdr.data.data(), hdr.data.size(), contents.data(), contents.size(), 
-            nullptr);
-    if(!err) {
-        throw std::runtime_error("lzfse_encode_buffer failed");
+    // compress it; keep the compressed data only if it saves at least 1/8 of the size
+    if(hdr.rawBytes && !this->uncompressed.contains(name)) {
+        auto compressed = CompressChunks(contents);
+
+        if(compressed.size() <= (hdr.rawBytes - (hdr.rawBytes / 8))) {
+            hdr.data = std::move(compressed);
+            hdr.compressed = true;
+        }
     }
 
-    hdr.data.resize(err);
+    if(!hdr.compressed) {
+        hdr.data = std::move(contents);
+    }
 
     // store the file data
     this->files.push_back(std::move(hdr));
 }
 
 /**
- * Builds up the bundle's header, as well as the individual file headers. Then, append the data for
- * each file to the init bundle.
+ * Builds up the bundle's header, the hashed directory and the name table. Then, append the data
+ * for each file to the init bundle.
+ *
+ * The kernel (if any) is placed first, followed by all compressed files (16 byte aligned) and
+ * then all uncompressed files (page aligned.)
  */
 size_t InitBundle::write(const std::string &path) {
     // open up write stream
@@ -66,93 +154,123 @@ size_t InitBundle::write(const std::string &path) {
         throw std::runtime_error("failed to open output file");
     }
 
-    // build the header
-    InitHeader hdr;
-    memset(&hdr, 0, sizeof(InitHeader));
+    // get the number of buckets, and sort files into them
+    uint32_t numBuckets = 1;
+    while(numBuckets < this->files.size()) {
+        numBuckets <<= 1;
+    }
 
-    hdr.magic = kInitMagic;
-    hdr.type = kInitType;
-    hdr.major = 1; hdr.minor = 0;
-    hdr.numFiles = this->files.size();
+    auto bucketOf = [numBuckets](const File &f) -> uint32_t {
+        return InitBundleHashName(f.name.data(), f.name.length()) & (numBuckets - 1);
+    };
 
-    // ensure file headers are sorted
-    std::sort(this->files.begin(), this->files.end(), [](const auto &f1, const auto &f2) {
+    std::sort(this->files.begin(), this->files.end(), [&](const auto &f1, const auto &f2) {
+        const auto b1 = bucketOf(f1), b2 = bucketOf(f2);
+        if(b1 != b2) return b1 < b2;
         return f1.name < f2.name;
     });
 
-    // build headers for all files. this will also place them
-    void *fileHdrs = nullptr;
-    size_t fileHdrOff = 0;
-    size_t fileDataOff = 0;
-
-    for(const auto &file : this->files) {
-        // calculate space required for this header and allocate it
-        const auto required = sizeof(InitFileHeader) + file.name.length();
-        fileHdrs = realloc(fileHdrs, fileHdrOff + required);
-        if(!fileHdrs) {
-            throw std::runtime_error("failed to realloc file headers");
-        }
+    // build the bucket table and name table
+    std::vector<uint32_t> buckets(numBuckets + 1, 0);
+    std::string names;
 
-        // populate the file header
-        auto hdr = reinterpret_cast<InitFileHeader *>(((uintptr_t) fileHdrs) + fileHdrOff);
-        memset(hdr, 0, required);
-
-        hdr->flags = kInitFileFlagsCompressed;
-        hdr->dataLen = file.data.size();
-        hdr->rawLen = file.rawBytes;
-        hdr->dataOff = fileDataOff;
-        hdr->nameLen = file.name.length();
-        strncpy(hdr->name, file.name.c_str(), hdr->nameLen);
-
-        // prepare for next
-        fileDataOff += hdr->dataLen;
-        if(fileDataOff % 16) {
-            fileDataOff = ((fileDataOff + 15) / 16) * 16;
+    for(size_t i = 0, bucket = 0; i <= this->files.size(); i++) {
+        const auto b = (i == this->files.size()) ? numBuckets : bucketOf(this->files[i]);
+        while(bucket <= b) {
+            buckets[bucket++] = i;
         }
+    }
 
-        fileHdrOff += required;
+    for(const auto &f : this->files) {
+        names += f.name;
     }
 
-    // adjust file headers offset values
-    const auto hdrBytes = sizeof(InitHeader) + fileHdrOff;
-    const auto fileDataStart = ((hdrBytes + 15) / 16) * 16;
-    size_t totalSize = 0;
+    // lay out the header
+    InitHeader hdr;
+    memset(&hdr, 0, sizeof(InitHeader));
 
-    InitFileHeader *fileHdr = reinterpret_cast<InitFileHeader *>(fileHdrs);
-    for(size_t i = 0; i < this->files.size(); i++) {
-        fileHdr->dataOff += fileDataStart;
+    hdr.magic = kInitMagic;
+    hdr.type = kInitType;
+    hdr.major = kInitVersionMajor; hdr.minor = kInitVersionMinor;
+    hdr.numFiles = this->files.size();
+    hdr.numBuckets = numBuckets;
+    hdr.bucketsOff = sizeof(InitHeader);
+    hdr.filesOff = hdr.bucketsOff + (sizeof(uint32_t) * buckets.size());
+    hdr.namesOff = hdr.filesOff + (sizeof(InitFileHeader) * this->files.size());
+    hdr.namesLen = names.length();
+    hdr.headerLen = hdr.namesOff + hdr.namesLen;
+    hdr.dataAlign = kInitDataAlign;
+    hdr.chunkSize = kInitChunkSize;
+
+    // place the file data
+    std::vector<File *> order;
+    for(auto &f : this->files) {
+        order.push_back(&f);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const File *f1, const File *f2) {
+        const auto r1 = f1->first ? 0 : (f1->compressed ? 1 : 2);
+        const auto r2 = f2->first ? 0 : (f2->compressed ? 1 : 2);
+        return r1 < r2;
+    });
 
-        const auto end = fileHdr->dataOff + fileHdr->dataLen;
-        if(end > totalSize) {
-            totalSize = end;
-        }
+    size_t dataOff = ((hdr.headerLen + 15) / 16) * 16;
+    size_t totalSize = dataOff;
 
-        // go to the next header
-        fileHdr = reinterpret_cast<InitFileHeader *>(((uintptr_t) fileHdr) + sizeof(InitFileHeader) + fileHdr->nameLen);
-    }
+    for(auto f : order) {
+        if(f->data.empty()) continue;
+
+        const size_t align = f->compressed ? 16 : kInitDataAlign;
+        dataOff = ((dataOff + align - 1) / align) * align;
 
-    std::cout << "starting file data at " << fileDataStart << std::endl;
+        f->dataOff = dataOff;
+        dataOff += f->data.size();
+        totalSize = dataOff;
+    }
 
+    if(totalSize > UINT32_MAX) {
+        throw std::runtime_error("bundle too large");
+    }
     hdr.totalLen = totalSize;
 
-    // write out the bundle header and all file headers
-    file.write(reinterpret_cast<const char *>(&hdr), sizeof(InitHeader));
-    file.write(reinterpret_cast<const char *>(fileHdrs), fileHdrOff);
+    // build the directory
+    std::vector<InitFileHeader> dir;
+    size_t nameOff = 0;
 
-    // place files; assume we placed headers in the same order as the sorted files array
-    fileHdr = reinterpret_cast<InitFileHeader *>(fileHdrs);
-    for(size_t i = 0; i < this->files.size(); i++) {
-        // get file info and write it
-        const auto &info = this->files[i];
+    for(const auto &f : this->files) {
+        InitFileHeader fhdr;
+        memset(&fhdr, 0, sizeof(fhdr));
 
-        file.seekp(fileHdr->dataOff);
-        file.write(reinterpret_cast<const char *>(info.data.data()), info.data.size());
+        fhdr.hash = InitBundleHashName(f.name.data(), f.name.length());
+        fhdr.flags = f.compressed ? kInitFileFlagsCompressed : 0;
+        fhdr.dataOff = f.dataOff;
+        fhdr.dataLen = f.data.size();
+        fhdr.rawLen = f.rawBytes;
+        fhdr.nameOff = nameOff;
+        fhdr.nameLen = f.name.length();
 
-        // go to the next header
-        fileHdr = reinterpret_cast<InitFileHeader *>(((uintptr_t) fileHdr) + sizeof(InitFileHeader) + fileHdr->nameLen);
+        nameOff += f.name.length();
+        dir.push_back(fhdr);
     }
 
+    // write out the bundle header, bucket table, directory and name table
+    file.write(reinterpret_cast<const char *>(&hdr), sizeof(InitHeader));
+    file.write(reinterpret_cast<const char *>(buckets.data()), sizeof(uint32_t) * buckets.size());
+    file.write(reinterpret_cast<const char *>(dir.data()), sizeof(InitFileHeader) * dir.size());
+    file.write(names.data(), names.length());
+
+    // then the file data, in placement order
+    size_t numCompressed = 0;
+    for(auto f : order) {
+        if(f->compressed) numCompressed++;
+        if(f->data.empty()) continue;
+
+        file.seekp(f->dataOff);
+        file.write(reinterpret_cast<const char *>(f->data.data()), f->data.size());
+    }
+
+    std::cout << numCompressed << " of " << this->files.size() << " files compressed; "
+        << numBuckets << " buckets" << std::endl;
+
     // done
-    free(fileHdrs);
     return file.tellp();
 }
@@ -4,11 +4,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 /**
  * Builds an in-memory list of all files to go into an init bundle, then reads them all in,
  * compresses them, and writes them out.
+ *
+ * Each file is compressed individually, and only stored compressed if that saves a meaningful
+ * amount of space; otherwise, it's stored as-is, page aligned, so it can be used in place.
  */
 class InitBundle {
     public:
@@ -16,8 +20,15 @@ class InitBundle {
         InitBundle(const std::string &_sysroot) : sysroot(_sysroot) {}
 
         void addFile(const std::string &inPath);
+        void addDirectory(const std::string &dirPath);
+        void setKernel(const std::string &path);
         size_t write(const std::string &path);
 
+        /// Never compress the file with the given name (path inside the bundle)
+        void storeUncompressed(const std::string &name) {
+            this->uncompressed.insert(name);
+        }
+
         /// Returns the total number of files
         const size_t getNumFiles() const {
             return this->files.size();
@@ -33,16 +44,28 @@ class InitBundle {
 
             /// number of bytes of file data (uncompressed)
             size_t rawBytes;
-            /// compressed file data
+            /// file data, compressed if `compressed` is set
             std::vector<uint8_t> data;
+            /// whether the data is compressed
+            bool compressed{false};
+            /// whether this file is placed before all others (the kernel)
+            bool first{false};
+
+            /// offset of the file's data in the bundle
+            size_t dataOff{0};
 
             File(const std::string &_name, const std::string &_path) : path(_path), name(_name) {}
         };
 
+        void addFile(const std::string &name, const std::string &realpath, const bool first);
+
     private:
         /// path to prepend to filenames when reading from fs
         std::string sysroot;
 
+        /// names of files never to compress
+        std::unordered_set<std::string> uncompressed;
+
         /// all files in the bundle
         std::vector<File> files;
 };
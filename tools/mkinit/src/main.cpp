@@ -7,6 +7,7 @@
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 std::string & ltrim(std::string & str) {
     auto it2 =  std::find_if(str.begin(), str.end(), [](char ch){ return !std::isspace<char>(ch, std::locale::classic()); });
@@ -25,19 +26,24 @@ std::string & trim(std::string & str) {
 /**
  * Input state
  */
-std::string gScriptPath, gOutPath, gSysroot;
+std::string gScriptPath, gOutPath, gSysroot, gDirPath, gKernelPath;
+/// names of files to store uncompressed
+std::vector<std::string> gUncompressed;
 
 /**
  * Parse the command line. The tool should be invoked as "mkinit [flags] -i <script> -o <output path>" 
- * where the optional flags can be any of the following:
+ * or "mkinit [flags] -r <directory> -o <output path>" where the optional flags can be any of the
+ * following:
  *
  * -s [path]: Specifies a sysroot to prepend to all paths in the init script.
+ * -k [path]: Kernel to place (uncompressed) at the start of the bundle.
+ * -u [name]: Store the file with the given name uncompressed. May be specified multiple times.
  *
  * @return true if the program execution should continue, false otherwise.
  */
 static bool ParseCommandline(int argc, char *const *argv) {
     int option;
-    while((option = getopt(argc, argv, ":i:o:s:")) != -1) {
+    while((option = getopt(argc, argv, ":i:o:s:r:k:u:")) != -1) {
         switch(option) {
             // script file
             case 'i':
@@ -51,6 +57,18 @@ static bool ParseCommandline(int argc, char *const *argv) {
             case 's':
                 gSysroot = std::string(optarg);
                 break;
+            // directory to bundle
+            case 'r':
+                gDirPath = std::string(optarg);
+                break;
+            // kernel
+            case 'k':
+                gKernelPath = std::string(optarg);
+                break;
+            // file to not compress
+            case 'u':
+                gUncompressed.emplace_back(optarg);
+                break;
 
             // unknown option
             case '?':
@@ -59,8 +77,8 @@ static bool ParseCommandline(int argc, char *const *argv) {
         }
     }
 
-    // ensure the script path and output path were specified
-    if(gScriptPath.empty() || gOutPath.empty()) {
+    // ensure the script path (or directory) and output path were specified
+    if((gScriptPath.empty() && gDirPath.empty()) || gOutPath.empty()) {
         return false;
     }
 
@@ -114,7 +132,8 @@ static bool LoadFiles(InitBundle &bundle) {
  */
 int main(int argc, char * const *argv) {
     if(!ParseCommandline(argc, argv)) {
-        std::cerr << "usage: " << argv[0] << " [-s sysroot] -i script -o outfile" << std::endl;
+        std::cerr << "usage: " << argv[0] << " [-s sysroot] [-k kernel] [-u name]... "
+            "(-i script | -r directory) -o outfile" << std::endl;
         return -1;
     }
 
@@ -129,10 +148,20 @@ int main(int argc, char * const *argv) {
     // build up the file container
     InitBundle bundle(gSysroot);
 
-    if(!LoadFiles(bundle)) {
+    for(const auto &name : gUncompressed) {
+        bundle.storeUncompressed(name);
+    }
+    if(!gKernelPath.empty()) {
+        bundle.setKernel(gKernelPath);
+    }
+
+    if(!gScriptPath.empty() && !LoadFiles(bundle)) {
         std::cerr << "failed to read init script" << std::endl;
         return 1;
     }
+    if(!gDirPath.empty()) {
+        bundle.addDirectory(gDirPath);
+    }
 
     // write out the bundle
     const auto written = bundle.write(gOutPath);
@@ -0,0 +1,298 @@
+#include "TraceDecoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Process ID for the processor tracks
+constexpr static const int kProcessorsPid{0};
+/// Process ID for the thread tracks
+constexpr static const int kThreadsPid{1};
+
+/**
+ * Names of syscalls, indexed by syscall number; this matches the amd64 syscall table.
+ */
+static const std::unordered_map<uint64_t, std::string> gSyscallNames{
+    {0x00, "PortReceive"}, {0x01, "PortSend"}, {0x02, "PortSetParams"}, {0x03, "PortAlloc"},
+    {0x04, "PortDealloc"},
+    {0x08, "NotifyReceive"}, {0x09, "NotifySend"},
+    {0x10, "VmAllocPhysRegion"}, {0x11, "VmAllocAnonRegion"}, {0x12, "VmDealloc"},
+    {0x13, "VmRegionUpdatePermissions"}, {0x14, "VmRegionResize"}, {0x15, "VmRegionMap"},
+    {0x16, "VmRegionMapEx"}, {0x17, "VmRegionUnmap"}, {0x18, "VmRegionGetInfo"},
+    {0x19, "VmTaskGetInfo"}, {0x1A, "VmAddrToRegion"}, {0x1B, "VmTranslateVirtToPhys"},
+    {0x1C, "VmQueryParams"},
+    {0x20, "ThreadGetHandle"}, {0x21, "ThreadYield"}, {0x22, "ThreadUsleep"},
+    {0x23, "ThreadCreate"}, {0x24, "ThreadJoin"}, {0x25, "ThreadDestroy"},
+    {0x27, "ThreadSetPriority"}, {0x28, "ThreadSetNoteMask"}, {0x29, "ThreadSetName"},
+    {0x2A, "ThreadResume"},
+    {0x30, "TaskGetHandle"}, {0x31, "TaskCreate"}, {0x32, "TaskTerminate"},
+    {0x33, "TaskInitialize"}, {0x34, "TaskSetName"}, {0x36, "TaskDbgOut"},
+    {0x37, "TaskDbgReadLog"},
+    {0x38, "IrqHandlerInstall"}, {0x39, "IrqHandlerRemove"}, {0x3A, "IrqHandlerUpdate"},
+    {0x3B, "IrqHandlerGetInfo"}, {0x3C, "IrqHandlerAllocCoreLocal"},
+    {0x40, "GetEntropy"}, {0x41, "TraceSetMask"}, {0x42, "TraceRead"},
+    {0x48, "UpdateThreadTlsBase"}, {0x49, "GetLoaderInfo"}, {0x4A, "UpdateIoPermission"},
+    {0x4B, "LockIoPermission"}, {0x4C, "IoPortRead"}, {0x4D, "IoPortWrite"},
+    {0x4E, "SetFbConsState"},
+};
+
+/**
+ * Reads all trace records from the given dump file.
+ */
+void TraceDecoder::addFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file.good()) {
+        throw std::system_error(errno, std::generic_category(), "failed to open " + path);
+    }
+
+    TraceRecord record;
+    while(file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        this->records.push_back(record);
+    }
+
+    if(file.gcount()) {
+        throw std::runtime_error(path + " has a partial record at the end");
+    }
+
+    this->decoded = false;
+}
+
+/**
+ * Sorts all records by timestamp, then pairs up syscall entry and exit events, and page faults,
+ * into spans.
+ */
+void TraceDecoder::decode() {
+    if(this->decoded) return;
+
+    std::stable_sort(this->records.begin(), this->records.end(),
+            [](const auto &a, const auto &b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    this->spans.clear();
+
+    // open syscalls, by thread handle
+    std::unordered_map<uint64_t, const TraceRecord *> syscalls;
+
+    for(const auto &record : this->records) {
+        switch(static_cast<TraceEvent>(record.event)) {
+            case TraceEvent::SyscallEnter:
+                syscalls[record.thread] = &record;
+                break;
+
+            case TraceEvent::SyscallExit: {
+                auto it = syscalls.find(record.thread);
+                if(it == syscalls.end() || it->second->args[0] != record.args[0]) break;
+
+                const auto enter = it->second;
+                syscalls.erase(it);
+
+                this->spans.push_back({record.thread, enter->coreId, enter->timestamp,
+                        record.timestamp, SyscallName(record.args[0])});
+                break;
+            }
+
+            case TraceEvent::PageFault:
+                this->spans.push_back({record.thread, record.coreId,
+                        record.timestamp - record.args[3], record.timestamp,
+                        "PageFault " + Hex(record.args[0])});
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    this->decoded = true;
+}
+
+/**
+ * Writes all trace records to the given file as a Chrome trace event JSON file.
+ *
+ * @return Number of bytes written
+ */
+size_t TraceDecoder::write(const std::string &path) {
+    this->decode();
+
+    std::ofstream os(path, std::ios::trunc);
+    if(!os.good()) {
+        throw std::system_error(errno, std::generic_category(), "failed to open " + path);
+    }
+
+    const uint64_t base = this->records.empty() ? 0 : this->records.front().timestamp;
+    // timestamps are relative to the first record; both they and durations are in µs
+    auto us = [](const int64_t ns) {
+        std::stringstream str;
+        str << std::fixed << std::setprecision(3) << (static_cast<double>(ns) / 1000.);
+        return str.str();
+    };
+    auto ts = [&](const uint64_t timestamp) {
+        return us(static_cast<int64_t>(timestamp - base));
+    };
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+
+    // name the tracks
+    std::unordered_set<uint16_t> cores;
+    std::unordered_set<uint64_t> threads;
+    for(const auto &record : this->records) {
+        cores.insert(record.coreId);
+        if(record.thread) threads.insert(record.thread);
+    }
+
+    os << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kProcessorsPid
+        << ",\"args\":{\"name\":\"Processors\"}}," << std::endl;
+    os << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kThreadsPid
+        << ",\"args\":{\"name\":\"Threads\"}}";
+
+    for(const auto core : cores) {
+        os << "," << std::endl << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":"
+            << kProcessorsPid << ",\"tid\":" << core << ",\"args\":{\"name\":\"Core "
+            << core << "\"}}";
+    }
+    for(const auto thread : threads) {
+        os << "," << std::endl << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << kThreadsPid
+            << ",\"tid\":" << thread << ",\"args\":{\"name\":\"Thread " << Hex(thread) << "\"}}";
+    }
+
+    // the threads running on each processor, from one context switch to the next
+    std::unordered_map<uint16_t, const TraceRecord *> running;
+
+    auto endSlice = [&](const TraceRecord *from, const uint64_t end) {
+        os << "," << std::endl << "{\"ph\":\"X\",\"name\":\"Thread " << Hex(from->args[1])
+            << "\",\"pid\":" << kProcessorsPid << ",\"tid\":" << from->coreId << ",\"ts\":"
+            << ts(from->timestamp) << ",\"dur\":" << us(end - from->timestamp) << "}";
+    };
+
+    for(const auto &record : this->records) {
+        if(static_cast<TraceEvent>(record.event) == TraceEvent::ContextSwitch) {
+            auto it = running.find(record.coreId);
+            if(it != running.end()) {
+                endSlice(it->second, record.timestamp);
+            }
+            running[record.coreId] = &record;
+        } else {
+            this->writeEvent(os, record);
+        }
+    }
+
+    if(!this->records.empty()) {
+        const auto end = this->records.back().timestamp;
+        for(const auto &[core, from] : running) {
+            endSlice(from, end);
+        }
+    }
+
+    // syscalls and page faults
+    for(const auto &span : this->spans) {
+        os << "," << std::endl << "{\"ph\":\"X\",\"name\":\"" << span.name << "\",\"pid\":"
+            << kThreadsPid << ",\"tid\":" << span.thread << ",\"ts\":" << ts(span.start)
+            << ",\"dur\":" << us(span.end - span.start) << ",\"args\":{\"core\":"
+            << span.coreId << "}}";
+    }
+
+    os << std::endl << "]}" << std::endl;
+    return os.tellp();
+}
+
+/**
+ * Writes a single instantaneous event for the given record. Events that are part of spans or
+ * slices are skipped, since they're written separately.
+ */
+void TraceDecoder::writeEvent(std::ostream &os, const TraceRecord &record) {
+    const uint64_t base = this->records.front().timestamp;
+    const auto time = static_cast<double>(record.timestamp - base) / 1000.;
+
+    std::string name;
+    std::stringstream args;
+    int pid{kThreadsPid};
+    uint64_t tid{record.thread};
+
+    switch(static_cast<TraceEvent>(record.event)) {
+        case TraceEvent::PortSend:
+            name = "PortSend";
+            args << "\"port\":\"" << Hex(record.args[0]) << "\",\"length\":" << record.args[1]
+                << ",\"status\":" << static_cast<int64_t>(record.args[2]);
+            break;
+        case TraceEvent::PortReceive:
+            name = "PortReceive";
+            args << "\"port\":\"" << Hex(record.args[0]) << "\",\"bufferLength\":"
+                << record.args[1] << ",\"status\":" << static_cast<int64_t>(record.args[2]);
+            break;
+
+        case TraceEvent::Irq:
+            name = "Irq " + std::to_string(record.args[0]);
+            args << "\"vector\":" << record.args[1] << ",\"thread\":\"" << Hex(record.args[2])
+                << "\",\"bits\":\"" << Hex(record.args[3]) << "\"";
+            pid = kProcessorsPid;
+            tid = record.coreId;
+            break;
+
+        case TraceEvent::SyscallEnter:
+        case TraceEvent::SyscallExit:
+        case TraceEvent::PageFault:
+        case TraceEvent::ContextSwitch:
+            return;
+
+        default:
+            name = "Event " + Hex(record.event);
+            args << "\"args\":[" << record.args[0] << "," << record.args[1] << ","
+                << record.args[2] << "," << record.args[3] << "]";
+            break;
+    }
+
+    os << "," << std::endl << "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << name << "\",\"pid\":"
+        << pid << ",\"tid\":" << tid << ",\"ts\":" << std::fixed << std::setprecision(3) << time
+        << ",\"args\":{\"core\":" << record.coreId << "," << args.str() << "}}";
+}
+
+/**
+ * Prints all syscalls and page faults that took at least the given time, longest first.
+ */
+void TraceDecoder::printOutliers(std::ostream &os, const uint64_t thresholdNs) {
+    this->decode();
+
+    std::vector<const Span *> outliers;
+    for(const auto &span : this->spans) {
+        if(span.end - span.start >= thresholdNs) {
+            outliers.push_back(&span);
+        }
+    }
+
+    std::sort(outliers.begin(), outliers.end(), [](const auto a, const auto b) {
+        return (a->end - a->start) > (b->end - b->start);
+    });
+
+    for(const auto span : outliers) {
+        os << std::setw(12) << (span->end - span->start) << " ns  thread " << std::setw(18)
+            << Hex(span->thread) << "  core " << std::setw(3) << span->coreId << "  at "
+            << span->start << ": " << span->name << std::endl;
+    }
+}
+
+/**
+ * Returns the name of the given syscall.
+ */
+std::string TraceDecoder::SyscallName(const uint64_t number) {
+    auto it = gSyscallNames.find(number);
+    if(it != gSyscallNames.end()) {
+        return it->second;
+    }
+
+    return "Syscall " + Hex(number);
+}
+
+/**
+ * Formats a number as a hexadecimal string.
+ */
+std::string TraceDecoder::Hex(const uint64_t value) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(value));
+    return buf;
+}
@@ -0,0 +1,60 @@
+#ifndef _TRACEDUMP_TRACEDECODER_H
+#define _TRACEDUMP_TRACEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "TraceTypes.h"
+
+/**
+ * Reads one or more kernel trace dumps and converts them to the Chrome trace event JSON format,
+ * which can be viewed in Perfetto or `chrome://tracing`.
+ *
+ * Each processor gets a track showing which thread it's running, as well as interrupts delivered
+ * on it. Each thread gets a track with its syscalls, page faults, and IPC operations.
+ */
+class TraceDecoder {
+    public:
+        void addFile(const std::string &path);
+        size_t write(const std::string &path);
+
+        void printOutliers(std::ostream &os, const uint64_t thresholdNs);
+
+        /// Returns the total number of trace records read
+        size_t getNumRecords() const {
+            return this->records.size();
+        }
+
+    private:
+        /// An operation with a duration, i.e. a syscall or page fault
+        struct Span {
+            /// thread the operation was performed on
+            uint64_t thread;
+            /// processor on which the operation started
+            uint16_t coreId;
+            /// start and end timestamps (in ns)
+            uint64_t start, end;
+            /// descriptive name of the operation
+            std::string name;
+        };
+
+        void decode();
+        void writeEvent(std::ostream &os, const TraceRecord &record);
+
+        static std::string SyscallName(const uint64_t number);
+        static std::string Hex(const uint64_t value);
+
+    private:
+        /// all records read, sorted by timestamp once decoded
+        std::vector<TraceRecord> records;
+        /// whether the records have been decoded
+        bool decoded{false};
+
+        /// all syscalls and page faults, in the order they completed
+        std::vector<Span> spans;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef _TRACEDUMP_TRACETYPES_H
+#define _TRACEDUMP_TRACETYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Types of trace events; this must be kept in sync with `debug::TraceEvent` in the kernel. The
+ * high byte of each value is the event's category.
+ */
+enum class TraceEvent: uint16_t {
+    ContextSwitch                       = 0x0001,
+
+    PortSend                            = 0x0101,
+    PortReceive                         = 0x0102,
+
+    PageFault                           = 0x0201,
+
+    Irq                                 = 0x0301,
+
+    SyscallEnter                        = 0x0401,
+    SyscallExit                         = 0x0402,
+};
+
+/**
+ * A single trace record, as written by the kernel (`debug::TraceRecord`) and returned by the
+ * TraceRead syscall. A trace dump is simply a sequence of these.
+ */
+struct TraceRecord {
+    /// sequence number of the record in its processor's buffer, plus one
+    uint64_t sequence;
+    /// timestamp at which the event was recorded, in nanoseconds
+    uint64_t timestamp;
+    /// handle of the thread running when the event was recorded
+    uint64_t thread;
+    /// event type
+    uint16_t event;
+    /// processor that recorded the event
+    uint16_t coreId;
+    /// reserved
+    uint32_t reserved;
+    /// event specific arguments
+    uint64_t args[4];
+} __attribute__((packed));
+static_assert(sizeof(TraceRecord) == 64, "invalid trace record size");
+
+#endif
@@ -0,0 +1,93 @@
+#include "TraceDecoder.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Input state
+ */
+std::vector<std::string> gInPaths;
+std::string gOutPath;
+/// If nonzero, print all syscalls and page faults that took at least this long (in ns)
+uint64_t gOutlierThreshold{0};
+
+/**
+ * Parse the command line. The tool should be invoked as "tracedump -i <dump> [-i <dump>...]
+ * [-o <output path>] [-t <threshold>]" where each input is a binary kernel trace dump.
+ *
+ * @return true if the program execution should continue, false otherwise.
+ */
+static bool ParseCommandline(int argc, char *const *argv) {
+    int option;
+    while((option = getopt(argc, argv, ":i:o:t:")) != -1) {
+        switch(option) {
+            // input trace dump
+            case 'i':
+                gInPaths.emplace_back(optarg);
+                break;
+            // output JSON file
+            case 'o':
+                gOutPath = std::string(optarg);
+                break;
+            // outlier threshold
+            case 't':
+                gOutlierThreshold = strtoull(optarg, nullptr, 0);
+                break;
+
+            // unknown option
+            case '?':
+                std::cerr << "unknown option " << (char) optopt << std::endl;
+                return false;
+        }
+    }
+
+    // ensure there's an input, and something to do with it
+    if(gInPaths.empty() || (gOutPath.empty() && !gOutlierThreshold)) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Entry point for the trace decoder.
+ *
+ * All input dumps (as read via the TraceRead syscall) are combined into a single Chrome trace
+ * event file, which can be opened in Perfetto. Optionally, the longest syscalls and page faults
+ * are printed as well.
+ */
+int main(int argc, char * const *argv) {
+    if(!ParseCommandline(argc, argv)) {
+        std::cerr << "usage: " << argv[0] << " -i dump [-i dump2...] [-o trace.json] "
+            "[-t outlier threshold (ns)]" << std::endl;
+        return -1;
+    }
+
+    TraceDecoder decoder;
+
+    try {
+        for(const auto &path : gInPaths) {
+            decoder.addFile(path);
+        }
+
+        if(!gOutPath.empty()) {
+            const auto written = decoder.write(gOutPath);
+            std::cout << "Wrote " << written << " bytes (" << decoder.getNumRecords()
+                << " trace records)" << std::endl;
+        }
+
+        if(gOutlierThreshold) {
+            decoder.printOutliers(std::cout, gOutlierThreshold);
+        }
+    } catch(const std::exception &e) {
+        std::cerr << "failed to decode trace: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "CompiledDbParser.h"
+#include "DriverDb.h"
+#include "Driver.h"
+#include "DeviceMatch.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <string>
+
+/**
+ * Reads the compiled database at the given path into memory, then creates driver objects for all
+ * drivers inside it and adds them to the driver database.
+ */
+bool CompiledDbParser::parse(const std::string_view &path, DriverDb *db) {
+    // read the entire file
+    FILE *fp = fopen(path.data(), "rb");
+    if(!fp) {
+        Warn("Failed to open driver db at %s", path.data());
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    const auto size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if(size <= 0 || static_cast<size_t>(size) < sizeof(DriverDbHeader)) {
+        Warn("Driver DB at %s is invalid: %s", path.data(), "file too small");
+        fclose(fp);
+        return false;
+    }
+
+    this->data.resize(size);
+    const auto read = fread(this->data.data(), 1, size, fp);
+    fclose(fp);
+
+    if(read != static_cast<size_t>(size)) {
+        Warn("Failed to read driver db at %s: %lu of %ld bytes", path.data(), read, size);
+        return false;
+    }
+
+    // set up the tables
+    if(!this->validate(path)) {
+        return false;
+    }
+
+    // create drivers
+    DriverList temp;
+    temp.reserve(this->drivers.size());
+
+    for(const auto &entry : this->drivers) {
+        if(!this->processEntry(entry, temp)) {
+            Warn("Driver DB at %s is invalid: %s", path.data(), "invalid driver entry");
+            return false;
+        }
+    }
+
+    Trace("Read %lu driver(s) from %s", temp.size(), path.data());
+    for(const auto &driver : temp) {
+        db->addDriver(driver);
+    }
+
+    return true;
+}
+
+/**
+ * Checks whether a file exists at the given path.
+ */
+bool CompiledDbParser::Exists(const std::string_view &path) {
+    FILE *fp = fopen(path.data(), "rb");
+    if(!fp) return false;
+
+    fclose(fp);
+    return true;
+}
+
+/**
+ * Ensures the header of the database is valid, and that all of the tables it refers to are
+ * contained in the file.
+ */
+bool CompiledDbParser::validate(const std::string_view &path) {
+    auto base = reinterpret_cast<const uint8_t *>(this->data.data());
+    const size_t size = this->data.size();
+
+    this->hdr = reinterpret_cast<const DriverDbHeader *>(base);
+
+    if(this->hdr->magic != kDriverDbMagic || this->hdr->type != kDriverDbType) {
+        Warn("Driver DB at %s is invalid: %s", path.data(), "invalid magic");
+        return false;
+    } else if(this->hdr->major != 1) {
+        Warn("Driver DB at %s is invalid: unsupported version %u.%u", path.data(),
+                this->hdr->major, this->hdr->minor);
+        return false;
+    } else if(this->hdr->totalLen > size) {
+        Warn("Driver DB at %s is invalid: %s", path.data(), "truncated");
+        return false;
+    }
+
+    // ensure each table is in bounds
+    auto inBounds = [&](const uint32_t off, const size_t len) {
+        return off <= size && len <= (size - off);
+    };
+
+    if(!inBounds(this->hdr->driversOff, this->hdr->numDrivers * sizeof(DriverDbDriver)) ||
+       !inBounds(this->hdr->matchesOff, this->hdr->numMatches * sizeof(DriverDbMatch)) ||
+       !inBounds(this->hdr->vidPidsOff, this->hdr->numVidPids * sizeof(DriverDbVidPid)) ||
+       !inBounds(this->hdr->stringsOff, this->hdr->stringsLen)) {
+        Warn("Driver DB at %s is invalid: %s", path.data(), "table out of bounds");
+        return false;
+    }
+
+    this->drivers = {reinterpret_cast<const DriverDbDriver *>(base + this->hdr->driversOff),
+        this->hdr->numDrivers};
+    this->matches = {reinterpret_cast<const DriverDbMatch *>(base + this->hdr->matchesOff),
+        this->hdr->numMatches};
+    this->vidPids = {reinterpret_cast<const DriverDbVidPid *>(base + this->hdr->vidPidsOff),
+        this->hdr->numVidPids};
+    this->strings = {reinterpret_cast<const char *>(base + this->hdr->stringsOff),
+        this->hdr->stringsLen};
+
+    return true;
+}
+
+/**
+ * Creates a driver object from the given driver record, including all of its match descriptors.
+ */
+bool CompiledDbParser::processEntry(const DriverDbDriver &entry, DriverList &dl) {
+    const auto path = this->getString(entry.pathOff, entry.pathLen);
+    if(path.empty()) return false;
+
+    if(entry.firstMatch > this->matches.size() ||
+            entry.numMatches > (this->matches.size() - entry.firstMatch)) {
+        return false;
+    }
+
+    auto driver = std::make_shared<Driver>(std::string(path));
+    driver->mustMatchAll = (entry.flags & kDriverDbDriverFlagsMatchAll);
+
+    for(const auto &m : this->matches.subspan(entry.firstMatch, entry.numMatches)) {
+        switch(m.type) {
+            case kDriverDbMatchTypeName: {
+                const auto name = this->getString(m.nameOff, m.nameLen);
+                if(name.empty()) return false;
+
+                driver->addMatch(new DeviceNameMatch(std::string(name), m.priority));
+                break;
+            }
+
+            case kDriverDbMatchTypePci: {
+                if(m.firstVidPid > this->vidPids.size() ||
+                        m.numVidPid > (this->vidPids.size() - m.firstVidPid)) {
+                    return false;
+                }
+
+                auto pci = new PciDeviceMatch(m.flags & kDriverDbMatchFlagsConjunction,
+                        m.priority);
+                if(m.flags & kDriverDbMatchFlagsClass) pci->setClassId(m.classId);
+                if(m.flags & kDriverDbMatchFlagsSubclass) pci->setSubclassId(m.subclassId);
+
+                for(const auto &vp : this->vidPids.subspan(m.firstVidPid, m.numVidPid)) {
+                    std::optional<uint16_t> pid;
+                    std::optional<int> priority;
+
+                    if(vp.flags & kDriverDbVidPidFlagsPid) pid = vp.pid;
+                    if(vp.flags & kDriverDbVidPidFlagsPriority) priority = vp.priority;
+
+                    pci->addVidPidMatch(vp.vid, pid, priority);
+                }
+
+                driver->addMatch(pci);
+                break;
+            }
+
+            default:
+                Warn("Driver %s is invalid: unknown match type %u", driver->getPath().c_str(),
+                        m.type);
+                return false;
+        }
+    }
+
+    dl.push_back(std::move(driver));
+    return true;
+}
+
+/**
+ * Returns a view of a string in the string table, or an empty view if it is out of bounds.
+ */
+std::string_view CompiledDbParser::getString(const uint32_t off, const uint32_t len) const {
+    if(off > this->strings.size() || len > (this->strings.size() - off)) {
+        return {};
+    }
+    return std::string_view(this->strings.data() + off, len);
+}
@@ -0,0 +1,53 @@
+#ifndef DB_COMPILEDDBPARSER_H
+#define DB_COMPILEDDBPARSER_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "DriverDbTypes.h"
+
+class DriverDb;
+class Driver;
+
+/**
+ * Loads a compiled driver database, as produced by the `mkdriverdb` tool. The entire file is read
+ * into memory and its tables are used in place; no text parsing is required.
+ */
+class CompiledDbParser {
+    using DriverPtr = std::shared_ptr<Driver>;
+    using DriverList = std::vector<DriverPtr>;
+
+    public:
+        /// Read drivers from the given file and add to database
+        [[nodiscard]] bool parse(const std::string_view &path, DriverDb * _Nonnull db);
+
+        /// Tests whether a compiled database exists at the given path.
+        static bool Exists(const std::string_view &path);
+
+    private:
+        /// Validates the header and table bounds of the database.
+        [[nodiscard]] bool validate(const std::string_view &path);
+
+        /// Generate a driver object for an entry.
+        [[nodiscard]] bool processEntry(const DriverDbDriver &, DriverList &);
+
+        /// Gets a string from the string table.
+        std::string_view getString(const uint32_t off, const uint32_t len) const;
+
+    private:
+        /// contents of the database file
+        std::vector<std::byte> data;
+
+        /// header of the database
+        const DriverDbHeader * _Nullable hdr{nullptr};
+        /// tables in the database
+        std::span<const DriverDbDriver> drivers;
+        std::span<const DriverDbMatch> matches;
+        std::span<const DriverDbVidPid> vidPids;
+        std::span<const char> strings;
+};
+
+#endif
@@ -5,12 +5,24 @@
 #include <vector>
 #include <mpack/mpack.h>
 
+/**
+ * Decodes the match information of the device.
+ */
+MatchDevice::MatchDevice(const std::shared_ptr<Device> &_device) : device(_device) {
+    PciDeviceMatch::Info info;
+    if(PciDeviceMatch::DecodeInfo(_device, info)) {
+        this->pci = info;
+    }
+}
+
+
+
 /**
  * Checks if the given device specifies our name anywhere in its list of driver names. Depending
  * on its index in the driver name list, we'll apply a negative offset to the base priority value.
  */
-bool DeviceNameMatch::supportsDevice(const std::shared_ptr<Device> &dev, int &outPriority) {
-    const auto &names = dev->getDriverNames();
+bool DeviceNameMatch::supportsDevice(const MatchDevice &dev, int &outPriority) {
+    const auto &names = dev.device->getDriverNames();
 
     for(size_t i = 0; i < names.size(); i++) {
         // trim off the aux info if needed
@@ -29,6 +41,13 @@ bool DeviceNameMatch::supportsDevice(const std::shared_ptr<Device> &dev, int &ou
     return false;
 }
 
+/**
+ * Name matches are indexed by the name; the device produces a key for each of its names.
+ */
+void DeviceNameMatch::getKeys(std::vector<MatchKey> &outKeys) const {
+    outKeys.emplace_back(this->name);
+}
+
 
 
 const std::string PciDeviceMatch::kPciExpressInfoPropertyName{"pcie.info"};
@@ -43,12 +62,11 @@ void PciDeviceMatch::addVidPidMatch(const uint16_t vid, const std::optional<uint
 }
 
 /**
- * If the given device is a PCI or PCI Express device, attempt to match against it.
+ * Decodes the PCI information property of the device.
+ *
+ * @return Whether the device is a PCI device, and its info was decoded.
  */
-bool PciDeviceMatch::supportsDevice(const std::shared_ptr<Device> &dev, int &outPriority) {
-    bool success{false};
-
-    // decode the PCI info
+bool PciDeviceMatch::DecodeInfo(const std::shared_ptr<Device> &dev, Info &outInfo) {
     mpack_tree_t tree;
     std::vector<std::byte> info;
 
@@ -60,24 +78,39 @@ bool PciDeviceMatch::supportsDevice(const std::shared_ptr<Device> &dev, int &out
         return false;
     }
 
-
     mpack_tree_parse(&tree);
     mpack_node_t root = mpack_tree_root(&tree);
 
-    const uint8_t classId = mpack_node_u8(mpack_node_map_cstr(root, "class")),
-               subclassId = mpack_node_u8(mpack_node_map_cstr(root, "subclass"));
-    const uint16_t    vid = mpack_node_u16(mpack_node_map_cstr(root, "vid")),
-                      pid = mpack_node_u16(mpack_node_map_cstr(root, "pid"));
-
-    if(kLogMatch) Trace("Match against %04x:%04x, class %02x:%02x (expected %02x %02x)", vid, pid,
-            classId, subclassId, this->classId.value_or(-1), this->subclassId.value_or(-1));
+    outInfo.classId = mpack_node_u8(mpack_node_map_cstr(root, "class"));
+    outInfo.subclassId = mpack_node_u8(mpack_node_map_cstr(root, "subclass"));
+    outInfo.vid = mpack_node_u16(mpack_node_map_cstr(root, "vid"));
+    outInfo.pid = mpack_node_u16(mpack_node_map_cstr(root, "pid"));
 
     // clean up the msgpack decoder
     auto status = mpack_tree_destroy(&tree);
     if(status != mpack_ok) {
         Warn("%s failed: %d", "mpack_tree_destroy", status);
+        return false;
     }
 
+    return true;
+}
+
+/**
+ * If the given device is a PCI or PCI Express device, attempt to match against it.
+ */
+bool PciDeviceMatch::supportsDevice(const MatchDevice &dev, int &outPriority) {
+    bool success{false};
+
+    // the PCI info was decoded when the lookup started
+    if(!dev.pci) return false;
+
+    const auto classId = dev.pci->classId, subclassId = dev.pci->subclassId;
+    const auto vid = dev.pci->vid, pid = dev.pci->pid;
+
+    if(kLogMatch) Trace("Match against %04x:%04x, class %02x:%02x (expected %02x %02x)", vid, pid,
+            classId, subclassId, this->classId.value_or(-1), this->subclassId.value_or(-1));
+
     // match class id if needed
     if(this->classId) {
         if(*this->classId != classId) return false;
@@ -114,3 +147,24 @@ bool PciDeviceMatch::supportsDevice(const std::shared_ptr<Device> &dev, int &out
     return success;
 }
 
+/**
+ * Index the match by the most specific condition that every matching device must satisfy: class
+ * and subclass ids are always required if specified; otherwise, one of the vid/pid pairs must
+ * match.
+ */
+void PciDeviceMatch::getKeys(std::vector<MatchKey> &outKeys) const {
+    if(this->classId) {
+        outKeys.emplace_back(MatchKey::Type::PciClass, *this->classId);
+    } else if(this->subclassId) {
+        outKeys.emplace_back(MatchKey::Type::PciSubclass, *this->subclassId);
+    } else {
+        for(const auto &m : this->vidPid) {
+            if(m.pid) {
+                outKeys.emplace_back(MatchKey::Type::PciDevice,
+                        (static_cast<uint32_t>(m.vid) << 16) | *m.pid);
+            } else {
+                outKeys.emplace_back(MatchKey::Type::PciVendor, m.vid);
+            }
+        }
+    }
+}
@@ -7,7 +7,10 @@
 #include <string_view>
 #include <vector>
 
+#include "MatchKey.h"
+
 class Device;
+struct MatchDevice;
 
 /**
  * Defines the basic interface of a device match structure. Each match implements a different
@@ -23,7 +26,14 @@ class DeviceMatch {
          * allows basic feature support for a wide range of hardware, with more specific drivers
          * with higher priorities for more specific hardware.
          */
-        virtual bool supportsDevice(const std::shared_ptr<Device> &dev, int &outPriority) = 0;
+        virtual bool supportsDevice(const MatchDevice &dev, int &outPriority) = 0;
+
+        /**
+         * Outputs the keys under which this match is indexed in the driver database. A device
+         * can only be supported if it produces at least one of these keys as well; a match that
+         * outputs no keys is tested against every device.
+         */
+        virtual void getKeys(std::vector<MatchKey> &outKeys) const = 0;
 };
 
 /**
@@ -36,7 +46,8 @@ class DeviceNameMatch: public DeviceMatch {
          */
         DeviceNameMatch(const std::string &_name, int _priority) : name(_name), priority(_priority) {}
 
-        bool supportsDevice(const std::shared_ptr<Device> &dev, int &outPriority) override;
+        bool supportsDevice(const MatchDevice &dev, int &outPriority) override;
+        void getKeys(std::vector<MatchKey> &outKeys) const override;
 
     private:
         /// Name to match against anywhere in the device name list
@@ -57,6 +68,16 @@ class PciDeviceMatch: public DeviceMatch {
     /// Property storing the PCI device information
     static const std::string kPciExpressInfoPropertyName;
 
+    public:
+        /// PCI device information decoded from a device's properties
+        struct Info {
+            uint8_t classId{0}, subclassId{0};
+            uint16_t vid{0}, pid{0};
+        };
+
+        /// Decodes the PCI device information of the given device, if it is a PCI device.
+        static bool DecodeInfo(const std::shared_ptr<Device> &dev, Info &outInfo);
+
     public:
         /// Creates an empty PCI device match.
         PciDeviceMatch() = default;
@@ -93,7 +114,9 @@ class PciDeviceMatch: public DeviceMatch {
                 const std::optional<int> priority = std::nullopt);
 
         /// Checks whether we can match against the given device.
-        bool supportsDevice(const std::shared_ptr<Device> &dev, int &outPriority) override;
+        bool supportsDevice(const MatchDevice &dev, int &outPriority) override;
+        /// Gets the keys of the most specific required condition.
+        void getKeys(std::vector<MatchKey> &outKeys) const override;
 
     private:
         /// Defines a single vid/pid match.
@@ -125,4 +148,17 @@ class PciDeviceMatch: public DeviceMatch {
         int priority{0};
 };
 
+/**
+ * A device that's being matched against drivers. Information that matches test is decoded from the
+ * device's properties once, before the lookup, rather than again by every match.
+ */
+struct MatchDevice {
+    /// Device being matched
+    const std::shared_ptr<Device> &device;
+    /// PCI device information, if it's a PCI device
+    std::optional<PciDeviceMatch::Info> pci;
+
+    explicit MatchDevice(const std::shared_ptr<Device> &_device);
+};
+
 #endif
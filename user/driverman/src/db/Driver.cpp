@@ -40,7 +40,7 @@ void Driver::addMatch(DeviceMatch *match) {
  * Tests whether we can match to the device. This will query every match descriptor to see if it
  * matches, and and returns the highest priority value returned by them all.
  */
-bool Driver::test(const std::shared_ptr<Device> &dev, int &outPriority) {
+bool Driver::test(const MatchDevice &dev, int &outPriority) {
     int priority{0};
 
     // bail if no match descriptors
@@ -75,6 +75,34 @@ bool Driver::test(const std::shared_ptr<Device> &dev, int &outPriority) {
     }
 }
 
+/**
+ * Collects the index keys of all match descriptors. If any descriptor may be satisfied on its own
+ * and can't be indexed, the driver as a whole can't be indexed; when all descriptors must match,
+ * the keys of any one of them suffice.
+ *
+ * @return Whether the driver can be indexed; if not, it must be tested against every device.
+ */
+bool Driver::getKeys(std::vector<MatchKey> &outKeys) const {
+    std::vector<MatchKey> keys;
+
+    for(auto m : this->matches) {
+        keys.clear();
+        m->getKeys(keys);
+
+        if(this->mustMatchAll) {
+            if(!keys.empty()) {
+                outKeys = std::move(keys);
+                return true;
+            }
+        } else {
+            if(keys.empty()) return false;
+            outKeys.insert(outKeys.end(), keys.begin(), keys.end());
+        }
+    }
+
+    return !outKeys.empty();
+}
+
 
 
 /**
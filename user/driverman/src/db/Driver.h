@@ -7,8 +7,11 @@
 #include <string>
 #include <vector>
 
+#include "MatchKey.h"
+
 class Device;
 class DeviceMatch;
+struct MatchDevice;
 
 class DriverInstance;
 
@@ -17,6 +20,7 @@ class DriverInstance;
  */
 class Driver: public std::enable_shared_from_this<Driver> {
     friend class DbParser;
+    friend class CompiledDbParser;
 
     public:
         Driver(const std::string &path);
@@ -26,7 +30,9 @@ class Driver: public std::enable_shared_from_this<Driver> {
         void addMatch(DeviceMatch *);
 
         /// Determine whether this driver matches against the device, and if so, its priority.
-        virtual bool test(const std::shared_ptr<Device> &dev, int &outPriority);
+        virtual bool test(const MatchDevice &dev, int &outPriority);
+        /// Get the keys under which the driver is indexed in the driver database.
+        virtual bool getKeys(std::vector<MatchKey> &outKeys) const;
         /// Start the driver for the given device.
         virtual void start(const std::shared_ptr<Device> &dev);
 
@@ -1,8 +1,13 @@
 #include "DriverDb.h"
+#include "CompiledDbParser.h"
 #include "DbParser.h"
+#include "DeviceMatch.h"
 #include "Driver.h"
 #include "Log.h"
 
+#include "forest/Device.h"
+
+#include <algorithm>
 #include <queue>
 
 DriverDb *DriverDb::gShared{nullptr};
@@ -19,9 +24,7 @@ DriverDb *DriverDb::gShared{nullptr};
  * must also exist on the real filesystem) the init drivers.
  */
 DriverDb::DriverDb() {
-    DbParser p;
-
-    if(!p.parse(kBootDbPath, this)) {
+    if(!this->load(kBootCompiledDbPath, kBootDbPath)) {
         Abort("Failed to load %s driver database", "initial");
     }
 }
@@ -31,17 +34,32 @@ DriverDb::DriverDb() {
  * called when the root filesystem has become available.
  */
 void DriverDb::loadFullDb() {
-    DbParser p;
-
-    if(!p.parse(kFullDbPath, this)) {
+    if(!this->load(kFullCompiledDbPath, kFullDbPath)) {
         Abort("Failed to load %s driver database", "full");
     }
 }
 
+/**
+ * Loads the drivers from a database. If a compiled version of the database exists, it's used;
+ * otherwise, we fall back to parsing the text form.
+ */
+bool DriverDb::load(const std::string_view &compiledPath, const std::string_view &textPath) {
+    if(CompiledDbParser::Exists(compiledPath)) {
+        CompiledDbParser p;
+        return p.parse(compiledPath, this);
+    }
+
+    DbParser p;
+    return p.parse(textPath, this);
+}
+
 /**
  * Finds a driver that can match to the given device. If there are multiple drivers that match,
  * the one with the highest priority is returned.
  *
+ * Rather than testing every driver, we look up the device's keys in the index to get a list of
+ * candidate drivers; only those, and the drivers that could not be indexed, are tested.
+ *
  * @param device Device to match against
  * @param outDriver Optional pointer to a match info structure that will be filled in on match
  *
@@ -50,13 +68,36 @@ void DriverDb::loadFullDb() {
 std::shared_ptr<Driver> DriverDb::findDriver(const std::shared_ptr<Device> &device,
         MatchInfo *outDriver) {
     std::priority_queue<MatchInfo> mi;
+    std::vector<MatchKey> keys;
+    std::vector<uintptr_t> candidates;
 
-    // check all drivers to see if they match
+    const MatchDevice match(device);
+    GetDeviceKeys(match, keys);
+
+    // collect candidates from the index
     this->driversLock.lock_shared();
 
-    for(const auto &[key, driver] : this->drivers) {
+    for(const auto &key : keys) {
+        auto it = this->index.find(key);
+        if(it == this->index.end()) continue;
+
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+    candidates.insert(candidates.end(), this->unindexed.begin(), this->unindexed.end());
+
+    // a driver may be found under multiple keys; test each only once
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    if(kLogCandidates) Trace("%lu candidate(s) for %s (%lu keys, %lu drivers)", candidates.size(),
+            device->getPrimaryName().c_str(), keys.size(), this->drivers.size());
+
+    // check the candidates to see if they match
+    for(const auto id : candidates) {
+        const auto &driver = this->drivers.at(id).driver;
+
         int score{0};
-        if(driver->test(device, score)) {
+        if(driver->test(match, score)) {
             mi.emplace(driver, score);
         }
     }
@@ -71,13 +112,37 @@ std::shared_ptr<Driver> DriverDb::findDriver(const std::shared_ptr<Device> &devi
     return best.driver;
 }
 
+/**
+ * Produces the index keys for a device. These are all of its driver names (without auxiliary
+ * info) and, for PCI devices, the class, subclass, vendor and product ids.
+ */
+void DriverDb::GetDeviceKeys(const MatchDevice &device, std::vector<MatchKey> &keys) {
+    for(const auto &name : device.device->getDriverNames()) {
+        const auto end = name.find_first_of('@');
+        keys.emplace_back((end != std::string::npos) ? name.substr(0, end) : name);
+    }
+
+    if(const auto &pci = device.pci) {
+        keys.emplace_back(MatchKey::Type::PciClass, pci->classId);
+        keys.emplace_back(MatchKey::Type::PciSubclass, pci->subclassId);
+        keys.emplace_back(MatchKey::Type::PciVendor, pci->vid);
+        keys.emplace_back(MatchKey::Type::PciDevice,
+                (static_cast<uint32_t>(pci->vid) << 16) | pci->pid);
+    }
+}
+
 
 /**
- * Register new driver.
+ * Register new driver, and insert it into the index under all of its keys.
  *
  * @return ID of the newly inserted driver.
  */
 uintptr_t DriverDb::addDriver(const std::shared_ptr<Driver> &driver) {
+    Entry entry{driver, {}};
+    if(!driver->getKeys(entry.keys)) {
+        entry.keys.clear();
+    }
+
     // acquire lock, get id
     this->driversLock.lock();
 
@@ -87,8 +152,17 @@ again:;
         goto again;
     }
 
+    // index it
+    if(entry.keys.empty()) {
+        this->unindexed.push_back(id);
+    } else {
+        for(const auto &key : entry.keys) {
+            this->index[key].push_back(id);
+        }
+    }
+
     // inscrete
-    this->drivers.emplace(id, driver);
+    this->drivers.emplace(id, std::move(entry));
 
     // clean up
     this->driversLock.unlock();
@@ -102,8 +176,31 @@ again:;
  */
 bool DriverDb::removeDriver(const uintptr_t id) {
     this->driversLock.lock();
-    const auto nRemoved = this->drivers.erase(id);
+
+    auto it = this->drivers.find(id);
+    if(it == this->drivers.end()) {
+        this->driversLock.unlock();
+        return false;
+    }
+
+    // remove it from the index
+    auto removeId = [id](std::vector<uintptr_t> &ids) {
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    };
+
+    const auto &keys = it->second.keys;
+    if(keys.empty()) {
+        removeId(this->unindexed);
+    } else {
+        for(const auto &key : keys) {
+            auto &ids = this->index[key];
+            removeId(ids);
+            if(ids.empty()) this->index.erase(key);
+        }
+    }
+
+    this->drivers.erase(it);
     this->driversLock.unlock();
 
-    return (nRemoved == 1);
+    return true;
 }
@@ -10,12 +10,16 @@
 #include <string_view>
 #include <shared_mutex>
 #include <span>
+#include <vector>
+
+#include "MatchKey.h"
 
 class Device;
 class Driver;
+struct MatchDevice;
 
 /**
- * Maintains a repository of all drivers in the system and a;;pws qieruomg for the correct drivers
+ * Maintains a repository of all drivers in the system and allows querying for the correct drivers
  * to load for a particular device.
  */
 class DriverDb {
@@ -23,6 +27,13 @@ class DriverDb {
     constexpr static const std::string_view kBootDbPath{"/config/DriverDb.toml"};
     /// Filesystem path to the driver database with the full system booted
     constexpr static const std::string_view kFullDbPath{"/config/FullDriverDb.toml"};
+    /// Filesystem path to the compiled early boot driver database
+    constexpr static const std::string_view kBootCompiledDbPath{"/config/DriverDb.bin"};
+    /// Filesystem path to the compiled full driver database
+    constexpr static const std::string_view kFullCompiledDbPath{"/config/FullDriverDb.bin"};
+
+    /// Whether the candidate drivers for a device are logged
+    constexpr static const bool kLogCandidates{false};
 
     public:
         /**
@@ -66,17 +77,35 @@ class DriverDb {
         /// Removes an existing driver.
         bool removeDriver(const uintptr_t id);
 
+    private:
+        /// Information on a registered driver
+        struct Entry {
+            std::shared_ptr<Driver> driver;
+            /// keys under which the driver is indexed; if empty, it's in the unindexed list
+            std::vector<MatchKey> keys;
+        };
+
     private:
         DriverDb();
 
+        /// Loads a driver database, preferring the compiled form if it exists.
+        bool load(const std::string_view &compiledPath, const std::string_view &textPath);
+
+        /// Gets all index keys produced by the device.
+        static void GetDeviceKeys(const MatchDevice &, std::vector<MatchKey> &);
+
     private:
         static DriverDb * _Nonnull gShared;
 
     private:
-        /// Lock over the drivers list
+        /// Lock over the drivers list and index
         std::shared_mutex driversLock;
         /// all registered drivers
-        std::unordered_map<uintptr_t, std::shared_ptr<Driver>> drivers;
+        std::unordered_map<uintptr_t, Entry> drivers;
+        /// Maps each index key to the ids of drivers with matches using that key
+        std::unordered_map<MatchKey, std::vector<uintptr_t>, MatchKey::Hash> index;
+        /// Drivers that cannot be indexed, and must be tested against every device
+        std::vector<uintptr_t> unindexed;
         /// ID for the next driver
         uintptr_t nextId = 1;
 };
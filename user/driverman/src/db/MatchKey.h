@@ -0,0 +1,53 @@
+#ifndef DB_MATCHKEY_H
+#define DB_MATCHKEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * Keys are used to index the driver database: each match descriptor produces one or more keys
+ * that a device must also produce for the match to have any chance of succeeding. Matching a
+ * device then only requires testing the drivers found under the device's keys.
+ */
+struct MatchKey {
+    enum class Type: uint8_t {
+        /// Device driver name (auxiliary info removed)
+        Name,
+        /// PCI class id
+        PciClass,
+        /// PCI subclass id
+        PciSubclass,
+        /// PCI vendor id
+        PciVendor,
+        /// PCI vendor and product id (vid in the high 16 bits)
+        PciDevice,
+    };
+
+    /// What kind of key this is
+    Type type;
+    /// Numeric key value; unused for name keys
+    uint32_t value{0};
+    /// Name for name keys
+    std::string name;
+
+    MatchKey(const Type _type, const uint32_t _value) : type(_type), value(_value) {}
+    MatchKey(const std::string &_name) : type(Type::Name), name(_name) {}
+
+    bool operator==(const MatchKey &k) const {
+        return this->type == k.type && this->value == k.value && this->name == k.name;
+    }
+
+    /// Hash function for use with unordered containers
+    struct Hash {
+        size_t operator()(const MatchKey &k) const {
+            if(k.type == Type::Name) {
+                return std::hash<std::string>{}(k.name);
+            }
+            return (static_cast<size_t>(k.type) << 32) | k.value;
+        }
+    };
+};
+
+#endif
@@ -9,6 +9,8 @@
 
 #include <stdexcept>
 
+#include <sys/syscalls.h>
+
 /**
  * Splits a comma separated list of driver names into an ordered list. The list may contain only a
  * single entry, but it may not be empty.
@@ -58,6 +60,39 @@ void Device::didReforest(const std::shared_ptr<Forest::Leaf> &leaf) {
 
 
 
+/**
+ * Adds a property observer. If the thread is already observing this device, its notification bits
+ * are replaced.
+ */
+void Device::addPropertyObserver(const uintptr_t thread, const uintptr_t bits) {
+    this->propertyObservers[thread] = bits;
+}
+
+/**
+ * Removes the property observer for the given thread.
+ */
+void Device::removePropertyObserver(const uintptr_t thread) {
+    this->propertyObservers.erase(thread);
+}
+
+/**
+ * Sends a notification to every property observer. Observers whose threads no longer exist are
+ * removed.
+ */
+void Device::propertiesChanged() {
+    for(auto it = this->propertyObservers.begin(); it != this->propertyObservers.end();) {
+        const auto [thread, bits] = *it;
+
+        int err = NotificationSend(thread, bits);
+        if(err) {
+            Warn("Failed to notify property observer $%p: %d", thread, err);
+            it = this->propertyObservers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 /**
  * If the device is in the forest, return its path.
  */
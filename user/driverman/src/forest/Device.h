@@ -76,10 +76,13 @@ class Device: public std::enable_shared_from_this<Device> {
             } else {
                 this->properties[key] = data;
             }
+            this->propertiesChanged();
         }
         /// Deletes the given property, if it exists.
         void removeProperty(const std::string &key) {
-            this->properties.erase(key);
+            if(this->properties.erase(key)) {
+                this->propertiesChanged();
+            }
         }
         /// Tests if the given property exists.
         bool hasProperty(const std::string &key) const {
@@ -93,6 +96,11 @@ class Device: public std::enable_shared_from_this<Device> {
             return this->properties.at(key);
         }
 
+        /// Notifies the given thread with the given bits when properties change.
+        void addPropertyObserver(const uintptr_t thread, const uintptr_t bits);
+        /// Removes a property observer previously added for the given thread.
+        void removePropertyObserver(const uintptr_t thread);
+
         /// Sets the driver associated with the device.
         void setDriver(const std::shared_ptr<DriverInstance> &newDriver) {
             this->driver = newDriver;
@@ -115,6 +123,9 @@ class Device: public std::enable_shared_from_this<Device> {
         /// Splits the given driver match string into an ordered list.
         static void SplitDriverName(const std::string_view &, std::vector<std::string> &);
 
+        /// Notifies all property observers that a property changed.
+        void propertiesChanged();
+
     protected:
         /// If the device is in the forest, the leaf it is stored under
         std::weak_ptr<Forest::Leaf> leaf;
@@ -126,6 +137,8 @@ class Device: public std::enable_shared_from_this<Device> {
 
         /// Key/value properties associated with the device
         std::unordered_map<std::string, ByteVec> properties;
+        /// Threads to notify when properties change, and the notification bits to send them
+        std::unordered_map<uintptr_t, uintptr_t> propertyObservers;
 };
 
 #endif
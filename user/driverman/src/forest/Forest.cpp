@@ -5,7 +5,6 @@
 #include "util/String.h"
 
 #include <stdexcept>
-#include <sstream>
 
 Forest *Forest::gShared = nullptr;
 
@@ -15,6 +14,7 @@ Forest *Forest::gShared = nullptr;
 Forest::Forest() {
     // create the root node
     this->root = std::make_shared<Leaf>();
+    this->paths.emplace(kPathSeparator, this->root);
 }
 
 /**
@@ -39,10 +39,13 @@ bool Forest::insertDevice(const std::string_view &path, const std::shared_ptr<De
 
     // check if the desired name would conflict
     desiredName = dev->getPrimaryName();
-    for(const auto &child : *parent) {
-        if(child->name == desiredName) {
-            Abort("TODO: handle naming conflicts!");
-        }
+
+    auto childPath = (parent == this->root) ? std::string() : parent->getPath();
+    childPath.append(kPathSeparator);
+    childPath.append(desiredName);
+
+    if(this->paths.contains(childPath)) {
+        Abort("TODO: handle naming conflicts!");
     }
 
     // if not, create the object
@@ -53,6 +56,7 @@ bool Forest::insertDevice(const std::string_view &path, const std::shared_ptr<De
 
     // and store its path
     outPath = leaf->getPath();
+    this->paths.emplace(outPath, leaf);
 
     // try matching a driver if not already assigned
     if(loadDriver && !dev->hasDriver()) {
@@ -99,43 +103,31 @@ void Forest::startDriversOn(const std::shared_ptr<Leaf> &leaf) {
 }
 
 /**
- * Searches the forest for a node with the given path.
+ * Searches the forest for a node with the given path. This is a single lookup in the path index.
  */
-bool Forest::find(const std::string_view &_path, std::shared_ptr<Forest::Leaf> &outLeaf) {
-    // empty string or just a separator indicate the root of the tree
-    if(_path.empty() || _path == kPathSeparator) {
-        outLeaf = this->root;
-        return true;
-    }
+bool Forest::find(const std::string_view &path, std::shared_ptr<Forest::Leaf> &outLeaf) {
+    auto it = this->paths.find(NormalizePath(path));
+    if(it == this->paths.end()) return false;
 
-    // we gotta iterate the path now :D
+    outLeaf = it->second;
+    return true;
+}
+
+/**
+ * Converts the given path to the form produced by `Leaf::getPath()`: that is, it always starts
+ * with a separator, but never ends with one. An empty path refers to the root.
+ */
+std::string Forest::NormalizePath(const std::string_view &_path) {
     std::string path(_path);
-    auto leaf = this->root;
 
-    if(path[0] == '/') {
-        path = path.substr(1);
+    while(path.size() > 1 && path.back() == kPathSeparator[0]) {
+        path.pop_back();
     }
-
-    std::stringstream stream{path};
-    std::string name;
-
-    while(std::getline(stream, name, '/')) {
-        // search the leaf's children for one with this name
-        for(const auto &child : *leaf) {
-            if(child->name == name) {
-                leaf = child;
-                goto mcdonalds;
-            }
-        }
-        return false;
-
-        // check next component
-mcdonalds:;
+    if(path.empty() || path[0] != kPathSeparator[0]) {
+        path.insert(0, kPathSeparator);
     }
 
-    // return the leaf
-    outLeaf = leaf;
-    return true;
+    return path;
 }
 
 /**
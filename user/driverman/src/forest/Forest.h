@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 class Device;
 
@@ -84,6 +85,9 @@ class Forest {
 
         void startDriversOn(const std::shared_ptr<Leaf> &ptr);
 
+        /// Converts a path to the form used as key in the path index.
+        static std::string NormalizePath(const std::string_view &path);
+
         /// Associates the given device to the given leaf.
         static void UpdateLeafDev(const std::shared_ptr<Device> &, const std::shared_ptr<Leaf> &);
 
@@ -93,6 +97,8 @@ class Forest {
     private:
         /// root element of the tree
         std::shared_ptr<Leaf> root;
+        /// maps the full path of every leaf (including the root) to the leaf
+        std::unordered_map<std::string, std::shared_ptr<Leaf>> paths;
 };
 
 #endif
@@ -1,6 +1,6 @@
 /*
  * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
- * Generated from Driverman.idl for interface Driverman at 2021-06-26T17:21:35-0500
+ * Generated from Driverman.idl for interface Driverman at 2026-10-18T05:57:57-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -188,6 +188,77 @@ Client::GetDevicePropertyReturn Client::GetDeviceProperty(const std::string &pat
 
     }
 }
+/*
+ * Autogenerated call method for 'GetDeviceProperties' (id $12bedcce3bab3d75)
+ * Have 2 parameter(s), 2 return(s); method is sync
+ */
+Client::GetDevicePropertiesReturn Client::GetDeviceProperties(const std::string &path, const std::vector<std::byte> &keys) {
+    uint32_t sentTag;
+    {
+        internals::GetDevicePropertiesRequest request;
+        request.path = path;
+        request.keys = keys;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::GetDeviceProperties), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::GetDeviceProperties)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::GetDevicePropertiesResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        GetDevicePropertiesReturn r;
+        r.status =  reply.status;
+        r.data =  reply.data;
+        return r;
+
+    }
+}
+/*
+ * Autogenerated call method for 'SubscribeDeviceProperties' (id $42c957a1f8d67101)
+ * Have 3 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::SubscribeDeviceProperties(const std::string &path, uint64_t thread, uint64_t bits) {
+    uint32_t sentTag;
+    {
+        internals::SubscribeDevicePropertiesRequest request;
+        request.path = path;
+        request.thread = thread;
+        request.bits = bits;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::SubscribeDeviceProperties), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::SubscribeDeviceProperties)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::SubscribeDevicePropertiesResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
 /*
  * Autogenerated call method for 'StartDevice' (id $6a7cbf9e2efa75f0)
  * Have 1 parameter(s), 1 return(s); method is sync
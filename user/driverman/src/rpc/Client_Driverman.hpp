@@ -1,6 +1,6 @@
 /*
  * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
- * Generated from Driverman.idl for interface Driverman at 2021-06-26T17:21:35-0500
+ * Generated from Driverman.idl for interface Driverman at 2026-10-18T05:57:57-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -48,6 +48,11 @@ class DrivermanClient {
             int32_t status;
             std::vector<std::byte> data;
         };
+        // Return types for method 'GetDeviceProperties'
+        struct GetDevicePropertiesReturn {
+            int32_t status;
+            std::vector<std::byte> data;
+        };
 
     public:
         DrivermanClient(const std::shared_ptr<IoStream> &stream);
@@ -56,6 +61,8 @@ class DrivermanClient {
         virtual std::string AddDevice(const std::string &parent, const std::string &driverId);
         virtual int32_t SetDeviceProperty(const std::string &path, const std::string &key, const std::vector<std::byte> &data);
         virtual GetDevicePropertyReturn GetDeviceProperty(const std::string &path, const std::string &key);
+        virtual GetDevicePropertiesReturn GetDeviceProperties(const std::string &path, const std::vector<std::byte> &keys);
+        virtual int32_t SubscribeDeviceProperties(const std::string &path, uint64_t thread, uint64_t bits);
         virtual int32_t StartDevice(const std::string &path);
         virtual int32_t StopDevice(const std::string &path);
         virtual int32_t Notify(const std::string &path, uint64_t key);
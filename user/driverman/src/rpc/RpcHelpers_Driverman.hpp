@@ -1,6 +1,6 @@
 /*
  * This RPC serialization code was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
- * Generated from Driverman.idl for interface Driverman at 2021-06-26T17:21:35-0500
+ * Generated from Driverman.idl for interface Driverman at 2026-10-18T05:57:57-0500
  *
  * The structs and methods within are used by the RPC system to serialize and deserialize the
  * arguments and return values on method calls. They work internally in the same way that encoding
@@ -92,6 +92,8 @@ enum class Type: uint64_t {
                                            AddDevice = 0xe2cd5678129683feULL,
                                    SetDeviceProperty = 0x4fe09a246da305bcULL,
                                    GetDeviceProperty = 0xfaac446645be5520ULL,
+                                 GetDeviceProperties = 0x12bedcce3bab3d75ULL,
+                           SubscribeDeviceProperties = 0x42c957a1f8d67101ULL,
                                          StartDevice = 0x6a7cbf9e2efa75f0ULL,
                                           StopDevice = 0xee8b158787490a80ULL,
                                               Notify = 0x63ce1044c4349828ULL,
@@ -194,6 +196,72 @@ struct GetDevicePropertyResponse {
     constexpr static const size_t kBlobStartOffset{16};
 };
 
+/**
+ * Request structure for method 'GetDeviceProperties'
+ */
+struct GetDevicePropertiesRequest {
+    std::string path;
+    std::vector<std::byte> keys;
+
+    constexpr static const size_t kElementSizes[2] {
+     8,  8
+    };
+    constexpr static const size_t kElementOffsets[2] {
+     0,  8
+    };
+    constexpr static const size_t kScalarBytes{16};
+    constexpr static const size_t kBlobStartOffset{16};
+};
+/**
+ * Reply structure for method 'GetDeviceProperties'
+ */
+struct GetDevicePropertiesResponse {
+    int32_t status;
+    std::vector<std::byte> data;
+
+    constexpr static const size_t kElementSizes[2] {
+     4,  8
+    };
+    constexpr static const size_t kElementOffsets[2] {
+     0,  4
+    };
+    constexpr static const size_t kScalarBytes{12};
+    constexpr static const size_t kBlobStartOffset{16};
+};
+
+/**
+ * Request structure for method 'SubscribeDeviceProperties'
+ */
+struct SubscribeDevicePropertiesRequest {
+    std::string path;
+    uint64_t thread;
+    uint64_t bits;
+
+    constexpr static const size_t kElementSizes[3] {
+     8,  8,  8
+    };
+    constexpr static const size_t kElementOffsets[3] {
+     0,  8, 16
+    };
+    constexpr static const size_t kScalarBytes{24};
+    constexpr static const size_t kBlobStartOffset{24};
+};
+/**
+ * Reply structure for method 'SubscribeDeviceProperties'
+ */
+struct SubscribeDevicePropertiesResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
 /**
  * Request structure for method 'StartDevice'
  */
@@ -680,6 +748,246 @@ inline bool deserialize(const std::span<std::byte> &in, internals::GetDeviceProp
     return true;
 }
 
+inline size_t bytesFor(const internals::GetDevicePropertiesRequest &x) {
+    using namespace internals;
+    size_t len = GetDevicePropertiesRequest::kBlobStartOffset;
+    len += bytesFor(x.path);
+    len += bytesFor(x.keys);
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::GetDevicePropertiesRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = GetDevicePropertiesRequest::kBlobStartOffset;
+    {
+        const auto off = GetDevicePropertiesRequest::kElementOffsets[0];
+        const auto size = GetDevicePropertiesRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.path);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.path)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+    {
+        const auto off = GetDevicePropertiesRequest::kElementOffsets[1];
+        const auto size = GetDevicePropertiesRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.keys);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.keys)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::GetDevicePropertiesRequest &x) {
+    using namespace internals;
+    if(in.size() < GetDevicePropertiesRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(GetDevicePropertiesRequest::kBlobStartOffset);
+    {
+        const auto off = GetDevicePropertiesRequest::kElementOffsets[0];
+        const auto size = GetDevicePropertiesRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.path)) {
+            HandleDecodeError("GetDevicePropertiesRequest", "path", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+    {
+        const auto off = GetDevicePropertiesRequest::kElementOffsets[1];
+        const auto size = GetDevicePropertiesRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.keys)) {
+            HandleDecodeError("GetDevicePropertiesRequest", "keys", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::GetDevicePropertiesResponse &x) {
+    using namespace internals;
+    size_t len = GetDevicePropertiesResponse::kBlobStartOffset;
+    len += bytesFor(x.data);
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::GetDevicePropertiesResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = GetDevicePropertiesResponse::kBlobStartOffset;
+    {
+        const auto off = GetDevicePropertiesResponse::kElementOffsets[0];
+        const auto size = GetDevicePropertiesResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+    {
+        const auto off = GetDevicePropertiesResponse::kElementOffsets[1];
+        const auto size = GetDevicePropertiesResponse::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.data);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.data)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::GetDevicePropertiesResponse &x) {
+    using namespace internals;
+    if(in.size() < GetDevicePropertiesResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(GetDevicePropertiesResponse::kBlobStartOffset);
+    {
+        const auto off = GetDevicePropertiesResponse::kElementOffsets[0];
+        const auto size = GetDevicePropertiesResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+    {
+        const auto off = GetDevicePropertiesResponse::kElementOffsets[1];
+        const auto size = GetDevicePropertiesResponse::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.data)) {
+            HandleDecodeError("GetDevicePropertiesResponse", "data", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SubscribeDevicePropertiesRequest &x) {
+    using namespace internals;
+    size_t len = SubscribeDevicePropertiesRequest::kBlobStartOffset;
+    len += bytesFor(x.path);
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SubscribeDevicePropertiesRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = SubscribeDevicePropertiesRequest::kBlobStartOffset;
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[0];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.path);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.path)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[1];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.thread, range.size());
+    }
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[2];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[2];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.bits, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SubscribeDevicePropertiesRequest &x) {
+    using namespace internals;
+    if(in.size() < SubscribeDevicePropertiesRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SubscribeDevicePropertiesRequest::kBlobStartOffset);
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[0];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.path)) {
+            HandleDecodeError("SubscribeDevicePropertiesRequest", "path", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[1];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.thread, range.data(), range.size());
+    }
+    {
+        const auto off = SubscribeDevicePropertiesRequest::kElementOffsets[2];
+        const auto size = SubscribeDevicePropertiesRequest::kElementSizes[2];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.bits, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SubscribeDevicePropertiesResponse &x) {
+    using namespace internals;
+    size_t len = SubscribeDevicePropertiesResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SubscribeDevicePropertiesResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = SubscribeDevicePropertiesResponse::kBlobStartOffset;
+    {
+        const auto off = SubscribeDevicePropertiesResponse::kElementOffsets[0];
+        const auto size = SubscribeDevicePropertiesResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SubscribeDevicePropertiesResponse &x) {
+    using namespace internals;
+    if(in.size() < SubscribeDevicePropertiesResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SubscribeDevicePropertiesResponse::kBlobStartOffset);
+    {
+        const auto off = SubscribeDevicePropertiesResponse::kElementOffsets[0];
+        const auto size = SubscribeDevicePropertiesResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
 inline size_t bytesFor(const internals::StartDeviceRequest &x) {
     using namespace internals;
     size_t len = StartDeviceRequest::kBlobStartOffset;
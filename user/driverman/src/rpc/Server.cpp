@@ -8,8 +8,11 @@
 #include "util/String.h"
 
 #include <driver/DrivermanClient.h>
+#include <mpack/mpack.h>
 #include <rpc/rt/ServerPortRpcStream.h>
 
+#include <cstdlib>
+
 RpcServer *RpcServer::gShared{nullptr};
 
 /**
@@ -84,7 +87,8 @@ int32_t RpcServer::implSetDeviceProperty(const std::string &path, const std::str
  * @param path Path of the device to get the property from
  * @param key Key to retrieve the data of
  *
- * @return Data associated with the key, or an zero byte blob if not found.
+ * @return Data associated with the key; if the device has no such property, the status is
+ *         `NoSuchProperty`.
  */
 RpcServer::GetDevicePropertyReturn RpcServer::implGetDeviceProperty(const std::string &path,
         const std::string &key) {
@@ -98,7 +102,108 @@ RpcServer::GetDevicePropertyReturn RpcServer::implGetDeviceProperty(const std::s
     if(device->hasProperty(key)) {
         return {0, device->getProperty(key)};
     }
-    return {0, {}};
+    return { Errors::NoSuchProperty };
+}
+
+/**
+ * Gets the values of multiple device properties in one go.
+ *
+ * @param path Path of the device to get the properties from
+ * @param keys Msgpack encoded array of property key strings
+ *
+ * @return A msgpack encoded map of key to value for all keys that exist on the device
+ */
+RpcServer::GetDevicePropertiesReturn RpcServer::implGetDeviceProperties(const std::string &path,
+        const std::vector<std::byte> &keys) {
+    auto device = Forest::the()->getDevice(path);
+    if(!device) {
+        Warn("Failed to get device at '%s' to get properties", path.c_str());
+        return { Errors::NoSuchDevice };
+    }
+
+    // decode the requested keys
+    std::vector<std::string> names;
+
+    mpack_tree_t tree;
+    mpack_tree_init_data(&tree, reinterpret_cast<const char *>(keys.data()), keys.size());
+    mpack_tree_parse(&tree);
+
+    mpack_node_t root = mpack_tree_root(&tree);
+    const auto numKeys = mpack_node_array_length(root);
+    names.reserve(numKeys);
+
+    for(size_t i = 0; i < numKeys; i++) {
+        auto node = mpack_node_array_at(root, i);
+        names.emplace_back(mpack_node_str(node), mpack_node_strlen(node));
+    }
+
+    auto status = mpack_tree_destroy(&tree);
+    if(status != mpack_ok) {
+        Warn("%s failed: %d", "mpack_tree_destroy", status);
+        return { Errors::InvalidRequest };
+    }
+
+    // build the reply map
+    size_t numFound{0};
+    for(const auto &key : names) {
+        if(device->hasProperty(key)) numFound++;
+    }
+
+    char *data;
+    size_t size;
+
+    mpack_writer_t writer;
+    mpack_writer_init_growable(&writer, &data, &size);
+    mpack_start_map(&writer, numFound);
+
+    for(const auto &key : names) {
+        if(!device->hasProperty(key)) continue;
+        const auto value = device->getProperty(key);
+
+        mpack_write_str(&writer, key.data(), key.length());
+        mpack_write_bin(&writer, reinterpret_cast<const char *>(value.data()), value.size());
+    }
+
+    mpack_finish_map(&writer);
+
+    status = mpack_writer_destroy(&writer);
+    if(status != mpack_ok) {
+        Warn("%s failed: %d", "mpack_writer_destroy", status);
+        return { Errors::InvalidRequest };
+    }
+
+    if(kLogProperties) Trace("%s: Get %lu properties (%lu found)", path.c_str(), names.size(),
+            numFound);
+
+    std::vector<std::byte> out(reinterpret_cast<std::byte *>(data),
+            reinterpret_cast<std::byte *>(data + size));
+    free(data);
+
+    return {0, std::move(out)};
+}
+
+/**
+ * Registers a thread to be notified when any properties on the device change.
+ *
+ * @param path Path of the device whose properties are to be observed
+ * @param thread Handle of the thread to notify
+ * @param bits Notification bits to send; if zero, any existing subscription is removed
+ */
+int32_t RpcServer::implSubscribeDeviceProperties(const std::string &path, uint64_t thread,
+        uint64_t bits) {
+    auto device = Forest::the()->getDevice(path);
+    if(!device) {
+        Warn("Failed to get device at '%s' to subscribe", path.c_str());
+        return Errors::NoSuchDevice;
+    }
+
+    if(bits) {
+        device->addPropertyObserver(thread, bits);
+    } else {
+        device->removePropertyObserver(thread);
+    }
+
+    return 0;
 }
 
 
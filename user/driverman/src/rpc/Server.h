@@ -20,6 +20,10 @@ class RpcServer: public rpc::DrivermanServer {
             InvalidPath                 = -90000,
             /// No device was found at the given path
             NoSuchDevice                = -90001,
+            /// The request could not be decoded
+            InvalidRequest              = -90002,
+            /// The device has no property with the given key
+            NoSuchProperty              = -90003,
         };
 
         /// Initialize the global RPC server instance
@@ -32,6 +36,8 @@ class RpcServer: public rpc::DrivermanServer {
         std::string implAddDevice(const std::string &parent, const std::string &driverId) override;
         int32_t implSetDeviceProperty(const std::string &path, const std::string &key, const std::vector<std::byte> &data) override;
         GetDevicePropertyReturn implGetDeviceProperty(const std::string &path, const std::string &key) override;
+        GetDevicePropertiesReturn implGetDeviceProperties(const std::string &path, const std::vector<std::byte> &keys) override;
+        int32_t implSubscribeDeviceProperties(const std::string &path, uint64_t thread, uint64_t bits) override;
 
         int32_t implStartDevice(const std::string &path) override;
         int32_t implStopDevice(const std::string &path) override;
@@ -1,6 +1,6 @@
 /*
  * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
- * Generated from Driverman.idl for interface Driverman at 2021-06-26T17:21:35-0500
+ * Generated from Driverman.idl for interface Driverman at 2026-10-18T05:57:57-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -80,6 +80,12 @@ bool Server::runOne(const bool block) {
         case static_cast<uint64_t>(internals::Type::GetDeviceProperty):
             this->_marshallGetDeviceProperty(*hdr, payload);
             break;
+        case static_cast<uint64_t>(internals::Type::GetDeviceProperties):
+            this->_marshallGetDeviceProperties(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::SubscribeDeviceProperties):
+            this->_marshallSubscribeDeviceProperties(*hdr, payload);
+            break;
         case static_cast<uint64_t>(internals::Type::StartDevice):
             this->_marshallStartDevice(*hdr, payload);
             break;
@@ -202,6 +208,51 @@ void Server::_marshallGetDeviceProperty(const MessageHeader &hdr, const std::spa
 
     this->_sendReply(hdr, numBytes);
 }
+/*
+ * Autogenerated marshalling method for 'GetDeviceProperties' (id $12bedcce3bab3d75)
+ * Have 2 parameter(s), 2 return(s); method is sync
+ */
+void Server::_marshallGetDeviceProperties(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::GetDevicePropertiesRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implGetDeviceProperties(request.path, request.keys);
+
+    internals::GetDevicePropertiesResponse reply;
+    reply.status = retVal.status;
+    reply.data = retVal.data;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'SubscribeDeviceProperties' (id $42c957a1f8d67101)
+ * Have 3 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallSubscribeDeviceProperties(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::SubscribeDevicePropertiesRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implSubscribeDeviceProperties(request.path, request.thread, request.bits);
+
+    internals::SubscribeDevicePropertiesResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
 /*
  * Autogenerated marshalling method for 'StartDevice' (id $6a7cbf9e2efa75f0)
  * Have 1 parameter(s), 1 return(s); method is sync
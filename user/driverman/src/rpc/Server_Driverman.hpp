@@ -1,6 +1,6 @@
 /*
  * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
- * Generated from Driverman.idl for interface Driverman at 2021-06-26T17:21:35-0500
+ * Generated from Driverman.idl for interface Driverman at 2026-10-18T05:57:57-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -46,6 +46,11 @@ class DrivermanServer {
             int32_t status;
             std::vector<std::byte> data;
         };
+        // Return types for method 'GetDeviceProperties'
+        struct GetDevicePropertiesReturn {
+            int32_t status;
+            std::vector<std::byte> data;
+        };
 
     public:
         DrivermanServer(const std::shared_ptr<IoStream> &stream);
@@ -61,6 +66,8 @@ class DrivermanServer {
         virtual std::string implAddDevice(const std::string &parent, const std::string &driverId) = 0;
         virtual int32_t implSetDeviceProperty(const std::string &path, const std::string &key, const std::vector<std::byte> &data) = 0;
         virtual GetDevicePropertyReturn implGetDeviceProperty(const std::string &path, const std::string &key) = 0;
+        virtual GetDevicePropertiesReturn implGetDeviceProperties(const std::string &path, const std::vector<std::byte> &keys) = 0;
+        virtual int32_t implSubscribeDeviceProperties(const std::string &path, uint64_t thread, uint64_t bits) = 0;
         virtual int32_t implStartDevice(const std::string &path) = 0;
         virtual int32_t implStopDevice(const std::string &path) = 0;
         virtual int32_t implNotify(const std::string &path, uint64_t key) = 0;
@@ -86,6 +93,8 @@ class DrivermanServer {
         void _marshallAddDevice(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallSetDeviceProperty(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallGetDeviceProperty(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallGetDeviceProperties(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallSubscribeDeviceProperties(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallStartDevice(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallStopDevice(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallNotify(const MessageHeader &, const std::span<std::byte> &payload);
@@ -1,7 +1,9 @@
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include <driver/DrivermanClient.h>
+#include <driver/ThreadPool.h>
 #include <DriverSupport/disk/Client.h>
 
 #include "FilesystemRegistry.h"
@@ -12,6 +14,63 @@
 
 const char *gLogTag = "fs";
 
+/**
+ * A filesystem that was started on a partition of a disk
+ */
+struct StartedFs {
+    std::shared_ptr<DriverSupport::disk::Disk> disk;
+    PartitionTable::Partition partition;
+    std::shared_ptr<Filesystem> fs;
+};
+
+/**
+ * Opens the disk at the given forest path, reads its partition table, and tries to start a
+ * filesystem on each of its partitions.
+ *
+ * @param outStarted All filesystems that were started are appended to this vector.
+ */
+static void AttachDisk(const char *path, std::vector<StartedFs> &outStarted) {
+    int err;
+
+    // create disk object
+    std::shared_ptr<DriverSupport::disk::Disk> disk;
+    err = DriverSupport::disk::Disk::Alloc(path, disk);
+    if(err) {
+        Warn("Failed to allocate disk from '%s': %d", path, err);
+        return;
+    }
+
+    Success("Opened drive: %s", disk->getForestPath().c_str());
+
+    // probe to see the partition table of this disk
+    std::shared_ptr<PartitionTable> tab;
+
+    err = GPT::Probe(disk, tab);
+    if(err) {
+        Warn("Failed to detect GPT on '%s': %d", path, err);
+        return;
+    }
+
+    // read the partition tables and try to initialize a filesystem for each
+    const auto &tabs = tab->getPartitions();
+    Success("Got %lu partitions", tabs.size());
+
+    for(const auto &p : tabs) {
+        // try to create FS
+        std::shared_ptr<Filesystem> fs;
+        err = FilesystemRegistry::the()->start(p.typeId, p, disk, fs);
+
+        if(!err) {
+            outStarted.push_back({disk, p, fs});
+        } else {
+            const auto &i = p.typeId;
+            Trace("Failed to initialize fs (%d) %10lu (%10lu sectors): %02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X - %s", err,
+                    p.startLba, p.size, i[0],i[1],i[2],i[3],i[4],i[5],i[6],i[7],i[8],i[9],i[10],
+                    i[11],i[12],i[13],i[14],i[15], p.name.value_or("(no name)").c_str());
+        }
+    }
+}
+
 /**
  * Entry point for the filesystem server, attached to a disk. The arguments to the function are
  * paths to disks to attach to.
@@ -28,48 +87,30 @@ int main(const int argc, const char **argv) {
 
     MessageLoop ml;
 
-    // for each argument, create a disk and probe the partition table
+    /*
+     * Attach to each disk in parallel, since probing partitions and starting filesystems mostly
+     * waits for disk IO. Partitions of the same disk are handled sequentially, as a disk client may
+     * only be used by one thread at a time.
+     */
+    std::vector<std::vector<StartedFs>> started(argc - 1);
+    auto pool = libdriver::ThreadPool::the();
+    libdriver::ThreadPool::TaskGroup attach;
+
     for(size_t i = 1; i < argc; i++) {
         const auto path = argv[i];
+        auto &out = started[i - 1];
 
-        // create disk object
-        std::shared_ptr<DriverSupport::disk::Disk> disk;
-        err = DriverSupport::disk::Disk::Alloc(path, disk);
-        if(err) {
-            Warn("Failed to allocate disk from '%s': %d", path, err);
-            continue;
-        }
-
-        Success("Opened drive: %s", disk->getForestPath().c_str());
-
-        // probe to see the partition table of this disk
-        std::shared_ptr<PartitionTable> tab;
-
-        err = GPT::Probe(disk, tab);
-        if(err) {
-            Warn("Failed to detect GPT on '%s': %d", path, err);
-            continue;
-        }
+        pool->submit(attach, [path, &out]{
+            AttachDisk(path, out);
+        });
+    }
 
-        // read the partition tables and try to initialize a filesystem for each
-        const auto &tabs = tab->getPartitions();
-        Success("Got %lu partitions", tabs.size());
-
-        for(const auto &p : tabs) {
-            // try to create FS
-            std::shared_ptr<Filesystem> fs;
-            err = FilesystemRegistry::the()->start(p.typeId, p, disk, fs);
-
-            if(!err) {
-                // add to automounter
-                Automount::the()->startedFs(disk, p, fs);
-            } else {
-                const auto &i = p.typeId;
-                Trace("Failed to initialize fs (%d) %10lu (%10lu sectors): %02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X - %s", err,
-                        p.startLba, p.size, i[0],i[1],i[2],i[3],i[4],i[5],i[6],i[7],i[8],i[9],i[10],
-                        i[11],i[12],i[13],i[14],i[15], p.name.value_or("(no name)").c_str());
-            }
+    pool->wait(attach);
 
+    // add the filesystems to the automounter in the order of the disks
+    for(const auto &disk : started) {
+        for(const auto &s : disk) {
+            Automount::the()->startedFs(s.disk, s.partition, s.fs);
         }
     }
 
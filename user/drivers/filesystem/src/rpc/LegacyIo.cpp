@@ -1,5 +1,6 @@
 #include "LegacyIo.h"
 #include "MessageLoop.h"
+#include "Pager.h"
 
 #include "Log.h"
 
@@ -8,6 +9,7 @@
 #include <rpc/FileIO.hpp>
 #include <sys/syscalls.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 
@@ -104,6 +106,19 @@ void LegacyIo::main() {
                     if(!packet->replyPort) continue;
                     this->handleReadDirect(msg, packet, err);
                     break;
+                case static_cast<uint32_t>(FileIoEpType::ReadFileScatter):
+                    if(!packet->replyPort) continue;
+                    this->handleReadScatter(msg, packet, err);
+                    break;
+
+                case static_cast<uint32_t>(FileIoEpType::MapFile):
+                    if(!packet->replyPort) continue;
+                    this->handleMap(msg, packet, err);
+                    break;
+                case static_cast<uint32_t>(FileIoEpType::UnmapFile):
+                    if(!packet->replyPort) continue;
+                    this->handleUnmap(msg, packet, err);
+                    break;
 
                 default:
                     Warn("Legacy io invalid msg type: $%08x", packet->type);
@@ -132,7 +147,7 @@ void LegacyIo::handleGetCaps(const struct MessageHeader *msg, const RpcPacket *p
     // send the reply
     FileIoGetCapsReply reply;
     reply.version = 1;
-    reply.capabilities = FileIoCaps::DirectIo;
+    reply.capabilities = FileIoCaps::DirectIo | FileIoCaps::MapFile | FileIoCaps::ScatterRead;
     reply.maxReadBlockSize = kMaxBlockSize;
 
     auto buf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
@@ -245,6 +260,85 @@ void LegacyIo::handleClose(const struct MessageHeader *msg, const RpcPacket *pac
     this->reply(packet, FileIoEpType::CloseFileReply, replyBuf);
 }
 
+/**
+ * Maps a range of an open file into memory. The pager creates a region backed by the file, which
+ * the caller then maps into its address space.
+ */
+void LegacyIo::handleMap(const struct MessageHeader *msg, const RpcPacket *packet,
+        const size_t msgLen) {
+    FileIoMapReqReply reply;
+    memset(&reply, 0, sizeof(reply));
+
+    auto replyBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
+
+    // deserialize the request
+    auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(data.size() < sizeof(FileIoMapReq)) {
+        reply.status = EINVAL;
+        return this->reply(packet, FileIoEpType::MapFileReply, replyBuf);
+    }
+    auto req = reinterpret_cast<const FileIoMapReq *>(data.data());
+
+    // convert the access flags
+    uintptr_t vmFlags{0};
+
+    if(TestFlags(req->flags & FileIoMapFlags::Read)) {
+        vmFlags |= VM_REGION_READ;
+    }
+    if(TestFlags(req->flags & FileIoMapFlags::Write)) {
+        vmFlags |= VM_REGION_WRITE;
+    }
+    if(TestFlags(req->flags & FileIoMapFlags::Execute)) {
+        vmFlags |= VM_REGION_EXEC;
+    }
+
+    if(!vmFlags) {
+        reply.status = EINVAL;
+        return this->reply(packet, FileIoEpType::MapFileReply, replyBuf);
+    }
+
+    // get the file
+    std::shared_ptr<FileBase> file;
+    {
+        std::lock_guard<std::mutex> lg(this->ml->openFilesLock);
+        if(this->ml->openFiles.contains(req->file)) {
+            file = this->ml->openFiles[req->file];
+        }
+    }
+
+    if(!file) {
+        reply.status = MessageLoop::Errors::InvalidFileHandle;
+        return this->reply(packet, FileIoEpType::MapFileReply, replyBuf);
+    }
+
+    // create the region
+    reply.status = this->ml->pager->map(file, req->offset, req->length, vmFlags, msg->senderTask,
+            reply.region, reply.length);
+    this->reply(packet, FileIoEpType::MapFileReply, replyBuf);
+}
+
+/**
+ * Releases a region created by an earlier map request.
+ */
+void LegacyIo::handleUnmap(const struct MessageHeader *msg, const RpcPacket *packet,
+        const size_t msgLen) {
+    FileIoUnmapReqReply reply;
+    memset(&reply, 0, sizeof(reply));
+
+    auto replyBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
+
+    // deserialize the request
+    auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(data.size() < sizeof(FileIoUnmapReq)) {
+        reply.status = EINVAL;
+        return this->reply(packet, FileIoEpType::UnmapFileReply, replyBuf);
+    }
+    auto req = reinterpret_cast<const FileIoUnmapReq *>(data.data());
+
+    reply.status = this->ml->pager->unmap(req->region, msg->senderTask);
+    this->reply(packet, FileIoEpType::UnmapFileReply, replyBuf);
+}
+
 /**
  * Handles an open request.
  */
@@ -256,20 +350,20 @@ void LegacyIo::handleReadDirect(const struct MessageHeader *msg, const RpcPacket
     auto reqData = std::span(packet->payload, msgLen - sizeof(RpcPacket));
     if(reqData.size() < sizeof(FileIoReadReq)) {
         // XXX: can we get the file handle?
-        return this->readFailed(0, EINVAL, packet);
+        return this->readFailed(0, 0, EINVAL, packet);
     }
 
     auto req = reinterpret_cast<const FileIoReadReq *>(reqData.data());
 
     if(req->length > kMaxBlockSize) {
-        return this->readFailed(req->file, EINVAL, packet);
+        return this->readFailed(req->file, req->tag, EINVAL, packet);
     }
 
     // forward request
     auto ret = this->ml->implSlowRead(req->file, req->offset, req->length);
 
     if(ret.status) {
-        return this->readFailed(req->file, ret.status, packet);
+        return this->readFailed(req->file, req->tag, ret.status, packet);
     }
 
     // fill out the reply buffer
@@ -284,6 +378,7 @@ void LegacyIo::handleReadDirect(const struct MessageHeader *msg, const RpcPacket
 
     reply->status = 0;
     reply->file = req->file;
+    reply->tag = req->tag;
     reply->dataLen = data.size();
     memcpy(reply->data, data.data(), data.size());
 
@@ -322,15 +417,116 @@ void LegacyIo::ensureReadReplyBufferSize(const size_t payloadBytes) {
 }
 
 /**
- * Sends a "read failed" message.
+ * Sends a "read failed" message. The status is always sent as a negative error code.
  */
-void LegacyIo::readFailed(const uintptr_t file, const int errno, const RpcPacket *packet) {
+void LegacyIo::readFailed(const uintptr_t file, const uint32_t tag, const int errno,
+        const RpcPacket *packet) {
     FileIoReadReqReply reply;
     memset(&reply, 0, sizeof(reply));
 
-    reply.status = errno;
+    reply.status = (errno > 0) ? -errno : errno;
     reply.file = file;
+    reply.tag = tag;
 
     auto replyBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
     this->reply(packet, FileIoEpType::ReadFileDirectReply, replyBuf);
 }
+
+
+
+/**
+ * Handles a scatter read request. Each segment is read individually, and the data of all of them
+ * is returned in a single reply.
+ *
+ * The total length of all segments is limited to the maximum block size, so the reply is no larger
+ * than that of a regular read.
+ */
+void LegacyIo::handleReadScatter(const struct MessageHeader *msg, const RpcPacket *packet,
+        const size_t msgLen) {
+    int err;
+
+    // deserialize the request and ensure length is ok
+    auto reqData = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(reqData.size() < sizeof(FileIoReadScatterReq)) {
+        return this->readScatterFailed(0, 0, EINVAL, packet);
+    }
+
+    auto req = reinterpret_cast<const FileIoReadScatterReq *>(reqData.data());
+    const size_t numSegments = req->numSegments;
+
+    if(!numSegments || numSegments > ((reqData.size() - sizeof(FileIoReadScatterReq)) /
+                sizeof(FileIoReadSegment))) {
+        return this->readScatterFailed(req->file, req->tag, EINVAL, packet);
+    }
+
+    uint64_t total{0};
+    for(size_t i = 0; i < numSegments; i++) {
+        const auto len = req->segments[i].length;
+        if(len > kMaxBlockSize || (total += len) > kMaxBlockSize) {
+            return this->readScatterFailed(req->file, req->tag, EINVAL, packet);
+        }
+    }
+
+    // prepare the reply buffer; data is appended after the segment lengths
+    const size_t headerLen = sizeof(FileIoReadScatterReqReply) + (sizeof(uint32_t) * numSegments);
+    this->ensureReadReplyBufferSize(headerLen + total);
+
+    auto txPacket = reinterpret_cast<RpcPacket *>(this->readReplyBuffer);
+    auto reply = reinterpret_cast<FileIoReadScatterReqReply *>(txPacket->payload);
+
+    memset(txPacket, 0, sizeof(RpcPacket));
+    memset(reply, 0, headerLen);
+
+    reply->file = req->file;
+    reply->tag = req->tag;
+    reply->numSegments = numSegments;
+
+    auto dataPtr = reinterpret_cast<uint8_t *>(txPacket->payload) + headerLen;
+    size_t dataLen{0};
+
+    // read each segment
+    for(size_t i = 0; i < numSegments; i++) {
+        const auto &seg = req->segments[i];
+        if(!seg.length) continue;
+
+        auto ret = this->ml->implSlowRead(req->file, seg.offset, seg.length);
+        if(ret.status) {
+            return this->readScatterFailed(req->file, req->tag, ret.status, packet);
+        }
+
+        const auto &data = ret.data;
+        const size_t len = std::min<size_t>(data.size(), seg.length);
+
+        memcpy(dataPtr + dataLen, data.data(), len);
+        reply->segmentLengths[i] = len;
+        dataLen += len;
+    }
+
+    txPacket->type = static_cast<uint32_t>(FileIoEpType::ReadFileScatterReply);
+    txPacket->replyPort = 0;
+
+    // send it
+    const auto replyPort = packet->replyPort;
+    const size_t replySize = sizeof(RpcPacket) + headerLen + dataLen;
+    err = PortSend(replyPort, txPacket, replySize);
+
+    if(err) {
+        Warn("%s failed: %d", "PortSend", err);
+    }
+}
+
+/**
+ * Sends a "scatter read failed" message. The status is always sent as a negative error code.
+ */
+void LegacyIo::readScatterFailed(const uintptr_t file, const uint32_t tag, const int errno,
+        const RpcPacket *packet) {
+    FileIoReadScatterReqReply reply;
+    memset(&reply, 0, sizeof(reply));
+
+    reply.status = (errno > 0) ? -errno : errno;
+    reply.file = file;
+    reply.tag = tag;
+
+    auto replyBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
+    this->reply(packet, FileIoEpType::ReadFileScatterReply, replyBuf);
+}
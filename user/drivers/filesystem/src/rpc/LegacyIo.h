@@ -40,10 +40,16 @@ class LegacyIo {
         void handleOpen(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
         void openFailed(const int, const rpc::RpcPacket *);
         void handleReadDirect(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
-        void readFailed(const uintptr_t, const int, const rpc::RpcPacket *);
+        void readFailed(const uintptr_t, const uint32_t, const int, const rpc::RpcPacket *);
+        void handleReadScatter(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
+        void readScatterFailed(const uintptr_t, const uint32_t, const int,
+                const rpc::RpcPacket *);
 
         void handleClose(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
 
+        void handleMap(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
+        void handleUnmap(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
+
         void reply(const rpc::RpcPacket *packet, const rpc::FileIoEpType type,
             const std::span<uint8_t> &buf);
 
@@ -1,5 +1,6 @@
 #include "MessageLoop.h"
 #include "LegacyIo.h"
+#include "Pager.h"
 
 #include "auto/Automount.h"
 #include "fs/Filesystem.h"
@@ -19,6 +20,7 @@
  */
 MessageLoop::MessageLoop() :
     FilesystemServer(std::make_shared<rpc::rt::ServerPortRpcStream>(kPortName)) {
+    this->pager = std::make_unique<Pager>();
     this->legacy = std::make_unique<LegacyIo>(this);
 }
 
@@ -27,6 +29,7 @@ MessageLoop::MessageLoop() :
  */
 MessageLoop::~MessageLoop() {
     this->legacy.reset();
+    this->pager.reset();
 }
 
 /**
@@ -12,6 +12,7 @@
 
 class FileBase;
 class LegacyIo;
+class Pager;
 
 /**
  * Implements the filesystem "message loop" which handles RPC calls to the Filesystem endpoint,
@@ -62,6 +63,8 @@ class MessageLoop: public rpc::FilesystemServer {
         /// Lock protecting the map
         std::mutex openFilesLock;
 
+        /// provides the contents of memory mapped files
+        std::unique_ptr<Pager> pager;
         /// legacy IO handler
         std::unique_ptr<LegacyIo> legacy;
 };
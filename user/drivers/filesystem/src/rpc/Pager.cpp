@@ -0,0 +1,272 @@
+#include "Pager.h"
+
+#include "fs/File.h"
+#include "Log.h"
+
+#include <sys/syscalls.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * Creates the pager port and scratch buffer, then starts the worker thread.
+ */
+Pager::Pager() {
+    int err;
+
+    err = PortCreate(&this->port);
+    if(err) {
+        Abort("%s failed: %d", "PortCreate", err);
+    }
+
+    /*
+     * Allocate the scratch buffer. Its pages are moved into regions we provide data to, which
+     * requires that they've been faulted in; the kernel replaces them with fresh pages, so this
+     * only needs to be done once.
+     */
+    this->pageSz = sysconf(_SC_PAGESIZE);
+
+    this->scratch = aligned_alloc(this->pageSz, kScratchSize);
+    if(!this->scratch) {
+        Abort("failed to allocate pager scratch buffer");
+    }
+    memset(this->scratch, 0, kScratchSize);
+
+    this->worker = std::make_unique<std::thread>(&Pager::main, this);
+}
+
+/**
+ * Stops the worker thread and releases all regions.
+ */
+Pager::~Pager() {
+    // signal to terminate
+    this->run = false;
+
+    uint32_t dummy{0};
+    int err = PortSend(this->port, &dummy, sizeof(dummy));
+    if(err) {
+        Trace("Failed to send pager shutdown message: %d", err);
+    }
+
+    this->worker->join();
+
+    // clean up
+    for(const auto &[cookie, mapping] : this->mappings) {
+        DeallocVirtualRegion(mapping.region);
+    }
+
+    PortDestroy(this->port);
+    free(this->scratch);
+}
+
+/**
+ * Receives page requests from the kernel.
+ */
+void Pager::main() {
+    int err;
+
+    ThreadSetName(0, "Pager");
+
+    void *rxBuf{nullptr};
+    err = posix_memalign(&rxBuf, 16, kMaxMsgLen);
+    if(err) {
+        Abort("%s failed: %d", "posix_memalign", err);
+    }
+
+    while(this->run) {
+        memset(rxBuf, 0, kMaxMsgLen);
+
+        auto msg = reinterpret_cast<struct MessageHeader *>(rxBuf);
+        err = PortReceive(this->port, msg, kMaxMsgLen, UINTPTR_MAX);
+
+        if(err > 0) {
+            if(msg->receivedBytes < sizeof(VmPagerRequest_t)) {
+                continue;
+            }
+
+            auto req = reinterpret_cast<const VmPagerRequest_t *>(msg->data);
+            if(req->type == VM_PAGER_REQUEST_TYPE) {
+                this->handleRequest(req->region, req->cookie, req->offset, req->length);
+            } else if(req->type == VM_PAGER_RELEASE_TYPE) {
+                this->handleRelease(req->region, req->cookie);
+            } else {
+                Warn("Pager invalid msg type: $%08x", req->type);
+            }
+        } else {
+            Warn("Pager port rx error: %d", err);
+        }
+    }
+
+    free(rxBuf);
+}
+
+
+
+/**
+ * Creates a new pager-backed region for the given range of the file.
+ *
+ * @param vmFlags Access flags for the region (VM_REGION_*)
+ * @param client Task that requested the mapping; only it may release the region again
+ *
+ * @return 0 on success, or an errno value.
+ */
+int Pager::map(const std::shared_ptr<FileBase> &file, const uint64_t offset,
+        const uint64_t length, const uintptr_t vmFlags, const uintptr_t client,
+        uintptr_t &outRegion, uint64_t &outLength) {
+    int err;
+    uintptr_t region{0};
+
+    // validate the range
+    if(!length || (offset % this->pageSz) || length > (UINTPTR_MAX - this->pageSz)) {
+        return EINVAL;
+    }
+
+    const auto regionLength = ((length + this->pageSz - 1) / this->pageSz) * this->pageSz;
+
+    // create the region
+    const auto cookie = this->nextCookie++;
+
+    err = AllocVirtualPagerRegion(regionLength, vmFlags, this->port, cookie, &region);
+    if(err) {
+        Warn("%s failed: %d", "AllocVirtualPagerRegion", err);
+        return ENOMEM;
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(this->mappingsLock);
+        this->mappings.emplace(cookie, Mapping{file, offset, region, client});
+    }
+
+    outRegion = region;
+    outLength = regionLength;
+    return 0;
+}
+
+/**
+ * Releases a region created by an earlier call to map(). Any page requests for it that are
+ * received afterwards are failed.
+ *
+ * @return 0 on success, or an errno value.
+ */
+int Pager::unmap(const uintptr_t region, const uintptr_t client) {
+    std::lock_guard<std::mutex> lg(this->mappingsLock);
+
+    auto it = std::find_if(this->mappings.begin(), this->mappings.end(), [&](const auto &e) {
+        return e.second.region == region;
+    });
+    if(it == this->mappings.end()) {
+        return EINVAL;
+    } else if(it->second.client != client) {
+        return EPERM;
+    }
+
+    int err = DeallocVirtualRegion(region);
+    if(err) {
+        Warn("%s failed: %d", "DeallocVirtualRegion", err);
+    }
+
+    this->mappings.erase(it);
+    return 0;
+}
+
+
+
+/**
+ * Handles the kernel's notification that a region is no longer mapped in any task. This is how
+ * mappings of clients that exit without unmapping them are released.
+ *
+ * If the mapping was already released by its client, there's nothing left to do.
+ */
+void Pager::handleRelease(const uintptr_t region, const uintptr_t cookie) {
+    std::lock_guard<std::mutex> lg(this->mappingsLock);
+
+    auto it = this->mappings.find(cookie);
+    if(it == this->mappings.end() || it->second.region != region) {
+        return;
+    }
+
+    int err = DeallocVirtualRegion(region);
+    if(err) {
+        Warn("%s failed: %d", "DeallocVirtualRegion", err);
+    }
+
+    this->mappings.erase(it);
+}
+
+/**
+ * Handles a page request from the kernel. The requested range is read in chunks of the scratch
+ * buffer's size.
+ */
+void Pager::handleRequest(const uintptr_t region, const uintptr_t cookie, const uint64_t offset,
+        const uint64_t length) {
+    Mapping m;
+
+    {
+        std::lock_guard<std::mutex> lg(this->mappingsLock);
+        if(this->mappings.contains(cookie)) {
+            m = this->mappings[cookie];
+        }
+    }
+
+    if(!m.file || m.region != region) {
+        Warn("Pager request for unknown region $%p'h (cookie %p)", region, cookie);
+        VirtualRegionFailPages(region, offset, length);
+        return;
+    }
+
+    for(uint64_t done = 0; done < length; done += kScratchSize) {
+        this->supply(m, offset + done, std::min<uint64_t>(length - done, kScratchSize));
+    }
+}
+
+/**
+ * Reads a range of the file into the scratch buffer, then moves it into the region. The part of
+ * the last page past the end of the file is zeroed; pages that are entirely beyond it are failed.
+ */
+void Pager::supply(const Mapping &m, const uint64_t offset, const uint64_t length) {
+    int err;
+    std::vector<std::byte> buf;
+
+    const auto fileSize = m.file->getFileSize();
+    const auto fileOffset = m.fileOffset + offset;
+
+    if(fileOffset >= fileSize) {
+        VirtualRegionFailPages(m.region, offset, length);
+        return;
+    }
+
+    const size_t valid = std::min<uint64_t>(length, fileSize - fileOffset);
+    const size_t dataBytes = ((valid + this->pageSz - 1) / this->pageSz) * this->pageSz;
+
+    // read the data
+    err = m.file->read(fileOffset, valid, buf);
+    if(err) {
+        Warn("Failed to read %lu bytes at %lu for region $%p'h: %d", valid, fileOffset, m.region,
+                err);
+        VirtualRegionFailPages(m.region, offset, length);
+        return;
+    }
+
+    const auto numRead = std::min(buf.size(), valid);
+    auto scratch = reinterpret_cast<std::byte *>(this->scratch);
+
+    memcpy(scratch, buf.data(), numRead);
+    memset(scratch + numRead, 0, dataBytes - numRead);
+
+    // then provide the pages
+    err = VirtualRegionSupplyPages(m.region, offset, scratch, dataBytes);
+    if(err) {
+        Warn("%s failed: %d", "VirtualRegionSupplyPages", err);
+        VirtualRegionFailPages(m.region, offset, length);
+        return;
+    }
+
+    if(dataBytes < length) {
+        VirtualRegionFailPages(m.region, offset + dataBytes, length - dataBytes);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+class FileBase;
+
+/**
+ * Provides the contents of memory mapped files.
+ *
+ * Each mapping is a pager-backed virtual memory region, owned by us. When a page of it is first
+ * accessed, the kernel sends a request to our port; we read the corresponding range of the file
+ * into a scratch buffer, then move its pages into the region.
+ *
+ * Mappings are released when the client unmaps them, or when the kernel tells us the region is no
+ * longer mapped in any task (such as when the client exited without unmapping it.)
+ */
+class Pager {
+    /// maximum length of messages received on the pager port
+    constexpr static const size_t kMaxMsgLen{256};
+    /// size of the scratch buffer; larger requests are processed in multiple steps
+    constexpr static const size_t kScratchSize{1024 * 64};
+
+    public:
+        Pager();
+        ~Pager();
+
+        /// Creates a region backed by the given range of the file.
+        int map(const std::shared_ptr<FileBase> &file, const uint64_t offset,
+                const uint64_t length, const uintptr_t vmFlags, const uintptr_t client,
+                uintptr_t &outRegion, uint64_t &outLength);
+        /// Releases a previously created region.
+        int unmap(const uintptr_t region, const uintptr_t client);
+
+    private:
+        /**
+         * Information on a single mapping
+         */
+        struct Mapping {
+            /// file whose contents are mapped
+            std::shared_ptr<FileBase> file;
+            /// offset into the file of the start of the region
+            uint64_t fileOffset{0};
+            /// VM region handle
+            uintptr_t region{0};
+            /// task that requested the mapping
+            uintptr_t client{0};
+        };
+
+        void main();
+        void handleRequest(const uintptr_t region, const uintptr_t cookie, const uint64_t offset,
+                const uint64_t length);
+        void handleRelease(const uintptr_t region, const uintptr_t cookie);
+        void supply(const Mapping &m, const uint64_t offset, const uint64_t length);
+
+    private:
+        /// whether the worker is running
+        std::atomic_bool run{true};
+        /// worker thread that processes page requests
+        std::unique_ptr<std::thread> worker;
+        /// port on which the kernel sends page requests
+        uintptr_t port{0};
+
+        /// page size of the system
+        size_t pageSz{0};
+        /// page aligned buffer that file data is read into, before being moved into a region
+        void *scratch{nullptr};
+
+        /// cookie value for the next mapping
+        std::atomic_uintptr_t nextCookie{1};
+        /// all mappings, by their cookie
+        std::unordered_map<uintptr_t, Mapping> mappings;
+        /// lock protecting the mappings
+        std::mutex mappingsLock;
+};
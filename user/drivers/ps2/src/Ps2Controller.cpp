@@ -1,6 +1,7 @@
 #include "Ps2Controller.h"
 #include "Ps2Device.h"
 #include "PortDetector.h"
+#include "rpc/EventSubmitter.h"
 #include "Log.h"
 
 #include <thread>
@@ -166,10 +167,14 @@ void Ps2Controller::workerMain() {
     while(this->run) {
         std::byte temp;
 
-        // wait on notification
-        note = NotificationReceive(UINTPTR_MAX, UINTPTR_MAX);
+        // wait on notification; input events that couldn't be delivered are retried periodically
+        auto es = EventSubmitter::the();
+        note = NotificationReceive(UINTPTR_MAX,
+                es->hasHeldEvents() ? kHeldEventRetryInterval : UINTPTR_MAX);
         //Trace("Notify $%08x", note);
 
+        es->retryHeld();
+
         this->inCmdLoop = true;
 
         // read port 1 byte
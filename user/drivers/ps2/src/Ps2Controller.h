@@ -47,6 +47,9 @@ class Ps2Controller {
             kMouseIrq                   = (1 << 1),
         };
 
+        /// Interval at which input events held back by the event submitter are retried (in µs)
+        constexpr static const uintptr_t kHeldEventRetryInterval{10000};
+
         /// Commands we can send to the controller
         enum Command: uint8_t {
             /// Read controller configuration byte
@@ -1,14 +1,25 @@
 #include "EventSubmitter.h"
 #include "Client_WindowServer.hpp"
+#include "InputRing.h"
 
 #include "Log.h"
 
 #include <threads.h>
+#include <time.h>
+#include <sys/syscalls.h>
 #include <rpc/dispensary.h>
 #include <rpc/rt/ClientPortRpcStream.h>
 
 EventSubmitter *EventSubmitter::gShared{nullptr};
 
+/// Region of virtual memory in which the input ring is mapped
+static uintptr_t kRingMappingRange[2] = {
+    // start
+    0x60300000000,
+    // end
+    0x60310000000,
+};
+
 /**
  * Returns the shared event submitter instance, allocating it if needed.
  */
@@ -26,10 +37,13 @@ EventSubmitter *EventSubmitter::the() {
 /**
  * Submits a mouse event to the window server. If the RPC connection is not valid or otherwise
  * unavailable, and we cannot reestablish it, the event is discarded.
+ *
+ * If the input ring is full, the event is held back; further motion with the same button state is
+ * merged into it, so that no movement is lost.
  */
 void EventSubmitter::submitMouseEvent(const uintptr_t buttons,
         const std::tuple<int, int, int> &deltas) {
-    const auto [dX, dY, dZ] = deltas;
+    auto [dX, dY, dZ] = deltas;
 
     // ensure RPC connection
     if(!this->rpc) {
@@ -39,9 +53,23 @@ void EventSubmitter::submitMouseEvent(const uintptr_t buttons,
         }
     }
 
-    // submit the event
     // XXX: we need to flip the Y coordinate for some reason?
-    rpc->SubmitMouseEvent(buttons, dX, -dY, dZ);
+    dY = -dY;
+
+    if(!this->ring) {
+        rpc->SubmitMouseEvent(buttons, dX, dY, dZ);
+        return;
+    }
+
+    InputRing::Event event;
+    event.timestamp = GetTimestamp();
+    event.type = InputRing::EventType::Mouse;
+    event.mouse.buttons = buttons;
+    event.mouse.dX = dX;
+    event.mouse.dY = dY;
+    event.mouse.dZ = dZ;
+
+    this->submit(event);
 }
 
 /**
@@ -57,12 +85,139 @@ void EventSubmitter::submitKeyEvent(const uint32_t key, const bool isMake) {
         }
     }
 
-    rpc->SubmitKeyEvent(key, !isMake);
+    if(!this->ring) {
+        rpc->SubmitKeyEvent(key, !isMake);
+        return;
+    }
+
+    InputRing::Event event;
+    event.timestamp = GetTimestamp();
+    event.type = InputRing::EventType::Key;
+    event.key.scancode = key;
+    event.key.release = !isMake;
+
+    this->submit(event);
+}
+
+/**
+ * Writes an event to the input ring. Any held back events are written first, so that events are
+ * always delivered in order; if they can't all be written, the event is held back as well.
+ */
+void EventSubmitter::submit(const InputRing::Event &event) {
+    if(this->flushHeld() && this->push(event)) {
+        return;
+    }
+
+    this->hold(event);
 }
 
+/**
+ * Writes an event to the input ring, and notifies the window server if the ring was empty.
+ *
+ * @return Whether the event was written; this fails if the ring is full.
+ */
+bool EventSubmitter::push(const InputRing::Event &event) {
+    bool notify{false};
+
+    if(!InputRing::Push(this->ring, event, notify)) {
+        return false;
+    }
+
+    if(notify) {
+        int err = NotificationSend(this->ring->notifyThread, this->ring->notifyBits);
+        if(err) {
+            Warn("%s failed: %d", "NotificationSend", err);
+        }
+    }
+
+    return true;
+}
 
 /**
- * Attempts to establish an RPC connection to the window server.
+ * Holds back an event that couldn't be written to the ring.
+ *
+ * Mouse motion with the same button state as the most recently held back event is merged into it.
+ * If too many events are held back, we give the window server a chance to catch up; if it still
+ * doesn't, the event is dropped. A mouse event is instead merged into the last held back one, and
+ * its button state replaces that event's: the intermediate button state is lost, but the latest
+ * one is always delivered, so buttons can't get stuck.
+ */
+void EventSubmitter::hold(const InputRing::Event &event) {
+    auto &held = this->held;
+    const bool isMouse = (event.type == InputRing::EventType::Mouse);
+    const bool lastIsMouse = !held.empty() && held.back().type == InputRing::EventType::Mouse;
+
+    // merge motion if the buttons didn't change
+    if(isMouse && lastIsMouse && held.back().mouse.buttons == event.mouse.buttons) {
+        auto &m = held.back().mouse;
+        m.dX += event.mouse.dX;
+        m.dY += event.mouse.dY;
+        m.dZ += event.mouse.dZ;
+
+        if(kLogCoalescing) Trace("Coalesced motion: (%d, %d, %d)", m.dX, m.dY, m.dZ);
+        return;
+    }
+
+    // wait for some space if the backlog is full
+    for(size_t i = 0; held.size() >= kMaxHeldEvents && i < kHoldRetries; i++) {
+        ThreadYield();
+        this->flushHeld();
+    }
+
+    if(held.size() < kMaxHeldEvents) {
+        held.push_back(event);
+        return;
+    }
+
+    // keep the latest button state
+    if(isMouse && lastIsMouse) {
+        auto &m = held.back().mouse;
+        m.buttons = event.mouse.buttons;
+        m.dX += event.mouse.dX;
+        m.dY += event.mouse.dY;
+        m.dZ += event.mouse.dZ;
+    } else if(event.type == InputRing::EventType::Key) {
+        Warn("Discarding key event: (%08x, %5s)", event.key.scancode,
+                event.key.release ? "break" : "make");
+    }
+
+    this->ring->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Writes as many held back events to the ring as there is space for.
+ *
+ * @return Whether there are no more held back events
+ */
+bool EventSubmitter::flushHeld() {
+    auto &held = this->held;
+
+    while(!held.empty()) {
+        if(!this->push(held.front())) {
+            return false;
+        }
+        held.pop_front();
+    }
+
+    return true;
+}
+
+/**
+ * Reads the system uptime from the kernel's time page.
+ */
+uint64_t EventSubmitter::GetTimestamp() {
+    struct timespec ts;
+    if(clock_gettime(CLOCK_UPTIME_RAW, &ts)) {
+        return 0;
+    }
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL) + ts.tv_nsec;
+}
+
+
+
+/**
+ * Attempts to establish an RPC connection to the window server, then sets up an input ring.
  */
 bool EventSubmitter::connect() {
     int err;
@@ -74,7 +229,7 @@ bool EventSubmitter::connect() {
         // an error occurred
         if(err > 0) {
             Abort("%s failed: %d", "LookupService", err);
-        } 
+        }
         // the port hasn't been registered yet
         else {
             return false;
@@ -85,5 +240,43 @@ bool EventSubmitter::connect() {
     auto stream = std::make_shared<rpc::rt::ClientPortRpcStream>(port);
     this->rpc = std::make_unique<rpc::WindowServerClient>(stream);
 
+    // try to get an input ring; if that fails, we'll fall back to sending events via RPC
+    err = this->openRing();
+    if(err) {
+        Warn("Failed to open input ring (%d), events will be sent via RPC", err);
+    }
+
     return true;
 }
+
+/**
+ * Requests an input ring from the window server, then maps it into our address space.
+ */
+int EventSubmitter::openRing() {
+    int err;
+
+    auto info = this->rpc->OpenInputRing();
+    if(info.status) {
+        return info.status;
+    }
+
+    uintptr_t base{0};
+    err = MapVirtualRegionRange(info.regionHandle, kRingMappingRange, info.regionBytes, 0, &base);
+    kRingMappingRange[0] += info.regionBytes;
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegionRange", err);
+        return err;
+    }
+
+    // validate the header
+    auto hdr = reinterpret_cast<InputRing::Header *>(base);
+    if(__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != InputRing::kMagic ||
+            hdr->version != InputRing::kVersion) {
+        Warn("Invalid input ring header (magic %08x, version %u)", hdr->magic, hdr->version);
+        UnmapVirtualRegion(info.regionHandle);
+        return -1;
+    }
+
+    this->ring = hdr;
+    return 0;
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <tuple>
 #include <memory>
 #include <string_view>
 
+#include "InputRing.h"
+
 namespace rpc {
 class WindowServerClient;
 }
@@ -12,6 +16,10 @@ class WindowServerClient;
 /**
  * Generated events from mice and keyboard are processed via this class and sent to the window
  * server which then handles them appropriately.
+ *
+ * Events are written into a shared memory ring that the window server reads from; only if the ring
+ * can't be set up, each event is sent as an individual RPC call instead. Since the ring only has a
+ * single producer, events must all be submitted from the same thread.
  */
 class EventSubmitter {
     /// Name under which the RPC port for the window server is registered
@@ -26,13 +34,53 @@ class EventSubmitter {
         /// A mouse event has been generated
         void submitMouseEvent(const uintptr_t buttons, const std::tuple<int, int, int> &delta);
 
+        /// Whether any events are held back because the input ring was full
+        bool hasHeldEvents() const {
+            return !this->held.empty();
+        }
+        /// Attempts to write any held back events to the input ring
+        void retryHeld() {
+            this->flushHeld();
+        }
+
     private:
         /// Attempts to establish the RPC connection
         bool connect();
+        /// Requests an input ring from the window server and maps it
+        int openRing();
+
+        /// Writes an event to the input ring, or holds it back if the ring is full
+        void submit(const InputRing::Event &event);
+        /// Writes an event to the input ring
+        bool push(const InputRing::Event &event);
+        /// Adds an event to the held back events
+        void hold(const InputRing::Event &event);
+        /// Writes any events held back while the ring was full
+        bool flushHeld();
+
+        /// Gets the current system uptime, in nanoseconds
+        static uint64_t GetTimestamp();
 
     private:
+        /// Whether mouse motion accumulated while the ring is full is logged
+        constexpr static const bool kLogCoalescing{false};
+        /// Maximum number of events to hold back while the ring is full
+        constexpr static const size_t kMaxHeldEvents{64};
+        /// Number of times to yield to the window server before giving up on a full backlog
+        constexpr static const size_t kHoldRetries{8};
+
         static EventSubmitter *gShared;
 
         /// RPC connection handler
         std::unique_ptr<rpc::WindowServerClient> rpc;
+
+        /// Input ring shared with the window server, if one could be set up
+        InputRing::Header *ring{nullptr};
+
+        /**
+         * Events that could not be written to the ring because it was full, in the order they
+         * were generated. Mouse motion with the same button state as the most recent held back
+         * event is added to it, and they're written as soon as there is space.
+         */
+        std::deque<InputRing::Event> held;
 };
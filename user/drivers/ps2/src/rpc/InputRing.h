@@ -0,0 +1 @@
+../../../../gui/windowserver/include/InputRing.h
\ No newline at end of file
@@ -6,6 +6,9 @@
 
 #include <svga_reg.h>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace svga;
 
 /**
@@ -53,6 +56,56 @@ int Commands2D::update() {
     return this->update({0, 0}, size);
 }
 
+/**
+ * Notifies the GPU that several regions of the framebuffer have been updated.
+ *
+ * Rather than committing each update command individually, as many update commands as fit in a
+ * single FIFO reservation are written back to back, and then committed at once. This means the
+ * device is only notified once per batch rather than once per rectangle.
+ *
+ * @param rects Rectangles that were updated
+ *
+ * @return 0 on success or an error code
+ */
+int Commands2D::update(const std::span<const DriverSupport::gfx::UpdateRect> &rects) {
+    struct UpdateCommand {
+        uint32_t type;
+        SVGAFifoCmdUpdate cmd;
+    } __attribute__((__packed__));
+
+    constexpr static const size_t kMaxPerBatch{FIFO::kMaxCommandSize / sizeof(UpdateCommand)};
+
+    int err;
+    std::span<std::byte> cmdBuf;
+
+    for(size_t i = 0; i < rects.size(); i += kMaxPerBatch) {
+        const auto batch = rects.subspan(i, std::min(kMaxPerBatch, rects.size() - i));
+
+        // reserve space for all commands in this batch
+        err = this->s->fifo->reserve(batch.size() * sizeof(UpdateCommand), cmdBuf);
+        if(err) return err;
+
+        // write them out
+        auto cmds = reinterpret_cast<UpdateCommand *>(cmdBuf.data());
+        for(const auto &rect : batch) {
+            UpdateCommand c;
+            c.type = SVGA_CMD_UPDATE;
+            c.cmd.x = rect.x;
+            c.cmd.y = rect.y;
+            c.cmd.width = rect.w;
+            c.cmd.height = rect.h;
+
+            memcpy(cmds++, &c, sizeof(c));
+        }
+
+        // and submit them
+        err = this->s->fifo->commitAll();
+        if(err) return err;
+    }
+
+    return 0;
+}
+
 /**
  * Defines the cursor image.
  *
@@ -5,6 +5,8 @@
 #include <span>
 #include <utility>
 
+#include <DriverSupport/gfx/Types.h>
+
 class SVGA;
 
 namespace svga {
@@ -23,6 +25,8 @@ class Commands2D {
         [[nodiscard]] int update(const Point &origin, const Size &size);
         /// Marks the entire framebuffer as needing to be redrawn.
         [[nodiscard]] int update();
+        /// Marks several rectangular regions of the screen as needing to be redrawn.
+        [[nodiscard]] int update(const std::span<const DriverSupport::gfx::UpdateRect> &rects);
 
         /// Defines the 32-bit BGRA image used for the cursor.
         [[nodiscard]] int defineCursor(const Point &hotspot, const Size &size,
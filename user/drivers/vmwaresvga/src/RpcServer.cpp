@@ -9,6 +9,8 @@
 #include <rpc/rt/ServerPortRpcStream.h>
 #include <sys/syscalls.h>
 
+#include <cstring>
+
 using namespace svga;
 
 /**
@@ -91,6 +93,24 @@ int32_t RpcServer::implRegionUpdated(int32_t x, int32_t y, uint32_t w, uint32_t
     return c2->update({x, y}, {w, h});
 }
 
+/**
+ * Invalidates all regions in the provided list of rectangles.
+ */
+int32_t RpcServer::implRegionsUpdated(const std::vector<std::byte> &rects) {
+    using UpdateRect = DriverSupport::gfx::UpdateRect;
+
+    if(rects.size() % sizeof(UpdateRect)) {
+        return SVGA::Errors::InvalidRequest;
+    }
+
+    // copy out the rects, since the blob may not be suitably aligned
+    std::vector<UpdateRect> updates(rects.size() / sizeof(UpdateRect));
+    memcpy(updates.data(), rects.data(), rects.size());
+
+    auto &c2 = this->s->get2DCommands();
+    return c2->update(updates);
+}
+
 /**
  * Gets the virtual memory object that maps the framebuffer for this display.
  */
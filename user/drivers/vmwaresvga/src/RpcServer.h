@@ -23,6 +23,7 @@ class RpcServer: public rpc::DisplayServer {
         int32_t implSetOutputEnabled(bool enabled) override;
         int32_t implSetOutputMode(const DriverSupport::gfx::DisplayMode &mode) override;
         int32_t implRegionUpdated(int32_t x, int32_t y, uint32_t w, uint32_t h) override;
+        int32_t implRegionsUpdated(const std::vector<std::byte> &rects) override;
         GetFramebufferReturn implGetFramebuffer() override;
         GetFramebufferInfoReturn implGetFramebufferInfo() override;
 
@@ -53,6 +53,8 @@ class SVGA {
             CommandInFlight                     = -71005,
             /// Attempted to commit a command when there are no commands in flight
             NoCommandsAvailable                 = -71006,
+            /// A request from a client was malformed
+            InvalidRequest                      = -71007,
         };
 
     public:
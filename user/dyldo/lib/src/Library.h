@@ -5,7 +5,7 @@
 #include <cstring>
 #include <list>
 
-#include "struct/StringAllocator.h"
+#include "link/SymbolTable.h"
 
 namespace dyldo {
 class ElfLibReader;
@@ -36,8 +36,8 @@ struct Library {
     /// all termination functions associated with this object
     std::list<void(*)(void)> finiFuncs;
 
-    /// string allocator
-    StringAllocator strings;
+    /// dynamic symbol table, used to look up symbols exported by the library
+    SymbolTable symbols;
 };
 }
 
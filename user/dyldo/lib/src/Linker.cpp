@@ -1,5 +1,6 @@
 #include "Linker.h"
 #include "Library.h"
+#include "link/LaunchClosure.h"
 #include "link/SymbolMap.h"
 #include "runtime/DlInfo.h"
 #include "runtime/ThreadLocal.h"
@@ -7,6 +8,9 @@
 #include "elf/ElfLibReader.h"
 #include "struct/PaddedArray.h"
 
+#include <cstdlib>
+#include <utility>
+#include <vector>
 #include <unistd.h>
 
 using namespace dyldo;
@@ -28,13 +32,14 @@ bool Linker::gLogTraceEnabled{true};
 bool Linker::gLogOpenAttempts{false};
 bool Linker::gLogInitFini{false};
 bool Linker::gLogTls{false};
+bool Linker::gLogClosures{false};
 
 /**
  * Initializes a new linker, for the executable at the path given.
  *
  * It's assumed the executable is properly mapped, and as are we, but that's it.
  */
-Linker::Linker(const char *_path) {
+Linker::Linker(const char *_path, const uintptr_t _launchFlags) : launchFlags(_launchFlags) {
     // initialize containers
     int err = hashmap_create(1, &this->loaded);
     if(err) {
@@ -120,6 +125,17 @@ uintptr_t Linker::calcLibOffset() {
  * Discards all cached data and releases unneeded memory.
  */
 void Linker::cleanUp() {
+    // record the launch closure if we didn't have one; otherwise, release it
+    if(this->closureBuilder) {
+        this->closureBuilder->submit(this->soSlide, this->soBase);
+        delete this->closureBuilder;
+        this->closureBuilder = nullptr;
+    }
+    if(this->closure) {
+        delete this->closure;
+        this->closure = nullptr;
+    }
+
     /**
      * Ensure all library segments are properly protected; and then get rid of the readers. That
      * will close the file handles as well.
@@ -153,9 +169,13 @@ void Linker::cleanUp() {
  * Performs fixups: in the current implementation, this just performs relocations for all symbols
  * in the executable and dependent libraries.
  *
- * All symbol resolution happens just-in-time by calling back into the runtime linking stub.
+ * Data relocations are always processed immediately. Jump table (PLT) relocations are bound
+ * lazily, through the runtime linking stub, the first time each function is called; unless eager
+ * binding was requested, or the object requires it.
  */
 void Linker::doFixups() {
+    this->lazyBinding = this->shouldBindLazily();
+
     // first, fix up the executable (data and PLT)
     PaddedArray<Elf_Rel> execRels;
 
@@ -163,11 +183,12 @@ void Linker::doFixups() {
         this->exec->processRelocs(execRels);
     }
     if(this->exec->getPltRels(execRels)) {
-        this->exec->processRelocs(execRels);
+        this->exec->processPltRelocs(execRels, this->lazyBinding);
     }
 
     // then, ALL loaded libraries
     hashmap_iterate(&this->loaded, [](void *ctx, void *value) {
+        auto linker = reinterpret_cast<Linker *>(ctx);
         auto lib = reinterpret_cast<Library *>(value);
         PaddedArray<Elf_Rel> rels;
 
@@ -178,7 +199,8 @@ void Linker::doFixups() {
             lib->reader->processRelocs(rels);
         }
         if(lib->reader->getPltRels(rels)) {
-            lib->reader->processRelocs(rels);
+            const bool lazy = linker->lazyBinding && !lib->reader->wantsBindNow();
+            lib->reader->processPltRelocs(rels, lazy);
         }
 
         return 1;
@@ -188,6 +210,29 @@ void Linker::doFixups() {
     this->entryAddr = this->exec->getEntryAddress();
 }
 
+/**
+ * Determines whether jump table relocations should be bound lazily. This is the case unless the
+ * executable was linked with `-z now`, the task was launched with the bind now flag (see
+ * RpcTaskCreateWithFlags), or the linker was built with eager binding forced.
+ *
+ * Lazy binding is only implemented for amd64.
+ */
+bool Linker::shouldBindLazily() {
+#if defined(__amd64__) && !defined(DYLDO_BIND_NOW)
+    if(this->exec->wantsBindNow()) {
+        return false;
+    }
+
+    if(this->launchFlags & TASK_LAUNCHINFO_FLAG_BIND_NOW) {
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
 /**
  * Jumps to the program entry point.
  */
@@ -238,22 +283,114 @@ void Linker::runInit() {
 /**
  * Loads dependent libraries.
  *
- * This starts with the ones required by the main executable, recursively loading depenencies of
- * all other libraries until there is nothing left to do.
+ * If the executable has a valid launch closure, the libraries it lists are loaded directly.
+ * Otherwise, we start with the ones required by the main executable, recursively loading
+ * depenencies of all other libraries until there is nothing left to do; and record a closure for
+ * the next launch.
  */
 void Linker::loadLibs() {
+    if(this->loadLibsFromClosure()) {
+        return;
+    }
+
+#if defined(__amd64__)
+    if(ElfReader::hasDyldosrv()) {
+        this->closureBuilder = new ClosureBuilder(this->exec, this->path);
+    }
+#endif
+
     for(const auto &dep : this->exec->getDeps()) {
         this->loadSharedLib(dep.name);
     }
 }
 
+/**
+ * Attempts to load the libraries of the executable from its launch closure. Each library is
+ * loaded from the path it was previously loaded from, at the same base address.
+ *
+ * Before any libraries are mapped, we ensure the executable and all libraries are the same files
+ * as when the closure was recorded; if not, the closure is discarded.
+ *
+ * @return Whether libraries were loaded from the closure
+ */
+bool Linker::loadLibsFromClosure() {
+    bool valid{true};
+
+    auto closure = LaunchClosure::Load(this->path);
+    if(!closure) {
+        return false;
+    }
+
+    // open all libraries, and validate them and the executable
+    const auto numObjects = closure->getNumObjects();
+    std::vector<std::pair<FILE *, ElfLibReader *>> readers;
+    readers.reserve(numObjects);
+
+    if(!closure->matches(0, this->exec)) {
+        valid = false;
+    }
+
+    for(size_t i = 1; valid && i < numObjects; i++) {
+        const auto path = closure->getPath(i);
+
+        FILE *fp = fopen(path, "rb");
+        if(!fp) {
+            valid = false;
+            break;
+        }
+
+        // the file may have been replaced by something we can't load at all
+        if(!ElfLibReader::IsLoadable(fp)) {
+            fclose(fp);
+            valid = false;
+            break;
+        }
+
+        auto reader = new ElfLibReader(closure->getBase(i), fp, path);
+        readers.emplace_back(fp, reader);
+
+        valid = closure->matches(i, reader);
+    }
+
+    if(!valid) {
+        if(gLogClosures) Trace("Launch closure for %s is stale", this->path);
+
+        for(auto &[fp, reader] : readers) {
+            delete reader;
+            fclose(fp);
+        }
+        delete closure;
+        return false;
+    }
+
+    // map and register all of them, in the same order as before
+    this->exec->setObjectIndex(0);
+
+    for(size_t i = 1; i < numObjects; i++) {
+        auto reader = readers[i - 1].second;
+
+        const auto libPath = strdup(closure->getPath(i));
+        if(!libPath) Abort("out of memory");
+
+        auto info = this->addSharedLib(closure->getSoname(i), libPath, reader,
+                closure->getBase(i));
+        reader->setObjectIndex(i);
+        closure->setLibrary(i, info);
+    }
+
+    this->soSlide = closure->getSoSlide();
+    this->soBase = closure->getSoBase();
+    this->closure = closure;
+
+    if(gLogClosures) Trace("Loaded %lu libraries from launch closure", numObjects - 1);
+    return true;
+}
+
 /**
  * Loads a dependent library based on its soname. This exits immediately if it's already been
  * loaded.
  */
 void Linker::loadSharedLib(const char *soname) {
-    int err;
-
     // bail if it's already been loaded
     if(hashmap_get(&this->loaded, soname, strlen(soname))) {
         return;
@@ -270,6 +407,36 @@ void Linker::loadSharedLib(const char *soname) {
     const auto base = this->soBase;
     auto loader = new ElfLibReader(base, file, libPath);
 
+    auto info = this->addSharedLib(soname, libPath, loader, base);
+    if(this->closureBuilder) {
+        this->closureBuilder->addLibrary(info, loader);
+    }
+
+    // advance the pointer to place the next library
+    const auto nextBase = base + loader->getVmRequirements();
+    const auto off = this->calcLibOffset();
+    this->soBase = ((nextBase + off - 1) / off) * off;
+
+    // process dependencies of the library that was just loaded
+    for(const auto &dep : loader->getDeps()) {
+        this->loadSharedLib(dep.name);
+    }
+}
+
+/**
+ * Maps a library that's been opened, and registers it and its symbols.
+ *
+ * @param soname Name of the library
+ * @param libPath Path from which the library was loaded; ownership is taken
+ * @param loader Reader for the library's file
+ * @param base Address at which the library is loaded
+ *
+ * @return Information structure for the newly loaded library
+ */
+Library *Linker::addSharedLib(const char *soname, const char *libPath, ElfLibReader *loader,
+        const uintptr_t base) {
+    int err;
+
     // store its info
     auto info = new Library;
     if(!info) Abort("out of memory");
@@ -311,15 +478,7 @@ void Linker::loadSharedLib(const char *soname) {
     // store it in the dynamic info
     this->dlInfo->loadedLib(loader, info);
 
-    // advance the pointer to place the next library
-    const auto nextBase = base + loader->getVmRequirements();
-    const auto off = this->calcLibOffset();
-    this->soBase = ((nextBase + off - 1) / off) * off;
-
-    // process dependencies of the library that was just loaded
-    for(const auto &dep : loader->getDeps()) {
-        this->loadSharedLib(dep.name);
-    }
+    return info;
 }
 
 /**
@@ -365,17 +524,44 @@ FILE *Linker::openSharedLib(const char *soname, const char* &outPath) {
 
 /**
  * Resolves a global symbol.
+ *
+ * @return Whether the symbol was found, in which case `outSymbol` is filled in
  */
-const SymbolMap::Symbol *Linker::resolveSymbol(const char *name, Library *inLibrary) {
-    return this->map->get(name, inLibrary);
+bool Linker::resolveSymbol(const char *name, SymbolMap::Symbol &outSymbol, Library *inLibrary) {
+    return this->map->get(name, outSymbol, inLibrary);
+}
+
+/**
+ * Resolves a symbol referenced by a relocation in an object. The binding recorded in the launch
+ * closure is used if there is one; otherwise, the symbol is looked up, and the result is recorded
+ * in the closure being built.
+ *
+ * @param object Index of the object that contains the relocation
+ * @param symbol Index of the symbol in that object's symbol table
+ * @param name Name of the symbol
+ *
+ * @return Whether the symbol was found, in which case `outSymbol` is filled in
+ */
+bool Linker::bindSymbol(const uint32_t object, const uint32_t symbol, const char *name,
+        SymbolMap::Symbol &outSymbol) {
+    if(this->closure && this->closure->getBinding(object, symbol, name, outSymbol)) {
+        return true;
+    }
+
+    if(!this->resolveSymbol(name, outSymbol)) {
+        return false;
+    }
+    if(this->closureBuilder) {
+        this->closureBuilder->addBinding(object, symbol, outSymbol);
+    }
+    return true;
 }
 
 /**
- * Registers a symbol in the symbol map.
+ * Registers a library's symbol table in the symbol map.
  */
-void Linker::exportSymbol(const char * _Nonnull name, const Elf_Sym &sym,
-        Library * _Nonnull library) {
-    this->map->add(name, sym, library);
+void Linker::exportSymbols(Library * _Nonnull library) {
+    this->map->addLibrary(library);
 }
 
 /**
@@ -389,16 +575,17 @@ void Linker::overrideSymbol(const SymbolMap::Symbol *inSym, const uintptr_t newA
 /**
  * Sets the size of the thread-local region required by the executable.
  */
-void Linker::setExecTlsRequirements(const size_t totalLen, const std::span<std::byte> &tdata) {
-    this->tls->setExecTlsInfo(totalLen, tdata);
+void Linker::setExecTlsRequirements(const size_t totalLen, const size_t align,
+        const std::span<std::byte> &tdata) {
+    this->tls->setExecTlsInfo(totalLen, align, tdata);
 }
 
 /**
  * Sets the thread-local requirements of a shared library.
  */
-void Linker::setLibTlsRequirements(const size_t totalLen, const std::span<std::byte> &tdata,
-        Library * _Nonnull library) {
-    this->tls->setLibTlsInfo(totalLen, tdata, library);
+void Linker::setLibTlsRequirements(const size_t totalLen, const size_t align,
+        const std::span<std::byte> &tdata, Library * _Nonnull library) {
+    this->tls->setLibTlsInfo(totalLen, align, tdata, library);
 }
 
 /**
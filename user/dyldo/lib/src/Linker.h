@@ -20,6 +20,8 @@ class DlInfo;
 class ElfReader;
 class ElfExecReader;
 class ElfLibReader;
+class ClosureBuilder;
+class LaunchClosure;
 struct Library;
 class SymbolMap;
 
@@ -44,8 +46,8 @@ class Linker {
 
     public:
         /// Initializes the shared linker.
-        static void init(const char *_Nonnull execPath) {
-            gShared = new Linker(execPath);
+        static void init(const kush_task_launchinfo_t *_Nonnull info) {
+            gShared = new Linker(info->loadPath, info->flags);
             if(!gShared) {
                 Abort("out of memory");
             }
@@ -68,7 +70,7 @@ class Linker {
         [[noreturn]] static void Abort(const char * _Nonnull format, ...) __attribute__ ((format (printf, 1, 2)));
 
     public:
-        Linker(const char * _Nonnull path);
+        Linker(const char * _Nonnull path, const uintptr_t launchFlags);
 
         /// Loads libraries required by the executable (and other libraries)
         void loadLibs();
@@ -85,18 +87,22 @@ class Linker {
         void printImageBases();
 
         /// Resolves a symbol.
-        const SymbolMap::Symbol* _Nullable resolveSymbol(const char *_Nonnull name,
+        bool resolveSymbol(const char *_Nonnull name, SymbolMap::Symbol &outSymbol,
                 Library * _Nullable inLibrary = nullptr);
-        /// Registers a symbol exported from a library
-        void exportSymbol(const char * _Nonnull name, const Elf_Sym &sym, Library *_Nonnull lib);
+        /// Resolves a symbol referenced by an object's relocations.
+        bool bindSymbol(const uint32_t object, const uint32_t symbol, const char * _Nonnull name,
+                SymbolMap::Symbol &outSymbol);
+        /// Registers the symbols exported from a library
+        void exportSymbols(Library *_Nonnull lib);
         /// Overrides a symbol's address.
         void overrideSymbol(const SymbolMap::Symbol * _Nonnull inSym, const uintptr_t newAddr);
 
         /// Registers the main executable's TLS requirements.
-        void setExecTlsRequirements(const size_t totalLen, const std::span<std::byte> &tdata);
+        void setExecTlsRequirements(const size_t totalLen, const size_t align,
+                const std::span<std::byte> &tdata);
         /// Registers a library's thread-local requirements.
-        void setLibTlsRequirements(const size_t totalLen, const std::span<std::byte> &tdata,
-                Library * _Nonnull library);
+        void setLibTlsRequirements(const size_t totalLen, const size_t align,
+                const std::span<std::byte> &tdata, Library * _Nonnull library);
 
 
         ThreadLocal * _Nonnull getTls() {
@@ -113,9 +119,17 @@ class Linker {
         void calcSlides();
         /// Gets the offset to use to the next library.
         uintptr_t calcLibOffset();
+        /// Determines whether jump table relocations are bound lazily
+        bool shouldBindLazily();
 
+        /// Loads all libraries as recorded in the executable's launch closure
+        bool loadLibsFromClosure();
         /// Load a shared library
         void loadSharedLib(const char * _Nonnull soname);
+        /// Maps a shared library and registers it
+        Library * _Nonnull addSharedLib(const char * _Nonnull soname,
+                const char * _Nonnull libPath, ElfLibReader * _Nonnull loader,
+                const uintptr_t base);
         /// Searches for a library with the given name in system paths and open it
         FILE * _Nullable openSharedLib(const char * _Nonnull soname, const char * _Nullable &outPath);
 
@@ -131,6 +145,8 @@ class Linker {
         static bool gLogInitFini;
         /// are we logging thread-local info
         static bool gLogTls;
+        /// whether we log the use of launch closures
+        static bool gLogClosures;
 
         /// Whether we output logs for each library we fix up
         constexpr static const bool kLogLibraryFixups{false};
@@ -138,6 +154,8 @@ class Linker {
     private:
         /// path from which the file is loaded
         const char * _Nonnull path;
+        /// flags from the task's launch info structure
+        uintptr_t launchFlags{0};
 
         /// ELF reader for the executable
         ElfExecReader * _Nullable exec{nullptr};
@@ -152,6 +170,13 @@ class Linker {
         uintptr_t soSlide{0};
         /// memory address holding program entry point
         uintptr_t entryAddr{0};
+        /// whether jump table relocations are bound lazily
+        bool lazyBinding{false};
+
+        /// launch closure used to load the executable, if any
+        LaunchClosure * _Nullable closure{nullptr};
+        /// launch closure being recorded, if the executable didn't have one
+        ClosureBuilder * _Nullable closureBuilder{nullptr};
 
         /// executable initializer functions
         std::list<void(*)(void)> execInitFuncs;
@@ -168,8 +193,8 @@ class Linker {
         struct hashmap_s loaded;
 
         /**
-         * Symbol registration map; all symbols from loaded dynamic libraries are stored in here
-         * so we can look them up later, during relocations and during runtime.
+         * Symbol map; the symbol tables of all loaded dynamic libraries are registered here so we
+         * can look up symbols later, during relocations and during runtime.
          */
         SymbolMap * _Nonnull map;
 };
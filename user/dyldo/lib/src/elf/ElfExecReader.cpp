@@ -124,9 +124,16 @@ void ElfExecReader::loadTlsTemplate(const Elf_Phdr &hdr) {
         tdata = std::span<std::byte>(reinterpret_cast<std::byte *>(hdr.p_vaddr), hdr.p_filesz);
     }
 
-    // record this information, alongside the TOTAL size of the TLS
+    // record this information, alongside the TOTAL size of the TLS and its alignment
     const size_t tlsSize = hdr.p_memsz;
-    Linker::the()->setExecTlsRequirements(tlsSize, tdata);
+    Linker::the()->setExecTlsRequirements(tlsSize, hdr.p_align, tdata);
+}
+
+/**
+ * Gets the offset of the executable's TLS from the thread pointer; it ends right below it.
+ */
+off_t ElfExecReader::getTlsOffset() {
+    return -static_cast<off_t>(Linker::the()->getTls()->getExecSize());
 }
 
 /**
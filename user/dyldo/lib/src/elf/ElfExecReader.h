@@ -23,10 +23,17 @@ class ElfExecReader: public ElfReader {
             this->init();
         }
 
+        /// Returns the offset of the executable's TLS from the thread pointer.
+        off_t getTlsOffset() override;
+
         /// Processes the given relocations.
         void processRelocs(const PaddedArray<Elf_Rel> &rels) override {
             this->patchRelocs(rels, 0);
         }
+        /// Processes the given jump table relocations.
+        void processPltRelocs(const PaddedArray<Elf_Rel> &rels, const bool lazy) override {
+            this->patchPltRelocs(rels, 0, lazy);
+        }
         /// Finds all initialization and termination functions and registers them.
         void exportInitFiniFuncs();
 
@@ -32,6 +32,47 @@ ElfLibReader::~ElfLibReader() {
 
 }
 
+/**
+ * Checks whether the given file is a shared library for the current architecture, with program
+ * headers that are contained in the file. These are the same checks the reader performs when it's
+ * instantiated, except that failures are reported rather than aborting.
+ *
+ * This is used for files whose paths were cached (such as in a launch closure) and which may have
+ * since been replaced.
+ */
+bool ElfLibReader::IsLoadable(FILE *file) {
+    Elf_Ehdr hdr;
+
+    // get the file size, then read the header
+    if(fseek(file, 0, SEEK_END)) return false;
+    const auto fileSize = ftell(file);
+    if(fileSize < static_cast<long>(sizeof hdr)) return false;
+
+    if(fseek(file, 0, SEEK_SET)) return false;
+    if(fread(&hdr, 1, sizeof hdr, file) != sizeof hdr) return false;
+
+    // validate its identity
+    if(strncmp(reinterpret_cast<const char *>(hdr.e_ident), ELFMAG, SELFMAG)) return false;
+#if defined(__i386__)
+    if(hdr.e_ident[EI_CLASS] != ELFCLASS32 || hdr.e_machine != EM_386) return false;
+#elif defined(__amd64__)
+    if(hdr.e_ident[EI_CLASS] != ELFCLASS64 || hdr.e_machine != EM_X86_64) return false;
+#endif
+    if(hdr.e_ident[EI_DATA] != ELFDATA2LSB || hdr.e_ident[EI_VERSION] != EV_CURRENT ||
+            hdr.e_version != EV_CURRENT) {
+        return false;
+    }
+
+    // and that it's a library, whose program headers we can read
+    if(hdr.e_type != ET_DYN || hdr.e_shentsize != sizeof(Elf_Shdr) ||
+            hdr.e_phentsize != sizeof(Elf_Phdr) || !hdr.e_phnum) {
+        return false;
+    }
+
+    const auto phdrEnd = hdr.e_phoff + (static_cast<uint64_t>(hdr.e_phnum) * sizeof(Elf_Phdr));
+    return (phdrEnd <= static_cast<uint64_t>(fileSize));
+}
+
 /**
  * Validates that the file is an executable.
  */
@@ -158,27 +199,12 @@ void ElfLibReader::loadDynamicInfo() {
 }
 
 /**
- * Extracts all symbols from the library, and registers them with the linker. We'll in turn point
- * at the specified runtime library structure.
+ * Registers the library's symbol table with the linker, so that symbols it exports can be found.
+ * The symbols themselves aren't copied; they're looked up in the library's hash table as needed.
  */
 void ElfLibReader::exportSymbols(Library *lib) {
-    for(const auto &sym : this->symtab) {
-        // ignore symbols that aren't defined in this file
-        if(sym.st_shndx == STN_UNDEF) continue;
-
-        // get its name
-        auto namePtr = this->readStrtab(sym.st_name);
-
-        // XXX: skip _start exported from dynamic libs
-        if(!strcmp(namePtr, "_start")) {
-            continue;
-        }
-
-        auto name = lib->strings.add(namePtr);
-
-        // register it
-        Linker::the()->exportSymbol(name, sym, lib);
-    }
+    lib->symbols = this->symbols;
+    Linker::the()->exportSymbols(lib);
 }
 
 /**
@@ -299,12 +325,30 @@ void ElfLibReader::exportThreadLocals(Library *lib) {
             tdata = std::span<std::byte>(reinterpret_cast<std::byte *>(hdr.p_vaddr), hdr.p_filesz);
         }
 
-        // record this information, alongside the TOTAL size of the TLS
+        // record this information, alongside the TOTAL size of the TLS and its alignment
         const size_t tlsSize = hdr.p_memsz;
-        Linker::the()->setLibTlsRequirements(tlsSize, tdata, lib);
+        Linker::the()->setLibTlsRequirements(tlsSize, hdr.p_align, tdata, lib);
+        this->tlsLibrary = lib;
     }
 
     // clean up
     free(phdrs);
 }
 
+/**
+ * Gets the offset of the library's TLS region from the thread pointer. This is used to resolve TLS
+ * relocations that don't reference a symbol, such as initial-exec accesses to the library's own
+ * (non-preemptible) thread-locals.
+ */
+off_t ElfLibReader::getTlsOffset() {
+    if(!this->tlsLibrary) {
+        Linker::Abort("TLS relocation in %s, which has no TLS segment", this->path);
+    }
+
+    const auto off = Linker::the()->getTls()->getLibTlsOffset(this->tlsLibrary);
+    if(!off) {
+        Linker::Abort("Invalid TLS offset for %s: %ld", this->path, static_cast<long>(off));
+    }
+    return off;
+}
+
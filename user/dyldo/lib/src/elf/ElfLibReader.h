@@ -13,25 +13,31 @@ namespace dyldo {
  * ELF reader specialized for shared libraries.
  */
 class ElfLibReader: public ElfReader {
-    friend class SymbolMap;
-
     public:
         ElfLibReader(const uintptr_t vmBase, FILE * _Nonnull file, const char * _Nonnull path);
         ElfLibReader(const uintptr_t vmBase, const char * _Nonnull path);
         virtual ~ElfLibReader();
 
+        /// Tests whether the file is a shared library we could load, without aborting if not.
+        static bool IsLoadable(FILE * _Nonnull file);
+
         /// Loads the contents of the library and maps them into memory.
         void mapContents();
-        /// Registers all symbols exported from the ELF and registers them.
+        /// Registers the library's symbol table with the linker.
         void exportSymbols(Library * _Nonnull lib);
         /// Finds all initialization and termination functions and registers them.
         void exportInitFiniFuncs(Library * _Nonnull lib);
         /// Defines the library's thread-local storage requirements.
         void exportThreadLocals(Library * _Nonnull lib);
 
+        off_t getTlsOffset() override;
+
         void processRelocs(const PaddedArray<Elf_Rel> &rels) override {
             this->patchRelocs(rels, this->base);
         }
+        void processPltRelocs(const PaddedArray<Elf_Rel> &rels, const bool lazy) override {
+            this->patchPltRelocs(rels, this->base, lazy);
+        }
 
         /// Total of VM space required for the library; rounded up to the nearest page.
         const size_t getVmRequirements() const;
@@ -54,6 +60,8 @@ class ElfLibReader: public ElfReader {
     private:
         /// Virtual memory base address at which this library is loaded
         uintptr_t base = 0;
+        /// Library that owns this reader's TLS region, if it has any thread-locals
+        Library * _Nullable tlsLibrary = nullptr;
 };
 }
 
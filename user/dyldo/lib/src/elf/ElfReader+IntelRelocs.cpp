@@ -4,6 +4,7 @@
 #include "ElfReader.h"
 #include "Library.h"
 #include "Linker.h"
+#include "link/LazyBinder.h"
 
 #include <cstdlib>
 #include <cstdio>
@@ -17,6 +18,7 @@ using namespace dyldo;
  * Performs i386-style relocations
  */
 void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_t base) {
+    SymbolMap::Symbol resolved;
     const SymbolMap::Symbol *symbol;
 
     // process each relocation
@@ -37,6 +39,12 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
                 // translate the symbol index into a name
                 const auto symIdx = ELF32_R_SYM(rel.r_info);
                 const auto sym = this->symtab[symIdx];
+
+                if(symIdx == STN_UNDEF) {
+                    symbol = nullptr;
+                    break;
+                }
+
                 const auto name = this->readStrtab(sym.st_name);
                 if(!name) {
                     Linker::Abort("failed to resolve name for symbol %u (off %x info %x base %x)",
@@ -44,10 +52,10 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
                 }
 
                 // resolve to symbol
-                symbol = Linker::the()->resolveSymbol(name);
-                if(!symbol) {
+                if(!Linker::the()->bindSymbol(this->objectIndex, symIdx, name, resolved)) {
                     Linker::Abort("failed to resolve symbol '%s'", name);
                 }
+                symbol = &resolved;
                 break;
             }
 
@@ -125,6 +133,9 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
              * Thread-local offset for an object. When we look up the symbol, we must add to it the
              * TLS offset for the object, which we acquire from the thread-local handler. This will
              * produce a negative value.
+             *
+             * If there's no symbol, the relocation refers to a thread-local in this object, at the
+             * offset stored in the relocated location.
              */
             case R_386_TLS_TPOFF: {
                 // read current TLS value
@@ -132,17 +143,20 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
                 auto from = reinterpret_cast<void *>(base + rel.r_offset);
                 memcpy(&value, from, sizeof(value));
 
-                // add to it the library's TLS offset
-                auto tls = Linker::the()->getTls();
-                auto off = tls->getLibTlsOffset(symbol->library);
-                if(!off) {
-                    Linker::Abort("Invalid TLS offset for '%s' in %s: %d", symbol->name,
-                            symbol->library->soname, off);
+                if(!symbol) {
+                    value += this->getTlsOffset();
                 }
+                else {
+                    // add to it the library's TLS offset
+                    auto tls = Linker::the()->getTls();
+                    auto off = tls->getLibTlsOffset(symbol->library);
+                    if(!off) {
+                        Linker::Abort("Invalid TLS offset for '%s' in %s: %d", symbol->name,
+                                symbol->library->soname, off);
+                    }
 
-                // XXX: do we need to subtract the exec size?
-                //Linker::Trace("Original value: %08x sym %s addr %08x", value, symbol->name, symbol->address);
-                value += off - tls->getExecSize() + symbol->address;
+                    value += off + symbol->address;
+                }
                 //Linker::Trace("Relocation for '%s': off %d -> %08x", symbol->name, off, value);
 
                 // write it back
@@ -156,10 +170,14 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
              * This writes the module index in which this thread-local object is defined.
              */
             case R_386_TLS_DTPMOD32: {
-                // get module id (in this case, the TLS offset)
+                // get module id (in this case, the TLS offset from the thread pointer)
                 uint32_t value = 0;
-                auto tls = Linker::the()->getTls();
-                value = tls->getLibTlsOffset(symbol->library);
+                if(!symbol) {
+                    value = this->getTlsOffset();
+                } else {
+                    auto tls = Linker::the()->getTls();
+                    value = tls->getLibTlsOffset(symbol->library);
+                }
 
                 // write the value
                 auto from = reinterpret_cast<void *>(base + rel.r_offset);
@@ -173,6 +191,9 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
              * this case, it's the raw "address" of the symbol.
              */
             case R_386_TLS_DTPOFF32: {
+                // without a symbol, the offset is already in place
+                if(!symbol) break;
+
                 uint32_t value = symbol->address;
 
                 // write the value
@@ -194,6 +215,7 @@ void ElfReader::patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_
  * Performs AMD64 relocations
  */
 void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintptr_t base) {
+    SymbolMap::Symbol resolved;
     const SymbolMap::Symbol *symbol;
 
     // ensure stride is valid
@@ -233,10 +255,10 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
                 }
 
                 // resolve to symbol
-                symbol = Linker::the()->resolveSymbol(name);
-                if(!symbol) {
+                if(!Linker::the()->bindSymbol(this->objectIndex, symIdx, name, resolved)) {
                     Linker::Abort("failed to resolve symbol '%s'", name);
                 }
+                symbol = &resolved;
                 break;
             }
 
@@ -311,11 +333,12 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
 
                 /*
                  * It's possible that there's a TPOFF64 relocation that does NOT have a symbol that
-                 * is associated with it. In that case, we just have to get the base address of
-                 * the executable's TLS segment.
+                 * is associated with it; the linker emits these for initial-exec accesses to an
+                 * object's own thread-locals. The addend is then the offset into this object's TLS
+                 * region.
                  */
                 if(!symbol) {
-                    value = tls->getExecSize() + rel.r_addend;
+                    value = this->getTlsOffset() + rel.r_addend;
                 }
                 else {
                     // add to it the library's TLS offset
@@ -326,7 +349,7 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
                     }
 
                     // calculate offset and write back
-                    value = off - tls->getExecSize() + symbol->address + rel.r_addend;\
+                    value = off + symbol->address + rel.r_addend;
                 }
 
                 // write offset
@@ -336,10 +359,14 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
 
             /// Writes the module index in which this thread-local object is defined.
             case R_X86_64_DTPMOD64: {
-                // get module id (in this case, the TLS offset)
+                // get module id (in this case, the TLS offset from the thread pointer)
                 uint64_t value = 0;
-                auto tls = Linker::the()->getTls();
-                value = tls->getLibTlsOffset(symbol->library);
+                if(!symbol) {
+                    value = this->getTlsOffset();
+                } else {
+                    auto tls = Linker::the()->getTls();
+                    value = tls->getLibTlsOffset(symbol->library);
+                }
 
                 // write the value
                 auto dest = reinterpret_cast<void *>(base + rel.r_offset);
@@ -349,7 +376,7 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
 
             /// Writes the offset of a TLS variable in the originating module's TLS block
             case R_X86_64_DTPOFF64: {
-                uint64_t value = symbol->address + rel.r_addend;
+                uint64_t value = (symbol ? symbol->address : 0) + rel.r_addend;
 
                 auto dest = reinterpret_cast<void *>(base + rel.r_offset);
                 memcpy(dest, &value, sizeof(value));
@@ -363,3 +390,53 @@ void ElfReader::patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintpt
         }
     }
 }
+
+/**
+ * Sets up lazy binding of AMD64 jump slot relocations.
+ *
+ * The second and third entries of the object's GOT are filled with the lazy binder for the object
+ * and the address of the lazy binding trampoline; the PLT pushes the former before jumping to the
+ * latter. Each GOT entry initially points back into its PLT entry, so for libraries, the load
+ * address has to be added to it.
+ *
+ * @return Whether lazy binding was set up; if not, the relocations must be processed now.
+ */
+bool ElfReader::bindLazilyAmd64(const PaddedArray<Elf_Rela> &rels, const uintptr_t base) {
+    // we can only handle jump slots lazily
+    for(const auto &rel : rels) {
+        if(ELF_R_TYPE(rel.r_info) != R_X86_64_JMP_SLOT) {
+            return false;
+        }
+    }
+
+    // find the GOT
+    uintptr_t pltGot{0};
+    for(const auto &entry : this->dynInfo) {
+        if(entry.d_tag == DT_PLTGOT) {
+            pltGot = this->rebaseVmAddr(entry.d_un.d_ptr);
+            break;
+        }
+    }
+
+    if(!pltGot) {
+        return false;
+    }
+
+    // install the binder and trampoline
+    auto binder = new LazyBinder(this->path, base, rels, this->symtab, this->strtab);
+    if(!binder) Linker::Abort("out of memory");
+
+    auto got = reinterpret_cast<uintptr_t *>(pltGot);
+    got[1] = reinterpret_cast<uintptr_t>(binder);
+    got[2] = reinterpret_cast<uintptr_t>(&__dyldo_lazy_bind_entry);
+
+    // rebase the GOT entries
+    if(base) {
+        for(const auto &rel : rels) {
+            auto slot = reinterpret_cast<uintptr_t *>(base + rel.r_offset);
+            *slot += base;
+        }
+    }
+
+    return true;
+}
@@ -5,6 +5,7 @@
 
 #include <PacketTypes.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -88,6 +89,33 @@ void ElfReader::getFilesize() {
     }
 }
 
+/**
+ * Calculates a hash identifying this particular version of the file. It covers the entire contents
+ * of the file; together with the file size, this is used to validate launch closures.
+ */
+uint64_t ElfReader::getIdentityHash() {
+    constexpr static const uint64_t kHashPrime{0x100000001b3ULL};
+    constexpr static const size_t kChunkSize{0x4000};
+    uint64_t hash{0xcbf29ce484222325ULL};
+
+    auto buf = reinterpret_cast<uint8_t *>(malloc(kChunkSize));
+    if(!buf) Linker::Abort("out of memory");
+
+    // FNV-1a, over the file in chunks
+    for(size_t off = 0; off < this->fileSize; off += kChunkSize) {
+        const auto bytes = std::min(kChunkSize, this->fileSize - off);
+        this->read(bytes, buf, off);
+
+        for(size_t i = 0; i < bytes; i++) {
+            hash ^= buf[i];
+            hash *= kHashPrime;
+        }
+    }
+
+    free(buf);
+    return hash;
+}
+
 /**
  * Validates an ELF header.
  */
@@ -215,7 +243,7 @@ const char *ElfReader::readStrtab(const size_t i) {
  */
 void ElfReader::parseDynamicInfo() {
     // extract the string table and symbol table offset
-    uintptr_t strtabAddr = 0, symtabAddr = 0;
+    uintptr_t strtabAddr = 0, symtabAddr = 0, gnuHashAddr = 0, sysvHashAddr = 0;
     size_t strtabLen = 0, symtabItemLen = 0;
 
     for(const auto &entry : this->dynInfo) {
@@ -234,6 +262,13 @@ void ElfReader::parseDynamicInfo() {
                 symtabItemLen = entry.d_un.d_val;
                 break;
 
+            case DT_GNU_HASH:
+                gnuHashAddr = this->rebaseVmAddr(entry.d_un.d_ptr);
+                break;
+            case DT_HASH:
+                sysvHashAddr = this->rebaseVmAddr(entry.d_un.d_ptr);
+                break;
+
             default:
                 break;
         }
@@ -271,6 +306,15 @@ void ElfReader::parseDynamicInfo() {
         }
     }
 
+    // set up symbol lookups; prefer the GNU hash table
+    this->symbols = SymbolTable(this->symtab, this->strtab);
+
+    if(gnuHashAddr) {
+        this->symbols.setGnuHash(gnuHashAddr);
+    } else if(sysvHashAddr) {
+        this->symbols.setSysvHash(sysvHashAddr);
+    }
+
     // read dependencies
     this->readDeps();
 
@@ -421,6 +465,51 @@ void ElfReader::patchRelocs(const PaddedArray<Elf_Rel> &rels, const uintptr_t ba
 }
 
 
+/**
+ * Processes the jump table (PLT) relocations of the object. When lazy binding is requested and
+ * supported for the object, the GOT is set up so that each entry is resolved on first use;
+ * otherwise, all entries are resolved now.
+ *
+ * @param base An offset to add to virtual addresses of symbols to turn them into absolute addresses.
+ */
+void ElfReader::patchPltRelocs(const PaddedArray<Elf_Rel> &rels, const uintptr_t base,
+        const bool lazy) {
+#if defined(__amd64__)
+    if(lazy && this->elfMachine == EM_X86_64) {
+        auto rela = reinterpret_cast<const PaddedArray<Elf_Rela> &>(rels);
+        if(this->bindLazilyAmd64(rela, base)) {
+            return;
+        }
+    }
+#endif
+
+    this->patchRelocs(rels, base);
+}
+
+/**
+ * Checks whether the object was linked with `-z now`, in which case all of its symbols must be
+ * bound when it's loaded.
+ */
+bool ElfReader::wantsBindNow() const {
+    for(const auto &entry : this->dynInfo) {
+        switch(entry.d_tag) {
+            case DT_BIND_NOW:
+                return true;
+            case DT_FLAGS:
+                if(entry.d_un.d_val & DF_BIND_NOW) return true;
+                break;
+            case DT_FLAGS_1:
+                if(entry.d_un.d_val & DF_1_BIND_NOW) return true;
+                break;
+
+            default:
+                continue;
+        }
+    }
+
+    return false;
+}
+
 /**
  * Parses all of the DT_NEEDED entries out of the provided dynamic table, and creates an entry for
  * the associated library.
@@ -574,33 +663,33 @@ bool ElfReader::hasDyldosrv() {
 }
 
 /**
- * Sends an RPC request to the dynamic link server, if possible, to map the segment.
+ * Sends a request to the dynamic link server, and waits for its reply.
+ *
+ * @param type Message type of the request
+ * @param payload Request payload, copied into the message
+ * @param replyType Expected message type of the reply
+ * @param replyBytes Minimum size of the reply payload
+ *
+ * @return Pointer to the reply payload; it's valid until the next request is sent.
  */
-void ElfReader::loadSegmentShared(const Elf_Phdr &phdr, const uintptr_t base, Segment &seg) {
+const void *ElfReader::DyldosrvCall(const DyldosrvMessageType type, const void *payload,
+        const size_t payloadBytes, const DyldosrvMessageType replyType, const size_t replyBytes) {
     int err;
 
     // allocate the buffer for the request
     void *msgBuf;
-    const auto pathBytes = strlen(this->path) + 2;
-    const auto msgBytes = sizeof(rpc::RpcPacket) + sizeof(DyldosrvMapSegmentRequest) + pathBytes;
+    const auto msgBytes = sizeof(rpc::RpcPacket) + payloadBytes;
 
     err = posix_memalign(&msgBuf, 16, msgBytes);
     if(err) {
         Linker::Abort("%s failed: %d", "posix_memalign", err);
     }
 
-    memset(msgBuf, 0, msgBytes);
-
     auto outPacket = reinterpret_cast<rpc::RpcPacket *>(msgBuf);
+    memset(outPacket, 0, sizeof(*outPacket));
     outPacket->replyPort = gRpcReplyPort;
-    outPacket->type = static_cast<uint32_t>(DyldosrvMessageType::MapSegment);
-
-    // build the message
-    auto msg = reinterpret_cast<DyldosrvMapSegmentRequest *>(outPacket->payload);
-
-    msg->objectVmBase = base;
-    memcpy(&msg->phdr, &phdr, sizeof(phdr));
-    strncpy(msg->path, this->path, pathBytes);
+    outPacket->type = static_cast<uint32_t>(type);
+    memcpy(outPacket->payload, payload, payloadBytes);
 
     // send it :)
     err = PortSend(gRpcServerPort, msgBuf, msgBytes);
@@ -619,17 +708,41 @@ void ElfReader::loadSegmentShared(const Elf_Phdr &phdr, const uintptr_t base, Se
     }
 
     // validate it
-    if(replyMsg->receivedBytes < sizeof(rpc::RpcPacket) + sizeof(DyldosrvMapSegmentReply)) {
+    if(replyMsg->receivedBytes < sizeof(rpc::RpcPacket) + replyBytes) {
         Linker::Abort("RPC reply too small (%lu bytes)", replyMsg->receivedBytes);
     }
 
     auto packet = reinterpret_cast<const rpc::RpcPacket *>(replyMsg->data);
-    if(packet->type != static_cast<uint32_t>(DyldosrvMessageType::MapSegmentReply)) {
+    if(packet->type != static_cast<uint32_t>(replyType)) {
         Linker::Abort("Invalid RPC reply type %08x", packet->type);
     }
 
-    // handle failures
-    auto reply = reinterpret_cast<const DyldosrvMapSegmentReply *>(packet->payload);
+    return packet->payload;
+}
+
+/**
+ * Sends an RPC request to the dynamic link server, if possible, to map the segment.
+ */
+void ElfReader::loadSegmentShared(const Elf_Phdr &phdr, const uintptr_t base, Segment &seg) {
+    // build the request
+    const auto pathBytes = strlen(this->path) + 2;
+    const auto msgBytes = sizeof(DyldosrvMapSegmentRequest) + pathBytes;
+
+    auto msg = reinterpret_cast<DyldosrvMapSegmentRequest *>(malloc(msgBytes));
+    if(!msg) Linker::Abort("out of memory");
+
+    memset(msg, 0, msgBytes);
+
+    msg->objectVmBase = base;
+    memcpy(&msg->phdr, &phdr, sizeof(phdr));
+    strncpy(msg->path, this->path, pathBytes);
+
+    // send it and handle failures
+    auto reply = reinterpret_cast<const DyldosrvMapSegmentReply *>(DyldosrvCall(
+                DyldosrvMessageType::MapSegment, msg, msgBytes,
+                DyldosrvMessageType::MapSegmentReply, sizeof(DyldosrvMapSegmentReply)));
+    free(msg);
+
     if(reply->status) {
         Linker::Abort("Failed to map shared region (off $%x len $%x) in %s: %d", phdr.p_offset,
                 phdr.p_memsz, this->path, reply->status);
@@ -2,6 +2,8 @@
 #define DYLDO_ELF_ELFREADER_H
 
 #include "Linker.h"
+#include <PacketTypes.h>
+#include "link/SymbolTable.h"
 #include "struct/PaddedArray.h"
 
 #include <cstdarg>
@@ -53,8 +55,31 @@ class ElfReader {
             return this->deps;
         }
 
+        /// Gets the size of the file, in bytes
+        size_t getFileSize() const {
+            return this->fileSize;
+        }
+        /// Calculates a hash that identifies this version of the file
+        uint64_t getIdentityHash();
+
+        /// Index of the object in the launch closure (0 is the executable)
+        uint32_t getObjectIndex() const {
+            return this->objectIndex;
+        }
+        /// Sets the index of the object in the launch closure
+        void setObjectIndex(const uint32_t index) {
+            this->objectIndex = index;
+        }
+
+        /// Return the offset of the object's own TLS from the thread pointer.
+        virtual off_t getTlsOffset() = 0;
+
         /// Applies the given relocations.
         virtual void processRelocs(const PaddedArray<Elf_Rel> &rels) = 0;
+        /// Applies the given jump table relocations, binding them lazily if possible.
+        virtual void processPltRelocs(const PaddedArray<Elf_Rel> &rels, const bool lazy) = 0;
+        /// Whether the object requests that all symbols be bound at load time
+        bool wantsBindNow() const;
         /// Gets the dynamic (data) relocation entries
         bool getDynRels(PaddedArray<Elf_Rel> &outRels);
         /// Gets the jump table (PLT) relocations
@@ -69,6 +94,13 @@ class ElfReader {
         /// Protects all loaded segments.
         void applyProtection();
 
+        /// Checks if the dynamic link server is available.
+        static bool hasDyldosrv();
+        /// Sends a request to the dynamic link server and waits for the reply.
+        static const void * _Nonnull DyldosrvCall(const DyldosrvMessageType type,
+                const void * _Nonnull payload, const size_t payloadBytes,
+                const DyldosrvMessageType replyType, const size_t replyBytes);
+
     protected:
         /// Loads a segment described by a program header into memory.
         void loadSegment(const Elf_Phdr &phdr, const uintptr_t base = 0);
@@ -80,12 +112,16 @@ class ElfReader {
 
         /// Processes relocations.
         void patchRelocs(const PaddedArray<Elf_Rel> &rels, const uintptr_t base);
+        /// Processes jump table relocations.
+        void patchPltRelocs(const PaddedArray<Elf_Rel> &rels, const uintptr_t base,
+                const bool lazy);
 
 #if defined(__i386__) || defined(__amd64__)
         void patchRelocsi386(const PaddedArray<Elf_Rel> &rels, const uintptr_t base);
 #endif
 #if defined(__amd64__)
         void patchRelocsAmd64(const PaddedArray<Elf_Rela> &rels, const uintptr_t base);
+        bool bindLazilyAmd64(const PaddedArray<Elf_Rela> &rels, const uintptr_t base);
 #endif
 
 
@@ -157,8 +193,6 @@ class ElfReader {
         };
 
     private:
-        /// Checks if the dynamic link server is available.
-        bool hasDyldosrv();
         /// Loads a shareable segment
         void loadSegmentShared(const Elf_Phdr &phdr, const uintptr_t base, Segment &seg);
 
@@ -179,6 +213,8 @@ class ElfReader {
         std::span<char> strtab;
         /// symbol table
         std::span<Elf_Sym> symtab;
+        /// lookup structure for symbols defined by this object
+        SymbolTable symbols;
 
         /// file offset to get to section headers
         uintptr_t shdrOff = 0;
@@ -201,6 +237,8 @@ class ElfReader {
 
         // copy of the path this file was read from
         char * _Nullable path{nullptr};
+        /// index of this object in the launch closure
+        uint32_t objectIndex{0};
 
     private:
         /// DyldoServer remote request port
@@ -6,6 +6,7 @@
 
 #include "Linker.h"
 #include "LaunchInfo.h"
+#include "link/LazyBinder.h"
 
 using namespace dyldo;
 
@@ -20,7 +21,8 @@ extern "C" void dyldo_start(const kush_task_launchinfo_t *info) {
     }
 
     // handle the linking process
-    Linker::init(info->loadPath);
+    LazyBinder::Init();
+    Linker::init(info);
 
     Linker::Trace("Loading libraries");
     Linker::the()->loadLibs();
@@ -0,0 +1,429 @@
+#include "LaunchClosure.h"
+#include "Library.h"
+#include "Linker.h"
+
+#include "elf/ElfReader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/syscalls.h>
+
+using namespace dyldo;
+
+bool ClosureBuilder::gLogSubmit = false;
+
+/**
+ * Requests the launch closure for the executable at the given path from the dynamic link server.
+ *
+ * @return The closure, if there is a valid one, or `nullptr` otherwise.
+ */
+LaunchClosure *LaunchClosure::Load(const char *execPath) {
+#if defined(__amd64__)
+    if(!ElfReader::hasDyldosrv()) {
+        return nullptr;
+    }
+
+    // build the request
+    const auto pathBytes = strlen(execPath) + 1;
+    const auto msgBytes = sizeof(DyldosrvGetClosureRequest) + pathBytes;
+
+    auto msg = reinterpret_cast<DyldosrvGetClosureRequest *>(malloc(msgBytes));
+    if(!msg) Linker::Abort("out of memory");
+
+    msg->mapAt = kMapBase;
+    msg->mapLength = kDyldoClosureMaxLength;
+    memcpy(msg->path, execPath, pathBytes);
+
+    // send it
+    auto reply = reinterpret_cast<const DyldosrvGetClosureReply *>(ElfReader::DyldosrvCall(
+                DyldosrvMessageType::GetClosure, msg, msgBytes,
+                DyldosrvMessageType::GetClosureReply, sizeof(DyldosrvGetClosureReply)));
+    free(msg);
+
+    if(reply->status) {
+        if(reply->status != DyldosrvErrors::NoClosure) {
+            Linker::Info("Failed to get launch closure for %s: %d", execPath, reply->status);
+        }
+        return nullptr;
+    }
+
+    // validate it
+    auto closure = new LaunchClosure(reply->vmRegion, kMapBase, reply->length);
+    if(!closure->validate()) {
+        Linker::Info("Ignoring invalid launch closure for %s", execPath);
+        delete closure;
+        return nullptr;
+    }
+
+    return closure;
+#else
+    return nullptr;
+#endif
+}
+
+/**
+ * Sets up a closure that's mapped at the given address.
+ */
+LaunchClosure::LaunchClosure(const uintptr_t _region, const uintptr_t base, const size_t _length) :
+    region(_region), header(reinterpret_cast<const Header *>(base)), length(_length) {
+}
+
+/**
+ * Unmaps the closure.
+ */
+LaunchClosure::~LaunchClosure() {
+    int err = UnmapVirtualRegion(this->region);
+    if(err) {
+        Linker::Abort("%s failed: %d", "UnmapVirtualRegion", err);
+    }
+}
+
+/**
+ * Ensures the closure is well formed: that is, all arrays and strings it references are inside
+ * the closure.
+ */
+bool LaunchClosure::validate() {
+    const auto hdr = this->header;
+    const auto base = reinterpret_cast<uintptr_t>(hdr);
+
+    if(this->length < sizeof(Header) || hdr->common.magic != kDyldoClosureMagic ||
+            hdr->common.version != kDyldoClosureVersion || hdr->common.length != this->length) {
+        return false;
+    }
+
+    // check the extents of each of the arrays
+    auto inBounds = [&](const size_t off, const size_t bytes) {
+        return off <= this->length && bytes <= (this->length - off);
+    };
+
+    if(!hdr->numObjects || hdr->objectsOff % alignof(Object) || hdr->bindingsOff % alignof(Binding)) {
+        return false;
+    } else if(!inBounds(hdr->objectsOff, sizeof(Object) * hdr->numObjects) ||
+            !inBounds(hdr->bindingsOff, sizeof(Binding) * hdr->numBindings) ||
+            !inBounds(hdr->stringsOff, hdr->stringsLen)) {
+        return false;
+    }
+
+    this->objects = std::span<const Object>(reinterpret_cast<const Object *>(base +
+                hdr->objectsOff), hdr->numObjects);
+    this->bindings = std::span<const Binding>(reinterpret_cast<const Binding *>(base +
+                hdr->bindingsOff), hdr->numBindings);
+    this->strings = std::span<const char>(reinterpret_cast<const char *>(base + hdr->stringsOff),
+            hdr->stringsLen);
+
+    if(this->strings.empty() || this->strings.back() != '\0') {
+        return false;
+    }
+
+    // then, each object
+    for(const auto &obj : this->objects) {
+        if(obj.path >= this->strings.size() || obj.soname >= this->strings.size()) {
+            return false;
+        } else if(obj.firstBinding > this->bindings.size() ||
+                obj.numBindings > (this->bindings.size() - obj.firstBinding)) {
+            return false;
+        }
+    }
+
+    this->libraries.resize(this->objects.size(), nullptr);
+    return true;
+}
+
+/**
+ * Checks whether the file the given reader was opened on is identical to the one that the object
+ * was loaded from when the closure was recorded.
+ */
+bool LaunchClosure::matches(const size_t i, ElfReader *reader) const {
+    const auto &obj = this->objects[i];
+    return (obj.fileSize == reader->getFileSize()) && (obj.hash == reader->getIdentityHash());
+}
+
+/**
+ * Records the library structure for an object, once it's been loaded.
+ */
+void LaunchClosure::setLibrary(const size_t i, Library *library) {
+    this->libraries[i] = library;
+}
+
+/**
+ * Looks up the binding recorded for a symbol referenced by an object, and reads the symbol's
+ * information from the symbol table of the library that provides it.
+ *
+ * The providing symbol table entry must be a definition of a symbol with the same name; otherwise,
+ * the binding is ignored.
+ *
+ * @param object Index of the object whose relocations reference the symbol
+ * @param symbol Index of the symbol in the object's symbol table
+ * @param name Name of the symbol
+ * @param outSymbol Filled with the symbol's information
+ *
+ * @return Whether a binding was recorded; if not, the symbol must be looked up.
+ */
+bool LaunchClosure::getBinding(const uint32_t object, const uint32_t symbol, const char *name,
+        SymbolMap::Symbol &outSymbol) const {
+    if(object >= this->objects.size()) {
+        return false;
+    }
+
+    const auto &obj = this->objects[object];
+    const auto objBindings = this->bindings.subspan(obj.firstBinding, obj.numBindings);
+
+    auto it = std::lower_bound(objBindings.begin(), objBindings.end(), symbol,
+            [](const Binding &b, const uint32_t sym) {
+        return b.symbol < sym;
+    });
+    if(it == objBindings.end() || it->symbol != symbol) {
+        return false;
+    }
+
+    // get the library that provides it, and its symbol table entry
+    if(it->object <= 0 || static_cast<size_t>(it->object) >= this->libraries.size()) {
+        return false;
+    }
+
+    auto library = this->libraries[it->object];
+    if(!library) {
+        return false;
+    }
+
+    auto sym = library->symbols.get(it->providerSymbol);
+    if(!sym || sym->st_shndx == SHN_UNDEF || strcmp(library->symbols.getName(*sym), name)) {
+        return false;
+    }
+
+    switch(ELF_ST_TYPE(sym->st_info)) {
+        case STT_OBJECT:
+        case STT_FUNC:
+        case STT_TLS:
+            break;
+        default:
+            return false;
+    }
+
+    SymbolMap::MakeSymbol(name, *sym, library, outSymbol);
+    return true;
+}
+
+
+
+/**
+ * Starts recording a launch closure for the given executable.
+ */
+ClosureBuilder::ClosureBuilder(ElfReader *exec, const char *_execPath) : execPath(_execPath) {
+    exec->setObjectIndex(0);
+    this->objects.push_back({_execPath, "", nullptr, exec->getFileSize(),
+            exec->getIdentityHash(), 0, {}});
+}
+
+/**
+ * Records a library that was loaded, and assigns its object index.
+ */
+void ClosureBuilder::addLibrary(Library *library, ElfReader *reader) {
+    reader->setObjectIndex(this->objects.size());
+    this->objects.push_back({library->path, library->soname, library, reader->getFileSize(),
+            reader->getIdentityHash(), library->base, {}});
+}
+
+/**
+ * Records the result of looking up a symbol for one of an object's relocations.
+ *
+ * Symbols that didn't come from a library's symbol table are recorded without a providing object,
+ * so that all bindings of that symbol are dropped when the closure is built.
+ */
+void ClosureBuilder::addBinding(const uint32_t object, const uint32_t symbol,
+        const SymbolMap::Symbol &resolved) {
+    if(object >= this->objects.size()) return;
+
+    int32_t provider{-1};
+    if(resolved.index != SymbolMap::kNoIndex) {
+        provider = this->indexOf(resolved.library);
+    }
+
+    LaunchClosure::Binding binding{symbol, provider, resolved.index, 0};
+    this->objects[object].bindings.push_back(binding);
+}
+
+/**
+ * Gets the object index of a library.
+ *
+ * @return Object index, or -1 if the library is null or unknown
+ */
+int32_t ClosureBuilder::indexOf(const Library *library) const {
+    if(!library) return -1;
+
+    for(size_t i = 1; i < this->objects.size(); i++) {
+        if(this->objects[i].library == library) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Sorts the bindings of an object by symbol, and removes duplicates. If a symbol was bound to
+ * different symbol table entries, or to one that can't be recorded (such as after a copy
+ * relocation overrides it) it's dropped, so that it's always looked up.
+ *
+ * @return Number of bindings remaining
+ */
+size_t ClosureBuilder::finalizeBindings(ObjectInfo &object) {
+    auto &b = object.bindings;
+    std::sort(b.begin(), b.end(), [](const auto &l, const auto &r) {
+        return l.symbol < r.symbol;
+    });
+
+    std::vector<LaunchClosure::Binding> out;
+    out.reserve(b.size());
+
+    for(size_t i = 0; i < b.size();) {
+        size_t end = i + 1;
+        bool consistent{b[i].object > 0};
+
+        while(end < b.size() && b[end].symbol == b[i].symbol) {
+            if(b[end].object != b[i].object || b[end].providerSymbol != b[i].providerSymbol) {
+                consistent = false;
+            }
+            end++;
+        }
+
+        if(consistent) {
+            out.push_back(b[i]);
+        }
+        i = end;
+    }
+
+    b = std::move(out);
+    return b.size();
+}
+
+/**
+ * Serializes the closure into a new VM region, then sends it to the dynamic link server, which
+ * copies it out.
+ *
+ * @param soSlide Base address of the shared library region
+ * @param soBase Address at which the next library would be loaded
+ */
+void ClosureBuilder::submit(const uintptr_t soSlide, const uintptr_t soBase) {
+#if defined(__amd64__)
+    using Header = LaunchClosure::Header;
+    using Object = LaunchClosure::Object;
+    using Binding = LaunchClosure::Binding;
+
+    int err;
+    uintptr_t region;
+
+    // calculate the layout
+    size_t numBindings{0}, stringsLen{0};
+    for(auto &obj : this->objects) {
+        numBindings += this->finalizeBindings(obj);
+        stringsLen += strlen(obj.path) + 1 + strlen(obj.soname) + 1;
+    }
+
+    const size_t objectsOff = sizeof(Header);
+    const size_t bindingsOff = objectsOff + (sizeof(Object) * this->objects.size());
+    const size_t stringsOff = bindingsOff + (sizeof(Binding) * numBindings);
+    const size_t length = stringsOff + stringsLen;
+
+    if(length > kDyldoClosureMaxLength) {
+        if(gLogSubmit) Linker::Trace("Launch closure too large (%lu bytes)", length);
+        return;
+    }
+
+    // allocate memory for it
+    const auto pageSz = sysconf(_SC_PAGESIZE);
+    const size_t regionLen = ((length + pageSz - 1) / pageSz) * pageSz;
+
+    err = AllocVirtualAnonRegion(regionLen, VM_REGION_RW, &region);
+    if(err) {
+        Linker::Abort("failed to %s anon region (for %s): %d", "allocate", "closure", err);
+    }
+
+    err = MapVirtualRegion(region, LaunchClosure::kMapBase, regionLen, 0);
+    if(err) {
+        Linker::Abort("failed to %s anon region (for %s) at $%p ($%x bytes): %d", "map",
+                "closure", LaunchClosure::kMapBase, regionLen, err);
+    }
+
+    // write the header and all objects
+    auto base = reinterpret_cast<uint8_t *>(LaunchClosure::kMapBase);
+
+    auto hdr = reinterpret_cast<Header *>(base);
+    hdr->common.magic = kDyldoClosureMagic;
+    hdr->common.version = kDyldoClosureVersion;
+    hdr->common.length = length;
+    hdr->numObjects = this->objects.size();
+    hdr->numBindings = numBindings;
+    hdr->soSlide = soSlide;
+    hdr->soBase = soBase;
+    hdr->objectsOff = objectsOff;
+    hdr->bindingsOff = bindingsOff;
+    hdr->stringsOff = stringsOff;
+    hdr->stringsLen = stringsLen;
+
+    auto objects = reinterpret_cast<Object *>(base + objectsOff);
+    auto bindings = reinterpret_cast<Binding *>(base + bindingsOff);
+    auto strings = reinterpret_cast<char *>(base + stringsOff);
+
+    size_t bindingIdx{0}, stringIdx{0};
+    auto addString = [&](const char *str) -> uint32_t {
+        const auto off = stringIdx;
+        const auto bytes = strlen(str) + 1;
+        memcpy(strings + stringIdx, str, bytes);
+        stringIdx += bytes;
+        return off;
+    };
+
+    for(size_t i = 0; i < this->objects.size(); i++) {
+        const auto &info = this->objects[i];
+        auto &obj = objects[i];
+
+        obj.fileSize = info.fileSize;
+        obj.hash = info.hash;
+        obj.base = info.base;
+        obj.path = addString(info.path);
+        obj.soname = addString(info.soname);
+        obj.firstBinding = bindingIdx;
+        obj.numBindings = info.bindings.size();
+
+        memcpy(&bindings[bindingIdx], info.bindings.data(), sizeof(Binding) * obj.numBindings);
+        bindingIdx += obj.numBindings;
+    }
+
+    // send it to the server
+    const auto pathBytes = strlen(this->execPath) + 1;
+    const auto msgBytes = sizeof(DyldosrvStoreClosureRequest) + pathBytes;
+
+    auto msg = reinterpret_cast<DyldosrvStoreClosureRequest *>(malloc(msgBytes));
+    if(!msg) Linker::Abort("out of memory");
+
+    msg->vmRegion = region;
+    msg->length = length;
+    memcpy(msg->path, this->execPath, pathBytes);
+
+    auto reply = reinterpret_cast<const DyldosrvStoreClosureReply *>(ElfReader::DyldosrvCall(
+                DyldosrvMessageType::StoreClosure, msg, msgBytes,
+                DyldosrvMessageType::StoreClosureReply, sizeof(DyldosrvStoreClosureReply)));
+    free(msg);
+
+    if(reply->status == DyldosrvErrors::NotPermitted ||
+            reply->status == DyldosrvErrors::ClosureExists) {
+        if(gLogSubmit) Linker::Trace("Launch closure for %s not stored: %d", this->execPath,
+                reply->status);
+    } else if(reply->status) {
+        Linker::Info("Failed to store launch closure for %s: %d", this->execPath, reply->status);
+    } else if(gLogSubmit) {
+        Linker::Trace("Stored launch closure for %s: %lu objects, %lu bindings (%lu bytes)",
+                this->execPath, this->objects.size(), numBindings, length);
+    }
+
+    // the server has its own copy now
+    err = DeallocVirtualRegion(region);
+    if(err) {
+        Linker::Abort("%s failed: %d", "DeallocVirtualRegion", err);
+    }
+#endif
+}
@@ -0,0 +1,214 @@
+#ifndef DYLDO_LINK_LAUNCHCLOSURE_H
+#define DYLDO_LINK_LAUNCHCLOSURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <PacketTypes.h>
+
+#include "link/SymbolMap.h"
+
+namespace dyldo {
+class ElfReader;
+struct Library;
+
+/**
+ * A launch closure records the outcome of loading a particular executable: the libraries it loaded
+ * (in order), the addresses they were loaded at, and for every symbol lookup performed while
+ * processing relocations, which library's symbol table entry it resolved to.
+ *
+ * Closures are recorded by the dynamic linker the first time an executable is launched, then kept
+ * by the dynamic link server. On subsequent launches, if the executable and all libraries are
+ * still the same files, the libraries are loaded directly from their recorded paths at the same
+ * addresses, and symbol lookups for relocations are replaced by reading the recorded entry of the
+ * providing library's symbol table. Closures never contain addresses of symbols.
+ *
+ * Since the load addresses are reused, libraries of an executable with a closure are only slid
+ * once per boot, rather than on every launch.
+ */
+class LaunchClosure {
+    public:
+        /**
+         * Header of a closure; this is followed by the objects array, bindings array, and string
+         * table. All offsets are relative to the start of the header.
+         */
+        struct Header {
+            /// common header (validated by the server)
+            DyldoClosureHeader common;
+
+            /// number of objects; the first is always the executable
+            uint32_t numObjects;
+            /// total number of bindings
+            uint32_t numBindings;
+
+            /// base address of the shared library region
+            uint64_t soSlide;
+            /// address at which the next library would be loaded
+            uint64_t soBase;
+
+            /// offset to the objects array
+            uint32_t objectsOff;
+            /// offset to the bindings array
+            uint32_t bindingsOff;
+            /// offset to the string table
+            uint32_t stringsOff;
+            /// length of the string table, in bytes
+            uint32_t stringsLen;
+        };
+
+        /**
+         * An object (the executable, or a library) that was loaded
+         */
+        struct Object {
+            /// size of the object's file
+            uint64_t fileSize;
+            /// identity hash of the object's file
+            uint64_t hash;
+            /// load address of the object
+            uint64_t base;
+
+            /// string table offsets of the path and soname (the latter is unused for executables)
+            uint32_t path, soname;
+            /// index of the first binding for this object, and the number of bindings
+            uint32_t firstBinding, numBindings;
+        };
+
+        /**
+         * The result of looking up a symbol referenced by an object's relocations. Bindings of an
+         * object are sorted by symbol index.
+         *
+         * Symbols that aren't provided by a library's symbol table (linker exports and overrides)
+         * are never recorded.
+         */
+        struct Binding {
+            /// index of the symbol in the referencing object's symbol table
+            uint32_t symbol;
+            /// index of the object that provides the symbol
+            int32_t object;
+            /// index of the symbol in the providing object's symbol table
+            uint32_t providerSymbol;
+            uint32_t reserved;
+        };
+
+#if defined(__amd64__)
+        /// Address at which closures are mapped
+        constexpr static const uintptr_t kMapBase{0x700040000000};
+#endif
+
+    public:
+        /// Requests the closure for the given executable from the dynamic link server.
+        static LaunchClosure * _Nullable Load(const char * _Nonnull execPath);
+        ~LaunchClosure();
+
+        /// Returns the number of objects in the closure
+        size_t getNumObjects() const {
+            return this->objects.size();
+        }
+        /// Returns the path of the given object
+        const char * _Nonnull getPath(const size_t i) const {
+            return this->strings.data() + this->objects[i].path;
+        }
+        /// Returns the soname of the given object
+        const char * _Nonnull getSoname(const size_t i) const {
+            return this->strings.data() + this->objects[i].soname;
+        }
+        /// Returns the load address of the given object
+        uintptr_t getBase(const size_t i) const {
+            return this->objects[i].base;
+        }
+
+        /// Returns the base address of the shared library region
+        uintptr_t getSoSlide() const {
+            return this->header->soSlide;
+        }
+        /// Returns the address at which the next library is loaded
+        uintptr_t getSoBase() const {
+            return this->header->soBase;
+        }
+
+        /// Checks whether the given object's file is the one the closure was recorded with
+        bool matches(const size_t i, ElfReader * _Nonnull reader) const;
+        /// Associates a loaded library with an object in the closure
+        void setLibrary(const size_t i, Library * _Nonnull library);
+
+        /// Looks up the recorded binding for a symbol
+        bool getBinding(const uint32_t object, const uint32_t symbol, const char * _Nonnull name,
+                SymbolMap::Symbol &outSymbol) const;
+
+    private:
+        LaunchClosure(const uintptr_t region, const uintptr_t base, const size_t length);
+
+        bool validate();
+
+    private:
+        /// VM region containing the closure
+        uintptr_t region{0};
+        /// header of the closure
+        const Header * _Nonnull header;
+        /// length of the closure, in bytes
+        size_t length{0};
+
+        /// objects in the closure
+        std::span<const Object> objects;
+        /// all bindings
+        std::span<const Binding> bindings;
+        /// string table
+        std::span<const char> strings;
+
+        /// loaded library for each object (the executable's entry is unused)
+        std::vector<Library *> libraries;
+};
+
+/**
+ * Records a launch closure while an executable is loaded the regular way.
+ */
+class ClosureBuilder {
+    public:
+        ClosureBuilder(ElfReader * _Nonnull exec, const char * _Nonnull execPath);
+
+        /// Records a library that was loaded; they must be added in load order.
+        void addLibrary(Library * _Nonnull library, ElfReader * _Nonnull reader);
+        /// Records the result of a symbol lookup for a relocation.
+        void addBinding(const uint32_t object, const uint32_t symbol,
+                const SymbolMap::Symbol &resolved);
+
+        /// Builds the closure and sends it to the dynamic link server.
+        void submit(const uintptr_t soSlide, const uintptr_t soBase);
+
+    private:
+        /// Information about a loaded object
+        struct ObjectInfo {
+            /// path of the object's file
+            const char * _Nonnull path;
+            /// soname of the library (empty for the executable)
+            const char * _Nonnull soname;
+            /// library structure (null for the executable)
+            Library * _Nullable library;
+
+            /// size and identity hash of the object's file
+            uint64_t fileSize, hash;
+            /// load address
+            uint64_t base;
+
+            /// bindings recorded for this object
+            std::vector<LaunchClosure::Binding> bindings;
+        };
+
+        int32_t indexOf(const Library * _Nullable library) const;
+        size_t finalizeBindings(ObjectInfo &object);
+
+    private:
+        /// whether we log the size of submitted closures
+        static bool gLogSubmit;
+
+    private:
+        /// path of the executable
+        const char * _Nonnull execPath;
+        /// all objects, in load order
+        std::vector<ObjectInfo> objects;
+};
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "LazyBinder.h"
+#include "Linker.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__amd64__)
+#include <cpuid.h>
+#endif
+
+using namespace dyldo;
+
+bool LazyBinder::gLogBindings = false;
+
+size_t __dyldo_lazy_bind_xsave_size = 0;
+
+/**
+ * Figures out the size of the XSAVE area needed to save all extended processor state enabled by
+ * the OS, as reported by CPUID leaf 0xD; the trampoline needs it to preserve vector registers
+ * wider than 128 bits across the call into the binder. If XSAVE isn't available, the trampoline
+ * falls back to FXSAVE.
+ */
+void LazyBinder::Init() {
+#if defined(__amd64__)
+    uint32_t eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+    if(!(ecx & bit_XSAVE) || !(ecx & bit_OSXSAVE)) return;
+    if(__get_cpuid_max(0, nullptr) < 0xD) return;
+
+    // EBX is the size required by the features currently enabled in XCR0
+    __cpuid_count(0xD, 0, eax, ebx, ecx, edx);
+    __dyldo_lazy_bind_xsave_size = (ebx + 63) & ~63;
+#endif
+}
+
+/**
+ * Entry point from the lazy binding trampoline: resolves the symbol for the relocation at the
+ * given index, and returns its address.
+ */
+uintptr_t __dyldo_lazy_bind(LazyBinder *binder, const size_t index) {
+    return binder->bind(index);
+}
+
+/**
+ * Creates a lazy binder for an object's jump slot relocations.
+ */
+LazyBinder::LazyBinder(const char *_path, const uintptr_t _base,
+        const PaddedArray<Elf_Rela> &_relocs, const std::span<Elf_Sym> &_symtab,
+        const std::span<char> &_strtab) : path(strdup(_path)), base(_base), symtab(_symtab),
+        strtab(_strtab) {
+    if(!this->path) Linker::Abort("out of memory");
+    this->relocs = _relocs;
+}
+
+/**
+ * Resolves the symbol referenced by the relocation at the given index in the object's jump slot
+ * relocations, then writes its address into the relocation's GOT entry; subsequent calls through
+ * the PLT then go straight to the function.
+ *
+ * This may run concurrently on multiple threads, if they call the same function for the first
+ * time at once; that's harmless since they'll all resolve the same address.
+ */
+uintptr_t LazyBinder::bind(const size_t index) {
+    const auto &rel = this->relocs[index];
+
+    const auto symIdx = ELF64_R_SYM(rel.r_info);
+    if(symIdx == STN_UNDEF || symIdx >= this->symtab.size()) {
+        Linker::Abort("invalid symbol %lu for PLT entry %lu in %s", symIdx, index, this->path);
+    }
+
+    const auto &sym = this->symtab[symIdx];
+    if(sym.st_name >= this->strtab.size()) {
+        Linker::Abort("invalid name for symbol %lu in %s", symIdx, this->path);
+    }
+    const auto name = this->strtab.data() + sym.st_name;
+
+    // resolve it and update the GOT
+    SymbolMap::Symbol symbol;
+    if(!Linker::the()->resolveSymbol(name, symbol)) {
+        Linker::Abort("failed to resolve symbol '%s'", name);
+    }
+
+    auto slot = reinterpret_cast<uintptr_t *>(this->base + rel.r_offset);
+    __atomic_store_n(slot, symbol.address, __ATOMIC_RELEASE);
+
+    if(gLogBindings) Linker::Trace("Bound %s in %s: $%p", name, this->path, symbol.address);
+
+    return symbol.address;
+}
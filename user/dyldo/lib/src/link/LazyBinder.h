@@ -0,0 +1,63 @@
+#ifndef DYLDO_LINK_LAZYBINDER_H
+#define DYLDO_LINK_LAZYBINDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <sys/elf.h>
+
+#include "struct/PaddedArray.h"
+
+namespace dyldo {
+class LazyBinder;
+}
+
+/// Invoked by the lazy binding trampoline to resolve a PLT entry
+extern "C" uintptr_t __dyldo_lazy_bind(dyldo::LazyBinder * _Nonnull binder, const size_t index);
+/// Lazy binding trampoline, installed in the GOT of objects that are bound lazily
+extern "C" void __dyldo_lazy_bind_entry();
+/// Size of the XSAVE area used by the lazy binding trampoline, or 0 to use FXSAVE instead
+extern "C" size_t __dyldo_lazy_bind_xsave_size;
+
+namespace dyldo {
+/**
+ * Resolves the jump slot (PLT) relocations of a single object the first time each function is
+ * called, rather than when the object is loaded.
+ *
+ * An instance is allocated for each object that's bound lazily, and its address is stored in the
+ * second GOT entry of the object, where the PLT picks it up to pass to the lazy binding
+ * trampoline. Everything it references lives in the object's loaded segments, so it stays valid
+ * once the ELF readers have been released.
+ */
+class LazyBinder {
+    public:
+        /// Determines how the lazy binding trampoline saves the processor's extended state.
+        static void Init();
+
+        LazyBinder(const char * _Nonnull path, const uintptr_t base,
+                const PaddedArray<Elf_Rela> &relocs, const std::span<Elf_Sym> &symtab,
+                const std::span<char> &strtab);
+
+        /// Resolves the symbol for the given relocation and updates its GOT entry.
+        uintptr_t bind(const size_t index);
+
+    private:
+        /// whether each symbol binding is logged
+        static bool gLogBindings;
+
+    private:
+        /// path of the object (for diagnostics)
+        char * _Nonnull path;
+        /// load address of the object, added to relocation offsets
+        uintptr_t base;
+
+        /// jump slot relocations of the object
+        PaddedArray<Elf_Rela> relocs;
+        /// dynamic symbol and string tables of the object
+        std::span<Elf_Sym> symtab;
+        std::span<char> strtab;
+};
+}
+
+#endif
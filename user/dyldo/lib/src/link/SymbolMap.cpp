@@ -2,8 +2,6 @@
 #include "Library.h"
 #include "Linker.h"
 
-#include "elf/ElfLibReader.h"
-
 #include <cstring>
 
 using namespace dyldo;
@@ -16,11 +14,6 @@ bool SymbolMap::gLogOverrides = false;
 SymbolMap::SymbolMap() {
     int err;
 
-    err = hashmap_create(kMapInitialSize, &this->map);
-    if(err) {
-        Linker::Abort("%s failed: %d", "hashmap_create", err);
-    }
-
     err = hashmap_create(kOverrideMapInitialSize, &this->overridesMap);
     if(err) {
         Linker::Abort("%s failed: %d", "hashmap_create", err);
@@ -28,43 +21,22 @@ SymbolMap::SymbolMap() {
 }
 
 /**
- * Adds a new symbol to the map.
- *
- * It's an error if the symbol is already globally defined; weak symbols can always be overridden
- * by global symbols, however.
+ * Adds a library to the list of libraries searched for symbols. Libraries are searched in the
+ * order they're added.
  */
-void SymbolMap::add(const char *name, const Elf_Sym &sym, Library *library) {
-    int err;
-    const auto keyLen = strlen(name);
-
-    // check if the symbol already exists
-    auto ptr = hashmap_get(&this->map, name, keyLen);
-    if(ptr) {
-        auto existing = reinterpret_cast<Symbol *>(ptr);
-        const auto bind = (existing->flags & SymbolFlags::BindMask);
-
-        // if already defined as global, abort
-        if(bind == SymbolFlags::BindGlobal) {
-            // if a global symbol is redefined as weak, we ignore the weak redefinition
-            if(ELF_ST_BIND(sym.st_info) == STB_WEAK) {
-                return;
-            }
-
-            // otherwise, this is an error
-            Linker::Abort("duplicate definition for symbol '%s': in '%s' and '%s'", name,
-                    existing->library->soname, library->soname);
-        }
-
-        // XXX: free this old entry (we'll overwrite it next)
-        delete existing;
-    }
-
-    // allocate a new symbol entry
-    auto info = new Symbol;
-    info->name = name;
-    info->library = library;
+void SymbolMap::addLibrary(Library *library) {
+    this->libraries.push_back(library);
+}
 
-    info->length = sym.st_size;
+/**
+ * Fills in the symbol info structure for a symbol defined by the given library.
+ */
+void SymbolMap::MakeSymbol(const char *name, const Elf_Sym &sym, Library *library, Symbol &info) {
+    info.name = name;
+    info.library = library;
+    info.length = sym.st_size;
+    info.flags = SymbolFlags::None;
+    info.index = library->symbols.getIndex(sym);
 
     // get object type
     switch(ELF_ST_TYPE(sym.st_info)) {
@@ -72,16 +44,16 @@ void SymbolMap::add(const char *name, const Elf_Sym &sym, Library *library) {
          * Data/object: address is a virtual address
          */
         case STT_OBJECT:
-            info->address = library->reader->rebaseVmAddr(sym.st_value);
-            info->flags |= SymbolFlags::TypeData;
+            info.address = sym.st_value + library->base;
+            info.flags |= SymbolFlags::TypeData;
             break;
 
         /**
          * Function (code)
          */
         case STT_FUNC:
-            info->address = library->reader->rebaseVmAddr(sym.st_value);
-            info->flags |= SymbolFlags::TypeData;
+            info.address = sym.st_value + library->base;
+            info.flags |= SymbolFlags::TypeData;
             break;
 
         /**
@@ -92,8 +64,8 @@ void SymbolMap::add(const char *name, const Elf_Sym &sym, Library *library) {
          * offset.
          */
         case STT_TLS:
-            info->address = sym.st_value;
-            info->flags |= SymbolFlags::TypeThreadLocal;
+            info.address = sym.st_value;
+            info.flags |= SymbolFlags::TypeThreadLocal;
             break;
 
         default:
@@ -105,13 +77,13 @@ void SymbolMap::add(const char *name, const Elf_Sym &sym, Library *library) {
     // get binding type
     switch(ELF_ST_BIND(sym.st_info)) {
         case STB_LOCAL:
-            info->flags |= SymbolFlags::BindLocal;
+            info.flags |= SymbolFlags::BindLocal;
             break;
         case STB_GLOBAL:
-            info->flags |= SymbolFlags::BindGlobal;
+            info.flags |= SymbolFlags::BindGlobal;
             break;
         case STB_WEAK:
-            info->flags |= SymbolFlags::BindWeakGlobal;
+            info.flags |= SymbolFlags::BindWeakGlobal;
             break;
         default:
             Linker::Abort("unknown %s for '%s' in %s: %u (strtab %u, value %08x size %08x shdx %u)",
@@ -120,12 +92,6 @@ void SymbolMap::add(const char *name, const Elf_Sym &sym, Library *library) {
     }
 
     // TODO: get visibility
-
-    // insert it
-    err = hashmap_put(&this->map, name, keyLen, info);
-    if(err) {
-        Linker::Abort("%s failed: %d", "hashmap_put", err);
-    }
 }
 
 /**
@@ -137,6 +103,7 @@ void SymbolMap::addOverride(const Symbol * _Nonnull inSym, const uintptr_t newAd
     // clone the symbol object
     auto oSym = new Symbol(*inSym);
     oSym->address = newAddr;
+    oSym->index = kNoIndex;
 
     if(gLogOverrides) {
         Linker::Trace("Overriding %s: %08x -> %08x", inSym->name, inSym->address, oSym->address);
@@ -160,6 +127,7 @@ void SymbolMap::addLinkerExport(const char * _Nonnull name, const void *data, co
     info->name = name;
     info->address = reinterpret_cast<uintptr_t>(data);
     info->length = length;
+    info->library = nullptr;
 
     info->flags = SymbolFlags::BindGlobal;
 
@@ -177,34 +145,67 @@ void SymbolMap::addLinkerExport(const char * _Nonnull name, const void *data, co
 }
 
 /**
- * Searches the symbol map for a symbol with the specified name, optionally limiting the search to
- * a particular library.
+ * Searches for a symbol with the specified name, optionally limiting the search to a particular
+ * library.
+ *
+ * Overrides are checked first; then, the symbol table of each library is searched in load order.
+ * The first global definition is returned; if there are only weak definitions, the first of them
+ * is used instead.
  *
+ * This may be invoked concurrently (from the lazy binding path) so it must not modify any state.
+ *
+ * @param outSymbol Filled with the symbol's information, if found
  * @param searchIn If non-null, limit the search to symbols exported by the given library.
+ *
+ * @return Whether the symbol was found
  */
-SymbolMap::Symbol const * SymbolMap::get(const char *name, Library *searchIn) {
-    const auto keyLen = strlen(name);
-    void *element = nullptr;
-
+bool SymbolMap::get(const char *name, Symbol &outSymbol, Library *searchIn) {
     // have we an override?
-    element = hashmap_get(&this->overridesMap, name, keyLen);
+    auto element = hashmap_get(&this->overridesMap, name, strlen(name));
     if(element) {
-        goto beach;
+        auto symbol = reinterpret_cast<const Symbol *>(element);
+        if(searchIn && symbol->library != searchIn) {
+            // symbol not exported by the library requested
+            return false;
+        }
+
+        outSymbol = *symbol;
+        return true;
     }
 
-    // does the map contain the item?
-    element = hashmap_get(&this->map, name, keyLen);
-    if(!element) {
-        return nullptr;
+    // XXX: skip _start exported from dynamic libs
+    if(!strcmp(name, "_start")) {
+        return false;
+    }
+
+    // search each library's symbol table
+    SymbolTable::Name key(name);
+
+    const Elf_Sym *weak{nullptr};
+    Library *weakLib{nullptr};
+
+    for(auto library : this->libraries) {
+        if(searchIn && library != searchIn) continue;
+
+        auto sym = library->symbols.lookup(key);
+        if(!sym) continue;
+
+        if(ELF_ST_BIND(sym->st_info) == STB_WEAK) {
+            if(!weak) {
+                weak = sym;
+                weakLib = library;
+            }
+            continue;
+        }
+
+        MakeSymbol(library->symbols.getName(*sym), *sym, library, outSymbol);
+        return true;
     }
 
-beach:;
-    auto symbol = reinterpret_cast<const Symbol *>(element);
-    if(searchIn && symbol->library != searchIn) {
-        // symbol not exported by the library requested
-        return nullptr;
+    if(weak) {
+        MakeSymbol(weakLib->symbols.getName(*weak), *weak, weakLib, outSymbol);
+        return true;
     }
 
-    // found the symbol
-    return symbol;
+    return false;
 }
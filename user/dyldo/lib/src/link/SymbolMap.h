@@ -1,6 +1,9 @@
 #ifndef DYLDO_LINK_SYMBOLMAP_H
 #define DYLDO_LINK_SYMBOLMAP_H
 
+#include <cstdint>
+#include <vector>
+
 #include <sys/bitflags.hpp>
 #include <sys/elf.h>
 
@@ -43,16 +46,13 @@ enum class SymbolFlags: uint16_t {
 };
 
 /**
- * Registry mapping symbol names (from a library's string allocator) to their values.
+ * Resolves symbol names to their values.
+ *
+ * Symbols aren't copied out of the loaded libraries; instead, each library's own symbol table is
+ * searched (via its hash table) in the order the libraries were loaded. The first global
+ * definition of a symbol wins; weak definitions are used only if there's no global definition.
  */
 class SymbolMap {
-    /**
-     * Initial size of the symbol hashmap.
-     *
-     * This is set to allow roughly containing most of the commonly used functions from the C and
-     * system libraries.
-     */
-    constexpr static const size_t kMapInitialSize = 128;
     /**
      * Initial size of the overrides hashmap.
      *
@@ -61,11 +61,14 @@ class SymbolMap {
     constexpr static const size_t kOverrideMapInitialSize = 16;
 
     public:
+        /// Symbol index for symbols that weren't read from a library's symbol table
+        constexpr static const uint32_t kNoIndex{UINT32_MAX};
+
         struct Symbol {
             /// pointer to the symbol's name
             const char * _Nonnull name;
-            /// library this symbol is exported from
-            Library * _Nonnull library;
+            /// library this symbol is exported from (null for linker exports)
+            Library * _Nullable library;
 
             /// symbol address (absolute)
             uintptr_t address;
@@ -74,13 +77,16 @@ class SymbolMap {
 
             // flags defining this symbol's mapping
             SymbolFlags flags = SymbolFlags::None;
+
+            /// index in the library's symbol table; `kNoIndex` for overrides and linker exports
+            uint32_t index = kNoIndex;
         };
 
     public:
         SymbolMap();
 
-        /// Adds a new symbol.
-        void add(const char * _Nonnull name, const Elf_Sym &sym, Library * _Nonnull library);
+        /// Adds a library whose symbols are searched.
+        void addLibrary(Library * _Nonnull library);
         /// Registers a symbol override.
         void addOverride(const Symbol * _Nonnull inSym, const uintptr_t newAddr);
         /// Adds a new linker exported symbol in the form of a function.
@@ -91,23 +97,20 @@ class SymbolMap {
         void addLinkerExport(const char * _Nonnull name, const void * _Nonnull data,
                 const size_t length);
         /// Gets symbol information, if found.
-        Symbol const * _Nullable get(const char * _Nonnull name, Library * _Nullable searchIn = nullptr);
+        bool get(const char * _Nonnull name, Symbol &outSymbol,
+                Library * _Nullable searchIn = nullptr);
 
-        /// Gets the number of registered symbols
-        const size_t getNumSymbols() const {
-            return hashmap_num_entries(&this->map);
-        }
+        /// Fills in symbol information from a library's symbol table entry.
+        static void MakeSymbol(const char * _Nonnull name, const Elf_Sym &sym,
+                Library * _Nonnull library, Symbol &out);
 
     private:
         /// whether overrides are logged
         static bool gLogOverrides;
 
     private:
-        /**
-         * Mapping of symbol name -> symbol info, for global symbols exported by all loaded
-         * dynamic objects.
-         */
-        struct hashmap_s map;
+        /// All libraries whose symbols are searched, in load order
+        std::vector<Library *> libraries;
 
         /**
          * Mapping of symbol name -> symbol info, for symbol overrides. These are added by the
@@ -0,0 +1,163 @@
+#include "SymbolTable.h"
+
+#include <cstring>
+
+using namespace dyldo;
+
+/**
+ * Sets up the GNU hash table. It consists of a header, followed by the bloom filter, hash buckets
+ * and the hash chains.
+ */
+void SymbolTable::setGnuHash(const uintptr_t address) {
+    auto header = reinterpret_cast<const uint32_t *>(address);
+
+    this->gnuNumBuckets = header[0];
+    this->gnuSymOffset = header[1];
+    this->gnuBloomSize = header[2];
+    this->gnuBloomShift = header[3];
+
+    this->gnuBloom = reinterpret_cast<const Elf_Addr *>(&header[4]);
+    this->gnuBuckets = reinterpret_cast<const uint32_t *>(&this->gnuBloom[this->gnuBloomSize]);
+    this->gnuChain = &this->gnuBuckets[this->gnuNumBuckets];
+}
+
+/**
+ * Sets up the System V hash table. It consists of the number of buckets and chains, followed by
+ * the buckets and chains themselves.
+ */
+void SymbolTable::setSysvHash(const uintptr_t address) {
+    auto header = reinterpret_cast<const uint32_t *>(address);
+
+    this->sysvNumBuckets = header[0];
+    this->sysvBuckets = &header[2];
+    this->sysvChain = &this->sysvBuckets[this->sysvNumBuckets];
+}
+
+/**
+ * Looks up a symbol with the given name. Only symbols that are defined in this object, and are
+ * visible to other objects, are returned.
+ */
+const Elf_Sym *SymbolTable::lookup(Name &name) const {
+    if(this->gnuNumBuckets) {
+        return this->lookupGnu(name);
+    } else if(this->sysvNumBuckets) {
+        return this->lookupSysv(name);
+    }
+
+    return this->lookupLinear(name);
+}
+
+/**
+ * Looks up a symbol via the GNU hash table.
+ *
+ * The bloom filter is checked first; two bits (selected by different parts of the hash) must be
+ * set in the filter word if the object defines a symbol with this hash. Then, the chain for the
+ * hash's bucket is walked; the low bit of each chain entry indicates the end of the chain.
+ */
+const Elf_Sym *SymbolTable::lookupGnu(const Name &name) const {
+    const auto hash = name.gnuHash;
+
+    const auto word = this->gnuBloom[(hash / kBloomWordBits) & (this->gnuBloomSize - 1)];
+    const Elf_Addr mask = (Elf_Addr{1} << (hash % kBloomWordBits)) |
+        (Elf_Addr{1} << ((hash >> this->gnuBloomShift) % kBloomWordBits));
+    if((word & mask) != mask) {
+        return nullptr;
+    }
+
+    auto index = this->gnuBuckets[hash % this->gnuNumBuckets];
+    if(index < this->gnuSymOffset) {
+        return nullptr;
+    }
+
+    while(index < this->symtab.size()) {
+        const auto chainHash = this->gnuChain[index - this->gnuSymOffset];
+
+        if((hash | 1) == (chainHash | 1) && this->matches(this->symtab[index], name)) {
+            return &this->symtab[index];
+        }
+        if(chainHash & 1) {
+            break;
+        }
+
+        index++;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Looks up a symbol via the System V hash table.
+ */
+const Elf_Sym *SymbolTable::lookupSysv(Name &name) const {
+    if(!name.hasSysvHash) {
+        name.sysvHash = SysvHash(name.string);
+        name.hasSysvHash = true;
+    }
+
+    for(auto index = this->sysvBuckets[name.sysvHash % this->sysvNumBuckets];
+            index != STN_UNDEF && index < this->symtab.size(); index = this->sysvChain[index]) {
+        if(this->matches(this->symtab[index], name)) {
+            return &this->symtab[index];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Searches the entire symbol table for a symbol. This is only used for objects without any hash
+ * tables, which shouldn't really exist.
+ */
+const Elf_Sym *SymbolTable::lookupLinear(const Name &name) const {
+    for(const auto &sym : this->symtab) {
+        if(this->matches(sym, name)) {
+            return &sym;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Checks whether the symbol has the given name, is defined in this object, and is not local.
+ */
+bool SymbolTable::matches(const Elf_Sym &sym, const Name &name) const {
+    if(sym.st_shndx == SHN_UNDEF || ELF_ST_BIND(sym.st_info) == STB_LOCAL) {
+        return false;
+    } else if(sym.st_name >= this->strtab.size()) {
+        return false;
+    }
+
+    return !strcmp(this->strtab.data() + sym.st_name, name.string);
+}
+
+/**
+ * Calculates the GNU hash (DJB hash) of a symbol name.
+ */
+uint32_t SymbolTable::GnuHash(const char *name) {
+    uint32_t hash{5381};
+
+    for(auto str = reinterpret_cast<const uint8_t *>(name); *str; str++) {
+        hash = (hash << 5) + hash + *str;
+    }
+
+    return hash;
+}
+
+/**
+ * Calculates the System V hash of a symbol name.
+ */
+uint32_t SymbolTable::SysvHash(const char *name) {
+    uint32_t hash{0}, high;
+
+    for(auto str = reinterpret_cast<const uint8_t *>(name); *str; str++) {
+        hash = (hash << 4) + *str;
+        high = hash & 0xf0000000;
+        if(high) {
+            hash ^= high >> 24;
+        }
+        hash &= ~high;
+    }
+
+    return hash;
+}
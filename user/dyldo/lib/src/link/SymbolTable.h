@@ -0,0 +1,110 @@
+#ifndef DYLDO_LINK_SYMBOLTABLE_H
+#define DYLDO_LINK_SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <sys/elf.h>
+
+namespace dyldo {
+/**
+ * Provides lookups of symbols by name in the dynamic symbol table of a single loaded object.
+ *
+ * Lookups use the object's GNU-style hash table (`DT_GNU_HASH`) if it has one, including its bloom
+ * filter, which rejects most names the object doesn't define without touching the symbol table.
+ * Otherwise, the System V hash table (`DT_HASH`) is used; if neither exist, the symbol table is
+ * searched linearly.
+ *
+ * All tables referenced are part of the object's loaded segments, so this remains valid after its
+ * ELF reader has been deallocated.
+ */
+class SymbolTable {
+    public:
+        /**
+         * Name of a symbol being looked up, along with its hashes; these are calculated once for
+         * each name, rather than for each object that's searched.
+         */
+        struct Name {
+            /// the name string
+            const char * _Nonnull string;
+            /// GNU hash of the name
+            uint32_t gnuHash{0};
+            /// System V hash of the name, if calculated
+            uint32_t sysvHash{0};
+            /// whether the System V hash has been calculated
+            bool hasSysvHash{false};
+
+            Name(const char * _Nonnull _string) : string(_string),
+                gnuHash(SymbolTable::GnuHash(_string)) {}
+        };
+
+    public:
+        SymbolTable() = default;
+        SymbolTable(const std::span<Elf_Sym> &symtab, const std::span<char> &strtab) :
+            symtab(symtab), strtab(strtab) {}
+
+        /// Uses the GNU hash table at the given address for lookups.
+        void setGnuHash(const uintptr_t address);
+        /// Uses the System V hash table at the given address for lookups.
+        void setSysvHash(const uintptr_t address);
+
+        /// Finds a symbol that's defined by this object.
+        const Elf_Sym * _Nullable lookup(Name &name) const;
+
+        /// Returns the name of a symbol in this table.
+        const char * _Nonnull getName(const Elf_Sym &sym) const {
+            return this->strtab.data() + sym.st_name;
+        }
+
+        /// Returns the index of a symbol in this table.
+        uint32_t getIndex(const Elf_Sym &sym) const {
+            return &sym - this->symtab.data();
+        }
+        /// Returns the symbol at the given index, if there is one.
+        const Elf_Sym * _Nullable get(const uint32_t index) const {
+            return (index < this->symtab.size()) ? &this->symtab[index] : nullptr;
+        }
+
+        /// Returns whether the table has any symbols
+        bool empty() const {
+            return this->symtab.empty();
+        }
+
+        static uint32_t GnuHash(const char * _Nonnull name);
+        static uint32_t SysvHash(const char * _Nonnull name);
+
+    private:
+        const Elf_Sym * _Nullable lookupGnu(const Name &name) const;
+        const Elf_Sym * _Nullable lookupSysv(Name &name) const;
+        const Elf_Sym * _Nullable lookupLinear(const Name &name) const;
+
+        bool matches(const Elf_Sym &sym, const Name &name) const;
+
+    private:
+        /// Number of bits in a bloom filter word
+        constexpr static const size_t kBloomWordBits{sizeof(Elf_Addr) * 8};
+
+        /// dynamic symbol table
+        std::span<Elf_Sym> symtab;
+        /// string table referenced by the symbol table
+        std::span<char> strtab;
+
+        /// GNU hash table: number of buckets, index of first hashed symbol
+        uint32_t gnuNumBuckets{0}, gnuSymOffset{0};
+        /// GNU hash table: number of bloom filter words (power of two), and second hash shift
+        uint32_t gnuBloomSize{0}, gnuBloomShift{0};
+        /// GNU hash table: bloom filter, hash buckets, and hash chains
+        const Elf_Addr * _Nullable gnuBloom{nullptr};
+        const uint32_t * _Nullable gnuBuckets{nullptr};
+        const uint32_t * _Nullable gnuChain{nullptr};
+
+        /// System V hash table: number of buckets
+        uint32_t sysvNumBuckets{0};
+        /// System V hash table: buckets and chains
+        const uint32_t * _Nullable sysvBuckets{nullptr};
+        const uint32_t * _Nullable sysvChain{nullptr};
+};
+}
+
+#endif
@@ -53,44 +53,30 @@ void __dyldo_teardown_tls() {
 }
 
 /**
- * Stub function used to get the address of a thread-local that belongs to another shared object.
+ * Gets the address of a thread-local that belongs to another shared object.
+ *
+ * The module id written for DTPMOD relocations is the offset of the module's TLS from the thread
+ * pointer; since all modules' TLS is allocated statically, this is simply an addition.
  */
 void *__dyldo_tls_get_addr_amd64(tls_index_t *ctx) {
     // read out TLS block base
-    uintptr_t tlsBlockBase = 0;
-    asm volatile("mov   %%gs:0x00, %0" : "=r" (tlsBlockBase));
-    asm volatile("mov   %%fs:0x00, %0" : "=r" (tlsBlockBase));
-
-    // get address
-    const auto addr = tlsBlockBase + ctx->ti_module + ctx->ti_offset;
-    Linker::Trace("%s %p (mod %p off %p) = %08x", __FUNCTION__, ctx, ctx->ti_module,
-            ctx->ti_offset, addr);
-
-    return reinterpret_cast<void *>(addr);
+    uintptr_t tlsBlockBase;
+    asm("mov   %%fs:0x00, %0" : "=r" (tlsBlockBase));
 
-    Linker::Abort("%s unimplemented: %p (mod %p off %p)", __FUNCTION__, ctx, ctx->ti_module,
-            ctx->ti_offset);
+    return reinterpret_cast<void *>(tlsBlockBase + ctx->ti_module + ctx->ti_offset);
 }
 /**
- * Stub function used to get the address of a thread-local that belongs to another shared object.
+ * Gets the address of a thread-local that belongs to another shared object.
  *
  * I _think_ the argument is passed in %eax; 
  */
 #if defined(__i386__)
 __attribute__ ((__regparm__ (1))) void *__dyldo_tls_get_addr_i386(tls_index_t *ctx) {
     // read out TLS block base
-    uintptr_t tlsBlockBase = 0;
-    asm volatile("mov   %%gs:0x00, %0" : "=r" (tlsBlockBase));
-
-    // get address
-    const auto addr = tlsBlockBase + ctx->ti_module + ctx->ti_offset;
-    Linker::Trace("%s %p (mod %p off %p) = %08x", __FUNCTION__, ctx, ctx->ti_module,
-            ctx->ti_offset, addr);
+    uintptr_t tlsBlockBase;
+    asm("mov   %%gs:0x00, %0" : "=r" (tlsBlockBase));
 
-    return reinterpret_cast<void *>(addr);
-
-    Linker::Abort("%s unimplemented: %p (mod %p off %p)", __FUNCTION__, ctx, ctx->ti_module,
-            ctx->ti_offset);
+    return reinterpret_cast<void *>(tlsBlockBase + ctx->ti_module + ctx->ti_offset);
 }
 #endif
 
@@ -114,20 +100,23 @@ ThreadLocal::ThreadLocal() {
     Linker::the()->map->addLinkerExport("___tls_get_addr",
             reinterpret_cast<void *>(&__dyldo_tls_get_addr_i386), 0);
 #elif defined(__amd64__)
-    Linker::the()->map->addLinkerExport("___tls_get_addr",
+    Linker::the()->map->addLinkerExport("__tls_get_addr",
             reinterpret_cast<void *>(&__dyldo_tls_get_addr_amd64), 0);
 #endif
 }
 
 /**
- * Sets the size of the thread-local region requested by the main executable.
+ * Sets the size and alignment of the thread-local region requested by the main executable.
  */
-void ThreadLocal::setExecTlsInfo(const size_t size, const std::span<std::byte> &tdata) {
+void ThreadLocal::setExecTlsInfo(const size_t size, const size_t align,
+        const std::span<std::byte> &tdata) {
     if(gLogAllocations) {
-        Linker::Trace("exec: .tdata %u TLS total %u", tdata.size(), size);
+        Linker::Trace("exec: .tdata %u TLS total %u align %u", tdata.size(), size, align);
     }
 
     this->totalExecSize = size;
+    this->alignedExecSize = AlignUp(size, align);
+    this->tlsAlign = std::max(this->tlsAlign, align);
 
     if(!tdata.empty()) {
         this->tdata = tdata;
@@ -135,20 +124,26 @@ void ThreadLocal::setExecTlsInfo(const size_t size, const std::span<std::byte> &
 }
 
 /**
- * Sets a thread-local reservation for a shared library.
+ * Sets a thread-local reservation for a shared library. It's placed below all previously
+ * allocated regions, such that its offset from the thread pointer is a multiple of its alignment.
+ *
+ * This relies on the executable's TLS information having been set already.
  */
-void ThreadLocal::setLibTlsInfo(const size_t size, const std::span<std::byte> &tdata,
-        Library *library) {
+void ThreadLocal::setLibTlsInfo(const size_t size, const size_t align,
+        const std::span<std::byte> &tdata, Library *library) {
+    // distance from the thread pointer to the start of the region
+    const auto tpOffset = AlignUp(this->alignedExecSize + this->totalSharedSize + size, align);
+
     // build the info struct
     auto region = new LibTlsRegion(library);
     region->length = size;
     region->tdata = tdata;
 
-    region->offset = this->nextSharedOffset - static_cast<off_t>(size);
+    region->offset = -static_cast<off_t>(tpOffset - this->alignedExecSize);
 
     // update offset for next allocation
-    this->totalSharedSize += size;
-    this->nextSharedOffset -= size;
+    this->totalSharedSize = tpOffset - this->alignedExecSize;
+    this->tlsAlign = std::max(this->tlsAlign, align);
 
     if(gLogAllocations) {
         Linker::Trace("lib '%s': .tdata %u TLS total %u off %d", library->soname,
@@ -163,7 +158,8 @@ void ThreadLocal::setLibTlsInfo(const size_t size, const std::span<std::byte> &t
 }
 
 /**
- * Find the TLS offset for the given library.
+ * Find the TLS offset for the given library. This is relative to the thread pointer, so it can be
+ * used directly for TPOFF relocations, and as the module id for dynamic TLS accesses.
  *
  * @return TLS offset, or 0 in case of error.
  */
@@ -176,51 +172,29 @@ off_t ThreadLocal::getLibTlsOffset(Library *library) {
 
     // return the offset
     auto region = reinterpret_cast<const LibTlsRegion *>(el);
-    return region->offset;
+    return region->offset - static_cast<off_t>(this->alignedExecSize);
 }
 
 /**
- * Set up the calling thread's thread-local storage. The template data is copied into it, and if
- * required, the thread's architectural state is updated.
- *
- * @return Memory address of the base of the thread structure.
+ * Builds the initial TLS image, by copying the initialized data of the executable and each of the
+ * libraries to their offsets from the thread pointer. Everything else is zeroed.
  */
-void *ThreadLocal::setUp() {
-    // figure out alignment
-    const auto alignment = std::max(alignof(uintptr_t), alignof(TlsBlock));
-
-    // actual required TLS space (for executable)
-    const auto tlsActualSize = (((this->totalExecSize + alignment - 1) / alignment) * alignment);
-    // actual required TLS space (for shared libraries)
-    const auto tlsSharedActualSize = (((this->totalSharedSize + alignment - 1) / alignment) * alignment);
-
-    // how much TLS space is to be allocated
-    const auto tlsSize = std::max(kTlsMinSize, tlsActualSize + tlsSharedActualSize);
-    // size of final allocation
-    const auto size = tlsSize + sizeof(TlsBlock);
+void ThreadLocal::buildImage() {
+    this->imageSize = this->alignedExecSize + this->totalSharedSize;
+    this->blockTlsSize = AlignUp(std::max(kTlsMinSize, this->imageSize), this->tlsAlign);
 
     if(gLogAllocations) {
-        Linker::Trace("Total TLS size: %u alloc %u (exec %u lib %u)", tlsSize, size, tlsActualSize, tlsSharedActualSize);
+        Linker::Trace("Total TLS size: %u image %u (exec %u lib %u)", this->blockTlsSize,
+                this->imageSize, this->alignedExecSize, this->totalSharedSize);
     }
 
-    // allocate the region and zero it
-    void *base = nullptr;
-    int err = posix_memalign(&base, alignment, size);
-    if(err) {
-        Linker::Abort("%s failed: %d", "posix_memalign", err);
+    this->image = reinterpret_cast<std::byte *>(calloc(1, std::max<size_t>(this->imageSize, 1)));
+    if(!this->image) {
+        Linker::Abort("out of memory");
     }
 
-    memset(base, 0, size);
-
-    // get location of the structures
-    const auto tbBase = reinterpret_cast<uintptr_t>(base) + tlsSize;
-    TlsBlock *tb = new(reinterpret_cast<void *>(tbBase)) TlsBlock;
-    tb->self = tb;
-    tb->memBase = base;
-
     // copy in the TLS defaults (for the executable)
-    const auto tlsBase = tbBase - tlsActualSize;
-    auto tls = reinterpret_cast<void *>(tlsBase);
+    auto tls = this->image + this->imageSize - this->alignedExecSize;
 
     if(!this->tdata.empty()) {
         memcpy(tls, this->tdata.data(), this->tdata.size());
@@ -230,9 +204,7 @@ void *ThreadLocal::setUp() {
     hashmap_iterate(&this->libRegions, [](void *ctx, void *_region) -> int {
         // get offset from the TLS
         auto region = reinterpret_cast<const LibTlsRegion *>(_region);
-
-        const auto baseAddr = reinterpret_cast<uintptr_t>(ctx) + region->offset;
-        auto base = reinterpret_cast<void *>(baseAddr);
+        auto base = reinterpret_cast<std::byte *>(ctx) + region->offset;
 
         if(!region->tdata.empty()) {
             memcpy(base, region->tdata.data(), region->tdata.size());
@@ -240,16 +212,81 @@ void *ThreadLocal::setUp() {
 
         return 1;
     }, tls);
+}
+
+/**
+ * Allocates a new TLS block. Any space in it not covered by the TLS image is zeroed.
+ */
+ThreadLocal::TlsBlock *ThreadLocal::allocBlock() {
+    // size of final allocation
+    const auto size = this->blockTlsSize + sizeof(TlsBlock);
+
+    void *base = nullptr;
+    int err = posix_memalign(&base, this->tlsAlign, size);
+    if(err) {
+        Linker::Abort("%s failed: %d", "posix_memalign", err);
+    }
+
+    memset(base, 0, this->blockTlsSize - this->imageSize);
+
+    // get location of the structures
+    const auto tbBase = reinterpret_cast<uintptr_t>(base) + this->blockTlsSize;
+    TlsBlock *tb = new(reinterpret_cast<void *>(tbBase)) TlsBlock;
+    tb->memBase = base;
+
+    if(gLogAllocations) {
+        Linker::Trace("allocated tls: %p (%p)", tb, base);
+    }
+
+    return tb;
+}
+
+/**
+ * Set up the calling thread's thread-local storage. The template data is copied into it, and if
+ * required, the thread's architectural state is updated.
+ *
+ * If a thread exited previously, its TLS block is reused; otherwise, a new one is allocated.
+ *
+ * @return Memory address of the base of the thread structure.
+ */
+void *ThreadLocal::setUp() {
+    // the first call is for the main thread, so no other threads can be racing us here
+    if(!this->image) {
+        this->buildImage();
+    }
+
+    // get a block
+    TlsBlock *tb{nullptr};
+
+    this->lockFreeBlocks();
+    if(this->freeBlocks) {
+        tb = this->freeBlocks;
+        this->freeBlocks = tb->next;
+        this->numFreeBlocks--;
+    }
+    this->unlockFreeBlocks();
+
+    if(!tb) {
+        tb = this->allocBlock();
+    }
+
+    tb->self = tb;
+    tb->next = nullptr;
+
+    // copy in the initial TLS contents
+    auto tbBase = reinterpret_cast<std::byte *>(tb);
+    memcpy(tbBase - this->imageSize, this->image, this->imageSize);
 
     // update the thread's arch state and return
-    tb->tlsBase = tls;
+    tb->tlsBase = tbBase - this->alignedExecSize;
     this->updateThreadArchState(tb);
 
     return tb;
 }
 
 /**
- * Tears down the TLS region.
+ * Tears down the TLS region. Its memory is kept for use by the next thread that's created, unless
+ * there are already plenty of blocks cached.
  */
 void ThreadLocal::tearDown() {
     // get the base address of the TlsBlock
@@ -262,14 +299,47 @@ void ThreadLocal::tearDown() {
 #error Update ThreadLocal for current arch
 #endif
 
-    // release its memory
     auto tls = reinterpret_cast<TlsBlock *>(tlsBlockBase);
-    Linker::Trace("deallocating tls: %p (%p)", tls, tls->memBase);
-
-    free(tls->tlsBase);
 
     // clear arch state (so we don't refer to invalid memory)
     this->updateThreadArchState(nullptr);
+
+    // cache the block if possible
+    this->lockFreeBlocks();
+    if(this->numFreeBlocks < kMaxCachedBlocks) {
+        tls->next = this->freeBlocks;
+        this->freeBlocks = tls;
+        this->numFreeBlocks++;
+
+        tls = nullptr;
+    }
+    this->unlockFreeBlocks();
+
+    // otherwise, release its memory
+    if(tls) {
+        if(gLogAllocations) {
+            Linker::Trace("deallocating tls: %p (%p)", tls, tls->memBase);
+        }
+
+        free(tls->memBase);
+    }
+}
+
+/**
+ * Acquires the lock protecting the list of cached TLS blocks. It's only ever held for a few
+ * instructions, so we just yield the CPU while it's taken.
+ */
+void ThreadLocal::lockFreeBlocks() {
+    while(__atomic_test_and_set(&this->freeBlocksLock, __ATOMIC_ACQUIRE)) {
+        ThreadYield();
+    }
+}
+
+/**
+ * Releases the lock protecting the list of cached TLS blocks.
+ */
+void ThreadLocal::unlockFreeBlocks() {
+    __atomic_clear(&this->freeBlocksLock, __ATOMIC_RELEASE);
 }
 
 /**
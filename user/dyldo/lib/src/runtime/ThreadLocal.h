@@ -19,6 +19,14 @@ struct Library;
  * The C runtime will invoke methods in this class (exported via pseudo symbols) to set up new
  * threads it creates; and we'll make sure the main thread's TLS section is set up properly before
  * calling any code in the executables or libraries.
+ *
+ * All modules are loaded at startup, so the TLS of each of them lives at a fixed offset from the
+ * thread pointer (the static TLS model) in each thread's block: the executable's immediately below
+ * it, followed by those of all libraries. This means that initial-exec accesses work for libraries
+ * too, and that `__tls_get_addr` needn't allocate anything on first access.
+ *
+ * Each module's region is placed such that its offset from the thread pointer is a multiple of its
+ * `PT_TLS` alignment; the thread pointer itself is aligned to the largest alignment of any module.
  */
 class ThreadLocal {
     friend void * _Nullable __dyldo_setup_tls();
@@ -26,6 +34,10 @@ class ThreadLocal {
 
     /// minimum size of thread-local storage, in bytes
     constexpr static const size_t kTlsMinSize = sizeof(uintptr_t) * 1024;
+    /// minimum alignment of the thread pointer (and TLS blocks)
+    constexpr static const size_t kTlsAlignment = 16;
+    /// maximum number of TLS blocks of exited threads to keep around for reuse
+    constexpr static const size_t kMaxCachedBlocks = 16;
 
     private:
         /// Thread local storage block
@@ -36,6 +48,8 @@ class ThreadLocal {
             void * _Nullable memBase = nullptr;
             /// base to the TLS
             void * _Nullable tlsBase = nullptr;
+            /// next block in the list of cached blocks, if this block isn't in use
+            TlsBlock * _Nullable next = nullptr;
         };
 
         /// Registration for a library's TLS region
@@ -58,12 +72,13 @@ class ThreadLocal {
         ThreadLocal();
 
         /// Sets the size of the executable TLS region.
-        void setExecTlsInfo(const size_t size, const std::span<std::byte> &tdata);
+        void setExecTlsInfo(const size_t size, const size_t align,
+                const std::span<std::byte> &tdata);
         /// Sets the TLS requirements of a library.
-        void setLibTlsInfo(const size_t size, const std::span<std::byte> &tdata,
-                Library * _Nonnull library);
+        void setLibTlsInfo(const size_t size, const size_t align,
+                const std::span<std::byte> &tdata, Library * _Nonnull library);
 
-        /// Return the TLS offset for the given library.
+        /// Return the offset of the given library's TLS from the thread pointer.
         off_t getLibTlsOffset(Library * _Nonnull library);
 
         /// Set up the calling thread's thread-local storage.
@@ -71,9 +86,15 @@ class ThreadLocal {
         /// Tears down the calling thread's TLS and releases its memory.
         void tearDown();
 
-        /// Get total bytes of TLS used by executable
+        /// Get total bytes of TLS used by executable, including alignment padding
         const size_t getExecSize() const {
-            return this->totalExecSize;
+            return this->alignedExecSize;
+        }
+
+    private:
+        /// Rounds a size up to the given alignment (which may be zero)
+        static constexpr size_t AlignUp(const size_t size, const size_t align) {
+            return align ? ((size + align - 1) / align) * align : size;
         }
 
     private:
@@ -90,6 +111,16 @@ class ThreadLocal {
          * beyond the initialized section should be zeroed.
          */
         size_t totalExecSize = 0;
+        /**
+         * Size of the executable's TLS section, rounded up to its alignment. The section ends at
+         * the thread pointer, so this is the (negated) offset of its start from it.
+         */
+        size_t alignedExecSize = 0;
+        /**
+         * Alignment of the thread pointer, and thus the TLS blocks: the largest alignment of the
+         * TLS of any module, but at least `kTlsAlignment`.
+         */
+        size_t tlsAlign = kTlsAlignment;
 
         /**
          * Mapping of library soname to library thread-local allocation information structure
@@ -97,18 +128,37 @@ class ThreadLocal {
          */
         struct hashmap_s libRegions;
         /**
-         * Total bytes of thread local space required for shared libraries. This region is located
-         * immediately above the executable's TLS region. It's zeroed by default, though it may
-         * have data initialized from shared libraries.
+         * Total bytes of thread local space required for shared libraries, including alignment
+         * padding. This region is located immediately below the executable's TLS region. It's
+         * zeroed by default, though it may have data initialized from shared libraries.
          */
         size_t totalSharedSize = 0;
+
         /**
-         * Offset (from the top of the executable's TLS region) at which the next shared library's
-         * thread locals should be allocated.
+         * Initial contents of the static TLS of all modules, laid out exactly as it is in each
+         * thread's TLS block: it ends at the thread pointer. This is built when the first thread
+         * (the main thread) is set up, at which point all modules have been loaded.
          */
-        off_t nextSharedOffset = 0;
+        std::byte * _Nullable image = nullptr;
+        /// Size of the initial TLS image, in bytes
+        size_t imageSize = 0;
+        /// Size of the TLS area in each block (a multiple of `tlsAlign`); all blocks are the same
+        size_t blockTlsSize = 0;
+
+        /// TLS blocks of exited threads, available for reuse
+        TlsBlock * _Nullable freeBlocks = nullptr;
+        /// Number of blocks in the free list
+        size_t numFreeBlocks = 0;
+        /// Lock protecting the free list
+        bool freeBlocksLock = false;
 
     private:
+        void buildImage();
+        TlsBlock * _Nonnull allocBlock();
+
+        void lockFreeBlocks();
+        void unlockFreeBlocks();
+
         void updateThreadArchState(TlsBlock * _Nullable);
 };
 }
@@ -1,6 +1,8 @@
 #ifndef DYLDOSRV_PACKETTYPES_H
 #define DYLDOSRV_PACKETTYPES_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <sys/elf.h>
 
 /**
@@ -12,8 +14,19 @@ enum class DyldosrvMessageType: uint32_t {
     /// Reply for mapping a shared library's segment
     MapSegmentReply                     = 'SEGR',
 
+    /// Request the launch closure for an executable
+    GetClosure                          = 'CLGT',
+    /// Reply to a launch closure request
+    GetClosureReply                     = 'CLGR',
+    /// Store the launch closure for an executable
+    StoreClosure                        = 'CLST',
+    /// Reply to a launch closure store request
+    StoreClosureReply                   = 'CLSR',
+
     /// Indicates that the file IO connection should be reset
     RootFsUpdated                       = 'FSUP',
+    /// Sent by the root server when it launches a dynamically linked task
+    TaskLaunched                        = 'TKLN',
 };
 
 /**
@@ -21,8 +34,36 @@ enum class DyldosrvMessageType: uint32_t {
  */
 enum DyldosrvErrors: int {
     InternalError                       = -48400,
+    /// No launch closure exists for the executable
+    NoClosure                           = -48401,
+    /// The launch closure is malformed or too large
+    InvalidClosure                      = -48402,
+    /// A launch closure for the executable already exists
+    ClosureExists                       = -48403,
+    /// The caller may not store a launch closure for the executable
+    NotPermitted                        = -48404,
+};
+
+/**
+ * Header at the start of every launch closure. The remainder of the closure is only interpreted by
+ * the dynamic linker; the server validates just this header.
+ */
+struct DyldoClosureHeader {
+    /// Magic value; must be `kDyldoClosureMagic`
+    uint32_t magic;
+    /// Format version; must be `kDyldoClosureVersion`
+    uint32_t version;
+    /// Total length of the closure, in bytes, including this header
+    uint32_t length;
 };
 
+/// Magic value for launch closures
+constexpr static const uint32_t kDyldoClosureMagic{'DYCL'};
+/// Current launch closure format version
+constexpr static const uint32_t kDyldoClosureVersion{2};
+/// Maximum size of a launch closure, in bytes
+constexpr static const size_t kDyldoClosureMaxLength{0x100000};
+
 /**
  * Request to map a particular shared library's segment.
  *
@@ -53,4 +94,70 @@ struct DyldosrvMapSegmentReply {
     uintptr_t vmRegion;
 };
 
+/**
+ * Requests the launch closure for an executable. If one exists, it's mapped read-only into the
+ * address space of the caller at the given address.
+ */
+struct DyldosrvGetClosureRequest {
+    /// Address at which the closure is mapped; must be page aligned
+    uintptr_t mapAt;
+    /// Number of bytes of virtual memory reserved at that address
+    size_t mapLength;
+
+    /// Zero terminated string containing the full path of the executable
+    char path[];
+};
+
+/**
+ * Reply to a launch closure request.
+ */
+struct DyldosrvGetClosureReply {
+    /// Status code: 0 indicates success
+    int32_t status;
+
+    /// VM handle of the region containing the closure
+    uintptr_t vmRegion;
+    /// Length of the closure, in bytes
+    size_t length;
+};
+
+/**
+ * Stores the launch closure for an executable. The server copies the closure out of the provided
+ * VM region before replying.
+ *
+ * Closures are only accepted from a task that the root server launched from the executable (see
+ * `DyldosrvTaskLaunchedRequest`) and only once per launch; an existing closure is never replaced.
+ */
+struct DyldosrvStoreClosureRequest {
+    /// VM region containing the closure, starting at its first byte
+    uintptr_t vmRegion;
+    /// Length of the closure, in bytes
+    size_t length;
+
+    /// Zero terminated string containing the full path of the executable
+    char path[];
+};
+
+/**
+ * Reply to a request to store a launch closure.
+ */
+struct DyldosrvStoreClosureReply {
+    /// Status code: 0 indicates success
+    int32_t status;
+};
+
+/**
+ * Notification sent by the root server when it launches a dynamically linked task, before the
+ * task starts executing. No reply is sent.
+ *
+ * It's only honored if sent by the task that loaded us (as indicated in our launch info.)
+ */
+struct DyldosrvTaskLaunchedRequest {
+    /// Kernel handle of the task that was launched
+    uintptr_t task;
+
+    /// Zero terminated string containing the full path of the executable
+    char path[];
+};
+
 #endif
@@ -0,0 +1,248 @@
+#include "ClosureCache.h"
+#include "Log.h"
+#include "PacketTypes.h"
+#include "hashmap.h"
+
+#include <unistd.h>
+#include <sys/syscalls.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+/// Region of virtual memory space for temporary mappings of closures
+static uintptr_t kClosureMappingRange[2] = {
+    // start
+    0x14000000000,
+    // end (256G later)
+    0x18000000000,
+};
+
+/**
+ * Initializes the closure map.
+ */
+ClosureCache::ClosureCache() {
+    this->closures = hashmap_new(sizeof(Entry), 16, 'DYLD', 'CLOS', HashEntry, CompareEntry,
+            nullptr);
+}
+
+/**
+ * Releases all closures.
+ */
+ClosureCache::~ClosureCache() {
+    hashmap_scan(this->closures, [](const void *item, void *) -> bool {
+        auto e = reinterpret_cast<const Entry *>(item);
+        DeallocVirtualRegion(e->region);
+        free(const_cast<char *>(e->path));
+        return true;
+    }, nullptr);
+
+    hashmap_free(this->closures);
+
+    for(auto &launch : this->launches) {
+        free(launch.path);
+    }
+}
+
+
+
+/**
+ * Hashes the path of a closure entry.
+ */
+uint64_t ClosureCache::HashEntry(const void *item, uint64_t s0, uint64_t s1) {
+    auto e = reinterpret_cast<const Entry *>(item);
+    return hashmap_sip(e->path, e->pathLen, s0, s1);
+}
+
+/**
+ * Compares the paths of two closure entries.
+ */
+int ClosureCache::CompareEntry(const void *a, const void *b, void *) {
+    auto e1 = reinterpret_cast<const Entry *>(a);
+    auto e2 = reinterpret_cast<const Entry *>(b);
+
+    if(e1->pathLen != e2->pathLen) {
+        return (e1->pathLen < e2->pathLen) ? -1 : 1;
+    }
+    return memcmp(e1->path, e2->path, e1->pathLen);
+}
+
+
+
+/**
+ * Records that the root server launched a task from the given executable. That task may then
+ * store a closure for it, unless one already exists.
+ */
+void ClosureCache::taskLaunched(const uintptr_t task, const char *path) {
+    Entry ent{path, strlen(path), 0, 0};
+    if(hashmap_get(this->closures, &ent)) {
+        return;
+    }
+
+    auto path2 = strdup(path);
+    if(!path2) {
+        Abort("out of memory");
+    }
+
+    auto &launch = this->launches[this->nextLaunch];
+    free(launch.path);
+    launch.task = task;
+    launch.path = path2;
+
+    this->nextLaunch = (this->nextLaunch + 1) % kMaxLaunches;
+}
+
+/**
+ * Checks whether the given task was launched from the given executable and hasn't yet stored a
+ * closure; if so, the launch record is removed.
+ *
+ * @return Whether the task may store a closure for the executable
+ */
+bool ClosureCache::consumeLaunch(const uintptr_t task, const char *path) {
+    for(auto &launch : this->launches) {
+        if(launch.task != task || !launch.path || strcmp(launch.path, path)) {
+            continue;
+        }
+
+        free(launch.path);
+        launch.path = nullptr;
+        launch.task = 0;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Stores a new closure for the given executable. It's accepted only if the calling task was
+ * launched from that executable, and there's no closure for it yet.
+ *
+ * The closure is copied into a new VM region we own, since the caller's region goes away with it.
+ *
+ * @param task Task that sent the closure
+ * @param srcRegion VM region (owned by the caller) holding the closure
+ * @param length Number of bytes of closure data
+ *
+ * @return 0 on success, or an error code
+ */
+int ClosureCache::store(const uintptr_t task, const char *path, const uintptr_t srcRegion,
+        const size_t length) {
+    int err, ret{DyldosrvErrors::InternalError};
+    uintptr_t srcBase{0}, region{0}, base{0};
+    const auto pageSz = sysconf(_SC_PAGESIZE);
+
+    Entry ent{path, strlen(path), 0, length};
+    if(!this->consumeLaunch(task, path)) {
+        return DyldosrvErrors::NotPermitted;
+    } else if(hashmap_get(this->closures, &ent)) {
+        return DyldosrvErrors::ClosureExists;
+    } else if(hashmap_count(this->closures) >= kMaxClosures) {
+        return -ENOSPC;
+    }
+
+    if(length < sizeof(DyldoClosureHeader) || length > kDyldoClosureMaxLength) {
+        return DyldosrvErrors::InvalidClosure;
+    }
+
+    const size_t mapLength = ((length + pageSz - 1) / pageSz) * pageSz;
+
+    // map the caller's region and validate the header
+    err = MapVirtualRegionRange(srcRegion, kClosureMappingRange, mapLength, 0, &srcBase);
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegionRange", err);
+        return err;
+    }
+
+    auto hdr = reinterpret_cast<const DyldoClosureHeader *>(srcBase);
+    if(hdr->magic != kDyldoClosureMagic || hdr->version != kDyldoClosureVersion ||
+            hdr->length != length) {
+        ret = DyldosrvErrors::InvalidClosure;
+        goto fail;
+    }
+
+    // copy it into our own region, then make it read-only
+    err = AllocVirtualAnonRegion(mapLength, VM_REGION_RW, &region);
+    if(err) {
+        Warn("%s failed: %d", "AllocVirtualAnonRegion", err);
+        goto fail;
+    }
+
+    err = MapVirtualRegionRange(region, kClosureMappingRange, mapLength, 0, &base);
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegionRange", err);
+        goto fail;
+    }
+
+    memcpy(reinterpret_cast<void *>(base), hdr, length);
+
+    err = VirtualRegionSetFlags(region, VM_REGION_READ);
+    if(err) {
+        Warn("%s failed: %d", "VirtualRegionSetFlags", err);
+        goto fail;
+    }
+
+    UnmapVirtualRegion(region);
+    UnmapVirtualRegion(srcRegion);
+
+    // insert it
+    ent.path = strndup(path, ent.pathLen);
+    if(!ent.path) {
+        DeallocVirtualRegion(region);
+        return -ENOMEM;
+    }
+    ent.region = region;
+
+    hashmap_set(this->closures, &ent);
+    if(hashmap_oom(this->closures)) {
+        Abort("%s failed: %d", "hashmap_set", ENOMEM);
+    }
+
+    return 0;
+
+fail:;
+    if(region) {
+        DeallocVirtualRegion(region);
+    }
+    UnmapVirtualRegion(srcRegion);
+
+    return ret;
+}
+
+/**
+ * Maps the closure for the given executable into a task.
+ *
+ * @param task Task to map the closure into
+ * @param mapAt Base address for the mapping in the task
+ * @param mapLength Number of bytes of virtual memory space available at that address
+ * @param outRegion VM region containing the closure
+ * @param outLength Length of the closure, in bytes
+ *
+ * @return 0 on success, or an error code
+ */
+int ClosureCache::map(const char *path, const uintptr_t task, const uintptr_t mapAt,
+        const size_t mapLength, uintptr_t &outRegion, size_t &outLength) {
+    int err;
+    const auto pageSz = sysconf(_SC_PAGESIZE);
+
+    Entry ent{path, strlen(path), 0, 0};
+    auto item = hashmap_get(this->closures, &ent);
+    if(!item) {
+        return DyldosrvErrors::NoClosure;
+    }
+
+    auto e = reinterpret_cast<const Entry *>(item);
+    const size_t length = ((e->length + pageSz - 1) / pageSz) * pageSz;
+    if(length > mapLength || !mapAt || mapAt % pageSz) {
+        return DyldosrvErrors::InvalidClosure;
+    }
+
+    err = MapVirtualRegionRemote(task, e->region, mapAt, length, 0);
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegionRemote", err);
+        return err;
+    }
+
+    outRegion = e->region;
+    outLength = e->length;
+    return 0;
+}
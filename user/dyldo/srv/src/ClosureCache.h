@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct hashmap;
+
+/**
+ * Stores launch closures for executables, as generated by the dynamic linker the first time an
+ * executable is launched. They're opaque to us, other than their header.
+ *
+ * Each closure is kept in its own read-only VM region, which is mapped directly into tasks that
+ * request it. Closures live until the server exits; they're never replaced.
+ *
+ * Since closures are trusted by every later launch of an executable, they're only accepted from a
+ * task that the root server told us it launched from that executable, once per launch. These
+ * launches are kept in a small ring, so records of tasks that never store a closure (because they
+ * received one, or exited early) are eventually overwritten.
+ */
+class ClosureCache {
+    /// Maximum number of closures to store
+    constexpr static const size_t kMaxClosures{128};
+    /// Maximum number of launches that may store a closure
+    constexpr static const size_t kMaxLaunches{64};
+
+    public:
+        ClosureCache();
+        ~ClosureCache();
+
+        /// Records that a task was launched from the given executable
+        void taskLaunched(const uintptr_t task, const char *path);
+        /// Stores a closure, copying it out of the given VM region
+        int store(const uintptr_t task, const char *path, const uintptr_t srcRegion,
+                const size_t length);
+        /// Maps the closure for the given executable into a task
+        int map(const char *path, const uintptr_t task, const uintptr_t mapAt,
+                const size_t mapLength, uintptr_t &outRegion, size_t &outLength);
+
+    private:
+        /// Entry in the hash map
+        struct Entry {
+            /// copy of the executable's path
+            const char *path{nullptr};
+            /// number of characters in the path
+            size_t pathLen{0};
+
+            /// VM region containing the closure
+            uintptr_t region{0};
+            /// length of the closure, in bytes
+            size_t length{0};
+        };
+
+        /// A task that may store a closure
+        struct Launch {
+            /// kernel handle of the task
+            uintptr_t task{0};
+            /// copy of the path of the executable it was launched from
+            char *path{nullptr};
+        };
+
+        static uint64_t HashEntry(const void *_item, uint64_t s0, uint64_t s1);
+        static int CompareEntry(const void *a, const void *b, void *udata);
+
+        bool consumeLaunch(const uintptr_t task, const char *path);
+
+    private:
+        /// all closures, keyed by executable path
+        hashmap *closures{nullptr};
+
+        /// tasks that may store a closure
+        Launch launches[kMaxLaunches];
+        /// index of the launch record to overwrite next
+        size_t nextLaunch{0};
+};
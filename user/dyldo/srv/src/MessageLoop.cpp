@@ -1,10 +1,12 @@
 #include "MessageLoop.h"
+#include "ClosureCache.h"
 #include "Library.h"
 #include "hashmap.h"
 #include "Log.h"
 #include "PacketTypes.h"
 
 #include <unistd.h>
+#include <LaunchInfo.h>
 #include <rpc/dispensary.h>
 #include <rpc/RpcPacket.hpp>
 #include <sys/elf.h>
@@ -16,6 +18,7 @@
 #include <cstring>
 
 extern "C" void __librpc__FileIoResetConnection();
+extern "C" kush_task_launchinfo_t *__libc_task_info;
 
 /// Region of virtual memory space for temporary mappings
 static uintptr_t kTempMappingRange[2] = {
@@ -35,6 +38,7 @@ MessageLoop::MessageLoop() {
     // set up libraries map
     this->libraries = hashmap_new(sizeof(HashmapEntry), 16, 'DYLD', 'LIBS', HashLib, CompareLib,
             nullptr);
+    this->closures = new ClosureCache;
 
     // allocate receive and send buffers
     err = posix_memalign(&this->rxBuf, 16, kMaxMsgLen);
@@ -64,6 +68,7 @@ MessageLoop::MessageLoop() {
  */
 MessageLoop::~MessageLoop() {
     hashmap_free(this->libraries);
+    delete this->closures;
 
     PortDestroy(this->port);
     free(this->rxBuf);
@@ -123,9 +128,19 @@ void MessageLoop::run() {
                 this->handleMapSegment(*msg);
                 break;
 
+            case static_cast<uint32_t>(DyldosrvMessageType::GetClosure):
+                this->handleGetClosure(*msg);
+                break;
+            case static_cast<uint32_t>(DyldosrvMessageType::StoreClosure):
+                this->handleStoreClosure(*msg);
+                break;
+
             case static_cast<uint32_t>(DyldosrvMessageType::RootFsUpdated):
                 __librpc__FileIoResetConnection();
                 break;
+            case static_cast<uint32_t>(DyldosrvMessageType::TaskLaunched):
+                this->handleTaskLaunched(*msg);
+                break;
 
             default:
                 Warn("Unknown RPC message type: $%08x", packet->type);
@@ -431,3 +446,115 @@ void MessageLoop::reply(const struct MessageHeader &msg, const DyldosrvMapSegmen
     }
 }
 
+
+
+/**
+ * Handles a request for the launch closure of an executable. If we have one, it's mapped into the
+ * caller's address space at the address it requested.
+ */
+void MessageLoop::handleGetClosure(const struct MessageHeader &msg) {
+    DyldosrvGetClosureReply reply{0, 0, 0};
+
+    // validate it
+    auto packet = reinterpret_cast<const rpc::RpcPacket *>(msg.data);
+    const size_t payloadBytes = msg.receivedBytes - sizeof(rpc::RpcPacket);
+    if(payloadBytes < sizeof(DyldosrvGetClosureRequest) + 2) {
+        Warn("Received too small RPC message (%lu bytes, type $%08x)", msg.receivedBytes,
+                packet->type);
+        return;
+    }
+
+    auto req = reinterpret_cast<const DyldosrvGetClosureRequest *>(packet->payload);
+    if(!memchr(req->path, '\0', payloadBytes - sizeof(DyldosrvGetClosureRequest))) {
+        Warn("Invalid path in closure request");
+        return;
+    }
+
+    // map it
+    reply.status = this->closures->map(req->path, msg.senderTask, req->mapAt, req->mapLength,
+            reply.vmRegion, reply.length);
+
+    this->sendReply(msg, DyldosrvMessageType::GetClosureReply, &reply, sizeof(reply));
+}
+
+/**
+ * Handles a request to store the launch closure for an executable.
+ */
+void MessageLoop::handleStoreClosure(const struct MessageHeader &msg) {
+    DyldosrvStoreClosureReply reply{0};
+
+    // validate it
+    auto packet = reinterpret_cast<const rpc::RpcPacket *>(msg.data);
+    const size_t payloadBytes = msg.receivedBytes - sizeof(rpc::RpcPacket);
+    if(payloadBytes < sizeof(DyldosrvStoreClosureRequest) + 2) {
+        Warn("Received too small RPC message (%lu bytes, type $%08x)", msg.receivedBytes,
+                packet->type);
+        return;
+    }
+
+    auto req = reinterpret_cast<const DyldosrvStoreClosureRequest *>(packet->payload);
+    if(!memchr(req->path, '\0', payloadBytes - sizeof(DyldosrvStoreClosureRequest))) {
+        Warn("Invalid path in closure request");
+        return;
+    }
+
+    // copy the closure
+    reply.status = this->closures->store(msg.senderTask, req->path, req->vmRegion, req->length);
+    if(reply.status) {
+        Warn("Failed to store closure for %s: %d", req->path, reply.status);
+    }
+
+    this->sendReply(msg, DyldosrvMessageType::StoreClosureReply, &reply, sizeof(reply));
+}
+
+/**
+ * Handles the root server's notification that it launched a task. This is what allows the task to
+ * store a launch closure for its executable, so it's ignored unless it was sent by the task that
+ * loaded us.
+ */
+void MessageLoop::handleTaskLaunched(const struct MessageHeader &msg) {
+    auto packet = reinterpret_cast<const rpc::RpcPacket *>(msg.data);
+    if(!__libc_task_info || msg.senderTask != __libc_task_info->loaderTask) {
+        Warn("Ignoring launch notification from task $%p'h", msg.senderTask);
+        return;
+    }
+
+    // validate it
+    const size_t payloadBytes = msg.receivedBytes - sizeof(rpc::RpcPacket);
+    if(payloadBytes < sizeof(DyldosrvTaskLaunchedRequest) + 2) {
+        Warn("Received too small RPC message (%lu bytes, type $%08x)", msg.receivedBytes,
+                packet->type);
+        return;
+    }
+
+    auto req = reinterpret_cast<const DyldosrvTaskLaunchedRequest *>(packet->payload);
+    if(!memchr(req->path, '\0', payloadBytes - sizeof(DyldosrvTaskLaunchedRequest))) {
+        Warn("Invalid path in launch notification");
+        return;
+    }
+
+    this->closures->taskLaunched(req->task, req->path);
+}
+
+/**
+ * Sends a reply to a previously received request.
+ */
+void MessageLoop::sendReply(const struct MessageHeader &msg, const DyldosrvMessageType type,
+        const void *payload, const size_t payloadBytes) {
+    int err;
+    auto inPacket = reinterpret_cast<const rpc::RpcPacket *>(msg.data);
+
+    // construct the reply message
+    const size_t msgBytes = sizeof(rpc::RpcPacket) + payloadBytes;
+    memset(this->txBuf, 0, msgBytes);
+
+    auto outPacket = reinterpret_cast<rpc::RpcPacket *>(this->txBuf);
+    outPacket->type = static_cast<uint32_t>(type);
+    memcpy(outPacket->payload, payload, payloadBytes);
+
+    // send it
+    err = PortSend(inPacket->replyPort, outPacket, msgBytes);
+    if(err) {
+        Warn("%s failed: %d", "PortSend", err);
+    }
+}
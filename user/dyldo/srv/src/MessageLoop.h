@@ -4,10 +4,13 @@
 #include <cstdint>
 #include <string_view>
 
+#include "PacketTypes.h"
+
 struct hashmap;
 struct MessageHeader;
 struct DyldosrvMapSegmentRequest;
 
+class ClosureCache;
 class Library;
 
 /**
@@ -48,6 +51,12 @@ class MessageLoop {
         void reply(const struct MessageHeader &, const DyldosrvMapSegmentRequest &, const int err);
         void reply(const struct MessageHeader &, const DyldosrvMapSegmentRequest &, const uintptr_t vmRegion);
 
+        void handleGetClosure(const struct MessageHeader &);
+        void handleStoreClosure(const struct MessageHeader &);
+        void handleTaskLaunched(const struct MessageHeader &);
+        void sendReply(const struct MessageHeader &, const DyldosrvMessageType type,
+                const void *payload, const size_t payloadBytes);
+
     private:
         /// Message receive buffer
         void *rxBuf{nullptr};
@@ -59,4 +68,6 @@ class MessageLoop {
 
         /// mapping of all loaded libraries
         hashmap *libraries{nullptr};
+        /// launch closures for executables
+        ClosureCache *closures{nullptr};
 };
@@ -0,0 +1 @@
+../../src/pixels/Pixels.h
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * AVX2 implementation of the pixel routines, processing eight pixels at a time.
+ *
+ * This mirrors the SSE2 implementation. Note that most AVX2 unpack and pack instructions operate
+ * on each 128-bit half of the register independently; since every unpack is paired with the
+ * corresponding pack, pixels end up back in their original order.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include "Kernels.h"
+
+#include <immintrin.h>
+
+using namespace gui::gfx::pixels;
+
+#define AVX2 __attribute__((target("avx2")))
+
+/**
+ * Composites eight source pixels over eight destination pixels.
+ */
+AVX2 static inline __m256i Blend8(const __m256i d, const __m256i s) {
+    const auto zero = _mm256_setzero_si256();
+    const auto k255 = _mm256_set1_epi16(255);
+    const auto k128 = _mm256_set1_epi16(128);
+
+    // broadcast inverse alpha of each pixel to all of its components
+    auto aLo = _mm256_unpacklo_epi8(s, zero);
+    auto aHi = _mm256_unpackhi_epi8(s, zero);
+    aLo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(aLo, 0xFF), 0xFF);
+    aHi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(aHi, 0xFF), 0xFF);
+    aLo = _mm256_sub_epi16(k255, aLo);
+    aHi = _mm256_sub_epi16(k255, aHi);
+
+    // scale the destination
+    auto lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), aLo), k128);
+    auto hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), aHi), k128);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+    // then add the source
+    return _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), s);
+}
+
+AVX2 static void BlendOver(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto alphaMask = _mm256_set1_epi32(0xFF000000);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+
+        // all pixels fully transparent: nothing to do
+        if(_mm256_testz_si256(s, s)) continue;
+
+        auto out = reinterpret_cast<__m256i *>(dst + i);
+
+        // all pixels fully opaque: replace destination
+        const auto opaque = _mm256_cmpeq_epi32(_mm256_and_si256(s, alphaMask), alphaMask);
+        if(_mm256_movemask_epi8(opaque) == -1) {
+            _mm256_storeu_si256(out, s);
+            continue;
+        }
+
+        _mm256_storeu_si256(out, Blend8(_mm256_loadu_si256(out), s));
+    }
+
+    for(; i < count; i++) {
+        dst[i] = impl::BlendPixel(dst[i], src[i]);
+    }
+}
+
+AVX2 static void Fill(uint32_t *dst, const uint32_t color, const size_t count) {
+    const auto c = _mm256_set1_epi32(color);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), c);
+    }
+    for(; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+AVX2 static void Argb32ToRgb30(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto rMask = _mm256_set1_epi32(0xFF0000), rTop = _mm256_set1_epi32(0xC00000);
+    const auto gMask = _mm256_set1_epi32(0x00FF00), gTop = _mm256_set1_epi32(0x00C000);
+    const auto bMask = _mm256_set1_epi32(0x0000FF), bTop = _mm256_set1_epi32(0x0000C0);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+
+        auto r = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, rMask), 6),
+                _mm256_srli_epi32(_mm256_and_si256(p, rTop), 2));
+        auto g = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, gMask), 4),
+                _mm256_srli_epi32(_mm256_and_si256(p, gTop), 4));
+        auto b = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, bMask), 2),
+                _mm256_srli_epi32(_mm256_and_si256(p, bTop), 6));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                _mm256_or_si256(_mm256_or_si256(r, g), b));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb30(src[i]);
+    }
+}
+
+AVX2 static void Rgb30ToArgb32(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto alpha = _mm256_set1_epi32(0xFF000000);
+    const auto rMask = _mm256_set1_epi32(0xFF0000);
+    const auto gMask = _mm256_set1_epi32(0x00FF00);
+    const auto bMask = _mm256_set1_epi32(0x0000FF);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+
+        auto r = _mm256_and_si256(_mm256_srli_epi32(p, 6), rMask);
+        auto g = _mm256_and_si256(_mm256_srli_epi32(p, 4), gMask);
+        auto b = _mm256_and_si256(_mm256_srli_epi32(p, 2), bMask);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                _mm256_or_si256(_mm256_or_si256(alpha, r), _mm256_or_si256(g, b)));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelRgb30ToArgb32(src[i]);
+    }
+}
+
+/**
+ * Converts eight ARGB32 pixels; the 32-bit results are packed to 16 bits, then the two middle
+ * 64-bit quarters are swapped to undo the per-lane interleaving of the pack.
+ */
+AVX2 static void Argb32ToRgb565(uint16_t *dst, const uint32_t *src, const size_t count) {
+    const auto rMask = _mm256_set1_epi32(0xF800);
+    const auto gMask = _mm256_set1_epi32(0x07E0);
+    const auto bMask = _mm256_set1_epi32(0x001F);
+
+    size_t i{0};
+    for(; i + 16 <= count; i += 16) {
+        __m256i out[2];
+
+        for(size_t j = 0; j < 2; j++) {
+            const auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + (j * 8)));
+
+            const auto r = _mm256_and_si256(_mm256_srli_epi32(p, 8), rMask);
+            const auto g = _mm256_and_si256(_mm256_srli_epi32(p, 5), gMask);
+            const auto b = _mm256_and_si256(_mm256_srli_epi32(p, 3), bMask);
+            out[j] = _mm256_or_si256(_mm256_or_si256(r, g), b);
+        }
+
+        const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(out[0], out[1]), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), packed);
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb565(src[i]);
+    }
+}
+
+AVX2 static void Rgb565ToArgb32(uint32_t *dst, const uint16_t *src, const size_t count) {
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+
+        auto r = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p,
+                        _mm256_set1_epi32(0xF800)), 8),
+                _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xE000)), 3));
+        auto g = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p,
+                        _mm256_set1_epi32(0x07E0)), 5),
+                _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x0600)), 1));
+        auto b = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p,
+                        _mm256_set1_epi32(0x001F)), 3),
+                _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x001C)), 2));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0xFF000000), r),
+                    _mm256_or_si256(g, b)));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelRgb565ToArgb32(src[i]);
+    }
+}
+
+AVX2 static void SwapBgra(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_shuffle_epi8(p, mask));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::SwapPixel(src[i]);
+    }
+}
+
+const impl::Kernels impl::gAvx2Kernels{
+    .name               = "avx2",
+    .blendOver          = BlendOver,
+    .fill               = Fill,
+    .argb32ToRgb30      = Argb32ToRgb30,
+    .rgb30ToArgb32      = Rgb30ToArgb32,
+    .argb32ToRgb565     = Argb32ToRgb565,
+    .rgb565ToArgb32     = Rgb565ToArgb32,
+    .swapBgra           = SwapBgra,
+};
+#endif
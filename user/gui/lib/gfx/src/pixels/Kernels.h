@@ -0,0 +1,87 @@
+/**
+ * Internal definitions shared between the different implementations of the pixel routines.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gui::gfx::pixels::impl {
+/**
+ * Table of function pointers for one implementation of the pixel routines.
+ */
+struct Kernels {
+    /// Name of the implementation, for debugging
+    const char *name;
+
+    void (*blendOver)(uint32_t *dst, const uint32_t *src, const size_t count);
+    void (*fill)(uint32_t *dst, const uint32_t color, const size_t count);
+
+    void (*argb32ToRgb30)(uint32_t *dst, const uint32_t *src, const size_t count);
+    void (*rgb30ToArgb32)(uint32_t *dst, const uint32_t *src, const size_t count);
+    void (*argb32ToRgb565)(uint16_t *dst, const uint32_t *src, const size_t count);
+    void (*rgb565ToArgb32)(uint32_t *dst, const uint16_t *src, const size_t count);
+    void (*swapBgra)(uint32_t *dst, const uint32_t *src, const size_t count);
+};
+
+extern const Kernels gScalarKernels;
+#if defined(__x86_64__) || defined(__i386__)
+extern const Kernels gSse2Kernels;
+extern const Kernels gAvx2Kernels;
+#endif
+
+/*
+ * Single pixel versions of each operation. The vectorized implementations use these for any
+ * pixels left over at the end of a row, so they must produce exactly the same results.
+ */
+
+/**
+ * Composites a premultiplied source pixel over the destination. Each destination component is
+ * scaled by the inverse of the source alpha (divided by 255, rounded) and the source component is
+ * then added, saturating at 255.
+ *
+ * Red/blue and alpha/green are processed as pairs of 16-bit fields in a single 32-bit word.
+ */
+inline uint32_t BlendPixel(const uint32_t d, const uint32_t s) {
+    const uint32_t ia = 255 - (s >> 24);
+
+    uint32_t rb = (d & 0x00FF00FF) * ia + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    rb += s & 0x00FF00FF;
+    rb |= 0x01000100 - ((rb >> 8) & 0x00010001);
+    rb &= 0x00FF00FF;
+
+    uint32_t ag = ((d >> 8) & 0x00FF00FF) * ia + 0x00800080;
+    ag = ((ag + ((ag >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag += (s >> 8) & 0x00FF00FF;
+    ag |= 0x01000100 - ((ag >> 8) & 0x00010001);
+    ag &= 0x00FF00FF;
+
+    return rb | (ag << 8);
+}
+
+/// Converts an ARGB32 pixel to RGB30, replicating the top bits of each component into the bottom.
+constexpr inline uint32_t PixelArgb32ToRgb30(const uint32_t p) {
+    return ((p & 0xFF0000) << 6) | ((p & 0xC00000) >> 2) |
+        ((p & 0x00FF00) << 4) | ((p & 0x00C000) >> 4) |
+        ((p & 0x0000FF) << 2) | ((p & 0x0000C0) >> 6);
+}
+/// Converts an RGB30 pixel to ARGB32 by dropping the low bits of each component.
+constexpr inline uint32_t PixelRgb30ToArgb32(const uint32_t p) {
+    return 0xFF000000 | ((p >> 6) & 0xFF0000) | ((p >> 4) & 0x00FF00) | ((p >> 2) & 0x0000FF);
+}
+/// Converts an ARGB32 pixel to RGB565 by dropping the low bits of each component.
+constexpr inline uint16_t PixelArgb32ToRgb565(const uint32_t p) {
+    return ((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F);
+}
+/// Converts an RGB565 pixel to ARGB32, replicating the top bits of each component into the bottom.
+constexpr inline uint32_t PixelRgb565ToArgb32(const uint32_t p) {
+    return 0xFF000000 | ((p & 0xF800) << 8) | ((p & 0xE000) << 3) |
+        ((p & 0x07E0) << 5) | ((p & 0x0600) >> 1) |
+        ((p & 0x001F) << 3) | ((p & 0x001C) >> 2);
+}
+/// Reverses the byte order of a pixel.
+constexpr inline uint32_t SwapPixel(const uint32_t p) {
+    return __builtin_bswap32(p);
+}
+}
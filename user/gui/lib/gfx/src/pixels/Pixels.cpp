@@ -0,0 +1,211 @@
+#include "Pixels.h"
+#include "Kernels.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+using namespace gui::gfx;
+using namespace gui::gfx::pixels;
+
+/// Implementation selected for use; chosen the first time any pixel routine is called
+static std::atomic<const impl::Kernels *> gKernels{nullptr};
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Checks whether the processor supports SSE2.
+ */
+static bool SupportsSse2() {
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+
+    return (edx & bit_SSE2);
+}
+
+/**
+ * Checks whether the processor supports AVX2, and whether the OS has enabled saving the extended
+ * register state (via XSAVE) so that we may use the 256-bit registers.
+ */
+static bool SupportsAvx2() {
+    unsigned int eax, ebx, ecx, edx;
+
+    // AVX and OSXSAVE are required
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    if(!(ecx & bit_AVX) || !(ecx & bit_OSXSAVE)) return false;
+
+    // the OS must save both SSE and AVX state
+    uint32_t xcr0Lo, xcr0Hi;
+    asm volatile("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+    if((xcr0Lo & 0b110) != 0b110) return false;
+
+    // check for AVX2 itself
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & bit_AVX2);
+}
+#endif
+
+/**
+ * Returns the function table for the given implementation, if the processor supports it.
+ */
+static const impl::Kernels *GetKernelsFor(const Implementation which) {
+    switch(which) {
+        case Implementation::Scalar:
+            return &impl::gScalarKernels;
+
+#if defined(__x86_64__) || defined(__i386__)
+        case Implementation::Sse2:
+            return SupportsSse2() ? &impl::gSse2Kernels : nullptr;
+        case Implementation::Avx2:
+            return SupportsAvx2() ? &impl::gAvx2Kernels : nullptr;
+#endif
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Returns the function table of the implementation to use. The first time this is invoked, the
+ * fastest implementation supported by the processor is selected.
+ */
+static const impl::Kernels &GetKernels() {
+    auto k = gKernels.load(std::memory_order_relaxed);
+    if(k) [[likely]] return *k;
+
+    for(const auto which : {Implementation::Avx2, Implementation::Sse2, Implementation::Scalar}) {
+        k = GetKernelsFor(which);
+        if(k) break;
+    }
+
+    gKernels.store(k, std::memory_order_relaxed);
+    return *k;
+}
+
+
+
+/**
+ * Gets the implementation of the pixel routines that is currently in use.
+ */
+Implementation pixels::GetImplementation() {
+    const auto &k = GetKernels();
+
+#if defined(__x86_64__) || defined(__i386__)
+    if(&k == &impl::gAvx2Kernels) return Implementation::Avx2;
+    else if(&k == &impl::gSse2Kernels) return Implementation::Sse2;
+#endif
+    return Implementation::Scalar;
+}
+
+/**
+ * Gets the name of the current implementation of the pixel routines.
+ */
+const char *pixels::GetImplementationName() {
+    return GetKernels().name;
+}
+
+/**
+ * Overrides the implementation selection. This is mostly useful to compare the results or
+ * performance of different implementations.
+ *
+ * @return Whether the implementation is supported; if not, the current one remains in use.
+ */
+bool pixels::SetImplementation(const Implementation which) {
+    auto k = GetKernelsFor(which);
+    if(!k) return false;
+
+    gKernels.store(k, std::memory_order_relaxed);
+    return true;
+}
+
+
+
+void pixels::BlendOver(uint32_t *dst, const uint32_t *src, const size_t count) {
+    GetKernels().blendOver(dst, src, count);
+}
+void pixels::Fill(uint32_t *dst, const uint32_t color, const size_t count) {
+    GetKernels().fill(dst, color, count);
+}
+/**
+ * Copying is left to `memcpy`, which is already optimized for the platform.
+ */
+void pixels::Copy(uint32_t *dst, const uint32_t *src, const size_t count) {
+    memcpy(dst, src, count * sizeof(uint32_t));
+}
+
+void pixels::ConvertArgb32ToRgb30(uint32_t *dst, const uint32_t *src, const size_t count) {
+    GetKernels().argb32ToRgb30(dst, src, count);
+}
+void pixels::ConvertRgb30ToArgb32(uint32_t *dst, const uint32_t *src, const size_t count) {
+    GetKernels().rgb30ToArgb32(dst, src, count);
+}
+void pixels::ConvertArgb32ToRgb565(uint16_t *dst, const uint32_t *src, const size_t count) {
+    GetKernels().argb32ToRgb565(dst, src, count);
+}
+void pixels::ConvertRgb565ToArgb32(uint32_t *dst, const uint16_t *src, const size_t count) {
+    GetKernels().rgb565ToArgb32(dst, src, count);
+}
+void pixels::SwapArgb32Bgra(uint32_t *dst, const uint32_t *src, const size_t count) {
+    GetKernels().swapBgra(dst, src, count);
+}
+
+
+
+/**
+ * Composites a rectangle of pixels, one row at a time.
+ */
+void pixels::BlendOverRect(void *dst, const size_t dstPitch, const void *src,
+        const size_t srcPitch, const size_t width, const size_t height) {
+    const auto &k = GetKernels();
+
+    auto dstRow = reinterpret_cast<std::byte *>(dst);
+    auto srcRow = reinterpret_cast<const std::byte *>(src);
+
+    for(size_t y = 0; y < height; y++) {
+        k.blendOver(reinterpret_cast<uint32_t *>(dstRow), reinterpret_cast<const uint32_t *>(srcRow),
+                width);
+
+        dstRow += dstPitch;
+        srcRow += srcPitch;
+    }
+}
+
+/**
+ * Fills a rectangle of pixels, one row at a time.
+ */
+void pixels::FillRect(void *dst, const size_t dstPitch, const uint32_t color, const size_t width,
+        const size_t height) {
+    const auto &k = GetKernels();
+    auto dstRow = reinterpret_cast<std::byte *>(dst);
+
+    for(size_t y = 0; y < height; y++) {
+        k.fill(reinterpret_cast<uint32_t *>(dstRow), color, width);
+        dstRow += dstPitch;
+    }
+}
+
+/**
+ * Copies a rectangle of pixels. If both source and destination rows are contiguous, the entire
+ * rectangle is copied at once.
+ */
+void pixels::CopyRect(void *dst, const size_t dstPitch, const void *src, const size_t srcPitch,
+        const size_t width, const size_t height) {
+    const auto rowBytes = width * sizeof(uint32_t);
+
+    if(dstPitch == rowBytes && srcPitch == rowBytes) {
+        memcpy(dst, src, rowBytes * height);
+        return;
+    }
+
+    auto dstRow = reinterpret_cast<std::byte *>(dst);
+    auto srcRow = reinterpret_cast<const std::byte *>(src);
+
+    for(size_t y = 0; y < height; y++) {
+        memcpy(dstRow, srcRow, rowBytes);
+
+        dstRow += dstPitch;
+        srcRow += srcPitch;
+    }
+}
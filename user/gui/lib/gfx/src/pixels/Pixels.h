@@ -0,0 +1,74 @@
+#ifndef GUI_LIBGFX_PIXELS_H
+#define GUI_LIBGFX_PIXELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Low level pixel manipulation routines, for operations that are performed on lots of pixels at
+ * once (such as compositing windows) where going through Cairo would be unnecessarily slow.
+ *
+ * Each operation is implemented in scalar code, as well as with SSE2 and AVX2 where available. The
+ * fastest implementation supported by the processor is selected the first time any of them are
+ * called; all implementations produce bit for bit identical results.
+ *
+ * All ARGB32 pixels are in native byte order with premultiplied alpha, the same as the Cairo
+ * `ARGB32` format. Pitches are always specified in bytes.
+ */
+namespace gui::gfx::pixels {
+/// Implementations of the pixel routines
+enum class Implementation {
+    /// Portable C++ implementation
+    Scalar,
+    /// x86 SSE2 implementation, processing four pixels at a time
+    Sse2,
+    /// x86 AVX2 implementation, processing eight pixels at a time
+    Avx2,
+};
+
+/// Returns the implementation of the pixel routines in use.
+Implementation GetImplementation();
+/// Returns the name of the implementation of the pixel routines in use.
+const char *GetImplementationName();
+/// Forces use of a particular implementation; returns whether the processor supports it.
+bool SetImplementation(const Implementation impl);
+
+/// Composites source pixels over the destination (Porter-Duff OVER, premultiplied alpha)
+void BlendOver(uint32_t *dst, const uint32_t *src, const size_t count);
+/// Writes the given color to all pixels
+void Fill(uint32_t *dst, const uint32_t color, const size_t count);
+/// Copies pixels from the source to the destination; they must not overlap
+void Copy(uint32_t *dst, const uint32_t *src, const size_t count);
+
+/// Converts ARGB32 pixels to RGB30 (10 bits per component; alpha is discarded)
+void ConvertArgb32ToRgb30(uint32_t *dst, const uint32_t *src, const size_t count);
+/// Converts RGB30 pixels to (opaque) ARGB32
+void ConvertRgb30ToArgb32(uint32_t *dst, const uint32_t *src, const size_t count);
+/// Converts ARGB32 pixels to RGB565 (alpha is discarded)
+void ConvertArgb32ToRgb565(uint16_t *dst, const uint32_t *src, const size_t count);
+/// Converts RGB565 pixels to (opaque) ARGB32
+void ConvertRgb565ToArgb32(uint32_t *dst, const uint16_t *src, const size_t count);
+/// Reverses the byte order of each pixel; this converts between ARGB32 and BGRA32.
+void SwapArgb32Bgra(uint32_t *dst, const uint32_t *src, const size_t count);
+
+/**
+ * Composites a rectangle of source pixels over the destination.
+ *
+ * @param dst Pointer to the top left destination pixel
+ * @param dstPitch Bytes per row of the destination
+ * @param src Pointer to the top left source pixel
+ * @param srcPitch Bytes per row of the source
+ * @param width Width of the rectangle, in pixels
+ * @param height Height of the rectangle, in pixels
+ */
+void BlendOverRect(void *dst, const size_t dstPitch, const void *src, const size_t srcPitch,
+        const size_t width, const size_t height);
+/// Fills a rectangle of pixels with a solid color.
+void FillRect(void *dst, const size_t dstPitch, const uint32_t color, const size_t width,
+        const size_t height);
+/// Copies a rectangle of pixels.
+void CopyRect(void *dst, const size_t dstPitch, const void *src, const size_t srcPitch,
+        const size_t width, const size_t height);
+} // namespace gui::gfx::pixels
+
+#endif
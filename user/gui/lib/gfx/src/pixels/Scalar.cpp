@@ -0,0 +1,64 @@
+/**
+ * Portable implementation of the pixel routines. This is used on processors that don't support any
+ * of the vectorized implementations.
+ */
+#include "Kernels.h"
+
+using namespace gui::gfx::pixels;
+
+/**
+ * Composites source pixels over the destination. Fully transparent source pixels leave the
+ * destination untouched, and fully opaque ones simply replace it.
+ */
+static void BlendOver(uint32_t *dst, const uint32_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        const auto s = src[i];
+
+        if(!s) continue;
+        else if((s >> 24) == 0xFF) dst[i] = s;
+        else dst[i] = impl::BlendPixel(dst[i], s);
+    }
+}
+
+static void Fill(uint32_t *dst, const uint32_t color, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+static void Argb32ToRgb30(uint32_t *dst, const uint32_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb30(src[i]);
+    }
+}
+static void Rgb30ToArgb32(uint32_t *dst, const uint32_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = impl::PixelRgb30ToArgb32(src[i]);
+    }
+}
+static void Argb32ToRgb565(uint16_t *dst, const uint32_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb565(src[i]);
+    }
+}
+static void Rgb565ToArgb32(uint32_t *dst, const uint16_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = impl::PixelRgb565ToArgb32(src[i]);
+    }
+}
+static void SwapBgra(uint32_t *dst, const uint32_t *src, const size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        dst[i] = impl::SwapPixel(src[i]);
+    }
+}
+
+const impl::Kernels impl::gScalarKernels{
+    .name               = "scalar",
+    .blendOver          = BlendOver,
+    .fill               = Fill,
+    .argb32ToRgb30      = Argb32ToRgb30,
+    .rgb30ToArgb32      = Rgb30ToArgb32,
+    .argb32ToRgb565     = Argb32ToRgb565,
+    .rgb565ToArgb32     = Rgb565ToArgb32,
+    .swapBgra           = SwapBgra,
+};
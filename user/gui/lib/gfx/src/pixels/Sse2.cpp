@@ -0,0 +1,224 @@
+/**
+ * SSE2 implementation of the pixel routines, processing four pixels at a time.
+ *
+ * All functions are compiled for SSE2 explicitly, since the library as a whole may be built for
+ * processors without it; they're only called once the processor is known to support it.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include "Kernels.h"
+
+#include <emmintrin.h>
+
+using namespace gui::gfx::pixels;
+
+#define SSE2 __attribute__((target("sse2")))
+
+/**
+ * Composites four source pixels over four destination pixels.
+ *
+ * The pixels are unpacked to 16 bits per component, each destination component is multiplied by
+ * the inverse source alpha and divided by 255 (with the same rounding as the scalar version) and
+ * the result is packed back together, and added to the source with saturation.
+ */
+SSE2 static inline __m128i Blend4(const __m128i d, const __m128i s) {
+    const auto zero = _mm_setzero_si128();
+    const auto k255 = _mm_set1_epi16(255);
+    const auto k128 = _mm_set1_epi16(128);
+
+    // broadcast inverse alpha of each pixel to all of its components
+    auto aLo = _mm_unpacklo_epi8(s, zero);
+    auto aHi = _mm_unpackhi_epi8(s, zero);
+    aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(aLo, 0xFF), 0xFF);
+    aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(aHi, 0xFF), 0xFF);
+    aLo = _mm_sub_epi16(k255, aLo);
+    aHi = _mm_sub_epi16(k255, aHi);
+
+    // scale the destination
+    auto lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), aLo), k128);
+    auto hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), aHi), k128);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    // then add the source
+    return _mm_adds_epu8(_mm_packus_epi16(lo, hi), s);
+}
+
+SSE2 static void BlendOver(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto zero = _mm_setzero_si128();
+    const auto alphaMask = _mm_set1_epi32(0xFF000000);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        // all pixels fully transparent: nothing to do
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) continue;
+
+        auto out = reinterpret_cast<__m128i *>(dst + i);
+
+        // all pixels fully opaque: replace destination
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask)) == 0xFFFF) {
+            _mm_storeu_si128(out, s);
+            continue;
+        }
+
+        _mm_storeu_si128(out, Blend4(_mm_loadu_si128(out), s));
+    }
+
+    for(; i < count; i++) {
+        dst[i] = impl::BlendPixel(dst[i], src[i]);
+    }
+}
+
+SSE2 static void Fill(uint32_t *dst, const uint32_t color, const size_t count) {
+    const auto c = _mm_set1_epi32(color);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), c);
+    }
+    for(; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+SSE2 static void Argb32ToRgb30(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto rMask = _mm_set1_epi32(0xFF0000), rTop = _mm_set1_epi32(0xC00000);
+    const auto gMask = _mm_set1_epi32(0x00FF00), gTop = _mm_set1_epi32(0x00C000);
+    const auto bMask = _mm_set1_epi32(0x0000FF), bTop = _mm_set1_epi32(0x0000C0);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const auto p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        auto r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, rMask), 6),
+                _mm_srli_epi32(_mm_and_si128(p, rTop), 2));
+        auto g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, gMask), 4),
+                _mm_srli_epi32(_mm_and_si128(p, gTop), 4));
+        auto b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, bMask), 2),
+                _mm_srli_epi32(_mm_and_si128(p, bTop), 6));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(_mm_or_si128(r, g), b));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb30(src[i]);
+    }
+}
+
+SSE2 static void Rgb30ToArgb32(uint32_t *dst, const uint32_t *src, const size_t count) {
+    const auto alpha = _mm_set1_epi32(0xFF000000);
+    const auto rMask = _mm_set1_epi32(0xFF0000);
+    const auto gMask = _mm_set1_epi32(0x00FF00);
+    const auto bMask = _mm_set1_epi32(0x0000FF);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const auto p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        auto r = _mm_and_si128(_mm_srli_epi32(p, 6), rMask);
+        auto g = _mm_and_si128(_mm_srli_epi32(p, 4), gMask);
+        auto b = _mm_and_si128(_mm_srli_epi32(p, 2), bMask);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                _mm_or_si128(_mm_or_si128(alpha, r), _mm_or_si128(g, b)));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelRgb30ToArgb32(src[i]);
+    }
+}
+
+/**
+ * Converts four ARGB32 pixels to RGB565; the results are in the low 16 bits of each 32-bit lane.
+ */
+SSE2 static inline __m128i Argb32ToRgb565x4(const __m128i p) {
+    const auto r = _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xF800));
+    const auto g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0));
+    const auto b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001F));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+/**
+ * SSE2 can only pack 32-bit values to 16 bits with signed saturation, so the values are biased
+ * into the signed range before packing, and the bias is removed afterwards.
+ */
+SSE2 static void Argb32ToRgb565(uint16_t *dst, const uint32_t *src, const size_t count) {
+    const auto bias32 = _mm_set1_epi32(0x8000);
+    const auto bias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const auto p2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4));
+
+        const auto lo = _mm_sub_epi32(Argb32ToRgb565x4(p1), bias32);
+        const auto hi = _mm_sub_epi32(Argb32ToRgb565x4(p2), bias32);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                _mm_add_epi16(_mm_packs_epi32(lo, hi), bias16));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelArgb32ToRgb565(src[i]);
+    }
+}
+
+/**
+ * Converts four RGB565 pixels (zero extended to 32 bits) to ARGB32.
+ */
+SSE2 static inline __m128i Rgb565ToArgb32x4(const __m128i p) {
+    auto r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 8),
+            _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xE000)), 3));
+    auto g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x07E0)), 5),
+            _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x0600)), 1));
+    auto b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x001F)), 3),
+            _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x001C)), 2));
+
+    return _mm_or_si128(_mm_or_si128(_mm_set1_epi32(0xFF000000), r), _mm_or_si128(g, b));
+}
+
+SSE2 static void Rgb565ToArgb32(uint32_t *dst, const uint16_t *src, const size_t count) {
+    const auto zero = _mm_setzero_si128();
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const auto p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                Rgb565ToArgb32x4(_mm_unpacklo_epi16(p, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4),
+                Rgb565ToArgb32x4(_mm_unpackhi_epi16(p, zero)));
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::PixelRgb565ToArgb32(src[i]);
+    }
+}
+
+/**
+ * Without a byte shuffle instruction, the byte swap is done by first exchanging the two 16-bit
+ * halves of each pixel, then the two bytes in each half.
+ */
+SSE2 static void SwapBgra(uint32_t *dst, const uint32_t *src, const size_t count) {
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        auto p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        p = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xB1), 0xB1);
+        p = _mm_or_si128(_mm_slli_epi16(p, 8), _mm_srli_epi16(p, 8));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), p);
+    }
+    for(; i < count; i++) {
+        dst[i] = impl::SwapPixel(src[i]);
+    }
+}
+
+const impl::Kernels impl::gSse2Kernels{
+    .name               = "sse2",
+    .blendOver          = BlendOver,
+    .fill               = Fill,
+    .argb32ToRgb30      = Argb32ToRgb30,
+    .rgb30ToArgb32      = Rgb30ToArgb32,
+    .argb32ToRgb565     = Argb32ToRgb565,
+    .rgb565ToArgb32     = Rgb565ToArgb32,
+    .swapBgra           = SwapBgra,
+};
+#endif
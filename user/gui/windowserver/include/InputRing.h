@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Input events are delivered from input drivers to the window server through a ring buffer in a
+ * shared memory region, rather than one RPC message per event. Each ring has exactly one producer
+ * (the driver) and one consumer (the window server's input thread.)
+ *
+ * The producer only needs to notify the consumer when the ring goes from empty to non-empty; as
+ * long as the consumer hasn't caught up, it will pick up newly written events on its own.
+ *
+ * A ring is set up by the driver calling the `OpenInputRing` RPC, and then mapping the returned
+ * virtual memory region. The region starts with an `InputRing::Header`, which is initialized by
+ * the window server, followed by the event slots.
+ */
+namespace InputRing {
+/// Value of the magic field in an initialized ring ('INPR')
+constexpr static const uint32_t kMagic{0x52504E49};
+/// Current version of the ring layout
+constexpr static const uint32_t kVersion{1};
+
+/**
+ * Types of input events
+ */
+enum class EventType: uint32_t {
+    /// A key was pressed or released
+    Key                                 = 1,
+    /// The mouse moved, or its buttons changed state
+    Mouse                               = 2,
+};
+
+/**
+ * A single input event as stored in the ring.
+ */
+struct Event {
+    /// System uptime when the event was generated, in nanoseconds
+    uint64_t timestamp{0};
+    /// Type of event; this determines which of the members in the union below is valid
+    EventType type;
+
+    union {
+        /// Keyboard event
+        struct {
+            /// Key, as a value in the window server's scancode set
+            uint32_t scancode;
+            /// Whether the key was released
+            uint32_t release;
+        } key;
+
+        /// Mouse event (relative motion)
+        struct {
+            /// Bitmask of mouse buttons that are pressed
+            uint32_t buttons;
+            int32_t dX, dY, dZ;
+        } mouse;
+    };
+} __attribute__((aligned(32)));
+static_assert(sizeof(Event) == 32, "Invalid input event size");
+
+/**
+ * Header at the start of the ring's shared memory region. The read and write indices increase
+ * monotonically (wrapping around at 2^32) and are reduced modulo the capacity to get a slot.
+ *
+ * Each index is only ever written by one side, and they're placed in separate cache lines so the
+ * producer and consumer don't contend on them.
+ */
+struct Header {
+    /// Magic value, `kMagic`
+    uint32_t magic;
+    /// Layout version, `kVersion`
+    uint32_t version;
+    /// Number of event slots; always a power of two
+    uint32_t capacity;
+    /// Offset from the start of the region to the first event slot, in bytes
+    uint32_t eventsOffset;
+
+    /// Handle of the thread to notify when the ring becomes non-empty
+    uint64_t notifyThread;
+    /// Notification bits to send to that thread
+    uint64_t notifyBits;
+
+    /// Index of the next slot the producer will write
+    alignas(64) std::atomic_uint32_t writeIndex;
+    /// Number of events the producer had to drop because the ring was full
+    std::atomic_uint32_t dropped;
+
+    /// Index of the next slot the consumer will read
+    alignas(64) std::atomic_uint32_t readIndex;
+};
+static_assert(std::atomic_uint32_t::is_always_lock_free, "Ring indices must be lock free");
+
+/**
+ * Gets the event slot array of a ring.
+ */
+inline Event *GetEvents(Header *hdr) {
+    return reinterpret_cast<Event *>(reinterpret_cast<std::byte *>(hdr) + hdr->eventsOffset);
+}
+
+/**
+ * Writes an event into the ring.
+ *
+ * After publishing the event, we check whether the consumer had already read everything before
+ * it; if so, it may be going to sleep, and has to be notified. The full fence pairs with the one
+ * in `Drain()` so that at least one side always observes the other's update.
+ *
+ * @param outNotify Set if the consumer must be notified
+ *
+ * @return Whether the event was written; if the ring is full, it's not.
+ */
+inline bool Push(Header *hdr, const Event &event, bool &outNotify) {
+    const auto write = hdr->writeIndex.load(std::memory_order_relaxed);
+    const auto read = hdr->readIndex.load(std::memory_order_acquire);
+
+    if(write - read >= hdr->capacity) {
+        return false;
+    }
+
+    GetEvents(hdr)[write & (hdr->capacity - 1)] = event;
+    hdr->writeIndex.store(write + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    outNotify = (hdr->readIndex.load(std::memory_order_relaxed) == write);
+    return true;
+}
+
+/**
+ * Reads all events available in the ring, invoking the given callback for each of them, until
+ * the ring is empty.
+ *
+ * The header is writable by the producer, so the consumer can't trust anything in it besides the
+ * write index. Instead, it keeps its own copies of the ring's geometry and read index, and passes
+ * them in here. Each event is copied out of the ring before it's handed to the callback.
+ *
+ * @param events Event slot array, as computed by the consumer
+ * @param capacity Number of event slots in the ring; a power of two
+ * @param readIndex Consumer's copy of the read index; updated as events are read
+ * @param outTotal Total number of events read
+ *
+ * @return Whether the ring is consistent; if the producer advanced the write index further than
+ *         is possible, no further events are read and false is returned.
+ */
+template<typename F>
+inline bool Drain(Header *hdr, const Event *events, const uint32_t capacity, uint32_t &readIndex,
+        F &&callback, size_t &outTotal) {
+    outTotal = 0;
+    auto read = readIndex;
+
+    while(true) {
+        const auto write = hdr->writeIndex.load(std::memory_order_acquire);
+        if(read == write) break;
+        if(write - read > capacity) return false;
+
+        for(; read != write; read++, outTotal++) {
+            const Event event = events[read & (capacity - 1)];
+            callback(event);
+        }
+
+        // release the slots, then check again whether the producer added more in the meantime
+        readIndex = read;
+        hdr->readIndex.store(read, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    return true;
+}
+}
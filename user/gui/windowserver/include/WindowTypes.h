@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Flags that may be specified when creating a window.
+ */
+enum WindowFlags: uint32_t {
+    /**
+     * The window's contents are fully opaque; the alpha channel of its surface is ignored.
+     *
+     * The window server can skip compositing anything underneath opaque windows, so clients should
+     * set this flag whenever possible.
+     */
+    kWindowOpaque                       = (1 << 0),
+};
+
+/**
+ * Describes a rectangular region of a window's surface that has been drawn to. An array of these
+ * is sent to the window server in a `DamageWindow` call.
+ */
+struct WindowDamageRect {
+    int32_t x{0};
+    int32_t y{0};
+    uint32_t w{0};
+    uint32_t h{0};
+} __attribute__((packed));
@@ -1,18 +1,30 @@
 #include "Compositor.h"
 #include "CursorHandler.h"
+#include "Window.h"
 
 #include "Log.h"
 #include "gfx/Types.h"
 
+#include <WindowTypes.h>
+
 #include <DriverSupport/gfx/Display.h>
+#include <DriverSupport/gfx/Types.h>
 
 #ifdef __Kush__
+#include <sys/syscalls.h>
 #include <threads.h>
+#include <time.h>
 #endif
 
 #include <gfx/Context.h>
 #include <gfx/Surface.h>
 #include <gfx/Pattern.h>
+#include <gfx/Pixels.h>
+
+#include <algorithm>
+
+/// Color painted in areas of the screen not covered by any opaque window (ARGB32, premultiplied)
+constexpr static const uint32_t kBackgroundPixel{0xFF330000};
 
 /**
  * Instantiates a compositor instance for the given display.
@@ -53,15 +65,8 @@ void Compositor::updateBuffer() {
 
     this->context = std::make_unique<gui::gfx::Context>(this->surface);
 
-    // clear it
-    this->context->setSource(gui::gfx::RgbColor{0, 0, 0});
-    this->context->paint();
-
+    // then redraw (and update) the entire screen
     this->draw(kDrawEverything);
-
-    // and mark it as updated
-    this->surface->flush();
-    this->display->RegionUpdated({0, 0}, this->bufferDimensions);
 }
 
 
@@ -70,9 +75,13 @@ void Compositor::updateBuffer() {
 /**
  * Main loop for the worker thread. We'll wait to receive notifications forever and redraw the
  * display in response to them.
+ *
+ * Every so often, we also check for (and destroy) windows whose owning task has exited.
  */
 void Compositor::workerMain() {
     uintptr_t note;
+    uint64_t nextReap{0};
+    struct timespec ts;
 
     // set up buffer initially
     this->updateBuffer();
@@ -82,6 +91,18 @@ void Compositor::workerMain() {
         bool needsDraw{false};
         uintptr_t drawWhat{0};
 
+        // destroy windows of exited clients
+        if(!clock_gettime(CLOCK_UPTIME_RAW, &ts)) {
+            const uint64_t now = (ts.tv_sec * 1'000'000'000ULL) + ts.tv_nsec;
+            if(now >= nextReap) {
+                if(this->reapWindows()) {
+                    needsDraw = true;
+                    drawWhat |= kWindowsUpdateBit;
+                }
+                nextReap = now + kReapInterval;
+            }
+        }
+
         // receive notifications
         note = NotificationReceive(UINTPTR_MAX, 16666);
         if(!note) {
@@ -109,6 +130,10 @@ void Compositor::workerMain() {
             needsDraw = true;
             drawWhat |= kCursorUpdateBit;
         }
+        if(note & kWindowsUpdateBit) {
+            needsDraw = true;
+            drawWhat |= kWindowsUpdateBit;
+        }
 
 draw:;
         // perform the drawing if needed
@@ -121,6 +146,40 @@ draw:;
     this->context.reset();
     this->surface.reset();
 }
+
+/**
+ * Destroys all windows whose owner has exited. Once a task is destroyed, its handle becomes
+ * invalid, so any query against it fails.
+ *
+ * @return Whether any of the destroyed windows were visible
+ */
+bool Compositor::reapWindows() {
+    bool redraw{false};
+    TaskVmInfo_t info;
+    std::unordered_map<uintptr_t, bool> alive;
+
+    std::lock_guard<std::mutex> lg(this->windowsLock);
+
+    std::erase_if(this->windows, [&](const auto &window) {
+        const auto owner = window->getOwner();
+        if(!alive.contains(owner)) {
+            alive.emplace(owner, !VirtualGetTaskInfo(owner, &info, sizeof(info)));
+        }
+        if(alive.at(owner)) return false;
+
+        Trace("Destroying window %u of exited task $%p'h", window->getId(), owner);
+
+        if(window->isVisible()) {
+            this->screenDamage.add(window->getFrame());
+            redraw = true;
+        }
+
+        this->windowIds.erase(window->getId());
+        return true;
+    });
+
+    return redraw;
+}
 #endif
 
 /**
@@ -145,72 +204,337 @@ void Compositor::notifyWorker(const uintptr_t bits) {
 /**
  * Redraws the output display and updates the framebuffer.
  *
- * We try to be smart about this and only update the regions of the display that actually changed;
- * for example, when the cursor moves, we only redraw the part of the display where the old cursor
- * was, and then draw the new cursor on top; this is done via clever use of clip rects.
+ * We try to be smart about this and only update the regions of the display that actually changed.
+ * All damage (from windows, screen areas exposed by moving windows, and the previous position of
+ * the cursor) is collected into a single region, which is clipped to the screen and reduced to a
+ * small number of rectangles. Only those rectangles are composited, and the display is then
+ * informed of all of them in one batched update.
  */
 void Compositor::draw(const uintptr_t what) {
-    std::vector<gui::gfx::Rectangle> dirtyRects;
+    int err;
+    Region damage;
+
+    const auto [width, height] = this->bufferDimensions;
+    const Region::Rect screen{0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height)};
 
-    // redraw windows
+    // the entire screen or the cursor's last position needs redrawing
     if(what & kUpdateBufferBit) {
-        this->drawWindows();
+        damage.add(screen);
     }
-
-    // add a clipping rect for the last cursor position if it changed
     if(what & kCursorUpdateBit) {
-        auto rect = this->cursor->getCursorRect();
-        if(!rect.isEmpty()) {
-            // truncate rect to positive coordinates only
-            if(rect.origin.x < 0) {
-                rect.size.width += rect.origin.x;
-                rect.origin.x = 0;
-            }
-            if(rect.origin.y < 0) {
-                rect.size.height += rect.origin.y;
-                rect.origin.y = 0;
+        damage.add(Region::Rect::From(this->cursor->getCursorRect()));
+    }
+
+    // collect damage and composite windows
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+
+        damage.add(this->screenDamage);
+        this->screenDamage.clear();
+
+        for(auto &window : this->windows) {
+            if(window->isVisible()) {
+                window->takeDamage(damage);
+            } else {
+                window->clearDamage();
             }
+        }
+
+        damage.intersect(screen);
+        damage.simplify(kMaxDamageRects);
+
+        if(!damage.isEmpty()) {
+            this->drawWindows(damage);
+        }
+    }
+
+    // draw the cursor if it moved or was drawn over
+    std::vector<gui::gfx::Rectangle> cursorRects;
+
+    if((what & kCursorUpdateBit) ||
+            damage.intersects(Region::Rect::From(this->cursor->getCursorRect()))) {
+        this->cursor->draw(this->context, cursorRects);
+    }
+
+    if(damage.isEmpty() && cursorRects.empty()) return;
+
+    for(const auto &rect : cursorRects) {
+        damage.add(Region::Rect::From(rect));
+    }
+    damage.intersect(screen);
+    damage.coalesce();
+
+    if(kLogDamage) Trace("Frame damage: %lu rect(s), %lu pixels", damage.getRects().size(),
+            damage.area());
+
+    // update all dirty rects at once
+    this->surface->flush();
+
+    std::vector<DriverSupport::gfx::UpdateRect> updates;
+    updates.reserve(damage.getRects().size());
+
+    for(const auto &rect : damage) {
+        updates.push_back({rect.x, rect.y, static_cast<uint32_t>(rect.w),
+                static_cast<uint32_t>(rect.h)});
+    }
+
+    err = this->display->RegionsUpdated(updates);
+    if(err) {
+        Warn("%s failed: %d", "Display::RegionsUpdated", err);
+    }
+}
+
+/**
+ * Composites all application windows in the given region of the screen.
+ *
+ * We first walk the windows front to back to determine which part of the region each window is
+ * visible in. Opaque windows hide everything beneath them, so the area they cover is removed from
+ * the region considered for any windows further back. Whatever is left afterwards is filled with
+ * the background, and the visible parts of windows are then drawn back to front.
+ *
+ * Window contents are composited straight into the framebuffer with the pixel routines from
+ * libgfx, rather than through cairo, since we only ever need to copy or blend pixel rectangles.
+ *
+ * @note The caller must hold the windows lock.
+ */
+void Compositor::drawWindows(const Region &region) {
+    // figure out which parts of each window are visible
+    Region remaining(region);
+    std::vector<std::pair<const Window *, Region>> visible;
+
+    for(auto it = this->windows.rbegin(); it != this->windows.rend(); ++it) {
+        const auto &window = *it;
+        if(remaining.isEmpty()) break;
+        if(!window->isVisible()) continue;
+
+        auto exposed = remaining.intersected(window->getFrame());
+        if(exposed.isEmpty()) continue;
 
-            // then set up the clipping rectangle
-            this->context->pushState();
+        if(window->isOpaque()) {
+            remaining.subtract(window->getFrame());
+        }
+        visible.emplace_back(window.get(), std::move(exposed));
+    }
+
+    // ensure cairo's drawing has landed in the framebuffer before writing to it directly
+    this->surface->flush();
+
+    auto fb = reinterpret_cast<std::byte *>(this->surface->data());
+    const auto fbPitch = this->surface->getPitch();
+
+    // fill the background wherever no opaque window covers it
+    for(const auto &rect : remaining) {
+        gui::gfx::pixels::FillRect(fb + (rect.y * fbPitch) + (rect.x * 4), fbPitch,
+                kBackgroundPixel, rect.w, rect.h);
+    }
+
+    // then composite the windows straight out of their shared surfaces
+    for(auto it = visible.rbegin(); it != visible.rend(); ++it) {
+        const auto &[window, exposed] = *it;
+        const auto &frame = window->getFrame();
 
-            this->context->clipReset();
-            this->context->rectangle(rect);
-            this->context->clip();
+        const auto srcPitch = window->getPitch();
+        auto src = reinterpret_cast<const std::byte *>(window->getSurface()->data());
 
-            // and draw the windows in it
-            this->drawWindows();
-            this->context->popState();
+        for(const auto &rect : exposed) {
+            auto dstPtr = fb + (rect.y * fbPitch) + (rect.x * 4);
+            auto srcPtr = src + ((rect.y - frame.y) * srcPitch) + ((rect.x - frame.x) * 4);
 
-            // mark it as dirty
-            dirtyRects.emplace_back(std::move(rect));
+            if(window->isOpaque()) {
+                gui::gfx::pixels::CopyRect(dstPtr, fbPitch, srcPtr, srcPitch, rect.w, rect.h);
+            } else {
+                gui::gfx::pixels::BlendOverRect(dstPtr, fbPitch, srcPtr, srcPitch, rect.w, rect.h);
+            }
         }
     }
 
-    // draw cursor
-    this->cursor->draw(this->context, dirtyRects);
+    // let cairo know which parts of the framebuffer changed under it
+    for(const auto &rect : region) {
+        this->surface->markDirty(gui::gfx::Point(rect.x, rect.y), gui::gfx::Size(rect.w, rect.h));
+    }
+}
+
 
-    // update the dirty rects
-    for(const auto &rect : dirtyRects) {
-        this->display->RegionUpdated(rect.origin, rect.size);
+
+/**
+ * Creates a new window. It's allocated with a shared memory surface of the given size, and is
+ * placed in front of all other windows, but it's not visible until explicitly shown.
+ *
+ * @param owner Handle of the task that requested the window
+ * @param width Width of the window, in pixels
+ * @param height Height of the window, in pixels
+ * @param flags Window flags, as defined in the `WindowFlags` enum
+ * @param outWindow On success, the newly created window
+ *
+ * @return 0 on success or an error code
+ */
+int Compositor::createWindow(const uintptr_t owner, const uint32_t width, const uint32_t height,
+        const uint32_t flags, std::shared_ptr<Window> &outWindow) {
+    int err;
+    std::shared_ptr<Window> window;
+
+    if(!width || !height || width > kMaxWindowDimension || height > kMaxWindowDimension) {
+        return Errors::InvalidWindowSize;
     }
+
+    std::lock_guard<std::mutex> lg(this->windowsLock);
+
+    err = Window::Alloc(this->nextWindowId, owner, width, height, flags, window);
+    if(err) return err;
+    this->nextWindowId++;
+
+    this->windows.push_back(window);
+    this->windowIds.emplace(window->getId(), window);
+
+    outWindow = window;
+    return 0;
 }
 
 /**
- * Draws all application windows.
+ * Looks up the window with the given id.
  *
- * You should have the clipping rects for the context configured appropriately to redraw only the
- * parts of the screen that are desired.
+ * @note The caller must hold the windows lock.
+ *
+ * @return 0 on success, or an error code if there's no such window or it belongs to another task
  */
-void Compositor::drawWindows() {
-    // set up state
-    this->context->pushState();
-    this->context->setSource(gui::gfx::RgbColor{0.2, 0, 0});
+int Compositor::getWindow(const uintptr_t owner, const uint32_t id,
+        std::shared_ptr<Window> &outWindow) {
+    auto it = this->windowIds.find(id);
+    if(it == this->windowIds.end()) {
+        return Errors::InvalidWindow;
+    } else if(it->second->getOwner() != owner) {
+        return Errors::NotWindowOwner;
+    }
 
-    this->context->paint();
+    outWindow = it->second;
+    return 0;
+}
+
+/**
+ * Destroys the window with the given id. If it was visible, the area it covered is redrawn.
+ */
+int Compositor::destroyWindow(const uintptr_t owner, const uint32_t id) {
+    int err;
+    bool redraw{false};
+    std::shared_ptr<Window> window;
+
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+        err = this->getWindow(owner, id, window);
+        if(err) return err;
+
+        if(window->isVisible()) {
+            this->screenDamage.add(window->getFrame());
+            redraw = true;
+        }
+
+        std::erase(this->windows, window);
+        this->windowIds.erase(id);
+    }
+
+    if(redraw) this->notifyWorker(kWindowsUpdateBit);
+    return 0;
+}
+
+/**
+ * Moves a window on screen; both the area it covered previously and its new location are redrawn.
+ */
+int Compositor::setWindowPosition(const uintptr_t owner, const uint32_t id, const int32_t x,
+        const int32_t y) {
+    int err;
+    bool redraw{false};
+    std::shared_ptr<Window> window;
+
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+        err = this->getWindow(owner, id, window);
+        if(err) return err;
+        if(window->isVisible()) {
+            this->screenDamage.add(window->getFrame());
+            redraw = true;
+        }
+
+        window->setPosition(x, y);
+
+        if(window->isVisible()) {
+            this->screenDamage.add(window->getFrame());
+        }
+    }
+
+    if(redraw) this->notifyWorker(kWindowsUpdateBit);
+    return 0;
+}
+
+/**
+ * Shows or hides a window, redrawing the area it covers if its visibility changed.
+ */
+int Compositor::setWindowVisible(const uintptr_t owner, const uint32_t id, const bool visible) {
+    int err;
+    bool redraw{false};
+    std::shared_ptr<Window> window;
+
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+        err = this->getWindow(owner, id, window);
+        if(err) return err;
+        if(window->isVisible() != visible) {
+            window->setVisible(visible);
+            this->screenDamage.add(window->getFrame());
+            redraw = true;
+        }
+    }
+
+    if(redraw) this->notifyWorker(kWindowsUpdateBit);
+    return 0;
+}
+
+/**
+ * Moves a window in front of all other windows.
+ */
+int Compositor::raiseWindow(const uintptr_t owner, const uint32_t id) {
+    int err;
+    bool redraw{false};
+    std::shared_ptr<Window> window;
+
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+        err = this->getWindow(owner, id, window);
+        if(err) return err;
+        if(this->windows.back() == window) return 0;
+
+        std::erase(this->windows, window);
+        this->windows.push_back(window);
+
+        if(window->isVisible()) {
+            this->screenDamage.add(window->getFrame());
+            redraw = true;
+        }
+    }
+
+    if(redraw) this->notifyWorker(kWindowsUpdateBit);
+    return 0;
+}
+
+/**
+ * Records that the client drew into the given regions of the window's surface. They'll be
+ * composited the next time the display is redrawn.
+ */
+int Compositor::damageWindow(const uintptr_t owner, const uint32_t id,
+        const std::span<const WindowDamageRect> &rects) {
+    int err;
+    bool redraw{false};
+    std::shared_ptr<Window> window;
+
+    {
+        std::lock_guard<std::mutex> lg(this->windowsLock);
+        err = this->getWindow(owner, id, window);
+        if(err) return err;
+        window->addDamage(rects);
+        redraw = window->isVisible();
+    }
 
-    // restore state
-    this->context->popState();
+    if(redraw) this->notifyWorker(kWindowsUpdateBit);
+    return 0;
 }
 
 
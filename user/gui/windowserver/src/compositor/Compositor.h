@@ -4,12 +4,19 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 #include <tuple>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 
+#include "Region.h"
+
 class CursorHandler;
+class Window;
+struct WindowDamageRect;
 
 namespace DriverSupport::gfx {
 class Display;
@@ -24,6 +31,15 @@ class Surface;
  * The compositor handles drawing windows on an internal back buffer, which is copied to the output
  * framebuffer as regions of it are dirtied.
  *
+ * Drawing is driven entirely by damage: windows accumulate damage as their clients draw into them,
+ * and moving, showing or hiding windows damages the screen areas they cover. Once per frame, all
+ * damage is merged into a small set of rectangles, only those rectangles are composited, and the
+ * display is informed of all of them in a single batched update.
+ *
+ * Windows are manipulated on behalf of the client task that created them; requests from any other
+ * task are rejected. The worker thread periodically checks whether the owners of windows are still
+ * alive, and destroys the windows of any that have exited.
+ *
  * @note Currently, we only support 32bpp back buffers.
  */
 class Compositor {
@@ -31,10 +47,23 @@ class Compositor {
 
     constexpr static const uintptr_t kUpdateBufferBit{1 << 0};
     constexpr static const uintptr_t kCursorUpdateBit{1 << 1};
+    constexpr static const uintptr_t kWindowsUpdateBit{1 << 2};
     constexpr static const uintptr_t kShutdownBit{1 << 16};
 
     constexpr static const uintptr_t kDrawEverything{kCursorUpdateBit | kUpdateBufferBit};
 
+    public:
+        enum Errors: int {
+            /// The window id is not valid
+            InvalidWindow                       = -95000,
+            /// The requested window size is not supported
+            InvalidWindowSize                   = -95001,
+            /// The window belongs to a different client
+            NotWindowOwner                      = -95002,
+            /// There is no address space left to map the window's surface
+            NoSurfaceAddressSpace               = -95003,
+        };
+
     public:
         /// Create a compositor instance for the given display
         Compositor(const std::shared_ptr<DriverSupport::gfx::Display> &display);
@@ -46,6 +75,23 @@ class Compositor {
         /// Handles a keyboard event
         void handleKeyEvent(const uint32_t scancode, const bool release);
 
+        /// Creates a new (hidden) window of the given size, owned by the given task.
+        [[nodiscard]] int createWindow(const uintptr_t owner, const uint32_t width,
+                const uint32_t height, const uint32_t flags, std::shared_ptr<Window> &outWindow);
+        /// Destroys the window with the given id.
+        [[nodiscard]] int destroyWindow(const uintptr_t owner, const uint32_t id);
+        /// Moves a window to the given position on screen.
+        [[nodiscard]] int setWindowPosition(const uintptr_t owner, const uint32_t id,
+                const int32_t x, const int32_t y);
+        /// Shows or hides a window.
+        [[nodiscard]] int setWindowVisible(const uintptr_t owner, const uint32_t id,
+                const bool visible);
+        /// Moves a window in front of all other windows.
+        [[nodiscard]] int raiseWindow(const uintptr_t owner, const uint32_t id);
+        /// Marks regions of a window's surface as having been drawn to.
+        [[nodiscard]] int damageWindow(const uintptr_t owner, const uint32_t id,
+                const std::span<const WindowDamageRect> &rects);
+
     private:
         /// Resizes the buffer in response to the display size changing
         void updateBuffer();
@@ -57,10 +103,25 @@ class Compositor {
 
         /// Redraws the parts of the display that have changed
         void draw(const uintptr_t what);
-        /// Redraws windows under the current clip region
-        void drawWindows();
+        /// Composites all windows in the given region of the screen
+        void drawWindows(const Region &region);
+
+        /// Looks up a window, ensuring it belongs to the given task.
+        [[nodiscard]] int getWindow(const uintptr_t owner, const uint32_t id,
+                std::shared_ptr<Window> &outWindow);
+        /// Destroys all windows whose owning task has exited.
+        bool reapWindows();
 
     private:
+        /// Maximum number of rectangles damage is reduced to per frame
+        constexpr static const size_t kMaxDamageRects{16};
+        /// Maximum width or height of a window, in pixels
+        constexpr static const uint32_t kMaxWindowDimension{16384};
+        /// Whether per frame damage is logged
+        constexpr static const bool kLogDamage{false};
+        /// Interval between checks for windows whose owner exited, in nanoseconds
+        constexpr static const uint64_t kReapInterval{1'000'000'000ULL};
+
         /// Display for which we're responsible
         std::shared_ptr<DriverSupport::gfx::Display> display;
 
@@ -75,6 +136,17 @@ class Compositor {
         /// cursor drawing
         std::unique_ptr<CursorHandler> cursor;
 
+        /// Lock protecting the window list and screen damage
+        std::mutex windowsLock;
+        /// All windows, ordered back to front
+        std::vector<std::shared_ptr<Window>> windows;
+        /// Windows by their id
+        std::unordered_map<uint32_t, std::shared_ptr<Window>> windowIds;
+        /// Id to assign to the next window
+        uint32_t nextWindowId{1};
+        /// Screen areas exposed or covered since the last frame (e.g. by moving windows)
+        Region screenDamage;
+
         /// render thread
         std::unique_ptr<std::thread> worker;
         /// whether the render thread shall execute
@@ -0,0 +1,208 @@
+#include "Region.h"
+
+#include <cstdint>
+
+/**
+ * Adds a rectangle to the region.
+ *
+ * Any existing rectangles that are entirely covered by the new rectangle are removed; then, only
+ * the parts of the new rectangle not already covered by the region are added. This ensures the
+ * rectangles never overlap.
+ */
+void Region::add(const Rect &r) {
+    if(r.isEmpty()) return;
+
+    // drop all rects the new one covers
+    std::erase_if(this->rects, [&](const auto &e) {
+        return r.contains(e);
+    });
+
+    // cut the parts of the rect that are already in the region away
+    std::vector<Rect> pieces{r}, next;
+
+    for(const auto &existing : this->rects) {
+        if(!existing.intersects(r)) continue;
+
+        next.clear();
+        for(const auto &piece : pieces) {
+            Subtract(piece, existing, next);
+        }
+        std::swap(pieces, next);
+
+        // the rect was already entirely covered
+        if(pieces.empty()) return;
+    }
+
+    this->rects.insert(this->rects.end(), pieces.begin(), pieces.end());
+}
+
+/**
+ * Removes the area covered by the given rectangle from the region.
+ */
+void Region::subtract(const Rect &r) {
+    if(r.isEmpty() || this->rects.empty()) return;
+
+    std::vector<Rect> out;
+    out.reserve(this->rects.size());
+
+    for(const auto &existing : this->rects) {
+        Subtract(existing, r, out);
+    }
+
+    this->rects = std::move(out);
+}
+
+/**
+ * Clips all rectangles in the region against the given rectangle, removing any that lie entirely
+ * outside of it.
+ */
+void Region::intersect(const Rect &r) {
+    for(auto &existing : this->rects) {
+        existing = existing.intersection(r);
+    }
+
+    std::erase_if(this->rects, [](const auto &e) {
+        return e.isEmpty();
+    });
+}
+
+/**
+ * Merges rectangles that are directly adjacent and share an entire edge; that is, two rectangles
+ * of the same width stacked on top of each other, or of the same height next to each other.
+ *
+ * The merged rectangle covers exactly the same area as the two it replaces, so this never grows
+ * the region.
+ */
+void Region::coalesce() {
+    bool merged{true};
+
+    while(merged) {
+        merged = false;
+
+        for(size_t i = 0; i < this->rects.size(); i++) {
+            for(size_t j = i + 1; j < this->rects.size(); j++) {
+                auto &a = this->rects[i];
+                const auto &b = this->rects[j];
+
+                const bool vertical = (a.x == b.x && a.w == b.w) &&
+                    (a.bottom() == b.y || b.bottom() == a.y);
+                const bool horizontal = (a.y == b.y && a.h == b.h) &&
+                    (a.right() == b.x || b.right() == a.x);
+
+                if(vertical || horizontal) {
+                    a = a.bounding(b);
+                    this->rects.erase(this->rects.begin() + j);
+                    merged = true;
+                    j--;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Reduces the number of rectangles in the region.
+ *
+ * After coalescing exactly adjacent rectangles, we repeatedly replace the pair of rectangles whose
+ * bounding box adds the least extra area by that bounding box. Each rectangle in the region costs
+ * a draw call and a display update, so it's usually cheaper to redraw a few extra pixels than to
+ * handle lots of small rectangles.
+ *
+ * @param maxRects Maximum number of rectangles the region may contain afterwards
+ */
+void Region::simplify(const size_t maxRects) {
+    this->coalesce();
+
+    while(this->rects.size() > std::max(maxRects, size_t{1})) {
+        // find the pair that wastes the least area when merged
+        size_t bestA{0}, bestB{1};
+        size_t bestWaste{SIZE_MAX};
+
+        for(size_t i = 0; i < this->rects.size(); i++) {
+            for(size_t j = i + 1; j < this->rects.size(); j++) {
+                const auto &a = this->rects[i], &b = this->rects[j];
+                const auto waste = a.bounding(b).area() - a.area() - b.area();
+
+                if(waste < bestWaste) {
+                    bestWaste = waste;
+                    bestA = i;
+                    bestB = j;
+                }
+            }
+        }
+
+        // replace the two rects with their bounding box
+        const auto box = this->rects[bestA].bounding(this->rects[bestB]);
+        const auto before = this->rects.size();
+
+        this->rects.erase(this->rects.begin() + bestB);
+        this->rects.erase(this->rects.begin() + bestA);
+        this->add(box);
+
+        // if the box split other rects such that we didn't make progress, just use the bounds
+        if(this->rects.size() >= before) {
+            const auto all = this->bounds();
+            this->rects.clear();
+            this->rects.push_back(all);
+            break;
+        }
+    }
+}
+
+/**
+ * Returns the total number of pixels covered by the region.
+ */
+size_t Region::area() const {
+    size_t total{0};
+    for(const auto &r : this->rects) {
+        total += r.area();
+    }
+    return total;
+}
+
+/**
+ * Calculates the bounding rectangle of the entire region.
+ */
+Region::Rect Region::bounds() const {
+    Rect out;
+    for(const auto &r : this->rects) {
+        out = out.bounding(r);
+    }
+    return out;
+}
+
+
+
+/**
+ * Subtracts one rectangle from another, and writes the remaining pieces (up to four) to the output
+ * vector. If the rectangles don't overlap, the source rectangle is written unchanged.
+ *
+ * @param from Rectangle to subtract from
+ * @param what Area to remove
+ * @param out Vector to receive the remaining rectangles
+ */
+void Region::Subtract(const Rect &from, const Rect &what, std::vector<Rect> &out) {
+    if(!from.intersects(what)) {
+        out.push_back(from);
+        return;
+    }
+
+    // full width bands above and below
+    if(what.y > from.y) {
+        out.push_back({from.x, from.y, from.w, what.y - from.y});
+    }
+    if(what.bottom() < from.bottom()) {
+        out.push_back({from.x, what.bottom(), from.w, from.bottom() - what.bottom()});
+    }
+
+    // pieces to the left and right, in the band covered by both
+    const auto y1 = std::max(from.y, what.y);
+    const auto y2 = std::min(from.bottom(), what.bottom());
+
+    if(what.x > from.x) {
+        out.push_back({from.x, y1, what.x - from.x, y2 - y1});
+    }
+    if(what.right() < from.right()) {
+        out.push_back({what.right(), y1, from.right() - what.right(), y2 - y1});
+    }
+}
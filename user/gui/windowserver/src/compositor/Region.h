@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gfx/Types.h>
+
+/**
+ * Describes an arbitrary area of the screen as a set of non-overlapping rectangles, with integer
+ * pixel coordinates.
+ *
+ * This is used to track damage: every rectangle added is reduced to only the parts not already
+ * covered by the region, so the same pixel is never composited (or sent to the display) twice in
+ * a single frame.
+ */
+class Region {
+    public:
+        /**
+         * A rectangle with integer pixel coordinates.
+         */
+        struct Rect {
+            int32_t x{0};
+            int32_t y{0};
+            int32_t w{0};
+            int32_t h{0};
+
+            /// Creates the smallest integer rectangle that fully contains the given rectangle.
+            static Rect From(const gui::gfx::Rectangle &r) {
+                const auto x1 = static_cast<int32_t>(std::floor(r.origin.x));
+                const auto y1 = static_cast<int32_t>(std::floor(r.origin.y));
+                const auto x2 = static_cast<int32_t>(std::ceil(r.origin.x + r.size.width));
+                const auto y2 = static_cast<int32_t>(std::ceil(r.origin.y + r.size.height));
+                return {x1, y1, x2 - x1, y2 - y1};
+            }
+
+            /// Converts the rectangle to one usable for drawing.
+            inline gui::gfx::Rectangle toRectangle() const {
+                return {gui::gfx::Point(this->x, this->y), gui::gfx::Size(this->w, this->h)};
+            }
+
+            /// Whether the rectangle has no area
+            constexpr inline bool isEmpty() const {
+                return this->w <= 0 || this->h <= 0;
+            }
+            /// Area of the rectangle, in pixels
+            constexpr inline size_t area() const {
+                return this->isEmpty() ? 0 : static_cast<size_t>(this->w) * this->h;
+            }
+            /// X coordinate one past the right edge
+            constexpr inline int32_t right() const {
+                return this->x + this->w;
+            }
+            /// Y coordinate one past the bottom edge
+            constexpr inline int32_t bottom() const {
+                return this->y + this->h;
+            }
+
+            /// Test whether the two rectangles overlap.
+            constexpr inline bool intersects(const Rect &r) const {
+                return !this->isEmpty() && !r.isEmpty() && this->x < r.right() &&
+                    r.x < this->right() && this->y < r.bottom() && r.y < this->bottom();
+            }
+            /// Test whether the given rectangle lies entirely inside this one.
+            constexpr inline bool contains(const Rect &r) const {
+                return r.x >= this->x && r.y >= this->y && r.right() <= this->right() &&
+                    r.bottom() <= this->bottom();
+            }
+
+            /// Returns the overlapping area of the two rectangles; it may be empty.
+            constexpr inline Rect intersection(const Rect &r) const {
+                const auto x1 = std::max(this->x, r.x), y1 = std::max(this->y, r.y);
+                const auto x2 = std::min(this->right(), r.right());
+                const auto y2 = std::min(this->bottom(), r.bottom());
+                return {x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0)};
+            }
+            /// Returns the smallest rectangle containing both rectangles.
+            constexpr inline Rect bounding(const Rect &r) const {
+                if(this->isEmpty()) return r;
+                else if(r.isEmpty()) return *this;
+
+                const auto x1 = std::min(this->x, r.x), y1 = std::min(this->y, r.y);
+                const auto x2 = std::max(this->right(), r.right());
+                const auto y2 = std::max(this->bottom(), r.bottom());
+                return {x1, y1, x2 - x1, y2 - y1};
+            }
+            /// Returns the rectangle moved by the given offset.
+            constexpr inline Rect translated(const int32_t dx, const int32_t dy) const {
+                return {this->x + dx, this->y + dy, this->w, this->h};
+            }
+
+            constexpr bool operator==(const Rect &) const = default;
+        };
+
+    public:
+        Region() = default;
+        /// Creates a region covering a single rectangle.
+        Region(const Rect &r) {
+            this->add(r);
+        }
+
+        /// Adds the given rectangle to the region.
+        void add(const Rect &r);
+        /// Adds all rectangles of another region to this one.
+        void add(const Region &r) {
+            for(const auto &rect : r.rects) {
+                this->add(rect);
+            }
+        }
+        /// Removes the area covered by the given rectangle from the region.
+        void subtract(const Rect &r);
+        /// Clips the region so it lies entirely inside the given rectangle.
+        void intersect(const Rect &r);
+        /// Returns the part of this region that lies inside the given rectangle.
+        Region intersected(const Rect &r) const {
+            Region out(*this);
+            out.intersect(r);
+            return out;
+        }
+
+        /// Merges adjacent rectangles that share an entire edge.
+        void coalesce();
+        /// Reduces the number of rectangles in the region to at most the given number.
+        void simplify(const size_t maxRects);
+
+        /// Removes all rectangles from the region.
+        inline void clear() {
+            this->rects.clear();
+        }
+        /// Whether the region is empty
+        inline bool isEmpty() const {
+            return this->rects.empty();
+        }
+        /// Whether any part of the region overlaps the given rectangle
+        bool intersects(const Rect &r) const {
+            return std::any_of(this->rects.begin(), this->rects.end(), [&](const auto &e) {
+                return e.intersects(r);
+            });
+        }
+        /// Total area covered by the region, in pixels
+        size_t area() const;
+        /// Smallest rectangle that contains the entire region
+        Rect bounds() const;
+
+        /// Returns all rectangles that make up this region.
+        constexpr inline auto &getRects() const {
+            return this->rects;
+        }
+        inline auto begin() const {
+            return this->rects.begin();
+        }
+        inline auto end() const {
+            return this->rects.end();
+        }
+
+    private:
+        static void Subtract(const Rect &from, const Rect &what, std::vector<Rect> &out);
+
+    private:
+        /// Rectangles making up the region; these never overlap
+        std::vector<Rect> rects;
+};
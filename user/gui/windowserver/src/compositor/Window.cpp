@@ -0,0 +1,220 @@
+#include "Window.h"
+#include "Compositor.h"
+
+#include "Log.h"
+
+#include <WindowTypes.h>
+
+#include <gfx/Surface.h>
+
+#include <sys/syscalls.h>
+#include <unistd.h>
+
+#include <iterator>
+
+/// Region of virtual memory in which window surfaces are mapped
+constexpr static const uintptr_t kSurfaceMappingRange[2] = {
+    // start
+    0x60300000000,
+    // end
+    0x60400000000,
+};
+
+std::mutex Window::gAddressLock;
+std::map<uintptr_t, size_t> Window::gFreeAddresses{
+    {kSurfaceMappingRange[0], kSurfaceMappingRange[1] - kSurfaceMappingRange[0]},
+};
+
+/**
+ * Allocates a new window, including its surface.
+ *
+ * @param id Identifier for the window
+ * @param owner Handle of the task that the window belongs to
+ * @param width Width of the window surface, in pixels
+ * @param height Height of the window surface, in pixels
+ * @param flags Window flags, as defined in the `WindowFlags` enum
+ * @param outWindow On success, the allocated window
+ *
+ * @return 0 on success or an error code
+ */
+int Window::Alloc(const uint32_t id, const uintptr_t owner, const uint32_t width,
+        const uint32_t height, const uint32_t flags, std::shared_ptr<Window> &outWindow) {
+    std::shared_ptr<Window> ptr(new Window(id, owner, width, height, flags));
+    if(ptr->status) {
+        return ptr->status;
+    }
+
+    outWindow = ptr;
+    return 0;
+}
+
+/**
+ * Allocates the virtual memory region that backs the window's surface, and maps it into our
+ * address space. The client will later map the same region into its own address space.
+ */
+Window::Window(const uint32_t _id, const uintptr_t _owner, const uint32_t width,
+        const uint32_t height, const uint32_t _flags) : id(_id), owner(_owner), flags(_flags),
+        frame({0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height)}) {
+    int err;
+    using Format = gui::gfx::Surface::Format;
+
+    // figure out how much memory we need
+    const auto pageSz = sysconf(_SC_PAGESIZE);
+    this->pitch = gui::gfx::Surface::GetOptimalPitch({width, height}, Format::ARGB32);
+
+    this->vmBytes = this->pitch * height;
+    this->vmBytes = ((this->vmBytes + pageSz - 1) / pageSz) * pageSz;
+
+    // allocate and map it
+    err = AllocVirtualAnonRegion(this->vmBytes, VM_REGION_RW, &this->vmRegion);
+    if(err) {
+        Warn("%s failed: %d", "AllocVirtualAnonRegion", err);
+        this->status = err;
+        return;
+    }
+
+    const auto base = AllocAddressRange(this->vmBytes);
+    if(!base) {
+        Warn("Out of address space for %lu byte surface", this->vmBytes);
+        this->status = Compositor::Errors::NoSurfaceAddressSpace;
+        return;
+    }
+
+    err = MapVirtualRegion(this->vmRegion, base, this->vmBytes, 0);
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegion", err);
+        FreeAddressRange(base, this->vmBytes);
+        this->status = err;
+        return;
+    }
+    this->vmBase = base;
+
+    // create the surface on it
+    std::span<std::byte> buffer(reinterpret_cast<std::byte *>(base), this->vmBytes);
+    this->surface = std::make_shared<gui::gfx::Surface>(buffer, this->pitch, Format::ARGB32,
+            gui::gfx::Surface::Size{width, height});
+}
+
+/**
+ * Releases the surface, then unmaps and deallocates the backing memory region. Its address range
+ * becomes available for other surfaces.
+ */
+Window::~Window() {
+    int err;
+
+    this->surface.reset();
+
+    if(this->vmRegion) {
+        if(this->vmBase) {
+            err = UnmapVirtualRegion(this->vmRegion);
+            if(err) {
+                Warn("%s failed: %d", "UnmapVirtualRegion", err);
+            } else {
+                FreeAddressRange(this->vmBase, this->vmBytes);
+            }
+        }
+
+        err = DeallocVirtualRegion(this->vmRegion);
+        if(err) {
+            Warn("%s failed: %d", "DeallocVirtualRegion", err);
+        }
+    }
+}
+
+/**
+ * Finds a free part of the surface mapping range that's large enough to hold the given number of
+ * bytes, and removes it from the free list. The first range that fits is used.
+ *
+ * @return Base address of the allocated range, or 0 if there is no suitable free range
+ */
+uintptr_t Window::AllocAddressRange(const size_t bytes) {
+    std::lock_guard<std::mutex> lg(gAddressLock);
+
+    for(auto it = gFreeAddresses.begin(); it != gFreeAddresses.end(); ++it) {
+        const auto [base, length] = *it;
+        if(length < bytes) continue;
+
+        gFreeAddresses.erase(it);
+        if(length > bytes) {
+            gFreeAddresses.emplace(base + bytes, length - bytes);
+        }
+        return base;
+    }
+
+    return 0;
+}
+
+/**
+ * Returns a range previously allocated by AllocAddressRange() to the free list. It's merged with
+ * the free ranges immediately before and after it, if any.
+ */
+void Window::FreeAddressRange(const uintptr_t base, const size_t bytes) {
+    std::lock_guard<std::mutex> lg(gAddressLock);
+
+    auto [it, inserted] = gFreeAddresses.emplace(base, bytes);
+    REQUIRE(inserted, "Surface address range $%p freed twice", base);
+
+    // merge with the following range
+    auto next = std::next(it);
+    if(next != gFreeAddresses.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        gFreeAddresses.erase(next);
+    }
+
+    // and the preceding one
+    if(it != gFreeAddresses.begin()) {
+        auto prev = std::prev(it);
+        if(prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            gFreeAddresses.erase(it);
+        }
+    }
+}
+
+
+
+/**
+ * Whether the window is opaque. This is the case if it was created with the opaque flag.
+ */
+bool Window::isOpaque() const {
+    return (this->flags & WindowFlags::kWindowOpaque);
+}
+
+
+
+/**
+ * Adds damage to the window. Each rectangle is clipped to the bounds of the window's surface.
+ *
+ * Since the client modified the surface's backing memory directly, we also need to let the
+ * graphics library know the contents of these regions changed, in case it cached them.
+ */
+void Window::addDamage(const std::span<const WindowDamageRect> &rects) {
+    const Region::Rect bounds{0, 0, this->frame.w, this->frame.h};
+
+    for(const auto &in : rects) {
+        const Region::Rect rect{in.x, in.y, static_cast<int32_t>(in.w),
+            static_cast<int32_t>(in.h)};
+        const auto clipped = rect.intersection(bounds);
+        if(clipped.isEmpty()) continue;
+
+        if(kLogDamage) Trace("Window %u damage: (%d, %d) %d x %d", this->id, clipped.x, clipped.y,
+                clipped.w, clipped.h);
+
+        this->damage.add(clipped);
+
+        this->surface->markDirty(gui::gfx::Surface::Point(clipped.x, clipped.y),
+                gui::gfx::Surface::Size(clipped.w, clipped.h));
+    }
+}
+
+/**
+ * Translates the window's damage region into screen coordinates and adds it to the provided
+ * region, then clears the window's damage.
+ */
+void Window::takeDamage(Region &outScreenDamage) {
+    for(const auto &rect : this->damage) {
+        outScreenDamage.add(rect.translated(this->frame.x, this->frame.y));
+    }
+
+    this->damage.clear();
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "Region.h"
+
+namespace gui::gfx {
+class Surface;
+}
+
+struct WindowDamageRect;
+
+/**
+ * Represents a single window on screen.
+ *
+ * Each window's contents are stored in a surface backed by an anonymous virtual memory region,
+ * which is shared with the client that owns the window. The client draws into that memory and then
+ * indicates which parts of the surface it changed; these are accumulated in the window's damage
+ * region until the compositor picks them up for the next frame.
+ *
+ * Windows belong to the task that created them; only it may manipulate the window.
+ */
+class Window {
+    public:
+        /// Allocates a window with a surface of the given size.
+        [[nodiscard]] static int Alloc(const uint32_t id, const uintptr_t owner,
+                const uint32_t width, const uint32_t height, const uint32_t flags,
+                std::shared_ptr<Window> &outWindow);
+        /// Releases the window's surface and its backing memory.
+        ~Window();
+
+        /// Adds the given rectangles (in window coordinates) to the window's damage region.
+        void addDamage(const std::span<const WindowDamageRect> &rects);
+        /// Adds this window's damage, in screen coordinates, to the given region and clears it.
+        void takeDamage(Region &outScreenDamage);
+        /// Discards any damage accumulated on the window.
+        inline void clearDamage() {
+            this->damage.clear();
+        }
+
+        /// Moves the window's top left corner to the given screen coordinate.
+        inline void setPosition(const int32_t x, const int32_t y) {
+            this->frame.x = x;
+            this->frame.y = y;
+        }
+        /// Sets whether the window is visible.
+        inline void setVisible(const bool isVisible) {
+            this->visible = isVisible;
+        }
+
+        /// Returns the window's identifier.
+        constexpr inline auto getId() const {
+            return this->id;
+        }
+        /// Returns the handle of the task that owns the window.
+        constexpr inline auto getOwner() const {
+            return this->owner;
+        }
+        /// Returns the rectangle the window covers on screen.
+        constexpr inline auto &getFrame() const {
+            return this->frame;
+        }
+        /// Whether the window is visible
+        constexpr inline bool isVisible() const {
+            return this->visible;
+        }
+        /// Whether the window is fully opaque
+        bool isOpaque() const;
+
+        /// Returns the surface holding the window's contents.
+        inline auto &getSurface() const {
+            return this->surface;
+        }
+        /// Returns the handle of the virtual memory region backing the window surface.
+        constexpr inline auto getSurfaceHandle() const {
+            return this->vmRegion;
+        }
+        /// Returns the size of the window surface's backing memory, in bytes.
+        constexpr inline auto getSurfaceBytes() const {
+            return this->vmBytes;
+        }
+        /// Returns the number of bytes per row of the window surface.
+        constexpr inline auto getPitch() const {
+            return this->pitch;
+        }
+
+    private:
+        Window(const uint32_t id, const uintptr_t owner, const uint32_t width,
+                const uint32_t height, const uint32_t flags);
+
+        static uintptr_t AllocAddressRange(const size_t bytes);
+        static void FreeAddressRange(const uintptr_t base, const size_t bytes);
+
+    private:
+        /// Whether damage added to windows is logged
+        constexpr static const bool kLogDamage{false};
+
+        /// Protects the free list of the surface mapping range
+        static std::mutex gAddressLock;
+        /// Unused parts of the surface mapping range, as base address -> length
+        static std::map<uintptr_t, size_t> gFreeAddresses;
+
+        /// Records errors during initialization
+        int status{0};
+
+        /// Window identifier, unique for the window server's lifetime
+        uint32_t id;
+        /// Task handle of the client that created the window
+        uintptr_t owner;
+        /// Flags the window was created with (see `WindowFlags`)
+        uint32_t flags;
+
+        /// Area of the screen covered by the window
+        Region::Rect frame;
+        /// Whether the window is displayed
+        bool visible{false};
+
+        /// Parts of the window's surface (in window coordinates) changed since the last frame
+        Region damage;
+
+        /// Handle of the virtual memory region backing the surface
+        uintptr_t vmRegion{0};
+        /// Size of the virtual memory region, in bytes
+        size_t vmBytes{0};
+        /// Address at which the region is mapped in our address space
+        uintptr_t vmBase{0};
+        /// Bytes per row of the surface
+        size_t pitch{0};
+
+        /// Surface drawing into the shared memory region
+        std::shared_ptr<gui::gfx::Surface> surface;
+};
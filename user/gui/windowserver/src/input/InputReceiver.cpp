@@ -0,0 +1,262 @@
+#include "InputReceiver.h"
+#include "compositor/Compositor.h"
+
+#include "Log.h"
+
+#include <InputRing.h>
+
+#include <sys/syscalls.h>
+#include <unistd.h>
+
+#ifdef __Kush__
+#include <threads.h>
+#endif
+
+#include <cstring>
+#include <optional>
+#include <tuple>
+
+/// Region of virtual memory in which input rings are mapped
+static uintptr_t kRingMappingRange[2] = {
+    // start
+    0x60410000000,
+    // end
+    0x60420000000,
+};
+
+/**
+ * Sets up the input receiver and starts its worker thread.
+ */
+InputReceiver::InputReceiver(const std::shared_ptr<Compositor> &_comp) : comp(_comp) {
+#ifdef __Kush__
+    this->worker = std::make_unique<std::thread>(&InputReceiver::workerMain, this);
+#endif
+}
+
+/**
+ * Stops the worker thread, then unmaps and releases all rings. Any driver that still has a ring
+ * mapped keeps its mapping, but its events will no longer be read.
+ */
+InputReceiver::~InputReceiver() {
+    int err;
+
+#ifdef __Kush__
+    this->run = false;
+    NotificationSend(this->getThreadHandle(), kShutdownBit);
+    this->worker->join();
+#endif
+
+    std::lock_guard<std::mutex> lg(this->ringsLock);
+    std::lock_guard<std::mutex> dlg(this->dispatchLock);
+    for(const auto &ring : this->rings) {
+        err = UnmapVirtualRegion(ring.vmRegion);
+        if(err) {
+            Warn("%s failed: %d", "UnmapVirtualRegion", err);
+        }
+        err = DeallocVirtualRegion(ring.vmRegion);
+        if(err) {
+            Warn("%s failed: %d", "DeallocVirtualRegion", err);
+        }
+    }
+}
+
+/**
+ * Allocates a new input ring and maps it into our address space. The header is initialized so
+ * that the producer notifies our input thread when it writes to an empty ring.
+ *
+ * @param outRegion On success, the handle of the VM region holding the ring
+ * @param outBytes On success, the size of the ring's VM region
+ *
+ * @return 0 on success or an error code
+ */
+int InputReceiver::openRing(uintptr_t &outRegion, uint64_t &outBytes) {
+    int err;
+    Ring ring;
+
+    // figure out the size of the region
+    const auto pageSz = sysconf(_SC_PAGESIZE);
+    const auto eventsOffset = (sizeof(InputRing::Header) + alignof(InputRing::Event) - 1) &
+        ~(alignof(InputRing::Event) - 1);
+
+    ring.vmBytes = eventsOffset + (kRingCapacity * sizeof(InputRing::Event));
+    ring.vmBytes = ((ring.vmBytes + pageSz - 1) / pageSz) * pageSz;
+
+    // allocate and map it
+    err = AllocVirtualAnonRegion(ring.vmBytes, VM_REGION_RW, &ring.vmRegion);
+    if(err) {
+        Warn("%s failed: %d", "AllocVirtualAnonRegion", err);
+        return err;
+    }
+
+    uintptr_t base{0};
+    err = MapVirtualRegionRange(ring.vmRegion, kRingMappingRange, ring.vmBytes, 0, &base);
+    kRingMappingRange[0] += ring.vmBytes;
+    if(err) {
+        Warn("%s failed: %d", "MapVirtualRegionRange", err);
+        DeallocVirtualRegion(ring.vmRegion);
+        return err;
+    }
+
+    // initialize the header
+    memset(reinterpret_cast<void *>(base), 0, ring.vmBytes);
+    ring.header = new(reinterpret_cast<void *>(base)) InputRing::Header;
+    ring.capacity = kRingCapacity;
+    ring.eventsOffset = eventsOffset;
+
+    auto hdr = ring.header;
+    hdr->version = InputRing::kVersion;
+    hdr->capacity = kRingCapacity;
+    hdr->eventsOffset = eventsOffset;
+    hdr->notifyThread = this->getThreadHandle();
+    hdr->notifyBits = kRingBit;
+    hdr->writeIndex = 0;
+    hdr->readIndex = 0;
+    hdr->dropped = 0;
+
+    __atomic_store_n(&hdr->magic, InputRing::kMagic, __ATOMIC_RELEASE);
+
+    // register it
+    {
+        std::lock_guard<std::mutex> lg(this->ringsLock);
+        this->rings.emplace_back(ring);
+    }
+
+    outRegion = ring.vmRegion;
+    outBytes = ring.vmBytes;
+    return 0;
+}
+
+
+
+/**
+ * Delivers a key event received through an RPC call.
+ */
+void InputReceiver::submitKeyEvent(const uint32_t scancode, const bool release) {
+    std::lock_guard<std::mutex> lg(this->dispatchLock);
+    this->comp->handleKeyEvent(scancode, release);
+}
+
+/**
+ * Delivers a mouse event received through an RPC call.
+ */
+void InputReceiver::submitMouseEvent(const std::tuple<int, int, int> &move,
+        const uint32_t buttons) {
+    std::lock_guard<std::mutex> lg(this->dispatchLock);
+    this->comp->handleMouseEvent(move, buttons);
+}
+
+
+
+/**
+ * Main loop for the input thread: wait for a producer to notify us, then drain all rings. We
+ * always check all rings since the notification bits don't tell us which ring was written to.
+ */
+void InputReceiver::workerMain() {
+#ifdef __Kush__
+    while(this->run) {
+        const auto note = NotificationReceive(kRingBit | kShutdownBit, UINTPTR_MAX);
+
+        if(note & kShutdownBit) {
+            break;
+        }
+        if(note & kRingBit) {
+            this->drainAll();
+        }
+    }
+#endif
+}
+
+/**
+ * Reads all pending events out of every ring and dispatches them to the compositor.
+ *
+ * Mouse motion is accumulated for as long as the button state doesn't change, and the events
+ * were generated within a short time of one another; when either changes, or a key event arrives,
+ * the motion so far is submitted first, so that clicks and key presses still happen at the right
+ * cursor position.
+ */
+void InputReceiver::drainAll() {
+    struct PendingMotion {
+        /// timestamp of the first event merged
+        uint64_t start;
+        uint32_t buttons;
+        int32_t dX, dY, dZ;
+    };
+    std::optional<PendingMotion> motion;
+
+    auto flushMotion = [&]() {
+        if(!motion) return;
+        this->comp->handleMouseEvent({motion->dX, motion->dY, motion->dZ}, motion->buttons);
+        motion.reset();
+    };
+
+    std::lock_guard<std::mutex> lg(this->ringsLock);
+    std::lock_guard<std::mutex> dlg(this->dispatchLock);
+
+    for(auto &ring : this->rings) {
+        if(ring.broken) continue;
+
+        size_t num;
+        auto events = reinterpret_cast<const InputRing::Event *>(
+                reinterpret_cast<const std::byte *>(ring.header) + ring.eventsOffset);
+
+        const bool ok = InputRing::Drain(ring.header, events, ring.capacity, ring.readIndex,
+                [&](const InputRing::Event &event) {
+            switch(event.type) {
+                case InputRing::EventType::Mouse: {
+                    const auto &m = event.mouse;
+
+                    if(motion && motion->buttons == m.buttons &&
+                            event.timestamp - motion->start < kMotionMergeWindow) {
+                        motion->dX += m.dX;
+                        motion->dY += m.dY;
+                        motion->dZ += m.dZ;
+                    } else {
+                        flushMotion();
+                        motion = PendingMotion{event.timestamp, m.buttons, m.dX, m.dY, m.dZ};
+                    }
+                    break;
+                }
+
+                case InputRing::EventType::Key:
+                    flushMotion();
+                    this->comp->handleKeyEvent(event.key.scancode, event.key.release);
+                    break;
+
+                default:
+                    Warn("Unknown input event type %u", static_cast<uint32_t>(event.type));
+                    break;
+            }
+        }, num);
+
+        // motion from different devices is not merged
+        flushMotion();
+
+        if(!ok) {
+            Warn("Input ring %p is corrupt (read %u, write %u); ignoring it", ring.header,
+                    ring.readIndex, ring.header->writeIndex.load(std::memory_order_relaxed));
+            ring.broken = true;
+            continue;
+        }
+
+        if(kLogBatches) Trace("Ring %p: %lu events", ring.header, num);
+
+        // report any events the producer dropped
+        const auto dropped = ring.header->dropped.load(std::memory_order_relaxed);
+        if(dropped != ring.dropped) {
+            Warn("Input ring %p dropped %u events", ring.header, dropped - ring.dropped);
+            ring.dropped = dropped;
+        }
+    }
+}
+
+/**
+ * Gets the kernel handle of the input thread, to which producers send notifications.
+ */
+uintptr_t InputReceiver::getThreadHandle() const {
+#ifdef __Kush__
+    auto thrd = reinterpret_cast<thrd_t>(this->worker->native_handle());
+    return thrd_get_handle_np(thrd);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+class Compositor;
+
+namespace InputRing {
+struct Header;
+}
+
+/**
+ * Receives input events from drivers through shared memory rings (see `InputRing.h`) and feeds
+ * them into the compositor.
+ *
+ * All rings are serviced by a single thread, which sleeps until a driver notifies it that a ring
+ * became non-empty. Consecutive mouse motion events with the same button state are merged before
+ * being handed to the compositor, so the cursor is only updated once per batch of events rather
+ * than once for every packet the mouse sends.
+ *
+ * Drivers that couldn't set up a ring submit events through RPC calls instead; those are also
+ * delivered through the input receiver, so the compositor only ever handles one event at a time.
+ */
+class InputReceiver {
+    constexpr static const uintptr_t kRingBit{1 << 0};
+    constexpr static const uintptr_t kShutdownBit{1 << 16};
+
+    public:
+        /// Creates the input receiver and starts its thread.
+        InputReceiver(const std::shared_ptr<Compositor> &comp);
+        /// Stops the input thread and releases all rings.
+        ~InputReceiver();
+
+        /// Allocates a new input ring for a driver.
+        [[nodiscard]] int openRing(uintptr_t &outRegion, uint64_t &outBytes);
+
+        /// Delivers a key event that was received through an RPC call, rather than a ring.
+        void submitKeyEvent(const uint32_t scancode, const bool release);
+        /// Delivers a mouse event that was received through an RPC call, rather than a ring.
+        void submitMouseEvent(const std::tuple<int, int, int> &move, const uint32_t buttons);
+
+    private:
+        /**
+         * Information on a single input ring
+         */
+        struct Ring {
+            /// VM region containing the ring
+            uintptr_t vmRegion{0};
+            /// Size of the VM region, in bytes
+            size_t vmBytes{0};
+            /// Ring header (at the start of the region)
+            InputRing::Header *header{nullptr};
+            /// Number of dropped events last reported by the producer
+            uint32_t dropped{0};
+
+            /**
+             * Ring geometry and read index, as set up by us; the copies in the header are
+             * writable by the producer, so they aren't used to access the ring.
+             */
+            uint32_t capacity{0}, eventsOffset{0}, readIndex{0};
+            /// Set if the producer corrupted the ring; it's no longer read from
+            bool broken{false};
+        };
+
+        void workerMain();
+        void drainAll();
+
+        /// Returns the kernel handle of the input thread.
+        uintptr_t getThreadHandle() const;
+
+    private:
+        /// Number of events each ring can hold; must be a power of two
+        constexpr static const uint32_t kRingCapacity{256};
+        /// Whether the number of events processed per batch is logged
+        constexpr static const bool kLogBatches{false};
+        /**
+         * Maximum time span (in nanoseconds) of mouse motion events that are merged; this keeps
+         * the path of the cursor intact when a large batch of motion is read at once.
+         */
+        constexpr static const uint64_t kMotionMergeWindow{8'000'000};
+
+        /// Compositor to deliver events to
+        std::shared_ptr<Compositor> comp;
+
+        /// Lock protecting the rings list
+        std::mutex ringsLock;
+        /// All rings we've allocated
+        std::vector<Ring> rings;
+
+        /**
+         * Lock serializing delivery of events to the compositor; events may be delivered both by
+         * the input thread and the RPC thread.
+         */
+        std::mutex dispatchLock;
+
+        /// input thread
+        std::unique_ptr<std::thread> worker;
+        /// whether the input thread shall execute
+        std::atomic_bool run{true};
+};
@@ -1,5 +1,6 @@
 #include "Log.h"
 #include "compositor/Compositor.h"
+#include "input/InputReceiver.h"
 #include "rpc/RpcServer.h"
 
 #include <DriverSupport/gfx/Display.h>
@@ -26,9 +27,10 @@ int main(const int argc, const char **argv) {
     }
 
     auto compositor = std::make_shared<Compositor>(display);
+    auto input = std::make_shared<InputReceiver>(compositor);
 
     // create and start RPC server
-    RpcServer server(compositor);
+    RpcServer server(compositor, input);
     err = server.run();
 
     Trace("Run loop returned: %d", err);
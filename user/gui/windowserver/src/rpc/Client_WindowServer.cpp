@@ -1,6 +1,6 @@
 /*
- * This RPC client stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from WindowServer.idl for interface WindowServer at 2021-07-11T18:46:48-0500
+ * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from WindowServer.idl for interface WindowServer at 2026-10-18T06:17:41-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -124,4 +124,231 @@ void Client::SubmitMouseEvent(uint32_t buttons, int32_t dX, int32_t dY, int32_t
         this->_sendRequest(static_cast<uint64_t>(internals::Type::SubmitMouseEvent), numBytes);
     }
 }
+/*
+ * Autogenerated call method for 'OpenInputRing' (id $cf4bb9eecb816e63)
+ * Have 0 parameter(s), 3 return(s); method is sync
+ */
+Client::OpenInputRingReturn Client::OpenInputRing() {
+    uint32_t sentTag;
+    {
+        internals::OpenInputRingRequest request;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::OpenInputRing), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::OpenInputRing)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::OpenInputRingResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        OpenInputRingReturn r;
+        r.status =  reply.status;
+        r.regionHandle =  reply.regionHandle;
+        r.regionBytes =  reply.regionBytes;
+        return r;
+
+    }
+}
+/*
+ * Autogenerated call method for 'CreateWindow' (id $d5cef735fcb77c2f)
+ * Have 3 parameter(s), 5 return(s); method is sync
+ */
+Client::CreateWindowReturn Client::CreateWindow(uint32_t width, uint32_t height, uint32_t flags) {
+    uint32_t sentTag;
+    {
+        internals::CreateWindowRequest request;
+        request.width = width;
+        request.height = height;
+        request.flags = flags;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::CreateWindow), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::CreateWindow)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::CreateWindowResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        CreateWindowReturn r;
+        r.status =  reply.status;
+        r.windowId =  reply.windowId;
+        r.surfaceHandle =  reply.surfaceHandle;
+        r.surfaceBytes =  reply.surfaceBytes;
+        r.pitch =  reply.pitch;
+        return r;
+
+    }
+}
+/*
+ * Autogenerated call method for 'DestroyWindow' (id $bae83efdfca98972)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::DestroyWindow(uint32_t windowId) {
+    uint32_t sentTag;
+    {
+        internals::DestroyWindowRequest request;
+        request.windowId = windowId;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::DestroyWindow), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::DestroyWindow)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::DestroyWindowResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
+/*
+ * Autogenerated call method for 'SetWindowPosition' (id $8e3e0ede28aefc1e)
+ * Have 3 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::SetWindowPosition(uint32_t windowId, int32_t x, int32_t y) {
+    uint32_t sentTag;
+    {
+        internals::SetWindowPositionRequest request;
+        request.windowId = windowId;
+        request.x = x;
+        request.y = y;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::SetWindowPosition), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::SetWindowPosition)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::SetWindowPositionResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
+/*
+ * Autogenerated call method for 'SetWindowVisible' (id $36861b4d2a6bd919)
+ * Have 2 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::SetWindowVisible(uint32_t windowId, bool visible) {
+    uint32_t sentTag;
+    {
+        internals::SetWindowVisibleRequest request;
+        request.windowId = windowId;
+        request.visible = visible;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::SetWindowVisible), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::SetWindowVisible)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::SetWindowVisibleResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
+/*
+ * Autogenerated call method for 'RaiseWindow' (id $5a2848ad54886174)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::RaiseWindow(uint32_t windowId) {
+    uint32_t sentTag;
+    {
+        internals::RaiseWindowRequest request;
+        request.windowId = windowId;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::RaiseWindow), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::RaiseWindow)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::RaiseWindowResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
+/*
+ * Autogenerated call method for 'DamageWindow' (id $16d4e63884ad0dc9)
+ * Have 2 parameter(s), 0 return(s); method is async
+ */
+void Client::DamageWindow(uint32_t windowId, const std::vector<std::byte> &rects) {
+    {
+        internals::DamageWindowRequest request;
+        request.windowId = windowId;
+        request.rects = rects;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        this->_sendRequest(static_cast<uint64_t>(internals::Type::DamageWindow), numBytes);
+    }
+}
 #pragma clang diagnostic pop
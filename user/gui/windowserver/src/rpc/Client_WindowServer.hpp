@@ -1,6 +1,6 @@
 /*
- * This RPC client stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from WindowServer.idl for interface WindowServer at 2021-07-11T18:46:48-0500
+ * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from WindowServer.idl for interface WindowServer at 2026-10-18T06:17:41-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -43,6 +43,20 @@ class WindowServerClient {
         using IoStream = rt::ClientRpcIoStream;
 
     public:
+        // Return types for method 'OpenInputRing'
+        struct OpenInputRingReturn {
+            int32_t status;
+            uint64_t regionHandle;
+            uint64_t regionBytes;
+        };
+        // Return types for method 'CreateWindow'
+        struct CreateWindowReturn {
+            int32_t status;
+            uint32_t windowId;
+            uint64_t surfaceHandle;
+            uint64_t surfaceBytes;
+            uint32_t pitch;
+        };
 
     public:
         WindowServerClient(const std::shared_ptr<IoStream> &stream);
@@ -50,6 +64,13 @@ class WindowServerClient {
 
         virtual void SubmitKeyEvent(uint32_t scancode, bool release);
         virtual void SubmitMouseEvent(uint32_t buttons, int32_t dX, int32_t dY, int32_t dZ);
+        virtual OpenInputRingReturn OpenInputRing();
+        virtual CreateWindowReturn CreateWindow(uint32_t width, uint32_t height, uint32_t flags);
+        virtual int32_t DestroyWindow(uint32_t windowId);
+        virtual int32_t SetWindowPosition(uint32_t windowId, int32_t x, int32_t y);
+        virtual int32_t SetWindowVisible(uint32_t windowId, bool visible);
+        virtual int32_t RaiseWindow(uint32_t windowId);
+        virtual void DamageWindow(uint32_t windowId, const std::vector<std::byte> &rects);
 
     // Helpers provided to subclasses for implementation of interface methods
     protected:
@@ -1,6 +1,6 @@
 /*
- * This RPC serialization code was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from WindowServer.idl for interface WindowServer at 2021-07-11T18:46:48-0500
+ * This RPC serialization code was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from WindowServer.idl for interface WindowServer at 2026-10-18T06:17:41-0500
  *
  * The structs and methods within are used by the RPC system to serialize and deserialize the
  * arguments and return values on method calls. They work internally in the same way that encoding
@@ -91,6 +91,13 @@ namespace internals {
 enum class Type: uint64_t {
                                       SubmitKeyEvent = 0x5313353be07b5c96ULL,
                                     SubmitMouseEvent = 0x46e5a95b9576c0cULL,
+                                       OpenInputRing = 0xcf4bb9eecb816e63ULL,
+                                        CreateWindow = 0xd5cef735fcb77c2fULL,
+                                       DestroyWindow = 0xbae83efdfca98972ULL,
+                                   SetWindowPosition = 0x8e3e0ede28aefc1eULL,
+                                    SetWindowVisible = 0x36861b4d2a6bd919ULL,
+                                         RaiseWindow = 0x5a2848ad54886174ULL,
+                                        DamageWindow = 0x16d4e63884ad0dc9ULL,
 };
 /**
  * Request structure for method 'SubmitKeyEvent'
@@ -128,6 +135,219 @@ struct SubmitMouseEventRequest {
     constexpr static const size_t kBlobStartOffset{16};
 };
 
+/**
+ * Request structure for method 'OpenInputRing'
+ */
+struct OpenInputRingRequest {
+
+    constexpr static const size_t kElementSizes[0] {
+    
+    };
+    constexpr static const size_t kElementOffsets[0] {
+    
+    };
+    constexpr static const size_t kScalarBytes{0};
+    constexpr static const size_t kBlobStartOffset{0};
+};
+/**
+ * Reply structure for method 'OpenInputRing'
+ */
+struct OpenInputRingResponse {
+    int32_t status;
+    uint64_t regionHandle;
+    uint64_t regionBytes;
+
+    constexpr static const size_t kElementSizes[3] {
+     4,  8,  8
+    };
+    constexpr static const size_t kElementOffsets[3] {
+     0,  4, 12
+    };
+    constexpr static const size_t kScalarBytes{20};
+    constexpr static const size_t kBlobStartOffset{24};
+};
+
+/**
+ * Request structure for method 'CreateWindow'
+ */
+struct CreateWindowRequest {
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+
+    constexpr static const size_t kElementSizes[3] {
+     4,  4,  4
+    };
+    constexpr static const size_t kElementOffsets[3] {
+     0,  4,  8
+    };
+    constexpr static const size_t kScalarBytes{12};
+    constexpr static const size_t kBlobStartOffset{16};
+};
+/**
+ * Reply structure for method 'CreateWindow'
+ */
+struct CreateWindowResponse {
+    int32_t status;
+    uint32_t windowId;
+    uint64_t surfaceHandle;
+    uint64_t surfaceBytes;
+    uint32_t pitch;
+
+    constexpr static const size_t kElementSizes[5] {
+     4,  4,  8,  8,  4
+    };
+    constexpr static const size_t kElementOffsets[5] {
+     0,  4,  8, 16, 24
+    };
+    constexpr static const size_t kScalarBytes{28};
+    constexpr static const size_t kBlobStartOffset{32};
+};
+
+/**
+ * Request structure for method 'DestroyWindow'
+ */
+struct DestroyWindowRequest {
+    uint32_t windowId;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+/**
+ * Reply structure for method 'DestroyWindow'
+ */
+struct DestroyWindowResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
+/**
+ * Request structure for method 'SetWindowPosition'
+ */
+struct SetWindowPositionRequest {
+    uint32_t windowId;
+    int32_t x;
+    int32_t y;
+
+    constexpr static const size_t kElementSizes[3] {
+     4,  4,  4
+    };
+    constexpr static const size_t kElementOffsets[3] {
+     0,  4,  8
+    };
+    constexpr static const size_t kScalarBytes{12};
+    constexpr static const size_t kBlobStartOffset{16};
+};
+/**
+ * Reply structure for method 'SetWindowPosition'
+ */
+struct SetWindowPositionResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
+/**
+ * Request structure for method 'SetWindowVisible'
+ */
+struct SetWindowVisibleRequest {
+    uint32_t windowId;
+    bool visible;
+
+    constexpr static const size_t kElementSizes[2] {
+     4,  1
+    };
+    constexpr static const size_t kElementOffsets[2] {
+     0,  4
+    };
+    constexpr static const size_t kScalarBytes{5};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+/**
+ * Reply structure for method 'SetWindowVisible'
+ */
+struct SetWindowVisibleResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
+/**
+ * Request structure for method 'RaiseWindow'
+ */
+struct RaiseWindowRequest {
+    uint32_t windowId;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+/**
+ * Reply structure for method 'RaiseWindow'
+ */
+struct RaiseWindowResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
+/**
+ * Request structure for method 'DamageWindow'
+ */
+struct DamageWindowRequest {
+    uint32_t windowId;
+    std::vector<std::byte> rects;
+
+    constexpr static const size_t kElementSizes[2] {
+     4,  8
+    };
+    constexpr static const size_t kElementOffsets[2] {
+     0,  4
+    };
+    constexpr static const size_t kScalarBytes{12};
+    constexpr static const size_t kBlobStartOffset{16};
+};
+
 } // namespace rpc::internals
 
 
@@ -249,6 +469,592 @@ inline bool deserialize(const std::span<std::byte> &in, internals::SubmitMouseEv
     return true;
 }
 
+inline size_t bytesFor(const internals::OpenInputRingRequest &x) {
+    using namespace internals;
+    size_t len = OpenInputRingRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::OpenInputRingRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = OpenInputRingRequest::kBlobStartOffset;
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::OpenInputRingRequest &x) {
+    using namespace internals;
+    if(in.size() < OpenInputRingRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(OpenInputRingRequest::kBlobStartOffset);
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::OpenInputRingResponse &x) {
+    using namespace internals;
+    size_t len = OpenInputRingResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::OpenInputRingResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = OpenInputRingResponse::kBlobStartOffset;
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[0];
+        const auto size = OpenInputRingResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[1];
+        const auto size = OpenInputRingResponse::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.regionHandle, range.size());
+    }
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[2];
+        const auto size = OpenInputRingResponse::kElementSizes[2];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.regionBytes, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::OpenInputRingResponse &x) {
+    using namespace internals;
+    if(in.size() < OpenInputRingResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(OpenInputRingResponse::kBlobStartOffset);
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[0];
+        const auto size = OpenInputRingResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[1];
+        const auto size = OpenInputRingResponse::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.regionHandle, range.data(), range.size());
+    }
+    {
+        const auto off = OpenInputRingResponse::kElementOffsets[2];
+        const auto size = OpenInputRingResponse::kElementSizes[2];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.regionBytes, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::CreateWindowRequest &x) {
+    using namespace internals;
+    size_t len = CreateWindowRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::CreateWindowRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = CreateWindowRequest::kBlobStartOffset;
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[0];
+        const auto size = CreateWindowRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.width, range.size());
+    }
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[1];
+        const auto size = CreateWindowRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.height, range.size());
+    }
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[2];
+        const auto size = CreateWindowRequest::kElementSizes[2];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.flags, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::CreateWindowRequest &x) {
+    using namespace internals;
+    if(in.size() < CreateWindowRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(CreateWindowRequest::kBlobStartOffset);
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[0];
+        const auto size = CreateWindowRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.width, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[1];
+        const auto size = CreateWindowRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.height, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowRequest::kElementOffsets[2];
+        const auto size = CreateWindowRequest::kElementSizes[2];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.flags, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::CreateWindowResponse &x) {
+    using namespace internals;
+    size_t len = CreateWindowResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::CreateWindowResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = CreateWindowResponse::kBlobStartOffset;
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[0];
+        const auto size = CreateWindowResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[1];
+        const auto size = CreateWindowResponse::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[2];
+        const auto size = CreateWindowResponse::kElementSizes[2];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.surfaceHandle, range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[3];
+        const auto size = CreateWindowResponse::kElementSizes[3];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.surfaceBytes, range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[4];
+        const auto size = CreateWindowResponse::kElementSizes[4];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.pitch, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::CreateWindowResponse &x) {
+    using namespace internals;
+    if(in.size() < CreateWindowResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(CreateWindowResponse::kBlobStartOffset);
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[0];
+        const auto size = CreateWindowResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[1];
+        const auto size = CreateWindowResponse::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[2];
+        const auto size = CreateWindowResponse::kElementSizes[2];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.surfaceHandle, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[3];
+        const auto size = CreateWindowResponse::kElementSizes[3];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.surfaceBytes, range.data(), range.size());
+    }
+    {
+        const auto off = CreateWindowResponse::kElementOffsets[4];
+        const auto size = CreateWindowResponse::kElementSizes[4];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.pitch, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::DestroyWindowRequest &x) {
+    using namespace internals;
+    size_t len = DestroyWindowRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::DestroyWindowRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = DestroyWindowRequest::kBlobStartOffset;
+    {
+        const auto off = DestroyWindowRequest::kElementOffsets[0];
+        const auto size = DestroyWindowRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::DestroyWindowRequest &x) {
+    using namespace internals;
+    if(in.size() < DestroyWindowRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(DestroyWindowRequest::kBlobStartOffset);
+    {
+        const auto off = DestroyWindowRequest::kElementOffsets[0];
+        const auto size = DestroyWindowRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::DestroyWindowResponse &x) {
+    using namespace internals;
+    size_t len = DestroyWindowResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::DestroyWindowResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = DestroyWindowResponse::kBlobStartOffset;
+    {
+        const auto off = DestroyWindowResponse::kElementOffsets[0];
+        const auto size = DestroyWindowResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::DestroyWindowResponse &x) {
+    using namespace internals;
+    if(in.size() < DestroyWindowResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(DestroyWindowResponse::kBlobStartOffset);
+    {
+        const auto off = DestroyWindowResponse::kElementOffsets[0];
+        const auto size = DestroyWindowResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SetWindowPositionRequest &x) {
+    using namespace internals;
+    size_t len = SetWindowPositionRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SetWindowPositionRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = SetWindowPositionRequest::kBlobStartOffset;
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[0];
+        const auto size = SetWindowPositionRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[1];
+        const auto size = SetWindowPositionRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.x, range.size());
+    }
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[2];
+        const auto size = SetWindowPositionRequest::kElementSizes[2];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.y, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SetWindowPositionRequest &x) {
+    using namespace internals;
+    if(in.size() < SetWindowPositionRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SetWindowPositionRequest::kBlobStartOffset);
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[0];
+        const auto size = SetWindowPositionRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[1];
+        const auto size = SetWindowPositionRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.x, range.data(), range.size());
+    }
+    {
+        const auto off = SetWindowPositionRequest::kElementOffsets[2];
+        const auto size = SetWindowPositionRequest::kElementSizes[2];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.y, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SetWindowPositionResponse &x) {
+    using namespace internals;
+    size_t len = SetWindowPositionResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SetWindowPositionResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = SetWindowPositionResponse::kBlobStartOffset;
+    {
+        const auto off = SetWindowPositionResponse::kElementOffsets[0];
+        const auto size = SetWindowPositionResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SetWindowPositionResponse &x) {
+    using namespace internals;
+    if(in.size() < SetWindowPositionResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SetWindowPositionResponse::kBlobStartOffset);
+    {
+        const auto off = SetWindowPositionResponse::kElementOffsets[0];
+        const auto size = SetWindowPositionResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SetWindowVisibleRequest &x) {
+    using namespace internals;
+    size_t len = SetWindowVisibleRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SetWindowVisibleRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = SetWindowVisibleRequest::kBlobStartOffset;
+    {
+        const auto off = SetWindowVisibleRequest::kElementOffsets[0];
+        const auto size = SetWindowVisibleRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+    {
+        const auto off = SetWindowVisibleRequest::kElementOffsets[1];
+        const auto size = SetWindowVisibleRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.visible, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SetWindowVisibleRequest &x) {
+    using namespace internals;
+    if(in.size() < SetWindowVisibleRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SetWindowVisibleRequest::kBlobStartOffset);
+    {
+        const auto off = SetWindowVisibleRequest::kElementOffsets[0];
+        const auto size = SetWindowVisibleRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+    {
+        const auto off = SetWindowVisibleRequest::kElementOffsets[1];
+        const auto size = SetWindowVisibleRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.visible, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::SetWindowVisibleResponse &x) {
+    using namespace internals;
+    size_t len = SetWindowVisibleResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::SetWindowVisibleResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = SetWindowVisibleResponse::kBlobStartOffset;
+    {
+        const auto off = SetWindowVisibleResponse::kElementOffsets[0];
+        const auto size = SetWindowVisibleResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::SetWindowVisibleResponse &x) {
+    using namespace internals;
+    if(in.size() < SetWindowVisibleResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(SetWindowVisibleResponse::kBlobStartOffset);
+    {
+        const auto off = SetWindowVisibleResponse::kElementOffsets[0];
+        const auto size = SetWindowVisibleResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::RaiseWindowRequest &x) {
+    using namespace internals;
+    size_t len = RaiseWindowRequest::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::RaiseWindowRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = RaiseWindowRequest::kBlobStartOffset;
+    {
+        const auto off = RaiseWindowRequest::kElementOffsets[0];
+        const auto size = RaiseWindowRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::RaiseWindowRequest &x) {
+    using namespace internals;
+    if(in.size() < RaiseWindowRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(RaiseWindowRequest::kBlobStartOffset);
+    {
+        const auto off = RaiseWindowRequest::kElementOffsets[0];
+        const auto size = RaiseWindowRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::RaiseWindowResponse &x) {
+    using namespace internals;
+    size_t len = RaiseWindowResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::RaiseWindowResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = RaiseWindowResponse::kBlobStartOffset;
+    {
+        const auto off = RaiseWindowResponse::kElementOffsets[0];
+        const auto size = RaiseWindowResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::RaiseWindowResponse &x) {
+    using namespace internals;
+    if(in.size() < RaiseWindowResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(RaiseWindowResponse::kBlobStartOffset);
+    {
+        const auto off = RaiseWindowResponse::kElementOffsets[0];
+        const auto size = RaiseWindowResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::DamageWindowRequest &x) {
+    using namespace internals;
+    size_t len = DamageWindowRequest::kBlobStartOffset;
+    len += bytesFor(x.rects);
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::DamageWindowRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = DamageWindowRequest::kBlobStartOffset;
+    {
+        const auto off = DamageWindowRequest::kElementOffsets[0];
+        const auto size = DamageWindowRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.windowId, range.size());
+    }
+    {
+        const auto off = DamageWindowRequest::kElementOffsets[1];
+        const auto size = DamageWindowRequest::kElementSizes[1];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.rects);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.rects)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::DamageWindowRequest &x) {
+    using namespace internals;
+    if(in.size() < DamageWindowRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(DamageWindowRequest::kBlobStartOffset);
+    {
+        const auto off = DamageWindowRequest::kElementOffsets[0];
+        const auto size = DamageWindowRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.windowId, range.data(), range.size());
+    }
+    {
+        const auto off = DamageWindowRequest::kElementOffsets[1];
+        const auto size = DamageWindowRequest::kElementSizes[1];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.rects)) {
+            HandleDecodeError("DamageWindowRequest", "rects", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 }; // namespace rpc
 
 #pragma clang diagnostic push
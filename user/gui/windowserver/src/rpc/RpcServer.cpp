@@ -1,15 +1,30 @@
 #include "RpcServer.h"
 #include "compositor/Compositor.h"
+#include "compositor/Window.h"
+#include "input/InputReceiver.h"
 
 #include "Log.h"
 
+#include <WindowTypes.h>
+
 #include <rpc/rt/ServerPortRpcStream.h>
 
+#include <cstring>
+
 /**
  * Initializes the RPC server. A listening port will be opened and registered.
  */
-RpcServer::RpcServer(const std::shared_ptr<Compositor> &comp) :
-    rpc::WindowServerServer(std::make_shared<rpc::rt::ServerPortRpcStream>(kPortName)) {
+RpcServer::RpcServer(const std::shared_ptr<Compositor> &comp,
+        const std::shared_ptr<InputReceiver> &input) :
+    RpcServer(std::make_shared<rpc::rt::ServerPortRpcStream>(kPortName), comp, input) {
+}
+
+/**
+ * Initializes the RPC server to receive requests on the given stream.
+ */
+RpcServer::RpcServer(const std::shared_ptr<rpc::rt::ServerPortRpcStream> &_stream,
+        const std::shared_ptr<Compositor> &comp, const std::shared_ptr<InputReceiver> &_input) :
+    rpc::WindowServerServer(_stream), stream(_stream), input(_input) {
     this->addCompositor(comp);
 }
 
@@ -23,24 +38,120 @@ void RpcServer::addCompositor(const std::shared_ptr<Compositor> &comp) {
 
 
 
+/**
+ * Returns the handle of the task that sent the request currently being handled.
+ */
+uintptr_t RpcServer::getClient() const {
+    return this->stream->getSenderTask();
+}
+
+
+
 /**
  * Handles a received key event.
  */
 void RpcServer::implSubmitKeyEvent(uint32_t scancode, bool release) {
-    const auto &c = this->comps[0];
-    c->handleKeyEvent(scancode, release);
+    this->input->submitKeyEvent(scancode, release);
 }
 
 
 /**
  * Handles a received mouse movement event.
  *
- * This pushes the relative movements into the compositor's mouse handler, which is responsible for
+ * This pushes the relative movements (through the input receiver, which serializes them with events
+ * read from input rings) into the compositor's mouse handler, which is responsible for
  * scaling the input and updating the position of the cursor on screen. It will also handle sending
  * the event to any interested parties.
  */
 void RpcServer::implSubmitMouseEvent(uint32_t buttons, int32_t dX, int32_t dY, int32_t dZ) {
+    this->input->submitMouseEvent({dX, dY, dZ}, buttons);
+}
+
+/**
+ * Allocates an input ring for a driver. Drivers should prefer this over submitting each event
+ * through an RPC call, since events delivered through the ring are batched.
+ */
+RpcServer::OpenInputRingReturn RpcServer::implOpenInputRing() {
+    uintptr_t region{0};
+    uint64_t bytes{0};
+
+    int err = this->input->openRing(region, bytes);
+    if(err) {
+        return {err};
+    }
+
+    return {0, region, bytes};
+}
+
+
+
+
+/**
+ * Creates a new window. We return the handle of the virtual memory region holding its surface,
+ * which the caller should map into its address space to draw into the window.
+ */
+RpcServer::CreateWindowReturn RpcServer::implCreateWindow(uint32_t width, uint32_t height,
+        uint32_t flags) {
+    std::shared_ptr<Window> window;
+
     const auto &c = this->comps[0];
-    c->handleMouseEvent({dX, dY, dZ}, buttons);
+    int err = c->createWindow(this->getClient(), width, height, flags, window);
+    if(err) {
+        return {err};
+    }
+
+    return {0, window->getId(), window->getSurfaceHandle(), window->getSurfaceBytes(),
+        static_cast<uint32_t>(window->getPitch())};
+}
+
+/**
+ * Destroys the given window, if it belongs to the caller.
+ */
+int32_t RpcServer::implDestroyWindow(uint32_t windowId) {
+    const auto &c = this->comps[0];
+    return c->destroyWindow(this->getClient(), windowId);
+}
+
+/**
+ * Moves a window on screen.
+ */
+int32_t RpcServer::implSetWindowPosition(uint32_t windowId, int32_t x, int32_t y) {
+    const auto &c = this->comps[0];
+    return c->setWindowPosition(this->getClient(), windowId, x, y);
 }
 
+/**
+ * Shows or hides a window.
+ */
+int32_t RpcServer::implSetWindowVisible(uint32_t windowId, bool visible) {
+    const auto &c = this->comps[0];
+    return c->setWindowVisible(this->getClient(), windowId, visible);
+}
+
+/**
+ * Brings a window to the front.
+ */
+int32_t RpcServer::implRaiseWindow(uint32_t windowId) {
+    const auto &c = this->comps[0];
+    return c->raiseWindow(this->getClient(), windowId);
+}
+
+/**
+ * Handles damage reported by a client for one of its windows. The rects are copied out of the
+ * message, since the blob isn't guaranteed to be suitably aligned.
+ */
+void RpcServer::implDamageWindow(uint32_t windowId, const std::vector<std::byte> &rects) {
+    if(rects.size() % sizeof(WindowDamageRect)) {
+        Warn("Invalid damage rect list size: %lu", rects.size());
+        return;
+    }
+
+    std::vector<WindowDamageRect> damage(rects.size() / sizeof(WindowDamageRect));
+    memcpy(damage.data(), rects.data(), rects.size());
+
+    const auto &c = this->comps[0];
+    int err = c->damageWindow(this->getClient(), windowId, damage);
+    if(err) {
+        Warn("%s failed: %d", "Compositor::damageWindow", err);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string_view>
 #include <vector>
@@ -7,9 +8,17 @@
 #include "Server_WindowServer.hpp"
 
 class Compositor;
+class InputReceiver;
+
+namespace rpc::rt {
+class ServerPortRpcStream;
+}
 
 /**
  * Provides the window server's RPC interface, which applications use to create windows on screen.
+ *
+ * Windows are owned by the task that sent the request creating them; requests for a window from
+ * any other task fail.
  */
 class RpcServer: public rpc::WindowServerServer {
     public:
@@ -17,8 +26,9 @@ class RpcServer: public rpc::WindowServerServer {
         constexpr static const std::string_view kPortName{"me.blraaz.rpc.windowserver"};
 
     public:
-        /// Initializes the RPC server with the given compositor.
-        RpcServer(const std::shared_ptr<Compositor> &comp);
+        /// Initializes the RPC server with the given compositor and input receiver.
+        RpcServer(const std::shared_ptr<Compositor> &comp,
+                const std::shared_ptr<InputReceiver> &input);
         /// Cleans up the RPC server.
         virtual ~RpcServer() = default;
 
@@ -28,8 +38,28 @@ class RpcServer: public rpc::WindowServerServer {
     protected:
         void implSubmitKeyEvent(uint32_t scancode, bool release) override;
         void implSubmitMouseEvent(uint32_t buttons, int32_t dX, int32_t dY, int32_t dZ) override;
+        OpenInputRingReturn implOpenInputRing() override;
+
+        CreateWindowReturn implCreateWindow(uint32_t width, uint32_t height,
+                uint32_t flags) override;
+        int32_t implDestroyWindow(uint32_t windowId) override;
+        int32_t implSetWindowPosition(uint32_t windowId, int32_t x, int32_t y) override;
+        int32_t implSetWindowVisible(uint32_t windowId, bool visible) override;
+        int32_t implRaiseWindow(uint32_t windowId) override;
+        void implDamageWindow(uint32_t windowId, const std::vector<std::byte> &rects) override;
+
+    private:
+        RpcServer(const std::shared_ptr<rpc::rt::ServerPortRpcStream> &stream,
+                const std::shared_ptr<Compositor> &comp,
+                const std::shared_ptr<InputReceiver> &input);
+
+        uintptr_t getClient() const;
 
     private:
+        /// Stream through which requests are received; this identifies the sending task
+        std::shared_ptr<rpc::rt::ServerPortRpcStream> stream;
         /// All active compositors
         std::vector<std::shared_ptr<Compositor>> comps;
+        /// Receives input events through shared memory rings
+        std::shared_ptr<InputReceiver> input;
 };
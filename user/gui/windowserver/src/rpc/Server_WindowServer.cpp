@@ -1,6 +1,6 @@
 /*
- * This RPC server stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from WindowServer.idl for interface WindowServer at 2021-07-11T18:46:48-0500
+ * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from WindowServer.idl for interface WindowServer at 2026-10-18T06:17:41-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -77,6 +77,27 @@ bool Server::runOne(const bool block) {
         case static_cast<uint64_t>(internals::Type::SubmitMouseEvent):
             this->_marshallSubmitMouseEvent(*hdr, payload);
             break;
+        case static_cast<uint64_t>(internals::Type::OpenInputRing):
+            this->_marshallOpenInputRing(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::CreateWindow):
+            this->_marshallCreateWindow(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::DestroyWindow):
+            this->_marshallDestroyWindow(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::SetWindowPosition):
+            this->_marshallSetWindowPosition(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::SetWindowVisible):
+            this->_marshallSetWindowVisible(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::RaiseWindow):
+            this->_marshallRaiseWindow(*hdr, payload);
+            break;
+        case static_cast<uint64_t>(internals::Type::DamageWindow):
+            this->_marshallDamageWindow(*hdr, payload);
+            break;
     }
     return true;
 }
@@ -143,4 +164,152 @@ void Server::_marshallSubmitMouseEvent(const MessageHeader &hdr, const std::span
 
     this->implSubmitMouseEvent(request.buttons, request.dX, request.dY, request.dZ);
 }
+/*
+ * Autogenerated marshalling method for 'OpenInputRing' (id $cf4bb9eecb816e63)
+ * Have 0 parameter(s), 3 return(s); method is sync
+ */
+void Server::_marshallOpenInputRing(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::OpenInputRingRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implOpenInputRing();
+
+    internals::OpenInputRingResponse reply;
+    reply.status = retVal.status;
+    reply.regionHandle = retVal.regionHandle;
+    reply.regionBytes = retVal.regionBytes;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'CreateWindow' (id $d5cef735fcb77c2f)
+ * Have 3 parameter(s), 5 return(s); method is sync
+ */
+void Server::_marshallCreateWindow(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::CreateWindowRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implCreateWindow(request.width, request.height, request.flags);
+
+    internals::CreateWindowResponse reply;
+    reply.status = retVal.status;
+    reply.windowId = retVal.windowId;
+    reply.surfaceHandle = retVal.surfaceHandle;
+    reply.surfaceBytes = retVal.surfaceBytes;
+    reply.pitch = retVal.pitch;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'DestroyWindow' (id $bae83efdfca98972)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallDestroyWindow(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::DestroyWindowRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implDestroyWindow(request.windowId);
+
+    internals::DestroyWindowResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'SetWindowPosition' (id $8e3e0ede28aefc1e)
+ * Have 3 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallSetWindowPosition(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::SetWindowPositionRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implSetWindowPosition(request.windowId, request.x, request.y);
+
+    internals::SetWindowPositionResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'SetWindowVisible' (id $36861b4d2a6bd919)
+ * Have 2 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallSetWindowVisible(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::SetWindowVisibleRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implSetWindowVisible(request.windowId, request.visible);
+
+    internals::SetWindowVisibleResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'RaiseWindow' (id $5a2848ad54886174)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallRaiseWindow(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::RaiseWindowRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implRaiseWindow(request.windowId);
+
+    internals::RaiseWindowResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
+/*
+ * Autogenerated marshalling method for 'DamageWindow' (id $16d4e63884ad0dc9)
+ * Have 2 parameter(s), 0 return(s); method is async
+ */
+void Server::_marshallDamageWindow(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::DamageWindowRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    this->implDamageWindow(request.windowId, request.rects);
+}
 #pragma clang diagnostic pop
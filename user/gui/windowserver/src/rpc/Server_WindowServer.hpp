@@ -1,6 +1,6 @@
 /*
- * This RPC server stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from WindowServer.idl for interface WindowServer at 2021-07-11T18:46:48-0500
+ * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from WindowServer.idl for interface WindowServer at 2026-10-18T06:17:41-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -41,6 +41,20 @@ class WindowServerServer {
 
     protected:
         using IoStream = rt::ServerRpcIoStream;
+        // Return types for method 'OpenInputRing'
+        struct OpenInputRingReturn {
+            int32_t status;
+            uint64_t regionHandle;
+            uint64_t regionBytes;
+        };
+        // Return types for method 'CreateWindow'
+        struct CreateWindowReturn {
+            int32_t status;
+            uint32_t windowId;
+            uint64_t surfaceHandle;
+            uint64_t surfaceBytes;
+            uint32_t pitch;
+        };
 
     public:
         WindowServerServer(const std::shared_ptr<IoStream> &stream);
@@ -55,6 +69,13 @@ class WindowServerServer {
     protected:
         virtual void implSubmitKeyEvent(uint32_t scancode, bool release) = 0;
         virtual void implSubmitMouseEvent(uint32_t buttons, int32_t dX, int32_t dY, int32_t dZ) = 0;
+        virtual OpenInputRingReturn implOpenInputRing() = 0;
+        virtual CreateWindowReturn implCreateWindow(uint32_t width, uint32_t height, uint32_t flags) = 0;
+        virtual int32_t implDestroyWindow(uint32_t windowId) = 0;
+        virtual int32_t implSetWindowPosition(uint32_t windowId, int32_t x, int32_t y) = 0;
+        virtual int32_t implSetWindowVisible(uint32_t windowId, bool visible) = 0;
+        virtual int32_t implRaiseWindow(uint32_t windowId) = 0;
+        virtual void implDamageWindow(uint32_t windowId, const std::vector<std::byte> &rects) = 0;
 
     // Helpers provided to subclasses for implementation of interface methods
     protected:
@@ -76,6 +97,13 @@ class WindowServerServer {
 
         void _marshallSubmitKeyEvent(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallSubmitMouseEvent(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallOpenInputRing(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallCreateWindow(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallDestroyWindow(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallSetWindowPosition(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallSetWindowVisible(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallRaiseWindow(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallDamageWindow(const MessageHeader &, const std::span<std::byte> &payload);
 }; // class WindowServerServer
 } // namespace rpc
 #endif // defined(RPC_SERVER_GENERATED_16174174863144938629)
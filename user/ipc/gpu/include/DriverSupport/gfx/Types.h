@@ -20,6 +20,17 @@ enum DisplayCapabilities: uint32_t {
     kUpdateRects                        = (1 << 0),
 };
 
+/**
+ * Describes a single updated rectangle of the framebuffer. An array of these is sent to the
+ * driver in a `RegionsUpdated` call.
+ */
+struct UpdateRect {
+    int32_t x{0};
+    int32_t y{0};
+    uint32_t w{0};
+    uint32_t h{0};
+} __attribute__((packed));
+
 /**
  * Encapsulates all properties of a display mode.
  */
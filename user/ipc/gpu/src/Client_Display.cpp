@@ -1,6 +1,6 @@
 /*
- * This RPC client stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from Display.idl for interface Display at 2021-07-08T01:00:48-0500
+ * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from Display.idl for interface Display at 2026-10-18T06:02:27-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -237,6 +237,38 @@ int32_t Client::RegionUpdated(int32_t x, int32_t y, uint32_t w, uint32_t h) {
         return reply.status;
     }
 }
+/*
+ * Autogenerated call method for 'RegionsUpdated' (id $46a64e723e7281cb)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+int32_t Client::RegionsUpdated(const std::vector<std::byte> &rects) {
+    uint32_t sentTag;
+    {
+        internals::RegionsUpdatedRequest request;
+        request.rects = rects;
+
+        const auto numBytes = bytesFor(request);
+        this->_ensureTxBuf(numBytes);
+
+        auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+        std::span<std::byte> data(packet->payload, numBytes);
+        serialize(data, request);
+        sentTag = this->_sendRequest(static_cast<uint64_t>(internals::Type::RegionsUpdated), numBytes);
+    }
+    {
+        std::span<std::byte> buf;
+        if(!this->io->receiveReply(buf)) this->_HandleError(false, "Failed to receive RPC reply");
+        if(buf.size() < sizeof(MessageHeader)) this->_HandleError(false, "Received message too small");
+        const auto hdr = reinterpret_cast<const MessageHeader *>(buf.data());
+        if(hdr->tag != sentTag) this->_HandleError(false, "Invalid tag in reply RPC packet");
+        else if(hdr->type != static_cast<uint64_t>(internals::Type::RegionsUpdated)) this->_HandleError(false, "Invalid type in reply RPC packet");
+        const auto payload = buf.subspan(offsetof(MessageHeader, payload));
+
+        internals::RegionsUpdatedResponse reply;
+        if(!deserialize(payload, reply)) this->_HandleError(false, "Failed to decode message");
+        return reply.status;
+    }
+}
 /*
  * Autogenerated call method for 'GetFramebuffer' (id $390defeeb047275d)
  * Have 0 parameter(s), 3 return(s); method is sync
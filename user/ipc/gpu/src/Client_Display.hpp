@@ -1,6 +1,6 @@
 /*
- * This RPC client stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from Display.idl for interface Display at 2021-07-08T01:00:48-0500
+ * This RPC client stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from Display.idl for interface Display at 2026-10-18T06:02:27-0500
  *
  * You may use these generated stubs directly as the RPC interface, or you can subclass it to
  * override the behavior of the function calls, or to perform some preprocessing to the data as
@@ -74,6 +74,7 @@ class DisplayClient {
         virtual int32_t SetOutputEnabled(bool enabled);
         virtual int32_t SetOutputMode(const DriverSupport::gfx::DisplayMode &mode);
         virtual int32_t RegionUpdated(int32_t x, int32_t y, uint32_t w, uint32_t h);
+        virtual int32_t RegionsUpdated(const std::vector<std::byte> &rects);
         virtual GetFramebufferReturn GetFramebuffer();
         virtual GetFramebufferInfoReturn GetFramebufferInfo();
 
@@ -3,11 +3,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <span>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <DriverSupport/gfx/Types.h>
 #include <DriverSupport/gfx/Client_Display.hpp>
@@ -41,6 +43,7 @@ class Display: public rpc::DisplayClient {
 
     public:
         using DisplayClient::RegionUpdated;
+        using DisplayClient::RegionsUpdated;
 
         [[nodiscard]] static int Alloc(const std::string_view &forestPath,
                 std::shared_ptr<Display> &outPtr);
@@ -56,6 +59,18 @@ class Display: public rpc::DisplayClient {
             return this->RegionUpdated(x, y, w, h);
         }
 
+        /**
+         * Indicates to the driver that all of the provided rectangles have been updated. This is
+         * sent as a single message, so the driver can submit all of the updates at once.
+         */
+        int32_t RegionsUpdated(const std::span<const UpdateRect> &rects) {
+            if(rects.empty()) return 0;
+
+            std::vector<std::byte> buf(rects.size_bytes());
+            memcpy(buf.data(), rects.data(), rects.size_bytes());
+            return this->RegionsUpdated(buf);
+        }
+
         /**
          * Returns the user accessible region of the framebuffer.
          */
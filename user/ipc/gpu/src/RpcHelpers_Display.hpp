@@ -1,6 +1,6 @@
 /*
- * This RPC serialization code was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from Display.idl for interface Display at 2021-07-08T01:00:48-0500
+ * This RPC serialization code was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from Display.idl for interface Display at 2026-10-18T06:02:27-0500
  *
  * The structs and methods within are used by the RPC system to serialize and deserialize the
  * arguments and return values on method calls. They work internally in the same way that encoding
@@ -97,6 +97,7 @@ enum class Type: uint64_t {
                                     SetOutputEnabled = 0xd3ddaaa17cd66af0ULL,
                                        SetOutputMode = 0xf472a05edc874b12ULL,
                                        RegionUpdated = 0xf470173c1b34148aULL,
+                                      RegionsUpdated = 0x46a64e723e7281cbULL,
                                       GetFramebuffer = 0x390defeeb047275dULL,
                                   GetFramebufferInfo = 0xb103a5bbd55c1dc9ULL,
 };
@@ -227,6 +228,37 @@ struct RegionUpdatedResponse {
     constexpr static const size_t kBlobStartOffset{8};
 };
 
+/**
+ * Request structure for method 'RegionsUpdated'
+ */
+struct RegionsUpdatedRequest {
+    std::vector<std::byte> rects;
+
+    constexpr static const size_t kElementSizes[1] {
+     8
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{8};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+/**
+ * Reply structure for method 'RegionsUpdated'
+ */
+struct RegionsUpdatedResponse {
+    int32_t status;
+
+    constexpr static const size_t kElementSizes[1] {
+     4
+    };
+    constexpr static const size_t kElementOffsets[1] {
+     0
+    };
+    constexpr static const size_t kScalarBytes{4};
+    constexpr static const size_t kBlobStartOffset{8};
+};
+
 /**
  * Request structure for method 'GetFramebuffer'
  */
@@ -612,6 +644,86 @@ inline bool deserialize(const std::span<std::byte> &in, internals::RegionUpdated
     return true;
 }
 
+inline size_t bytesFor(const internals::RegionsUpdatedRequest &x) {
+    using namespace internals;
+    size_t len = RegionsUpdatedRequest::kBlobStartOffset;
+    len += bytesFor(x.rects);
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::RegionsUpdatedRequest &x) {
+    using namespace internals;
+    uint32_t blobOff = RegionsUpdatedRequest::kBlobStartOffset;
+    {
+        const auto off = RegionsUpdatedRequest::kElementOffsets[0];
+        const auto size = RegionsUpdatedRequest::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        const uint32_t blobSz = bytesFor(x.rects);
+        const uint32_t blobDataOffset = blobOff;
+        auto blobRange = out.subspan(blobDataOffset, blobSz);
+        if(!serialize(blobRange, x.rects)) return false;
+        blobOff += blobSz;
+        memcpy(range.data(), &blobDataOffset, sizeof(blobDataOffset));
+        memcpy(range.data()+sizeof(blobDataOffset), &blobSz, sizeof(blobSz));
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::RegionsUpdatedRequest &x) {
+    using namespace internals;
+    if(in.size() < RegionsUpdatedRequest::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(RegionsUpdatedRequest::kBlobStartOffset);
+    {
+        const auto off = RegionsUpdatedRequest::kElementOffsets[0];
+        const auto size = RegionsUpdatedRequest::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        uint32_t blobSz{0}, blobDataOffset{0};
+        memcpy(&blobDataOffset, range.data(), sizeof(blobDataOffset));
+        memcpy(&blobSz, range.data()+sizeof(blobDataOffset), sizeof(blobSz));
+        auto blobRange = in.subspan(blobDataOffset, blobSz);
+       if(!deserialize(blobRange, x.rects)) {
+            HandleDecodeError("RegionsUpdatedRequest", "rects", off, blobDataOffset, blobSz);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline size_t bytesFor(const internals::RegionsUpdatedResponse &x) {
+    using namespace internals;
+    size_t len = RegionsUpdatedResponse::kBlobStartOffset;
+
+    return len;
+}
+inline bool serialize(std::span<std::byte> &out, const internals::RegionsUpdatedResponse &x) {
+    using namespace internals;
+    uint32_t blobOff = RegionsUpdatedResponse::kBlobStartOffset;
+    {
+        const auto off = RegionsUpdatedResponse::kElementOffsets[0];
+        const auto size = RegionsUpdatedResponse::kElementSizes[0];
+        auto range = out.subspan(off, size);
+        memcpy(range.data(), &x.status, range.size());
+    }
+
+    return true;
+}
+inline bool deserialize(const std::span<std::byte> &in, internals::RegionsUpdatedResponse &x) {
+    using namespace internals;
+    if(in.size() < RegionsUpdatedResponse::kScalarBytes) return false;
+    const auto blobRegion = in.subspan(RegionsUpdatedResponse::kBlobStartOffset);
+    {
+        const auto off = RegionsUpdatedResponse::kElementOffsets[0];
+        const auto size = RegionsUpdatedResponse::kElementSizes[0];
+        auto range = in.subspan(off, size);
+        if(range.empty() || range.size() != size) return false;
+        memcpy(&x.status, range.data(), range.size());
+    }
+
+    return true;
+}
+
 inline size_t bytesFor(const internals::GetFramebufferRequest &x) {
     using namespace internals;
     size_t len = GetFramebufferRequest::kBlobStartOffset;
@@ -1,6 +1,6 @@
 /*
- * This RPC server stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from Display.idl for interface Display at 2021-07-08T01:00:48-0500
+ * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from Display.idl for interface Display at 2026-10-18T06:02:27-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -102,6 +102,9 @@ bool Server::runOne(const bool block) {
         case static_cast<uint64_t>(internals::Type::RegionUpdated):
             this->_marshallRegionUpdated(*hdr, payload);
             break;
+        case static_cast<uint64_t>(internals::Type::RegionsUpdated):
+            this->_marshallRegionsUpdated(*hdr, payload);
+            break;
         case static_cast<uint64_t>(internals::Type::GetFramebuffer):
             this->_marshallGetFramebuffer(*hdr, payload);
             break;
@@ -243,6 +246,28 @@ void Server::_marshallRegionUpdated(const MessageHeader &hdr, const std::span<st
 
     this->_sendReply(hdr, numBytes);
 }
+/*
+ * Autogenerated marshalling method for 'RegionsUpdated' (id $46a64e723e7281cb)
+ * Have 1 parameter(s), 1 return(s); method is sync
+ */
+void Server::_marshallRegionsUpdated(const MessageHeader &hdr, const std::span<std::byte> &payload) {
+    internals::RegionsUpdatedRequest request;
+    if(!deserialize(payload, request)) return this->_HandleError(false, "Failed to deserialize request");
+
+    auto retVal = this->implRegionsUpdated(request.rects);
+
+    internals::RegionsUpdatedResponse reply;
+    reply.status = retVal;
+
+    const auto numBytes = bytesFor(reply);
+    this->_ensureTxBuf(numBytes);
+
+    auto packet = reinterpret_cast<MessageHeader *>(this->txBuf);
+    std::span<std::byte> data(packet->payload, numBytes);
+    if(!serialize(data, reply)) return this->_HandleError(false, "Failed to serialize reply");
+
+    this->_sendReply(hdr, numBytes);
+}
 /*
  * Autogenerated marshalling method for 'GetFramebuffer' (id $390defeeb047275d)
  * Have 0 parameter(s), 3 return(s); method is sync
@@ -1,6 +1,6 @@
 /*
- * This RPC server stub was autogenerated by idlc (version c8601c6e). DO NOT EDIT!
- * Generated from Display.idl for interface Display at 2021-07-08T01:00:48-0500
+ * This RPC server stub was autogenerated by idlc (version 8a02fc5d). DO NOT EDIT!
+ * Generated from Display.idl for interface Display at 2026-10-18T06:02:27-0500
  *
  * You should subclass this implementation and define the required abstract methods to complete
  * implementing the interface. Note that there are several helper methods available to simplify
@@ -79,6 +79,7 @@ class DisplayServer {
         virtual int32_t implSetOutputEnabled(bool enabled) = 0;
         virtual int32_t implSetOutputMode(const DriverSupport::gfx::DisplayMode &mode) = 0;
         virtual int32_t implRegionUpdated(int32_t x, int32_t y, uint32_t w, uint32_t h) = 0;
+        virtual int32_t implRegionsUpdated(const std::vector<std::byte> &rects) = 0;
         virtual GetFramebufferReturn implGetFramebuffer() = 0;
         virtual GetFramebufferInfoReturn implGetFramebufferInfo() = 0;
 
@@ -104,6 +105,7 @@ class DisplayServer {
         void _marshallSetOutputEnabled(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallSetOutputMode(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallRegionUpdated(const MessageHeader &, const std::span<std::byte> &payload);
+        void _marshallRegionsUpdated(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallGetFramebuffer(const MessageHeader &, const std::span<std::byte> &payload);
         void _marshallGetFramebufferInfo(const MessageHeader &, const std::span<std::byte> &payload);
 }; // class DisplayServer
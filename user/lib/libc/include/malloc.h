@@ -69,17 +69,28 @@ LIBC_EXPORT size_t malloc_set_footprint_limit(const size_t newLimit);
  *
  * Supported options are:
  *   Symbol            param #  default    allowed param values
- * M_TRIM_THRESHOLD     -1   2*1024*1024   any   (-1 disables)
- * M_GRANULARITY        -2     page size   any power of 2 >= page size
- * M_MMAP_THRESHOLD     -3      256*1024   any   (or 0 if no MMAP support)
+ * M_TRIM_THRESHOLD     -1           n/a   any   (accepted, but has no effect)
+ * M_GRANULARITY        -2     1024*1024   any power of 2 >= page size
+ * M_MMAP_THRESHOLD     -3      256*1024   any >= 0
+ *
+ * Allocations of at least M_MMAP_THRESHOLD bytes (that are too large for the thread caches) are
+ * placed in their own virtual memory region, which is released when they are freed. The heap is
+ * grown in increments of at least M_GRANULARITY bytes.
  */
 LIBC_EXPORT int mallopt(const int option, const int value);
 
 /**
- * Trims the malloc region, leaving at most `trim` bytes of extra space.
+ * Returns all memory cached by the calling thread to the shared free lists, so that it can be
+ * reused by other threads. The argument is ignored.
  */
 LIBC_EXPORT int malloc_trim(const size_t trim);
 
+/**
+ * Returns the number of bytes usable in the given allocation; this is at least as many as were
+ * requested when it was allocated.
+ */
+LIBC_EXPORT size_t malloc_usable_size(void *ptr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,11 @@
 // min size of buffered IO Buffers
 #define BUFSIZ                          (1024)
 
+// buffering modes for setvbuf()
+#define _IOFBF                          0
+#define _IOLBF                          1
+#define _IONBF                          2
+
 // declare some stuff to the actual symbol names
 #define	stdin	__stdinp
 #define	stdout	__stdoutp
@@ -58,6 +63,8 @@ int	 fflush(FILE *);
 int	 fgetc(FILE *);
 int	 fgetpos(FILE * __restrict, fpos_t * __restrict);
 char	*fgets(char * __restrict, int, FILE * __restrict);
+ssize_t  getdelim(char ** __restrict, size_t * __restrict, int, FILE * __restrict);
+ssize_t  getline(char ** __restrict, size_t * __restrict, FILE * __restrict);
 FILE	*fopen(const char * __restrict, const char * __restrict);
 FILE    *fdopen(int fd, const char *mode);
 
@@ -3,6 +3,8 @@
 
 #include <_libc.h>
 #include <sys/cdefs.h>
+#include <stddef.h>
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +27,10 @@ struct iovec {
 LIBC_EXPORT ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
 /// Write to the given file descriptor with vectored IO
 LIBC_EXPORT ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+/// Read from the given offset of a file with vectored IO, without changing the file position
+LIBC_EXPORT ssize_t preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+/// Write to the given offset of a file with vectored IO, without changing the file position
+LIBC_EXPORT ssize_t pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset);
 
 #ifdef __cplusplus
 }
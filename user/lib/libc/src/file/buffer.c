@@ -0,0 +1,367 @@
+/*
+ * Buffering layer for file streams.
+ *
+ * All stdio functions go through these routines; for streams that aren't buffered, they call
+ * straight through to the stream's callbacks. Callers must hold the stream's lock (see
+ * StreamLock()) if the stream is buffered.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file_private.h"
+
+/**
+ * Allocates the stream's buffer, if it doesn't have one yet.
+ */
+static int EnsureBuffer(stream_t *stream) {
+    if(stream->buf) return 0;
+
+    stream->buf = malloc(stream->bufSize);
+    if(!stream->buf) {
+        stream->error = true;
+        errno = ENOMEM;
+        return -1;
+    }
+
+    stream->bufOwned = true;
+    return 0;
+}
+
+/**
+ * Reads from the backing file into the given buffer until either the requested number of bytes
+ * have been read, or the end of the file is reached.
+ *
+ * @return Number of bytes read
+ */
+static size_t ReadDirect(stream_t *stream, char *buf, const size_t length) {
+    size_t done = 0;
+
+    while(done < length) {
+        int ret = stream->read(stream, buf + done, length - done);
+        if(ret < 0) {
+            stream->error = true;
+            break;
+        } else if(!ret) {
+            stream->eof = true;
+            break;
+        }
+
+        done += ret;
+    }
+
+    return done;
+}
+
+/**
+ * Writes the given buffer to the backing file.
+ *
+ * @return 0 on success, or EOF if the data could not be written completely
+ */
+static int WriteDirect(stream_t *stream, const char *buf, const size_t length) {
+    size_t done = 0;
+
+    while(done < length) {
+        int ret = stream->write(stream, buf + done, length - done);
+        if(ret <= 0) {
+            stream->error = true;
+            return EOF;
+        }
+
+        done += ret;
+    }
+
+    return 0;
+}
+
+/**
+ * Refills the buffer with read-ahead data.
+ *
+ * @return Number of bytes now in the buffer; zero at end of file or on error.
+ */
+static size_t Refill(stream_t *stream) {
+    if(EnsureBuffer(stream)) return 0;
+
+    stream->bufPos = stream->bufLen = 0;
+
+    int ret = stream->read(stream, stream->buf, stream->bufSize);
+    if(ret < 0) {
+        stream->error = true;
+        return 0;
+    } else if(!ret) {
+        stream->eof = true;
+        return 0;
+    }
+
+    stream->bufLen = ret;
+    return ret;
+}
+
+
+
+/**
+ * Reads data from the stream. Data is served from the buffer where possible; requests of at least
+ * the size of the buffer bypass it, once it's been drained.
+ *
+ * @return Number of bytes read; if less than requested, the end of file or error indicator is set
+ */
+size_t StreamRead(stream_t *stream, void *_buf, const size_t length) {
+    char *buf = (char *) _buf;
+    size_t done = 0;
+
+    if(!length) return 0;
+    if(!stream->read) {
+        stream->error = true;
+        errno = ENODEV;
+        return 0;
+    }
+
+    // any pushed back character comes first
+    if(stream->hasPushback) {
+        stream->hasPushback = false;
+        buf[done++] = stream->pushback;
+    }
+
+    if(!StreamIsBuffered(stream)) {
+        return done + ReadDirect(stream, buf + done, length - done);
+    }
+
+    // switching from writing to reading
+    if(stream->bufDirty && StreamFlush(stream)) {
+        return done;
+    }
+
+    while(done < length) {
+        // copy out what's in the buffer
+        const size_t avail = stream->bufLen - stream->bufPos;
+        if(avail) {
+            const size_t toCopy = (avail < (length - done)) ? avail : (length - done);
+            memcpy(buf + done, stream->buf + stream->bufPos, toCopy);
+
+            stream->bufPos += toCopy;
+            done += toCopy;
+            continue;
+        }
+
+        // large reads go directly to the caller's buffer
+        if((length - done) >= stream->bufSize) {
+            stream->bufPos = stream->bufLen = 0;
+            done += ReadDirect(stream, buf + done, length - done);
+            break;
+        }
+
+        // otherwise, read ahead
+        if(!Refill(stream)) break;
+    }
+
+    return done;
+}
+
+/**
+ * Reads a single character from the stream.
+ *
+ * @return The character read, or EOF.
+ */
+int StreamGetc(stream_t *stream) {
+    if(stream->hasPushback) {
+        stream->hasPushback = false;
+        return stream->pushback;
+    }
+
+    if(StreamIsBuffered(stream) && !stream->bufDirty && stream->bufPos < stream->bufLen) {
+        return (unsigned char) stream->buf[stream->bufPos++];
+    }
+
+    unsigned char ch;
+    if(StreamRead(stream, &ch, 1) != 1) return EOF;
+    return ch;
+}
+
+/**
+ * Writes data to the stream. Output is collected in the buffer until it's full (or for line
+ * buffered streams, a newline is written) and only then written to the backing file.
+ *
+ * @return Number of bytes written
+ */
+size_t StreamWrite(stream_t *stream, const void *_buf, const size_t length) {
+    const char *buf = (const char *) _buf;
+    size_t done = 0;
+
+    if(!length) return 0;
+    if(!stream->write) {
+        stream->error = true;
+        errno = ENODEV;
+        return 0;
+    }
+
+    if(!StreamIsBuffered(stream)) {
+        return WriteDirect(stream, buf, length) ? 0 : length;
+    }
+
+    // switching from reading to writing: move the file position back to what we've consumed
+    if(!stream->bufDirty && (stream->bufLen || stream->hasPushback)) {
+        if(StreamSync(stream)) return 0;
+    }
+
+    // large writes bypass the buffer if it's empty
+    if(!stream->bufLen && length >= stream->bufSize) {
+        return WriteDirect(stream, buf, length) ? 0 : length;
+    }
+
+    if(EnsureBuffer(stream)) return 0;
+    stream->bufDirty = true;
+
+    while(done < length) {
+        const size_t space = stream->bufSize - stream->bufLen;
+        const size_t toCopy = (space < (length - done)) ? space : (length - done);
+
+        memcpy(stream->buf + stream->bufLen, buf + done, toCopy);
+        stream->bufLen += toCopy;
+        done += toCopy;
+
+        if(stream->bufLen == stream->bufSize && StreamFlush(stream)) {
+            return done - toCopy;
+        }
+    }
+
+    if(stream->bufMode == _IOLBF && memchr(buf, '\n', length)) {
+        if(StreamFlush(stream)) return 0;
+    }
+
+    return done;
+}
+
+/**
+ * Writes out any buffered output.
+ *
+ * @return 0 on success, or EOF if the output could not be written
+ */
+int StreamFlush(stream_t *stream) {
+    if(!stream->bufDirty) return 0;
+
+    int err = WriteDirect(stream, stream->buf, stream->bufLen);
+
+    stream->bufPos = stream->bufLen = 0;
+    stream->bufDirty = false;
+
+    return err;
+}
+
+/**
+ * Synchronizes the position of the backing file with the stream position: any buffered output is
+ * written, and unread read-ahead data (and pushed back characters) are discarded, moving the file
+ * position back accordingly.
+ *
+ * @return 0 on success, or EOF on failure
+ */
+int StreamSync(stream_t *stream) {
+    if(stream->bufDirty) {
+        return StreamFlush(stream);
+    }
+
+    long unread = (stream->bufLen - stream->bufPos) + (stream->hasPushback ? 1 : 0);
+
+    stream->bufPos = stream->bufLen = 0;
+    stream->hasPushback = false;
+
+    if(unread) {
+        if(!stream->seek || stream->seek(stream, -unread, SEEK_CUR)) {
+            stream->error = true;
+            return EOF;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Seeks the stream. Seeks that land within the read-ahead data only adjust the read position in
+ * the buffer; all others discard the buffer contents and seek the backing file.
+ */
+int StreamSeek(stream_t *stream, const long offset, const int whence) {
+    long pos = offset;
+    int mode = whence;
+
+    if(!stream->seek) {
+        errno = ENODEV;
+        return -1;
+    }
+
+    stream->eof = false;
+
+    // make seeks relative to the current position absolute, since the backing file's position
+    // is different from ours
+    if(mode == SEEK_CUR) {
+        long current;
+        if(StreamTell(stream, &current)) return -1;
+
+        pos = current + offset;
+        mode = SEEK_SET;
+    }
+
+    if(StreamIsBuffered(stream)) {
+        // seeking within the read-ahead data
+        if(mode == SEEK_SET && !stream->bufDirty && stream->bufLen && stream->tell) {
+            long filePos;
+            if(!stream->tell(stream, &filePos)) {
+                const long bufStart = filePos - (long) stream->bufLen;
+
+                if(pos >= bufStart && pos <= filePos) {
+                    stream->bufPos = pos - bufStart;
+                    stream->hasPushback = false;
+                    return 0;
+                }
+            }
+        }
+
+        if(StreamFlush(stream)) return -1;
+        stream->bufPos = stream->bufLen = 0;
+    }
+
+    stream->hasPushback = false;
+    return stream->seek(stream, pos, mode);
+}
+
+/**
+ * Gets the current position of the stream: the position of the backing file, adjusted by any
+ * buffered data.
+ */
+int StreamTell(stream_t *stream, long *outPos) {
+    long pos;
+
+    if(!stream->tell) {
+        errno = ENODEV;
+        return -1;
+    }
+
+    int err = stream->tell(stream, &pos);
+    if(err < 0) return err;
+
+    if(stream->bufDirty) {
+        pos += stream->bufLen;
+    } else {
+        pos -= (stream->bufLen - stream->bufPos);
+    }
+
+    if(stream->hasPushback && pos) {
+        pos--;
+    }
+
+    *outPos = pos;
+    return 0;
+}
+
+/**
+ * Releases the stream's buffer, if we allocated it. Any buffered output is discarded.
+ */
+void StreamFreeBuffer(stream_t *stream) {
+    if(stream->bufOwned) {
+        free(stream->buf);
+    }
+
+    stream->buf = NULL;
+    stream->bufOwned = false;
+    stream->bufDirty = false;
+    stream->bufPos = stream->bufLen = 0;
+}
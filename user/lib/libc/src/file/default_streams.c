@@ -28,6 +28,13 @@ FILE *__stderrp = NULL;
 struct DebugOutStream {
     struct __libc_file_stream header;
 
+    /**
+     * Lock protecting the line buffer; this is separate from the stream lock in the header, since
+     * the stdio buffering layer holds that lock while invoking our callbacks if the stream was
+     * made buffered with setvbuf().
+     */
+    mtx_t bufLock;
+
     /// total number of bytes written to the output stream
     uint64_t bytesWritten;
 
@@ -48,18 +55,31 @@ static int DebugTell(struct __libc_file_stream *_file, long *out) {
 }
 
 /**
- * Flushes the buffered contents of the output stream.
+ * Outputs the contents of the line buffer; the caller must hold the buffer lock.
  */
-static int DebugOutFlush(struct __libc_file_stream *_file) {
-    struct DebugOutStream *file = (struct DebugOutStream *) _file;
-
+static void DebugOutFlushLocked(struct DebugOutStream *file) {
     if(file->bufUsed) {
         DbgOut(file->buf, file->bufUsed);
 
         memset(file->buf, 0, file->bufUsed);
         file->bufUsed = 0;
     }
+}
+
+/**
+ * Flushes the buffered contents of the output stream.
+ */
+static int DebugOutFlush(struct __libc_file_stream *_file) {
+    struct DebugOutStream *file = (struct DebugOutStream *) _file;
+
+    int err = mtx_lock(&file->bufLock);
+    if(err != thrd_success) {
+        return EOF;
+    }
+
+    DebugOutFlushLocked(file);
 
+    mtx_unlock(&file->bufLock);
     return 0;
 }
 
@@ -70,7 +90,7 @@ static int DebugOutFlush(struct __libc_file_stream *_file) {
 static int DebugOutPutc(struct __libc_file_stream *_file, char c) {
     struct DebugOutStream *file = (struct DebugOutStream *) _file;
 
-    int err = mtx_lock(&file->header.lock);
+    int err = mtx_lock(&file->bufLock);
     if(err != thrd_success) {
         return EOF;
     }
@@ -79,32 +99,86 @@ static int DebugOutPutc(struct __libc_file_stream *_file, char c) {
 
     // if buffer is full, flush and try again
     if(file->bufUsed == kBufLength) {
-        DebugOutFlush(_file);
+        DebugOutFlushLocked(file);
     }
     // flush if newline
     if(c == '\n') {
-        DebugOutFlush(_file);
+        DebugOutFlushLocked(file);
     }
     // otherwise, add it into the buffer
     else {
         file->buf[file->bufUsed++] = c;
     }
 
-    mtx_unlock(&file->header.lock);
+    mtx_unlock(&file->bufLock);
     return c;
 }
 
+/**
+ * Writes a run of characters to the debug out stream. This behaves the same as writing each
+ * character with DebugOutPutc(), but takes the lock only once, and copies the run into the
+ * buffer in as few pieces as possible.
+ */
+static int DebugOutWrite(struct __libc_file_stream *_file, const void *_buf, const size_t length) {
+    struct DebugOutStream *file = (struct DebugOutStream *) _file;
+    const char *buf = (const char *) _buf;
+    size_t done = 0;
+
+    int err = mtx_lock(&file->bufLock);
+    if(err != thrd_success) {
+        return EOF;
+    }
+
+    file->bytesWritten += length;
+
+    while(done < length) {
+        // find the end of the current line, if it's in this run
+        const char *newline = memchr(buf + done, '\n', length - done);
+        const size_t lineLen = newline ? (size_t) (newline - (buf + done)) : (length - done);
+
+        // copy the line into the buffer, flushing it whenever it fills up
+        for(size_t copied = 0; copied < lineLen;) {
+            if(file->bufUsed == kBufLength) {
+                DebugOutFlushLocked(file);
+            }
+
+            const size_t space = kBufLength - file->bufUsed;
+            const size_t toCopy = (space < (lineLen - copied)) ? space : (lineLen - copied);
+
+            memcpy(file->buf + file->bufUsed, buf + done + copied, toCopy);
+            file->bufUsed += toCopy;
+            copied += toCopy;
+        }
+        done += lineLen;
+
+        // flush at the end of the line; the newline itself isn't output
+        if(newline) {
+            DebugOutFlushLocked(file);
+            done++;
+        }
+    }
+
+    mtx_unlock(&file->bufLock);
+    return (int) length;
+}
+
 /**
  * Discards all data in the write buffer of the stream.
  */
 static int DebugOutPurge(struct __libc_file_stream *_file) {
     struct DebugOutStream *file = (struct DebugOutStream *) _file;
 
+    int err = mtx_lock(&file->bufLock);
+    if(err != thrd_success) {
+        return EOF;
+    }
+
     if(file->bufUsed) {
         memset(file->buf, 0, file->bufUsed);
         file->bufUsed = 0;
     }
 
+    mtx_unlock(&file->bufLock);
     return 0;
 }
 
@@ -123,7 +197,10 @@ LIBC_INTERNAL void __stdstream_init() {
     stream->header.length = sizeof(struct DebugOutStream);
     stream->header.fd = STDERR_FILENO;
 
+    if(mtx_init(&stream->bufLock, mtx_plain) != thrd_success) abort();
+
     stream->header.putc = DebugOutPutc;
+    stream->header.write = DebugOutWrite;
     stream->header.flush = DebugOutFlush;
     stream->header.purge = DebugOutPurge;
     stream->header.tell = DebugTell;
@@ -9,6 +9,14 @@
 int fclose(FILE *stream) {
     int err = 0;
 
+    // write out any buffered output
+    if(StreamIsBuffered(stream)) {
+        mtx_lock(&stream->lock);
+        err = StreamFlush(stream);
+        StreamFreeBuffer(stream);
+        mtx_unlock(&stream->lock);
+    }
+
     // unregister the FD
 #ifndef LIBC_NOTLS
     UnregisterFdStream(stream);
@@ -16,7 +24,8 @@ int fclose(FILE *stream) {
 
     // invoke the close handler
     if(stream->close) {
-        err = stream->close(stream);
+        int closeErr = stream->close(stream);
+        if(!err) err = closeErr;
     }
 
     // XXX: is it a guarantee all file streams are allocated via malloc()?
@@ -8,7 +8,10 @@
 #ifndef LIBC_FILE_FD_MAP_H
 #define LIBC_FILE_FD_MAP_H
 
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/uio.h>
 #include <_libc.h>
 #include "../file_private.h"
 
@@ -37,4 +40,21 @@ LIBC_INTERNAL int RegisterFdStream(stream_t * _Nonnull stream, bool allocateFd);
  */
 LIBC_INTERNAL int UnregisterFdStream(stream_t * _Nonnull stream);
 
+/**
+ * Validates the IO vectors passed to one of the vectored IO calls: there must be between 1 and
+ * IOV_MAX of them, and their total length must fit in an int, as the streams' IO callbacks return
+ * the number of bytes transferred as one.
+ */
+static inline bool ValidateIovec(const struct iovec * _Nullable iov, const int iovcnt) {
+    if(!iov || iovcnt <= 0 || iovcnt > IOV_MAX) return false;
+
+    size_t total = 0;
+    for(int i = 0; i < iovcnt; i++) {
+        if(__builtin_add_overflow(total, iov[i].iov_len, &total) || total > INT_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
 #endif
@@ -0,0 +1,269 @@
+/*
+ * Memory mapping of files and anonymous memory.
+ *
+ * Anonymous mappings are plain anonymous VM regions. File mappings are regions provided by the
+ * stream's `map` callback; for files on the file server, these are backed by a pager, so their
+ * contents are read in on demand as pages are first accessed.
+ *
+ * Each mapping is a separate VM region, so they can only be unmapped as a whole: munmap() fails
+ * with EINVAL unless it covers an entire mapping.
+ */
+#include "map.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <sys/mman.h>
+#include <sys/syscalls.h>
+
+/**
+ * Virtual address range in which mappings are placed, unless a fixed address is requested.
+ */
+#if defined(__i386__)
+#define kMmapRangeStart                 (0x30000000)
+#define kMmapRangeEnd                   (0x40000000)
+#elif defined(__amd64__)
+#define kMmapRangeStart                 (0x7a0000000000)
+#define kMmapRangeEnd                   (0x7c0000000000)
+#else
+#error Update file/fd/mmap.c with this arch's mapping range
+#endif
+
+/// Page size assumed for alignment checks
+#define kPageSize                       (0x1000)
+
+/**
+ * Information on a single mapping
+ */
+typedef struct mmap_entry {
+    /// next mapping
+    struct mmap_entry *next;
+
+    /// base address and length of the mapping
+    uintptr_t base;
+    size_t length;
+    /// VM region handle
+    uintptr_t region;
+
+    /// for file mappings, releases the region; if NULL, it's anonymous memory
+    int (*unmap)(const uintptr_t);
+} mmap_entry_t;
+
+/// all mappings created by mmap()
+static mmap_entry_t *gMappings = NULL;
+/// lock protecting the mapping list
+static mtx_t gMappingsLock;
+
+/**
+ * Initializes the mapping list lock.
+ */
+LIBC_INTERNAL void __libc_mmap_init() {
+    if(mtx_init(&gMappingsLock, mtx_plain) != thrd_success) abort();
+}
+
+/**
+ * Converts PROT_* flags to VM region flags.
+ */
+static uintptr_t ConvertProt(const int prot) {
+    uintptr_t flags = 0;
+
+    if(prot & PROT_READ) flags |= VM_REGION_READ;
+    if(prot & PROT_WRITE) flags |= VM_REGION_WRITE;
+    if(prot & PROT_EXEC) flags |= VM_REGION_EXEC;
+
+    return flags;
+}
+
+/**
+ * Creates the region for a file mapping.
+ *
+ * @return 0 on success, or an errno value.
+ */
+static int MapFileRegion(mmap_entry_t *entry, const int prot, const int flags, const int fd,
+        const off_t offset, const size_t length) {
+    stream_t *fp = ConvertFdToStream(fd);
+    if(!fp) {
+        return EBADF;
+    } else if(!fp->map || !fp->unmap) {
+        return ENODEV;
+    }
+
+    // changes to the mapping are never written back
+    if((flags & MAP_SHARED) && (prot & PROT_WRITE)) {
+        return ENOTSUP;
+    } else if(offset < 0 || (offset & (kPageSize - 1))) {
+        return EINVAL;
+    }
+
+    entry->unmap = fp->unmap;
+    return fp->map(fp, offset, length, prot, &entry->region, &entry->length);
+}
+
+/**
+ * Creates the region for an anonymous mapping.
+ *
+ * @return 0 on success, or an errno value.
+ */
+static int MapAnonRegion(mmap_entry_t *entry, const int prot, const size_t length) {
+    int err;
+
+    if(length > (SIZE_MAX - kPageSize)) {
+        return ENOMEM;
+    }
+
+    entry->length = (length + kPageSize - 1) & ~(kPageSize - 1);
+
+    err = AllocVirtualAnonRegion(entry->length, ConvertProt(prot), &entry->region);
+    return err ? ENOMEM : 0;
+}
+
+/**
+ * Releases a mapping's region, after it's been unmapped.
+ */
+static void ReleaseRegion(mmap_entry_t *entry) {
+    if(entry->unmap) {
+        entry->unmap(entry->region);
+    } else {
+        DeallocVirtualRegion(entry->region);
+    }
+}
+
+
+
+/**
+ * Maps a file, or anonymous memory, into the address space.
+ */
+void *mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
+    int err;
+
+    // validate args
+    const int sharing = flags & (MAP_SHARED | MAP_PRIVATE);
+    if(!length || sharing == 0 || sharing == (MAP_SHARED | MAP_PRIVATE)) {
+        errno = EINVAL;
+        return MAP_FAILED;
+    } else if((flags & MAP_FIXED) && ((uintptr_t) addr & (kPageSize - 1))) {
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+
+    mmap_entry_t *entry = calloc(1, sizeof(*entry));
+    if(!entry) {
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+
+    // create the region
+    if(flags & MAP_ANON) {
+        err = MapAnonRegion(entry, prot, length);
+    } else {
+        err = MapFileRegion(entry, prot, flags, fd, offset, length);
+    }
+
+    if(err) {
+        free(entry);
+        errno = err;
+        return MAP_FAILED;
+    }
+
+    // then map it, either at the fixed address or anywhere in the mapping range
+    uintptr_t range[2] = {kMmapRangeStart, kMmapRangeEnd};
+    if(flags & MAP_FIXED) {
+        range[0] = (uintptr_t) addr;
+        range[1] = 0;
+    }
+
+    err = MapVirtualRegionRange(entry->region, range, entry->length, ConvertProt(prot),
+            &entry->base);
+    if(err) {
+        ReleaseRegion(entry);
+        free(entry);
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+
+    // record it
+    mtx_lock(&gMappingsLock);
+    entry->next = gMappings;
+    gMappings = entry;
+    mtx_unlock(&gMappingsLock);
+
+    return (void *) entry->base;
+}
+
+/**
+ * Removes a mapping created by mmap(). Only whole mappings can be removed; the length, rounded up
+ * to the page size, must be that of the mapping.
+ */
+int munmap(void *addr, size_t length) {
+    int err;
+
+    if(!length || length > (SIZE_MAX - kPageSize)) {
+        errno = EINVAL;
+        return -1;
+    }
+    const size_t pageLength = (length + kPageSize - 1) & ~(kPageSize - 1);
+
+    mtx_lock(&gMappingsLock);
+
+    mmap_entry_t **prev = &gMappings, *entry = gMappings;
+    while(entry && entry->base != (uintptr_t) addr) {
+        prev = &entry->next;
+        entry = entry->next;
+    }
+
+    if(!entry || pageLength != entry->length) {
+        mtx_unlock(&gMappingsLock);
+        errno = EINVAL;
+        return -1;
+    }
+
+    // unmap the region; the entry is only removed if that succeeded, since it's still mapped
+    err = UnmapVirtualRegion(entry->region);
+    if(err) {
+        mtx_unlock(&gMappingsLock);
+        errno = EINVAL;
+        return -1;
+    }
+
+    *prev = entry->next;
+    mtx_unlock(&gMappingsLock);
+
+    // then release it
+    ReleaseRegion(entry);
+    free(entry);
+
+    return 0;
+}
+
+/**
+ * Synchronizes a mapping with its backing file. Mappings are never written back, so this only
+ * validates that the range is mapped.
+ */
+int msync(void *addr, size_t length, int flags) {
+    const uintptr_t start = (uintptr_t) addr;
+
+    if((start & (kPageSize - 1)) || ((flags & MS_ASYNC) && (flags & MS_SYNC))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mtx_lock(&gMappingsLock);
+
+    bool found = false;
+    for(mmap_entry_t *entry = gMappings; entry; entry = entry->next) {
+        if(start >= entry->base && (start - entry->base) <= entry->length &&
+                length <= (entry->length - (start - entry->base))) {
+            found = true;
+            break;
+        }
+    }
+
+    mtx_unlock(&gMappingsLock);
+
+    if(!found) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
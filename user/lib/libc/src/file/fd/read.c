@@ -16,9 +16,16 @@ ssize_t read(int filedes, void *buf, size_t nbyte) {
         return -1 ;
     }
 
-    // perform read
+    // perform read, after writing out or discarding anything buffered by stdio
     if(fp->read) {
-        return fp->read(fp, buf, nbyte);
+        StreamLock(fp);
+        ssize_t ret = StreamSync(fp);
+        if(!ret) {
+            ret = fp->read(fp, buf, nbyte);
+        }
+        StreamUnlock(fp);
+
+        return ret;
     } else {
         errno = ENODEV;
         return -1;
@@ -26,7 +33,11 @@ ssize_t read(int filedes, void *buf, size_t nbyte) {
 }
 
 /**
- * Performs vectored IO to read from the file descriptor
+ * Performs vectored IO to read from the file descriptor.
+ *
+ * If the stream supports positional IO, all buffers are read with a single call, starting at the
+ * current file position, which is then advanced; otherwise, they're read one by one until a short
+ * read.
  */
 ssize_t readv(int filedes, const struct iovec *iov, int iovcnt) {
     // get the file descriptor
@@ -34,9 +45,92 @@ ssize_t readv(int filedes, const struct iovec *iov, int iovcnt) {
     if(!fp) {
         errno = EBADF;
         return -1;
+    } else if(!ValidateIovec(iov, iovcnt)) {
+        errno = EINVAL;
+        return -1;
+    } else if(!fp->read) {
+        errno = ENODEV;
+        return -1;
+    }
+
+    StreamLock(fp);
+
+    ssize_t ret = StreamSync(fp);
+    if(ret) goto done;
+
+    // read all buffers at once
+    if(fp->preadv && fp->tell && fp->seek) {
+        long pos;
+        ret = fp->tell(fp, &pos);
+        if(ret) goto done;
+
+        ret = fp->preadv(fp, iov, iovcnt, pos);
+        if(ret > 0 && fp->seek(fp, ret, SEEK_CUR)) {
+            ret = -1;
+        }
+    }
+    // read each of them in turn
+    else {
+        ret = 0;
+
+        for(int i = 0; i < iovcnt; i++) {
+            if(!iov[i].iov_len) continue;
+
+            const int err = fp->read(fp, iov[i].iov_base, iov[i].iov_len);
+            if(err < 0) {
+                if(!ret) ret = err;
+                break;
+            }
+
+            ret += err;
+            if((size_t) err < iov[i].iov_len) break;
+        }
+    }
+
+done:;
+    StreamUnlock(fp);
+
+    if(ret < 0) {
+        errno = EIO;
+        return -1;
+    }
+    return ret;
+}
+
+/**
+ * Reads into the buffers, starting at the given offset; the file position is not changed.
+ */
+ssize_t preadv(int filedes, const struct iovec *iov, int iovcnt, off_t offset) {
+    // get the file descriptor
+    stream_t *fp = ConvertFdToStream(filedes);
+    if(!fp) {
+        errno = EBADF;
+        return -1;
+    } else if(!ValidateIovec(iov, iovcnt) || offset < 0) {
+        errno = EINVAL;
+        return -1;
+    } else if(!fp->preadv) {
+        errno = fp->read ? ESPIPE : ENODEV;
+        return -1;
+    }
+
+    // this neither uses nor changes the stream position, so needn't sync with the stdio buffer
+    const int ret = fp->preadv(fp, iov, iovcnt, offset);
+    if(ret < 0) {
+        errno = EIO;
+        return -1;
     }
+    return ret;
+}
+
+/**
+ * Reads from the given offset of the file; the file position is not changed.
+ */
+ssize_t pread(int filedes, void *buf, size_t nbyte, off_t offset) {
+    const struct iovec iov = {
+        .iov_base = buf,
+        .iov_len = nbyte,
+    };
 
-    // TODO: implement
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
-    return -1;
+    return preadv(filedes, &iov, 1, offset);
 }
@@ -16,9 +16,16 @@ ssize_t write(int filedes, const void *buf, size_t nbyte) {
         return -1 ;
     }
 
-    // perform write
+    // perform write, after writing out or discarding anything buffered by stdio
     if(fp->write) {
-        return fp->write(fp, buf, nbyte);
+        StreamLock(fp);
+        ssize_t ret = StreamSync(fp);
+        if(!ret) {
+            ret = fp->write(fp, buf, nbyte);
+        }
+        StreamUnlock(fp);
+
+        return ret;
     } else {
         errno = ENODEV;
         return -1;
@@ -26,7 +33,8 @@ ssize_t write(int filedes, const void *buf, size_t nbyte) {
 }
 
 /**
- * Performs vectored IO to the file descriptor given by `filedes`.
+ * Performs vectored IO to the file descriptor given by `filedes`. Each buffer is written in turn,
+ * until one of them is written only partially.
  */
 ssize_t writev(int filedes, const struct iovec *iov, int iovcnt) {
     // get the file descriptor
@@ -34,9 +42,69 @@ ssize_t writev(int filedes, const struct iovec *iov, int iovcnt) {
     if(!fp) {
         errno = EBADF;
         return -1;
+    } else if(!ValidateIovec(iov, iovcnt)) {
+        errno = EINVAL;
+        return -1;
+    } else if(!fp->write) {
+        errno = ENODEV;
+        return -1;
     }
 
-    // TODO: implement
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
+    StreamLock(fp);
+
+    ssize_t ret = StreamSync(fp);
+    if(!ret) {
+        for(int i = 0; i < iovcnt; i++) {
+            if(!iov[i].iov_len) continue;
+
+            const int err = fp->write(fp, iov[i].iov_base, iov[i].iov_len);
+            if(err < 0) {
+                if(!ret) ret = err;
+                break;
+            }
+
+            ret += err;
+            if((size_t) err < iov[i].iov_len) break;
+        }
+    }
+
+    StreamUnlock(fp);
+
+    if(ret < 0) {
+        errno = EIO;
+        return -1;
+    }
+    return ret;
+}
+
+/**
+ * Writes the buffers to the given offset of the file, without changing the file position.
+ *
+ * None of the stream types support positional writes, so this always fails.
+ */
+ssize_t pwritev(int filedes, const struct iovec *iov, int iovcnt, off_t offset) {
+    // get the file descriptor
+    stream_t *fp = ConvertFdToStream(filedes);
+    if(!fp) {
+        errno = EBADF;
+        return -1;
+    } else if(!ValidateIovec(iov, iovcnt) || offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    errno = fp->write ? ESPIPE : ENODEV;
     return -1;
 }
+
+/**
+ * Writes to the given offset of the file, without changing the file position.
+ */
+ssize_t pwrite(int filedes, const void *buf, size_t nbyte, off_t offset) {
+    const struct iovec iov = {
+        .iov_base = (void *) buf,
+        .iov_len = nbyte,
+    };
+
+    return pwritev(filedes, &iov, 1, offset);
+}
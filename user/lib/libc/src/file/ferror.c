@@ -7,15 +7,22 @@
  * Test the end-of-file indicator of the given file.
  */
 int feof(FILE *stream) {
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
-    return 0;
+    return stream->eof;
 }
 
 /**
  * Tests the error indicator of the given file.
  */
 int ferror(FILE *stream) {
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
-    return 0;
+    return stream->error;
 }
 
+/**
+ * Clears the end-of-file and error indicators of the given file.
+ */
+void clearerr(FILE *stream) {
+    StreamLock(stream);
+    stream->eof = false;
+    stream->error = false;
+    StreamUnlock(stream);
+}
@@ -3,21 +3,51 @@
 #include "file_private.h"
 
 /**
- * Flushes all output buffers in the given file pointer.
+ * Flushes all output buffers in the given file pointer. For input streams, any read-ahead data is
+ * discarded, and the position of the underlying file set to that of the stream.
  */
 int fflush(FILE *file) {
+    int err = 0;
+
     // if null, we should flush ALL streams
     if(!file) {
         return -1;
     }
 
     // otherwise, just flush this stream
-    return file->flush(file);
+    StreamLock(file);
+
+    if(StreamIsBuffered(file)) {
+        err = StreamSync(file);
+    }
+    if(!err && file->flush) {
+        err = file->flush(file);
+    }
+
+    StreamUnlock(file);
+    return err;
 }
 
 /**
  * Purges all input and output buffers of the given file, discarding any unsent/unread data.
  */
 int fpurge(FILE *file) {
-    return file->purge(file);
+    int err = 0;
+
+    StreamLock(file);
+
+    if(StreamIsBuffered(file)) {
+        // discard read-ahead data the same way as flushing does, but drop the output
+        file->bufDirty = false;
+        file->bufPos = file->bufLen = 0;
+        err = StreamSync(file);
+    }
+    file->hasPushback = false;
+
+    if(!err && file->purge) {
+        err = file->purge(file);
+    }
+
+    StreamUnlock(file);
+    return err;
 }
@@ -0,0 +1,94 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_private.h"
+
+/**
+ * Reads a line (including the trailing newline) from the stream, but no more than `size - 1`
+ * characters. The string is always NUL terminated.
+ *
+ * @return The buffer, or NULL if no characters were read before reaching end of file or an error
+ */
+char *fgets(char *restrict str, int size, FILE *restrict stream) {
+    int i = 0;
+
+    if(size <= 0) return NULL;
+
+    StreamLock(stream);
+
+    while(i < (size - 1)) {
+        const int ch = StreamGetc(stream);
+        if(ch == EOF) break;
+
+        str[i++] = ch;
+        if(ch == '\n') break;
+    }
+
+    StreamUnlock(stream);
+
+    if(!i) return NULL;
+
+    str[i] = '\0';
+    return str;
+}
+
+/**
+ * Reads from the stream until the delimiter is found (which is included in the output) or the end
+ * of the file is reached. The line buffer is grown as needed.
+ *
+ * @return Number of characters read, or -1 on error or if at end of file
+ */
+ssize_t getdelim(char **restrict linePtr, size_t *restrict lineCap, int delim,
+        FILE *restrict stream) {
+    size_t len = 0;
+
+    if(!linePtr || !lineCap) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if(!*linePtr || !*lineCap) {
+        *lineCap = 128;
+        *linePtr = realloc(*linePtr, *lineCap);
+        if(!*linePtr) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    StreamLock(stream);
+
+    while(1) {
+        const int ch = StreamGetc(stream);
+        if(ch == EOF) break;
+
+        // grow buffer (leaving space for the terminator)
+        if(len + 2 > *lineCap) {
+            char *newLine = realloc(*linePtr, *lineCap * 2);
+            if(!newLine) {
+                StreamUnlock(stream);
+                errno = ENOMEM;
+                return -1;
+            }
+
+            *linePtr = newLine;
+            *lineCap *= 2;
+        }
+
+        (*linePtr)[len++] = ch;
+        if(ch == delim) break;
+    }
+
+    StreamUnlock(stream);
+
+    (*linePtr)[len] = '\0';
+    return len ? (ssize_t) len : -1;
+}
+
+/**
+ * Reads a line from the stream; the newline is included in the output.
+ */
+ssize_t getline(char **restrict linePtr, size_t *restrict lineCap, FILE *restrict stream) {
+    return getdelim(linePtr, lineCap, '\n', stream);
+}
@@ -1,8 +1,13 @@
 #ifndef FILE_FILE_PRIVATE_H
 #define FILE_FILE_PRIVATE_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <threads.h>
+#include <_libc.h>
 
 /**
  * Definition for the base file structure.
@@ -12,6 +17,12 @@
  * structure beyond this basic "header."
  *
  * Any functions that aren't implemented can be left as NULL; they will fail with an ENODEV error.
+ *
+ * Streams that implement `read` and/or `write` may opt into buffering by setting `bufSize` to a
+ * nonzero value; the stdio functions then go through a buffer of that size (allocated on first
+ * use) and only invoke `read` and `write` with large requests. The buffer holds either read-ahead
+ * data or unwritten output, never both; the `tell` callback returns the position of the backing
+ * file, which is after any read-ahead data, and before any unwritten output.
  */
 typedef struct __libc_file_stream {
     /// length of the whole struct
@@ -41,6 +52,75 @@ typedef struct __libc_file_stream {
     int (*write)(struct __libc_file_stream *, const void *, const size_t);
     /// reads up to the given number of bytes from the file
     int (*read)(struct __libc_file_stream *, void *, const size_t);
+    /**
+     * Reads into each of the buffers in turn, starting at the given offset of the file; this
+     * doesn't change the file position. Used to implement pread() and friends; streams that don't
+     * implement it don't support positional IO.
+     */
+    int (*preadv)(struct __libc_file_stream *, const struct iovec *, const int, const uint64_t);
+
+    /**
+     * Creates a VM region backed by the given range of the file, with the given protection
+     * (PROT_*) flags. On success, the region handle and its length (rounded up to a multiple of
+     * the page size) are written out; the caller maps the region, and releases it with `unmap`.
+     *
+     * @return 0 on success, or an errno value.
+     */
+    int (*map)(struct __libc_file_stream *, const uint64_t, const size_t, const int, uintptr_t *,
+            size_t *);
+    /**
+     * Releases a region created by `map`, once it's been unmapped. This may be invoked after the
+     * stream has been closed, so it isn't passed the stream.
+     */
+    int (*unmap)(const uintptr_t);
+
+    /// buffering mode (_IOFBF, _IOLBF or _IONBF)
+    int bufMode;
+    /// size of the buffer; if zero, the stream is unbuffered
+    size_t bufSize;
+    /// buffer, either allocated on first use or provided via setvbuf()
+    char *buf;
+    /// whether the buffer was allocated by us, and must be freed
+    bool bufOwned;
+    /// whether the buffer holds unwritten output (rather than read-ahead data)
+    bool bufDirty;
+    /// offset of the next byte to be read from the buffer
+    size_t bufPos;
+    /// number of valid bytes in the buffer
+    size_t bufLen;
+
+    /// whether a character was pushed back by ungetc()
+    bool hasPushback;
+    /// the character pushed back
+    unsigned char pushback;
+
+    /// end of file indicator
+    bool eof;
+    /// error indicator
+    bool error;
 } stream_t;
 
+/// Whether IO on the stream goes through its buffer
+static inline bool StreamIsBuffered(const stream_t *stream) {
+    return stream->bufSize && stream->bufMode != _IONBF && (stream->read || stream->write);
+}
+
+/// Locks the stream, if it's buffered; unbuffered streams do their own locking, if any
+static inline void StreamLock(stream_t *stream) {
+    if(StreamIsBuffered(stream)) mtx_lock(&stream->lock);
+}
+/// Unlocks a stream previously locked with StreamLock()
+static inline void StreamUnlock(stream_t *stream) {
+    if(StreamIsBuffered(stream)) mtx_unlock(&stream->lock);
+}
+
+LIBC_INTERNAL size_t StreamRead(stream_t *stream, void *buf, const size_t length);
+LIBC_INTERNAL size_t StreamWrite(stream_t *stream, const void *buf, const size_t length);
+LIBC_INTERNAL int StreamGetc(stream_t *stream);
+LIBC_INTERNAL int StreamFlush(stream_t *stream);
+LIBC_INTERNAL int StreamSync(stream_t *stream);
+LIBC_INTERNAL int StreamSeek(stream_t *stream, const long offset, const int whence);
+LIBC_INTERNAL int StreamTell(stream_t *stream, long *outPos);
+LIBC_INTERNAL void StreamFreeBuffer(stream_t *stream);
+
 #endif
@@ -9,11 +9,21 @@
 #include <sys/syscalls.h>
 
 /**
- * Printf callback that writes to the given stream.
+ * Printf callback that writes a run of characters to the given stream.
+ *
+ * Streams that can write blobs of data get the entire run at once; otherwise, we fall back to
+ * writing it one character at a time.
  */
-static void _WriteStreamCallback(char ch, void *arg) {
+static void _WriteStreamCallback(const char *chunk, size_t length, void *arg) {
     FILE *stream = (FILE *) arg;
-    fputc(ch, stream);
+
+    if(stream->write) {
+        fwrite(chunk, 1, length, stream);
+    } else {
+        for(size_t i = 0; i < length; i++) {
+            fputc(chunk[i], stream);
+        }
+    }
 }
 
 /**
@@ -22,7 +32,7 @@ static void _WriteStreamCallback(char ch, void *arg) {
 int vfprintf(FILE *stream, const char *format, va_list arg) {
     if(!stream) return -1;
 
-    return fctvprintf(_WriteStreamCallback, stream, format, arg);
+    return vchunkprintf(_WriteStreamCallback, stream, format, arg);
 }
 
 /**
@@ -3,30 +3,30 @@
 #include <errno.h>
 #include "file_private.h"
 
+/**
+ * Reads `nitems` items of `size` bytes each from the stream.
+ *
+ * @return Number of complete items read
+ */
 size_t fread(void *restrict ptr, size_t size, size_t nitems, FILE *restrict stream) {
-    if(stream->read) {
-        return stream->read(stream, ptr, (size * nitems));
-    }
+    if(!size || !nitems) return 0;
+
+    StreamLock(stream);
+    const size_t read = StreamRead(stream, ptr, (size * nitems));
+    StreamUnlock(stream);
 
-    errno = ENODEV;
-    return -1;
+    return read / size;
 }
 
 /**
  * Read a single character from the file.
  */
 int fgetc(FILE *stream) {
-    char ch;
-
-    if(stream->read) {
-        int s = stream->read(stream, &ch, sizeof ch);
-        if(s > 0) return EOF;
-
-        return ch;
-    }
+    StreamLock(stream);
+    int ch = StreamGetc(stream);
+    StreamUnlock(stream);
 
-    errno = ENODEV;
-    return EOF;
+    return ch;
 }
 
 int getc(FILE *stream) {
@@ -34,9 +34,31 @@ int getc(FILE *stream) {
 }
 
 /**
- * Pushes a character back on the stream's read queue, if possible.
+ * Pushes a character back on the stream's read queue, if possible. Only a single character of
+ * push back is guaranteed.
  */
 int ungetc(int c, FILE *stream) {
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
-    return EOF;
+    if(c == EOF) return EOF;
+
+    StreamLock(stream);
+
+    // if the character was just read from the buffer, step back
+    if(StreamIsBuffered(stream) && !stream->hasPushback && !stream->bufDirty &&
+            stream->bufPos && stream->buf[stream->bufPos - 1] == (char) c) {
+        stream->bufPos--;
+    }
+    // otherwise, we have a single character of push back space
+    else if(!stream->hasPushback) {
+        stream->hasPushback = true;
+        stream->pushback = c;
+    } else {
+        c = EOF;
+    }
+
+    if(c != EOF) {
+        stream->eof = false;
+    }
+
+    StreamUnlock(stream);
+    return (c == EOF) ? EOF : (unsigned char) c;
 }
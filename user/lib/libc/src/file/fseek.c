@@ -4,57 +4,48 @@
 #include "file_private.h"
 
 int fseek(FILE *stream, long offset, int whence) {
-    if(stream->seek) {
-        return stream->seek(stream, offset, whence);
-    }
+    StreamLock(stream);
+    int err = StreamSeek(stream, offset, whence);
+    StreamUnlock(stream);
 
-    errno = ENODEV;
-    return -1;
+    return err;
 }
 
 // XXX: this was simply copied from fseek; is this going to cause any problems?
 int fseeko(FILE *stream, off_t offset, int whence) {
-    if(stream->seek) {
-        return stream->seek(stream, offset, whence);
-    }
-
-    errno = ENODEV;
-    return -1;
+    return fseek(stream, offset, whence);
 }
 
 int fsetpos(FILE *stream, const fpos_t *pos) {
-    fprintf(stderr, "%s unimplemented\n", __PRETTY_FUNCTION__);
-    return -1;
+    return fseek(stream, *pos, SEEK_SET);
+}
+
+int fgetpos(FILE *restrict stream, fpos_t *restrict pos) {
+    long ret = ftell(stream);
+    if(ret < 0) return -1;
+
+    *pos = ret;
+    return 0;
+}
+
+void rewind(FILE *stream) {
+    fseek(stream, 0, SEEK_SET);
+
+    StreamLock(stream);
+    stream->error = false;
+    StreamUnlock(stream);
 }
 
 long ftell(FILE *stream) {
-    if(stream->tell) {
-        long ret = 0;
-        int err = stream->tell(stream, &ret);
-
-        if(err >= 0) {
-            return ret;
-        } else {
-            return err;
-        }
-    }
-
-    errno = ENODEV;
-    return -1;
+    long ret = 0;
+
+    StreamLock(stream);
+    int err = StreamTell(stream, &ret);
+    StreamUnlock(stream);
+
+    return (err < 0) ? err : ret;
 }
 
 off_t ftello(FILE *stream) {
-    if(stream->tell) {
-        long ret = 0;
-        int err = stream->tell(stream, &ret);
-
-        if(err >= 0) {
-            return ret;
-        } else {
-            return err;
-        }
-    }
-
-    errno = ENODEV;
-    return -1;
+    return ftell(stream);
 }
@@ -1,13 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 #include "file_private.h"
 
 /**
  * Writes a character to the file.
  */
 int fputc(int ch, FILE *stream) {
-    if(stream->putc) {
+    if(StreamIsBuffered(stream)) {
+        const unsigned char c = ch;
+
+        StreamLock(stream);
+        const size_t written = StreamWrite(stream, &c, 1);
+        StreamUnlock(stream);
+
+        return written ? c : EOF;
+    }
+    else if(stream->putc) {
         return stream->putc(stream, ch);
     } 
     // XXX: should we keep this emulation?
@@ -29,6 +39,16 @@ int putc(int ch, FILE *f) {
 int fputs(const char *str, FILE *stream) {
     int i = 0, err;
 
+    if(StreamIsBuffered(stream)) {
+        const size_t len = strlen(str);
+
+        StreamLock(stream);
+        const size_t written = StreamWrite(stream, str, len);
+        StreamUnlock(stream);
+
+        return (written == len) ? (int) len : EOF;
+    }
+
     while(*str) {
         err = fputc(*str++, stream);
         if(err < 0) return err;
@@ -39,13 +59,16 @@ int fputs(const char *str, FILE *stream) {
 }
 
 /**
- * Calls the device's write implementation.
+ * Writes `nitems` items of `size` bytes each to the stream.
+ *
+ * @return Number of complete items written
  */
 size_t fwrite(const void *restrict ptr, size_t size, size_t nitems, FILE *restrict stream) {
-    if(stream->write) {
-        return stream->write(stream, ptr, (size * nitems));
-    }
+    if(!size || !nitems) return 0;
 
-    errno = ENODEV;
-    return -1;
+    StreamLock(stream);
+    const size_t written = StreamWrite(stream, ptr, (size * nitems));
+    StreamUnlock(stream);
+
+    return written / size;
 }
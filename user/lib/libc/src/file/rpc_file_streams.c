@@ -2,12 +2,15 @@
 #include "file_private.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <sys/syscalls.h>
 #include <rpc/file.h>
 
@@ -37,35 +40,37 @@ static int RpcFileGetPos(struct __libc_file_stream *_file, long *out) {
 }
 
 /**
- * Seeks the file stream.
+ * Seeks the file stream. The resulting position is clamped to the bounds of the file.
  */
 static int RpcFileSeek(struct __libc_file_stream *_file, const long off, const int whence) {
     struct RpcFileStream *file = (struct RpcFileStream *) _file;
+    int64_t pos;
 
     switch(whence) {
         case SEEK_SET:
-            if(off < file->length) file->position = off;
-            else file->position = file->length;
-            return 0;
-
+            pos = off;
+            break;
         case SEEK_CUR:
-            file->position += off;
-            if(off > file->length) file->position = file->length;
-            return 0;
-
+            pos = (int64_t) file->position + off;
+            break;
         case SEEK_END:
-            if(off < file->length) file->position = file->length - off;
-            else file->position = 0;
-            return 0;
+            pos = (int64_t) file->length + off;
+            break;
 
         // should never get this
         default:
             return -1;
     }
+
+    if(pos < 0) pos = 0;
+    else if(pos > (int64_t) file->length) pos = file->length;
+
+    file->position = pos;
+    return 0;
 }
 
 /**
- * Empty implementations of flush/purge since we do not cache anything.
+ * Empty implementations of flush/purge; all buffering is done by the stdio layer.
  */
 static int RpcFileFlushPurgeNoOp(struct __libc_file_stream *file) {
     return 0;
@@ -85,6 +90,77 @@ static int RpcFileRead(struct __libc_file_stream *_file, void *buf, const size_t
     return err;
 }
 
+/**
+ * Reads into multiple buffers from the given offset. Each buffer is a separate segment of a
+ * scatter read, so that as few requests as possible are made.
+ */
+static int RpcFilePreadv(struct __libc_file_stream *_file, const struct iovec *iov,
+        const int iovcnt, const uint64_t offset) {
+    int err;
+    struct RpcFileStream *file = (struct RpcFileStream *) _file;
+
+    FileReadSegment_t segments[IOV_MAX];
+    uint64_t segmentOff = offset;
+
+    for(int i = 0; i < iovcnt; i++) {
+        segments[i].offset = segmentOff;
+        segments[i].length = iov[i].iov_len;
+        segments[i].buf = iov[i].iov_base;
+
+        segmentOff += iov[i].iov_len;
+    }
+
+    err = FileReadScatter(file->remoteHandle, segments, iovcnt);
+    if(err) {
+        return err;
+    }
+
+    // total up the bytes read, up to the first short segment
+    int total = 0;
+    for(int i = 0; i < iovcnt; i++) {
+        total += segments[i].bytesRead;
+        if(segments[i].bytesRead < segments[i].length) break;
+    }
+
+    return total;
+}
+
+/**
+ * Asks the file server to create a region backed by part of the file.
+ */
+static int RpcFileMap(struct __libc_file_stream *_file, const uint64_t offset,
+        const size_t length, const int prot, uintptr_t *outRegion, size_t *outLength) {
+    int err;
+    struct RpcFileStream *file = (struct RpcFileStream *) _file;
+
+    uintptr_t flags = 0;
+    if(prot & PROT_READ) flags |= FILE_MAP_READ;
+    if(prot & PROT_WRITE) flags |= FILE_MAP_WRITE;
+    if(prot & PROT_EXEC) flags |= FILE_MAP_EXEC;
+
+    err = FileMap(file->remoteHandle, offset, length, flags, outRegion, outLength);
+    if(!err) {
+        return 0;
+    }
+
+    // server doesn't support mapping files
+    if(err == -2) {
+        return ENODEV;
+    }
+    // server returned an errno value (rather than one of its own error codes)
+    else if(err < -4 && err > -4096) {
+        return -err;
+    }
+    return EIO;
+}
+
+/**
+ * Releases a region created by RpcFileMap.
+ */
+static int RpcFileUnmap(const uintptr_t region) {
+    return FileUnmap(region) ? EINVAL : 0;
+}
+
 /**
  * Closes an RPC file.
  */
@@ -128,6 +204,10 @@ LIBC_INTERNAL FILE *__libc_rpc_file_open(const char *path, const char *mode) {
 
     // create an RPC file object
     struct RpcFileStream *stream = (struct RpcFileStream *) calloc(sizeof(struct RpcFileStream), 1);
+    if(!stream) {
+        FileClose(handle);
+        return NULL;
+    }
 
     stream->remoteHandle = handle;
     stream->length = length;
@@ -139,6 +219,15 @@ LIBC_INTERNAL FILE *__libc_rpc_file_open(const char *path, const char *mode) {
     stream->h.seek = RpcFileSeek;
     stream->h.tell = RpcFileGetPos;
     stream->h.read = RpcFileRead;
+    stream->h.preadv = RpcFilePreadv;
+    stream->h.map = RpcFileMap;
+    stream->h.unmap = RpcFileUnmap;
+
+    // reads are buffered, and read ahead as much as the server can return in one message
+    const size_t ioSize = FileGetMaxIoSize();
+
+    stream->h.bufMode = _IOFBF;
+    stream->h.bufSize = (ioSize > BUFSIZ) ? ioSize : BUFSIZ;
 
     // seek it to end if needed
     if(seekToEnd) {
@@ -0,0 +1,50 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "file_private.h"
+
+/**
+ * Changes the buffering mode of the stream; this must be called before any IO is performed on it.
+ *
+ * @param buf Buffer to use; if NULL, it's allocated on first use
+ * @param mode Buffering mode, one of _IOFBF, _IOLBF or _IONBF
+ * @param size Size of the buffer; if zero, the stream's current buffer size is kept.
+ */
+int setvbuf(FILE *restrict stream, char *restrict buf, int mode, size_t size) {
+    if(mode != _IOFBF && mode != _IOLBF && mode != _IONBF) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mtx_lock(&stream->lock);
+
+    // get rid of the old buffer
+    if(StreamIsBuffered(stream)) {
+        StreamSync(stream);
+    }
+    StreamFreeBuffer(stream);
+
+    // then set up the new one
+    stream->bufMode = mode;
+
+    if(mode != _IONBF) {
+        if(buf && size) {
+            stream->buf = buf;
+        }
+        if(size) {
+            stream->bufSize = size;
+        } else if(!stream->bufSize) {
+            stream->bufSize = BUFSIZ;
+        }
+    }
+
+    mtx_unlock(&stream->lock);
+    return 0;
+}
+
+/**
+ * Sets the stream's buffer (which must be BUFSIZ bytes) or if NULL, makes it unbuffered.
+ */
+void setbuf(FILE *restrict stream, char *restrict buf) {
+    setvbuf(stream, buf, buf ? _IOFBF : _IONBF, BUFSIZ);
+}
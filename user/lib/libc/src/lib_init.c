@@ -1,9 +1,14 @@
 #include "threads/thread_info.h"
 #include "file/fd/map.h"
+#include "mem/malloc_private.h"
 #include "LaunchInfo.h"
 
 extern void __stdstream_init();
+#if defined(__amd64__)
+extern void __libc_cpu_init();
+#endif
 extern void __libc_tss_init();
+extern void __libc_mmap_init();
 
 /// memory address of the task's info page
 kush_task_launchinfo_t *__libc_task_info = NULL;
@@ -12,15 +17,24 @@ kush_task_launchinfo_t *__libc_task_info = NULL;
  * General C library initialization
  */
 void __libc_init() {
+    // select the string routines to use
+#if defined(__amd64__)
+    __libc_cpu_init();
+#endif
+
     __libc_thread_init();
 #ifndef LIBC_NOTLS
     __libc_tss_init();
+
+    // TLS is available from here on, so thread caches can be used
+    __libc_malloc_init();
 #endif
 
     // set up input/output streams
 #ifndef LIBC_NOTLS
     InitFdToStreamMap();
 #endif
+    __libc_mmap_init();
     __stdstream_init();
 }
 
@@ -0,0 +1,164 @@
+/*
+ * Central free lists: for each size class, these keep track of all spans that have free objects
+ * in them. Objects are taken from and returned to spans in batches, under a lock that's specific
+ * to the size class; allocations of different sizes thus never contend with one another.
+ *
+ * Spans are carved into objects lazily, so that pages of a span that were never used don't need
+ * to be faulted in. Once all objects of a span have been freed, it's returned to the page heap.
+ */
+#include "malloc_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+
+/**
+ * Central free list for a single size class
+ */
+typedef struct central_list {
+    /// protects the list and all spans on it
+    mtx_t lock;
+    /// spans that have at least one free object
+    span_t *nonempty;
+} __attribute__((aligned(64))) central_list_t;
+
+static central_list_t gCentral[kNumClasses];
+
+/**
+ * Adds the span to the central list's set of spans with free objects.
+ */
+static void LinkSpan(central_list_t *list, span_t *span) {
+    span->prev = NULL;
+    span->next = list->nonempty;
+    if(list->nonempty) list->nonempty->prev = span;
+    list->nonempty = span;
+
+    span->inCentral = true;
+}
+
+/**
+ * Removes the span from the central list.
+ */
+static void UnlinkSpan(central_list_t *list, span_t *span) {
+    if(span->prev) {
+        span->prev->next = span->next;
+    } else {
+        list->nonempty = span->next;
+    }
+    if(span->next) {
+        span->next->prev = span->prev;
+    }
+
+    span->next = span->prev = NULL;
+    span->inCentral = false;
+}
+
+/**
+ * Allocates a new span for the given size class and adds it to the central list.
+ */
+static span_t *Refill(central_list_t *list, const size_t cl) {
+    span_t *span = PageHeapAlloc(ClassPages(cl), 1);
+    if(!span) return NULL;
+
+    span->sizeClass = cl;
+    span->state = kSpanSmall;
+    span->freeList = NULL;
+    span->carve = span->start;
+    span->used = 0;
+
+    LinkSpan(list, span);
+    return span;
+}
+
+
+
+/**
+ * Allocates up to `max` objects of the given size class. They're returned as a singly linked
+ * list, with the link stored in the first word of each object.
+ *
+ * @return Number of objects allocated; this is only zero if we're out of memory.
+ */
+size_t CentralFetch(const size_t cl, void **outHead, const size_t max) {
+    central_list_t *list = &gCentral[cl];
+    const size_t size = ClassToSize(cl);
+
+    void *head = NULL;
+    size_t count = 0;
+
+    mtx_lock(&list->lock);
+
+    while(count < max) {
+        span_t *span = list->nonempty;
+        if(!span && !(span = Refill(list, cl))) {
+            break;
+        }
+
+        const uintptr_t end = span->start + (span->pages << kPageShift);
+
+        // take as many objects as we can from this span
+        while(count < max) {
+            void *obj;
+
+            if(span->freeList) {
+                obj = span->freeList;
+                span->freeList = *((void **) obj);
+            } else if(span->carve + size <= end) {
+                obj = (void *) span->carve;
+                span->carve += size;
+            } else {
+                break;
+            }
+
+            *((void **) obj) = head;
+            head = obj;
+
+            span->used++;
+            count++;
+        }
+
+        if(!span->freeList && (span->carve + size) > end) {
+            UnlinkSpan(list, span);
+        }
+    }
+
+    mtx_unlock(&list->lock);
+
+    *outHead = head;
+    return count;
+}
+
+/**
+ * Returns a list of objects (linked as returned by CentralFetch) to their spans. Spans that are
+ * entirely free afterwards are released to the page heap, unless it's the only span left.
+ */
+void CentralRelease(const size_t cl, void *head) {
+    central_list_t *list = &gCentral[cl];
+
+    mtx_lock(&list->lock);
+
+    while(head) {
+        void *obj = head;
+        head = *((void **) obj);
+
+        span_t *span = PageHeapLookup(obj);
+        if(!span || span->sizeClass != cl || !span->used) {
+            fprintf(stderr, "[libc] invalid pointer %p passed to allocator\n", obj);
+            abort();
+        }
+
+        *((void **) obj) = span->freeList;
+        span->freeList = obj;
+
+        if(!span->inCentral) {
+            LinkSpan(list, span);
+        }
+
+        // keep the last span around, so alternating allocations don't keep hitting the page heap
+        if(!--span->used && (list->nonempty != span || span->next)) {
+            UnlinkSpan(list, span);
+            PageHeapFree(span);
+        }
+    }
+
+    mtx_unlock(&list->lock);
+}
@@ -127,8 +127,9 @@ LIBC_INTERNAL void __fake_sbrk_init(const size_t initialSize) {
 LIBC_INTERNAL void *__fake_sbrk(const intptr_t inc) {
     int err;
 
-    // fail if we're at or above the limit
-    if(gHeapMaxSize && gHeapSize >= gHeapMaxSize) {
+    // fail if we're at or would go above the limit
+    if(gHeapMaxSize && (gHeapSize >= gHeapMaxSize ||
+                (inc > 0 && (size_t) inc > (gHeapMaxSize - gHeapSize)))) {
         errno = ENOMEM;
         return (void *) -1;
     }
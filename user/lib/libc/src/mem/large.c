@@ -0,0 +1,128 @@
+/*
+ * Large allocations: each of these gets its own anonymous virtual memory region, which is
+ * deallocated again when the allocation is freed. This returns the memory to the kernel right
+ * away, rather than keeping it in the heap (which can't shrink.)
+ *
+ * The region starts with a header that's placed right before the returned pointer; the pointer
+ * itself is always at least page aligned.
+ */
+#include "malloc_private.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <sys/syscalls.h>
+
+/// Magic value in the header of large allocations
+#define kLargeMagic                     'BIGA'
+
+/**
+ * Header at the start of a large allocation's region
+ */
+typedef struct large_header {
+    /// region base address
+    uintptr_t base;
+    /// length of the region, in bytes
+    size_t length;
+    /// VM region handle
+    uintptr_t region;
+
+    /// must be kLargeMagic
+    uint32_t magic;
+} __attribute__((aligned(kMinAlign))) large_header_t;
+
+/**
+ * Gets the header of the large allocation, aborting if the pointer is not a large allocation.
+ */
+static large_header_t *GetHeader(const void *ptr) {
+    large_header_t *hdr = ((large_header_t *) ptr) - 1;
+
+    if(((uintptr_t) ptr & (kPageSize - 1)) || hdr->magic != kLargeMagic) {
+        fprintf(stderr, "[libc] invalid pointer %p passed to allocator\n", ptr);
+        abort();
+    }
+
+    return hdr;
+}
+
+/**
+ * Allocates a new region to satisfy the allocation, aligned to at least a page.
+ */
+void *LargeAlloc(const size_t size, const size_t _align) {
+    int err;
+    uintptr_t region, base;
+
+    const size_t align = (_align > kPageSize) ? _align : kPageSize;
+    if(size > (SIZE_MAX - align - kPageSize)) {
+        return NULL;
+    }
+
+    const size_t length = (size + align + kPageSize - 1) & ~(kPageSize - 1);
+    if(!FootprintAdd(length)) {
+        return NULL;
+    }
+
+    // allocate and map the region
+    err = AllocVirtualAnonRegion(length, VM_REGION_RW, &region);
+    if(err) {
+        goto fail;
+    }
+
+    const uintptr_t range[2] = {kLargeRangeStart, kLargeRangeEnd};
+    err = MapVirtualRegionRange(region, range, length, 0, &base);
+    if(err) {
+        DeallocVirtualRegion(region);
+        goto fail;
+    }
+
+    // the header goes right before the (aligned) pointer we return
+    const uintptr_t ptr = (base + sizeof(large_header_t) + align - 1) & ~(align - 1);
+    large_header_t *hdr = ((large_header_t *) ptr) - 1;
+
+    hdr->base = base;
+    hdr->length = length;
+    hdr->region = region;
+    hdr->magic = kLargeMagic;
+
+    return (void *) ptr;
+
+fail:
+    FootprintAdd(-((intptr_t) length));
+    return NULL;
+}
+
+/**
+ * Unmaps and deallocates the region of the given large allocation.
+ */
+void LargeFree(void *ptr) {
+    int err;
+
+    large_header_t *hdr = GetHeader(ptr);
+    const uintptr_t region = hdr->region;
+    const size_t length = hdr->length;
+
+    hdr->magic = 0;
+
+    err = UnmapVirtualRegion(region);
+    if(err) {
+        fprintf(stderr, "[libc] %s failed: %d\n", "UnmapVirtualRegion", err);
+        abort();
+    }
+
+    err = DeallocVirtualRegion(region);
+    if(err) {
+        fprintf(stderr, "[libc] %s failed: %d\n", "DeallocVirtualRegion", err);
+        abort();
+    }
+
+    FootprintAdd(-((intptr_t) length));
+}
+
+/**
+ * Returns the number of bytes usable in the large allocation: everything to the end of its region.
+ */
+size_t LargeUsableSize(const void *ptr) {
+    const large_header_t *hdr = GetHeader(ptr);
+    return (hdr->base + hdr->length) - (uintptr_t) ptr;
+}
@@ -0,0 +1,426 @@
+/*
+ * Public interface of the memory allocator.
+ *
+ * Allocations of up to kMaxSmallSize bytes are rounded up to a size class and served from the
+ * calling thread's cache. Anything larger is allocated as a run of pages from the page heap, or
+ * once it's at least as large as the large allocation threshold, gets its own virtual memory
+ * region. See malloc_private.h for an overview of the pieces.
+ */
+#include "malloc_private.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Tunable parameters
+malloc_params_t __libc_malloc_params = {
+    .largeThreshold = kDefaultLargeThreshold,
+    .growSize = kDefaultHeapGrowSize,
+};
+
+/// Number of bytes currently allocated from the system
+static size_t gFootprint = 0;
+/// Highest value the footprint has ever had
+static size_t gMaxFootprint = 0;
+/// Maximum footprint; SIZE_MAX if unlimited
+static size_t gFootprintLimit = SIZE_MAX;
+
+/**
+ * Updates the footprint. Increases fail if they would take the footprint above the limit.
+ */
+bool FootprintAdd(const intptr_t bytes) {
+    const size_t now = __atomic_add_fetch(&gFootprint, bytes, __ATOMIC_RELAXED);
+
+    if(bytes > 0) {
+        if(now > __atomic_load_n(&gFootprintLimit, __ATOMIC_RELAXED)) {
+            __atomic_sub_fetch(&gFootprint, bytes, __ATOMIC_RELAXED);
+            return false;
+        }
+
+        size_t max = __atomic_load_n(&gMaxFootprint, __ATOMIC_RELAXED);
+        while(now > max && !__atomic_compare_exchange_n(&gMaxFootprint, &max, now, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    }
+
+    return true;
+}
+
+/**
+ * Aborts the program due to a pointer that wasn't allocated by us.
+ */
+static void InvalidPointer(const void *ptr) {
+    fprintf(stderr, "[libc] invalid pointer %p passed to allocator\n", ptr);
+    abort();
+}
+
+
+
+/**
+ * Allocates a block too large for the size classes: either a span from the page heap, or its own
+ * virtual memory region. It's aligned to at least a page.
+ */
+static void *AllocPages(const size_t size, const size_t align) {
+    if(size >= __libc_malloc_params.largeThreshold) {
+        return LargeAlloc(size, align);
+    } else if(size > (SIZE_MAX / 2)) {
+        return NULL;
+    }
+
+    const size_t pages = (size + kPageSize - 1) >> kPageShift;
+    const size_t alignPages = (align > kPageSize) ? (align >> kPageShift) : 1;
+
+    span_t *span = PageHeapAlloc(pages ? pages : 1, alignPages);
+    return span ? (void *) span->start : NULL;
+}
+
+/**
+ * Finds the smallest size class whose objects can hold `size` bytes, and are aligned to `align`,
+ * which is a power of two no larger than a page.
+ *
+ * Spans are page aligned, so objects are aligned if their size is a multiple of the alignment.
+ */
+static size_t AlignedClass(const size_t size, const size_t align) {
+    size_t cl = SizeToClass((size > align) ? size : align);
+
+    while(ClassToSize(cl) & (align - 1)) {
+        cl++;
+    }
+
+    return cl;
+}
+
+/**
+ * Allocates memory with the given alignment, which is a power of two.
+ */
+static void *AllocAligned(const size_t size, const size_t align, const bool cached) {
+    if(size <= kMaxSmallSize && align <= kPageSize) {
+        const size_t cl = AlignedClass(size, align);
+
+        if(cached) {
+            return ThreadCacheAlloc(cl);
+        }
+
+        void *obj;
+        return CentralFetch(cl, &obj, 1) ? obj : NULL;
+    }
+
+    return AllocPages(size, align);
+}
+
+/**
+ * Releases an allocation.
+ */
+static void FreeInternal(void *ptr, const bool cached) {
+    if(!PageHeapContains(ptr)) {
+        LargeFree(ptr);
+        return;
+    }
+
+    span_t *span = PageHeapLookup(ptr);
+    if(!span) {
+        InvalidPointer(ptr);
+    }
+
+    if(span->state == kSpanSmall) {
+        if(cached) {
+            ThreadCacheFree(ptr, span->sizeClass);
+        } else {
+            *((void **) ptr) = NULL;
+            CentralRelease(span->sizeClass, ptr);
+        }
+    } else if(span->state == kSpanInUse && span->start == (uintptr_t) ptr) {
+        PageHeapFree(span);
+    } else {
+        InvalidPointer(ptr);
+    }
+}
+
+/**
+ * Returns the number of bytes that can be used in the given allocation.
+ */
+static size_t UsableSize(const void *ptr) {
+    if(!PageHeapContains(ptr)) {
+        return LargeUsableSize(ptr);
+    }
+
+    const span_t *span = PageHeapLookup(ptr);
+    if(!span) {
+        InvalidPointer(ptr);
+    }
+
+    if(span->state == kSpanSmall) {
+        return ClassToSize(span->sizeClass);
+    }
+    return (span->pages << kPageShift) - ((uintptr_t) ptr - span->start);
+}
+
+/**
+ * Rounds the alignment up to a power of two, and at least the minimum alignment.
+ */
+static inline size_t NormalizeAlignment(const size_t align) {
+    if(align <= kMinAlign) {
+        return kMinAlign;
+    } else if(align & (align - 1)) {
+        return 1UL << ((sizeof(long) * 8) - __builtin_clzl(align));
+    }
+    return align;
+}
+
+
+
+/**
+ * Allocates memory, bypassing the calling thread's cache. This is used to allocate thread-local
+ * storage, before (or after) the thread's TLS is accessible.
+ */
+void *__libc_memalign_uncached(const size_t align, const size_t size) {
+    return AllocAligned(size, NormalizeAlignment(align), false);
+}
+
+/**
+ * Frees memory without going through the calling thread's cache.
+ */
+void __libc_free_uncached(void *ptr) {
+    if(ptr) {
+        FreeInternal(ptr, false);
+    }
+}
+
+
+
+/**
+ * Allocates memory.
+ */
+void *malloc(const size_t numBytes) {
+    void *ptr;
+
+    if(numBytes <= kMaxSmallSize) {
+        ptr = ThreadCacheAlloc(SizeToClass(numBytes));
+    } else {
+        ptr = AllocPages(numBytes, kPageSize);
+    }
+
+    if(!ptr) {
+        errno = ENOMEM;
+    }
+    return ptr;
+}
+
+/**
+ * Frees previously allocated memory.
+ */
+void free(void *ptr) {
+    if(ptr) {
+        FreeInternal(ptr, true);
+    }
+}
+
+/**
+ * Allocates zeroed memory for an array of `count` elements of `size` bytes each.
+ */
+void *calloc(const size_t count, const size_t size) {
+    size_t bytes;
+    if(__builtin_mul_overflow(count, size, &bytes)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    void *ptr = malloc(bytes);
+
+    // large allocations are in freshly allocated regions, which are already zeroed
+    if(ptr && (bytes <= kMaxSmallSize || bytes < __libc_malloc_params.largeThreshold)) {
+        memset(ptr, 0, bytes);
+    }
+
+    return ptr;
+}
+
+/**
+ * Resizes an allocation. If the existing allocation is large enough (and not excessively so) it's
+ * returned as-is; otherwise, the contents are copied to a new allocation.
+ */
+void *realloc(void *ptr, const size_t newSize) {
+    if(!ptr) {
+        return malloc(newSize);
+    } else if(!newSize) {
+        free(ptr);
+        return NULL;
+    }
+
+    const size_t oldSize = UsableSize(ptr);
+    if(newSize <= oldSize && newSize >= (oldSize / 2)) {
+        return ptr;
+    }
+
+    void *newPtr = malloc(newSize);
+    if(!newPtr) {
+        return NULL;
+    }
+
+    memcpy(newPtr, ptr, (newSize < oldSize) ? newSize : oldSize);
+    free(ptr);
+
+    return newPtr;
+}
+
+/**
+ * Resizes an allocation, only if this can be done without moving it.
+ */
+void *realloc_in_place(void *ptr, const size_t newSize) {
+    if(!ptr) {
+        return NULL;
+    }
+
+    return (newSize <= UsableSize(ptr)) ? ptr : NULL;
+}
+
+/**
+ * Allocates memory aligned to the given boundary; it's rounded up to a power of two if needed.
+ */
+void *memalign(const size_t alignment, const size_t numBytes) {
+    void *ptr = AllocAligned(numBytes, NormalizeAlignment(alignment), true);
+
+    if(!ptr) {
+        errno = ENOMEM;
+    }
+    return ptr;
+}
+
+/**
+ * Allocates aligned memory. The alignment must be a power of two multiple of the pointer size.
+ */
+int posix_memalign(void **outPtr, const size_t alignment, const size_t size) {
+    if(!alignment || (alignment % sizeof(void *)) || (alignment & (alignment - 1))) {
+        return EINVAL;
+    }
+
+    void *ptr = AllocAligned(size, NormalizeAlignment(alignment), true);
+    if(!ptr) {
+        return ENOMEM;
+    }
+
+    *outPtr = ptr;
+    return 0;
+}
+
+/**
+ * Allocates page-aligned memory.
+ */
+void *valloc(const size_t numBytes) {
+    return memalign(kPageSize, numBytes);
+}
+
+/**
+ * Allocates page-aligned memory, rounding the size up to a multiple of the page size.
+ */
+void *pvalloc(const size_t numBytes) {
+    if(numBytes > (SIZE_MAX - kPageSize)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return memalign(kPageSize, (numBytes + kPageSize - 1) & ~(kPageSize - 1));
+}
+
+/**
+ * Frees all non-NULL pointers in the array, and clears them.
+ *
+ * @return Number of pointers that could not be freed; always zero.
+ */
+size_t bulk_free(void **ptrs, size_t n_elements) {
+    for(size_t i = 0; i < n_elements; i++) {
+        if(ptrs[i]) {
+            free(ptrs[i]);
+            ptrs[i] = NULL;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Returns the number of usable bytes in the allocation, which may be more than was requested.
+ */
+size_t malloc_usable_size(void *ptr) {
+    return ptr ? UsableSize(ptr) : 0;
+}
+
+
+
+/**
+ * Returns the number of bytes currently allocated from the system.
+ */
+size_t malloc_footprint(void) {
+    return __atomic_load_n(&gFootprint, __ATOMIC_RELAXED);
+}
+
+/**
+ * Returns the largest number of bytes that were ever allocated from the system at once.
+ */
+size_t malloc_max_footprint(void) {
+    return __atomic_load_n(&gMaxFootprint, __ATOMIC_RELAXED);
+}
+
+/**
+ * Returns the footprint limit.
+ */
+size_t malloc_footprint_limit() {
+    return __atomic_load_n(&gFootprintLimit, __ATOMIC_RELAXED);
+}
+
+/**
+ * Sets the footprint limit, rounded up to a multiple of the page size.
+ */
+size_t malloc_set_footprint_limit(const size_t newLimit) {
+    size_t limit = newLimit;
+    if(limit != SIZE_MAX) {
+        limit = (limit > (SIZE_MAX - kPageSize)) ? SIZE_MAX :
+            ((limit + kPageSize - 1) & ~(kPageSize - 1));
+    }
+
+    __atomic_store_n(&gFootprintLimit, limit, __ATOMIC_RELAXED);
+    return limit;
+}
+
+/**
+ * Adjusts allocator parameters.
+ *
+ * @return 1 if the option was changed, 0 if the option or its value are invalid.
+ */
+int mallopt(const int option, const int value) {
+    switch(option) {
+        // the heap is never shrunk, so this is accepted but has no effect
+        case M_TRIM_THRESHOLD:
+            return 1;
+
+        case M_GRANULARITY:
+            if(value < (int) kPageSize || (value & (value - 1))) {
+                return 0;
+            }
+            __libc_malloc_params.growSize = value;
+            return 1;
+
+        case M_MMAP_THRESHOLD:
+            if(value < 0) {
+                return 0;
+            }
+            __libc_malloc_params.largeThreshold = value;
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Returns all memory cached by the calling thread to the shared free lists; spans that are then
+ * completely free become available for allocations of any size.
+ *
+ * @return 1 if any memory was released, 0 otherwise.
+ */
+int malloc_trim(const size_t trim) {
+    (void) trim;
+    return ThreadCacheFlush() ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+#ifndef LIBC_MEM_MALLOC_PRIVATE_H
+#define LIBC_MEM_MALLOC_PRIVATE_H
+
+/*
+ * Internal interfaces of the memory allocator.
+ *
+ * The allocator is split into a few layers:
+ *
+ * - Page heap: Manages the heap (obtained from the sbrk emulation) in units of pages. Contiguous
+ *   runs of pages are called spans; free spans are coalesced with their neighbors. A pagemap maps
+ *   each page of the heap back to the span it belongs to. Allocations that don't fit any size
+ *   class are served as whole spans.
+ * - Central free lists: One per size class, each with its own lock. They carve spans from the
+ *   page heap into objects of that size class and hand them out in batches. Spans whose objects
+ *   have all been freed are returned to the page heap.
+ * - Thread caches: Each thread keeps a list of free objects for each size class, so the common
+ *   case of malloc() and free() does not need any locks at all. They exchange objects in batches
+ *   with the central free lists.
+ * - Large allocations: These are served directly from anonymous virtual memory regions, which are
+ *   deallocated (returning the memory to the kernel) when the allocation is freed.
+ */
+#include <_libc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Page size, and its base 2 logarithm
+#define kPageShift                      (12)
+#define kPageSize                       (1UL << kPageShift)
+
+/// All allocations are aligned to at least this many bytes
+#define kMinAlign                       (16)
+
+/// Size of the largest allocation served from a size class
+#define kMaxSmallSize                   (32 * 1024)
+/// Number of size classes; class 0 is not used
+#define kNumClasses                     (41)
+
+/// Number of bytes that should (roughly) be moved between thread caches and central lists at once
+#define kBatchBytes                     (64 * 1024)
+/// Upper bound for number of objects moved at once
+#define kMaxBatch                       (32)
+
+/// Spans up to this many pages are kept in exact size free lists in the page heap
+#define kMaxPages                       (128)
+/// Default minimum number of bytes by which the heap is grown
+#define kDefaultHeapGrowSize            (1024 * 1024)
+/// Default threshold above which allocations get their own virtual memory region
+#define kDefaultLargeThreshold          (256 * 1024)
+
+/// Maximum number of bytes that may be held in a single thread's cache
+#define kMaxThreadCacheBytes            (2 * 1024 * 1024)
+
+/**
+ * Pagemap geometry: each leaf covers 2^kPagemapLeafBits pages. There must be enough leaves to
+ * cover the maximum heap size configured in fake_sbrk.c.
+ */
+#define kPagemapLeafBits                (15)
+#if defined(__i386__)
+#define kPagemapRootEntries             (2)
+#elif defined(__amd64__)
+#define kPagemapRootEntries             (512)
+#else
+#error Update mem/malloc_private.h with this arch's pagemap size
+#endif
+
+/**
+ * Virtual address range in which regions for large allocations are placed.
+ */
+#if defined(__i386__)
+#define kLargeRangeStart                (0x40000000)
+#define kLargeRangeEnd                  (0x70000000)
+#elif defined(__amd64__)
+#define kLargeRangeStart                (0x7c0000000000)
+#define kLargeRangeEnd                  (0x7f0000000000)
+#else
+#error Update mem/malloc_private.h with this arch's large allocation range
+#endif
+
+/**
+ * Tunable allocator parameters; these can be changed with mallopt().
+ */
+typedef struct malloc_params {
+    /// allocations of at least this size get their own virtual memory region
+    size_t largeThreshold;
+    /// minimum number of bytes by which the heap is grown
+    size_t growSize;
+} malloc_params_t;
+
+LIBC_INTERNAL extern malloc_params_t __libc_malloc_params;
+
+/**
+ * States a span can be in
+ */
+enum {
+    /// Span is on one of the page heap's free lists
+    kSpanFree                           = 1,
+    /// Span was handed out as a single allocation
+    kSpanInUse                          = 2,
+    /// Span is carved into objects of a size class
+    kSpanSmall                          = 3,
+};
+
+/**
+ * Describes a contiguous run of pages in the heap.
+ */
+typedef struct span {
+    /// address of the first page
+    uintptr_t start;
+    /// number of pages
+    size_t pages;
+
+    /// links in the page heap free list, or central free list
+    struct span *next, *prev;
+
+    /// free objects returned to this span (small spans only)
+    void *freeList;
+    /// next never allocated object; objects are carved from the span lazily
+    uintptr_t carve;
+    /// number of objects currently allocated from the span
+    size_t used;
+
+    /// size class of objects in the span, or 0 if not a small span
+    uint8_t sizeClass;
+    /// one of the kSpan* constants
+    uint8_t state;
+    /// whether the span is on the nonempty list of its central free list
+    bool inCentral;
+} span_t;
+
+
+
+/**
+ * Converts an allocation size (at most kMaxSmallSize) to a size class.
+ *
+ * Sizes up to 128 bytes are spaced 16 bytes apart; above that, there are four size classes for
+ * every power of two, so internal fragmentation is at most 25%.
+ */
+static inline size_t SizeToClass(const size_t size) {
+    if(size <= 128) {
+        return size ? ((size + 15) >> 4) : 1;
+    }
+
+    const size_t s = size - 1;
+    const size_t lg = (sizeof(long) * 8 - 1) - __builtin_clzl(s);
+    return 9 + ((lg - 7) * 4) + ((s >> (lg - 2)) & 3);
+}
+
+/**
+ * Returns the size of objects in the given size class.
+ */
+static inline size_t ClassToSize(const size_t cl) {
+    if(cl <= 8) {
+        return cl << 4;
+    }
+
+    const size_t lg = 7 + ((cl - 9) / 4);
+    return (1UL << lg) + (((cl - 9) % 4) + 1) * (1UL << (lg - 2));
+}
+
+/**
+ * Returns how many objects are moved between a thread cache and the central free list at once.
+ */
+static inline size_t ClassBatchSize(const size_t cl) {
+    const size_t n = kBatchBytes / ClassToSize(cl);
+    return (n < 2) ? 2 : ((n > kMaxBatch) ? kMaxBatch : n);
+}
+
+/**
+ * Returns the number of pages in a span of the given size class. Spans hold at least eight
+ * objects, and no more than an eighth of them is left over at the end.
+ */
+static inline size_t ClassPages(const size_t cl) {
+    const size_t size = ClassToSize(cl);
+    size_t pages = ((size * 8) + kPageSize - 1) >> kPageShift;
+
+    while(((pages << kPageShift) % size) > ((pages << kPageShift) / 8)) {
+        pages++;
+    }
+
+    return pages;
+}
+
+
+
+/// Grows the heap; implemented in fake_sbrk.c
+LIBC_INTERNAL void *__fake_sbrk(const intptr_t inc);
+
+/// Tests whether the address lies in the page heap.
+LIBC_INTERNAL bool PageHeapContains(const void *ptr);
+/// Finds the span the given address (inside the heap) belongs to.
+LIBC_INTERNAL span_t *PageHeapLookup(const void *ptr);
+
+/// Allocates a span of the given number of pages, aligned to the given number of pages
+LIBC_INTERNAL span_t *PageHeapAlloc(const size_t pages, const size_t alignPages);
+/// Returns a span to the page heap
+LIBC_INTERNAL void PageHeapFree(span_t *span);
+/// Allocates internal metadata; this memory can never be released.
+LIBC_INTERNAL void *PageHeapAllocMeta(const size_t bytes);
+
+/// Allocates a block in its own virtual memory region
+LIBC_INTERNAL void *LargeAlloc(const size_t size, const size_t align);
+/// Releases a large allocation
+LIBC_INTERNAL void LargeFree(void *ptr);
+/// Returns the usable size of a large allocation
+LIBC_INTERNAL size_t LargeUsableSize(const void *ptr);
+
+/// Updates the heap's footprint by the given (signed) number of bytes; fails if over the limit
+LIBC_INTERNAL bool FootprintAdd(const intptr_t bytes);
+
+/// Allocates up to `max` objects of the given size class as a linked list
+LIBC_INTERNAL size_t CentralFetch(const size_t cl, void **outHead, const size_t max);
+/// Returns a linked list of objects to the central free list of the given size class
+LIBC_INTERNAL void CentralRelease(const size_t cl, void *head);
+
+/// Allocates an object of the given size class from the calling thread's cache
+LIBC_INTERNAL void *ThreadCacheAlloc(const size_t cl);
+/// Releases an object to the calling thread's cache
+LIBC_INTERNAL void ThreadCacheFree(void *ptr, const size_t cl);
+/// Returns all objects in the calling thread's cache to the central lists.
+LIBC_INTERNAL bool ThreadCacheFlush();
+
+/// Allocates memory, bypassing the thread cache; safe to call while TLS is unavailable
+LIBC_INTERNAL void *__libc_memalign_uncached(const size_t align, const size_t size);
+/// Releases memory without going through the thread cache
+LIBC_INTERNAL void __libc_free_uncached(void *ptr);
+
+/// Enables thread caches; called once the main thread's TLS is set up
+LIBC_INTERNAL void __libc_malloc_init();
+/// Returns all memory cached by the calling thread, and disables its cache
+LIBC_INTERNAL void __libc_malloc_thread_fini();
+
+#endif
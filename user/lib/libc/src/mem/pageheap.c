@@ -0,0 +1,421 @@
+/*
+ * Page heap: manages the memory obtained from the sbrk emulation in units of pages.
+ *
+ * Free spans are kept in free lists indexed by their size in pages; spans larger than kMaxPages
+ * go into a single list that is searched best-fit. When a span is freed, it's merged with any
+ * free spans that immediately precede or follow it.
+ *
+ * The pagemap is a two level radix tree that maps each page of the heap to its span. For spans
+ * in use, every page is mapped, so that any pointer into the span can be resolved; for free
+ * spans, only the first and last pages are, which is all that's needed to coalesce them. Entries
+ * are written with the heap lock held, but may be read without it.
+ */
+#include "malloc_private.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <threads.h>
+
+/**
+ * State of the page heap
+ */
+static struct {
+    /// protects all state below, and writes to the pagemap
+    mtx_t lock;
+
+    /// address of the first byte of the heap
+    uintptr_t base;
+    /// address of the end of the heap; anything between base and this is in the heap
+    uintptr_t top;
+
+    /// free spans of up to kMaxPages pages, indexed by page count
+    span_t *free[kMaxPages + 1];
+    /// free spans larger than that
+    span_t *large;
+
+    /// span descriptors that are not currently used
+    span_t *spareSpans;
+
+    /// current chunk for metadata allocations
+    uintptr_t metaCur, metaEnd;
+
+    /// pagemap root; leaves are allocated as needed
+    span_t **pagemap[kPagemapRootEntries];
+} gHeap;
+
+/// Number of bytes of metadata to allocate from the heap at once
+#define kMetaChunkSize                  (64 * 1024)
+/// Number of entries in a pagemap leaf
+#define kPagemapLeafEntries             (1UL << kPagemapLeafBits)
+
+static void FreeLocked(span_t *span);
+
+
+
+/**
+ * Grows the heap by the given number of bytes, which must be a multiple of the page size.
+ *
+ * @return Address of the new memory, or 0 if the heap could not be grown.
+ */
+static uintptr_t Sbrk(const size_t bytes) {
+    if(!FootprintAdd(bytes)) {
+        return 0;
+    }
+
+    void *ptr = __fake_sbrk(bytes);
+    if(ptr == (void *) -1) {
+        FootprintAdd(-((intptr_t) bytes));
+        return 0;
+    }
+
+    if(!gHeap.base) {
+        __atomic_store_n(&gHeap.base, (uintptr_t) ptr, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&gHeap.top, ((uintptr_t) ptr) + bytes, __ATOMIC_RELEASE);
+
+    return (uintptr_t) ptr;
+}
+
+/**
+ * Allocates metadata with the heap lock held. Memory is carved from chunks that were allocated
+ * from the heap but never appear in the pagemap, since they are never freed.
+ */
+static void *AllocMetaLocked(const size_t _bytes) {
+    const size_t bytes = (_bytes + 15) & ~15UL;
+
+    // large allocations (pagemap leaves) get their own chunk
+    if(bytes > (kMetaChunkSize / 2)) {
+        return (void *) Sbrk((bytes + kPageSize - 1) & ~(kPageSize - 1));
+    }
+
+    if((gHeap.metaEnd - gHeap.metaCur) < bytes) {
+        const uintptr_t ptr = Sbrk(kMetaChunkSize);
+        if(!ptr) return NULL;
+
+        gHeap.metaCur = ptr;
+        gHeap.metaEnd = ptr + kMetaChunkSize;
+    }
+
+    void *ptr = (void *) gHeap.metaCur;
+    gHeap.metaCur += bytes;
+    return ptr;
+}
+
+/**
+ * Allocates internal metadata. The returned memory is zeroed.
+ */
+void *PageHeapAllocMeta(const size_t bytes) {
+    mtx_lock(&gHeap.lock);
+    void *ptr = AllocMetaLocked(bytes);
+    mtx_unlock(&gHeap.lock);
+
+    return ptr;
+}
+
+
+
+/**
+ * Tests whether the given address is inside the heap.
+ */
+bool PageHeapContains(const void *ptr) {
+    const uintptr_t addr = (uintptr_t) ptr;
+    const uintptr_t base = __atomic_load_n(&gHeap.base, __ATOMIC_ACQUIRE);
+    const uintptr_t top = __atomic_load_n(&gHeap.top, __ATOMIC_ACQUIRE);
+
+    return base && addr >= base && addr < top;
+}
+
+/**
+ * Gets the pagemap entry for the given page (relative to the heap base), optionally allocating
+ * the leaf that contains it. Allocating leaves requires the heap lock.
+ */
+static span_t **PagemapEntry(const uintptr_t page, const bool create) {
+    const size_t root = page >> kPagemapLeafBits;
+    if(root >= kPagemapRootEntries) {
+        return NULL;
+    }
+
+    span_t **leaf = __atomic_load_n(&gHeap.pagemap[root], __ATOMIC_ACQUIRE);
+    if(!leaf && create) {
+        // fresh heap memory is zeroed, so all entries are initially empty
+        leaf = AllocMetaLocked(sizeof(span_t *) * kPagemapLeafEntries);
+        if(!leaf) return NULL;
+
+        __atomic_store_n(&gHeap.pagemap[root], leaf, __ATOMIC_RELEASE);
+    }
+
+    return leaf ? &leaf[page & (kPagemapLeafEntries - 1)] : NULL;
+}
+
+/**
+ * Updates the pagemap entries for the given pages of the heap.
+ *
+ * @return Whether the pagemap could be updated; this can only fail if a leaf was needed, but
+ * could not be allocated.
+ */
+static bool PagemapSet(const uintptr_t addr, const size_t pages, span_t *span) {
+    const uintptr_t first = (addr - gHeap.base) >> kPageShift;
+
+    for(size_t i = 0; i < pages; i++) {
+        span_t **entry = PagemapEntry(first + i, true);
+        if(!entry) return false;
+
+        __atomic_store_n(entry, span, __ATOMIC_RELEASE);
+    }
+
+    return true;
+}
+
+/**
+ * Finds the span containing the given address.
+ */
+span_t *PageHeapLookup(const void *ptr) {
+    const uintptr_t page = ((uintptr_t) ptr - gHeap.base) >> kPageShift;
+
+    span_t **entry = PagemapEntry(page, false);
+    return entry ? __atomic_load_n(entry, __ATOMIC_ACQUIRE) : NULL;
+}
+
+
+
+/**
+ * Allocates a span descriptor.
+ */
+static span_t *NewSpan(const uintptr_t start, const size_t pages) {
+    span_t *span = gHeap.spareSpans;
+
+    if(span) {
+        gHeap.spareSpans = span->next;
+    } else {
+        span = AllocMetaLocked(sizeof(span_t));
+        if(!span) return NULL;
+    }
+
+    span->start = start;
+    span->pages = pages;
+    span->next = span->prev = NULL;
+    span->freeList = NULL;
+    span->carve = 0;
+    span->used = 0;
+    span->sizeClass = 0;
+    span->state = 0;
+    span->inCentral = false;
+
+    return span;
+}
+
+/**
+ * Releases a span descriptor. It's kept around for reuse, since it may still be referenced by
+ * stale (interior) pagemap entries.
+ */
+static void DeleteSpan(span_t *span) {
+    span->state = 0;
+    span->next = gHeap.spareSpans;
+    gHeap.spareSpans = span;
+}
+
+/**
+ * Gets the free list that a free span of the given size belongs on.
+ */
+static inline span_t **FreeListFor(const size_t pages) {
+    return (pages <= kMaxPages) ? &gHeap.free[pages] : &gHeap.large;
+}
+
+/**
+ * Inserts the span into the appropriate free list.
+ */
+static void InsertFree(span_t *span) {
+    span_t **list = FreeListFor(span->pages);
+
+    span->prev = NULL;
+    span->next = *list;
+    if(*list) (*list)->prev = span;
+    *list = span;
+}
+
+/**
+ * Removes the span from the free list it's on.
+ */
+static void RemoveFree(span_t *span) {
+    if(span->prev) {
+        span->prev->next = span->next;
+    } else {
+        *FreeListFor(span->pages) = span->next;
+    }
+    if(span->next) {
+        span->next->prev = span->prev;
+    }
+
+    span->next = span->prev = NULL;
+}
+
+/**
+ * Finds the smallest free span with at least the given number of pages.
+ */
+static span_t *FindFree(const size_t pages) {
+    for(size_t i = pages; i <= kMaxPages; i++) {
+        if(gHeap.free[i]) return gHeap.free[i];
+    }
+
+    span_t *best = NULL;
+    for(span_t *span = gHeap.large; span; span = span->next) {
+        if(span->pages < pages) continue;
+
+        if(!best || span->pages < best->pages ||
+                (span->pages == best->pages && span->start < best->start)) {
+            best = span;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Grows the heap so that it can satisfy an allocation of at least the given number of pages.
+ */
+static bool Grow(const size_t pages) {
+    size_t bytes = pages << kPageShift;
+    if(bytes < __libc_malloc_params.growSize) {
+        bytes = __libc_malloc_params.growSize;
+    }
+
+    span_t *span = NewSpan(0, bytes >> kPageShift);
+    if(!span) return false;
+
+    span->start = Sbrk(bytes);
+    if(!span->start) {
+        DeleteSpan(span);
+        return false;
+    }
+
+    FreeLocked(span);
+    return true;
+}
+
+/**
+ * Splits off the pages past the first `pages` of the span as a new free span.
+ *
+ * @return Whether the span was split; if not, it's left untouched.
+ */
+static bool SplitTail(span_t *span, const size_t pages) {
+    span_t *tail = NewSpan(span->start + (pages << kPageShift), span->pages - pages);
+    if(!tail) return false;
+
+    span->pages = pages;
+
+    tail->state = kSpanFree;
+    PagemapSet(tail->start, 1, tail);
+    PagemapSet(tail->start + ((tail->pages - 1) << kPageShift), 1, tail);
+    InsertFree(tail);
+
+    return true;
+}
+
+
+
+/**
+ * Allocates a span of the given number of pages. If more than one page of alignment is requested,
+ * the span's start address is aligned to a multiple of that many pages.
+ *
+ * All pages of the returned span are mapped in the pagemap.
+ */
+span_t *PageHeapAlloc(const size_t pages, const size_t alignPages) {
+    const size_t align = (alignPages > 1) ? (alignPages << kPageShift) : kPageSize;
+    const size_t needed = pages + ((alignPages > 1) ? (alignPages - 1) : 0);
+    span_t *span;
+
+    mtx_lock(&gHeap.lock);
+
+    while(!(span = FindFree(needed))) {
+        if(!Grow(needed)) goto fail;
+    }
+
+    RemoveFree(span);
+
+    // split off the unaligned part at the start
+    const uintptr_t aligned = (span->start + align - 1) & ~(align - 1);
+    if(aligned != span->start) {
+        const size_t prefix = (aligned - span->start) >> kPageShift;
+
+        span_t *rest = NewSpan(aligned, span->pages - prefix);
+        if(!rest) {
+            InsertFree(span);
+            goto fail;
+        }
+
+        // the prefix goes back on the free lists
+        span->pages = prefix;
+        PagemapSet(span->start, 1, span);
+        PagemapSet(span->start + ((span->pages - 1) << kPageShift), 1, span);
+        InsertFree(span);
+
+        span = rest;
+    }
+
+    // and any excess at the end; if that fails, the span is simply larger than needed
+    if(span->pages > pages) {
+        SplitTail(span, pages);
+    }
+
+    span->state = kSpanInUse;
+    if(!PagemapSet(span->start, span->pages, span)) {
+        FreeLocked(span);
+        goto fail;
+    }
+
+    mtx_unlock(&gHeap.lock);
+    return span;
+
+fail:
+    mtx_unlock(&gHeap.lock);
+    return NULL;
+}
+
+/**
+ * Returns the span to the free lists, merging it with any adjacent free spans.
+ */
+static void FreeLocked(span_t *span) {
+    // merge with the preceding span
+    if(span->start > gHeap.base) {
+        span_t *prev = PageHeapLookup((void *) (span->start - kPageSize));
+
+        if(prev && prev->state == kSpanFree) {
+            RemoveFree(prev);
+            span->start = prev->start;
+            span->pages += prev->pages;
+            DeleteSpan(prev);
+        }
+    }
+
+    // and the following one
+    const uintptr_t end = span->start + (span->pages << kPageShift);
+    if(end < gHeap.top) {
+        span_t *next = PageHeapLookup((void *) end);
+
+        if(next && next->state == kSpanFree) {
+            RemoveFree(next);
+            span->pages += next->pages;
+            DeleteSpan(next);
+        }
+    }
+
+    span->state = kSpanFree;
+    span->sizeClass = 0;
+    span->freeList = NULL;
+    span->used = 0;
+    span->inCentral = false;
+
+    PagemapSet(span->start, 1, span);
+    PagemapSet(span->start + ((span->pages - 1) << kPageShift), 1, span);
+    InsertFree(span);
+}
+
+/**
+ * Returns a span to the page heap.
+ */
+void PageHeapFree(span_t *span) {
+    mtx_lock(&gHeap.lock);
+    FreeLocked(span);
+    mtx_unlock(&gHeap.lock);
+}
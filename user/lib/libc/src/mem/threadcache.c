@@ -0,0 +1,267 @@
+/*
+ * Per-thread caches of free objects.
+ *
+ * Each thread has a free list for every size class; allocating and freeing objects that are on
+ * them doesn't require any locking. When a list runs empty, a batch of objects is fetched from the
+ * central free list; when it grows too long, a batch is returned to it. If the cache as a whole
+ * grows too large, half of each list is returned.
+ *
+ * Caches are only available once the thread's TLS has been set up, and after __libc_malloc_init()
+ * was called; before that (and in the non-TLS version of the C library) all allocations go to
+ * the central free lists directly. When a thread exits, its cache is flushed and kept around for
+ * reuse by a later thread.
+ */
+#include "malloc_private.h"
+
+#include <stddef.h>
+#include <threads.h>
+
+/**
+ * Free list for a single size class
+ */
+typedef struct thread_cache_list {
+    /// first free object
+    void *head;
+    /// number of objects on the list
+    uint32_t length;
+    /// once there are more objects than this on the list, a batch is returned to the central list
+    uint32_t maxLength;
+} thread_cache_list_t;
+
+/**
+ * A thread's cache
+ */
+typedef struct thread_cache {
+    /// free lists for each size class
+    thread_cache_list_t lists[kNumClasses];
+    /// total number of bytes held in the cache
+    size_t bytes;
+
+    /// next cache on the list of unused caches
+    struct thread_cache *next;
+} thread_cache_t;
+
+#ifndef LIBC_NOTLS
+/// Marks the cache of a thread that is exiting
+#define kCacheDisabled                  ((thread_cache_t *) 1)
+
+/// set once the main thread's TLS is available
+static bool gCachesEnabled = false;
+
+/// caches of threads that have exited
+static thread_cache_t *gFreeCaches = NULL;
+static mtx_t gFreeCachesLock;
+
+/**
+ * Cache for the current thread, allocated on first use.
+ *
+ * This is accessed with the initial-exec model; since it's not exported, the linker emits a TPOFF
+ * relocation without a symbol for it, which the dynamic linker resolves against the offset of the
+ * C library's own TLS region.
+ */
+static _Thread_local thread_cache_t *gCache = NULL;
+
+/**
+ * Allocates a cache for the calling thread.
+ */
+static thread_cache_t *CreateCache() {
+    mtx_lock(&gFreeCachesLock);
+    thread_cache_t *cache = gFreeCaches;
+    if(cache) {
+        gFreeCaches = cache->next;
+    }
+    mtx_unlock(&gFreeCachesLock);
+
+    if(!cache) {
+        cache = PageHeapAllocMeta(sizeof(thread_cache_t));
+        if(!cache) return NULL;
+    }
+
+    for(size_t cl = 1; cl < kNumClasses; cl++) {
+        cache->lists[cl].head = NULL;
+        cache->lists[cl].length = 0;
+        cache->lists[cl].maxLength = ClassBatchSize(cl) * 2;
+    }
+    cache->bytes = 0;
+    cache->next = NULL;
+
+    gCache = cache;
+    return cache;
+}
+#endif
+
+/**
+ * Returns the calling thread's cache, or NULL if caches can't be used.
+ */
+static inline thread_cache_t *GetCache() {
+#ifdef LIBC_NOTLS
+    return NULL;
+#else
+    if(!gCachesEnabled) {
+        return NULL;
+    }
+
+    thread_cache_t *cache = gCache;
+    if(cache == kCacheDisabled) {
+        return NULL;
+    }
+
+    return cache ? cache : CreateCache();
+#endif
+}
+
+
+
+/**
+ * Returns the first `count` objects on the free list to the central free list.
+ */
+static void ReleaseBatch(thread_cache_t *cache, const size_t cl, const size_t count) {
+    thread_cache_list_t *list = &cache->lists[cl];
+    if(!count) return;
+
+    void *head = list->head, *tail = head;
+    for(size_t i = 1; i < count; i++) {
+        tail = *((void **) tail);
+    }
+
+    list->head = *((void **) tail);
+    list->length -= count;
+    cache->bytes -= count * ClassToSize(cl);
+
+    *((void **) tail) = NULL;
+    CentralRelease(cl, head);
+}
+
+/**
+ * Returns half of the objects on each free list to the central lists.
+ */
+static void Scavenge(thread_cache_t *cache) {
+    for(size_t cl = 1; cl < kNumClasses; cl++) {
+        ReleaseBatch(cache, cl, (cache->lists[cl].length + 1) / 2);
+    }
+}
+
+/**
+ * Fetches a batch of objects from the central list, once the thread's list is empty.
+ */
+static void *FetchBatch(thread_cache_t *cache, const size_t cl) {
+    thread_cache_list_t *list = &cache->lists[cl];
+    void *head;
+
+    const size_t count = CentralFetch(cl, &head, ClassBatchSize(cl));
+    if(!count) return NULL;
+
+    list->head = *((void **) head);
+    list->length = count - 1;
+    cache->bytes += (count - 1) * ClassToSize(cl);
+
+    return head;
+}
+
+
+
+/**
+ * Allocates an object of the given size class.
+ */
+void *ThreadCacheAlloc(const size_t cl) {
+    thread_cache_t *cache = GetCache();
+
+    if(!cache) {
+        void *obj;
+        return CentralFetch(cl, &obj, 1) ? obj : NULL;
+    }
+
+    thread_cache_list_t *list = &cache->lists[cl];
+    void *obj = list->head;
+    if(!obj) {
+        return FetchBatch(cache, cl);
+    }
+
+    list->head = *((void **) obj);
+    list->length--;
+    cache->bytes -= ClassToSize(cl);
+
+    return obj;
+}
+
+/**
+ * Releases an object of the given size class.
+ */
+void ThreadCacheFree(void *ptr, const size_t cl) {
+    thread_cache_t *cache = GetCache();
+
+    if(!cache) {
+        *((void **) ptr) = NULL;
+        CentralRelease(cl, ptr);
+        return;
+    }
+
+    thread_cache_list_t *list = &cache->lists[cl];
+    *((void **) ptr) = list->head;
+    list->head = ptr;
+    list->length++;
+    cache->bytes += ClassToSize(cl);
+
+    if(list->length > list->maxLength) {
+        ReleaseBatch(cache, cl, ClassBatchSize(cl));
+    } else if(cache->bytes > kMaxThreadCacheBytes) {
+        Scavenge(cache);
+    }
+}
+
+/**
+ * Returns all objects in the calling thread's cache to the central lists.
+ *
+ * @return Whether any objects were released
+ */
+bool ThreadCacheFlush() {
+#ifndef LIBC_NOTLS
+    if(!gCachesEnabled) return false;
+
+    thread_cache_t *cache = gCache;
+    if(!cache || cache == kCacheDisabled || !cache->bytes) return false;
+
+    for(size_t cl = 1; cl < kNumClasses; cl++) {
+        ReleaseBatch(cache, cl, cache->lists[cl].length);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+/**
+ * Enables the use of thread caches. This must only be called once the calling thread's TLS has
+ * been set up; any threads started later will set up their TLS before allocating memory.
+ */
+void __libc_malloc_init() {
+#ifndef LIBC_NOTLS
+    gCachesEnabled = true;
+#endif
+}
+
+/**
+ * Flushes the calling thread's cache and makes it available for reuse. Any allocations the thread
+ * makes afterwards go directly to the central lists.
+ */
+void __libc_malloc_thread_fini() {
+#ifndef LIBC_NOTLS
+    if(!gCachesEnabled) return;
+
+    thread_cache_t *cache = gCache;
+    gCache = kCacheDisabled;
+
+    if(!cache || cache == kCacheDisabled) return;
+
+    for(size_t cl = 1; cl < kNumClasses; cl++) {
+        ReleaseBatch(cache, cl, cache->lists[cl].length);
+    }
+
+    mtx_lock(&gFreeCachesLock);
+    cache->next = gFreeCaches;
+    gFreeCaches = cache;
+    mtx_unlock(&gFreeCachesLock);
+#endif
+}
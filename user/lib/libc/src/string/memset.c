@@ -6,7 +6,8 @@
  */
 void *memset(void *ptr, const int value, const size_t num) {
     if(value == 0x00) {
-        return memclr(ptr, num);
+        memclr(ptr, num);
+        return ptr;
     }
 
     uint8_t *write = (uint8_t *) ptr;
@@ -28,11 +28,16 @@
 //        Use this instead of the bloated standard/newlib printf cause these use
 //        malloc for printf (and may not be thread safe).
 //
+//        This is shared between the kernel and the C library. Output is produced in runs
+//        (literal spans of the format string, padding, converted numbers) into either the
+//        caller's buffer, or a small buffer on the stack that's passed to the output
+//        function in chunks; nothing is ever allocated.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <stdbool.h>
-#include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <printf.h>
 
@@ -45,11 +50,11 @@
 #endif
 
 
-// 'ntoa' conversion buffer size, this must be big enough to hold one converted
-// numeric number including padded zeros (dynamically created on stack)
-// default: 32 byte
+// 'ntoa' conversion buffer size, this must be big enough to hold all digits of
+// the largest integer in the smallest base (binary), without any padding
+// default: 64 byte
 #ifndef PRINTF_NTOA_BUFFER_SIZE
-#define PRINTF_NTOA_BUFFER_SIZE    32U
+#define PRINTF_NTOA_BUFFER_SIZE    64U
 #endif
 
 // 'ftoa' conversion buffer size, this must be big enough to hold one converted
@@ -59,6 +64,13 @@
 #define PRINTF_FTOA_BUFFER_SIZE    32U
 #endif
 
+// size of the buffer on the stack that output is collected in, before it's
+// passed to an output function
+// default: 128 byte
+#ifndef PRINTF_CHUNK_BUFFER_SIZE
+#define PRINTF_CHUNK_BUFFER_SIZE   128U
+#endif
+
 // support for the floating point type (%f)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_FLOAT
@@ -119,40 +131,118 @@
 #endif
 
 
-// output function type
-typedef void (*out_fct_type)(char character, void* buffer, size_t idx, size_t maxlen);
+// output state: characters are collected in 'buffer'; once it's full, it's either
+// passed to the chunk output function (if any) and reused, or further output is
+// discarded (but still counted)
+typedef struct {
+  char*  buffer;
+  size_t capacity;
+  size_t pos;
+  size_t total;
+  void   (*chunk)(const char* chunk, size_t length, void* arg);
+  void*  arg;
+} out_type;
 
 
-// wrapper (used as buffer) for output function type
+// wrapper (used as chunk output argument) for single character output functions
 typedef struct {
   void  (*fct)(char character, void* arg);
   void* arg;
 } out_fct_wrap_type;
 
 
-// internal buffer output
-static inline void _out_buffer(char character, void* buffer, size_t idx, size_t maxlen)
+// digit tables
+static const char _digits_lower[] = "0123456789abcdef";
+static const char _digits_upper[] = "0123456789ABCDEF";
+static const char _digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+
+// pass any buffered output to the chunk output function
+static void _out_flush(out_type* o)
 {
-  if (idx < maxlen) {
-    ((char*)buffer)[idx] = character;
+  if (o->chunk && o->pos) {
+    o->chunk(o->buffer, o->pos, o->arg);
+    o->pos = 0U;
   }
 }
 
 
-// internal null output
-static inline void _out_null(char character, void* buffer, size_t idx, size_t maxlen)
+// output a run of characters
+static void _out_chars(out_type* o, const char* str, size_t len)
 {
-  (void)character; (void)buffer; (void)idx; (void)maxlen;
+  o->total += len;
+
+  while (len) {
+    size_t room = o->capacity - o->pos;
+    if (!room) {
+      if (!o->chunk) {
+        return;
+      }
+      _out_flush(o);
+      room = o->capacity;
+    }
+
+    const size_t n = (len < room) ? len : room;
+    memcpy(o->buffer + o->pos, str, n);
+    o->pos += n;
+    str    += n;
+    len    -= n;
+  }
 }
 
 
-// internal output function wrapper
-static inline void _out_fct(char character, void* buffer, size_t idx, size_t maxlen)
+// output a character 'count' times
+static void _out_fill(out_type* o, char character, size_t count)
 {
-  (void)idx; (void)maxlen;
-  if (character) {
-    // buffer is the output fct pointer
-    ((out_fct_wrap_type*)buffer)->fct(character, ((out_fct_wrap_type*)buffer)->arg);
+  o->total += count;
+
+  while (count) {
+    size_t room = o->capacity - o->pos;
+    if (!room) {
+      if (!o->chunk) {
+        return;
+      }
+      _out_flush(o);
+      room = o->capacity;
+    }
+
+    const size_t n = (count < room) ? count : room;
+    memset(o->buffer + o->pos, character, n);
+    o->pos += n;
+    count  -= n;
+  }
+}
+
+
+// output a single character
+static inline void _out_char(out_type* o, char character)
+{
+  if ((o->pos == o->capacity) && o->chunk) {
+    _out_flush(o);
+  }
+  if (o->pos < o->capacity) {
+    o->buffer[o->pos++] = character;
+  }
+  o->total++;
+}
+
+
+// chunk output function that passes each character to a single character output function
+static void _out_fct(const char* chunk, size_t length, void* arg)
+{
+  const out_fct_wrap_type* wrap = (const out_fct_wrap_type*)arg;
+  for (size_t i = 0U; i < length; i++) {
+    wrap->fct(chunk[i], wrap->arg);
   }
 }
 
@@ -186,93 +276,91 @@ static unsigned int _atoi(const char** str)
 }
 
 
-// output the specified string in reverse, taking care of any zero-padding
-static size_t _out_rev(out_fct_type out, char* buffer, size_t idx, size_t maxlen, const char* buf, size_t len, unsigned int width, unsigned int flags)
+// output a field of 'len' characters, padded with spaces up to the given width
+static void _out_field(out_type* o, const char* str, size_t len, unsigned int width, unsigned int flags)
 {
-  const size_t start_idx = idx;
+  const size_t pad = (len < width) ? (width - len) : 0U;
 
-  // pad spaces up to given width
-  if (!(flags & FLAGS_LEFT) && !(flags & FLAGS_ZEROPAD)) {
-    for (size_t i = len; i < width; i++) {
-      out(' ', buffer, idx++, maxlen);
-    }
+  if (!(flags & FLAGS_LEFT)) {
+    _out_fill(o, ' ', pad);
   }
-
-  // reverse string
-  while (len) {
-    out(buf[--len], buffer, idx++, maxlen);
+  _out_chars(o, str, len);
+  if (flags & FLAGS_LEFT) {
+    _out_fill(o, ' ', pad);
   }
+}
 
-  // append pad spaces up to given width
-  if (flags & FLAGS_LEFT) {
-    while (idx - start_idx < width) {
-      out(' ', buffer, idx++, maxlen);
-    }
+
+// output the specified string in reverse, taking care of any zero-padding
+static void _out_rev(out_type* o, const char* buf, size_t len, unsigned int width, unsigned int flags)
+{
+  char rev[PRINTF_FTOA_BUFFER_SIZE];
+
+  if (len > sizeof(rev)) {
+    len = sizeof(rev);
+  }
+  for (size_t i = 0U; i < len; i++) {
+    rev[i] = buf[len - 1U - i];
   }
 
-  return idx;
+  // zero padding was already done by the caller
+  if (flags & FLAGS_ZEROPAD) {
+    flags |= FLAGS_LEFT;
+  }
+  _out_field(o, rev, len, width, flags);
 }
 
 
-// internal itoa format
-static size_t _ntoa_format(out_fct_type out, char* buffer, size_t idx, size_t maxlen, char* buf, size_t len, bool negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags)
+// convert an unsigned value to digits, which are written backwards from 'end'
+// \return Pointer to the most significant digit
+static char* _utoa(char* end, unsigned long long value, unsigned int base, unsigned int flags)
 {
-  // pad leading zeros
-  if (!(flags & FLAGS_LEFT)) {
-    if (width && (flags & FLAGS_ZEROPAD) && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
-      width--;
-    }
-    while ((len < prec) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-      buf[len++] = '0';
-    }
-    while ((flags & FLAGS_ZEROPAD) && (len < width) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-      buf[len++] = '0';
-    }
-  }
+  char* p = end;
 
-  // handle hash
-  if (flags & FLAGS_HASH) {
-    if (!(flags & FLAGS_PRECISION) && len && ((len == prec) || (len == width))) {
-      len--;
-      if (len && (base == 16U)) {
-        len--;
-      }
-    }
-    if ((base == 16U) && !(flags & FLAGS_UPPERCASE) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-      buf[len++] = 'x';
-    }
-    else if ((base == 16U) && (flags & FLAGS_UPPERCASE) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-      buf[len++] = 'X';
-    }
-    else if ((base == 2U) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-      buf[len++] = 'b';
+  if (base == 10U) {
+    // avoid (slow) 64-bit divisions where possible
+    while (value > (unsigned long)-1) {
+      const unsigned int r = (unsigned int)(value % 100U) * 2U;
+      value /= 100U;
+      *--p = _digit_pairs[r + 1U];
+      *--p = _digit_pairs[r];
     }
-    if (len < PRINTF_NTOA_BUFFER_SIZE) {
-      buf[len++] = '0';
-    }
-  }
 
-  if (len < PRINTF_NTOA_BUFFER_SIZE) {
-    if (negative) {
-      buf[len++] = '-';
+    unsigned long v = (unsigned long)value;
+    while (v >= 100U) {
+      const unsigned int r = (unsigned int)(v % 100U) * 2U;
+      v /= 100U;
+      *--p = _digit_pairs[r + 1U];
+      *--p = _digit_pairs[r];
     }
-    else if (flags & FLAGS_PLUS) {
-      buf[len++] = '+';  // ignore the space if the '+' exists
+    if (v >= 10U) {
+      *--p = _digit_pairs[v * 2U + 1U];
+      *--p = _digit_pairs[v * 2U];
     }
-    else if (flags & FLAGS_SPACE) {
-      buf[len++] = ' ';
+    else {
+      *--p = (char)('0' + v);
     }
   }
+  else {
+    // bases are powers of two
+    const char* digits = (flags & FLAGS_UPPERCASE) ? _digits_upper : _digits_lower;
+    const unsigned int shift = (base == 16U) ? 4U : (base == 8U) ? 3U : 1U;
+    do {
+      *--p = digits[value & (base - 1U)];
+      value >>= shift;
+    } while (value);
+  }
 
-  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+  return p;
 }
 
 
-// internal itoa for 'long' type
-static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long value, bool negative, unsigned long base, unsigned int prec, unsigned int width, unsigned int flags)
+// internal itoa
+static void _ntoa(out_type* o, unsigned long long value, bool negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags)
 {
   char buf[PRINTF_NTOA_BUFFER_SIZE];
-  size_t len = 0U;
+  char* end = buf + sizeof(buf);
+  const char* digits = end;
 
   // no hash for 0 values
   if (!value) {
@@ -280,54 +368,70 @@ static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxl
   }
 
   // write if precision != 0 and value is != 0
-  if (!(flags & FLAGS_PRECISION) || value) {
-    do {
-      const char digit = (char)(value % base);
-      buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-      value /= base;
-    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  if (!(flags & FLAGS_PRECISION) || prec || value) {
+    digits = _utoa(end, value, base, flags);
   }
+  const size_t len = (size_t)(end - digits);
 
-  return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
-}
-
+  // sign and prefix
+  char prefix[3];
+  size_t prefixLen = 0U;
 
-// internal itoa for 'long long' type
-#if defined(PRINTF_SUPPORT_LONG_LONG)
-static size_t _ntoa_long_long(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long long value, bool negative, unsigned long long base, unsigned int prec, unsigned int width, unsigned int flags)
-{
-  char buf[PRINTF_NTOA_BUFFER_SIZE];
-  size_t len = 0U;
+  if (negative) {
+    prefix[prefixLen++] = '-';
+  }
+  else if (flags & FLAGS_PLUS) {
+    prefix[prefixLen++] = '+';  // ignore the space if the '+' exists
+  }
+  else if (flags & FLAGS_SPACE) {
+    prefix[prefixLen++] = ' ';
+  }
 
-  // no hash for 0 values
-  if (!value) {
-    flags &= ~FLAGS_HASH;
+  if (flags & FLAGS_HASH) {
+    if (base == 16U) {
+      prefix[prefixLen++] = '0';
+      prefix[prefixLen++] = (flags & FLAGS_UPPERCASE) ? 'X' : 'x';
+    }
+    else if (base == 2U) {
+      prefix[prefixLen++] = '0';
+      prefix[prefixLen++] = 'b';
+    }
+    else if ((base == 8U) && (prec <= len)) {
+      prefix[prefixLen++] = '0';
+    }
   }
 
-  // write if precision != 0 and value is != 0
-  if (!(flags & FLAGS_PRECISION) || value) {
-    do {
-      const char digit = (char)(value % base);
-      buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-      value /= base;
-    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+  // leading zeros from the precision, or zero padding up to the width
+  size_t zeros = (prec > len) ? (prec - len) : 0U;
+  if ((flags & FLAGS_ZEROPAD) && !(flags & FLAGS_LEFT) && (prefixLen + zeros + len < width)) {
+    zeros = width - (prefixLen + len);
   }
 
-  return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
+  const size_t total = prefixLen + zeros + len;
+  const size_t pad = (total < width) ? (width - total) : 0U;
+
+  if (!(flags & FLAGS_LEFT)) {
+    _out_fill(o, ' ', pad);
+  }
+  _out_chars(o, prefix, prefixLen);
+  _out_fill(o, '0', zeros);
+  _out_chars(o, digits, len);
+  if (flags & FLAGS_LEFT) {
+    _out_fill(o, ' ', pad);
+  }
 }
-#endif  // PRINTF_SUPPORT_LONG_LONG
 
 
 #if defined(PRINTF_SUPPORT_FLOAT)
 
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
 // forward declaration so that _ftoa can switch to exp notation for values > PRINTF_MAX_FLOAT
-static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags);
+static void _etoa(out_type* o, double value, unsigned int prec, unsigned int width, unsigned int flags);
 #endif
 
 
 // internal ftoa for fixed decimal floating point
-static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+static void _ftoa(out_type* o, double value, unsigned int prec, unsigned int width, unsigned int flags)
 {
   char buf[PRINTF_FTOA_BUFFER_SIZE];
   size_t len  = 0U;
@@ -337,21 +441,26 @@ static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
   static const double pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
 
   // test for special values
-  if (value != value)
-    return _out_rev(out, buffer, idx, maxlen, "nan", 3, width, flags);
-  if (value < -DBL_MAX)
-    return _out_rev(out, buffer, idx, maxlen, "fni-", 4, width, flags);
-  if (value > DBL_MAX)
-    return _out_rev(out, buffer, idx, maxlen, (flags & FLAGS_PLUS) ? "fni+" : "fni", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
+  if (value != value) {
+    _out_field(o, "nan", 3U, width, flags);
+    return;
+  }
+  if (value < -DBL_MAX) {
+    _out_field(o, "-inf", 4U, width, flags);
+    return;
+  }
+  if (value > DBL_MAX) {
+    _out_field(o, (flags & FLAGS_PLUS) ? "+inf" : "inf", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
+    return;
+  }
 
   // test for very large values
   // standard printf behavior is to print EVERY whole number digit -- which could be 100s of characters overflowing your buffers == bad
   if ((value > PRINTF_MAX_FLOAT) || (value < -PRINTF_MAX_FLOAT)) {
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
-    return _etoa(out, buffer, idx, maxlen, value, prec, width, flags);
-#else
-    return 0U;
+    _etoa(o, value, prec, width, flags);
 #endif
+    return;
   }
 
   // test for negative
@@ -449,17 +558,18 @@ static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
     }
   }
 
-  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+  _out_rev(o, buf, len, width, flags);
 }
 
 
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
 // internal ftoa variant for exponential floating-point type, contributed by Martijn Jasperse <m.jasperse@gmail.com>
-static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+static void _etoa(out_type* o, double value, unsigned int prec, unsigned int width, unsigned int flags)
 {
   // check for NaN and special values
   if ((value != value) || (value > DBL_MAX) || (value < -DBL_MAX)) {
-    return _ftoa(out, buffer, idx, maxlen, value, prec, width, flags);
+    _ftoa(o, value, prec, width, flags);
+    return;
   }
 
   // determine the sign
@@ -544,50 +654,44 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
   }
 
   // output the floating part
-  const size_t start_idx = idx;
-  idx = _ftoa(out, buffer, idx, maxlen, negative ? -value : value, prec, fwidth, flags & ~FLAGS_ADAPT_EXP);
+  const size_t start = o->total;
+  _ftoa(o, negative ? -value : value, prec, fwidth, flags & ~FLAGS_ADAPT_EXP);
 
   // output the exponent part
   if (minwidth) {
     // output the exponential symbol
-    out((flags & FLAGS_UPPERCASE) ? 'E' : 'e', buffer, idx++, maxlen);
+    _out_char(o, (flags & FLAGS_UPPERCASE) ? 'E' : 'e');
     // output the exponent value
-    idx = _ntoa_long(out, buffer, idx, maxlen, (expval < 0) ? -expval : expval, expval < 0, 10, 0, minwidth-1, FLAGS_ZEROPAD | FLAGS_PLUS);
+    _ntoa(o, (unsigned long long)((expval < 0) ? -expval : expval), expval < 0, 10U, 0U, minwidth - 1U, FLAGS_ZEROPAD | FLAGS_PLUS);
     // might need to right-pad spaces
-    if (flags & FLAGS_LEFT) {
-      while (idx - start_idx < width) out(' ', buffer, idx++, maxlen);
+    if ((flags & FLAGS_LEFT) && (o->total - start < width)) {
+      _out_fill(o, ' ', width - (o->total - start));
     }
   }
-  return idx;
 }
 #endif  // PRINTF_SUPPORT_EXPONENTIAL
 #endif  // PRINTF_SUPPORT_FLOAT
 
 
 // internal vsnprintf
-static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const char* format, va_list va)
+static int _vsnprintf(out_type* o, const char* format, va_list va)
 {
   unsigned int flags, width, precision, n;
-  size_t idx = 0U;
-
-  if (!buffer) {
-    // use null output function
-    out = _out_null;
-  }
 
   while (*format)
   {
-    // format specifier?  %[flags][width][.precision][length]
+    // output everything up to the next format specifier in one go
     if (*format != '%') {
-      // no
-      out(*format, buffer, idx++, maxlen);
-      format++;
+      const char* start = format;
+      while (*format && (*format != '%')) {
+        format++;
+      }
+      _out_chars(o, start, (size_t)(format - start));
       continue;
     }
-    else {
-      // yes, evaluate it
-      format++;
-    }
+
+    // format specifier: %[flags][width][.precision][length]
+    format++;
 
     // evaluate flags
     flags = 0U;
@@ -715,31 +819,31 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
           if (flags & FLAGS_LONG_LONG) {
 #if defined(PRINTF_SUPPORT_LONG_LONG)
             const long long value = va_arg(va, long long);
-            idx = _ntoa_long_long(out, buffer, idx, maxlen, (unsigned long long)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+            _ntoa(o, value > 0 ? (unsigned long long)value : 0ULL - (unsigned long long)value, value < 0, base, precision, width, flags);
 #endif
           }
           else if (flags & FLAGS_LONG) {
             const long value = va_arg(va, long);
-            idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned long)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+            _ntoa(o, value > 0 ? (unsigned long)value : 0UL - (unsigned long)value, value < 0, base, precision, width, flags);
           }
           else {
             const int value = (flags & FLAGS_CHAR) ? (char)va_arg(va, int) : (flags & FLAGS_SHORT) ? (short int)va_arg(va, int) : va_arg(va, int);
-            idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned int)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+            _ntoa(o, value > 0 ? (unsigned int)value : 0U - (unsigned int)value, value < 0, base, precision, width, flags);
           }
         }
         else {
           // unsigned
           if (flags & FLAGS_LONG_LONG) {
 #if defined(PRINTF_SUPPORT_LONG_LONG)
-            idx = _ntoa_long_long(out, buffer, idx, maxlen, va_arg(va, unsigned long long), false, base, precision, width, flags);
+            _ntoa(o, va_arg(va, unsigned long long), false, base, precision, width, flags);
 #endif
           }
           else if (flags & FLAGS_LONG) {
-            idx = _ntoa_long(out, buffer, idx, maxlen, va_arg(va, unsigned long), false, base, precision, width, flags);
+            _ntoa(o, va_arg(va, unsigned long), false, base, precision, width, flags);
           }
           else {
             const unsigned int value = (flags & FLAGS_CHAR) ? (unsigned char)va_arg(va, unsigned int) : (flags & FLAGS_SHORT) ? (unsigned short int)va_arg(va, unsigned int) : va_arg(va, unsigned int);
-            idx = _ntoa_long(out, buffer, idx, maxlen, value, false, base, precision, width, flags);
+            _ntoa(o, value, false, base, precision, width, flags);
           }
         }
         format++;
@@ -749,7 +853,7 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
       case 'f' :
       case 'F' :
         if (*format == 'F') flags |= FLAGS_UPPERCASE;
-        idx = _ftoa(out, buffer, idx, maxlen, va_arg(va, double), precision, width, flags);
+        _ftoa(o, va_arg(va, double), precision, width, flags);
         format++;
         break;
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
@@ -759,53 +863,25 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
       case 'G':
         if ((*format == 'g')||(*format == 'G')) flags |= FLAGS_ADAPT_EXP;
         if ((*format == 'E')||(*format == 'G')) flags |= FLAGS_UPPERCASE;
-        idx = _etoa(out, buffer, idx, maxlen, va_arg(va, double), precision, width, flags);
+        _etoa(o, va_arg(va, double), precision, width, flags);
         format++;
         break;
 #endif  // PRINTF_SUPPORT_EXPONENTIAL
 #endif  // PRINTF_SUPPORT_FLOAT
       case 'c' : {
-        unsigned int l = 1U;
-        // pre padding
-        if (!(flags & FLAGS_LEFT)) {
-          while (l++ < width) {
-            out(' ', buffer, idx++, maxlen);
-          }
-        }
-        // char output
-        out((char)va_arg(va, int), buffer, idx++, maxlen);
-        // post padding
-        if (flags & FLAGS_LEFT) {
-          while (l++ < width) {
-            out(' ', buffer, idx++, maxlen);
-          }
-        }
+        const char c = (char)va_arg(va, int);
+        _out_field(o, &c, 1U, width, flags);
         format++;
         break;
       }
 
       case 's' : {
         const char* p = va_arg(va, char*);
-        unsigned int l = _strnlen_s(p, precision ? precision : (size_t)-1);
-        // pre padding
-        if (flags & FLAGS_PRECISION) {
-          l = (l < precision ? l : precision);
-        }
-        if (!(flags & FLAGS_LEFT)) {
-          while (l++ < width) {
-            out(' ', buffer, idx++, maxlen);
-          }
-        }
-        // string output
-        while ((*p != 0) && (!(flags & FLAGS_PRECISION) || precision--)) {
-          out(*(p++), buffer, idx++, maxlen);
-        }
-        // post padding
-        if (flags & FLAGS_LEFT) {
-          while (l++ < width) {
-            out(' ', buffer, idx++, maxlen);
-          }
+        if (!p) {
+          p = "(null)";
         }
+        const size_t l = _strnlen_s(p, (flags & FLAGS_PRECISION) ? precision : (size_t)-1);
+        _out_field(o, p, l, width, flags);
         format++;
         break;
       }
@@ -813,38 +889,47 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
       case 'p' : {
         width = sizeof(void*) * 2U;
         flags |= FLAGS_ZEROPAD | FLAGS_UPPERCASE;
-#if defined(PRINTF_SUPPORT_LONG_LONG)
-        const bool is_ll = sizeof(uintptr_t) == sizeof(long long);
-        if (is_ll) {
-          idx = _ntoa_long_long(out, buffer, idx, maxlen, (uintptr_t)va_arg(va, void*), false, 16U, precision, width, flags);
-        }
-        else {
-#endif
-          idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned long)((uintptr_t)va_arg(va, void*)), false, 16U, precision, width, flags);
-#if defined(PRINTF_SUPPORT_LONG_LONG)
-        }
-#endif
+        _ntoa(o, (uintptr_t)va_arg(va, void*), false, 16U, precision, width, flags);
         format++;
         break;
       }
 
       case '%' :
-        out('%', buffer, idx++, maxlen);
+        _out_char(o, '%');
         format++;
         break;
 
+      // a lone '%' at the end of the format string
+      case '\0' :
+        break;
+
       default :
-        out(*format, buffer, idx++, maxlen);
+        _out_char(o, *format);
         format++;
         break;
     }
   }
 
-  // termination
-  out((char)0, buffer, idx < maxlen ? idx : maxlen - 1U, maxlen);
+  // pass on any remaining output
+  _out_flush(o);
 
   // return written chars without terminating \0
-  return (int)idx;
+  return (int)o->total;
+}
+
+
+// format into a caller-provided buffer, truncating the output if needed
+static int _vsnprintf_buffer(char* buffer, size_t count, const char* format, va_list va)
+{
+  out_type o = { buffer, buffer ? count : 0U, 0U, 0U, NULL, NULL };
+
+  const int ret = _vsnprintf(&o, format, va);
+
+  // termination
+  if (o.capacity) {
+    buffer[(o.pos < o.capacity) ? o.pos : (o.capacity - 1U)] = '\0';
+  }
+  return ret;
 }
 
 
@@ -855,7 +940,7 @@ int sprintf(char* buffer, const char* format, ...)
 {
   va_list va;
   va_start(va, format);
-  const int ret = _vsnprintf(_out_buffer, buffer, (size_t)-1, format, va);
+  const int ret = _vsnprintf_buffer(buffer, (size_t)-1, format, va);
   va_end(va);
   return ret;
 }
@@ -865,7 +950,7 @@ int snprintf(char* buffer, size_t count, const char* format, ...)
 {
   va_list va;
   va_start(va, format);
-  const int ret = _vsnprintf(_out_buffer, buffer, count, format, va);
+  const int ret = _vsnprintf_buffer(buffer, count, format, va);
   va_end(va);
   return ret;
 }
@@ -873,28 +958,37 @@ int snprintf(char* buffer, size_t count, const char* format, ...)
 
 int vsnprintf(char* buffer, size_t count, const char* format, va_list va)
 {
-  return _vsnprintf(_out_buffer, buffer, count, format, va);
+  return _vsnprintf_buffer(buffer, count, format, va);
 }
 
 
-int fctprintf(void (*out)(char character, void* arg), void* arg, const char* format, ...)
+int chunkprintf(void (*out)(const char* chunk, size_t length, void* arg), void* arg, const char* format, ...)
 {
   va_list va;
   va_start(va, format);
-  const out_fct_wrap_type out_fct_wrap = { out, arg };
-  const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
+  const int ret = vchunkprintf(out, arg, format, va);
   va_end(va);
   return ret;
 }
 
-int fctvprintf(void (*out)(char character, void* arg), void* arg, const char* format, va_list va) {
-  const out_fct_wrap_type out_fct_wrap = { out, arg };
-  const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
-  return ret;
+int vchunkprintf(void (*out)(const char* chunk, size_t length, void* arg), void* arg, const char* format, va_list va)
+{
+  char buffer[PRINTF_CHUNK_BUFFER_SIZE];
+  out_type o = { buffer, sizeof(buffer), 0U, 0U, out, arg };
+  return _vsnprintf(&o, format, va);
 }
 
-/// wide char printf not yet implemented
-int swprintf (wchar_t* ws, size_t len, const wchar_t* format, ...) {
-    abort();
+
+int fctprintf(void (*out)(char character, void* arg), void* arg, const char* format, ...)
+{
+  va_list va;
+  va_start(va, format);
+  const int ret = fctvprintf(out, arg, format, va);
+  va_end(va);
+  return ret;
 }
 
+int fctvprintf(void (*out)(char character, void* arg), void* arg, const char* format, va_list va) {
+  out_fct_wrap_type out_fct_wrap = { out, arg };
+  return vchunkprintf(_out_fct, &out_fct_wrap, format, va);
+}
@@ -0,0 +1,7 @@
+#include <stdlib.h>
+#include <wchar.h>
+
+/// wide char printf not yet implemented
+int swprintf (wchar_t* ws, size_t len, const wchar_t* format, ...) {
+    abort();
+}
@@ -1,15 +1,23 @@
 #include <threads.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <sys/syscalls.h>
 
+/*
+ * Condition variables are implemented the same way as mutexes: the value of the condition
+ * variable is a sequence number, which is incremented every time it is signalled. Waiters
+ * remember the sequence number before releasing the mutex, then yield until it changes.
+ *
+ * Since all waiters observe the same change, signalling wakes all of them; this is permitted,
+ * as condition variable waits may always return spuriously.
+ */
+
 /**
  * Initializes a condition variable.
  */
 int cnd_init(cnd_t *cond) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-
     memset(cond, 0, sizeof(cnd_t));
     return thrd_success;
 }
@@ -18,25 +26,23 @@ int cnd_init(cnd_t *cond) {
  * Releases condition variable resources.
  */
 void cnd_destroy(cnd_t *cond) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-    // TODO: implements
+    // nothing
 }
 
 /**
  * Wakes up one of the threads waiting on us.
  */
 int cnd_signal(cnd_t *cond) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-    // TODO: implement
-    return thrd_error;
+    __atomic_add_fetch(&cond->value, 1, __ATOMIC_RELEASE);
+    return thrd_success;
 }
 
 /**
  * Unblocks all threads waiting on us.
  */
 int cnd_broadcast(cnd_t *cond) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-    return thrd_error;
+    __atomic_add_fetch(&cond->value, 1, __ATOMIC_RELEASE);
+    return thrd_success;
 }
 
 /**
@@ -46,14 +52,42 @@ int cnd_broadcast(cnd_t *cond) {
  * mutex will be locked before we return.
  */
 int cnd_wait(cnd_t *cond, mtx_t *mtx) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-    return thrd_error;
+    const uintptr_t seq = __atomic_load_n(&cond->value, __ATOMIC_ACQUIRE);
+    mtx_unlock(mtx);
+
+    while(__atomic_load_n(&cond->value, __ATOMIC_ACQUIRE) == seq) {
+        thrd_yield();
+    }
+
+    mtx_lock(mtx);
+    return thrd_success;
 }
 
 /**
  * Same as cnd_wait, but with the addition of a timeout.
+ *
+ * The time point is measured against the system uptime, since that is the only clock available.
  */
 int cnd_timedwait(cnd_t *cond, mtx_t *mtx, const struct timespec *ts) {
-    fprintf(stderr, "%s unimplemented\n", __FUNCTION__);
-    return thrd_error;
+    struct timespec now;
+    int ret = thrd_success;
+
+    const uintptr_t seq = __atomic_load_n(&cond->value, __ATOMIC_ACQUIRE);
+    mtx_unlock(mtx);
+
+    while(__atomic_load_n(&cond->value, __ATOMIC_ACQUIRE) == seq) {
+        if(clock_gettime(CLOCK_UPTIME_RAW, &now)) {
+            ret = thrd_error;
+            break;
+        }
+        if(now.tv_sec > ts->tv_sec || (now.tv_sec == ts->tv_sec && now.tv_nsec >= ts->tv_nsec)) {
+            ret = thrd_timedout;
+            break;
+        }
+
+        thrd_yield();
+    }
+
+    mtx_lock(mtx);
+    return ret;
 }
@@ -1,5 +1,6 @@
 #include "thread_info.h"
 #include "tls.h"
+#include "mem/malloc_private.h"
 
 #include <assert.h>
 #include <malloc.h>
@@ -192,7 +193,8 @@ void thrd_exit(int res) {
 
     // TODO: get rid of the stack
 
-    // release thread locals
+    // return cached memory, then release thread locals
+    __libc_malloc_thread_fini();
     __libc_tls_fini();
 
     // terminate the thread
@@ -4,6 +4,7 @@
 #include "tls.h"
 #include "tss_private.h"
 #include "thread_info.h"
+#include "../mem/malloc_private.h"
 
 #include <threads.h>
 
@@ -96,9 +97,9 @@ LIBC_INTERNAL void __libc_tls_fini() {
     // zero out the pointer
     SetCurrentTlsBase(NULL);
 
-    // release the structure
+    // release the structure; TLS is gone, so the thread cache can't be used
     if(thrd->tls.s.base) {
-        free(thrd->tls.s.base);
+        __libc_free_uncached(thrd->tls.s.base);
     }
 }
 
@@ -110,7 +111,6 @@ LIBC_INTERNAL void __libc_tls_fini() {
 static void *AllocTls() {
     uthread_t *thrd = thrd_current();
 
-    int err;
     void *base;
 
     // how much thread local storage do we need?
@@ -122,8 +122,9 @@ static void *AllocTls() {
     size_t allocAlign = max(tlsAlignment, alignof(tls_block_static_t));
     size_t allocSize = alignup(tlsSize, allocAlign) + sizeof(tls_block_static_t);
 
-    err = posix_memalign(&base, allocAlign, allocSize);
-    assert(!err);
+    // the thread's TLS isn't set up yet, so bypass the thread cache
+    base = __libc_memalign_uncached(allocAlign, allocSize);
+    assert(base);
 
     memset(base, 0, allocAlign);
 
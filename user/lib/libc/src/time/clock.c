@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <time.h>
 
+#if defined(__i386__)
 /// Kernel time info structure
 struct TimeInfo {
     /// Seconds of kernel uptime
@@ -16,6 +17,81 @@ struct TimeInfo {
 /// Pointer to kernel info structure
 static const struct TimeInfo *gTimeInfo = (struct TimeInfo *) 0xBF5FD000;
 
+#elif defined(__amd64__)
+/// Kernel time info structure
+struct TimeInfo {
+    /// Sequence number; odd while the kernel is updating the structure
+    uint64_t sequence;
+    /// Nanoseconds of kernel uptime
+    uint64_t timeNsec;
+    /// Time counter value when this was written
+    uint64_t kernelTsc;
+    /// Nanoseconds per time counter tick, as fixed point with 24 fractional bits; 0 if not known
+    uint64_t nsPerTick;
+};
+
+/// Number of fractional bits in the time counter rate
+#define TIME_RATE_SHIFT                 24
+
+/// Pointer to kernel info structure
+static const struct TimeInfo *gTimeInfo = (struct TimeInfo *) 0x7FFF00100000;
+
+#else
+#error Unsupported architecture
+#endif
+
+/**
+ * Reads the system uptime from the kernel's time page.
+ */
+static void ReadUptime(struct timespec *tp) {
+#if defined(__i386__)
+    uint32_t sec1, sec2, nsec;
+
+    __atomic_load(&gTimeInfo->timeSecs, &sec1, __ATOMIC_ACQUIRE);
+    __atomic_load(&gTimeInfo->timeNsec, &nsec, __ATOMIC_ACQUIRE);
+    __atomic_load(&gTimeInfo->timeSecs2, &sec2, __ATOMIC_ACQUIRE);
+
+    // if sec2 is different than sec1, it will be newer, so use it, and reset nsec
+    if(sec1 != sec2) {
+        nsec = 0;
+        sec1 = sec2;
+    }
+
+    // TODO: apply an offset via RDTSC
+
+    tp->tv_sec = sec1;
+    tp->tv_nsec = nsec;
+#elif defined(__amd64__)
+    uint64_t seq, nsec, tsc, rate;
+    uint32_t low, high;
+
+    // read the base time published by the kernel
+    do {
+        seq = __atomic_load_n(&gTimeInfo->sequence, __ATOMIC_ACQUIRE);
+        if(seq & 1) continue;
+
+        nsec = __atomic_load_n(&gTimeInfo->timeNsec, __ATOMIC_RELAXED);
+        tsc = __atomic_load_n(&gTimeInfo->kernelTsc, __ATOMIC_RELAXED);
+        rate = __atomic_load_n(&gTimeInfo->nsPerTick, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while((seq & 1) || __atomic_load_n(&gTimeInfo->sequence, __ATOMIC_RELAXED) != seq);
+
+    // extrapolate from it by the time counter ticks elapsed since
+    if(rate) {
+        __asm__ volatile("lfence; rdtsc; lfence" : "=a"(low), "=d"(high) : : "memory");
+        const uint64_t now = ((uint64_t) high << 32) | low;
+
+        // another processor's counter may be slightly behind the one the base was taken on
+        if(now > tsc) {
+            nsec += (uint64_t) (((unsigned __int128) (now - tsc) * rate) >> TIME_RATE_SHIFT);
+        }
+    }
+
+    tp->tv_sec = nsec / 1000000000ULL;
+    tp->tv_nsec = nsec % 1000000000ULL;
+#endif
+}
 
 /**
  * Reads out the current time according to the specified clock id.
@@ -28,26 +104,9 @@ int clock_gettime(clockid_t clockId, struct timespec *tp) {
 
     switch(clockId) {
         // read system uptime from time page
-        case CLOCK_UPTIME_RAW: {
-            uint32_t sec1, sec2, nsec;
-
-            __atomic_load(&gTimeInfo->timeSecs, &sec1, __ATOMIC_ACQUIRE);
-            __atomic_load(&gTimeInfo->timeNsec, &nsec, __ATOMIC_ACQUIRE);
-            __atomic_load(&gTimeInfo->timeSecs2, &sec2, __ATOMIC_ACQUIRE);
-
-            // if sec2 is different than sec1, it will be newer, so use it, and reset nsec
-            if(sec1 != sec2) {
-                nsec = 0;
-                sec1 = sec2;
-            }
-
-            // TODO: apply an offset via RDTSC
-
-            // write to output
-            tp->tv_sec = sec1;
-            tp->tv_nsec = nsec;
+        case CLOCK_UPTIME_RAW:
+            ReadUptime(tp);
             return 0;
-        }
 
         // unsupported clock
         default:
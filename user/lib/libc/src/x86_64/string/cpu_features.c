@@ -0,0 +1,37 @@
+#include "cpu_features.h"
+
+#include <cpuid.h>
+
+// CPUID leaf 7 EBX: enhanced rep movsb/stosb (not defined by all compilers' cpuid.h)
+#define kCpuidErms                      (1 << 9)
+
+/// Features of the processor we're running on
+LIBC_INTERNAL struct __libc_cpu_features __libc_cpu = {
+    .erms = false,
+    .avx2 = false,
+};
+
+/**
+ * Queries the processor features relevant to the string routines.
+ *
+ * AVX2 is only used if the kernel enabled the AVX register state (XCR0 bits 1 and 2); otherwise,
+ * executing AVX instructions would fault.
+ */
+void __libc_cpu_init() {
+    uint32_t eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(0x01, &eax, &ebx, &ecx, &edx)) return;
+    const bool osxsave = (ecx & bit_OSXSAVE), avx = (ecx & bit_AVX);
+
+    if(__get_cpuid_max(0, NULL) < 0x07) return;
+    __cpuid_count(0x07, 0, eax, ebx, ecx, edx);
+
+    __libc_cpu.erms = (ebx & kCpuidErms);
+
+    if(osxsave && avx && (ebx & bit_AVX2)) {
+        uint32_t xcr0Lo, xcr0Hi;
+        __asm__ volatile("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+
+        __libc_cpu.avx2 = ((xcr0Lo & 0x6) == 0x6);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef LIBC_X86_64_STRING_CPU_FEATURES_H
+#define LIBC_X86_64_STRING_CPU_FEATURES_H
+
+#include <_libc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Processor features used to select the implementation of the string routines. Until they are
+ * detected (during libc initialization) all are false, and the baseline SSE2 code is used.
+ */
+struct __libc_cpu_features {
+    /// enhanced rep movsb/stosb (ERMS)
+    bool erms;
+    /// AVX2 is supported by the processor and its state is enabled by the kernel
+    bool avx2;
+};
+
+LIBC_INTERNAL extern struct __libc_cpu_features __libc_cpu;
+
+/// Minimum size for which we use rep movsb/stosb, if the processor has ERMS
+#define kRepStringThreshold             (2048)
+/// Minimum size for which the AVX2 loops are used
+#define kAvx2Threshold                  (256)
+
+/// Unaligned accesses to memory, for the small size copies
+typedef uint64_t __attribute__((aligned(1), may_alias)) unaligned_u64;
+typedef uint32_t __attribute__((aligned(1), may_alias)) unaligned_u32;
+typedef uint16_t __attribute__((aligned(1), may_alias)) unaligned_u16;
+
+LIBC_INTERNAL void __libc_cpu_init();
+
+#endif
@@ -0,0 +1,46 @@
+#include <string.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+
+#include "cpu_features.h"
+
+/*
+ * Finds the first occurrence of value in the first num bytes of ptr.
+ *
+ * The buffer is scanned 16 bytes at a time, with aligned loads: these never cross a page boundary,
+ * so bytes before the start or after the end of the buffer may be read (but are ignored) without
+ * the risk of faulting.
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcast-qual"
+
+void *memchr(const void *ptr, const int value, const size_t num) {
+    if(!num) return NULL;
+
+    const char *start = (const char *) ptr;
+    const __m128i needle = _mm_set1_epi8((char) value);
+
+    // first block: ignore the bytes before the start of the buffer
+    const uintptr_t misalign = (uintptr_t) start & 15;
+    const char *block = start - misalign;
+
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) block),
+                needle)) >> misalign;
+    size_t off = 0;
+
+    while(1) {
+        if(mask) {
+            const size_t found = off + __builtin_ctz(mask);
+            return (found < num) ? (void *) (start + found) : NULL;
+        }
+
+        off += 16 - (off ? 0 : misalign);
+        if(off >= num) return NULL;
+
+        block = start + off;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) block), needle));
+    }
+}
+
+#pragma clang diagnostic pop
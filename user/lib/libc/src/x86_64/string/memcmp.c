@@ -0,0 +1,48 @@
+#include <string.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+
+#include "cpu_features.h"
+
+/*
+ * Compares the first num bytes in two blocks of memory.
+ *
+ * Returns 0 if equal, a value greater than 0 if the first differing byte in ptr1 is greater than
+ * the one in ptr2; and a value less than zero if the opposite. Note that these comparisons are
+ * performed on uint8_t types.
+ *
+ * Blocks are compared 16 bytes at a time; a trailing partial block is compared by re-reading the
+ * last 16 bytes of both buffers.
+ */
+int memcmp(const void *ptr1, const void *ptr2, const size_t num) {
+    const uint8_t *a = (const uint8_t *) ptr1;
+    const uint8_t *b = (const uint8_t *) ptr2;
+
+    if(num < 16) {
+        for(size_t i = 0; i < num; i++) {
+            if(a[i] != b[i]) return (a[i] > b[i]) ? 1 : -1;
+        }
+        return 0;
+    }
+
+    size_t off = 0;
+    while(1) {
+        // last block overlaps with the previous one
+        if(off + 16 > num) {
+            off = num - 16;
+        }
+
+        const __m128i va = _mm_loadu_si128((const __m128i *) (a + off));
+        const __m128i vb = _mm_loadu_si128((const __m128i *) (b + off));
+        const uint32_t diff = ~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xFFFF;
+
+        if(diff) {
+            const size_t i = off + __builtin_ctz(diff);
+            return (a[i] > b[i]) ? 1 : -1;
+        }
+
+        off += 16;
+        if(off >= num) return 0;
+    }
+}
@@ -0,0 +1,171 @@
+#include <string.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+/**
+ * Copies up to 64 bytes. All loads are performed before any stores, so this is safe to use even if
+ * the buffers overlap.
+ *
+ * Sizes that aren't a power of two are handled by two overlapping accesses, one at the start and
+ * one at the end of the buffer.
+ */
+static inline void CopySmall(char *dst, const char *src, const size_t n) {
+    if(n >= 32) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) src);
+        const __m128i b = _mm_loadu_si128((const __m128i *) (src + 16));
+        const __m128i c = _mm_loadu_si128((const __m128i *) (src + n - 32));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (src + n - 16));
+        _mm_storeu_si128((__m128i *) dst, a);
+        _mm_storeu_si128((__m128i *) (dst + 16), b);
+        _mm_storeu_si128((__m128i *) (dst + n - 32), c);
+        _mm_storeu_si128((__m128i *) (dst + n - 16), d);
+    } else if(n >= 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) src);
+        const __m128i b = _mm_loadu_si128((const __m128i *) (src + n - 16));
+        _mm_storeu_si128((__m128i *) dst, a);
+        _mm_storeu_si128((__m128i *) (dst + n - 16), b);
+    } else if(n >= 8) {
+        const uint64_t a = *(const unaligned_u64 *) src, b = *(const unaligned_u64 *) (src + n - 8);
+        *(unaligned_u64 *) dst = a;
+        *(unaligned_u64 *) (dst + n - 8) = b;
+    } else if(n >= 4) {
+        const uint32_t a = *(const unaligned_u32 *) src, b = *(const unaligned_u32 *) (src + n - 4);
+        *(unaligned_u32 *) dst = a;
+        *(unaligned_u32 *) (dst + n - 4) = b;
+    } else if(n >= 2) {
+        const uint16_t a = *(const unaligned_u16 *) src, b = *(const unaligned_u16 *) (src + n - 2);
+        *(unaligned_u16 *) dst = a;
+        *(unaligned_u16 *) (dst + n - 2) = b;
+    } else if(n) {
+        *dst = *src;
+    }
+}
+
+/**
+ * Copies more than 64 bytes with 16 byte SSE2 accesses; stores are aligned. The first and last
+ * 16 bytes are copied with unaligned accesses.
+ */
+static void CopySse2(char *dst, const char *src, const size_t n) {
+    const __m128i head = _mm_loadu_si128((const __m128i *) src);
+    const __m128i tail = _mm_loadu_si128((const __m128i *) (src + n - 16));
+
+    size_t off = 16 - ((uintptr_t) dst & 15);
+
+    for(; off + 64 <= n - 16; off += 64) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) (src + off));
+        const __m128i b = _mm_loadu_si128((const __m128i *) (src + off + 16));
+        const __m128i c = _mm_loadu_si128((const __m128i *) (src + off + 32));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (src + off + 48));
+        _mm_store_si128((__m128i *) (dst + off), a);
+        _mm_store_si128((__m128i *) (dst + off + 16), b);
+        _mm_store_si128((__m128i *) (dst + off + 32), c);
+        _mm_store_si128((__m128i *) (dst + off + 48), d);
+    }
+    for(; off < n - 16; off += 16) {
+        _mm_store_si128((__m128i *) (dst + off), _mm_loadu_si128((const __m128i *) (src + off)));
+    }
+
+    _mm_storeu_si128((__m128i *) dst, head);
+    _mm_storeu_si128((__m128i *) (dst + n - 16), tail);
+}
+
+/**
+ * Copies at least 64 bytes with 32 byte AVX2 accesses; like the SSE2 version, but wider.
+ */
+__attribute__((target("avx2")))
+static void CopyAvx2(char *dst, const char *src, const size_t n) {
+    const __m256i head = _mm256_loadu_si256((const __m256i *) src);
+    const __m256i tail = _mm256_loadu_si256((const __m256i *) (src + n - 32));
+
+    size_t off = 32 - ((uintptr_t) dst & 31);
+
+    for(; off + 128 <= n - 32; off += 128) {
+        const __m256i a = _mm256_loadu_si256((const __m256i *) (src + off));
+        const __m256i b = _mm256_loadu_si256((const __m256i *) (src + off + 32));
+        const __m256i c = _mm256_loadu_si256((const __m256i *) (src + off + 64));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (src + off + 96));
+        _mm256_store_si256((__m256i *) (dst + off), a);
+        _mm256_store_si256((__m256i *) (dst + off + 32), b);
+        _mm256_store_si256((__m256i *) (dst + off + 64), c);
+        _mm256_store_si256((__m256i *) (dst + off + 96), d);
+    }
+    for(; off < n - 32; off += 32) {
+        _mm256_store_si256((__m256i *) (dst + off),
+                _mm256_loadu_si256((const __m256i *) (src + off)));
+    }
+
+    _mm256_storeu_si256((__m256i *) dst, head);
+    _mm256_storeu_si256((__m256i *) (dst + n - 32), tail);
+}
+
+/*
+ * Copies num bytes from source to destination.
+ *
+ * Small copies use overlapping unaligned accesses; medium sized ones SSE2 or AVX2 loops, and
+ * large copies use `rep movsb` if the processor implements it efficiently (ERMS).
+ */
+void *memcpy(void *destination, const void *source, const size_t num) {
+    char *dst = (char *) destination;
+    const char *src = (const char *) source;
+
+    if(num <= 64) {
+        CopySmall(dst, src, num);
+    } else if(num >= kRepStringThreshold && __libc_cpu.erms) {
+        size_t count = num;
+        __asm__ volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(count) :: "memory");
+    } else if(num >= kAvx2Threshold && __libc_cpu.avx2) {
+        CopyAvx2(dst, src, num);
+    } else {
+        CopySse2(dst, src, num);
+    }
+
+    return destination;
+}
+
+/**
+ * Moves the given memory region; they can overlap.
+ *
+ * Regions that don't overlap are copied with memcpy(). Otherwise, we copy in 16 byte chunks, in
+ * the direction that ensures no chunk is overwritten before it's been read.
+ */
+void *memmove(void *dest, const void *src, const size_t n) {
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    if(n <= 64) {
+        CopySmall(d, s, n);
+        return dest;
+    }
+    // no overlap
+    else if(((uintptr_t) d - (uintptr_t) s) >= n && ((uintptr_t) s - (uintptr_t) d) >= n) {
+        return memcpy(dest, src, n);
+    }
+
+    // copy forwards
+    if(d < s) {
+        size_t off = 0;
+        for(; off + 16 <= n; off += 16) {
+            _mm_storeu_si128((__m128i *) (d + off), _mm_loadu_si128((const __m128i *) (s + off)));
+        }
+        for(; off < n; off++) {
+            d[off] = s[off];
+        }
+    }
+    // copy backwards
+    else if(d > s) {
+        size_t off = n;
+        for(; off >= 16; off -= 16) {
+            _mm_storeu_si128((__m128i *) (d + off - 16),
+                    _mm_loadu_si128((const __m128i *) (s + off - 16)));
+        }
+        while(off--) {
+            d[off] = s[off];
+        }
+    }
+
+    return dest;
+}
@@ -0,0 +1,81 @@
+#include <string.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+/**
+ * Fills more than 32 bytes with AVX2 stores; the first and last 32 bytes are unaligned stores,
+ * everything in between is aligned.
+ */
+__attribute__((target("avx2")))
+static void FillAvx2(char *dst, const uint8_t value, const size_t n) {
+    const __m256i v = _mm256_set1_epi8(value);
+
+    _mm256_storeu_si256((__m256i *) dst, v);
+
+    size_t off = 32 - ((uintptr_t) dst & 31);
+    for(; off < n - 32; off += 32) {
+        _mm256_store_si256((__m256i *) (dst + off), v);
+    }
+
+    _mm256_storeu_si256((__m256i *) (dst + n - 32), v);
+}
+
+/*
+ * Fills a given segment of memory with a specified value.
+ *
+ * Like memcpy(), small sizes are handled with overlapping stores; larger ones with aligned vector
+ * stores, or `rep stosb` if supported efficiently.
+ */
+void *memset(void *ptr, const int value, const size_t num) {
+    char *dst = (char *) ptr;
+    const uint8_t byte = value;
+
+    if(num < 16) {
+        const uint64_t v = 0x0101010101010101ULL * byte;
+
+        if(num >= 8) {
+            *(unaligned_u64 *) dst = v;
+            *(unaligned_u64 *) (dst + num - 8) = v;
+        } else if(num >= 4) {
+            *(unaligned_u32 *) dst = v;
+            *(unaligned_u32 *) (dst + num - 4) = v;
+        } else if(num >= 2) {
+            *(unaligned_u16 *) dst = v;
+            *(unaligned_u16 *) (dst + num - 2) = v;
+        } else if(num) {
+            *dst = byte;
+        }
+    } else if(num <= 32) {
+        const __m128i v = _mm_set1_epi8(byte);
+        _mm_storeu_si128((__m128i *) dst, v);
+        _mm_storeu_si128((__m128i *) (dst + num - 16), v);
+    } else if(num >= kRepStringThreshold && __libc_cpu.erms) {
+        size_t count = num;
+        __asm__ volatile("rep stosb" : "+D"(dst), "+c"(count) : "a"(byte) : "memory");
+    } else if(num >= kAvx2Threshold && __libc_cpu.avx2) {
+        FillAvx2(dst, byte, num);
+    } else {
+        const __m128i v = _mm_set1_epi8(byte);
+        _mm_storeu_si128((__m128i *) dst, v);
+
+        size_t off = 16 - ((uintptr_t) dst & 15);
+        for(; off < num - 16; off += 16) {
+            _mm_store_si128((__m128i *) (dst + off), v);
+        }
+
+        _mm_storeu_si128((__m128i *) (dst + num - 16), v);
+    }
+
+    return ptr;
+}
+
+/*
+ * Clears count bytes of memory, starting at start, with 0x00.
+ */
+void *memclr(void *start, const size_t count) {
+    return memset(start, 0, count);
+}
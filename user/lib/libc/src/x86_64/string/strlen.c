@@ -0,0 +1,55 @@
+#include <string.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+/**
+ * Finds the terminating NUL byte with AVX2; aligned 32 byte loads never cross a page boundary, so
+ * they can't fault even if they read past the end of the string.
+ */
+__attribute__((target("avx2")))
+static size_t StrlenAvx2(const char *str) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    const uintptr_t misalign = (uintptr_t) str & 31;
+    const char *block = str - misalign;
+
+    uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_load_si256((const __m256i *) block), zero)) >> misalign;
+    if(mask) return __builtin_ctz(mask);
+
+    while(1) {
+        block += 32;
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_load_si256((const __m256i *) block), zero));
+        if(mask) return (block - str) + __builtin_ctz(mask);
+    }
+}
+
+/*
+ * Returns the length of the string, scanning 16 (SSE2) or 32 (AVX2) bytes at a time. Like for
+ * memchr(), all loads are aligned.
+ */
+size_t strlen(const char *str) {
+    if(__libc_cpu.avx2) {
+        return StrlenAvx2(str);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+
+    const uintptr_t misalign = (uintptr_t) str & 15;
+    const char *block = str - misalign;
+
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) block),
+                zero)) >> misalign;
+    if(mask) return __builtin_ctz(mask);
+
+    while(1) {
+        block += 16;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) block), zero));
+        if(mask) return (block - str) + __builtin_ctz(mask);
+    }
+}
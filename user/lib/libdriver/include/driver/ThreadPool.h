@@ -0,0 +1 @@
+../../src/thread/ThreadPool.h
\ No newline at end of file
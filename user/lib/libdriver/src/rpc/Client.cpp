@@ -1,8 +1,11 @@
 #include "Client.h"
 
+#include <mpack/mpack.h>
 #include <rpc/rt/ClientPortRpcStream.h>
+#include <sys/syscalls.h>
 
 #include <cstdio>
+#include <cstdlib>
 
 using namespace libdriver;
 
@@ -31,18 +34,210 @@ void RpcClient::SetDeviceProperty(const std::string_view &_path, const std::stri
     this->SetDeviceProperty(path, key, data);
 }
 /**
- * Allows getting keys with a string_view instead of a string.
+ * Allows getting keys with a string_view instead of a string. If the device's properties are
+ * being cached, the cached value is returned if available.
  */
 RpcClient::ByteVec RpcClient::GetDeviceProperty(const std::string_view &_path,
         const std::string_view &_key) {
     const std::string path(_path), key(_key);
+
+    uint64_t generation;
+    std::optional<ByteVec> cached;
+    if(this->getCachedProperty(path, key, cached, generation)) {
+        return cached.value_or(ByteVec());
+    }
+
     auto ret = this->GetDeviceProperty(path, key);
 
     // TODO: handle error codes
-    if(ret.status) {
+    if(ret.status == kNoSuchPropertyStatus) {
+        this->cacheProperty(path, key, std::nullopt, generation);
+        return {};
+    } else if(ret.status) {
         fprintf(stderr, "%s failed: %d\n", __PRETTY_FUNCTION__, ret.status);
+    } else {
+        this->cacheProperty(path, key, ret.data, generation);
     }
 
     return ret.data;
 }
 
+/**
+ * Reads multiple properties of a device with a single request. Any properties that are cached are
+ * not requested again.
+ *
+ * @return Map of key to value for all properties that exist on the device
+ */
+RpcClient::PropertyMap RpcClient::GetDeviceProperties(const std::string_view &_path,
+        const std::span<const std::string_view> &keys) {
+    const std::string path(_path);
+    PropertyMap out;
+    std::vector<std::string> toFetch;
+    uint64_t generation{0};
+    bool haveGeneration{false};
+
+    // satisfy as many keys as we can from the cache
+    for(const auto &_key : keys) {
+        const std::string key(_key);
+        std::optional<ByteVec> cached;
+        uint64_t keyGeneration;
+
+        const bool found = this->getCachedProperty(path, key, cached, keyGeneration);
+        if(!haveGeneration) {
+            generation = keyGeneration;
+            haveGeneration = true;
+        }
+
+        if(found) {
+            if(cached) out.emplace(key, std::move(*cached));
+        } else {
+            toFetch.push_back(key);
+        }
+    }
+
+    if(toFetch.empty()) return out;
+
+    // encode the list of keys
+    char *data;
+    size_t size;
+
+    mpack_writer_t writer;
+    mpack_writer_init_growable(&writer, &data, &size);
+    mpack_start_array(&writer, toFetch.size());
+    for(const auto &key : toFetch) {
+        mpack_write_str(&writer, key.data(), key.length());
+    }
+    mpack_finish_array(&writer);
+
+    if(mpack_writer_destroy(&writer) != mpack_ok) {
+        fprintf(stderr, "%s failed: %s\n", __PRETTY_FUNCTION__, "mpack_writer_destroy");
+        return out;
+    }
+
+    ByteVec request(reinterpret_cast<std::byte *>(data),
+            reinterpret_cast<std::byte *>(data + size));
+    free(data);
+
+    // send request
+    auto ret = this->GetDeviceProperties(path, request);
+    if(ret.status) {
+        fprintf(stderr, "%s failed: %d\n", __PRETTY_FUNCTION__, ret.status);
+        return out;
+    }
+
+    // decode the returned map
+    mpack_tree_t tree;
+    mpack_tree_init_data(&tree, reinterpret_cast<const char *>(ret.data.data()), ret.data.size());
+    mpack_tree_parse(&tree);
+
+    mpack_node_t root = mpack_tree_root(&tree);
+    const auto numValues = mpack_node_map_count(root);
+
+    for(size_t i = 0; i < numValues; i++) {
+        auto keyNode = mpack_node_map_key_at(root, i);
+        auto valueNode = mpack_node_map_value_at(root, i);
+
+        std::string key(mpack_node_str(keyNode), mpack_node_strlen(keyNode));
+        auto valuePtr = reinterpret_cast<const std::byte *>(mpack_node_bin_data(valueNode));
+        ByteVec value(valuePtr, valuePtr + mpack_node_bin_size(valueNode));
+
+        out.emplace(std::move(key), std::move(value));
+    }
+
+    if(mpack_tree_destroy(&tree) != mpack_ok) {
+        fprintf(stderr, "%s failed: %s\n", __PRETTY_FUNCTION__, "mpack_tree_destroy");
+        return {};
+    }
+
+    // cache the values (and absence of values) we just fetched
+    for(const auto &key : toFetch) {
+        auto it = out.find(key);
+        if(it != out.end()) {
+            this->cacheProperty(path, key, it->second, generation);
+        } else {
+            this->cacheProperty(path, key, std::nullopt, generation);
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Starts caching properties of the given device. Driverman will send the calling thread a
+ * notification with the given bits whenever the device's properties change; that thread must
+ * then call `InvalidatePropertyCache()` with the bits it received.
+ */
+int32_t RpcClient::CacheDeviceProperties(const std::string_view &_path, const uintptr_t bits) {
+    int err;
+    const std::string path(_path);
+
+    uintptr_t thread;
+    err = ThreadGetHandle(&thread);
+    if(err) return err;
+
+    err = this->SubscribeDeviceProperties(path, thread, bits);
+    if(err) return err;
+
+    std::lock_guard<std::mutex> lg(this->cacheLock);
+    this->cache[path].bits = bits;
+
+    return 0;
+}
+
+/**
+ * Drops all cached properties for devices whose change notification bits overlap the given bits.
+ * Their generation is bumped as well, so values fetched before the invalidation aren't cached.
+ */
+void RpcClient::InvalidatePropertyCache(const uintptr_t bits) {
+    std::lock_guard<std::mutex> lg(this->cacheLock);
+
+    for(auto &[path, info] : this->cache) {
+        if(info.bits & bits) {
+            info.values.clear();
+            info.generation++;
+        }
+    }
+}
+
+/**
+ * Looks up a property in the cache. If the property is known not to exist, the output is set to
+ * an empty optional.
+ *
+ * @param outGeneration Set to the cache generation of the device; it must be passed to
+ *        `cacheProperty()` when caching a value fetched after this call.
+ *
+ * @return Whether the property was found in the cache
+ */
+bool RpcClient::getCachedProperty(const std::string &path, const std::string &key,
+        std::optional<ByteVec> &out, uint64_t &outGeneration) {
+    std::lock_guard<std::mutex> lg(this->cacheLock);
+
+    outGeneration = 0;
+
+    auto it = this->cache.find(path);
+    if(it == this->cache.end()) return false;
+
+    outGeneration = it->second.generation;
+
+    auto valueIt = it->second.values.find(key);
+    if(valueIt == it->second.values.end()) return false;
+
+    out = valueIt->second;
+    return true;
+}
+
+/**
+ * Stores the value of a property in the cache, if the device's properties are being cached. If
+ * the cache was invalidated since the value was fetched (that is, its generation changed) the
+ * value may be stale, so it's not cached.
+ */
+void RpcClient::cacheProperty(const std::string &path, const std::string &key,
+        const std::optional<ByteVec> &value, const uint64_t generation) {
+    std::lock_guard<std::mutex> lg(this->cacheLock);
+
+    auto it = this->cache.find(path);
+    if(it == this->cache.end() || it->second.generation != generation) return;
+
+    it->second.values[key] = value;
+}
+
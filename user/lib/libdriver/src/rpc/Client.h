@@ -5,8 +5,11 @@
 
 #include <cstddef>
 #include <mutex>
+#include <optional>
 #include <span>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace libdriver {
@@ -19,6 +22,8 @@ class RpcClient: public rpc::DrivermanClient {
 
     /// Port name under which the driver manager is registered
     constexpr static const std::string_view kPortName{"me.blraaz.rpc.driverman"};
+    /// Status returned by the driver manager if a device has no property with the given key
+    constexpr static const int32_t kNoSuchPropertyStatus{-90003};
 
     public:
         /// Driverman specific notification keys
@@ -28,8 +33,11 @@ class RpcClient: public rpc::DrivermanClient {
         };
 
     public:
+        using PropertyMap = std::unordered_map<std::string, ByteVec>;
+
         using rpc::DrivermanClient::SetDeviceProperty;
         using rpc::DrivermanClient::GetDeviceProperty;
+        using rpc::DrivermanClient::GetDeviceProperties;
 
         /// Returns the RPC client connection shared by the program
         static RpcClient *the();
@@ -38,15 +46,44 @@ class RpcClient: public rpc::DrivermanClient {
                 const ByteVec &data);
         virtual ByteVec GetDeviceProperty(const std::string_view &path,
                 const std::string_view &key);
+        virtual PropertyMap GetDeviceProperties(const std::string_view &path,
+                const std::span<const std::string_view> &keys);
+
+        /// Caches properties of the device until a change notification with the given bits.
+        int32_t CacheDeviceProperties(const std::string_view &path, const uintptr_t bits);
+        /// Invalidates cached properties of all devices subscribed with any of the given bits.
+        void InvalidatePropertyCache(const uintptr_t bits);
 
         /// Sends a notification to the driver manager.
         virtual int32_t NotifyDriverman(const NoteKeys key) {
             return this->Notify("", static_cast<uint64_t>(key));
         }
 
+    private:
+        /// Cached properties for a single device
+        struct PropertyCache {
+            /// notification bits sent to us when the device's properties change
+            uintptr_t bits{0};
+            /// incremented whenever the cached values are invalidated
+            uint64_t generation{0};
+            /// cached property values; an empty optional indicates the property doesn't exist
+            std::unordered_map<std::string, std::optional<ByteVec>> values;
+        };
+
     private:
         RpcClient(const std::shared_ptr<IoStream> &io) : DrivermanClient(io) {}
 
+        bool getCachedProperty(const std::string &path, const std::string &key,
+                std::optional<ByteVec> &out, uint64_t &outGeneration);
+        void cacheProperty(const std::string &path, const std::string &key,
+                const std::optional<ByteVec> &value, const uint64_t generation);
+
+    private:
+        /// lock protecting the property cache
+        std::mutex cacheLock;
+        /// cached properties, keyed by device path
+        std::unordered_map<std::string, PropertyCache> cache;
+
     private:
         /// once token to ensure the client is only instantiated once
         static std::once_flag gInitFlag;
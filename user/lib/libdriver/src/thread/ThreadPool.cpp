@@ -0,0 +1,501 @@
+#include "ThreadPool.h"
+#include "WorkDeque.h"
+
+#include <sys/syscalls.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libdriver;
+
+std::once_flag ThreadPool::gInitFlag;
+ThreadPool *ThreadPool::gShared{nullptr};
+thread_local ThreadPool::Worker *ThreadPool::gCurrentWorker{nullptr};
+
+/// Number of times an idle worker looks for work (yielding in between) before it parks
+constexpr static const size_t kSpinRounds{16};
+
+/**
+ * A task that was submitted to the pool, but hasn't been executed yet
+ */
+struct ThreadPool::Job {
+    Job(Task &&_task, TaskGroup *_group) : task(std::move(_task)), group(_group) {}
+
+    /// the task to execute
+    Task task;
+    /// group the task belongs to, if any
+    TaskGroup *group;
+};
+
+/**
+ * State of a single worker thread
+ */
+struct ThreadPool::Worker {
+    Worker(ThreadPool *_pool, const size_t _index) : pool(_pool), index(_index),
+        rng(static_cast<uint32_t>(_index) + 1) {}
+
+    /// pool this worker belongs to
+    ThreadPool *pool;
+    /// index of the worker in the pool
+    size_t index;
+
+    /// tasks submitted by this worker
+    WorkDeque<Job> deque;
+
+    /// tasks submitted from outside the pool with an affinity hint for this worker
+    std::deque<Job *> inbox;
+    /// lock protecting the inbox
+    std::mutex inboxLock;
+    /// number of tasks in the inbox
+    std::atomic_size_t inboxSize{0};
+
+    /// thread handle of the worker, used to wake it when parked
+    std::atomic_uintptr_t handle{0};
+    /// whether the worker is parked (or about to be)
+    std::atomic_bool parked{false};
+    /// state for picking victims to steal from
+    uint32_t rng;
+
+    /// name of the worker thread
+    std::string name;
+    /// the worker thread
+    std::unique_ptr<std::thread> thread;
+};
+
+/**
+ * Initializes the shared thread pool if needed, and then returns pointer to the shared instance.
+ *
+ * The shared pool has a worker per processor, if the processor count can be determined.
+ */
+ThreadPool *ThreadPool::the() {
+    std::call_once(gInitFlag, []() {
+        size_t numWorkers = std::thread::hardware_concurrency();
+        if(!numWorkers) numWorkers = kDefaultWorkers;
+
+        gShared = new ThreadPool(numWorkers, "Shared pool");
+        if(gShared->status) {
+            fprintf(stderr, "Failed to create shared thread pool: %d\n", gShared->status);
+            abort();
+        }
+    });
+
+    return gShared;
+}
+
+/**
+ * Allocates a new thread pool, with the given number of workers.
+ *
+ * @param name Name for the pool's worker threads; they're suffixed with the worker's index.
+ */
+int ThreadPool::Alloc(const size_t numWorkers, const std::string &name,
+        std::shared_ptr<ThreadPool> &outPtr) {
+    std::shared_ptr<ThreadPool> pool(new ThreadPool(numWorkers, name));
+
+    if(!pool->status) {
+        outPtr = pool;
+    }
+    return pool->status;
+}
+
+/**
+ * Creates the workers, and starts their threads.
+ */
+ThreadPool::ThreadPool(const size_t numWorkers, const std::string &name) {
+    if(!numWorkers) {
+        this->status = Errors::InvalidWorkers;
+        return;
+    }
+
+    // create all workers first, so that they may steal from one another as soon as they start
+    this->workers.reserve(numWorkers);
+
+    for(size_t i = 0; i < numWorkers; i++) {
+        auto worker = std::make_unique<Worker>(this, i);
+        worker->name = name + " " + std::to_string(i);
+        this->workers.push_back(std::move(worker));
+    }
+
+    for(auto &worker : this->workers) {
+        worker->thread = std::make_unique<std::thread>(&ThreadPool::workerMain, this,
+                worker.get());
+    }
+}
+
+/**
+ * Stops all workers, and releases any tasks that were never executed.
+ */
+ThreadPool::~ThreadPool() {
+    // signal to terminate, and wake all parked workers
+    this->run = false;
+
+    for(auto &worker : this->workers) {
+        if(worker->parked.exchange(false)) {
+            this->numParked--;
+            NotificationSend(worker->handle, kWakeNoteBit);
+        }
+    }
+
+    for(auto &worker : this->workers) {
+        if(worker->thread) {
+            worker->thread->join();
+        }
+    }
+
+    // clean up tasks
+    for(auto &worker : this->workers) {
+        while(auto job = worker->deque.steal()) {
+            delete job;
+        }
+        for(auto job : worker->inbox) {
+            delete job;
+        }
+    }
+    for(auto job : this->injectQueue) {
+        delete job;
+    }
+}
+
+
+
+/**
+ * Submits a task to the pool.
+ *
+ * When called from one of the pool's workers without an affinity hint, the task is pushed onto
+ * the worker's own deque; it'll likely be executed by the same worker, unless another one steals
+ * it first.
+ *
+ * @param affinity Index of the worker that should execute the task, or kAnyWorker. This is only a
+ *        hint: the worker executes tasks in its inbox before any others, but idle workers may
+ *        steal them as well.
+ */
+void ThreadPool::submit(Task task, const size_t affinity) {
+    this->enqueue(new Job(std::move(task), nullptr), affinity);
+}
+
+/**
+ * Submits a task to the pool as part of the given group; the task counts as pending in the group
+ * from now until it has finished executing.
+ *
+ * @param affinity Index of the worker that should execute the task, or kAnyWorker.
+ */
+void ThreadPool::submit(TaskGroup &group, Task task, const size_t affinity) {
+    group.pending++;
+    this->enqueue(new Job(std::move(task), &group), affinity);
+}
+
+/**
+ * Places a newly submitted job on the appropriate queue, and wakes a worker to execute it.
+ */
+void ThreadPool::enqueue(Job *job, const size_t affinity) {
+    this->pending++;
+
+    auto current = gCurrentWorker;
+
+    // submitted by a worker
+    if(affinity == kAnyWorker && current && current->pool == this) {
+        current->deque.push(job);
+        this->wakeOne(kAnyWorker);
+    }
+    // affinity for a particular worker
+    else if(affinity != kAnyWorker) {
+        const auto index = affinity % this->workers.size();
+        auto &worker = this->workers[index];
+
+        {
+            std::lock_guard<std::mutex> lg(worker->inboxLock);
+            worker->inbox.push_back(job);
+            worker->inboxSize++;
+        }
+
+        this->wakeOne(index);
+    }
+    // any worker
+    else {
+        {
+            std::lock_guard<std::mutex> lg(this->injectQueueLock);
+            this->injectQueue.push_back(job);
+            this->injectQueueSize++;
+        }
+
+        this->wakeOne(kAnyWorker);
+    }
+}
+
+/**
+ * Waits for all tasks in the group (including tasks submitted to the group while waiting) to
+ * complete.
+ *
+ * If called from a task executing on one of the pool's workers, it executes other tasks while
+ * waiting, rather than blocking; these may be tasks from any group, so nested fork/join works even
+ * if all workers are waiting.
+ */
+void ThreadPool::wait(TaskGroup &group) {
+    auto current = gCurrentWorker;
+
+    if(current && current->pool == this) {
+        while(!group.isDone()) {
+            auto job = this->findTask(current);
+            if(job) {
+                this->execute(job);
+            } else {
+                ThreadYield();
+            }
+        }
+
+        // ensure the last task to complete is done with the group before the caller may free it
+        std::lock_guard<std::mutex> lg(group.lock);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lk(group.lock);
+    group.cv.wait(lk, [&]{
+        return group.isDone();
+    });
+}
+
+/**
+ * Waits for all tasks submitted so far (and any tasks they submit) to complete.
+ *
+ * This may only be called from outside the pool: a task can't wait for all tasks, since that
+ * includes itself and the tasks other workers are waiting in. Tasks should use a task group to
+ * wait for the work they split off instead.
+ */
+void ThreadPool::wait() {
+    auto current = gCurrentWorker;
+    if(current && current->pool == this) {
+        fprintf(stderr, "ThreadPool::wait() called from worker %lu; use a task group\n",
+                static_cast<unsigned long>(current->index));
+        abort();
+    }
+
+    std::unique_lock<std::mutex> lk(this->pendingLock);
+    this->pendingCv.wait(lk, [&]{
+        return !this->pending;
+    });
+}
+
+/**
+ * Returns the index of the worker that's calling this method.
+ */
+size_t ThreadPool::getCurrentWorker() const {
+    auto current = gCurrentWorker;
+    if(current && current->pool == this) {
+        return current->index;
+    }
+
+    return kAnyWorker;
+}
+
+
+
+/**
+ * Main loop for a worker thread: execute tasks until there are none left, then park until more
+ * are submitted.
+ */
+void ThreadPool::workerMain(Worker *worker) {
+    int err;
+    size_t idleRounds{0};
+
+    gCurrentWorker = worker;
+    ThreadSetName(0, worker->name.c_str());
+
+    uintptr_t handle{0};
+    err = ThreadGetHandle(&handle);
+    if(err) {
+        fprintf(stderr, "%s failed: %d\n", "ThreadGetHandle", err);
+        abort();
+    }
+    worker->handle = handle;
+
+    while(this->run) {
+        auto job = this->findTask(worker);
+
+        if(job) {
+            this->execute(job);
+            idleRounds = 0;
+        }
+        // look for work a few more times before parking
+        else if(++idleRounds < kSpinRounds) {
+            ThreadYield();
+        } else {
+            this->park(worker);
+            idleRounds = 0;
+        }
+    }
+}
+
+/**
+ * Finds the next task for the worker to execute. Its own deque is checked first, then its inbox,
+ * then the shared queue; and finally, we try to steal work from other workers.
+ *
+ * @return A task to execute, or `nullptr` if none could be found.
+ */
+ThreadPool::Job *ThreadPool::findTask(Worker *worker) {
+    // own deque
+    auto task = worker->deque.pop();
+    if(task) return task;
+
+    // tasks with affinity for us
+    if(worker->inboxSize) {
+        std::lock_guard<std::mutex> lg(worker->inboxLock);
+        if(!worker->inbox.empty()) {
+            task = worker->inbox.front();
+            worker->inbox.pop_front();
+            worker->inboxSize--;
+            return task;
+        }
+    }
+
+    // shared queue
+    if(this->injectQueueSize) {
+        std::lock_guard<std::mutex> lg(this->injectQueueLock);
+        if(!this->injectQueue.empty()) {
+            task = this->injectQueue.front();
+            this->injectQueue.pop_front();
+            this->injectQueueSize--;
+            return task;
+        }
+    }
+
+    // steal from others, starting at a random victim
+    const auto numWorkers = this->workers.size();
+
+    worker->rng ^= worker->rng << 13;
+    worker->rng ^= worker->rng >> 17;
+    worker->rng ^= worker->rng << 5;
+
+    const auto start = worker->rng % numWorkers;
+    for(size_t i = 0; i < numWorkers; i++) {
+        auto &victim = this->workers[(start + i) % numWorkers];
+        if(victim.get() == worker) continue;
+
+        task = victim->deque.steal();
+        if(task) return task;
+
+        // the victim is busy, so take the newest of the tasks with affinity for it
+        if(victim->inboxSize) {
+            std::lock_guard<std::mutex> lg(victim->inboxLock);
+            if(!victim->inbox.empty()) {
+                task = victim->inbox.back();
+                victim->inbox.pop_back();
+                victim->inboxSize--;
+                return task;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Executes a job, then marks it as completed in its group (if any) and the pool.
+ */
+void ThreadPool::execute(Job *job) {
+    job->task();
+
+    auto group = job->group;
+    delete job;
+
+    if(group) {
+        group->taskCompleted();
+    }
+    this->taskCompleted();
+}
+
+/**
+ * Checks whether there is any work that an idle worker could pick up.
+ *
+ * The loads are acquires so that a task observed here is also visible to the worker when it goes
+ * to pick it up.
+ */
+bool ThreadPool::hasWork() {
+    if(this->injectQueueSize.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    for(auto &w : this->workers) {
+        if(!w->deque.empty() || w->inboxSize.load(std::memory_order_acquire)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Parks the worker until a task is submitted, or the pool is shutting down.
+ *
+ * The worker is marked as parked before checking once more for work; since submitters make their
+ * task visible before checking for parked workers, either the worker sees the task, or the
+ * submitter sees the worker and wakes it.
+ */
+void ThreadPool::park(Worker *worker) {
+    worker->parked = true;
+    this->numParked++;
+
+    if(!this->run || this->hasWork()) {
+        if(worker->parked.exchange(false)) {
+            this->numParked--;
+        }
+        return;
+    }
+
+    // whoever clears our parked flag also sends the notification
+    while(worker->parked && this->run) {
+        NotificationReceive(kWakeNoteBit, UINTPTR_MAX);
+    }
+}
+
+/**
+ * Wakes a parked worker, if any, to execute a newly submitted task.
+ *
+ * @param preferred Index of the worker to wake, or kAnyWorker. If the preferred worker isn't
+ *        parked, another worker is woken, which may steal the task if the preferred worker is
+ *        still busy by the time it looks for work.
+ *
+ * The full fence orders the submitter's publication of the task before the load of the parked
+ * count; it pairs with the read-modify-write of the count in `park()`. Without it, the load could
+ * be satisfied before the task is visible, and both sides could miss each other.
+ */
+void ThreadPool::wakeOne(const size_t preferred) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!this->numParked.load(std::memory_order_relaxed)) return;
+
+    if(preferred != kAnyWorker) {
+        auto &worker = this->workers[preferred];
+        if(worker->parked.exchange(false)) {
+            this->numParked--;
+            NotificationSend(worker->handle, kWakeNoteBit);
+            return;
+        }
+    }
+
+    for(auto &worker : this->workers) {
+        if(worker->parked.exchange(false)) {
+            this->numParked--;
+            NotificationSend(worker->handle, kWakeNoteBit);
+            return;
+        }
+    }
+}
+
+/**
+ * Marks a task as completed. If it was the last pending task, waiters are woken.
+ */
+void ThreadPool::taskCompleted() {
+    if(this->pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lg(this->pendingLock);
+        this->pendingCv.notify_all();
+    }
+}
+
+/**
+ * Marks a task in the group as completed. If it was the last pending task, waiters are woken.
+ *
+ * The count is decremented with the lock held, so that a waiter that observes the group as done
+ * (and then acquires the lock) knows we're no longer accessing the group.
+ */
+void ThreadPool::TaskGroup::taskCompleted() {
+    std::lock_guard<std::mutex> lg(this->lock);
+    if(this->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        this->cv.notify_all();
+    }
+}
@@ -0,0 +1,156 @@
+#ifndef LIBDRIVER_THREAD_THREADPOOL_H
+#define LIBDRIVER_THREAD_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace libdriver {
+template<typename T> class WorkDeque;
+
+/**
+ * A pool of worker threads that execute tasks submitted to it.
+ *
+ * Each worker has its own deque of tasks: tasks submitted by a worker (for example, work split up
+ * by a running task) are pushed onto its own deque and run in LIFO order, while idle workers steal
+ * from the other end of other workers' deques. Tasks submitted from outside the pool go into a
+ * shared queue, or into a particular worker's queue if an affinity hint is specified.
+ *
+ * Workers that can't find any work park themselves by blocking on a notification bit, and are
+ * woken again when new tasks are submitted.
+ *
+ * Tasks may be submitted as part of a task group, which tracks their completion; waiting on a
+ * group only waits for the tasks in it, so tasks can wait for work they split off themselves
+ * without being held up by unrelated tasks.
+ */
+class ThreadPool {
+    public:
+        enum Errors: int {
+            /// The number of workers is invalid
+            InvalidWorkers                      = -20100,
+        };
+
+        /// A unit of work executed by the pool
+        using Task = std::function<void()>;
+
+        /// Affinity hint value indicating the task may run on any worker
+        constexpr static const size_t kAnyWorker{SIZE_MAX};
+        /// Notification bit used to wake parked workers
+        constexpr static const uintptr_t kWakeNoteBit{(1U << 31)};
+
+        /// Number of workers in the shared pool, if the processor count is not known
+        constexpr static const size_t kDefaultWorkers{4};
+
+        /**
+         * Tracks the completion of a set of tasks submitted to a pool.
+         *
+         * A group may be reused once all of its tasks have completed; it must not be destroyed
+         * while any of its tasks are still pending.
+         */
+        class TaskGroup {
+            friend class ThreadPool;
+
+            public:
+                /// Returns whether all tasks in the group have completed.
+                bool isDone() const {
+                    return !this->pending.load(std::memory_order_acquire);
+                }
+
+            private:
+                void taskCompleted();
+
+            private:
+                /// number of tasks in the group that haven't completed yet
+                std::atomic_size_t pending{0};
+                /// lock protecting the condition for waiting on the group
+                std::mutex lock;
+                /// signalled when the last pending task completes
+                std::condition_variable cv;
+        };
+
+    public:
+        ~ThreadPool();
+
+        /// Submits a task to be executed by the pool.
+        void submit(Task task, const size_t affinity = kAnyWorker);
+        /// Submits a task to be executed by the pool as part of the given group.
+        void submit(TaskGroup &group, Task task, const size_t affinity = kAnyWorker);
+        /// Blocks until all tasks in the group have completed.
+        void wait(TaskGroup &group);
+        /// Blocks until all tasks submitted so far have completed.
+        void wait();
+
+        /// Return the number of worker threads.
+        size_t getNumWorkers() const {
+            return this->workers.size();
+        }
+        /// Return the index of the calling worker, or kAnyWorker if not called from a worker.
+        size_t getCurrentWorker() const;
+
+        /// Allocate a new thread pool.
+        [[nodiscard]] static int Alloc(const size_t numWorkers, const std::string &name,
+                std::shared_ptr<ThreadPool> &outPtr);
+
+        /// Returns the thread pool shared by the program
+        static ThreadPool *the();
+
+    private:
+        struct Job;
+        struct Worker;
+
+        ThreadPool(const size_t numWorkers, const std::string &name);
+
+        void workerMain(Worker *worker);
+        Job *findTask(Worker *worker);
+        void enqueue(Job *job, const size_t affinity);
+        void execute(Job *job);
+        bool hasWork();
+        void park(Worker *worker);
+        void wakeOne(const size_t preferred);
+        void taskCompleted();
+
+    private:
+        static std::once_flag gInitFlag;
+        /// thread pool shared by the program
+        static ThreadPool *gShared;
+
+        /// worker that the calling thread belongs to, if any
+        static thread_local Worker *gCurrentWorker;
+
+    private:
+        /// Status code used to abort initialization if needed
+        int status{0};
+
+        /// whether workers should keep running
+        std::atomic_bool run{true};
+        /// all workers
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        /// tasks submitted from outside the pool without an affinity hint
+        std::deque<Job *> injectQueue;
+        /// lock protecting the injection queue
+        std::mutex injectQueueLock;
+        /// number of tasks in the injection queue (so workers can check it without the lock)
+        std::atomic_size_t injectQueueSize{0};
+
+        /// number of workers that are currently parked
+        std::atomic_size_t numParked{0};
+
+        /// number of submitted tasks that haven't completed yet
+        std::atomic_size_t pending{0};
+        /// lock protecting the condition for the wait() method
+        std::mutex pendingLock;
+        /// signalled when the last pending task completes
+        std::condition_variable pendingCv;
+};
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef LIBDRIVER_THREAD_WORKDEQUE_H
+#define LIBDRIVER_THREAD_WORKDEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libdriver {
+/**
+ * A work stealing deque, as described by Chase and Lev (with the memory orderings from Lê et al.)
+ *
+ * Only the thread that owns the deque may push and pop items, at the bottom end; any other thread
+ * may steal items from the top end. The underlying array grows as needed; arrays that are replaced
+ * are kept around until the deque is destroyed, since thieves may still be reading from them.
+ */
+template<typename T>
+class WorkDeque {
+    /// initial number of slots in the array; must be a power of two
+    constexpr static const size_t kInitialCapacity{64};
+
+    private:
+        /// Circular array holding the items
+        struct Array {
+            Array(const size_t _capacity) : capacity(_capacity),
+                slots(std::make_unique<std::atomic<T *>[]>(_capacity)) {}
+
+            /// Reads the item at the given index.
+            inline T *get(const int64_t i) const {
+                return this->slots[i & (this->capacity - 1)].load(std::memory_order_relaxed);
+            }
+            /// Writes the item at the given index.
+            inline void put(const int64_t i, T *item) {
+                this->slots[i & (this->capacity - 1)].store(item, std::memory_order_relaxed);
+            }
+
+            /// number of slots; a power of two
+            size_t capacity;
+            /// storage for items
+            std::unique_ptr<std::atomic<T *>[]> slots;
+        };
+
+    public:
+        WorkDeque() {
+            auto array = new Array(kInitialCapacity);
+            this->arrays.emplace_back(array);
+            this->array.store(array, std::memory_order_relaxed);
+        }
+
+        /**
+         * Pushes an item to the bottom of the deque. Only the owner may call this.
+         */
+        void push(T *item) {
+            const auto b = this->bottom.load(std::memory_order_relaxed);
+            const auto t = this->top.load(std::memory_order_acquire);
+            auto a = this->array.load(std::memory_order_relaxed);
+
+            if(b - t > static_cast<int64_t>(a->capacity) - 1) {
+                a = this->grow(a, b, t);
+            }
+
+            // the release store publishes the item to thieves, which load bottom with acquire
+            a->put(b, item);
+            this->bottom.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * Pops the most recently pushed item from the bottom of the deque. Only the owner may call
+         * this.
+         *
+         * @return An item, or `nullptr` if the deque is empty.
+         */
+        T *pop() {
+            const auto b = this->bottom.load(std::memory_order_relaxed) - 1;
+            auto a = this->array.load(std::memory_order_relaxed);
+            this->bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = this->top.load(std::memory_order_relaxed);
+
+            // deque was empty
+            if(t > b) {
+                this->bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            auto item = a->get(b);
+
+            // last item: race against thieves for it
+            if(t == b) {
+                if(!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                            std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                this->bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        /**
+         * Steals the oldest item from the top of the deque. Any thread may call this.
+         *
+         * @return An item, or `nullptr` if the deque is empty or we lost a race for the item.
+         */
+        T *steal() {
+            auto t = this->top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto b = this->bottom.load(std::memory_order_acquire);
+
+            if(t >= b) {
+                return nullptr;
+            }
+
+            auto a = this->array.load(std::memory_order_acquire);
+            auto item = a->get(t);
+
+            if(!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                        std::memory_order_relaxed)) {
+                return nullptr;
+            }
+
+            return item;
+        }
+
+        /// Whether the deque appears to be empty. This is only a hint.
+        bool empty() const {
+            return this->bottom.load(std::memory_order_acquire) <=
+                this->top.load(std::memory_order_acquire);
+        }
+
+    private:
+        /**
+         * Replaces the array with one twice its size, copying over all current items.
+         */
+        Array *grow(Array *old, const int64_t b, const int64_t t) {
+            auto a = new Array(old->capacity * 2);
+            for(int64_t i = t; i < b; i++) {
+                a->put(i, old->get(i));
+            }
+
+            this->arrays.emplace_back(a);
+            this->array.store(a, std::memory_order_release);
+            return a;
+        }
+
+    private:
+        /// index of the oldest item; thieves take items from here
+        alignas(64) std::atomic<int64_t> top{0};
+        /// index one past the newest item; the owner pushes and pops here
+        alignas(64) std::atomic<int64_t> bottom{0};
+
+        /// current array
+        std::atomic<Array *> array;
+        /// all arrays ever allocated, including the current one
+        std::vector<std::unique_ptr<Array>> arrays;
+};
+}
+
+#endif
@@ -33,6 +33,13 @@ enum class FileIoEpType: uint32_t {
     WriteFileDirectReply                = WriteFileDirect | ReplyFlag,
     ReadFileDirect                      = 'READ',
     ReadFileDirectReply                 = ReadFileDirect | ReplyFlag,
+    ReadFileScatter                     = 'RDSG',
+    ReadFileScatterReply                = ReadFileScatter | ReplyFlag,
+
+    MapFile                             = 'MMAP',
+    MapFileReply                        = MapFile | ReplyFlag,
+    UnmapFile                           = 'MUNM',
+    UnmapFileReply                      = UnmapFile | ReplyFlag,
 };
 
 /**
@@ -42,6 +49,10 @@ ENUM_FLAGS_EX(FileIoCaps, uint32_t);
 enum class FileIoCaps: uint32_t {
     /// Direct IO is supported
     DirectIo                            = (1 << 0),
+    /// Files may be mapped into memory
+    MapFile                             = (1 << 1),
+    /// Multiple ranges of a file may be read with a single request
+    ScatterRead                         = (1 << 2),
 };
 /**
  * Request for the capabilities of the file IO endpoint
@@ -151,6 +162,12 @@ struct FileIoReadReq {
     uint64_t offset;
     /// number of bytes to read
     uint64_t length;
+
+    /**
+     * Opaque value copied into the reply; this allows a client to have multiple reads in flight
+     * on the same reply port, and match the replies (which may arrive in any order) to them.
+     */
+    uint32_t tag;
 };
 /**
  * Read request reply
@@ -160,6 +177,8 @@ struct FileIoReadReqReply {
     uintptr_t file;
     /// status code: 0 indicates at least one byte was read
     int32_t status;
+    /// tag value from the request
+    uint32_t tag;
 
     /// number of bytes of data returned
     size_t dataLen;
@@ -167,6 +186,119 @@ struct FileIoReadReqReply {
     char data[];
 };
 
+
+
+/**
+ * A single range of a file to read in a scatter read request
+ */
+struct FileIoReadSegment {
+    /// offset to start reading from
+    uint64_t offset;
+    /// number of bytes to read
+    uint64_t length;
+};
+
+/**
+ * Request to read multiple ranges of a file. The total length of all segments may not exceed the
+ * server's maximum read block size.
+ */
+struct FileIoReadScatterReq {
+    /// file handle
+    uintptr_t file;
+    /// opaque value copied into the reply, as for regular reads
+    uint32_t tag;
+
+    /// number of segments to read
+    uint32_t numSegments;
+    /// the segments
+    FileIoReadSegment segments[];
+};
+/**
+ * Reply to a scatter read request.
+ *
+ * The reply contains the number of bytes read for each segment, followed by the data of each
+ * segment, in order and without any padding. A segment for which fewer bytes than requested were
+ * returned hit the end of the file; it doesn't affect any other segments.
+ */
+struct FileIoReadScatterReqReply {
+    /// file handle that this read request belongs to
+    uintptr_t file;
+    /// status code: 0 indicates all segments were read (though possibly partially)
+    int32_t status;
+    /// tag value from the request
+    uint32_t tag;
+
+    /// number of segments
+    uint32_t numSegments;
+    /// number of bytes read for each segment; the data follows after this array
+    uint32_t segmentLengths[];
+};
+
+
+
+/**
+ * Access flags for a file mapping
+ */
+ENUM_FLAGS_EX(FileIoMapFlags, uint32_t);
+enum class FileIoMapFlags: uint32_t {
+    /// The mapping may be read
+    Read                                = (1 << 0),
+    /// The mapping may be written. Changes are private to the mapping, and never written back.
+    Write                               = (1 << 1),
+    /// Code in the mapping may be executed
+    Execute                             = (1 << 2),
+};
+
+/**
+ * Request to map a range of a file into memory.
+ *
+ * The server creates a virtual memory region that is backed by the file's contents; its pages are
+ * read in on demand as they're accessed. Bytes past the end of the file, in the last page that
+ * contains file data, read as zero; accessing pages entirely beyond the end of the file faults.
+ *
+ * The region remains valid after the file is closed, until it is unmapped again.
+ */
+struct FileIoMapReq {
+    /// file handle
+    uintptr_t file;
+
+    /// offset into the file of the start of the mapping; must be page aligned
+    uint64_t offset;
+    /// number of bytes to map; this is rounded up to a multiple of the page size
+    uint64_t length;
+
+    /// access flags for the mapping
+    FileIoMapFlags flags;
+};
+/**
+ * Reply to a map request
+ */
+struct FileIoMapReqReply {
+    /// status code: 0 indicates the region was created
+    int32_t status;
+
+    /// handle of the virtual memory region; the caller should map it into its address space
+    uintptr_t region;
+    /// length of the region, in bytes
+    uint64_t length;
+};
+
+/**
+ * Request to release a region previously created by a map request. The caller should unmap the
+ * region first.
+ */
+struct FileIoUnmapReq {
+    /// virtual memory region handle
+    uintptr_t region;
+};
+/**
+ * Reply to an unmap request
+ */
+struct FileIoUnmapReqReply {
+    /// status code: 0 indicates success
+    int32_t status;
+};
+
 }
 
 #endif
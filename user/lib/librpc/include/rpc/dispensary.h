@@ -13,6 +13,10 @@ extern "C" {
 /**
  * Attempts to resolve a name into a port.
  *
+ * Results (including names that aren't registered) are cached until the dispensary's set of
+ * registrations changes; if the returned port turns out to be dead, call InvalidateService() before
+ * looking it up again.
+ *
  * @param name Service name to look up; this is a zero-terminated UTF-8 string.
  * @param outPort If a port is found, its handle is written to this variable.
  *
@@ -21,6 +25,25 @@ extern "C" {
  */
 int LookupService(const char * _Nonnull name, uintptr_t * _Nonnull outPort);
 
+/**
+ * Waits for a service to be registered, then returns its port. This doesn't poll: the dispensary
+ * replies once the name is registered.
+ *
+ * @param name Service name to look up; this is a zero-terminated UTF-8 string.
+ * @param timeoutUs Microseconds to wait for the registration, or UINTPTR_MAX to wait forever
+ * @param outPort If a port is found, its handle is written to this variable.
+ *
+ * @return 0 if the timeout expired before the name was registered; 1 if the port was found; or a
+ * negative error code.
+ */
+int WaitForService(const char * _Nonnull name, const uintptr_t timeoutUs,
+        uintptr_t * _Nonnull outPort);
+
+/**
+ * Removes any cached lookup result for the given service name.
+ */
+void InvalidateService(const char * _Nonnull name);
+
 /**
  * Registers a named service.
  *
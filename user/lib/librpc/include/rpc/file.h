@@ -1,6 +1,7 @@
 #ifndef LIBRPC_RPC_FILE_H
 #define LIBRPC_RPC_FILE_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /// Open a file for reading
@@ -10,10 +11,32 @@
 /// Create the file if it doesn't exist already.
 #define FILE_OPEN_CREATE        (1 << 8)
 
+/// Mapping may be read
+#define FILE_MAP_READ           (1 << 0)
+/// Mapping may be written; changes are private, and never written back to the file.
+#define FILE_MAP_WRITE          (1 << 1)
+/// Code in the mapping may be executed
+#define FILE_MAP_EXEC           (1 << 2)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Describes a single range of a file to read with FileReadScatter().
+ */
+typedef struct FileReadSegment {
+    /// offset into the file to read from
+    uint64_t offset;
+    /// number of bytes to read
+    size_t length;
+    /// buffer to receive the data
+    void * _Nonnull buf;
+
+    /// on return, the number of bytes read; less than `length` if the end of the file was reached
+    size_t bytesRead;
+} FileReadSegment_t;
+
 /**
  * Attempts to open a file by name.
  *
@@ -47,6 +70,52 @@ int FileClose(const uintptr_t file);
  */
 int FileRead(const uintptr_t file, const uint64_t offset, const size_t length, void * _Nonnull buf);
 
+/**
+ * Reads multiple ranges of a file. If the server supports it, as many segments as fit are read
+ * with a single request; otherwise, each segment is read individually.
+ *
+ * Each segment is independent: reaching the end of the file in one of them doesn't affect the
+ * others.
+ *
+ * @param segments Ranges to read; the number of bytes read is written to each segment.
+ * @param numSegments Number of segments
+ * @return 0 if all segments were read (possibly partially) or a negative error code.
+ */
+int FileReadScatter(const uintptr_t file, FileReadSegment_t * _Nonnull segments,
+        const size_t numSegments);
+
+/**
+ * Creates a virtual memory region backed by a range of the file. The region's pages are read in
+ * from the file as they're accessed.
+ *
+ * The region is not mapped; the caller should map it into its address space, then unmap it and
+ * call FileUnmap() when done. It stays valid even if the file is closed in the meantime.
+ *
+ * @param offset Offset into the file of the start of the mapping; must be page aligned
+ * @param length Number of bytes to map
+ * @param flags A combination of the file mapping flags, defined above.
+ * @param outRegion Variable where the region handle is written on success.
+ * @param outLength Where to store the length of the region, if the caller is interested.
+ * @return 0 on success, or a negative error code.
+ */
+int FileMap(const uintptr_t file, const uint64_t offset, const size_t length,
+        const uintptr_t flags, uintptr_t * _Nonnull outRegion, size_t * _Nullable outLength);
+
+/**
+ * Releases a region created by FileMap(). It should have been unmapped from the caller before.
+ *
+ * @return 0 on success, error code otherwise.
+ */
+int FileUnmap(const uintptr_t region);
+
+/**
+ * Returns the largest amount of data the file IO server transfers in a single message; reads of
+ * this size are the most efficient.
+ *
+ * @return Maximum IO size, in bytes, or 0 if unknown (no file has been opened yet)
+ */
+size_t FileGetMaxIoSize(void);
+
 #ifdef __cplusplus
 }
 #endif
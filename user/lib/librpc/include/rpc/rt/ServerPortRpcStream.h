@@ -108,6 +108,7 @@ class ServerPortRpcStream: public ServerRpcIoStream {
             // extract the payload
             auto packet = reinterpret_cast<Packet *>(msg->data);
             this->replyTo = packet->replyTo;
+            this->senderTask = msg->senderTask;
 
             outRxBuf = std::span(packet->payload, msg->receivedBytes - sizeof(Packet));
 
@@ -143,6 +144,13 @@ class ServerPortRpcStream: public ServerRpcIoStream {
             return true;
         }
 
+        /**
+         * Returns the handle of the task that sent the most recently received message.
+         */
+        constexpr inline uintptr_t getSenderTask() const {
+            return this->senderTask;
+        }
+
     private:
         /**
          * Allocates the receive buffer.
@@ -181,6 +189,8 @@ class ServerPortRpcStream: public ServerRpcIoStream {
 
         /// port to send the next reply to
         uintptr_t replyTo{0};
+        /// task that sent the most recently received message
+        uintptr_t senderTask{0};
 
         /// message receive buffer
         void *rxBuf{nullptr};
@@ -7,6 +7,9 @@
 extern "C" {
 #endif
 
+/// Bind all symbols of the program when it's loaded, rather than lazily on first use
+#define RPC_TASK_CREATE_BIND_NOW        (1 << 0)
+
 /**
  * Creates a new task from the specified binary file.
  *
@@ -19,6 +22,20 @@ extern "C" {
 int RpcTaskCreate(const char * _Nonnull path, const char * _Nullable * _Nullable args,
         uintptr_t * _Nullable outHandle);
 
+/**
+ * Creates a new task from the specified binary file, with additional flags that control how it
+ * is loaded.
+ *
+ * @param path Path to an executable to launch
+ * @param args List of arguments to pass to the task; terminated with NULL.
+ * @param flags Combination of RPC_TASK_CREATE_* flags
+ * @param outHandle Variable in which a handle to the created task is stored.
+ *
+ * @return A negative error code, or 0 on success.
+ */
+int RpcTaskCreateWithFlags(const char * _Nonnull path, const char * _Nullable * _Nullable args,
+        const uint32_t flags, uintptr_t * _Nullable outHandle);
+
 #ifdef __cplusplus
 }
 #endif
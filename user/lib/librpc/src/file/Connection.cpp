@@ -14,6 +14,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <new>
 #include <string>
 #include <span>
 #include <vector>
@@ -25,8 +26,8 @@ using namespace rpc;
 using namespace fileio;
 
 namespace fileio {
-static bool Connect();
-static bool UpdateCaps();
+static bool Connect(uintptr_t &outPort);
+static bool UpdateCaps(FileIoServer &server);
 }
 
 /// ensures global state is initialized only once
@@ -40,35 +41,33 @@ LIBRPC_INTERNAL FileIoState fileio::gState;
 void fileio::Init() {
     int err;
 
-    // set up the structure lock
+    // set up the locks
     memset(&gState, 0, sizeof(gState));
 
-    err = mtx_init(&gState.lock, mtx_plain);
+    err = mtx_init(&gState.connectLock, mtx_plain);
+    assert(err == thrd_success);
+    err = mtx_init(&gState.portCacheLock, mtx_plain);
     assert(err == thrd_success);
-
-    // allocate receive port
-    err = PortCreate(&gState.replyPort);
-    assert(!err);
 }
 
 /**
  * Finds the port to which file IO requests should be sent.
  */
-static bool fileio::Connect() {
+static bool fileio::Connect(uintptr_t &outPort) {
     int err;
     uintptr_t handle = 0;
 
     // try the file service
     err = LookupService("me.blraaz.rpc.fileio", &handle);
     if(err == 1) {
-        gState.ioServerPort = handle;
+        outPort = handle;
         return true;
     }
 
     // next, try the init file service
     err = LookupService("me.blraaz.rpc.rootsrv.initfileio", &handle);
     if(err == 1) {
-        gState.ioServerPort = handle;
+        outPort = handle;
         return true;
     }
 
@@ -77,33 +76,37 @@ static bool fileio::Connect() {
 }
 
 /**
- * Sends a capabilities request to the IO handler.
+ * Sends a capabilities request to the IO handler, and fills in the server info accordingly.
  */
-static bool fileio::UpdateCaps() {
+static bool fileio::UpdateCaps(FileIoServer &server) {
     int err;
     void *rxBuf = nullptr;
 
+    ReplyPort replyPort;
+    if(!replyPort) return false;
+
     // serialize the request
     FileIoGetCaps req;
     req.requestedVersion = 1;
 
     auto requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(FileIoGetCaps));
-    err = rpc::RpcSend(gState.ioServerPort, static_cast<uint32_t>(FileIoEpType::GetCapabilities),
-            requestBuf, gState.replyPort);
+    err = rpc::RpcSend(server.port, static_cast<uint32_t>(FileIoEpType::GetCapabilities),
+            requestBuf, replyPort);
     if(err) return false;
 
     // allocate a receive buffer
     constexpr static const size_t kReplyBufSize = 256 + sizeof(struct MessageHeader);
     err = posix_memalign(&rxBuf, 16, kReplyBufSize);
     if(err) {
-        return err;
+        replyPort.discard();
+        return false;
     }
 
     memset(rxBuf, 0, kReplyBufSize);
 
     // receive pls
     struct MessageHeader *msg = (struct MessageHeader *) rxBuf;
-    err = PortReceive(gState.replyPort, msg, kReplyBufSize, UINTPTR_MAX);
+    err = PortReceive(replyPort, msg, kReplyBufSize, UINTPTR_MAX);
 
     if(err > 0) {
         // read out the type
@@ -125,17 +128,24 @@ static bool fileio::UpdateCaps() {
         auto req = reinterpret_cast<const FileIoGetCapsReply *>(data.data());
 
         // read out capabilities
-        gState.caps = ServerCaps::Default;
+        server.caps = ServerCaps::Default;
 
         if(TestFlags(req->capabilities & FileIoCaps::DirectIo)) {
-            gState.caps |= ServerCaps::DirectIo;
+            server.caps |= ServerCaps::DirectIo;
+        }
+        if(TestFlags(req->capabilities & FileIoCaps::MapFile)) {
+            server.caps |= ServerCaps::MapFile;
+        }
+        if(TestFlags(req->capabilities & FileIoCaps::ScatterRead)) {
+            server.caps |= ServerCaps::ScatterRead;
         }
 
-        gState.maxIoSize = req->maxReadBlockSize;
+        server.maxIoSize = req->maxReadBlockSize;
 
-        //fprintf(stderr, "supported capabilities: %08x block max %u\n", (uintptr_t) gState.caps,
-        //        gState.maxIoSize);
+        //fprintf(stderr, "supported capabilities: %08x block max %u\n", (uintptr_t) server.caps,
+        //        server.maxIoSize);
     } else {
+        replyPort.discard();
         goto fail;
     }
 
@@ -149,24 +159,113 @@ fail:;
 }
 
 /**
- * Resolves the port handle for the file IO service and updates the capabilities field.
+ * Resolves the port handle for the file IO service and its capabilities, then publishes them as
+ * a new server info structure.
+ *
+ * The caller must hold the connect lock.
  */
 bool fileio::UpdateServerPort() {
+    FileIoServer info{0, ServerCaps::Default, 0};
+
     // determine port
-    if(!Connect()) return false;
+    if(!Connect(info.port)) return false;
     // determine capabilities
-    if(!UpdateCaps()) return false;
+    if(!UpdateCaps(info)) return false;
 
+    // publish it only once it's complete; the previous info may still be in use, so it's leaked
+    auto server = new(std::nothrow) FileIoServer(info);
+    if(!server) return false;
+
+    __atomic_store_n(&gState.server, server, __ATOMIC_RELEASE);
     return true;
 }
 
+/**
+ * Returns the file IO server info. If we're not yet connected, and `connect` is set, we look up
+ * the server first; otherwise, nullptr is returned.
+ *
+ * Only the first caller (or any callers racing with it) needs to take the connect lock.
+ */
+const FileIoServer *fileio::GetServer(const bool connect) {
+    call_once(&gStateOnceFlag, Init);
+
+    auto server = __atomic_load_n(&gState.server, __ATOMIC_ACQUIRE);
+    if(server || !connect) return server;
+
+    if(mtx_lock(&gState.connectLock) != thrd_success) return nullptr;
+
+    server = __atomic_load_n(&gState.server, __ATOMIC_ACQUIRE);
+    if(!server && UpdateServerPort()) {
+        server = __atomic_load_n(&gState.server, __ATOMIC_ACQUIRE);
+    }
+
+    mtx_unlock(&gState.connectLock);
+    return server;
+}
+
+
+
+/**
+ * Gets a port on which a request can receive its replies. Ports are taken from the cache of
+ * previously used ports if possible, and allocated otherwise.
+ *
+ * @return Port handle, or 0 if none could be allocated.
+ */
+uintptr_t fileio::AcquireReplyPort() {
+    uintptr_t port{0};
+
+    call_once(&gStateOnceFlag, Init);
+
+    if(mtx_lock(&gState.portCacheLock) == thrd_success) {
+        if(gState.numCachedPorts) {
+            port = gState.cachedPorts[--gState.numCachedPorts];
+        }
+        mtx_unlock(&gState.portCacheLock);
+    }
+
+    if(!port && PortCreate(&port)) {
+        return 0;
+    }
+
+    return port;
+}
+
+/**
+ * Returns a reply port once its request completed. If it can be reused (there are no replies
+ * outstanding on it) and the cache has room, it's kept for later requests; otherwise it's
+ * destroyed.
+ */
+void fileio::ReleaseReplyPort(const uintptr_t port, const bool reusable) {
+    if(reusable && mtx_lock(&gState.portCacheLock) == thrd_success) {
+        if(gState.numCachedPorts < FileIoState::kMaxCachedPorts) {
+            gState.cachedPorts[gState.numCachedPorts++] = port;
+            mtx_unlock(&gState.portCacheLock);
+            return;
+        }
+        mtx_unlock(&gState.portCacheLock);
+    }
+
+    PortDestroy(port);
+}
+
+/**
+ * Returns the maximum IO size of the file IO server, as of the last time we connected to it.
+ */
+size_t FileGetMaxIoSize(void) {
+    const auto server = GetServer(false);
+    return server ? server->maxIoSize : 0;
+}
+
 /**
  * Secret undocumented method that resets the RPC connection to the file io service.
  */
 extern "C" {
 
 LIBSYSTEM_EXPORT void __librpc__FileIoResetConnection() {
+    call_once(&gStateOnceFlag, Init);
+
+    if(mtx_lock(&gState.connectLock) != thrd_success) return;
     fileio::UpdateServerPort();
+    mtx_unlock(&gState.connectLock);
 }
 }
-
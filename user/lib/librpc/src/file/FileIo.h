@@ -4,6 +4,7 @@
 #include "rpc_internal.h"
 
 #include <sys/bitflags.hpp>
+#include <cstddef>
 #include <cstdint>
 
 #include <threads.h>
@@ -19,25 +20,49 @@ enum class ServerCaps: uintptr_t {
 
     /// direct IO is possible
     DirectIo                            = (1 << 0),
+    /// files can be mapped into memory
+    MapFile                             = (1 << 1),
+    /// multiple ranges can be read with one request
+    ScatterRead                         = (1 << 2),
 };
 
 /**
- * Info structure for the state of the file IO system
+ * Describes the file IO server we're connected to. Once published, it's never modified: when
+ * the connection is reset, a new instance is published instead. Old instances are never freed,
+ * since requests in progress may still be using them; resets are rare enough that this is fine.
  */
-struct FileIoState {
-    // lock to protect access to the resources
-    mtx_t lock;
-    // port to send requests to
-    uintptr_t ioServerPort;
-    // port for receiving file IO replies
-    uintptr_t replyPort;
-
+struct FileIoServer {
+    /// port to send requests to
+    uintptr_t port;
     /// various supported capabilities
     ServerCaps caps;
     /// maximum IO block size
     uintptr_t maxIoSize;
 };
 
+/**
+ * Info structure for the state of the file IO system
+ *
+ * The server info is not protected by a lock: it's published (with release semantics) only once
+ * it's fully set up, so once a caller observes it, all of its fields are valid.
+ */
+struct FileIoState {
+    /// Maximum number of reply ports kept around for reuse
+    constexpr static const size_t kMaxCachedPorts{16};
+
+    /// lock taken while (re)connecting to the IO server
+    mtx_t connectLock;
+    /// server we're currently connected to, if any
+    const FileIoServer *server;
+
+    /// protects the reply port cache
+    mtx_t portCacheLock;
+    /// number of ports in the cache
+    size_t numCachedPorts;
+    /// reply ports not currently used by any request
+    uintptr_t cachedPorts[kMaxCachedPorts];
+};
+
 namespace fileio {
 extern once_flag gStateOnceFlag;
 extern FileIoState gState;
@@ -45,6 +70,52 @@ extern FileIoState gState;
 LIBRPC_INTERNAL void Init();
 
 LIBRPC_INTERNAL bool UpdateServerPort();
+LIBRPC_INTERNAL const FileIoServer *GetServer(const bool connect);
+
+/**
+ * Returns the port of the file IO server, or 0 if not connected.
+ */
+inline uintptr_t GetServerPort(const bool connect) {
+    const auto server = GetServer(connect);
+    return server ? server->port : 0;
+}
+
+LIBRPC_INTERNAL uintptr_t AcquireReplyPort();
+LIBRPC_INTERNAL void ReleaseReplyPort(const uintptr_t port, const bool reusable);
+
+/**
+ * Holds a reply port for the duration of a single request. Each request receives its replies on
+ * a port of its own, so that any number of requests may be in flight from different threads.
+ *
+ * If the port may still receive replies (for example, because receiving failed) invoke
+ * `discard()` so that it's destroyed rather than reused.
+ */
+class ReplyPort {
+    public:
+        ReplyPort() : port(AcquireReplyPort()) {}
+        ~ReplyPort() {
+            if(this->port) ReleaseReplyPort(this->port, this->reusable);
+        }
+
+        ReplyPort(const ReplyPort &) = delete;
+        ReplyPort &operator=(const ReplyPort &) = delete;
+
+        /// Returns the port handle, or 0 if no port could be allocated.
+        constexpr inline operator uintptr_t() const {
+            return this->port;
+        }
+
+        /// Marks the port as unsuitable for reuse.
+        constexpr inline void discard() {
+            this->reusable = false;
+        }
+
+    private:
+        /// port handle
+        uintptr_t port{0};
+        /// whether the port can be reused by later requests
+        bool reusable{true};
+};
 }
 
 #endif
@@ -0,0 +1,209 @@
+#include "FileIo.h"
+
+#include "rpc/file.h"
+#include "sys/syscalls.h"
+
+#include "helpers/Send.h"
+
+#include <malloc.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+
+#include <rpc/RpcPacket.hpp>
+#include <rpc/FileIO.hpp>
+
+using namespace rpc;
+using namespace fileio;
+
+/**
+ * Requests the server create a VM region backed by the given range of the file.
+ */
+int FileMap(const uintptr_t file, const uint64_t offset, const size_t length,
+        const uintptr_t flags, uintptr_t * _Nonnull outRegion, size_t * _Nullable outLength) {
+    int err;
+    std::span<uint8_t> requestBuf;
+    void *rxBuf = nullptr;
+    struct MessageHeader *rxMsg = nullptr;
+
+    // validate args
+    if(!outRegion || !length) return -1;
+
+    const auto server = GetServer(false);
+    if(!server) return -1;
+    else if(!TestFlags(server->caps & ServerCaps::MapFile)) return -2;
+
+    const auto serverPort = server->port;
+
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
+
+    // allocate a receive buffer
+    constexpr static const size_t kReplyBufSize = 256 + sizeof(struct MessageHeader);
+    err = posix_memalign(&rxBuf, 16, kReplyBufSize);
+    if(err) {
+        goto fail;
+    }
+
+    memset(rxBuf, 0, kReplyBufSize);
+
+    // send the request
+    FileIoMapReq req;
+    memset(&req, 0, sizeof(req));
+
+    req.file = file;
+    req.offset = offset;
+    req.length = length;
+
+    if(flags & FILE_MAP_READ) {
+        req.flags |= FileIoMapFlags::Read;
+    }
+    if(flags & FILE_MAP_WRITE) {
+        req.flags |= FileIoMapFlags::Write;
+    }
+    if(flags & FILE_MAP_EXEC) {
+        req.flags |= FileIoMapFlags::Execute;
+    }
+
+    requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(req));
+
+    err = rpc::RpcSend(serverPort, static_cast<uint32_t>(FileIoEpType::MapFile), requestBuf,
+            replyPort);
+    if(err) {
+        err = -3;
+        goto fail;
+    }
+
+    // receive the response
+    rxMsg = (struct MessageHeader *) rxBuf;
+    err = PortReceive(replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
+
+    if(err > 0) {
+        // read out the type
+        if(rxMsg->receivedBytes < sizeof(RpcPacket)) {
+            err = -4;
+            goto fail;
+        }
+
+        const auto packet = reinterpret_cast<RpcPacket *>(rxMsg->data);
+        if(packet->type != static_cast<uint32_t>(FileIoEpType::MapFileReply)) {
+            fprintf(stderr, "%s received wrong packet type %08x!\n", __FUNCTION__, packet->type);
+            err = -4;
+            goto fail;
+        }
+
+        // deserialize the response
+        auto data = std::span(packet->payload, err - sizeof(RpcPacket));
+        if(data.size() < sizeof(FileIoMapReqReply)) {
+            err = -4;
+            goto fail;
+        }
+        auto reply = reinterpret_cast<const FileIoMapReqReply *>(data.data());
+
+        if(reply->status) {
+            err = (reply->status < 0) ? reply->status : -reply->status;
+            goto fail;
+        }
+
+        *outRegion = reply->region;
+        if(outLength) {
+            *outLength = reply->length;
+        }
+    }
+    // message too short for even the header
+    else {
+        replyPort.discard();
+        err = -4;
+        goto fail;
+    }
+
+    free(rxBuf);
+    return 0;
+
+fail:;
+    // failure case: release the receive buffer
+    free(rxBuf);
+    return err;
+}
+
+/**
+ * Tells the server that a region created by an earlier map request is no longer needed.
+ */
+int FileUnmap(const uintptr_t region) {
+    int err;
+    std::span<uint8_t> requestBuf;
+    void *rxBuf = nullptr;
+    struct MessageHeader *rxMsg = nullptr;
+
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
+
+    // allocate a receive buffer
+    constexpr static const size_t kReplyBufSize = 256 + sizeof(struct MessageHeader);
+    err = posix_memalign(&rxBuf, 16, kReplyBufSize);
+    if(err) {
+        goto fail;
+    }
+
+    memset(rxBuf, 0, kReplyBufSize);
+
+    // send the request
+    FileIoUnmapReq req;
+    memset(&req, 0, sizeof(req));
+
+    req.region = region;
+
+    requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(req));
+
+    err = rpc::RpcSend(GetServerPort(false), static_cast<uint32_t>(FileIoEpType::UnmapFile),
+            requestBuf, replyPort);
+    if(err) {
+        err = -2;
+        goto fail;
+    }
+
+    // receive the response
+    rxMsg = (struct MessageHeader *) rxBuf;
+    err = PortReceive(replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
+
+    if(err > 0) {
+        // read out the type
+        if(rxMsg->receivedBytes < sizeof(RpcPacket)) {
+            err = -3;
+            goto fail;
+        }
+
+        const auto packet = reinterpret_cast<RpcPacket *>(rxMsg->data);
+        if(packet->type != static_cast<uint32_t>(FileIoEpType::UnmapFileReply)) {
+            fprintf(stderr, "%s received wrong packet type %08x!\n", __FUNCTION__, packet->type);
+            err = -3;
+            goto fail;
+        }
+
+        // deserialize the response
+        auto data = std::span(packet->payload, err - sizeof(RpcPacket));
+        if(data.size() < sizeof(FileIoUnmapReqReply)) {
+            err = -3;
+            goto fail;
+        }
+        auto reply = reinterpret_cast<const FileIoUnmapReqReply *>(data.data());
+
+        err = reply->status;
+    }
+    // message too short for even the header
+    else {
+        replyPort.discard();
+        err = -3;
+        goto fail;
+    }
+
+    free(rxBuf);
+    return err;
+
+fail:;
+    // failure case: release the receive buffer
+    free(rxBuf);
+    return err;
+}
@@ -41,25 +41,16 @@ int FileOpen(const char * _Nonnull _path, const uintptr_t flags, uintptr_t * _No
 
     if(!pathLen || pathLen > UINT16_MAX) return -1;
 
-    // perform one-time init if needed
-    call_once(&gStateOnceFlag, []{
-        Init();
-    });
-
-    // acquire lock
-    err = mtx_lock(&gState.lock);
-    if(err != thrd_success) return -1;
-
-    // perform the IO service lookup
-    if(!gState.ioServerPort) {
-        if(!UpdateServerPort()) {
-            err = -2;
-            goto fail;
-        }
-    }
+    // perform the IO service lookup if needed
+    const auto serverPort = GetServerPort(true);
+    if(!serverPort) return -2;
+
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
 
     // allocate memory for the send request
     err = posix_memalign(reinterpret_cast<void **>(&open), 16, openMsgLen);
+    if(err) return -1;
     memset(open, 0, openMsgLen);
 
     // populate the request and send it
@@ -74,8 +65,8 @@ int FileOpen(const char * _Nonnull _path, const uintptr_t flags, uintptr_t * _No
     }
 
     requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(open), openMsgLen);
-    err = rpc::RpcSend(gState.ioServerPort, static_cast<uint32_t>(FileIoEpType::OpenFile),
-            requestBuf, gState.replyPort);
+    err = rpc::RpcSend(serverPort, static_cast<uint32_t>(FileIoEpType::OpenFile),
+            requestBuf, replyPort);
 
     free(open);
 
@@ -95,9 +86,7 @@ int FileOpen(const char * _Nonnull _path, const uintptr_t flags, uintptr_t * _No
 
     // receive pls
     rxMsg = (struct MessageHeader *) rxBuf;
-    err = PortReceive(gState.replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
-
-    mtx_unlock(&gState.lock);
+    err = PortReceive(replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
 
     if(err > 0) {
         // read out the type
@@ -137,6 +126,7 @@ int FileOpen(const char * _Nonnull _path, const uintptr_t flags, uintptr_t * _No
     } 
     // message too short for even the header
     else {
+        replyPort.discard();
         err = -4;
         goto fail;
     }
@@ -145,10 +135,8 @@ int FileOpen(const char * _Nonnull _path, const uintptr_t flags, uintptr_t * _No
     return 0;
 
 fail:;
-    // failure case: ensures the lock is released
+    // failure case: release the receive buffer
     if(rxBuf) free(rxBuf);
-
-    mtx_unlock(&gState.lock);
     return err;
 }
 
@@ -161,6 +149,9 @@ int FileClose(const uintptr_t file) {
     void *rxBuf = nullptr;
     struct MessageHeader *rxMsg = nullptr;
 
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
+
     // allocate a receive buffer
     constexpr static const size_t kReplyBufSize = 256 + sizeof(struct MessageHeader);
     err = posix_memalign(&rxBuf, 16, kReplyBufSize);
@@ -170,13 +161,6 @@ int FileClose(const uintptr_t file) {
 
     memset(rxBuf, 0, kReplyBufSize);
 
-    // acquire lock
-    err = mtx_lock(&gState.lock);
-    if(err != thrd_success) {
-        free(rxBuf);
-        return -1;
-    }
-
     // send the request
     FileIoClose req;
     memset(&req, 0, sizeof(req));
@@ -185,8 +169,8 @@ int FileClose(const uintptr_t file) {
 
     requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(req));
 
-    err = rpc::RpcSend(gState.ioServerPort, static_cast<uint32_t>(FileIoEpType::CloseFile),
-            requestBuf, gState.replyPort);
+    err = rpc::RpcSend(GetServerPort(false), static_cast<uint32_t>(FileIoEpType::CloseFile),
+            requestBuf, replyPort);
     if(err) {
         err = -2;
         goto fail;
@@ -194,9 +178,7 @@ int FileClose(const uintptr_t file) {
 
     // receive the response
     rxMsg = (struct MessageHeader *) rxBuf;
-    err = PortReceive(gState.replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
-
-    mtx_unlock(&gState.lock);
+    err = PortReceive(replyPort, rxMsg, kReplyBufSize, UINTPTR_MAX);
 
     if(err > 0) {
         // read out the type
@@ -224,6 +206,7 @@ int FileClose(const uintptr_t file) {
     } 
     // message too short for even the header
     else {
+        replyPort.discard();
         err = -3;
         goto fail;
     }
@@ -232,9 +215,7 @@ int FileClose(const uintptr_t file) {
     return err;
 
 fail:;
-    // failure case: ensures the lock is released
-    mtx_unlock(&gState.lock);
-
+    // failure case: release the receive buffer
     free(rxBuf);
     return err;
 }
@@ -21,26 +21,216 @@
 using namespace fileio;
 using namespace rpc;
 
+/// Maximum number of chunks of a single read that may be outstanding at once
+constexpr static const size_t kMaxReadsInFlight{4};
+
+/**
+ * State of a single multi-chunk read
+ */
+struct ReadState {
+    /// file to read from
+    uintptr_t file;
+    /// offset of the first byte to read
+    uint64_t offset;
+    /// total number of bytes to read
+    size_t length;
+    /// buffer to receive data
+    void *outBuf;
+
+    /// size of each chunk
+    size_t chunkSize;
+    /// total number of chunks
+    size_t numChunks;
+
+    /// next chunk to request
+    size_t nextChunk{0};
+    /// number of requests for which we haven't received a reply
+    size_t inFlight{0};
+
+    /// number of bytes received so far for each chunk
+    std::vector<size_t> received;
+    /// chunks for which less data than requested was returned; their tail is requested again
+    std::vector<size_t> retry;
+
+    /// index of the first chunk for which no data was returned (the end of the file)
+    size_t endChunk{SIZE_MAX};
+
+    /// first error encountered
+    int err{0};
+
+    /// Returns the length of the given chunk.
+    size_t chunkLength(const size_t chunk) const {
+        return std::min(this->chunkSize, (this->length - (chunk * this->chunkSize)));
+    }
+};
+
+/**
+ * Sends the read request for the remainder of the given chunk; that is, everything after the
+ * data already received for it. The chunk index is used as the tag.
+ */
+static int SendChunkRequest(ReadState &state, const size_t chunk, const uintptr_t serverPort,
+        const uintptr_t replyPort) {
+    const auto done = state.received[chunk];
+    const auto chunkOff = (chunk * state.chunkSize) + done;
+
+    FileIoReadReq req;
+    memset(&req, 0, sizeof(req));
+
+    req.file = state.file;
+    req.offset = state.offset + chunkOff;
+    req.length = state.chunkLength(chunk) - done;
+    req.tag = chunk;
+
+    auto requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(req));
+    return rpc::RpcSend(serverPort, static_cast<uint32_t>(FileIoEpType::ReadFileDirect),
+            requestBuf, replyPort);
+}
+
+/**
+ * Handles a reply to a chunk read request, copying its data into the output buffer.
+ *
+ * If the server returned less data than requested, but not none at all, the rest of the chunk is
+ * requested again; only a reply without any data indicates the end of the file.
+ *
+ * @return 0 if the reply was handled (even if it indicates the read failed) or an error code if
+ * the reply is malformed.
+ */
+static int HandleChunkReply(ReadState &state, const struct MessageHeader *msg, const size_t msgLen) {
+    // read out the type
+    if(msg->receivedBytes < sizeof(RpcPacket)) {
+        return -50;
+    }
+
+    const auto packet = reinterpret_cast<const RpcPacket *>(msg->data);
+    if(packet->type != static_cast<uint32_t>(FileIoEpType::ReadFileDirectReply)) {
+        fprintf(stderr, "%s received wrong packet type %08x!\n", __FUNCTION__, packet->type);
+        return -50;
+    }
+
+    // deserialize the response
+    auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(data.size() < sizeof(FileIoReadReqReply)) {
+        return -1;
+    }
+    auto reply = reinterpret_cast<const FileIoReadReqReply *>(data.data());
+
+    const size_t chunk = reply->tag;
+    if(chunk >= state.nextChunk) {
+        return -50;
+    }
+
+    if(reply->status) {
+        if(!state.err) state.err = (reply->status < 0) ? reply->status : -reply->status;
+        return 0;
+    }
+
+    // if no data was returned, we've reached the end of the file
+    auto &done = state.received[chunk];
+    const auto remaining = state.chunkLength(chunk) - done;
+
+    if(!reply->dataLen) {
+        state.endChunk = std::min(state.endChunk, chunk);
+        return 0;
+    } else if(reply->dataLen > (data.size() - sizeof(FileIoReadReqReply))) {
+        // received buffer too small!
+        return -2;
+    }
+
+    const auto toCopy = std::min<size_t>(reply->dataLen, remaining);
+    void *writePtr = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(state.outBuf) +
+            (chunk * state.chunkSize) + done);
+    memcpy(writePtr, reply->data, toCopy);
+    done += toCopy;
+
+    // request the rest of a short chunk
+    if(done < state.chunkLength(chunk)) {
+        state.retry.push_back(chunk);
+    }
+
+    return 0;
+}
+
+/**
+ * Sends requests for chunks (or the remainder of short chunks) until the maximum number of
+ * requests are in flight, or there's nothing left to request.
+ */
+static void SendChunkRequests(ReadState &state, const uintptr_t serverPort,
+        const uintptr_t replyPort) {
+    int err;
+
+    while(!state.err && state.inFlight < kMaxReadsInFlight) {
+        size_t chunk;
+        bool isRetry{false};
+
+        // finish short chunks first, unless they're past the end of the file
+        while(!state.retry.empty() && state.retry.back() > state.endChunk) {
+            state.retry.pop_back();
+        }
+
+        if(!state.retry.empty()) {
+            chunk = state.retry.back();
+            isRetry = true;
+        } else if(state.nextChunk < state.numChunks && state.nextChunk < state.endChunk) {
+            chunk = state.nextChunk;
+        } else {
+            break;
+        }
+
+        err = SendChunkRequest(state, chunk, serverPort, replyPort);
+
+        // if the server's queue is full, wait for some of our requests to complete first
+        if(err) {
+            if(!state.inFlight) state.err = err;
+            break;
+        }
+
+        if(isRetry) {
+            state.retry.pop_back();
+        } else {
+            state.nextChunk++;
+        }
+        state.inFlight++;
+    }
+}
+
 /**
  * Performs file reads if the direct IO strategy is available.
  *
- * This reads the file in small chunks via direct message passing.
+ * This reads the file in small chunks via direct message passing. Requests for up to
+ * kMaxReadsInFlight chunks are sent before waiting for any replies, so the server can work on the
+ * next chunk while we copy out the previous one. Replies carry the chunk index as their tag, so
+ * they may arrive in any order.
+ *
+ * The read ends at the first chunk for which the server returns no data at all; data returned
+ * for any later chunks is discarded.
  */
-LIBRPC_INTERNAL static int FileReadDirect(const uintptr_t file, const uint64_t _offset, const size_t length,
-        void *outBuf) {
+LIBRPC_INTERNAL static int FileReadDirect(const FileIoServer *server, const uintptr_t file,
+        const uint64_t offset, const size_t length, void *outBuf) {
     int err;
     void *rxBuf = nullptr;
 
-    // calculate how many IO requests we need to make
-    size_t numChunks = 1, chunkSize = length;
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
 
-    if(gState.maxIoSize && length > gState.maxIoSize) {
-        numChunks = (length + gState.maxIoSize - 1) / gState.maxIoSize;
-        chunkSize = gState.maxIoSize;
+    // calculate how many IO requests we need to make
+    ReadState state;
+    state.file = file;
+    state.offset = offset;
+    state.length = length;
+    state.outBuf = outBuf;
+    state.numChunks = 1;
+    state.chunkSize = length;
+
+    const auto maxIoSize = server->maxIoSize;
+    if(maxIoSize && length > maxIoSize) {
+        state.numChunks = (length + maxIoSize - 1) / maxIoSize;
+        state.chunkSize = maxIoSize;
     }
 
-    // set up a buffer for the send request (128 = fixed overhead for rest of read req fields)
-    auto rxBufSize = chunkSize + (128) + sizeof(RpcPacket) + sizeof(MessageHeader);
+    state.received.resize(state.numChunks, 0);
+
+    // set up a buffer for the replies (128 = fixed overhead for rest of read req fields)
+    auto rxBufSize = state.chunkSize + (128) + sizeof(RpcPacket) + sizeof(MessageHeader);
     rxBufSize = ((rxBufSize + 15) / 16) * 16;
 
     err = posix_memalign(&rxBuf, 16, rxBufSize);
@@ -48,118 +238,61 @@ LIBRPC_INTERNAL static int FileReadDirect(const uintptr_t file, const uint64_t _
         return err;
     }
 
-    memset(rxBuf, 0, rxBufSize);
-
-    // perform the required number of reads
-    uint64_t offset = _offset;
-    size_t bytesRead = 0;
-
-    for(size_t i = 0; i < numChunks; i++) {
-        // send the request
-        FileIoReadReq req;
-        memset(&req, 0, sizeof(req));
-
-        req.file = file;
-        req.offset = offset;
-        req.length = std::min(chunkSize, (length - bytesRead));
-
-        auto requestBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&req), sizeof(req));
+    // keep requests in flight until all chunks were read, or the read ended early
+    while(true) {
+        SendChunkRequests(state, server->port, replyPort);
+        if(!state.inFlight) break;
 
-        err = rpc::RpcSend(gState.ioServerPort, static_cast<uint32_t>(FileIoEpType::ReadFileDirect),
-                requestBuf, gState.replyPort);
-        if(err) goto fail;
-
-        // receive response
+        // receive a response
         struct MessageHeader *msg = (struct MessageHeader *) rxBuf;
-        err = PortReceive(gState.replyPort, msg, rxBufSize, UINTPTR_MAX);
-
-        if(err > 0) {
-            // read out the type
-            if(msg->receivedBytes < sizeof(RpcPacket)) {
-                err = -50;
-                goto fail;
-            }
-
-            const auto packet = reinterpret_cast<RpcPacket *>(msg->data);
-            if(packet->type != static_cast<uint32_t>(FileIoEpType::ReadFileDirectReply)) {
-                fprintf(stderr, "%s received wrong packet type %08x!\n", __FUNCTION__, packet->type);
-                err = -50;
-                goto fail;
-            }
-
-            // deserialize the response
-            auto data = std::span(packet->payload, err - sizeof(RpcPacket));
-            if(data.size() < sizeof(FileIoReadReqReply)) {
-                err = -1;
-                goto fail;
-            }
-            auto req = reinterpret_cast<const FileIoReadReqReply *>(data.data());
-
-            if(req->status < 0) {
-                err = req->status;
-                goto fail;
-            }
-
-            // the read succeeded at least partially
-            if(!req->dataLen) {
-                goto beach;
-            }
-            if(req->dataLen > (data.size() - sizeof(FileIoReadReqReply))) {
-                // received buffer too small!
-                err = -2;
-                goto fail;
-            }
-
-            const auto toCopy = std::min(req->dataLen, (length - bytesRead));
-            void *writePtr = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(outBuf) + bytesRead);
-            memcpy(writePtr, req->data, toCopy);
-
-            // bookkeeping
-            bytesRead += toCopy;
-            offset += toCopy;
+        err = PortReceive(replyPort, msg, rxBufSize, UINTPTR_MAX);
+        if(err <= 0) {
+            // we can't tell which requests are still outstanding, so the port can't be reused
+            replyPort.discard();
+            if(!state.err) state.err = err ? err : -1;
+            break;
         }
-        // read error
-        else {
-            goto fail;
+
+        state.inFlight--;
+
+        err = HandleChunkReply(state, msg, err);
+        if(err) {
+            replyPort.discard();
+            if(!state.err) state.err = err;
         }
     }
 
-beach:;
-    // finished reading; sum up the number of bytes read
-    err = bytesRead;
-
-fail:;
-    // clean up
     free(rxBuf);
-    return err;
+
+    // finished reading; sum up the number of bytes read
+    if(state.err) {
+        return state.err;
+    } else if(state.endChunk != SIZE_MAX) {
+        return (state.endChunk * state.chunkSize) + state.received[state.endChunk];
+    }
+    return length;
 }
 
 /**
  * Wrapper around the file read.
  *
- * We split the IO into chunks that are a multiple of the server IO block size.
+ * We split the IO into chunks that are a multiple of the server IO block size. Any number of
+ * reads may be performed concurrently, from different threads.
  */
 int FileRead(const uintptr_t file, const uint64_t offset, const size_t length, void *buf) {
-    int err;
-
     // validate arguments
     if(!file || !length || !buf) {
         return -1;
     }
 
-    // acquire lock
-    err = mtx_lock(&gState.lock);
-    if(err != thrd_success) return -1;
+    const auto server = GetServer(false);
+    if(!server) return -1;
 
     // select best method
-    if(TestFlags(gState.caps & ServerCaps::DirectIo)) {
-        err = FileReadDirect(file, offset, length, buf);
+    if(TestFlags(server->caps & ServerCaps::DirectIo)) {
+        return FileReadDirect(server, file, offset, length, buf);
     } else {
         fprintf(stderr, "no available read methods for file %08x!\n", file);
-        err = -1;
+        return -1;
     }
-
-    // unlock
-    mtx_unlock(&gState.lock);
-    return err;
 }
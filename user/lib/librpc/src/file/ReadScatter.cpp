@@ -0,0 +1,317 @@
+#include "FileIo.h"
+
+#include "rpc/file.h"
+#include "sys/syscalls.h"
+
+#include "helpers/Send.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <rpc/RpcPacket.hpp>
+#include <rpc/FileIO.hpp>
+
+using namespace fileio;
+using namespace rpc;
+
+/// Maximum number of segments to read with a single request
+constexpr static const size_t kMaxSegmentsPerRequest{64};
+/// Maximum number of requests that may be outstanding at once
+constexpr static const size_t kMaxRequestsInFlight{4};
+
+/**
+ * A group of segments that are read with a single request.
+ */
+struct Batch {
+    /// index into the list of segment indices of the first segment
+    size_t first;
+    /// number of segments
+    size_t count;
+};
+
+/**
+ * State of a scatter read
+ */
+struct ScatterState {
+    /// file to read from
+    uintptr_t file;
+    /// caller's segments
+    FileReadSegment_t *segments;
+
+    /// indices of all segments that are read with batched requests
+    std::vector<size_t> indices;
+    /// batches to request
+    std::vector<Batch> batches;
+    /// largest number of data bytes in any batch
+    size_t maxBatchBytes{0};
+
+    /// next batch to request
+    size_t nextBatch{0};
+    /// number of requests for which we haven't received a reply
+    size_t inFlight{0};
+
+    /// first error encountered
+    int err{0};
+};
+
+/**
+ * Splits the segments into batches. Each batch has at most kMaxSegmentsPerRequest segments, whose
+ * total length doesn't exceed the server's maximum IO size. Segments that are too large to fit
+ * into any batch are read individually.
+ *
+ * @param serverMaxIoSize Maximum IO size of the server, or 0 if unlimited
+ *
+ * @return 0 on success, or a negative error code if reading an individual segment failed.
+ */
+static int BuildBatches(ScatterState &state, const size_t numSegments,
+        const size_t serverMaxIoSize) {
+    const size_t maxIoSize = serverMaxIoSize ? serverMaxIoSize : SIZE_MAX;
+    size_t batchBytes{0};
+
+    for(size_t i = 0; i < numSegments; i++) {
+        auto &seg = state.segments[i];
+        seg.bytesRead = 0;
+
+        if(!seg.length) continue;
+
+        // too large to batch
+        if(seg.length > maxIoSize) {
+            int err = FileRead(state.file, seg.offset, seg.length, seg.buf);
+            if(err < 0) return err;
+
+            seg.bytesRead = err;
+            continue;
+        }
+
+        // start a new batch if this one is full
+        if(state.batches.empty() || state.batches.back().count == kMaxSegmentsPerRequest ||
+                (maxIoSize - batchBytes) < seg.length) {
+            state.batches.push_back({state.indices.size(), 0});
+            batchBytes = 0;
+        }
+
+        state.indices.push_back(i);
+        state.batches.back().count++;
+
+        batchBytes += seg.length;
+        state.maxBatchBytes = std::max(state.maxBatchBytes, batchBytes);
+    }
+
+    return 0;
+}
+
+/**
+ * Sends the request for the next batch. The batch index is used as the tag.
+ */
+static int SendBatchRequest(ScatterState &state, const uintptr_t serverPort,
+        const uintptr_t replyPort) {
+    const auto &batch = state.batches[state.nextBatch];
+
+    // build the request
+    uint8_t buf[sizeof(FileIoReadScatterReq) + (sizeof(FileIoReadSegment) * kMaxSegmentsPerRequest)];
+    memset(buf, 0, sizeof(buf));
+
+    auto req = reinterpret_cast<FileIoReadScatterReq *>(buf);
+    req->file = state.file;
+    req->tag = state.nextBatch;
+    req->numSegments = batch.count;
+
+    for(size_t i = 0; i < batch.count; i++) {
+        const auto &seg = state.segments[state.indices[batch.first + i]];
+        req->segments[i].offset = seg.offset;
+        req->segments[i].length = seg.length;
+    }
+
+    const auto reqLen = sizeof(FileIoReadScatterReq) + (sizeof(FileIoReadSegment) * batch.count);
+    auto requestBuf = std::span<uint8_t>(buf, reqLen);
+
+    return rpc::RpcSend(serverPort, static_cast<uint32_t>(FileIoEpType::ReadFileScatter),
+            requestBuf, replyPort);
+}
+
+/**
+ * Handles a reply to a batch request, copying each segment's data to its buffer.
+ *
+ * @return 0 if the reply was handled (even if it indicates the read failed) or an error code if
+ * the reply is malformed.
+ */
+static int HandleBatchReply(ScatterState &state, const struct MessageHeader *msg,
+        const size_t msgLen) {
+    // read out the type
+    if(msg->receivedBytes < sizeof(RpcPacket)) {
+        return -50;
+    }
+
+    const auto packet = reinterpret_cast<const RpcPacket *>(msg->data);
+    if(packet->type != static_cast<uint32_t>(FileIoEpType::ReadFileScatterReply)) {
+        fprintf(stderr, "%s received wrong packet type %08x!\n", __FUNCTION__, packet->type);
+        return -50;
+    }
+
+    // deserialize the response
+    auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(data.size() < sizeof(FileIoReadScatterReqReply)) {
+        return -1;
+    }
+    auto reply = reinterpret_cast<const FileIoReadScatterReqReply *>(data.data());
+
+    if(reply->tag >= state.nextBatch) {
+        return -50;
+    }
+    const auto &batch = state.batches[reply->tag];
+
+    // servers may send errno values as positive status codes
+    if(reply->status) {
+        if(!state.err) state.err = (reply->status < 0) ? reply->status : -reply->status;
+        return 0;
+    } else if(reply->numSegments != batch.count) {
+        return -50;
+    }
+
+    // validate the lengths, then copy out the data
+    const size_t headerLen = sizeof(FileIoReadScatterReqReply) + (sizeof(uint32_t) * batch.count);
+    if(data.size() < headerLen) {
+        return -2;
+    }
+
+    size_t dataOff{headerLen};
+
+    for(size_t i = 0; i < batch.count; i++) {
+        auto &seg = state.segments[state.indices[batch.first + i]];
+        const size_t len = reply->segmentLengths[i];
+
+        if(len > seg.length) {
+            return -50;
+        } else if(len > (data.size() - dataOff)) {
+            // received buffer too small!
+            return -2;
+        }
+
+        memcpy(seg.buf, data.data() + dataOff, len);
+        seg.bytesRead = len;
+        dataOff += len;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads the segments with scatter read requests.
+ *
+ * Requests for up to kMaxRequestsInFlight batches are sent before waiting for any replies, in the
+ * same way as regular reads are pipelined.
+ */
+static int FileReadScatterBatched(const uintptr_t serverPort, ScatterState &state) {
+    int err;
+    void *rxBuf = nullptr;
+
+    if(state.batches.empty()) return 0;
+
+    ReplyPort replyPort;
+    if(!replyPort) return -1;
+
+    // set up a buffer large enough for the reply to the largest batch
+    auto rxBufSize = state.maxBatchBytes + sizeof(FileIoReadScatterReqReply) +
+        (sizeof(uint32_t) * kMaxSegmentsPerRequest) + sizeof(RpcPacket) + sizeof(MessageHeader);
+    rxBufSize = ((rxBufSize + 15) / 16) * 16;
+
+    err = posix_memalign(&rxBuf, 16, rxBufSize);
+    if(err) {
+        return err;
+    }
+
+    while(true) {
+        while(!state.err && state.nextBatch < state.batches.size() &&
+                state.inFlight < kMaxRequestsInFlight) {
+            err = SendBatchRequest(state, serverPort, replyPort);
+
+            // if the server's queue is full, wait for some of our requests to complete first
+            if(err) {
+                if(!state.inFlight) state.err = err;
+                break;
+            }
+
+            state.nextBatch++;
+            state.inFlight++;
+        }
+
+        if(!state.inFlight) break;
+
+        // receive a response
+        struct MessageHeader *msg = (struct MessageHeader *) rxBuf;
+        err = PortReceive(replyPort, msg, rxBufSize, UINTPTR_MAX);
+        if(err <= 0) {
+            replyPort.discard();
+            if(!state.err) state.err = err ? err : -1;
+            break;
+        }
+
+        state.inFlight--;
+
+        err = HandleBatchReply(state, msg, err);
+        if(err) {
+            replyPort.discard();
+            if(!state.err) state.err = err;
+        }
+    }
+
+    free(rxBuf);
+    return state.err;
+}
+
+/**
+ * Reads each of the segments with a separate read.
+ */
+static int FileReadEachSegment(const uintptr_t file, FileReadSegment_t *segments,
+        const size_t numSegments) {
+    for(size_t i = 0; i < numSegments; i++) {
+        auto &seg = segments[i];
+        seg.bytesRead = 0;
+
+        if(!seg.length) continue;
+
+        int err = FileRead(file, seg.offset, seg.length, seg.buf);
+        if(err < 0) return err;
+
+        seg.bytesRead = err;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads multiple ranges of the file, batching as many of them as possible into each request.
+ */
+int FileReadScatter(const uintptr_t file, FileReadSegment_t *segments, const size_t numSegments) {
+    int err;
+
+    // validate arguments
+    if(!file || !segments) {
+        return -1;
+    } else if(!numSegments) {
+        return 0;
+    }
+
+    const auto server = GetServer(false);
+    if(!server) return -1;
+
+    // fall back to individual reads if the server can't batch them
+    if(!TestFlags(server->caps & ServerCaps::ScatterRead)) {
+        return FileReadEachSegment(file, segments, numSegments);
+    }
+
+    ScatterState state;
+    state.file = file;
+    state.segments = segments;
+
+    err = BuildBatches(state, numSegments, server->maxIoSize);
+    if(err) return err;
+
+    return FileReadScatterBatched(server->port, state);
+}
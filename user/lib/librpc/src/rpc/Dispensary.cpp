@@ -12,6 +12,7 @@
 #include <cstring>
 #include <string>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 #include <rpc/RpcPacket.hpp>
@@ -32,6 +33,13 @@ LIBRPC_INTERNAL static uintptr_t gLookupReplyPort = 0;
 /// Receive buffer for replies from the port
 LIBRPC_INTERNAL static void *gRxBuffer = nullptr;
 
+/// Lock protecting the lookup cache
+LIBRPC_INTERNAL static mtx_t gCacheLock;
+/// Dispensary generation for which the contents of the cache are valid
+LIBRPC_INTERNAL static uint64_t gCacheGeneration = 0;
+/// Cached lookup results: a port handle, or 0 if the name is not registered
+LIBRPC_INTERNAL static std::unordered_map<std::string, uintptr_t> *gCache = nullptr;
+
 /**
  * Performs one-time initialization of the lookup machinery.
  *
@@ -55,11 +63,85 @@ LIBRPC_INTERNAL static void InitDispensary() {
     assert(!err);
 
     memset(gRxBuffer, 0, kMaxMsgLen);
+
+    // set up the lookup cache
+    err = mtx_init(&gCacheLock, mtx_plain);
+    assert(err == thrd_success);
+
+    gCache = new std::unordered_map<std::string, uintptr_t>;
+}
+
+/**
+ * Returns the current generation of the dispensary. It changes whenever any registration is
+ * added, changed or removed.
+ */
+static inline uint64_t GetGeneration() {
+    return __atomic_load_n(&__kush_infopg->dispensaryGeneration, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Looks up a name in the cache. If the dispensary's registrations have changed since the cache
+ * was filled, it's flushed first.
+ *
+ * @return Whether the name was found in the cache; its port is written to `outPort`, which is 0 if
+ * the name is known to not be registered.
+ */
+static bool CacheGet(const std::string &name, uintptr_t &outPort) {
+    mtx_lock(&gCacheLock);
+
+    const auto generation = GetGeneration();
+    if(generation != gCacheGeneration) {
+        gCache->clear();
+        gCacheGeneration = generation;
+
+        mtx_unlock(&gCacheLock);
+        return false;
+    }
+
+    bool found{false};
+    if(auto it = gCache->find(name); it != gCache->end()) {
+        outPort = it->second;
+        found = true;
+    }
+
+    mtx_unlock(&gCacheLock);
+    return found;
+}
+
+/**
+ * Stores a lookup result in the cache, as long as the dispensary's registrations haven't changed
+ * since the lookup was started.
+ *
+ * @param generation Dispensary generation read before the lookup request was sent
+ */
+static void CachePut(const std::string &name, const uintptr_t port, const uint64_t generation) {
+    mtx_lock(&gCacheLock);
+
+    if(generation == gCacheGeneration && generation == GetGeneration()) {
+        (*gCache)[name] = port;
+    }
+
+    mtx_unlock(&gCacheLock);
+}
+
+/**
+ * Removes a name from the lookup cache.
+ */
+void InvalidateService(const char * _Nonnull name) {
+    if(!gCache) return;
+
+    mtx_lock(&gCacheLock);
+    gCache->erase(name);
+    mtx_unlock(&gCacheLock);
 }
 
 /**
  * Attempts to resolve a name into a port.
  *
+ * Results are cached, including those for names that aren't registered; the cache is invalidated
+ * whenever the dispensary's generation counter (in the info page) changes, so only the first
+ * lookup of a name after a change requires a round trip to the dispensary.
+ *
  * All RPC requests will block forever. This is in theory not a problem, assuming the root server
  * never goes away...
  *
@@ -69,9 +151,10 @@ LIBRPC_INTERNAL static void InitDispensary() {
  * @return 0 if the request was completed, but the port was not found; 1 if the port was found; or
  * a negative error code.
  */
-int LookupService(const char * _Nonnull _name, uintptr_t * _Nonnull outPort) {\
+int LookupService(const char * _Nonnull _name, uintptr_t * _Nonnull outPort) {
     int err;
     std::span<uint8_t> buf;
+    uint64_t generation;
 
     // validate string inputs
     const auto nameLen = strlen(_name);
@@ -92,6 +175,15 @@ int LookupService(const char * _Nonnull _name, uintptr_t * _Nonnull outPort) {\
         InitDispensary();
     });
 
+    // check the cache
+    const std::string name(_name, nameLen);
+    uintptr_t cachedPort{0};
+
+    if(CacheGet(name, cachedPort)) {
+        *outPort = cachedPort;
+        return cachedPort ? 1 : 0;
+    }
+
     // acquire the lock
     err = mtx_lock(&gLookupReplyPortLock);
     if(err != thrd_success) {
@@ -99,6 +191,8 @@ int LookupService(const char * _Nonnull _name, uintptr_t * _Nonnull outPort) {\
         return err;
     }
 
+    generation = GetGeneration();
+
     // build the send request
     auto req = reinterpret_cast<RootSrvDispensaryLookup *>(gRxBuffer);
     memset(req, 0, packetLen);
@@ -159,6 +253,8 @@ int LookupService(const char * _Nonnull _name, uintptr_t * _Nonnull outPort) {\
         }
     }
 
+    CachePut(name, *outPort, generation);
+
     // clean up
     mtx_unlock(&gLookupReplyPortLock);
     return err;
@@ -169,6 +265,116 @@ fail:;
     return err;
 }
 
+/**
+ * Waits for a service to be registered.
+ *
+ * If the name isn't registered already, a wait request is sent to the dispensary, which replies
+ * once it has been. Each wait uses its own reply port: if we time out, the reply may still arrive
+ * later, so the port is destroyed rather than reused.
+ *
+ * @param name Service name to look up; this is a zero-terminated UTF-8 string.
+ * @param timeoutUs Microseconds to wait for the registration, or UINTPTR_MAX to wait forever
+ * @param outPort If a port is found, its handle is written to this variable.
+ *
+ * @return 0 if the timeout expired before the name was registered; 1 if the port was found; or a
+ * negative error code.
+ */
+int WaitForService(const char * _Nonnull _name, const uintptr_t timeoutUs,
+        uintptr_t * _Nonnull outPort) {
+    int err;
+    std::span<uint8_t> buf;
+    uintptr_t replyPort{0};
+    void *rxBuf{nullptr};
+
+    // it may have been registered already
+    err = LookupService(_name, outPort);
+    if(err) {
+        return err;
+    } else if(!timeoutUs) {
+        return 0;
+    }
+
+    const auto nameLen = strlen(_name);
+    const auto packetLen = sizeof(RootSrvDispensaryLookup) + nameLen + 1;
+
+    // set up a reply port and buffer
+    err = PortCreate(&replyPort);
+    if(err) {
+        return err;
+    }
+
+    err = posix_memalign(&rxBuf, 16, kMaxMsgLen);
+    if(err) {
+        err = -1;
+        goto fail;
+    }
+
+    // send the wait request
+    {
+        auto req = reinterpret_cast<RootSrvDispensaryLookup *>(rxBuf);
+        memset(req, 0, packetLen);
+
+        req->nameLen = nameLen;
+        memcpy(req->name, _name, nameLen);
+
+        buf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(req), packetLen);
+
+        err = RpcSend(__kush_infopg->dispensaryPort,
+                static_cast<uint32_t>(RootSrvDispensaryEpType::WaitFor), buf, replyPort);
+        if(err) {
+            goto fail;
+        }
+    }
+
+    // wait for the reply
+    err = PortReceive(replyPort, reinterpret_cast<struct MessageHeader *>(rxBuf), kMaxMsgLen,
+            timeoutUs);
+
+    // timed out (or another receive error)
+    if(err <= 0) {
+        err = 0;
+        goto fail;
+    }
+
+    // interpret the reply
+    {
+        const auto rxMsg = reinterpret_cast<struct MessageHeader *>(rxBuf);
+        auto packet = reinterpret_cast<RpcPacket *>(rxMsg->data);
+
+        if(static_cast<size_t>(err) < sizeof(RpcPacket) ||
+                packet->type != static_cast<uint32_t>(RootSrvDispensaryEpType::WaitForReply)) {
+            err = -1;
+            goto fail;
+        }
+
+        auto data = std::span(packet->payload, err - sizeof(RpcPacket));
+        if(data.size() < sizeof(RootSrvDispensaryLookupReply)) {
+            err = -1;
+            goto fail;
+        }
+
+        auto reply = reinterpret_cast<const RootSrvDispensaryLookupReply *>(data.data());
+        if(reply->status || !reply->port) {
+            err = -1;
+            goto fail;
+        }
+
+        *outPort = reply->port;
+        err = 1;
+    }
+
+    // the registration changed the generation, so this will be cached on the next lookup
+    PortDestroy(replyPort);
+    free(rxBuf);
+    return err;
+
+fail:;
+    // failure handler; release the port and buffer
+    PortDestroy(replyPort);
+    free(rxBuf);
+    return err;
+}
+
 /**
  * Registers a named service.
  *
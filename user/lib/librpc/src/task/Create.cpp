@@ -12,11 +12,21 @@
 using namespace task;
 using namespace rpc;
 
+static_assert(RPC_TASK_CREATE_BIND_NOW == TaskEndpointCreateFlags::BindNow);
+
 /**
  * Task creation function
  *
  */
 int RpcTaskCreate(const char *path, const char **args, uintptr_t *outHandle) {
+    return RpcTaskCreateWithFlags(path, args, 0, outHandle);
+}
+
+/**
+ * Creates a task, passing the given flags to the task server.
+ */
+int RpcTaskCreateWithFlags(const char *path, const char **args, const uint32_t flags,
+        uintptr_t *outHandle) {
     int err;
     struct MessageHeader *rxMsg = nullptr;
 
@@ -64,7 +74,7 @@ int RpcTaskCreate(const char *path, const char **args, uintptr_t *outHandle) {
 
     // finish up the param
     mpack_write_cstr(&writer, "flags");
-    mpack_write_u32(&writer, 0);
+    mpack_write_u32(&writer, flags);
 
     mpack_finish_map(&writer);
 
@@ -28,6 +28,11 @@ typedef struct __system_info {
 
     /// lookup service handle
     uintptr_t dispensaryPort;
+    /**
+     * Incremented by the dispensary whenever a name is registered, re-registered or removed; so
+     * clients may cache lookups, and discard them once this value changes.
+     */
+    uint64_t dispensaryGeneration;
 } kush_sysinfo_page_t;
 
 #endif
@@ -7,5 +7,9 @@
 
 LIBSYSTEM_EXPORT int GetEntropy(void * _Nonnull outBuf, const size_t outBufSize);
 
+LIBSYSTEM_EXPORT int TraceSetMask(const uint32_t mask, uint32_t * _Nullable outOldMask);
+LIBSYSTEM_EXPORT int TraceRead(void * _Nonnull outBuf, const size_t outBufSize,
+        uint64_t * _Nullable outLost);
+
 #endif
 
@@ -14,4 +14,24 @@ LIBSYSTEM_EXPORT int TaskSetName(const uintptr_t handle, const char * _Nonnull n
 
 LIBSYSTEM_EXPORT int DbgOut(const char * _Nonnull string, const size_t length);
 
+/// Header of a record read from the kernel log
+struct KernelLogRecord {
+    /// Total size of the record, including this header and padding
+    uint32_t size;
+    /// Length of the message following the header; it is not zero terminated
+    uint16_t length;
+    /// Processor that logged the message
+    uint8_t coreId;
+    /// Reserved
+    uint8_t flags;
+    /// Time at which the message was logged, in nanoseconds since boot
+    uint64_t timestamp;
+};
+
+/// Largest log record the kernel may return
+#define KERNEL_LOG_MAX_RECORD           (16 + 512)
+
+LIBSYSTEM_EXPORT int DbgReadLog(void * _Nonnull outBuf, const size_t outBufSize,
+        uintptr_t * _Nonnull cursor);
+
 #endif
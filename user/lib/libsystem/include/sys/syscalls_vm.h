@@ -15,6 +15,30 @@ typedef struct TaskVmInfo {
     uintptr_t numVmMaps;
 } TaskVmInfo_t;
 
+/**
+ * Message sent by the kernel to the pager's port when pages of a pager-backed region are needed.
+ * The message's sender is the thread that faulted on the page.
+ *
+ * The same message (with a type of VM_PAGER_RELEASE_TYPE, and no range) is sent once the region
+ * is no longer mapped in any task, either because they unmapped it, or were destroyed.
+ */
+typedef struct VmPagerRequest {
+    /// VM_PAGER_REQUEST_TYPE or VM_PAGER_RELEASE_TYPE
+    uint32_t type;
+    uint32_t reserved;
+    /// handle of the region pages are requested for
+    uintptr_t region;
+    /// cookie specified when the region was created
+    uintptr_t cookie;
+    /// byte offset into the region of the first page requested
+    uint64_t offset;
+    /// number of bytes requested
+    uint64_t length;
+} VmPagerRequest_t;
+
+#define VM_PAGER_REQUEST_TYPE           (0x50414745)
+#define VM_PAGER_RELEASE_TYPE           (0x5052454C)
+
 /**
  * Flags for AllocVirtual*Region
  */
@@ -62,8 +86,15 @@ LIBSYSTEM_EXPORT int AllocVirtualAnonRegion(const uintptr_t size, const uintptr_
         uintptr_t *outHandle);
 LIBSYSTEM_EXPORT int AllocVirtualPhysRegion(const uint64_t physAddr, const uintptr_t size,
         const uintptr_t inFlags, uintptr_t *outHandle);
+LIBSYSTEM_EXPORT int AllocVirtualPagerRegion(const uintptr_t size, const uintptr_t inFlags,
+        const uintptr_t pagerPort, const uintptr_t cookie, uintptr_t *outHandle);
 LIBSYSTEM_EXPORT int DeallocVirtualRegion(const uintptr_t regionHandle);
 
+LIBSYSTEM_EXPORT int VirtualRegionSupplyPages(const uintptr_t regionHandle, const uintptr_t offset,
+        const void *data, const size_t length);
+LIBSYSTEM_EXPORT int VirtualRegionFailPages(const uintptr_t regionHandle, const uintptr_t offset,
+        const size_t length);
+
 LIBSYSTEM_EXPORT int ResizeVirtualRegion(const uintptr_t regionHandle, const uintptr_t newSize);
 
 LIBSYSTEM_EXPORT int MapVirtualRegion(const uintptr_t regionHandle, const uintptr_t baseAddr,
@@ -9,4 +9,33 @@ int GetEntropy(void * _Nonnull outBuf, const size_t outBufSize) {
     return __do_syscall2((uintptr_t) outBuf, outBufSize, SYS_MISC_GET_ENTROPY);
 }
 
+/**
+ * Sets the mask of enabled kernel trace event categories; bit n enables the category with value n.
+ *
+ * @param outOldMask If non-null, receives the previously enabled categories.
+ */
+int TraceSetMask(const uint32_t mask, uint32_t * _Nullable outOldMask) {
+    intptr_t ret = __do_syscall1(mask, SYS_MISC_TRACE_SET_MASK);
+    if(ret < 0) {
+        return ret;
+    }
+
+    if(outOldMask) {
+        *outOldMask = ret;
+    }
+    return 0;
+}
 
+/**
+ * Reads trace records out of the kernel's trace buffers. Each record is 64 bytes; see the kernel's
+ * `debug::TraceRecord` for its layout.
+ *
+ * @param outLost If non-null, receives the number of records lost because they were overwritten
+ *        before they could be read.
+ *
+ * @return Number of bytes of records read, or a negative error code.
+ */
+int TraceRead(void * _Nonnull outBuf, const size_t outBufSize, uint64_t * _Nullable outLost) {
+    return __do_syscall3((uintptr_t) outBuf, outBufSize, (uintptr_t) outLost,
+            SYS_MISC_TRACE_READ);
+}
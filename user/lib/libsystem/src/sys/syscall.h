@@ -49,6 +49,8 @@ LIBSYSTEM_INTERNAL intptr_t __do_syscall5(const uintptr_t arg0, const uintptr_t
 #define SYS_VM_ADDR_TO_HANDLE           0x1A
 #define SYS_VM_VIRT_TO_PHYS             0x1B
 #define SYS_VM_QUERY                    0x1C
+#define SYS_VM_CREATE_PAGER             0x1D
+#define SYS_VM_PAGER_SUPPLY             0x1E
 
 #define SYS_THREAD_GET_HANDLE           0x20
 #define SYS_THREAD_YIELD                0x21
@@ -70,6 +72,7 @@ LIBSYSTEM_INTERNAL intptr_t __do_syscall5(const uintptr_t arg0, const uintptr_t
 #define SYS_TASK_WAIT                   0x35
 
 #define SYS_TASK_DBG_OUT                0x36
+#define SYS_TASK_DBG_READ_LOG           0x37
 
 #define SYS_ARCH_INSTALL_IRQ            0x38
 #define SYS_ARCH_UNINSTALL_IRQ          0x39
@@ -78,6 +81,8 @@ LIBSYSTEM_INTERNAL intptr_t __do_syscall5(const uintptr_t arg0, const uintptr_t
 #define SYS_ARCH_ALLOC_LOCAL            0x3C
 
 #define SYS_MISC_GET_ENTROPY            0x40
+#define SYS_MISC_TRACE_SET_MASK         0x41
+#define SYS_MISC_TRACE_READ             0x42
 
 // first architecture specific syscall number
 #define SYS_ARCH                        0x48
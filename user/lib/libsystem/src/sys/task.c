@@ -74,7 +74,25 @@ int TaskSetName(const uintptr_t handle, const char *name) {
 
 /**
  * Writes the given string to the debug output stream for the process.
+ *
+ * Each call produces a single kernel log record; messages that don't fit in a record (512 bytes,
+ * including the task and thread ID prefix) are truncated, and end with a `[...]` marker.
  */
 int DbgOut(const char *string, const size_t length) {
     return __do_syscall2((uintptr_t) string, length, SYS_TASK_DBG_OUT);
 }
+
+/**
+ * Reads records from the kernel log, starting at the given offset. Each record consists of a
+ * `KernelLogRecord` header followed by the message; the next record begins `size` bytes after it.
+ *
+ * @param outBuf Buffer to receive records; must be at least `KERNEL_LOG_MAX_RECORD` bytes.
+ * @param cursor Offset of the first record to read, or 0 to read from the oldest record; it is
+ *        updated so that the next call returns the records following those just read.
+ *
+ * @return Number of bytes of records read, or a negative error code.
+ */
+int DbgReadLog(void *outBuf, const size_t outBufSize, uintptr_t *cursor) {
+    return __do_syscall3((uintptr_t) outBuf, outBufSize, (uintptr_t) cursor,
+            SYS_TASK_DBG_READ_LOG);
+}
@@ -178,6 +178,58 @@ int AllocVirtualPhysRegion(const uint64_t physAddr, const uintptr_t size, const
     return (err < 0) ? err : 0;
 }
 
+/**
+ * Creates a new virtual memory object whose pages are provided by a pager.
+ *
+ * When a page of the region is first accessed, a `VmPagerRequest_t` message is sent to the given
+ * port; the pager should respond by calling `VirtualRegionSupplyPages` (or failing the request
+ * with `VirtualRegionFailPages`) for the requested range.
+ *
+ * Pager-backed regions are currently only supported by the amd64 kernel.
+ */
+int AllocVirtualPagerRegion(const uintptr_t size, const uintptr_t inFlags,
+        const uintptr_t pagerPort, const uintptr_t cookie, uintptr_t *outHandle) {
+    intptr_t err;
+    if(!outHandle) return -1;
+
+    // build flags
+    uintptr_t flags = 0;
+    flags = BuildSyscallFlags(inFlags, false);
+
+    // perform syscall
+    err = __do_syscall4(size, flags, pagerPort, cookie, SYS_VM_CREATE_PAGER);
+
+    // return 0 for success, syscall error otherwise
+    if(err > 0) {
+        *outHandle = err;
+    }
+
+    return (err < 0) ? err : 0;
+}
+
+/**
+ * Provides pages to a pager-backed region, waking up any threads waiting for them.
+ *
+ * The data is moved (rather than copied) out of the caller's memory: it must be page aligned, and
+ * in anonymous memory owned by the caller. Afterwards, the contents of the source pages are
+ * undefined.
+ */
+int VirtualRegionSupplyPages(const uintptr_t regionHandle, const uintptr_t offset,
+        const void *data, const size_t length) {
+    if(!data) return -1;
+    return __do_syscall4(regionHandle, offset, (const uintptr_t) data, length,
+            SYS_VM_PAGER_SUPPLY);
+}
+
+/**
+ * Fails all outstanding page requests for the given range of a pager-backed region; threads that
+ * were waiting for them take an unhandled page fault.
+ */
+int VirtualRegionFailPages(const uintptr_t regionHandle, const uintptr_t offset,
+        const size_t length) {
+    return __do_syscall4(regionHandle, offset, 0, length, SYS_VM_PAGER_SUPPLY);
+}
+
 /**
  * Deallocates a virtual memory object.
  */
@@ -36,6 +36,12 @@ typedef struct {
     uintptr_t numArgs;
     /// An array containing pointers to each of the arguments
     const char **args;
+
+    /// Flags that modify how the program is loaded (TASK_LAUNCHINFO_FLAG_*)
+    uintptr_t flags;
+
+    /// Kernel handle of the task that loaded the program (that is, the root server)
+    uintptr_t loaderTask;
 } kush_task_launchinfo_t;
 
 #ifdef __cplusplus
@@ -45,6 +51,9 @@ static_assert(offsetof(kush_task_launchinfo_t, args) == LAUNCHINFO_OFF_ARGPTR);
 
 /// Magic value for the task launch info
 #define TASK_LAUNCHINFO_MAGIC           'TASK'
+
+/// Dynamic linker should bind all jump table relocations before invoking the program
+#define TASK_LAUNCHINFO_FLAG_BIND_NOW   (1 << 0)
 #endif
 
 #endif
@@ -25,6 +25,11 @@ enum class RootSrvDispensaryEpType: uint32_t {
     Register                            = 'REGP',
     /// Registration reply
     RegisterReply                       = Register | ReplyFlag,
+
+    /// Client -> server; wait for a name to be registered
+    WaitFor                             = 'WAIT',
+    /// Server -> client; sent once the name is registered
+    WaitForReply                        = WaitFor | ReplyFlag,
 };
 
 /**
@@ -38,6 +43,9 @@ struct RootSrvDispensaryLookup {
 };
 /**
  * Response to a previous request to look up a port.
+ *
+ * This is also sent in reply to a wait request (which uses the same request structure as a
+ * lookup) once the name has been registered; until then, no reply is sent.
  */
 struct RootSrvDispensaryLookupReply {
     /// status code: 0 indicates success
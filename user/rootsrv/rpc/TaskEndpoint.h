@@ -11,4 +11,12 @@ enum class TaskEndpointType: uint32_t {
     CreateTaskReply                     = 0x924C9DE8,
 };
 
+/**
+ * Flags for the task creation request
+ */
+enum TaskEndpointCreateFlags: uint32_t {
+    /// Bind all symbols of the program at load time, rather than lazily
+    BindNow                             = (1 << 0),
+};
+
 #endif
@@ -1,8 +1,12 @@
 #include "Registry.h"
 
+#include "task/InfoPage.h"
 #include "log.h"
 
-#include <thread>
+#include <sys/_infopage.h>
+
+#include <algorithm>
+#include <vector>
 
 using namespace dispensary;
 
@@ -12,23 +16,99 @@ Registry *Registry::gShared = nullptr;
 /**
  * Registers a new port. If there was a previous registration for this key, it's overwritten.
  *
+ * Any callbacks waiting for this name are invoked once the registration is done, without the
+ * lock held; so they may look up or register ports themselves.
+ *
  * @return Whether an existing key was overwritten (true) or the registration is new (false)
  */
 bool Registry::registerPort(const std::string_view &_key, const uintptr_t port) {
+    bool exists;
+    std::vector<std::function<void(uintptr_t)>> callbacks;
+
     // copy the key
     const std::string key(_key);
 
     // get the lock and insert
-    std::lock_guard<std::mutex> lg(this->lock);
+    {
+        std::lock_guard<std::mutex> lg(this->lock);
 
-    LOG("Registered port $%p'h for '%s'", port, key.c_str());
-    bool exists = this->storage.contains(key);
+        LOG("Registered port $%p'h for '%s'", port, key.c_str());
+        exists = this->storage.contains(key);
 
-    this->storage[key] = port;
+        if(!exists || this->storage[key] != port) {
+            this->storage[key] = port;
+            this->bumpGeneration();
+        }
+
+        // take out all waiters for this key
+        auto it = this->waiters.find(key);
+        if(it != this->waiters.end()) {
+            for(auto &waiter : it->second) {
+                callbacks.push_back(std::move(waiter.callback));
+            }
+            this->waiters.erase(it);
+        }
+    }
+
+    // notify them
+    for(const auto &f : callbacks) {
+        f(port);
+    }
 
     return exists;
 }
 
+/**
+ * Registers a callback to be invoked once a port is registered under the given name. If the name
+ * is already registered, the callback is invoked immediately, on the calling thread; otherwise, it
+ * runs on the thread that registers the name.
+ *
+ * Callbacks are invoked only once, for the first registration of the name after this call.
+ *
+ * @param evictable If set, the waiter may be dropped if there are too many evictable waiters for
+ *        the name; it's then invoked with a port handle of 0. This is used for waiters on behalf
+ *        of clients, which may have given up waiting.
+ */
+void Registry::notifyOnRegister(const std::string &key,
+        std::function<void(uintptr_t)> const &f, const bool evictable) {
+    uintptr_t port{0};
+    bool registered{false};
+    std::function<void(uintptr_t)> evicted;
+
+    {
+        std::lock_guard<std::mutex> lg(this->lock);
+
+        if(this->storage.contains(key)) {
+            port = this->storage.at(key);
+            registered = true;
+        } else {
+            auto &list = this->waiters[key];
+
+            // drop the oldest evictable waiter if there are too many
+            const auto numEvictable = std::count_if(list.begin(), list.end(), [](const auto &w) {
+                return w.evictable;
+            });
+            if(evictable && static_cast<size_t>(numEvictable) >= kMaxWaitersPerName) {
+                auto it = std::find_if(list.begin(), list.end(), [](const auto &w) {
+                    return w.evictable;
+                });
+                evicted = std::move(it->callback);
+                list.erase(it);
+
+                LOG("Too many waiters for '%s', evicted oldest", key.c_str());
+            }
+
+            list.push_back({f, evictable});
+        }
+    }
+
+    if(registered) {
+        f(port);
+    } else if(evicted) {
+        evicted(0);
+    }
+}
+
 /**
  * Looks up the given string in the map.
  *
@@ -51,32 +131,29 @@ bool Registry::lookupPort(const std::string &key, uintptr_t &outHandle) {
 }
 
 /**
- * Looks up the given string in the port map. If the key hasn't been registered yet, waits for
- * up to `wait` amount of time for it to be registered.
- *
- * This is a pretty shitty implementation since we just put the thread for sleep for a bit
+ * Removes the registration for the given name.
  *
- * @param wait How long to wait; if zero, wait forever
+ * @return Whether a registration was removed
  */
-bool Registry::lookupPort(const std::string &key, uintptr_t &outHandle,
-        const std::chrono::microseconds wait) {
-    bool check = true;
-
-    do {
-        // is the handle registered
-        if(this->lookupPort(key, outHandle)) {
-            return true;
-        }
+bool Registry::unregisterPort(const std::string &key) {
+    std::lock_guard<std::mutex> lg(this->lock);
 
-        // wait a bit
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if(!this->storage.erase(key)) {
+        return false;
+    }
 
-        // has timeout expired?
-        if(wait.count()) {
-            // TODO: implement
-        }
-    } while(check);
+    this->bumpGeneration();
+    return true;
+}
 
-    // if we drop here, timeout expired
-    return false;
+/**
+ * Increments the registry generation in the info page. This is done while holding the registry
+ * lock, before any replies for the change are sent; so a client observing the reply will also
+ * observe the new generation.
+ */
+void Registry::bumpGeneration() {
+    auto page = task::InfoPage::gShared;
+    if(!page || !page->info) return;
+
+    __atomic_add_fetch(&page->info->dispensaryGeneration, 1, __ATOMIC_RELEASE);
 }
@@ -1,11 +1,13 @@
 #ifndef DISPENSARY_REGISTRY_H
 #define DISPENSARY_REGISTRY_H
 
-#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <mutex>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 namespace dispensary {
 class RpcHandler;
@@ -13,6 +15,9 @@ class RpcHandler;
 /**
  * Underlying storage for the dispensary; this is a thin, thread-safe adapter around a string to
  * port handle mapping.
+ *
+ * Whenever the mapping changes, the generation counter in the info page is incremented; clients
+ * use it to invalidate their cached lookups.
  */
 class Registry {
     friend class RpcHandler;
@@ -24,9 +29,13 @@ class Registry {
             gShared = new Registry;
         }
 
-        static bool lookup(const std::string &key, uintptr_t &out,
-                const std::chrono::milliseconds wait = std::chrono::milliseconds(0)) {
-            return gShared->lookupPort(key, out, wait);
+        static bool lookup(const std::string &key, uintptr_t &out) {
+            return gShared->lookupPort(key, out);
+        }
+
+        static void notify(const std::string &key, std::function<void(uintptr_t)> const &f,
+                const bool evictable = false) {
+            gShared->notifyOnRegister(key, f, evictable);
         }
 
     public:
@@ -34,13 +43,31 @@ class Registry {
         bool registerPort(const std::string_view &key, const uintptr_t port);
         /// Looks up a name and transforms it into a port handle, returning immediately on failure.
         bool lookupPort(const std::string &key, uintptr_t &outHandle);
-        /// Looks up a port, waiting for up to the given amount of time for it to be registered.
-        bool lookupPort(const std::string &key, uintptr_t &outHandle,
-                const std::chrono::microseconds wait);
+        /// Invokes the callback once a port is registered under the given name.
+        void notifyOnRegister(const std::string &key, std::function<void(uintptr_t)> const &f,
+                const bool evictable = false);
         /// Unregisters the given port
-        bool unregisterPort(const std::string &key) {
-            return this->storage.erase(key);
-        }
+        bool unregisterPort(const std::string &key);
+
+    private:
+        /**
+         * A callback waiting for a name to be registered
+         */
+        struct Waiter {
+            /// function to invoke with the port handle
+            std::function<void(uintptr_t)> callback;
+            /// whether the waiter may be evicted if too many are waiting for the name
+            bool evictable{false};
+        };
+
+        /**
+         * Maximum number of evictable waiters per name. Clients that time out waiting leave their
+         * waiter behind, so this bounds how many of them can pile up for a name that's never
+         * registered.
+         */
+        constexpr static const size_t kMaxWaitersPerName{32};
+
+        void bumpGeneration();
 
     private:
         static Registry *gShared;
@@ -48,6 +75,8 @@ class Registry {
     private:
         std::mutex lock;
         std::unordered_map<std::string, uintptr_t> storage;
+        /// callbacks waiting for a name to be registered, oldest first
+        std::unordered_map<std::string, std::vector<Waiter>> waiters;
 };
 }
 
@@ -88,6 +88,11 @@ void RpcHandler::main() {
                     this->handleRegister(msg, packet, err);
                     break;
 
+                case static_cast<uint32_t>(RootSrvDispensaryEpType::WaitFor):
+                    if(!packet->replyPort) continue;
+                    this->handleWaitFor(msg, packet, err);
+                    break;
+
                 default:
                     LOG("Dispensary RPC invalid msg type: $%08x", packet->type);
                     break;
@@ -180,6 +185,53 @@ void RpcHandler::handleRegister(const struct MessageHeader *msg, const rpc::RpcP
     this->reply(packet, RootSrvDispensaryEpType::RegisterReply, replyBuf);
 }
 
+/**
+ * Handles a request to wait for a name to be registered. The reply is sent once it is, which may
+ * be right away; this is done from whichever thread registers the name.
+ *
+ * The client may have given up waiting by the time the reply is sent, so failing to send it is
+ * not an error. For the same reason, the waiter may be evicted if too many clients are waiting for
+ * the name; the reply then indicates failure.
+ */
+void RpcHandler::handleWaitFor(const struct MessageHeader *msg, const rpc::RpcPacket *packet,
+        const size_t msgLen) {
+    // deserialize the request
+    auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
+    if(data.size() < sizeof(RootSrvDispensaryLookup)) {
+        return;
+    }
+
+    auto req = reinterpret_cast<const RootSrvDispensaryLookup *>(data.data());
+    if(req->nameLen > (data.size() - sizeof(RootSrvDispensaryLookup))) {
+        return;
+    }
+
+    const std::string name(req->name, req->nameLen);
+    const auto replyPort = packet->replyPort;
+
+    if(kLogRequests) LOG("Wait for port '%s'", name.c_str());
+
+    // send the reply once registered
+    Registry::notify(name, [name, replyPort](uintptr_t port) {
+        const auto replyLen = sizeof(RootSrvDispensaryLookupReply) + name.length() + 1;
+        std::vector<uint8_t> txBuf(sizeof(RpcPacket) + replyLen, 0);
+
+        auto txPacket = reinterpret_cast<RpcPacket *>(txBuf.data());
+        txPacket->type = static_cast<uint32_t>(RootSrvDispensaryEpType::WaitForReply);
+
+        auto reply = reinterpret_cast<RootSrvDispensaryLookupReply *>(txPacket->payload);
+        reply->status = port ? 0 : 1;
+        reply->port = port;
+        reply->nameLen = name.length();
+        memcpy(reply->name, name.data(), name.length());
+
+        int err = PortSend(replyPort, txBuf.data(), txBuf.size());
+        if(err && kLogRequests) {
+            LOG("Failed to send wait reply for '%s': %d", name.c_str(), err);
+        }
+    }, true);
+}
+
 /**
  * Sends an RPC message.
  */
@@ -1,10 +1,12 @@
 #include "Bundle.h"
 #include "BundleTypes.h"
-#include "tar.h"
 
 #include "StringHelpers.h"
 
+#include <algorithm>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include <sys/syscalls.h>
 #include <compress/lzfse.h>
@@ -32,24 +34,101 @@ Bundle::Bundle(const uintptr_t _base) : base(reinterpret_cast<void *>(_base)) {
 }
 
 /**
- * Validate the init bundle. We assume that the file we got is a valid tarball.
+ * Validates the init bundle: its header must be valid, and all tables and file data must be
+ * within the bundle.
  */
 bool Bundle::validate() {
-    return true;
-}
+    const auto base = reinterpret_cast<uintptr_t>(this->base);
+    const auto hdr = reinterpret_cast<const InitHeader *>(this->base);
 
-/**
- * Helper method to convert an octal string to a binary number.
- */
-static size_t Oct2Bin(const char *str, size_t size) {
-    size_t n = 0;
-    auto c = str;
-    while (size-- > 0) {
-        n *= 8;
-        n += *c - '0';
-        c++;
-    }
-    return n;
+    if(this->size < sizeof(InitHeader)) {
+        LOG("Bundle too small (%lu bytes)", this->size);
+        return false;
+    }
+
+    // check the header
+    if(hdr->magic != kInitMagic || hdr->type != kInitType || hdr->major != kInitVersionMajor ||
+            hdr->minor < kInitVersionMinor) {
+        LOG("Invalid bundle header (magic %08x type %08x version %u.%u)", hdr->magic, hdr->type,
+                hdr->major, hdr->minor);
+        return false;
+    }
+    if(hdr->totalLen > this->size || hdr->headerLen > hdr->totalLen) {
+        LOG("Invalid bundle length (%u, header %u; region %lu)", hdr->totalLen, hdr->headerLen,
+                this->size);
+        return false;
+    }
+    if(!hdr->numBuckets || (hdr->numBuckets & (hdr->numBuckets - 1))) {
+        LOG("Invalid bundle bucket count: %u", hdr->numBuckets);
+        return false;
+    }
+    if(!hdr->chunkSize) {
+        LOG("Invalid bundle chunk size: %u", hdr->chunkSize);
+        return false;
+    }
+
+    // and the extents of the tables
+    auto inHeader = [hdr](const size_t off, const size_t bytes) {
+        return off <= hdr->headerLen && bytes <= (hdr->headerLen - off);
+    };
+
+    if(!inHeader(hdr->bucketsOff, (hdr->numBuckets + 1ULL) * sizeof(uint32_t)) ||
+            !inHeader(hdr->filesOff, hdr->numFiles * sizeof(InitFileHeader)) ||
+            !inHeader(hdr->namesOff, hdr->namesLen)) {
+        LOG("Bundle directory out of bounds");
+        return false;
+    }
+
+    auto buckets = reinterpret_cast<const uint32_t *>(base + hdr->bucketsOff);
+    auto files = reinterpret_cast<const InitFileHeader *>(base + hdr->filesOff);
+
+    for(size_t i = 0; i < hdr->numBuckets; i++) {
+        if(buckets[i] > buckets[i + 1]) {
+            LOG("Invalid bundle bucket %lu", i);
+            return false;
+        }
+    }
+    if(buckets[0] || buckets[hdr->numBuckets] != hdr->numFiles) {
+        LOG("Invalid bundle bucket table");
+        return false;
+    }
+
+    // then, validate each of the files
+    for(size_t i = 0; i < hdr->numFiles; i++) {
+        const auto &f = files[i];
+
+        if(f.nameOff > hdr->namesLen || f.nameLen > (hdr->namesLen - f.nameOff) ||
+                f.dataOff > hdr->totalLen || f.dataLen > (hdr->totalLen - f.dataOff) ||
+                (!(f.flags & kInitFileFlagsCompressed) && f.dataLen != f.rawLen)) {
+            LOG("Invalid bundle file %lu", i);
+            return false;
+        }
+
+        // compressed files must have a valid chunk table
+        if(!(f.flags & kInitFileFlagsCompressed)) continue;
+
+        const size_t numChunks = (f.rawLen + hdr->chunkSize - 1) / hdr->chunkSize;
+        if(numChunks * sizeof(InitChunkHeader) > f.dataLen) {
+            LOG("Invalid bundle file %lu", i);
+            return false;
+        }
+
+        auto chunks = reinterpret_cast<const InitChunkHeader *>(base + f.dataOff);
+        for(size_t j = 0; j < numChunks; j++) {
+            const auto &c = chunks[j];
+            if(c.offset > f.dataLen || c.length > (f.dataLen - c.offset)) {
+                LOG("Invalid bundle file %lu chunk %lu", i, j);
+                return false;
+            }
+        }
+    }
+
+    this->header = hdr;
+    this->buckets = buckets;
+    this->files = files;
+    this->names = reinterpret_cast<const char *>(base + hdr->namesOff);
+
+    return true;
 }
 
 /**
@@ -81,28 +160,24 @@ std::shared_ptr<Bundle::File> Bundle::open(const std::string &_name) {
         }
     }
 
-    // iterate over all file entries
-    auto read = reinterpret_cast<uint8_t *>(this->base);
-    const auto bundleEnd = reinterpret_cast<uintptr_t>(read) + this->size;
+    // search the file's hash bucket
+    const auto hash = InitBundleHashName(name.data(), name.length());
+    const auto bucket = hash & (this->header->numBuckets - 1);
 
-    // iterate until we find the right header
-    while((reinterpret_cast<uintptr_t>(read) + 512) < bundleEnd &&
-            !memcmp(read + 257, TMAGIC, 5)) {
-        // get the size of this header and entry
-        auto hdr = reinterpret_cast<struct posix_header *>(read);
-        const auto size = Oct2Bin(hdr->size, 11);
+    for(auto i = this->buckets[bucket]; i < this->buckets[bucket + 1]; i++) {
+        const auto hdr = &this->files[i];
 
         // compare filename
-        if(!strncmp(hdr->name, name.c_str(), name.length())) {
-            auto file = std::make_shared<File>(this->base, hdr);
-            // store it in our cache
-            this->fileCache[name] = file;
-            // done
-            return file;
+        if(hdr->hash != hash || hdr->nameLen != name.length() ||
+                memcmp(this->names + hdr->nameOff, name.data(), hdr->nameLen)) {
+            continue;
         }
 
-        // advance to next entry
-        read += (((size + 511) / 512) + 1) * 512;
+        auto file = std::make_shared<File>(this->base, hdr, name, this->header->chunkSize);
+        // store it in our cache
+        this->fileCache[name] = file;
+        // done
+        return file;
     }
 
     // if we get here, the file was not found
@@ -113,13 +188,124 @@ std::shared_ptr<Bundle::File> Bundle::open(const std::string &_name) {
 
 /**
  * Given a file header and base pointer, creates a file object to represent it.
+ *
+ * Uncompressed files are referenced in place; compressed files get a buffer (owned by the file
+ * object) into which chunks are decompressed as they're needed.
  */
-Bundle::File::File(void *base, const struct posix_header *hdr) {
-    // copy the file name
-    this->name = std::string(hdr->name, strlen(hdr->name));
+Bundle::File::File(void *base, const struct InitFileHeader *hdr, const std::string &_name,
+        const size_t _chunkSize) : name(_name) {
+    auto data = reinterpret_cast<std::byte *>(reinterpret_cast<uintptr_t>(base) + hdr->dataOff);
 
     // construct span for the contents directly if not compressed
-    const auto size = Oct2Bin(hdr->size, 11);
-    auto data = reinterpret_cast<std::byte *>(((uintptr_t) hdr) + 512);
-    this->contents = std::span(data, size);
+    if(!(hdr->flags & kInitFileFlagsCompressed)) {
+        this->contents = std::span(data, hdr->rawLen);
+        return;
+    }
+
+    // otherwise, set up for decompressing chunks (validated with the bundle)
+    this->data = data;
+    this->dataLen = hdr->dataLen;
+    this->chunks = reinterpret_cast<const InitChunkHeader *>(data);
+    this->chunkSize = _chunkSize;
+    this->numChunks = (hdr->rawLen + _chunkSize - 1) / _chunkSize;
+
+    this->chunkState = std::make_unique<std::atomic<ChunkState>[]>(this->numChunks);
+    for(size_t i = 0; i < this->numChunks; i++) {
+        this->chunkState[i] = ChunkState::Compressed;
+    }
+    this->chunksPending = this->numChunks;
+
+    this->decompressed = new std::byte[hdr->rawLen];
+    this->contents = std::span(this->decompressed, hdr->rawLen);
+}
+
+/**
+ * Returns a range of the file, decompressing the chunks it covers if needed.
+ *
+ * @note The range must be inside the file.
+ */
+std::span<std::byte> Bundle::File::getRange(const size_t offset, const size_t length) {
+    if(this->chunks && length && this->chunksPending) {
+        const auto last = ((offset + length - 1) / this->chunkSize) + 1;
+        for(size_t i = offset / this->chunkSize; i < last; i++) {
+            this->decompressChunk(i);
+        }
+    }
+
+    return this->contents.subspan(offset, length);
+}
+
+/**
+ * Ensures all chunks of the file are decompressed. They're decompressed in parallel by a few
+ * worker threads along with the calling thread.
+ *
+ * This is only done when the entire file is needed at once, so the cost of creating the threads is
+ * amortized over all of its chunks. Reads of a range of the file (such as those made over RPC) go
+ * through getRange() instead, which decompresses on the calling thread only.
+ */
+void Bundle::File::decompressAll() {
+    if(!this->chunksPending) return;
+
+    std::atomic_size_t next{0};
+    auto worker = [&]() {
+        size_t i;
+        while((i = next.fetch_add(1)) < this->numChunks) {
+            this->decompressChunk(i);
+        }
+    };
+
+    // figure out how many chunks need work
+    size_t pending{0};
+    for(size_t i = 0; i < this->numChunks; i++) {
+        if(this->chunkState[i] != ChunkState::Ready) pending++;
+    }
+
+    std::vector<std::thread> workers;
+    const auto numWorkers = std::min(pending, kMaxDecompressThreads);
+
+    for(size_t i = 1; i < numWorkers; i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for(auto &t : workers) {
+        t.join();
+    }
+}
+
+/**
+ * Decompresses a single chunk, unless it already has been. If another thread is busy
+ * decompressing it, wait for it to finish.
+ */
+void Bundle::File::decompressChunk(const size_t i) {
+    auto &state = this->chunkState[i];
+
+    auto expected = ChunkState::Compressed;
+    if(!state.compare_exchange_strong(expected, ChunkState::Busy)) {
+        while(state.load(std::memory_order_acquire) != ChunkState::Ready) {
+            std::this_thread::yield();
+        }
+        return;
+    }
+
+    // decompress it (or copy, if it's stored as-is)
+    const auto &c = this->chunks[i];
+    const auto off = i * this->chunkSize;
+    const auto rawLen = std::min(this->chunkSize, this->contents.size() - off);
+
+    auto dst = this->decompressed + off;
+    auto src = this->data + c.offset;
+
+    if(c.length == rawLen) {
+        memcpy(dst, src, rawLen);
+    } else {
+        const auto len = lzfse_decode_buffer(reinterpret_cast<uint8_t *>(dst), rawLen,
+                reinterpret_cast<const uint8_t *>(src), c.length, nullptr);
+        REQUIRE(len == rawLen, "failed to decompress '%s' chunk %lu: got %lu bytes, expected %lu",
+                this->name.c_str(), i, len, rawLen);
+    }
+
+    state.store(ChunkState::Ready, std::memory_order_release);
+    this->chunksPending--;
 }
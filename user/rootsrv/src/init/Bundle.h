@@ -1,6 +1,7 @@
 #ifndef INIT_BUNDLE_H
 #define INIT_BUNDLE_H
 
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -10,12 +11,16 @@
 
 struct InitHeader;
 struct InitFileHeader;
-
-struct posix_header;
+struct InitChunkHeader;
 
 namespace init {
 /**
  * Provides access to an in-memory init bundle.
+ *
+ * Files are looked up through the bundle's hashed directory. Uncompressed files are used in place
+ * (their data is page aligned in the bundle.) Compressed files consist of independently compressed
+ * chunks, which are decompressed as the parts of the file they hold are first read; reading the
+ * entire file decompresses all remaining chunks in parallel.
  */
 class Bundle {
     public:
@@ -42,10 +47,20 @@ class Bundle {
                 const size_t getSize() const {
                     return this->contents.size_bytes();
                 }
-                /// Gets the file's contents.
-                const std::span<std::byte> &getContents() const {
+                /// Gets the file's contents; compressed files are decompressed entirely.
+                const std::span<std::byte> &getContents() {
+                    if(this->chunks) {
+                        this->decompressAll();
+                    }
                     return this->contents;
                 }
+                /// Gets a range of the file's contents, decompressing only the chunks it covers
+                /// on the calling thread.
+                std::span<std::byte> getRange(const size_t offset, const size_t length);
+                /// Whether the contents point directly into the bundle (rather than a copy)
+                const bool isMapped() const {
+                    return !this->decompressed;
+                }
 
                 ~File() {
                     if(this->decompressed) {
@@ -54,7 +69,20 @@ class Bundle {
                 }
 
                 // you should not call this; only public for std::shared_ptr
-                File(void *base, const struct posix_header *hdr);
+                File(void *base, const struct InitFileHeader *hdr, const std::string &name,
+                        const size_t chunkSize);
+
+            private:
+                /// Maximum number of threads used to decompress a file
+                constexpr static const size_t kMaxDecompressThreads{4};
+
+                /// Chunk states
+                enum ChunkState: uint8_t {
+                    Compressed, Busy, Ready,
+                };
+
+                void decompressAll();
+                void decompressChunk(const size_t chunk);
 
             private:
                 std::string name;
@@ -62,6 +90,19 @@ class Bundle {
 
                 /// if non-null, this is a byte buffer we need to deallocate when released
                 std::byte *decompressed = nullptr;
+
+                /// start of the file's data in the bundle (compressed files only)
+                const std::byte *data = nullptr;
+                /// number of bytes of data in the bundle
+                size_t dataLen = 0;
+                /// chunk table (compressed files only)
+                const InitChunkHeader *chunks = nullptr;
+                /// number of chunks, and bytes of the file per chunk
+                size_t numChunks = 0, chunkSize = 0;
+                /// state of each chunk
+                std::unique_ptr<std::atomic<ChunkState>[]> chunkState;
+                /// number of chunks that have yet to be decompressed
+                std::atomic_size_t chunksPending{0};
         };
 
     public:
@@ -76,6 +117,14 @@ class Bundle {
     private:
         /// base address of the init bundle
         void *base = nullptr;
+        /// bundle header; set once validated
+        const InitHeader *header = nullptr;
+        /// hash bucket table: index of the first directory entry in each bucket
+        const uint32_t *buckets = nullptr;
+        /// directory
+        const InitFileHeader *files = nullptr;
+        /// name table
+        const char *names = nullptr;
         /// handle to the VM region containing the init bundle
         uintptr_t baseHandle = 0;
         /// length of the VM region
@@ -239,25 +239,25 @@ void BundleFileRpcHandler::handleReadDirect(const struct MessageHeader *msg,
     auto data = std::span(packet->payload, msgLen - sizeof(RpcPacket));
     if(data.size() < sizeof(FileIoReadReq)) {
         // XXX: can we get the file handle?
-        return this->readFailed(0, EINVAL, packet);
+        return this->readFailed(0, 0, EINVAL, packet);
     }
 
     auto req = reinterpret_cast<const FileIoReadReq *>(data.data());
 
     if(req->length > kMaxBlockSize) {
-        return this->readFailed(req->file, EINVAL, packet);
+        return this->readFailed(req->file, req->tag, EINVAL, packet);
     }
 
     // get the file
     if(!this->openFiles.contains(req->file)) {
-        return this->readFailed(req->file, EBADF, packet);
+        return this->readFailed(req->file, req->tag, EBADF, packet);
     }
 
     const auto &file = this->openFiles.at(req->file);
 
     // cap the read and offset values
     if(req->offset >= file.file->getSize()) {
-        return this->readFailed(req->file, EINVAL, packet);
+        return this->readFailed(req->file, req->tag, EINVAL, packet);
     }
 
     auto offset = req->offset;
@@ -268,7 +268,7 @@ void BundleFileRpcHandler::handleReadDirect(const struct MessageHeader *msg,
 #if LOG_IO
     LOG("Read req %x: off %llu len %llu", req->file, offset, length);
 #endif
-    auto range = file.file->getContents().subspan(offset, length);
+    auto range = file.file->getRange(offset, length);
 
     // allocate the reply buffer and fill it out
     std::vector<uint8_t> replyBuf;
@@ -277,6 +277,7 @@ void BundleFileRpcHandler::handleReadDirect(const struct MessageHeader *msg,
 
     reply->status = 0;
     reply->file = req->file;
+    reply->tag = req->tag;
     reply->dataLen = range.size();
     memcpy(reply->data, range.data(), range.size());
 
@@ -284,14 +285,16 @@ void BundleFileRpcHandler::handleReadDirect(const struct MessageHeader *msg,
 }
 
 /**
- * Sends a "read failed" message.
+ * Sends a "read failed" message. The status is always sent as a negative error code.
  */
-void BundleFileRpcHandler::readFailed(const uintptr_t file, const int errno, const RpcPacket *packet) {
+void BundleFileRpcHandler::readFailed(const uintptr_t file, const uint32_t tag, const int errno,
+        const RpcPacket *packet) {
     FileIoReadReqReply reply;
     memset(&reply, 0, sizeof(reply));
 
-    reply.status = errno;
+    reply.status = (errno > 0) ? -errno : errno;
     reply.file = file;
+    reply.tag = tag;
 
     auto replyBuf = std::span<uint8_t>(reinterpret_cast<uint8_t *>(&reply), sizeof(reply));
     this->reply(packet, FileIoEpType::ReadFileDirectReply, replyBuf);
@@ -68,7 +68,7 @@ class BundleFileRpcHandler {
         void handleOpen(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
         void openFailed(const int, const rpc::RpcPacket *);
         void handleReadDirect(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
-        void readFailed(const uintptr_t, const int, const rpc::RpcPacket *);
+        void readFailed(const uintptr_t, const uint32_t, const int, const rpc::RpcPacket *);
 
         void handleClose(const struct MessageHeader *, const rpc::RpcPacket *, const size_t);
 
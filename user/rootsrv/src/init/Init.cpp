@@ -2,22 +2,93 @@
 #include "Bundle.h"
 #include "ScriptParser.h"
 
+#include "dispensary/Registry.h"
 #include "task/Task.h"
 
 #include "log.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <sys/syscalls.h>
 
 using namespace init;
 
+namespace {
+/**
+ * Tracks the launch of all servers of one stage of the init script.
+ *
+ * Each server is a node in a dependency graph: it has a count of outstanding dependencies
+ * (servers named in its AFTER lines that haven't started, and services named in its NEEDS lines
+ * that haven't been registered) and is launched, on its own thread, as soon as that count drops to
+ * zero. A server is considered started when its task was created and all services it PROVIDES are
+ * registered with the dispensary; at that point, all servers depending on it are released.
+ *
+ * Servers without any dependencies are thus all launched concurrently right away.
+ */
+class Launcher: public std::enable_shared_from_this<Launcher> {
+    public:
+        Launcher(const std::shared_ptr<Bundle> &_bundle,
+                std::vector<ScriptParser::ServerInfo> &&_servers);
+
+        void start();
+
+    private:
+        /// State of a single server
+        struct Node {
+            /// index of all servers that depend on this one
+            std::vector<size_t> dependents;
+            /// number of dependencies that have yet to be satisfied
+            size_t pending{0};
+            /// number of provided services that have yet to be registered
+            size_t unprovided{0};
+
+            /// timestamp at which the server's dependencies were satisfied
+            uint64_t launchedAt{0};
+            /// timestamp at which the server's task was created
+            uint64_t createdAt{0};
+        };
+
+    private:
+        void checkForCycles();
+
+        void satisfy(const size_t i);
+        void launch(const size_t i);
+        void provided(const size_t i);
+        void started(const size_t i);
+
+        /// Returns the current timestamp, relative to when the launcher was created.
+        inline uint64_t now() const {
+            return (__builtin_ia32_rdtsc() - this->epoch) / 1000;
+        }
+
+    private:
+        /// bundle to load servers from
+        std::shared_ptr<Bundle> bundle;
+        /// timestamp counter value when the launcher was created
+        uint64_t epoch;
+
+        /// protects the dependency counts of all nodes
+        std::mutex lock;
+        /// all servers to launch
+        std::vector<ScriptParser::ServerInfo> servers;
+        /// launch state of each server
+        std::vector<Node> nodes;
+};
+}
+
 static void InitServer(const std::shared_ptr<Bundle> &bundle, const std::string &name,
         const std::vector<std::string> &params);
 
 /**
- * Parses the init script to discover all servers, then initializes them in the specified order.
+ * Parses the init script to discover all servers, then initializes them. Servers are launched as
+ * soon as the dependencies declared in the script are satisfied, so this returns before all of
+ * them have been started.
  */
 void init::SetupServers(const std::shared_ptr<Bundle> &bundle, const bool haveRootFs) {
     // get the script file
@@ -28,17 +99,219 @@ void init::SetupServers(const std::shared_ptr<Bundle> &bundle, const bool haveRo
     init::ScriptParser script;
     script.parse(scriptFile);
 
-    script.visitServers([&](const auto &name, const auto &params) {
+    // then launch the servers
+    auto launcher = std::make_shared<Launcher>(bundle, script.getServers(haveRootFs));
+    launcher->start();
+}
+
+
+
+/**
+ * Builds the dependency graph for the given servers. Dependencies on servers that aren't part of
+ * this stage are ignored; they were either started already or never will be.
+ */
+Launcher::Launcher(const std::shared_ptr<Bundle> &_bundle,
+        std::vector<ScriptParser::ServerInfo> &&_servers) : bundle(_bundle),
+        epoch(__builtin_ia32_rdtsc()), servers(std::move(_servers)) {
+    this->nodes.resize(this->servers.size());
+
+    std::unordered_map<std::string, size_t> names;
+    for(size_t i = 0; i < this->servers.size(); i++) {
+        names.emplace(this->servers[i].name, i);
+    }
+
+    for(size_t i = 0; i < this->servers.size(); i++) {
+        const auto &server = this->servers[i];
+        auto &node = this->nodes[i];
+
+        for(const auto &name : server.after) {
+            if(!names.contains(name)) {
+                LOG("Ignoring unknown dependency '%s' of server '%s'", name.c_str(),
+                        server.name.c_str());
+                continue;
+            }
+
+            this->nodes[names.at(name)].dependents.push_back(i);
+            node.pending++;
+        }
+
+        node.pending += server.needs.size();
+        node.unprovided = server.provides.size();
+    }
+
+    this->checkForCycles();
+}
+
+/**
+ * Ensures the dependency graph has no cycles, which would prevent the servers in them from ever
+ * being launched. We simply perform a topological sort and panic if not all nodes were visited.
+ *
+ * Besides the explicit AFTER dependencies, a server that NEEDS a service depends on every server
+ * in this stage that PROVIDES it. Services that no server in this stage provides are registered
+ * by someone else (or never); they can't be part of a cycle, so they're ignored here.
+ */
+void Launcher::checkForCycles() {
+    const auto numNodes = this->nodes.size();
+    std::vector<std::vector<size_t>> dependents(numNodes);
+    std::vector<size_t> pending(numNodes), ready;
+
+    std::unordered_map<std::string, std::vector<size_t>> providers;
+    for(size_t i = 0; i < numNodes; i++) {
+        for(const auto &name : this->servers[i].provides) {
+            providers[name].push_back(i);
+        }
+    }
+
+    for(size_t i = 0; i < numNodes; i++) {
+        for(const auto dependent : this->nodes[i].dependents) {
+            dependents[i].push_back(dependent);
+            pending[dependent]++;
+        }
+
+        for(const auto &name : this->servers[i].needs) {
+            if(!providers.contains(name)) continue;
+
+            for(const auto provider : providers.at(name)) {
+                dependents[provider].push_back(i);
+                pending[i]++;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < numNodes; i++) {
+        if(!pending[i]) ready.push_back(i);
+    }
+
+    size_t visited = 0;
+    while(!ready.empty()) {
+        const auto i = ready.back();
+        ready.pop_back();
+        visited++;
+
+        for(const auto dependent : dependents[i]) {
+            if(!--pending[dependent]) ready.push_back(dependent);
+        }
+    }
+
+    if(visited != numNodes) {
+        for(size_t i = 0; i < numNodes; i++) {
+            if(pending[i]) LOG("Server '%s' is part of a dependency cycle",
+                    this->servers[i].name.c_str());
+        }
+        PANIC("Init script has circular server dependencies");
+    }
+}
+
+/**
+ * Starts launching servers. All servers without dependencies are launched immediately, while
+ * the others wait for the services they need to be registered.
+ */
+void Launcher::start() {
+    auto self = this->shared_from_this();
+
+    // servers with no dependencies at all are launched right away
+    std::vector<size_t> ready;
+    {
+        std::lock_guard<std::mutex> lg(this->lock);
+        for(size_t i = 0; i < this->nodes.size(); i++) {
+            if(!this->nodes[i].pending) ready.push_back(i);
+        }
+    }
+
+    for(const auto i : ready) {
+        this->launch(i);
+    }
+
+    // the rest wait for registration of the services they need
+    for(size_t i = 0; i < this->servers.size(); i++) {
+        for(const auto &name : this->servers[i].needs) {
+            dispensary::Registry::notify(name, [self, i](auto) {
+                self->satisfy(i);
+            });
+        }
+    }
+}
+
+/**
+ * Marks one of the dependencies of the given server as satisfied, and launches it if it was the
+ * last one outstanding.
+ */
+void Launcher::satisfy(const size_t i) {
+    {
+        std::lock_guard<std::mutex> lg(this->lock);
+        REQUIRE(this->nodes[i].pending, "dependency count underflow for '%s'",
+                this->servers[i].name.c_str());
+
+        if(--this->nodes[i].pending) return;
+    }
+
+    this->launch(i);
+}
+
+/**
+ * Launches the given server on a separate thread. Once the task has been created, it's considered
+ * started if it doesn't provide any services; otherwise, we wait for those to be registered.
+ */
+void Launcher::launch(const size_t i) {
+    auto self = this->shared_from_this();
+    this->nodes[i].launchedAt = this->now();
+
+    std::thread([self, i] {
+        const auto &server = self->servers[i];
+        ThreadSetName(0, "Server launcher");
+
         try {
-            InitServer(bundle, name, params);
+            InitServer(self->bundle, server.name, server.args);
         } catch(std::exception &e) {
-            PANIC("Failed to initialize server %s: %s", name.c_str(), e.what());
+            PANIC("Failed to initialize server %s: %s", server.name.c_str(), e.what());
         }
-        return true;
-    }, haveRootFs);
 
+        self->nodes[i].createdAt = self->now();
+
+        if(server.provides.empty()) {
+            self->started(i);
+        } else {
+            for(const auto &name : server.provides) {
+                dispensary::Registry::notify(name, [self, i](auto) {
+                    self->provided(i);
+                });
+            }
+        }
+    }).detach();
 }
 
+/**
+ * One of the services provided by the given server has been registered; once all of them are,
+ * the server has started.
+ */
+void Launcher::provided(const size_t i) {
+    {
+        std::lock_guard<std::mutex> lg(this->lock);
+        if(--this->nodes[i].unprovided) return;
+    }
+
+    this->started(i);
+}
+
+/**
+ * The given server has started; log how long it took, then release all servers that depend on it.
+ *
+ * Times are in thousands of timestamp counter ticks since the launcher was created; there is no
+ * wall clock available this early.
+ */
+void Launcher::started(const size_t i) {
+    const auto &node = this->nodes[i];
+    const auto time = this->now();
+
+    LOG("Server '%s': launched at %llu, created task at %llu, started at %llu (kcycles)",
+            this->servers[i].name.c_str(), node.launchedAt, node.createdAt, time);
+
+    for(const auto dependent : node.dependents) {
+        this->satisfy(dependent);
+    }
+}
+
+
 
 /**
  * Initializes a server. This loads the binary from the init bundle, either from /sbin (if the
@@ -62,4 +335,3 @@ static void InitServer(const std::shared_ptr<Bundle> &bundle, const std::string
     REQUIRE(taskHandle, "Failed to create task for server '%s' (from %s)", name.c_str(),
             path.c_str());
 }
-
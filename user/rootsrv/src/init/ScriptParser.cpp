@@ -66,6 +66,12 @@ void ScriptParser::parse(std::shared_ptr<Bundle::File> file) {
             auto args = std::string_view(line.data() + 8, line.length() - 8);
             this->processServer(args, true);
         }
+        // dependency info for the preceding server
+        else if(keyword == "after" || keyword == "needs" || keyword == "provides") {
+            auto args = std::string_view(line.data() + keyword.length(),
+                    line.length() - keyword.length());
+            this->processDependency(keyword, args);
+        }
         // ignore file directives
         else if(!keyword.find("file")) {
             // nothing
@@ -78,21 +84,19 @@ void ScriptParser::parse(std::shared_ptr<Bundle::File> file) {
 }
 
 /**
- * Invokes the given function for each server we've read from the script.
+ * Returns all servers read from the script that are to be launched at the given stage.
  *
- * @param f A function to invoke for each server. Return true to continue iterating, or false to
- * terminate the iteration.
- * @param haveRootFs Whether servers that require the root fs or not are visited
+ * @param haveRootFs Whether servers that require the root fs or not are returned
  */
-void ScriptParser::visitServers(std::function<bool(const std::string &,
-            const std::vector<std::string> &)> const &f, const bool haveRootFs) {
+std::vector<ScriptParser::ServerInfo> ScriptParser::getServers(const bool haveRootFs) const {
+    std::vector<ServerInfo> out;
+
     for(const auto &server : this->servers) {
         if(server.needsRootFs != haveRootFs) continue;
-
-        if(!f(server.name, server.args)) {
-            return;
-        }
+        out.push_back(server);
     }
+
+    return out;
 }
 
 
@@ -132,3 +136,27 @@ void ScriptParser::processServer(const std::string_view &line, const bool postRo
     this->servers.push_back(info);
 }
 
+/**
+ * Processes a dependency line, which applies to the server defined by the most recent server
+ * line. Each space-separated token is a dependency:
+ *
+ * - AFTER: Names of servers that must have started before this one is launched.
+ * - NEEDS: Names of services that must be registered with the dispensary before launching.
+ * - PROVIDES: Names of services the server registers. Servers that depend on it are launched
+ *   only once all of them have been registered.
+ */
+void ScriptParser::processDependency(const std::string &keyword, const std::string_view &line) {
+    if(this->servers.empty()) {
+        LOG("Ignoring '%s' without a preceding server", keyword.c_str());
+        return;
+    }
+
+    auto &server = this->servers.back();
+
+    std::vector<std::string> names;
+    SplitStringArgs(line, names);
+
+    auto &list = (keyword == "after") ? server.after :
+        ((keyword == "needs") ? server.needs : server.provides);
+    list.insert(list.end(), names.begin(), names.end());
+}
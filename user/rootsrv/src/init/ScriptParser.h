@@ -13,23 +13,10 @@ namespace init {
  * Parses a boot-up initialization script and extracts from it the information required to continue
  * setting up the system.
  *
- * For now, this just extracts the list of servers to load.
+ * For now, this just extracts the list of servers to load, and their dependencies.
  */
 class ScriptParser {
     public:
-        /// Parses an init script.
-        void parse(std::shared_ptr<Bundle::File> file);
-
-        /// Visits all servers
-        void visitServers(std::function<bool(const std::string &,
-                    const std::vector<std::string> &)> const &f, const bool haveRootFs);
-
-        /// Clears all internal state.
-        void reset() {
-            this->servers.clear();
-        }
-
-    private:
         /// info on a server to launch
         struct ServerInfo {
             /// whether the server should wait to be started until the root fs is mounted
@@ -38,10 +25,30 @@ class ScriptParser {
             std::string name;
             /// any arguments
             std::vector<std::string> args;
+
+            /// servers (by name) that must have started before this one is launched
+            std::vector<std::string> after;
+            /// services that must be registered with the dispensary before launching
+            std::vector<std::string> needs;
+            /// services this server registers; it's started once all of them are registered
+            std::vector<std::string> provides;
         };
 
+    public:
+        /// Parses an init script.
+        void parse(std::shared_ptr<Bundle::File> file);
+
+        /// Returns all servers to launch, either before or after the root fs is mounted
+        std::vector<ServerInfo> getServers(const bool haveRootFs) const;
+
+        /// Clears all internal state.
+        void reset() {
+            this->servers.clear();
+        }
+
     private:
         void processServer(const std::string_view &line, const bool postRootMount);
+        void processDependency(const std::string &keyword, const std::string_view &line);
 
     private:
         /// servers to be launched
@@ -9,6 +9,7 @@
 #include "task/Registry.h"
 #include "task/RpcHandler.h"
 #include "task/InfoPage.h"
+#include "task/loader/ImageCache.h"
 #include "dispensary/Dispensary.h"
 
 #include "log.h"
@@ -54,6 +55,7 @@ int main(int argc, const char **argv) {
     EnvInit();
 
     task::InfoPage::init();
+    task::loader::ImageCache::init();
 
     dispensary::init();
     ThreadUsleep(10000);
@@ -0,0 +1,56 @@
+#include "DyldoPipe.h"
+
+#include "dispensary/Registry.h"
+
+#include <cstring>
+#include <vector>
+
+#include <rpc/RpcPacket.hpp>
+#include <sys/syscalls.h>
+
+#include "log.h"
+
+using namespace task;
+
+/**
+ * Sends the dynamic link server a notification that the given task was launched from the given
+ * executable. This must be sent before the task starts executing, so that it's received before
+ * any requests the task makes.
+ *
+ * If the dynamic link server hasn't registered its port yet (such as while early boot servers are
+ * launched) the notification is dropped; such tasks simply can't store launch closures.
+ */
+void DyldoPipe::taskLaunched(const uintptr_t taskHandle, const std::string &path) {
+    int err;
+
+    std::lock_guard<std::mutex> lg(this->lock);
+    if(!this->port && !this->resolvePort()) {
+        return;
+    }
+
+    // build the message: the task handle, followed by the zero terminated path
+    std::vector<std::byte> buf;
+    buf.resize(sizeof(rpc::RpcPacket) + sizeof(uintptr_t) + path.size() + 1, std::byte{0});
+
+    auto packet = reinterpret_cast<rpc::RpcPacket *>(buf.data());
+    packet->type = kTaskLaunchedType;
+
+    memcpy(packet->payload, &taskHandle, sizeof(taskHandle));
+    memcpy(packet->payload + sizeof(taskHandle), path.c_str(), path.size() + 1);
+
+    // send it; if it fails, the port is resolved again next time
+    err = PortSend(this->port, buf.data(), buf.size());
+    if(err) {
+        LOG("%s failed: %d", "PortSend", err);
+        this->port = 0;
+    }
+}
+
+/**
+ * Looks up the port of the dynamic link server.
+ *
+ * @return Whether the port was found
+ */
+bool DyldoPipe::resolvePort() {
+    return dispensary::Registry::lookup(std::string(kPortName), this->port);
+}
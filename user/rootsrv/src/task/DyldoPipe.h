@@ -0,0 +1,39 @@
+#ifndef TASK_DYLDOPIPE_H
+#define TASK_DYLDOPIPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace task {
+/**
+ * Sends notifications to the dynamic link server about dynamically linked tasks we launch.
+ *
+ * The dynamic link server only accepts a launch closure for an executable from a task that we
+ * told it was launched from that executable; these notifications are how it learns of them. Since
+ * they're sent by us, it can trust them, unlike anything the launched task itself claims.
+ */
+class DyldoPipe {
+    public:
+        /// Notifies the dynamic link server that a task was launched from the given executable.
+        void taskLaunched(const uintptr_t taskHandle, const std::string &path);
+
+    private:
+        bool resolvePort();
+
+    private:
+        /// Name of the dynamic link server's port
+        constexpr static const std::string_view kPortName{"me.blraaz.rpc.dyldosrv"};
+        /// Message type for the launch notification (DyldosrvMessageType::TaskLaunched)
+        constexpr static const uint32_t kTaskLaunchedType{'TKLN'};
+
+        /// protects the port handle
+        std::mutex lock;
+        /// port of the dynamic link server, once it's been resolved
+        uintptr_t port{0};
+};
+}
+
+#endif
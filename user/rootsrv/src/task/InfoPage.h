@@ -8,6 +8,7 @@
 struct __system_info;
 
 namespace dispensary {
+class Registry;
 class RpcHandler;
 }
 
@@ -22,6 +23,7 @@ class Task;
  */
 class InfoPage {
     friend class Task;
+    friend class dispensary::Registry;
     friend class dispensary::RpcHandler;
 
     public:
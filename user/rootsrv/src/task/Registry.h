@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "Task.h"
@@ -12,6 +13,9 @@
 namespace task {
 /**
  * Holds references to all of our task structs, indexed by the task handle.
+ *
+ * Tasks may be created from multiple threads at once (servers are launched concurrently) so all
+ * accesses are serialized.
  */
 class Registry {
     public:
@@ -23,6 +27,8 @@ class Registry {
         /// Adds a new task to the registry
         static void registerTask(std::shared_ptr<Task> &task) {
             const auto handle = task->getHandle();
+            std::lock_guard<std::mutex> lg(gShared->lock);
+
             REQUIRE(!gShared->tasks.contains(handle), "attempt to add duplicate task $%08x'h",
                     handle);
 
@@ -31,10 +37,12 @@ class Registry {
 
         /// Tests whether we have a task object for the given handle.
         static bool containsTask(const uintptr_t handle) {
+            std::lock_guard<std::mutex> lg(gShared->lock);
             return gShared->tasks.contains(handle);
         }
         /// Returns a reference to the task.
         static auto getTask(const uintptr_t handle) {
+            std::lock_guard<std::mutex> lg(gShared->lock);
             return gShared->tasks.at(handle);
         }
 
@@ -42,6 +50,7 @@ class Registry {
         static Registry *gShared;
 
     private:
+        std::mutex lock;
         std::unordered_map<uintptr_t, std::shared_ptr<Task>> tasks;
 };
 }
@@ -1,6 +1,7 @@
 #include "RpcHandler.h"
 #include "Task.h"
 #include "TaskEndpoint.h"
+#include "LaunchInfo.h"
 
 #include <sys/syscalls.h>
 #include <mpack/mpack.h>
@@ -123,6 +124,14 @@ void RpcHandler::handleCreate(const struct MessageHeader *msg, const RpcPacket *
         }
     }
 
+    uintptr_t launchFlags{0};
+    if(mpack_node_map_contains_cstr(root, "flags")) {
+        const auto flags = mpack_node_u32(mpack_node_map_cstr(root, "flags"));
+        if(flags & TaskEndpointCreateFlags::BindNow) {
+            launchFlags |= TASK_LAUNCHINFO_FLAG_BIND_NOW;
+        }
+    }
+
     // clean up the decoder and bail if error
     const auto readerStatus = mpack_tree_destroy(&tree);
     if(readerStatus != mpack_ok) {
@@ -141,7 +150,7 @@ void RpcHandler::handleCreate(const struct MessageHeader *msg, const RpcPacket *
 
     // ...create the task...
     try {
-        auto taskHandle = Task::createFromFile(path, params);
+        auto taskHandle = Task::createFromFile(path, params, 0, launchFlags);
 
         mpack_write_cstr(&writer, "status");
         mpack_write_i32(&writer, 1);
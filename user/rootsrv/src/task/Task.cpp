@@ -1,6 +1,7 @@
 #include "Task.h"
 #include "Registry.h"
 #include "InfoPage.h"
+#include "DyldoPipe.h"
 
 #include "LaunchInfo.h"
 #include "loader/Loader.h"
@@ -32,12 +33,14 @@ const uintptr_t Task::kTempMappingRange[2] = {
 /**
  * Creates a new task, loading the specified file from disk.
  *
+ * @param launchFlags Flags to place in the task's launch info structure
+ *
  * @return Kernel handle to the task. This can be used with the registry to look up the task
  * object.
  * @throws An exception is thrown if the task could not be loaded.
  */
 uintptr_t Task::createFromFile(const std::string &elfPath, const std::vector<std::string> &args,
-        const uintptr_t parent) {
+        const uintptr_t parent, const uintptr_t launchFlags) {
     // int err;
     uintptr_t entry = 0;
 
@@ -66,9 +69,17 @@ uintptr_t Task::createFromFile(const std::string &elfPath, const std::vector<std
     }
 
     // build the task info structure and push it on the stack
-    const auto infoBase = task->buildInfoStruct(args);
+    const auto infoBase = task->buildInfoStruct(args, launchFlags);
     loader->setUpStack(task, infoBase);
 
+    // let the dynamic link server know which executable the task was launched from
+    if(loader->needsDyld()) {
+        std::call_once(gDyldoPipeFlag, []() {
+            gDyldoPipe = new DyldoPipe;
+        });
+        gDyldoPipe->taskLaunched(task->getHandle(), elfPath);
+    }
+
     // set up its main thread to jump to the entry point
     Registry::registerTask(task);
 
@@ -153,11 +164,11 @@ std::shared_ptr<loader::Loader> Task::getLoaderFor(const std::string &path, FILE
     // use the class value to pick a reader (32 vs 64 bits)
     switch(hdr.e_ident[EI_CLASS]) {
         case ELFCLASS32:
-            return std::dynamic_pointer_cast<loader::Loader>(std::make_shared<Elf32>(fp));
+            return std::dynamic_pointer_cast<loader::Loader>(std::make_shared<Elf32>(fp, path));
             break;
 
         case ELFCLASS64:
-            return std::dynamic_pointer_cast<loader::Loader>(std::make_shared<Elf64>(fp));
+            return std::dynamic_pointer_cast<loader::Loader>(std::make_shared<Elf64>(fp, path));
             break;
 
         default:
@@ -214,7 +225,7 @@ void Task::loadDyld(const std::string &dyldPath, uintptr_t &pcOut) {
 /**
  * Allocates a task information structure.
  */
-uintptr_t Task::buildInfoStruct(const std::vector<std::string> &args) {
+uintptr_t Task::buildInfoStruct(const std::vector<std::string> &args, const uintptr_t flags) {
     int err;
     uintptr_t vmHandle, base;
     std::vector<char> buf;
@@ -226,6 +237,12 @@ uintptr_t Task::buildInfoStruct(const std::vector<std::string> &args) {
     memset(&info, 0, sizeof(kush_task_launchinfo_t));
 
     info.magic = TASK_LAUNCHINFO_MAGIC;
+    info.flags = flags;
+
+    err = TaskGetHandle(&info.loaderTask);
+    if(err) {
+        throw std::system_error(err, std::generic_category(), "TaskGetHandle");
+    }
 
     // allocate the task path
     info.loadPath = reinterpret_cast<const char *>(kStrStart + buf.size());
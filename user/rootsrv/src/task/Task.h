@@ -45,14 +45,15 @@ class Task: public std::enable_shared_from_this<Task> {
     public:
         /// Creates a new task from a file
         static uintptr_t createFromFile(const std::string &elfPath,
-                const std::vector<std::string> &args, const uintptr_t parent = 0);
+                const std::vector<std::string> &args, const uintptr_t parent = 0,
+                const uintptr_t launchFlags = 0);
 
     private:
         /// Instantiates a binary loader for the given file
         std::shared_ptr<loader::Loader> getLoaderFor(const std::string &, FILE *);
 
         /// Builds the launch info structure for this task.
-        uintptr_t buildInfoStruct(const std::vector<std::string> &args);
+        uintptr_t buildInfoStruct(const std::vector<std::string> &args, const uintptr_t flags);
 
         /// Loads the specified dynamic linker.
         void loadDyld(const std::string &dyldPath, uintptr_t &pcOut);
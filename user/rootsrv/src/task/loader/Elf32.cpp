@@ -20,7 +20,7 @@ using namespace task::loader;
  *
  * @throws An exception is thrown if the ELF header is invalid.
  */
-Elf32::Elf32(FILE *file) : ElfCommon(file) {
+Elf32::Elf32(FILE *file, const std::string &path) : ElfCommon(file, path) {
     // get the header
     Elf32_Ehdr hdr;
     memset(&hdr, 0, sizeof hdr);
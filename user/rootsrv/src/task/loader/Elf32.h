@@ -19,7 +19,7 @@ class Elf32: public ElfCommon {
         constexpr static const uintptr_t kDefaultStackSz = 0x20000;
 
     public:
-        Elf32(FILE *file);
+        Elf32(FILE *file, const std::string &path);
 
         void mapInto(const std::shared_ptr<Task> &task) override;
 
@@ -8,6 +8,7 @@
 #include <log.h>
 
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <system_error>
 
@@ -20,7 +21,7 @@ using namespace task::loader;
  *
  * @throws An exception is thrown if the ELF header is invalid.
  */
-Elf64::Elf64(FILE *file) : ElfCommon(file) {
+Elf64::Elf64(FILE *file, const std::string &path) : ElfCommon(file, path) {
     // get the header
     Elf64_Ehdr hdr;
     memset(&hdr, 0, sizeof hdr);
@@ -71,12 +72,17 @@ Elf64::Elf64(FILE *file) : ElfCommon(file) {
     this->phdrOff = hdr.e_phoff;
     this->phdrSize = hdr.e_phentsize;
     this->numPhdr = hdr.e_phnum;
+
+    this->headerHash = ImageCache::Hash(&hdr, sizeof hdr);
 }
 
 
 
 /**
  * Maps all sections defined by the program headers into the task.
+ *
+ * The loadable segments are taken from the image cache if this file has been loaded before;
+ * otherwise, they're loaded and the resulting image is added to the cache.
  */
 void Elf64::mapInto(const std::shared_ptr<Task> &task) {
     // read program headers 
@@ -85,6 +91,17 @@ void Elf64::mapInto(const std::shared_ptr<Task> &task) {
 
     this->read((this->numPhdr * sizeof(Elf64_Phdr)), phdrs.data(), this->phdrOff);
 
+    // map the loadable segments
+    const auto identity = this->getIdentity(phdrs);
+
+    auto image = ImageCache::lookup(this->path, identity);
+    if(!image) {
+        image = this->loadImage(phdrs, identity);
+        ImageCache::add(image);
+    }
+
+    image->mapInto(task);
+
     // process each program header
     for(const auto &phdr : phdrs) {
         this->processProgHdr(task, phdr);
@@ -92,126 +109,284 @@ void Elf64::mapInto(const std::shared_ptr<Task> &task) {
 }
 
 /**
- * Processes a loaded program header.
+ * Determines the identity of the file for the image cache. This consists of the file size, and a
+ * hash over the ELF header, program headers, and the build ID.
+ *
+ * Binaries are linked with a build ID, which changes whenever their contents do. For binaries that
+ * don't have one, the file data of all loadable segments is hashed instead: a rebuilt binary need
+ * not differ in any of its headers.
  */
-void Elf64::processProgHdr(const std::shared_ptr<Task> &task, const Elf64_Phdr &phdr) {
-    switch(phdr.p_type) {
-        // load from file
-        case PT_LOAD:
-            this->phdrLoad(task, phdr);
-            break;
+ImageCache::Identity Elf64::getIdentity(const std::vector<Elf64_Phdr> &phdrs) {
+    ImageCache::Identity identity;
 
-        // define stack parameters
-        case PT_GNU_STACK:
-            this->phdrGnuStack(task, phdr);
-            break;
+    // get the file size
+    if(fseek(this->file, 0, SEEK_END)) {
+        throw std::system_error(errno, std::generic_category(), "Seek failed");
+    }
 
-        // dynamic link interpreter
-        case PT_INTERP:
-            this->phdrInterp(task, phdr);
-            break;
+    const auto size = ftell(this->file);
+    if(size < 0) {
+        throw std::system_error(errno, std::generic_category(), "ftell");
+    }
+    identity.fileSize = size;
 
-        // dynamic and TLS info is handled by dynamic linker
-        case PT_DYNAMIC:
-        case PT_TLS:
-            break;
+    // hash headers and the build ID
+    identity.hash = ImageCache::Hash(phdrs.data(), phdrs.size() * sizeof(Elf64_Phdr),
+            this->headerHash);
 
-        // points back to location of program headers in executable image
-        case PT_PHDR:
-            break;
+    bool hasBuildId{false};
+    std::vector<std::byte> buf;
 
-        // unhandled program header type
-        default:
-            LOG("Unhandled phdr type %lu offset %p vaddr $%p filesz %lu memsz %lu"
-                " flags $%08x align %lu", phdr.p_type, phdr.p_offset, phdr.p_vaddr, phdr.p_filesz,
-                phdr.p_memsz, phdr.p_flags, phdr.p_align);
+    for(const auto &phdr : phdrs) {
+        if(phdr.p_type != PT_NOTE || !phdr.p_filesz || phdr.p_filesz > kMaxNoteSize) continue;
+
+        buf.resize(phdr.p_filesz);
+        this->read(phdr.p_filesz, buf.data(), phdr.p_offset);
+
+        const auto buildId = FindBuildId(buf);
+        if(!buildId.empty()) {
+            identity.hash = ImageCache::Hash(buildId.data(), buildId.size(), identity.hash);
+            hasBuildId = true;
+        }
+    }
+
+    if(hasBuildId) {
+        return identity;
+    }
+
+    // otherwise, hash the contents of the file
+    buf.resize(kContentHashChunkSize);
+
+    for(const auto &phdr : phdrs) {
+        if(phdr.p_type != PT_LOAD) continue;
+
+        for(uint64_t off = 0; off < phdr.p_filesz; off += buf.size()) {
+            const size_t len = std::min<uint64_t>(buf.size(), phdr.p_filesz - off);
+            this->read(len, buf.data(), phdr.p_offset + off);
+            identity.hash = ImageCache::Hash(buf.data(), len, identity.hash);
+        }
+    }
+
+    return identity;
+}
+
+/**
+ * Searches the contents of a note segment for a GNU build ID note.
+ *
+ * @return Descriptor of the build ID note (the ID itself) or an empty span, if there's none
+ */
+std::span<const std::byte> Elf64::FindBuildId(const std::span<const std::byte> notes) {
+    constexpr static const char kGnuName[]{"GNU"};
+    auto align = [](const size_t len) {
+        return (len + 3) & ~static_cast<size_t>(3);
+    };
+
+    size_t off{0};
+    while(notes.size() - off >= sizeof(Elf64_Nhdr)) {
+        Elf64_Nhdr hdr;
+        memcpy(&hdr, notes.data() + off, sizeof hdr);
+        off += sizeof hdr;
+
+        // name and descriptor are each padded to a 4 byte boundary
+        const auto nameLen = align(hdr.n_namesz), descLen = align(hdr.n_descsz);
+        if(nameLen > notes.size() - off || descLen > notes.size() - off - nameLen) {
             break;
+        }
+
+        if(hdr.n_type == NT_GNU_BUILD_ID && hdr.n_namesz == sizeof(kGnuName) &&
+                !memcmp(notes.data() + off, kGnuName, sizeof(kGnuName)) && hdr.n_descsz) {
+            return notes.subspan(off + nameLen, hdr.n_descsz);
+        }
+
+        off += nameLen + descLen;
     }
+
+    return {};
+}
+
+/**
+ * Loads all loadable segments from the file into a new image.
+ *
+ * Read-only segments can be shared between all tasks, unless the binary has text relocations: the
+ * dynamic linker would then modify the shared copy.
+ */
+std::shared_ptr<const ImageCache::Image> Elf64::loadImage(const std::vector<Elf64_Phdr> &phdrs,
+        const ImageCache::Identity &identity) {
+    auto image = std::make_shared<ImageCache::Image>(this->path, identity);
+    const bool canShare = !this->hasTextRelocations(phdrs);
+
+    for(const auto &phdr : phdrs) {
+        if(phdr.p_type != PT_LOAD) continue;
+        image->segments.push_back(this->loadSegment(phdr, canShare));
+    }
+
+    return image;
 }
 
 /**
  * Loads a segment from the file.
  *
- * This will allocate an anonymous memory region, and copy from the file buffer. It will be mapped
- * in virtual address space at the location specified.
+ * This will allocate an anonymous memory region, and copy from the file buffer. Read-only segments
+ * are mapped directly into tasks at the location specified. For writable segments, the region is
+ * the pristine copy of the segment's file data; it stays mapped in our address space, to be copied
+ * into each task.
  */
-void Elf64::phdrLoad(const std::shared_ptr<Task> &task, const Elf64_Phdr &hdr) {
+ImageCache::Segment Elf64::loadSegment(const Elf64_Phdr &hdr, const bool canShare) {
     int err;
-    uintptr_t vmHandle, taskHandle, regionBase;
-    void *vmBase;
+    uintptr_t regionBase;
+    ImageCache::Segment seg;
 
     // TODO: use sysconf
     const auto pageSz = 0x1000;
 
     // virtual address must be page aligned
     const uintptr_t inPageOff = hdr.p_vaddr & (pageSz - 1);
-    const uintptr_t virtBase = hdr.p_vaddr & ~(pageSz - 1);
+    seg.virtBase = hdr.p_vaddr & ~(pageSz - 1);
 
     // round up to the nearest page and get the mapping flags
-    size_t allocSize = hdr.p_memsz + inPageOff;
-    if(allocSize & (pageSz - 1)) {
-        allocSize = ((allocSize + pageSz - 1) / pageSz) * pageSz;
+    seg.length = ((hdr.p_memsz + inPageOff + pageSz - 1) / pageSz) * pageSz;
+
+    if(hdr.p_flags & PF_R) {
+        seg.vmFlags |= VM_REGION_READ;
+    }
+    if(hdr.p_flags & PF_W) {
+        seg.vmFlags |= VM_REGION_WRITE;
+    }
+
+    if(hdr.p_flags & PF_X) {
+        if(seg.vmFlags & VM_REGION_WRITE) {
+            throw LoaderError("Refusing to add WX mapping");
+        }
+
+        seg.vmFlags |= VM_REGION_EXEC;
+    }
+
+    seg.shared = canShare && !(seg.vmFlags & VM_REGION_WRITE);
+
+    // allocate an anonymous region (RW for now); a pristine copy only needs to hold the file data
+    const size_t regionSize = seg.shared ? seg.length :
+        ((hdr.p_filesz + inPageOff + pageSz - 1) / pageSz) * pageSz;
+    if(!regionSize) {
+        return seg;
     }
 
-    // allocate an anonymous region (RW for now) and get its base address in our vm map
-    err = AllocVirtualAnonRegion(allocSize, VM_REGION_RW | VM_REGION_FORCE_ALLOC, &vmHandle);
+    err = AllocVirtualAnonRegion(regionSize, VM_REGION_RW, &seg.vmHandle);
     if(err) {
         throw std::system_error(err, std::generic_category(), "AllocVirtualAnonRegion");
     }
 
-    err = MapVirtualRegionRange(vmHandle, ElfCommon::kTempMappingRange, allocSize, 0, &regionBase);
-
+    err = MapVirtualRegionRange(seg.vmHandle, ElfCommon::kTempMappingRange, regionSize, 0,
+            &regionBase);
     if(err) {
+        DeallocVirtualRegion(seg.vmHandle);
         throw std::system_error(err, std::generic_category(), "MapVirtualRegionRange");
     }
 
-    // set up to write to it, and copy the corresponding file region into it
-    vmBase = reinterpret_cast<void *>(regionBase + inPageOff);
-
-    if(hdr.p_filesz) {
-        this->read(hdr.p_filesz, vmBase, hdr.p_offset);
+    // copy the corresponding file region into it
+    try {
+        if(hdr.p_filesz) {
+            this->read(hdr.p_filesz, reinterpret_cast<void *>(regionBase + inPageOff),
+                    hdr.p_offset);
+        }
+    } catch(std::exception &) {
+        DeallocVirtualRegion(seg.vmHandle);
+        throw;
     }
 
     /*
-     * Change the page's protection level.
+     * Change the region's protection level.
      *
      * If the dynamic linker needs to fix up a read-only region, it will remap it as read/write
      * temporarily. This ensures static binaries will never have their .text segments left writable
      * or need to rely on a particular startup code to be secure.
+     *
+     * Shared regions get their final protection, and are unmapped from our task; we remain the
+     * owner, which keeps them alive while no task has them mapped. The pristine copy of private
+     * segments is made read-only, as we only ever copy out of it.
      */
-    uintptr_t vmFlags = 0;
-    if(hdr.p_flags & PF_R) {
-        vmFlags |= VM_REGION_READ;
-    }
-    if(hdr.p_flags & PF_W) {
-        vmFlags |= VM_REGION_WRITE;
+    err = VirtualRegionSetFlags(seg.vmHandle, seg.shared ? seg.vmFlags : VM_REGION_READ);
+    if(err) {
+        DeallocVirtualRegion(seg.vmHandle);
+        throw std::system_error(err, std::generic_category(), "VirtualRegionSetFlags");
     }
 
-    if(hdr.p_flags & PF_X) {
-        if(vmFlags & VM_REGION_WRITE) {
-            UnmapVirtualRegion(vmHandle);
-            throw LoaderError("Refusing to add WX mapping");
+    if(seg.shared) {
+        err = UnmapVirtualRegion(seg.vmHandle);
+        if(err) {
+            DeallocVirtualRegion(seg.vmHandle);
+            throw std::system_error(err, std::generic_category(), "UnmapVirtualRegion");
         }
-
-        vmFlags |= VM_REGION_EXEC;
+    } else {
+        seg.pristineBase = regionBase;
+        seg.pristineLength = hdr.p_filesz + inPageOff;
     }
 
-    err = VirtualRegionSetFlags(vmHandle, vmFlags);
-    if(err) {
-        throw std::system_error(err, std::generic_category(), "VirtualRegionSetFlags");
-    }
+    return seg;
+}
 
-    // place the mapping into the task
-    taskHandle = task->getHandle();
-    err = MapVirtualRegionRemote(taskHandle, vmHandle, virtBase, allocSize, 0);
-    if(err) {
-        throw std::system_error(err, std::generic_category(), "MapVirtualRegionRemote");
+/**
+ * Checks the dynamic section of the binary (if any) for text relocations.
+ */
+bool Elf64::hasTextRelocations(const std::vector<Elf64_Phdr> &phdrs) {
+    for(const auto &phdr : phdrs) {
+        if(phdr.p_type != PT_DYNAMIC) continue;
+
+        std::vector<Elf64_Dyn> dyn;
+        dyn.resize(phdr.p_filesz / sizeof(Elf64_Dyn));
+        this->read(dyn.size() * sizeof(Elf64_Dyn), dyn.data(), phdr.p_offset);
+
+        for(const auto &entry : dyn) {
+            if(entry.d_tag == DT_NULL) {
+                break;
+            } else if(entry.d_tag == DT_TEXTREL) {
+                return true;
+            } else if(entry.d_tag == DT_FLAGS && (entry.d_un.d_val & DF_TEXTREL)) {
+                return true;
+            }
+        }
     }
 
-    // then unmap it from our task
-    err = UnmapVirtualRegion(vmHandle);
-    if(err) {
-        throw std::system_error(err, std::generic_category(), "UnmapVirtualRegion");
+    return false;
+}
+
+/**
+ * Processes a loaded program header. Loadable segments have already been mapped via the image.
+ */
+void Elf64::processProgHdr(const std::shared_ptr<Task> &task, const Elf64_Phdr &phdr) {
+    switch(phdr.p_type) {
+        // mapped from the image
+        case PT_LOAD:
+            break;
+
+        // define stack parameters
+        case PT_GNU_STACK:
+            this->phdrGnuStack(task, phdr);
+            break;
+
+        // dynamic link interpreter
+        case PT_INTERP:
+            this->phdrInterp(task, phdr);
+            break;
+
+        // dynamic and TLS info is handled by dynamic linker
+        case PT_DYNAMIC:
+        case PT_TLS:
+            break;
+
+        // points back to location of program headers in executable image
+        case PT_PHDR:
+            break;
+
+        // notes are only used to identify the file in the image cache
+        case PT_NOTE:
+            break;
+
+        // unhandled program header type
+        default:
+            LOG("Unhandled phdr type %lu offset %p vaddr $%p filesz %lu memsz %lu"
+                " flags $%08x align %lu", phdr.p_type, phdr.p_offset, phdr.p_vaddr, phdr.p_filesz,
+                phdr.p_memsz, phdr.p_flags, phdr.p_align);
+            break;
     }
 }
 
@@ -3,10 +3,13 @@
 
 #include "Loader.h"
 #include "ElfCommon.h"
+#include "ImageCache.h"
 
 #include <cstdio>
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include <sys/elf.h>
 
@@ -19,7 +22,7 @@ class Elf64: public ElfCommon {
         constexpr static const uintptr_t kDefaultStackSz = 0x40000;
 
     public:
-        Elf64(FILE *file);
+        Elf64(FILE *file, const std::string &path);
 
         void mapInto(const std::shared_ptr<Task> &task) override;
 
@@ -37,11 +40,26 @@ class Elf64: public ElfCommon {
         }
 
     private:
+        /// Maximum size of note segments to search for a build ID
+        constexpr static const size_t kMaxNoteSize{0x1000};
+        /// Size of the reads used to hash the contents of files that have no build ID
+        constexpr static const size_t kContentHashChunkSize{0x4000};
+
+        ImageCache::Identity getIdentity(const std::vector<Elf64_Phdr> &);
+        static std::span<const std::byte> FindBuildId(const std::span<const std::byte> notes);
+        std::shared_ptr<const ImageCache::Image> loadImage(const std::vector<Elf64_Phdr> &,
+                const ImageCache::Identity &);
+        ImageCache::Segment loadSegment(const Elf64_Phdr &, const bool canShare);
+        bool hasTextRelocations(const std::vector<Elf64_Phdr> &);
+
         void processProgHdr(const std::shared_ptr<Task> &, const Elf64_Phdr &);
 
-        void phdrLoad(const std::shared_ptr<Task> &, const Elf64_Phdr &);
         void phdrGnuStack(const std::shared_ptr<Task> &, const Elf64_Phdr &);
         void phdrInterp(const std::shared_ptr<Task> &, const Elf64_Phdr &);
+
+    private:
+        /// hash of the ELF header; the basis for the file's identity
+        uint64_t headerHash{0};
 };
 }
 #endif
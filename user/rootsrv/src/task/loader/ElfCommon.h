@@ -13,11 +13,13 @@ namespace task::loader {
  * and creating mappings regardless of whether the file is 32 or 64 bit.
  */
 class ElfCommon: public Loader {
+    friend class ImageCache;
+
     public:
         /**
          * Does some basic setup of the common ELF reader.
          */
-        ElfCommon(FILE *file) : Loader(file) {};
+        ElfCommon(FILE *file, const std::string &path) : Loader(file, path) {};
 
         /**
          * Gets the entry point of the binary, as read from the ELF header.
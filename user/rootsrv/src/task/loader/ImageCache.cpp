@@ -0,0 +1,156 @@
+#include "ImageCache.h"
+#include "ElfCommon.h"
+#include "../Task.h"
+
+#include <log.h>
+
+#include <sys/syscalls.h>
+
+#include <cstring>
+#include <system_error>
+
+using namespace task::loader;
+
+ImageCache *ImageCache::gShared = nullptr;
+
+/**
+ * Releases the VM regions of all segments. Tasks that have a shared segment mapped keep their
+ * mapping; the region is deallocated once the last of them is unmapped.
+ */
+ImageCache::Image::~Image() {
+    for(const auto &seg : this->segments) {
+        if(!seg.vmHandle) continue;
+
+        int err = DeallocVirtualRegion(seg.vmHandle);
+        if(err) {
+            LOG("Failed to deallocate image segment $%p'h (%s): %d", seg.vmHandle,
+                    this->path.c_str(), err);
+        }
+    }
+}
+
+/**
+ * Maps all segments of the image into the task. Shared segments are mapped directly, while a new
+ * region is allocated for each private segment and initialized from its pristine copy.
+ */
+void ImageCache::Image::mapInto(const std::shared_ptr<Task> &task) const {
+    int err;
+    uintptr_t vmHandle, base;
+
+    for(const auto &seg : this->segments) {
+        if(!seg.length) {
+            continue;
+        } else if(seg.shared) {
+            err = MapVirtualRegionRemote(task->getHandle(), seg.vmHandle, seg.virtBase,
+                    seg.length, 0);
+            if(err) {
+                throw std::system_error(err, std::generic_category(), "MapVirtualRegionRemote");
+            }
+            continue;
+        }
+
+        // allocate the task's copy; pages past the file data are faulted in as needed
+        err = AllocVirtualAnonRegion(seg.length, VM_REGION_RW, &vmHandle);
+        if(err) {
+            throw std::system_error(err, std::generic_category(), "AllocVirtualAnonRegion");
+        }
+
+        err = MapVirtualRegionRange(vmHandle, ElfCommon::kTempMappingRange, seg.length, 0, &base);
+        if(err) {
+            DeallocVirtualRegion(vmHandle);
+            throw std::system_error(err, std::generic_category(), "MapVirtualRegionRange");
+        }
+
+        if(seg.pristineLength) {
+            memcpy(reinterpret_cast<void *>(base),
+                    reinterpret_cast<const void *>(seg.pristineBase), seg.pristineLength);
+        }
+
+        // apply protection and place it in the task
+        err = VirtualRegionSetFlags(vmHandle, seg.vmFlags);
+        if(err) {
+            DeallocVirtualRegion(vmHandle);
+            throw std::system_error(err, std::generic_category(), "VirtualRegionSetFlags");
+        }
+
+        err = MapVirtualRegionRemote(task->getHandle(), vmHandle, seg.virtBase, seg.length, 0);
+        if(err) {
+            DeallocVirtualRegion(vmHandle);
+            throw std::system_error(err, std::generic_category(), "MapVirtualRegionRemote");
+        }
+
+        err = UnmapVirtualRegion(vmHandle);
+        if(err) {
+            throw std::system_error(err, std::generic_category(), "UnmapVirtualRegion");
+        }
+    }
+}
+
+
+
+/**
+ * Looks up the image for the given path. If the cached image was loaded from a different version
+ * of the file, it's evicted.
+ *
+ * @return Cached image, or `nullptr` if there's no (matching) image in the cache
+ */
+std::shared_ptr<const ImageCache::Image> ImageCache::lookupImage(const std::string &path,
+        const Identity &identity) {
+    std::lock_guard<std::mutex> lg(this->lock);
+
+    auto it = this->images.find(path);
+    if(it == this->images.end()) {
+        if(kLogCache) LOG("Image cache miss: %s", path.c_str());
+        return nullptr;
+    }
+
+    auto &entry = it->second;
+    if(entry.image->identity != identity) {
+        if(kLogCache) LOG("Image cache stale: %s", path.c_str());
+        this->images.erase(it);
+        return nullptr;
+    }
+
+    if(kLogCache) LOG("Image cache hit: %s", path.c_str());
+    entry.lastUsed = ++this->useCounter;
+    return entry.image;
+}
+
+/**
+ * Inserts an image into the cache, replacing any existing image for the same path. If the cache
+ * is full, the least recently used image is evicted.
+ *
+ * Evicted images are released once the last task being loaded from them has been mapped.
+ */
+void ImageCache::addImage(const std::shared_ptr<const Image> &image) {
+    std::lock_guard<std::mutex> lg(this->lock);
+
+    if(!this->images.contains(image->path) && this->images.size() >= kMaxImages) {
+        auto oldest = this->images.begin();
+        for(auto it = this->images.begin(); it != this->images.end(); ++it) {
+            if(it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+
+        if(kLogCache) LOG("Image cache evict: %s", oldest->first.c_str());
+        this->images.erase(oldest);
+    }
+
+    this->images[image->path] = Entry{image, ++this->useCounter};
+}
+
+/**
+ * Calculates the FNV-1a hash of the given buffer.
+ */
+uint64_t ImageCache::Hash(const void *data, const size_t length, const uint64_t hash) {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    uint64_t value = hash;
+
+    for(size_t i = 0; i < length; i++) {
+        value ^= bytes[i];
+        value *= kHashPrime;
+    }
+
+    return value;
+}
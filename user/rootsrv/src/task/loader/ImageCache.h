@@ -0,0 +1,145 @@
+#ifndef TASK_LOADER_IMAGECACHE_H
+#define TASK_LOADER_IMAGECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace task {
+class Task;
+}
+
+namespace task::loader {
+/**
+ * Caches the loadable segments of executables, so that launching the same binary repeatedly does
+ * not need to read it from its file (and allocate memory for its code) each time.
+ *
+ * Read-only segments are loaded once into a VM region that's mapped directly into every task
+ * created from the image. Writable segments are loaded once into a pristine copy, which is copied
+ * into a new region for each task; only the pages with file data are copied, so the remainder of
+ * the segment (its .bss) is faulted in on demand.
+ *
+ * Images are keyed by their path, and the identity of the file (see `Identity`) is checked on each
+ * lookup to detect files that have been replaced.
+ */
+class ImageCache {
+    public:
+        /// Maximum number of images to keep in the cache
+        constexpr static const size_t kMaxImages{48};
+
+        /**
+         * Identifies a particular version of an executable file. There's no way to get the
+         * modification time of files, so this relies on the build ID that binaries are linked
+         * with; for files without one, their contents are hashed.
+         */
+        struct Identity {
+            /// total size of the file, in bytes
+            size_t fileSize{0};
+            /// hash over the file's headers and its build ID (or loadable segments)
+            uint64_t hash{0};
+
+            bool operator==(const Identity &) const = default;
+        };
+
+        /**
+         * A loadable segment of a cached image.
+         */
+        struct Segment {
+            /// page aligned virtual address of the segment in tasks
+            uintptr_t virtBase{0};
+            /// length of the segment's mapping in tasks, in bytes
+            size_t length{0};
+            /// protection flags (VM_REGION_*) of the segment in tasks
+            uintptr_t vmFlags{0};
+
+            /// VM region holding either the shared segment, or its pristine copy
+            uintptr_t vmHandle{0};
+            /// when set, the region is mapped into every task; otherwise, it's copied
+            bool shared{false};
+
+            /// base address of the pristine copy in our address space (if not shared)
+            uintptr_t pristineBase{0};
+            /// number of bytes to copy from the pristine copy (if not shared)
+            size_t pristineLength{0};
+        };
+
+        /**
+         * All loadable segments of a particular executable file.
+         */
+        struct Image {
+            /// path of the executable
+            std::string path;
+            /// identity of the file the segments were loaded from
+            Identity identity;
+            /// loadable segments
+            std::vector<Segment> segments;
+
+            Image(const std::string &_path, const Identity &_identity) : path(_path),
+                identity(_identity) {}
+            ~Image();
+
+            /// Maps all segments of the image into the given task.
+            void mapInto(const std::shared_ptr<Task> &task) const;
+        };
+
+    public:
+        /// Initializes the shared image cache
+        static void init() {
+            gShared = new ImageCache;
+        }
+
+        /// Looks up an image in the shared cache.
+        static std::shared_ptr<const Image> lookup(const std::string &path,
+                const Identity &identity) {
+            return gShared->lookupImage(path, identity);
+        }
+        /// Adds an image to the shared cache.
+        static void add(const std::shared_ptr<const Image> &image) {
+            gShared->addImage(image);
+        }
+
+        /// Hashes the given bytes; pass the previous result as `hash` to hash multiple buffers.
+        static uint64_t Hash(const void *data, const size_t length,
+                const uint64_t hash = kHashBasis);
+
+    public:
+        std::shared_ptr<const Image> lookupImage(const std::string &path,
+                const Identity &identity);
+        void addImage(const std::shared_ptr<const Image> &image);
+
+    private:
+        /// FNV-1a offset basis
+        constexpr static const uint64_t kHashBasis{0xcbf29ce484222325ULL};
+        /// FNV-1a prime
+        constexpr static const uint64_t kHashPrime{0x100000001b3ULL};
+
+        /// whether cache hits, misses and evictions are logged
+        constexpr static const bool kLogCache{false};
+
+        /**
+         * Entry in the image cache
+         */
+        struct Entry {
+            /// the cached image
+            std::shared_ptr<const Image> image;
+            /// value of the use counter when the image was last looked up
+            uint64_t lastUsed{0};
+        };
+
+        static ImageCache *gShared;
+
+    private:
+        /// protects the image map
+        std::mutex lock;
+        /// all cached images, keyed by path
+        std::unordered_map<std::string, Entry> images;
+        /// incremented on every lookup; used to find the least recently used image
+        uint64_t useCounter{0};
+};
+}
+
+#endif
@@ -43,7 +43,7 @@ class LoaderError: public std::exception {
  */
 class Loader {
     public:
-        Loader(FILE *_file) : file(_file) {};
+        Loader(FILE *_file, const std::string &_path) : file(_file), path(_path) {};
         virtual ~Loader() = default;
 
         /// Gets an identifier of this loader.
@@ -91,6 +91,8 @@ class Loader {
     protected:
         /// File handle to this binary. We do NOT own this file, so we don't close it.
         FILE *file = nullptr;
+        /// Path from which the binary was opened
+        std::string path;
 };
 }
 